@@ -39,11 +39,13 @@
 
 #include "qwebmercator_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoconvexclipper_p.h>
 
 #include <qmath.h>
 #include <algorithm>
 
 #include <QtCore/QScopedValueRollback>
+#include <QtCore/QVarLengthArray>
 #include <QPen>
 #include <QPainter>
 #include <QtGui/private/qtriangulator_p.h>
@@ -57,6 +59,7 @@
 #include <sweep/cdt.h>
 
 #include <QtPositioning/private/qclipperutils_p.h>
+#include <QtPositioning/private/qgeocoordinatebatch_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -189,12 +192,16 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
     QList<QList<QDoubleVector2D> > clippedPaths;
     const QList<QDoubleVector2D> &visibleRegion = p.visibleGeometry();
     if (visibleRegion.size()) {
-        clipper.clearClipper();
-        for (const Path &p: difference)
-            clipper.addSubjectPath(p, true);
-        clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
-        Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
-        clippedPaths = QClipperUtils::pathsToQList(res);
+        if (QGeoConvexClipper::contains(visibleRegion, fill)) {
+            clippedPaths = QClipperUtils::pathsToQList(difference);
+        } else {
+            clipper.clearClipper();
+            for (const Path &p: difference)
+                clipper.addSubjectPath(p, true);
+            clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
+            Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
+            clippedPaths = QClipperUtils::pathsToQList(res);
+        }
 
         // 2.1) update srcOrigin_ with the point with minimum X/Y
         lb = QDoubleVector2D(qInf(), qInf());
@@ -282,36 +289,28 @@ void QDeclarativeCircleMapItem::calculatePeripheralPoints(QList<QGeoCoordinate>
                                       int steps,
                                       QGeoCoordinate &leftBound)
 {
-    // Calculate points based on great-circle distance
-    // Calculation is the same as GeoCoordinate's atDistanceAndAzimuth function
-    // but tweaked here for computing multiple points
-
-    // pre-calculations
+    // Calculate points based on great-circle distance, in one batch
     steps = qMax(steps, 3);
     qreal centerLon = center.longitude();
     qreal minLon = centerLon;
-    qreal latRad = QLocationUtils::radians(center.latitude());
-    qreal lonRad = QLocationUtils::radians(centerLon);
-    qreal cosLatRad = std::cos(latRad);
-    qreal sinLatRad = std::sin(latRad);
-    qreal ratio = (distance / QLocationUtils::earthMeanRadius());
-    qreal cosRatio = std::cos(ratio);
-    qreal sinRatio = std::sin(ratio);
-    qreal sinLatRad_x_cosRatio = sinLatRad * cosRatio;
-    qreal cosLatRad_x_sinRatio = cosLatRad * sinRatio;
+    QVarLengthArray<double, 256> azimuths(steps);
+    for (int i = 0; i < steps; ++i)
+        azimuths[i] = 360.0 * i / steps;
+    QVarLengthArray<double, 256> latitudes(steps);
+    QVarLengthArray<double, 256> longitudes(steps);
+    QGeoCoordinateBatch::atDistanceAndAzimuth(center.latitude(), centerLon, distance,
+                                              azimuths.constData(), steps,
+                                              latitudes.data(), longitudes.data());
+
     int idx = 0;
+    path.reserve(path.size() + steps);
     for (int i = 0; i < steps; ++i) {
-        qreal azimuthRad = 2 * M_PI * i / steps;
-        qreal resultLatRad = std::asin(sinLatRad_x_cosRatio
-                                   + cosLatRad_x_sinRatio * std::cos(azimuthRad));
-        qreal resultLonRad = lonRad + std::atan2(std::sin(azimuthRad) * cosLatRad_x_sinRatio,
-                                       cosRatio - sinLatRad * std::sin(resultLatRad));
-        qreal lat2 = QLocationUtils::degrees(resultLatRad);
-        qreal lon2 = QLocationUtils::wrapLong(QLocationUtils::degrees(resultLonRad));
+        qreal lat2 = latitudes[i];
+        qreal lon2 = QLocationUtils::wrapLong(longitudes[i]);
 
         path << QGeoCoordinate(lat2, lon2, center.altitude());
         // Consider only points in the left half of the circle for the left bound.
-        if (azimuthRad > M_PI) {
+        if (azimuths[i] > 180.0) {
             if (lon2 > centerLon) // if point and center are on different hemispheres
                 lon2 -= 360;
             if (lon2 < minLon) {
@@ -182,9 +182,10 @@ QJSValue QDeclarativeGeoRoute::path() const
     QV4::ExecutionEngine *v4 = QQmlEnginePrivate::getV4Engine(engine);
 
     QV4::Scope scope(v4);
-    QV4::Scoped<QV4::ArrayObject> pathArray(scope, v4->newArrayObject(route_.path().length()));
-    for (int i = 0; i < route_.path().length(); ++i) {
-        const QGeoCoordinate &c = route_.path().at(i);
+    const QGeoCoordinateArray path = QGeoRoutePrivate::routePrivateData(route_)->coordinateArray();
+    QV4::Scoped<QV4::ArrayObject> pathArray(scope, v4->newArrayObject(path.size()));
+    for (int i = 0; i < path.size(); ++i) {
+        const QGeoCoordinate c = path.at(i);
 
         QV4::ScopedValue cv(scope, v4->fromVariant(QVariant::fromValue(c)));
         pathArray->put(i, cv);
@@ -198,8 +199,9 @@ void QDeclarativeGeoRoute::setPath(const QJSValue &value)
     if (!value.isArray())
         return;
 
-    QList<QGeoCoordinate> pathList;
+    QGeoCoordinateArray pathList;
     quint32 length = value.property(QStringLiteral("length")).toUInt();
+    pathList.reserve(int(length));
     for (quint32 i = 0; i < length; ++i) {
         bool ok;
         QGeoCoordinate c = parseCoordinate(value.property(i), &ok);
@@ -212,10 +214,11 @@ void QDeclarativeGeoRoute::setPath(const QJSValue &value)
         pathList.append(c);
     }
 
-    if (route_.path() == pathList)
+    QGeoRoutePrivate *routePrivate = QGeoRoutePrivate::get(route_);
+    if (routePrivate->coordinateArray() == pathList)
         return;
 
-    route_.setPath(pathList);
+    routePrivate->setCoordinateArray(pathList);
 
     emit pathChanged();
 }
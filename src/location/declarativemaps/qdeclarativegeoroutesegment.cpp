@@ -35,6 +35,7 @@
 ****************************************************************************/
 
 #include "qdeclarativegeoroutesegment_p.h"
+#include <QtLocation/private/qgeoroutesegment_p.h>
 
 #include <QtQml/QQmlEngine>
 #include <QtQml/private/qqmlengine_p.h>
@@ -148,9 +149,10 @@ QJSValue QDeclarativeGeoRouteSegment::path() const
     QV4::ExecutionEngine *v4 = QQmlEnginePrivate::getV4Engine(engine);
 
     QV4::Scope scope(v4);
-    QV4::Scoped<QV4::ArrayObject> pathArray(scope, v4->newArrayObject(segment_.path().length()));
-    for (int i = 0; i < segment_.path().length(); ++i) {
-        const QGeoCoordinate &c = segment_.path().at(i);
+    const QGeoCoordinateArray path = QGeoRouteSegmentPrivate::get(segment_)->coordinateArray();
+    QV4::Scoped<QV4::ArrayObject> pathArray(scope, v4->newArrayObject(path.size()));
+    for (int i = 0; i < path.size(); ++i) {
+        const QGeoCoordinate c = path.at(i);
 
         QV4::ScopedValue cv(scope, v4->fromVariant(QVariant::fromValue(c)));
         pathArray->put(i, cv);
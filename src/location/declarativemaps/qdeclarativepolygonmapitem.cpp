@@ -39,6 +39,7 @@
 #include "error_messages_p.h"
 #include "locationvaluetypehelper_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoconvexclipper_p.h>
 
 #include <QtCore/QScopedValueRollback>
 #include <QtGui/private/qtriangulator_p.h>
@@ -189,11 +190,15 @@ void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
     QList<QList<QDoubleVector2D> > clippedPaths;
     const QList<QDoubleVector2D> &visibleRegion = p.projectableGeometry();
     if (visibleRegion.size()) {
-        c2t::clip2tri clipper;
-        clipper.addSubjectPath(QClipperUtils::qListToPath(wrappedPath), true);
-        clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
-        Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
-        clippedPaths = QClipperUtils::pathsToQList(res);
+        if (QGeoConvexClipper::contains(visibleRegion, wrappedPath)) {
+            clippedPaths.append(wrappedPath);
+        } else {
+            c2t::clip2tri clipper;
+            clipper.addSubjectPath(QClipperUtils::qListToPath(wrappedPath), true);
+            clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
+            Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
+            clippedPaths = QClipperUtils::pathsToQList(res);
+        }
 
         // 2.1) update srcOrigin_ and leftBoundWrapped with the point with minimum X
         QDoubleVector2D lb(qInf(), qInf());
@@ -508,7 +513,11 @@ void QDeclarativePolygonMapItem::updatePolish()
     QScopedValueRollback<bool> rollback(updatingGeometry_);
     updatingGeometry_ = true;
 
-    geometry_.updateSourcePoints(*map(), geopathProjected_);
+    // Only the points which are at least half a pixel off the simplified outline
+    const QList<QDoubleVector2D> *path = &geopathProjected_.simplified(QGeoSimplifiedPath::tolerance(*map()));
+    if (path->size() < 3)
+        path = &geopathProjected_.path();
+    geometry_.updateSourcePoints(*map(), *path);
     geometry_.updateScreenPoints(*map(), border_.width());
 
     QList<QGeoMapItemGeometry *> geoms;
@@ -516,7 +525,7 @@ void QDeclarativePolygonMapItem::updatePolish()
     borderGeometry_.clear();
 
     if (border_.color() != Qt::transparent && border_.width() > 0) {
-        QList<QDoubleVector2D> closedPath = geopathProjected_;
+        QList<QDoubleVector2D> closedPath = *path;
         closedPath << closedPath.first();
 
         borderGeometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
@@ -577,10 +586,11 @@ void QDeclarativePolygonMapItem::regenerateCache()
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
-    geopathProjected_.clear();
-    geopathProjected_.reserve(geopath_.path().size());
+    QList<QDoubleVector2D> geopathProjected;
+    geopathProjected.reserve(geopath_.path().size());
     for (const QGeoCoordinate &c : geopath_.path())
-        geopathProjected_ << p.geoToMapProjection(c);
+        geopathProjected << p.geoToMapProjection(c);
+    geopathProjected_.setPath(geopathProjected);
 }
 
 /*!
@@ -591,7 +601,7 @@ void QDeclarativePolygonMapItem::updateCache()
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
-    geopathProjected_ << p.geoToMapProjection(geopath_.path().last());
+    geopathProjected_.append(p.geoToMapProjection(geopath_.path().last()));
 }
 
 /*!
@@ -52,6 +52,7 @@
 #include <QtLocation/private/qdeclarativegeomapitembase_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 #include <QtLocation/private/qgeomapitemgeometry_p.h>
+#include <QtLocation/private/qgeosimplifiedpath_p.h>
 #include <QtPositioning/qgeopolygon.h>
 
 #include <QSGGeometryNode>
@@ -126,7 +127,7 @@ private:
     void updateCache();
 
     QGeoPolygon geopath_;
-    QList<QDoubleVector2D> geopathProjected_;
+    QGeoSimplifiedPath geopathProjected_;
     QDeclarativeMapLineProperties border_;
     QColor color_;
     bool dirtyMaterial_;
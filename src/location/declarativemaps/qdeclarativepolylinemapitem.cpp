@@ -40,8 +40,12 @@
 #include "locationvaluetypehelper_p.h"
 #include "qdoublevector2d_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoconvexclipper_p.h>
 
 #include <QtCore/QScopedValueRollback>
+#include <QtGui/QVector4D>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGRendererInterface>
 #include <QtQml/QQmlInfo>
 #include <QtQml/private/qqmlengine_p.h>
 #include <QPainter>
@@ -406,7 +410,10 @@ QList<QList<QDoubleVector2D> > QGeoMapPolylineGeometry::clipPath(const QGeoMap &
     QList<QList<QDoubleVector2D> > clippedPaths;
     const QList<QDoubleVector2D> &visibleRegion = p.projectableGeometry();
     if (visibleRegion.size()) {
-        clippedPaths = clipLine(wrappedPath, visibleRegion);
+        if (QGeoConvexClipper::contains(visibleRegion, wrappedPath))
+            clippedPaths.append(wrappedPath);
+        else
+            clippedPaths = clipLine(wrappedPath, visibleRegion);
 
         // 2.1) update srcOrigin_ and leftBoundWrapped with the point with minimum X
         QDoubleVector2D lb(qInf(), qInf());
@@ -735,8 +742,165 @@ bool QGeoMapPolylineGeometry::contains(const QPointF &point) const
     return false;
 }
 
+QGeoMapPolylineGeometryExtruded::QGeoMapPolylineGeometryExtruded()
+:   sourceDirty_(true), vertexDataDirty_(true)
+{
+}
+
+/*!
+    \internal
+
+    \a path is in map projection, \a origin the projection of the left bound
+    of the path. Points left of the origin are moved one map width to the
+    right, as QGeoMapPolylineGeometry does, so that the path does not wrap.
+    The vertices are made relative to \a center, the camera center in map
+    projection.
+*/
+void QGeoMapPolylineGeometryExtruded::updateSourcePoints(const QList<QDoubleVector2D> &path,
+                                                          const QDoubleVector2D &origin,
+                                                          const QDoubleVector2D &center)
+{
+    if (!sourceDirty_)
+        return;
+    sourceDirty_ = false;
+
+    origin_ = origin;
+    points_.clear();
+    points_.reserve(path.size());
+    for (const QDoubleVector2D &coord : path) {
+        if (!qIsFinite(coord.x()) || !qIsFinite(coord.y()))
+            continue;
+        const QDoubleVector2D point = relativePoint(coord);
+        if (points_.isEmpty() || points_.last() != point)
+            points_.append(point);
+    }
+
+    base_ = relativePoint(center);
+    updateVertices();
+}
+
+/*!
+    \internal
+
+    Makes the vertices relative to \a center, in map projection, if it is
+    more than \a maxDistance away from the current base. Returns whether the
+    vertices were rewritten.
+*/
+bool QGeoMapPolylineGeometryExtruded::rebase(const QDoubleVector2D &center, double maxDistance)
+{
+    const QDoubleVector2D base = relativePoint(center);
+    if ((base - base_).length() <= maxDistance)
+        return false;
+    base_ = base;
+    updateVertices();
+    return true;
+}
+
+/*!
+    \internal
+
+    The point the vertices are relative to, in map projection.
+*/
+QDoubleVector2D QGeoMapPolylineGeometryExtruded::base() const
+{
+    QDoubleVector2D base = origin_ + base_;
+    if (base.x() >= 1.0)
+        base.setX(base.x() - 1.0);
+    return base;
+}
+
+QDoubleVector2D QGeoMapPolylineGeometryExtruded::relativePoint(const QDoubleVector2D &point) const
+{
+    QDoubleVector2D relative = point - origin_;
+    if (relative.x() < 0.0)
+        relative.setX(relative.x() + 1.0);
+    return relative;
+}
+
+// The differences to the base are taken in double precision, only the
+// results are rounded to single precision
+void QGeoMapPolylineGeometryExtruded::updateVertices()
+{
+    vertexDataDirty_ = true;
+    vertices_.clear();
+    if (points_.size() < 2)
+        return;
+    vertices_.resize((points_.size() - 1) * 6);
+
+    const QDoubleVector2D base = base_;
+    const auto vertex = [base](const QDoubleVector2D &point, const QDoubleVector2D &other,
+                               const QDoubleVector2D &neighbor, float side) {
+        const Vertex v = { float(point.x() - base.x()), float(point.y() - base.y()),
+                           float(other.x() - base.x()), float(other.y() - base.y()),
+                           float(neighbor.x() - base.x()), float(neighbor.y() - base.y()),
+                           side };
+        return v;
+    };
+
+    Vertex *v = vertices_.data();
+    const int last = points_.size() - 1;
+    for (int i = 0; i < last; ++i) {
+        const QDoubleVector2D &start = points_.at(i);
+        const QDoubleVector2D &end = points_.at(i + 1);
+        const QDoubleVector2D &before = (i > 0) ? points_.at(i - 1) : start;
+        const QDoubleVector2D &after = (i + 1 < last) ? points_.at(i + 2) : end;
+
+        // The normal flips with the direction at the end vertices, so side
+        // 1 is the left of the segment at its start and the right at its end.
+        const Vertex startLeft = vertex(start, end, before, 1.0f);
+        const Vertex startRight = vertex(start, end, before, -1.0f);
+        const Vertex endRight = vertex(end, start, after, 1.0f);
+        const Vertex endLeft = vertex(end, start, after, -1.0f);
+        *v++ = startLeft;
+        *v++ = startRight;
+        *v++ = endRight;
+        *v++ = startLeft;
+        *v++ = endRight;
+        *v++ = endLeft;
+    }
+}
+
+/*!
+    \internal
+
+    Whether \a point, in item coordinates of an item covering the map, is on
+    the line. Only used for input, so the path is projected on demand.
+*/
+bool QGeoMapPolylineGeometryExtruded::contains(const QGeoMap &map, const QPointF &point, qreal strokeWidth) const
+{
+    if (points_.size() < 2)
+        return false;
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+    const QDoubleVector2D origin = p.wrapMapProjection(origin_);
+    const QDoubleVector2D target(point);
+    const double maxDistance = qMax(strokeWidth * 0.5, 1.0);
+
+    QDoubleVector2D previous;
+    bool previousProjectable = false;
+    for (int i = 0; i < points_.size(); ++i) {
+        const QDoubleVector2D wrapped = origin + points_.at(i);
+        const bool projectable = p.isProjectable(wrapped);
+        const QDoubleVector2D current = projectable ? p.wrappedMapProjectionToItemPosition(wrapped)
+                                                    : QDoubleVector2D();
+        if (projectable && previousProjectable) {
+            const QDoubleVector2D segment = current - previous;
+            const double lengthSquared = QDoubleVector2D::dotProduct(segment, segment);
+            double t = 0.0;
+            if (lengthSquared > 0.0)
+                t = qBound(0.0, QDoubleVector2D::dotProduct(target - previous, segment) / lengthSquared, 1.0);
+            if ((previous + segment * t - target).length() <= maxDistance)
+                return true;
+        }
+        previous = current;
+        previousProjectable = projectable;
+    }
+    return false;
+}
+
 QDeclarativePolylineMapItem::QDeclarativePolylineMapItem(QQuickItem *parent)
-:   QDeclarativeGeoMapItemBase(parent), line_(this), dirtyMaterial_(true), updatingGeometry_(false)
+:   QDeclarativeGeoMapItemBase(parent), line_(this), dirtyMaterial_(true), updatingGeometry_(false),
+    backend_(Software), nodeBackend_(Software)
 {
     m_itemType = QGeoMap::MapPolyline;
     setFlag(ItemHasContents, true);
@@ -755,6 +919,12 @@ QDeclarativePolylineMapItem::~QDeclarativePolylineMapItem()
 */
 void QDeclarativePolylineMapItem::updateAfterLinePropertiesChanged()
 {
+    if (isExtruded()) {
+        // The width and the color are only passed to the material
+        update();
+        return;
+    }
+
     // mark dirty just in case we're a width change
     geometry_.markSourceDirty();
     polishAndUpdate();
@@ -766,6 +936,7 @@ void QDeclarativePolylineMapItem::updateAfterLinePropertiesChanged()
 void QDeclarativePolylineMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
 {
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
+    updateBackend();
     if (map) {
         regenerateCache();
         geometry_.markSourceDirty();
@@ -1003,6 +1174,65 @@ QDeclarativeMapLineProperties *QDeclarativePolylineMapItem::line()
     return &line_;
 }
 
+/*!
+    \internal
+
+    Software, the default, tessellates the polyline on the CPU whenever the
+    map moves, and works with every scene graph backend.
+
+    OpenGLExtruded tessellates the polyline only when its path changes. The
+    map projection and the line width are applied by a shader, so moving the
+    map does not touch the geometry. It requires the OpenGL scene graph
+    backend. Lines are joined with miters, and segments behind the camera are
+    clipped at the near plane.
+*/
+QDeclarativePolylineMapItem::Backend QDeclarativePolylineMapItem::backend() const
+{
+    return backend_;
+}
+
+void QDeclarativePolylineMapItem::setBackend(QDeclarativePolylineMapItem::Backend backend)
+{
+    if (backend == backend_)
+        return;
+    backend_ = backend;
+
+    geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
+    markSourceDirtyAndUpdate();
+}
+
+/*!
+    \internal
+*/
+bool QDeclarativePolylineMapItem::isExtruded() const
+{
+    return backend_ == OpenGLExtruded;
+}
+
+/*!
+    \internal
+
+    Selects OpenGLExtruded when the map enables extruded polylines and the
+    window uses the OpenGL scene graph backend, Software otherwise.
+*/
+void QDeclarativePolylineMapItem::updateBackend()
+{
+    const QQuickWindow *w = window();
+    const bool extruded = map() && map()->extrudedPolylinesEnabled() && w
+            && w->rendererInterface()->graphicsApi() == QSGRendererInterface::OpenGL;
+    setBackend(extruded ? OpenGLExtruded : Software);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolylineMapItem::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QDeclarativeGeoMapItemBase::itemChange(change, value);
+    if (change == ItemSceneChange)
+        updateBackend();
+}
+
 /*!
     \internal
 */
@@ -1040,6 +1270,15 @@ void QDeclarativePolylineMapItem::afterViewportChanged(const QGeoMapViewportChan
     if (event.mapSize.width() <= 0 || event.mapSize.height() <= 0)
         return;
 
+    if (isExtruded()) {
+        // The camera is only passed to the material, the item covers the map
+        if (event.mapSizeChanged)
+            polishAndUpdate();
+        else
+            update();
+        return;
+    }
+
     geometry_.setPreserveGeometry(true, geometry_.geoLeftBound());
     markSourceDirtyAndUpdate();
 }
@@ -1052,10 +1291,11 @@ void QDeclarativePolylineMapItem::regenerateCache()
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
-    geopathProjected_.clear();
-    geopathProjected_.reserve(geopath_.path().size());
+    QList<QDoubleVector2D> geopathProjected;
+    geopathProjected.reserve(geopath_.path().size());
     for (const QGeoCoordinate &c : geopath_.path())
-        geopathProjected_ << p.geoToMapProjection(c);
+        geopathProjected << p.geoToMapProjection(c);
+    geopathProjected_.setPath(geopathProjected);
 }
 
 /*!
@@ -1066,7 +1306,7 @@ void QDeclarativePolylineMapItem::updateCache()
     if (!map() ||  map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
-    geopathProjected_ << p.geoToMapProjection(geopath_.path().last());
+    geopathProjected_.append(p.geoToMapProjection(geopath_.path().last()));
 }
 
 /*!
@@ -1078,6 +1318,7 @@ void QDeclarativePolylineMapItem::updatePolish()
         return;
     if (geopath_.path().length() == 0) { // Possibly cleared
         geometry_.clear();
+        extrudedGeometry_.updateSourcePoints(QList<QDoubleVector2D>(), QDoubleVector2D(), QDoubleVector2D());
         setWidth(0);
         setHeight(0);
         return;
@@ -1086,7 +1327,19 @@ void QDeclarativePolylineMapItem::updatePolish()
     QScopedValueRollback<bool> rollback(updatingGeometry_);
     updatingGeometry_ = true;
 
-    geometry_.updateSourcePoints(*map(), geopathProjected_, geopath_.boundingGeoRectangle().topLeft());
+    if (isExtruded()) {
+        const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
+        extrudedGeometry_.updateSourcePoints(geopathProjected_.path(),
+                                             p.geoToMapProjection(geopath_.boundingGeoRectangle().topLeft()),
+                                             p.geoToMapProjection(p.cameraData().center()));
+        setPosition(QPointF(0, 0));
+        setSize(QSizeF(map()->viewportWidth(), map()->viewportHeight()));
+        return;
+    }
+
+    // Only the points which are at least half a pixel off the simplified line
+    geometry_.updateSourcePoints(*map(), geopathProjected_.simplified(QGeoSimplifiedPath::tolerance(*map())),
+                                 geopath_.boundingGeoRectangle().topLeft());
     geometry_.updateScreenPoints(*map(), line_.width());
 
     setWidth(geometry_.sourceBoundingBox().width() + 2 * line_.width());
@@ -1098,6 +1351,7 @@ void QDeclarativePolylineMapItem::updatePolish()
 void QDeclarativePolylineMapItem::markSourceDirtyAndUpdate()
 {
     geometry_.markSourceDirty();
+    extrudedGeometry_.markSourceDirty();
     polishAndUpdate();
 }
 
@@ -1108,6 +1362,38 @@ QSGNode *QDeclarativePolylineMapItem::updateMapItemPaintNode(QSGNode *oldNode, U
 {
     Q_UNUSED(data);
 
+    if (oldNode && nodeBackend_ != backend_) {
+        delete oldNode;
+        oldNode = nullptr;
+    }
+    nodeBackend_ = backend_;
+
+    if (isExtruded()) {
+        if (map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator) {
+            delete oldNode;
+            return nullptr;
+        }
+
+        // Keep the vertices relative to a point within about a viewport of
+        // the camera center, where they are accurate in single precision
+        const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
+        const double maxDistance = qMax(map()->viewportWidth(), map()->viewportHeight()) / p.mapWidth();
+        extrudedGeometry_.rebase(p.geoToMapProjection(p.cameraData().center()), maxDistance);
+
+        MapPolylineNodeExtruded *node = static_cast<MapPolylineNodeExtruded *>(oldNode);
+        if (!node)
+            node = new MapPolylineNodeExtruded();
+        if (extrudedGeometry_.isVertexDataDirty() || !oldNode) {
+            node->updateGeometry(&extrudedGeometry_);
+            extrudedGeometry_.markClean();
+        }
+
+        node->update(line_.color(), line_.width(),
+                     p.relativeItemTransformation(p.wrapMapProjection(extrudedGeometry_.base())),
+                     p.nearPlane());
+        return node;
+    }
+
     MapPolylineNode *node = static_cast<MapPolylineNode *>(oldNode);
 
     if (!node) {
@@ -1126,6 +1412,12 @@ QSGNode *QDeclarativePolylineMapItem::updateMapItemPaintNode(QSGNode *oldNode, U
 
 bool QDeclarativePolylineMapItem::contains(const QPointF &point) const
 {
+    if (isExtruded()) {
+        const QGeoMap *map = const_cast<QDeclarativePolylineMapItem *>(this)->map();
+        if (!map || map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
+            return false;
+        return extrudedGeometry_.contains(*map, point, line_.width());
+    }
     return geometry_.contains(point);
 }
 
@@ -1251,4 +1543,227 @@ void MapPolylineNode::update(const QColor &fillColor,
     }
 }
 
+static const QSGGeometry::AttributeSet &extrudedAttributes()
+{
+    static const QSGGeometry::Attribute data[] = {
+        QSGGeometry::Attribute::createWithAttributeType(0, 2, QSGGeometry::FloatType, QSGGeometry::PositionAttribute),
+        QSGGeometry::Attribute::createWithAttributeType(1, 2, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute),
+        QSGGeometry::Attribute::createWithAttributeType(2, 2, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute),
+        QSGGeometry::Attribute::createWithAttributeType(3, 1, QSGGeometry::FloatType, QSGGeometry::UnknownAttribute)
+    };
+    static const QSGGeometry::AttributeSet attributes = { 4, sizeof(QGeoMapPolylineGeometryExtruded::Vertex), data };
+    return attributes;
+}
+
+/*
+    Projects both ends of the segment of the vertex, moving the one behind the
+    camera to the near plane, and extrudes the vertex by half the line width
+    in screen space along the normal of the segment, or along the miter with
+    the joining segment.
+*/
+class MapPolylineShaderExtruded : public QSGMaterialShader
+{
+public:
+    MapPolylineShaderExtruded()
+        : matrixId_(-1), transformationId_(-1), halfWidthId_(-1), nearPlaneId_(-1), colorId_(-1), opacityId_(-1)
+    {
+    }
+
+    const char *vertexShader() const override
+    {
+        return
+            "attribute highp vec2 vertex;\n"
+            "attribute highp vec2 other;\n"
+            "attribute highp vec2 neighbor;\n"
+            "attribute highp float side;\n"
+            "uniform highp mat4 qt_Matrix;\n"
+            "uniform highp mat4 transformation;\n"
+            "uniform highp float halfWidth;\n"
+            "uniform highp float nearPlane;\n"
+            "const highp float miterLimit = 4.0;\n"
+            "void main() {\n"
+            "    highp vec4 p = transformation * vec4(vertex, 0.0, 1.0);\n"
+            "    highp vec4 o = transformation * vec4(other, 0.0, 1.0);\n"
+            "    if (p.w < nearPlane && o.w < nearPlane) {\n"
+            "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n" // The whole segment is behind the camera
+            "        return;\n"
+            "    }\n"
+            "    bool join = neighbor != vertex;\n"
+            "    if (p.w < nearPlane) {\n"
+            "        p = mix(p, o, (nearPlane - p.w) / (o.w - p.w));\n"
+            "        join = false;\n"
+            "    } else if (o.w < nearPlane) {\n"
+            "        o = mix(p, o, (p.w - nearPlane) / (p.w - o.w));\n"
+            "    }\n"
+            "    highp vec2 position = p.xy / p.w;\n"
+            "    highp vec2 direction = o.xy / o.w - position;\n"
+            "    highp float directionLength = length(direction);\n"
+            "    direction = directionLength > 0.0 ? direction / directionLength : vec2(1.0, 0.0);\n"
+            "    highp vec2 normal = vec2(-direction.y, direction.x);\n"
+            "    highp vec2 offset = normal * halfWidth;\n"
+            "    if (join) {\n"
+            "        highp vec4 n = transformation * vec4(neighbor, 0.0, 1.0);\n"
+            "        highp vec2 joined = position - n.xy / n.w;\n"
+            "        highp float joinedLength = length(joined);\n"
+            "        if (n.w >= nearPlane && joinedLength > 0.0) {\n"
+            "            joined /= joinedLength;\n"
+            "            highp vec2 miter = normal + vec2(-joined.y, joined.x);\n"
+            "            highp float miterLength = length(miter);\n"
+            "            if (miterLength > 0.001) {\n" // Not turning back
+            "                miter /= miterLength;\n"
+            "                offset = miter * min(halfWidth / dot(miter, normal), halfWidth * miterLimit);\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "    gl_Position = qt_Matrix * vec4(position + offset * side, 0.0, 1.0);\n"
+            "}\n";
+    }
+
+    const char *fragmentShader() const override
+    {
+        return
+            "uniform lowp vec4 color;\n"
+            "uniform lowp float opacity;\n"
+            "void main() {\n"
+            "    gl_FragColor = color * opacity;\n"
+            "}\n";
+    }
+
+    char const *const *attributeNames() const override
+    {
+        static char const *const names[] = { "vertex", "other", "neighbor", "side", nullptr };
+        return names;
+    }
+
+    // The transformation changes with every frame and is not part of
+    // compare(), so all the uniforms are set every time.
+    void updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial) override
+    {
+        Q_UNUSED(oldMaterial);
+        const MapPolylineMaterialExtruded *material = static_cast<const MapPolylineMaterialExtruded *>(newMaterial);
+        QOpenGLShaderProgram *p = program();
+
+        if (state.isMatrixDirty())
+            p->setUniformValue(matrixId_, state.combinedMatrix());
+        if (state.isOpacityDirty())
+            p->setUniformValue(opacityId_, state.opacity());
+
+        p->setUniformValue(transformationId_, material->transformation());
+        p->setUniformValue(halfWidthId_, material->lineWidth() * 0.5f);
+        p->setUniformValue(nearPlaneId_, material->nearPlane());
+        const QColor c = material->color();
+        const float a = float(c.alphaF());
+        p->setUniformValue(colorId_, QVector4D(float(c.redF()) * a, float(c.greenF()) * a, float(c.blueF()) * a, a));
+    }
+
+protected:
+    void initialize() override
+    {
+        matrixId_ = program()->uniformLocation("qt_Matrix");
+        transformationId_ = program()->uniformLocation("transformation");
+        halfWidthId_ = program()->uniformLocation("halfWidth");
+        nearPlaneId_ = program()->uniformLocation("nearPlane");
+        colorId_ = program()->uniformLocation("color");
+        opacityId_ = program()->uniformLocation("opacity");
+    }
+
+private:
+    int matrixId_;
+    int transformationId_;
+    int halfWidthId_;
+    int nearPlaneId_;
+    int colorId_;
+    int opacityId_;
+};
+
+/*!
+    \internal
+
+    The vertices are not positions in item coordinates, so the renderer must
+    neither merge nor transform them, hence RequiresFullMatrix.
+*/
+MapPolylineMaterialExtruded::MapPolylineMaterialExtruded()
+    : color_(Qt::black), lineWidth_(1.0f), nearPlane_(1.0f)
+{
+    setFlag(RequiresFullMatrix, true);
+}
+
+QSGMaterialShader *MapPolylineMaterialExtruded::createShader() const
+{
+    return new MapPolylineShaderExtruded();
+}
+
+QSGMaterialType *MapPolylineMaterialExtruded::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+int MapPolylineMaterialExtruded::compare(const QSGMaterial *other) const
+{
+    const MapPolylineMaterialExtruded *m = static_cast<const MapPolylineMaterialExtruded *>(other);
+    if (m->color_ != color_)
+        return m->color_.rgba() < color_.rgba() ? -1 : 1;
+    if (m->lineWidth_ != lineWidth_)
+        return m->lineWidth_ < lineWidth_ ? -1 : 1;
+    return m->transformation_ == transformation_ ? 0 : (m < this ? -1 : 1);
+}
+
+void MapPolylineMaterialExtruded::setColor(const QColor &color)
+{
+    color_ = color;
+    setFlag(Blending, color_.alpha() < 255);
+}
+
+/*!
+    \internal
+*/
+MapPolylineNodeExtruded::MapPolylineNodeExtruded() :
+    geometry_(extrudedAttributes(), 0)
+{
+    geometry_.setDrawingMode(QSGGeometry::DrawTriangles);
+    QSGGeometryNode::setMaterial(&material_);
+    QSGGeometryNode::setGeometry(&geometry_);
+}
+
+/*!
+    \internal
+*/
+MapPolylineNodeExtruded::~MapPolylineNodeExtruded()
+{
+}
+
+/*!
+    \internal
+*/
+void MapPolylineNodeExtruded::updateGeometry(const QGeoMapPolylineGeometryExtruded *shape)
+{
+    const QVector<QGeoMapPolylineGeometryExtruded::Vertex> &vertices = shape->vertices();
+    geometry_.allocate(vertices.size());
+    if (!vertices.isEmpty())
+        memcpy(geometry_.vertexData(), vertices.constData(), vertices.size() * sizeof(QGeoMapPolylineGeometryExtruded::Vertex));
+    markDirty(DirtyGeometry);
+}
+
+/*!
+    \internal
+*/
+void MapPolylineNodeExtruded::update(const QColor &color, qreal width, const QMatrix4x4 &transformation, double nearPlane)
+{
+    if (geometry_.vertexCount() == 0 || width <= 0.0 || color.alpha() == 0) {
+        setSubtreeBlocked(true);
+        return;
+    } else {
+        setSubtreeBlocked(false);
+    }
+
+    // Uniforms are set on every frame, see MapPolylineShaderExtruded::updateState()
+    material_.setTransformation(transformation);
+    material_.setNearPlane(float(nearPlane));
+    material_.setLineWidth(width);
+    if (color != material_.color())
+        material_.setColor(color);
+    markDirty(DirtyMaterial);
+}
+
 QT_END_NAMESPACE
@@ -51,11 +51,14 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativegeomapitembase_p.h>
 #include <QtLocation/private/qgeomapitemgeometry_p.h>
+#include <QtLocation/private/qgeosimplifiedpath_p.h>
 
 #include <QtPositioning/QGeoPath>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
+#include <QSGMaterial>
+#include <QMatrix4x4>
 
 QT_BEGIN_NAMESPACE
 
@@ -125,6 +128,60 @@ public:
     friend class QDeclarativeRectangleMapItem;
 };
 
+/*
+    The polyline extruded once in map projection. Every segment is a quad of
+    two triangles whose vertices carry the ends of the segment and of the
+    joining segments. The camera, the line width and the miter joins are
+    applied by MapPolylineMaterialExtruded, so the vertices only change with
+    the path, and when they are rebased.
+
+    The vertices are relative to base(), a point near the camera center,
+    since single precision is only accurate close to it at high zoom levels.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapPolylineGeometryExtruded
+{
+public:
+    struct Vertex
+    {
+        float x;
+        float y;
+        float otherX; // The other end of the segment
+        float otherY;
+        float neighborX; // The far end of the joining segment, x, y at the ends of the path
+        float neighborY;
+        float side; // 1 or -1
+    };
+
+    QGeoMapPolylineGeometryExtruded();
+
+    void updateSourcePoints(const QList<QDoubleVector2D> &path, const QDoubleVector2D &origin,
+                            const QDoubleVector2D &center);
+    bool rebase(const QDoubleVector2D &center, double maxDistance);
+
+    inline bool isSourceDirty() const { return sourceDirty_; }
+    inline void markSourceDirty() { sourceDirty_ = true; }
+    inline bool isVertexDataDirty() const { return vertexDataDirty_; }
+    inline void markClean() { vertexDataDirty_ = false; }
+
+    // In map projection
+    inline QDoubleVector2D origin() const { return origin_; }
+    QDoubleVector2D base() const;
+    inline const QVector<Vertex> &vertices() const { return vertices_; }
+
+    bool contains(const QGeoMap &map, const QPointF &point, qreal strokeWidth) const;
+
+private:
+    QDoubleVector2D relativePoint(const QDoubleVector2D &point) const;
+    void updateVertices();
+
+    QDoubleVector2D origin_;
+    QDoubleVector2D base_; // relative to origin_
+    QVector<QDoubleVector2D> points_; // relative to origin_, without repeated points
+    QVector<Vertex> vertices_;
+    bool sourceDirty_;
+    bool vertexDataDirty_;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItem : public QDeclarativeGeoMapItemBase
 {
     Q_OBJECT
@@ -133,6 +190,13 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItem : public QDeclarativ
     Q_PROPERTY(QDeclarativeMapLineProperties *line READ line CONSTANT)
 
 public:
+    // Not exposed to QML, OpenGLExtruded is used when the map enables it
+    // and the OpenGL scene graph backend is used
+    enum Backend {
+        Software = 0,
+        OpenGLExtruded = 1
+    };
+
     explicit QDeclarativePolylineMapItem(QQuickItem *parent = 0);
     ~QDeclarativePolylineMapItem();
 
@@ -159,11 +223,15 @@ public:
 
     QDeclarativeMapLineProperties *line();
 
+    Backend backend() const;
+    void setBackend(Backend backend);
+
 Q_SIGNALS:
     void pathChanged();
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
     void setPathFromGeoList(const QList<QGeoCoordinate> &path);
     void updatePolish() override;
 
@@ -175,17 +243,22 @@ protected Q_SLOTS:
 private:
     void regenerateCache();
     void updateCache();
+    bool isExtruded() const;
+    void updateBackend();
 
 #ifdef QT_LOCATION_DEBUG
 public:
 #endif
     QGeoPath geopath_;
-    QList<QDoubleVector2D> geopathProjected_;
+    QGeoSimplifiedPath geopathProjected_;
     QDeclarativeMapLineProperties line_;
     QColor color_;
     bool dirtyMaterial_;
     QGeoMapPolylineGeometry geometry_;
     bool updatingGeometry_;
+    Backend backend_;
+    QGeoMapPolylineGeometryExtruded extrudedGeometry_;
+    Backend nodeBackend_; // of the node returned by updateMapItemPaintNode()
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -225,6 +298,47 @@ private:
     QSGGeometry geometry_;
 };
 
+class Q_LOCATION_PRIVATE_EXPORT MapPolylineMaterialExtruded : public QSGMaterial
+{
+public:
+    MapPolylineMaterialExtruded();
+
+    QSGMaterialShader *createShader() const override;
+    QSGMaterialType *type() const override;
+    int compare(const QSGMaterial *other) const override;
+
+    void setColor(const QColor &color);
+    inline QColor color() const { return color_; }
+    inline void setLineWidth(float width) { lineWidth_ = width; }
+    inline float lineWidth() const { return lineWidth_; }
+    // See QGeoProjectionWebMercator::relativeItemTransformation()
+    inline void setTransformation(const QMatrix4x4 &transformation) { transformation_ = transformation; }
+    inline const QMatrix4x4 &transformation() const { return transformation_; }
+    // See QGeoProjectionWebMercator::nearPlane()
+    inline void setNearPlane(float nearPlane) { nearPlane_ = nearPlane; }
+    inline float nearPlane() const { return nearPlane_; }
+
+private:
+    QColor color_;
+    float lineWidth_;
+    QMatrix4x4 transformation_;
+    float nearPlane_;
+};
+
+class Q_LOCATION_PRIVATE_EXPORT MapPolylineNodeExtruded : public MapItemGeometryNode
+{
+public:
+    MapPolylineNodeExtruded();
+    ~MapPolylineNodeExtruded() override;
+
+    void updateGeometry(const QGeoMapPolylineGeometryExtruded *shape);
+    void update(const QColor &color, qreal width, const QMatrix4x4 &transformation, double nearPlane);
+
+private:
+    MapPolylineMaterialExtruded material_;
+    QSGGeometry geometry_;
+};
+
 QT_END_NAMESPACE
 
 QML_DECLARE_TYPE(QDeclarativeMapLineProperties)
@@ -36,9 +36,236 @@
 
 #include "qgeomapobjectqsgsupport_p.h"
 #include <QtLocation/private/qgeomap_p_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeomapitemgeometry_p.h>
+#include <QtLocation/private/qmapcircleobject_p.h>
+#include <QtLocation/private/qmapiconobject_p.h>
+#include <QtLocation/private/qmappolygonobject_p.h>
+#include <QtLocation/private/qmappolylineobject_p.h>
+#include <QtLocation/private/qmaprouteobject_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGFlatColorMaterial>
+#include <QtQuick/QSGTextureMaterial>
+#include <QtQuick/QQuickWindow>
+#include <QtGui/QPainter>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+// Cells per side of the grid the object bounds are bucketed on. Objects that
+// would be listed in more than maxIndexedCells cells are kept in a plain list.
+const int gridSize = 256;
+const int maxIndexedCells = 64;
+// Screen margin around the viewport, covering borders and other decorations
+// extending beyond the geographic bounds of the objects
+const double viewportMargin = 256.0;
+// Icon images up to maxAtlasedIconSize pixels are packed in rows into pages of
+// iconPageSize pixels, larger ones get a page of their own
+const int iconPageSize = 1024;
+const int maxAtlasedIconSize = 256;
+const int iconPadding = 2;
+}
+
+// Flat colored nodes shared by a run of objects of one style
+struct QGeoMapObjectQSGBatch
+{
+    QQSGMapObjectStyle style;
+    int first = 0;        // range of object orders the batch draws, not all
+    int last = 0;         // of them need to be members
+    QVector<int> members; // slots of the objects drawn by the batch
+    QSGNode *node = nullptr;
+    QSGGeometryNode *fillNode = nullptr;
+    QSGGeometryNode *borderNode = nullptr;
+    bool dirty = true;
+};
+
+// Draws the quads of the icons on one page, the node owns the page texture
+class QGeoMapObjectQSGIconNode : public QSGGeometryNode
+{
+public:
+    QGeoMapObjectQSGIconNode()
+    {
+        m_material.setFiltering(QSGTexture::Linear);
+        setMaterial(&m_material);
+        setFlag(OwnsGeometry);
+    }
+
+    ~QGeoMapObjectQSGIconNode() override
+    {
+        delete m_material.texture();
+    }
+
+    void setTexture(QSGTexture *texture)
+    {
+        delete m_material.texture();
+        m_material.setTexture(texture);
+        markDirty(DirtyMaterial);
+    }
+
+private:
+    QSGTextureMaterial m_material;
+};
+
+struct QGeoMapObjectQSGIconPage
+{
+    QImage image;
+    bool shared = true;     // false for a page holding a single large image
+    int shelfX = iconPadding;
+    int shelfY = iconPadding;
+    int shelfHeight = 0;
+    int references = 0;     // sum of the references to the atlas entries on the page
+
+    QVector<int> members;   // slot of the icon drawn by each quad
+    QVector<int> dirtyQuads;
+    int capacity = 0;       // quads allocated in the geometry, unused ones are degenerate
+    QGeoMapObjectQSGIconNode *node = nullptr;
+    bool imageDirty = true;
+};
+
+// Reserves room for an image of the given size in the current row of the page,
+// or in a new row below it
+static bool placeIcon(QGeoMapObjectQSGIconPage *page, const QSize &size, QPoint *position)
+{
+    if (page->shelfX + size.width() + iconPadding > iconPageSize) {
+        page->shelfX = iconPadding;
+        page->shelfY += page->shelfHeight + iconPadding;
+        page->shelfHeight = 0;
+    }
+    if (page->shelfY + size.height() + iconPadding > iconPageSize)
+        return false;
+
+    *position = QPoint(page->shelfX, page->shelfY);
+    page->shelfX += size.width() + iconPadding;
+    page->shelfHeight = qMax(page->shelfHeight, size.height());
+    return true;
+}
+
+static void setIconQuad(QSGGeometry::TexturedPoint2D *v, const QRectF &rect, const QRectF &textureRect)
+{
+    if (rect.isNull() || !rect.isValid()) {
+        memset(v, 0, 4 * sizeof(QSGGeometry::TexturedPoint2D));
+        return;
+    }
+    v[0].set(rect.left(), rect.top(), textureRect.left(), textureRect.top());
+    v[1].set(rect.right(), rect.top(), textureRect.right(), textureRect.top());
+    v[2].set(rect.left(), rect.bottom(), textureRect.left(), textureRect.bottom());
+    v[3].set(rect.right(), rect.bottom(), textureRect.right(), textureRect.bottom());
+}
+
+static QRectF mercatorBounds(const QGeoRectangle &rect)
+{
+    const QDoubleVector2D topLeft = QWebMercator::coordToMercator(rect.topLeft());
+    const QDoubleVector2D bottomRight = QWebMercator::coordToMercator(rect.bottomRight());
+    double right = bottomRight.x();
+    if (right < topLeft.x()) // crossing the dateline
+        right += 1.0;
+    return QRectF(QPointF(topLeft.x(), topLeft.y()), QPointF(right, bottomRight.y()));
+}
+
+static int gridColumn(double x)
+{
+    return qFloor(x * gridSize);
+}
+
+static int gridRow(double y)
+{
+    return qBound(0, qFloor(y * gridSize), gridSize - 1);
+}
+
+static int wrapColumn(int column)
+{
+    column %= gridSize;
+    return column < 0 ? column + gridSize : column;
+}
+
+static QSGGeometryNode *createBatchNode(QSGNode *parent, QRgb color)
+{
+    QSGGeometryNode *node = new QSGGeometryNode;
+    QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+    geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+    node->setGeometry(geometry);
+    QSGFlatColorMaterial *material = new QSGFlatColorMaterial;
+    material->setColor(QColor::fromRgba(color));
+    node->setMaterial(material);
+    node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+    parent->appendChildNode(node);
+    return node;
+}
+
+// Concatenates the shapes into one indexed triangle list. Triangle strips are
+// unrolled, as there is no way to restart them inside a single draw call.
+static void fillBatchNode(QSGGeometryNode *node, const QVector<const QGeoMapItemGeometry *> &shapes, bool strips)
+{
+    int vertexCount = 0;
+    int indexCount = 0;
+    for (const QGeoMapItemGeometry *shape : shapes) {
+        const int vertices = shape->vertices().size();
+        vertexCount += vertices;
+        if (strips)
+            indexCount += qMax(0, vertices - 2) * 3;
+        else
+            indexCount += shape->isIndexed() ? shape->indices().size() : vertices;
+    }
+
+    const int indexType = vertexCount > 0xffff ? QSGGeometry::UnsignedIntType
+                                               : QSGGeometry::UnsignedShortType;
+    QSGGeometry *geometry = node->geometry();
+    if (geometry->indexType() != indexType) {
+        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0, 0, indexType);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+    }
+    geometry->allocate(vertexCount, indexCount);
+
+    QSGGeometry::Point2D *points = geometry->vertexDataAsPoint2D();
+    quint16 *shortIndices = indexType == QSGGeometry::UnsignedShortType ? geometry->indexDataAsUShort() : nullptr;
+    quint32 *intIndices = indexType == QSGGeometry::UnsignedIntType ? geometry->indexDataAsUInt() : nullptr;
+    int index = 0;
+    auto appendIndex = [&](quint32 i) {
+        if (shortIndices)
+            shortIndices[index++] = quint16(i);
+        else
+            intIndices[index++] = i;
+    };
+
+    quint32 base = 0;
+    for (const QGeoMapItemGeometry *shape : shapes) {
+        const QVector<QPointF> &vertices = shape->vertices();
+        for (const QPointF &v : vertices)
+            (points++)->set(v.x(), v.y());
+
+        if (strips) {
+            for (int i = 2; i < vertices.size(); ++i) {
+                appendIndex(base + i - 2);
+                appendIndex(base + i - 1);
+                appendIndex(base + i);
+            }
+        } else if (shape->isIndexed()) {
+            const QVector<quint32> &indices = shape->indices();
+            for (quint32 i : indices)
+                appendIndex(base + i);
+        } else {
+            for (int i = 0; i < vertices.size(); ++i)
+                appendIndex(base + i);
+        }
+        base += vertices.size();
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+QGeoMapObjectQSGSupport::~QGeoMapObjectQSGSupport()
+{
+    // The nodes belong to the scene graph
+    qDeleteAll(m_batches);
+    qDeleteAll(m_iconPages);
+}
+
+
 static int findMapObject(QGeoMapObject *o, const QList<MapObject> &list)
 {
     for (int i = 0; i < list.size(); ++i)
@@ -131,14 +358,17 @@ QList<QGeoMapObject *> QGeoMapObjectQSGSupport::mapObjects() const
 
 void QGeoMapObjectQSGSupport::removeMapObject(QGeoMapObject *obj)
 {
-    int idx = findMapObject(obj, m_mapObjects);
-    if (idx >= 0) {
-        const MapObject &mo = m_mapObjects.takeAt(idx);
+    const int slot = m_slots.value(obj, -1);
+    if (slot >= 0) {
+        const MapObject mo = m_mapObjects.at(slot);
+        takeMapObject(slot);
+        m_slots.remove(obj);
         obj->disconnect(m_map);
-        m_removedMapObjects << mo;
+        if (mo.qsgNode)
+            m_removedMapObjects << mo;
         emit m_map->sgNodeChanged();
     } else {
-        idx = findMapObject(obj, m_pendingMapObjects);
+        int idx = findMapObject(obj, m_pendingMapObjects);
         if (idx >= 0) {
             m_pendingMapObjects.removeAt(idx);
             obj->disconnect(m_map);
@@ -162,15 +392,61 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
     }
     m_removedMapObjects.clear();
 
-    for (int i = 0; i < m_mapObjects.size(); ++i) {
+    // Objects whose bounds changed since the last camera change may have
+    // moved in or out of the viewport. Their geometry is already up to date.
+    if (!m_boundsDirty.isEmpty()) {
+        const QVector<int> dirty = m_boundsDirty;
+        m_boundsDirty.clear();
+        for (int slot : dirty) {
+            updateBounds(slot);
+            const bool inView = isInViewport(m_mapObjects.at(slot));
+            if (inView && m_mapObjects.at(slot).viewPosition < 0)
+                showObject(slot);
+            else if (!inView && m_mapObjects.at(slot).viewPosition >= 0)
+                cullObject(slot);
+        }
+    }
+
+    for (int slot : qAsConst(m_culledObjects)) {
+        MapObject &mo = m_mapObjects[slot];
+        if (!mo.sgObject || mo.viewPosition >= 0 || !mo.visibleNode)
+            continue;
+        if (mo.visibleNode->visible()) {
+            mo.visibleNode->setVisible(false);
+            mo.qsgNode->markDirty(QSGNode::DirtySubtreeBlocked);
+        }
+    }
+    m_culledObjects.clear();
+
+    for (int slot : qAsConst(m_visibleObjects)) {
+        MapObject &mo = m_mapObjects[slot];
         // already added as node
-        if (Q_UNLIKELY(!m_mapObjects.at(i).object)) {
-            qWarning() << "unexpected NULL pointer in m_mapObjects at "<<i;
+        if (Q_UNLIKELY(!mo.object)) {
+            qWarning() << "unexpected NULL pointer in m_mapObjects at "<<slot;
             continue;
         }
 
-        MapObject &mo = m_mapObjects[i];
         QQSGMapObject *sgo = mo.sgObject;
+        if (QQSGMapObjectIcon *icon = sgo->batchIcon()) {
+            updateIcon(slot, icon);
+            continue;
+        }
+
+        QQSGMapObjectStyle style;
+        QGeoMapItemGeometry *fill = nullptr;
+        QGeoMapItemGeometry *border = nullptr;
+        if (sgo->batchGeometry(&style, &fill, &border)) {
+            if (!mo.object->visible()) {
+                leaveBatch(slot);
+            } else if (!mo.batch || !(mo.batch->style == style)) {
+                leaveBatch(slot);
+                joinBatch(slot, style);
+            } else if ((fill && fill->isScreenDirty()) || (border && border->isScreenDirty())) {
+                mo.batch->dirty = true;
+            }
+            continue;
+        }
+
         QSGNode *oldNode = mo.qsgNode;
         mo.qsgNode = sgo->updateMapObjectNode(oldNode, &mo.visibleNode, root, window);
         if (Q_UNLIKELY(!mo.qsgNode)) {
@@ -181,44 +457,705 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
         }
     }
 
-    QList<int> toRemove;
+    QList<MapObject> stillPending;
     for (int i = 0; i < m_pendingMapObjects.size(); ++i) {
         // already added as node
         MapObject &mo = m_pendingMapObjects[i];
         QQSGMapObject *sgo = mo.sgObject;
-        QSGNode *oldNode = mo.qsgNode;
         sgo->updateGeometry(); // or subtree will be blocked
-        mo.qsgNode = sgo->updateMapObjectNode(oldNode, &mo.visibleNode, root, window);
-        if (mo.qsgNode) {
+
+        QQSGMapObjectStyle style;
+        QGeoMapItemGeometry *fill = nullptr;
+        QGeoMapItemGeometry *border = nullptr;
+        QQSGMapObjectIcon *icon = sgo->batchIcon();
+        const bool batched = !icon && sgo->batchGeometry(&style, &fill, &border);
+        if (!batched && !icon) {
+            QSGNode *oldNode = mo.qsgNode;
+            mo.qsgNode = sgo->updateMapObjectNode(oldNode, &mo.visibleNode, root, window);
+            if (!mo.qsgNode) {
+                // leave it to be processed, don't spit warnings
+                stillPending << mo;
+                continue;
+            }
             if (mo.visibleNode && (mo.visibleNode->visible() != mo.object->visible())) {
                 mo.visibleNode->setVisible(mo.object->visible());
                 mo.qsgNode->markDirty(QSGNode::DirtySubtreeBlocked);
             }
-            m_mapObjects << mo;
-            toRemove.push_front(i);
-            QObject::connect(mo.object, SIGNAL(visibleChanged()), m_map, SIGNAL(sgNodeChanged()));
-        } else {
-            // leave it to be processed, don't spit warnings
+        }
+
+        const int slot = addMapObject(mo);
+        if (m_mapObjects.at(slot).viewPosition < 0) {
+            if (m_mapObjects.at(slot).visibleNode) {
+                m_mapObjects.at(slot).visibleNode->setVisible(false);
+                m_mapObjects.at(slot).qsgNode->markDirty(QSGNode::DirtySubtreeBlocked);
+            }
+        } else if (icon) {
+            updateIcon(slot, icon);
+        } else if (batched && mo.object->visible()) {
+            joinBatch(slot, style);
+        }
+
+        QGeoMapObject *obj = mo.object;
+        QObject::connect(obj, SIGNAL(visibleChanged()), m_map, SIGNAL(sgNodeChanged()));
+        auto invalidate = [this, obj]() { invalidateBounds(obj); };
+        switch (obj->type()) {
+        case QGeoMapObject::PolylineType:
+            QObject::connect(static_cast<QMapPolylineObject *>(obj), &QMapPolylineObject::pathChanged, m_map, invalidate);
+            break;
+        case QGeoMapObject::PolygonType:
+            QObject::connect(static_cast<QMapPolygonObject *>(obj), &QMapPolygonObject::pathChanged, m_map, invalidate);
+            break;
+        case QGeoMapObject::CircleType:
+            QObject::connect(static_cast<QMapCircleObject *>(obj), &QMapCircleObject::centerChanged, m_map, invalidate);
+            QObject::connect(static_cast<QMapCircleObject *>(obj), &QMapCircleObject::radiusChanged, m_map, invalidate);
+            break;
+        case QGeoMapObject::RouteType:
+            QObject::connect(static_cast<QMapRouteObject *>(obj), &QMapRouteObject::routeChanged, m_map, invalidate);
+            break;
+        case QGeoMapObject::IconType:
+            QObject::connect(static_cast<QMapIconObject *>(obj), &QMapIconObject::coordinateChanged, m_map, invalidate);
+            break;
+        default:
+            break;
         }
     }
+    m_pendingMapObjects.swap(stillPending);
 
-    for (int i: qAsConst(toRemove))
-        m_pendingMapObjects.removeAt(i);
+    // Drop the batches left empty, runs of the same style they separated
+    // are drawn by one batch again
+    for (int i = 0; i < m_batches.size(); ) {
+        QGeoMapObjectQSGBatch *batch = m_batches.at(i);
+        if (batch->members.isEmpty() || (i > 0 && m_batches.at(i - 1)->style == batch->style)) {
+            if (!batch->members.isEmpty())
+                mergeBatch(i);
+            if (batch->node) {
+                root->removeChildNode(batch->node);
+                delete batch->node;
+            }
+            m_batches.removeAt(i);
+            delete batch;
+            continue;
+        }
+        ++i;
+    }
+    // In stacking order, so new nodes are placed after the ones below them
+    for (int i = 0; i < m_batches.size(); ++i) {
+        if (m_batches.at(i)->dirty)
+            updateBatch(i, root);
+    }
+
+    if (!m_iconPages.isEmpty() && !m_iconRoot) {
+        m_iconRoot = new QSGNode;
+        root->appendChildNode(m_iconRoot);
+    }
+    for (int i = m_iconPages.size() - 1; i >= 0; --i) {
+        QGeoMapObjectQSGIconPage *page = m_iconPages.at(i);
+        if (page->references > 0 || !page->members.isEmpty()) {
+            updateIconPage(page, window);
+            continue;
+        }
+        if (page->node) {
+            m_iconRoot->removeChildNode(page->node);
+            delete page->node;
+        }
+        for (auto it = m_iconAtlas.begin(); it != m_iconAtlas.end(); ) {
+            if (it->page == page)
+                it = m_iconAtlas.erase(it);
+            else
+                ++it;
+        }
+        delete page;
+        m_iconPages.removeAt(i);
+    }
+
+    // Icons are drawn above the batches and the other object nodes, which
+    // may have been appended after the icon root
+    if (m_iconRoot && m_iconPages.isEmpty()) {
+        root->removeChildNode(m_iconRoot);
+        delete m_iconRoot;
+        m_iconRoot = nullptr;
+    } else if (m_iconRoot && root->lastChild() != m_iconRoot) {
+        root->removeChildNode(m_iconRoot);
+        root->appendChildNode(m_iconRoot);
+    }
 }
 
 void QGeoMapObjectQSGSupport::updateObjectsGeometry()
 {
-    for (int i = 0; i < m_mapObjects.size(); ++i) {
+    const bool culling = updateViewport();
+
+    for (int slot : qAsConst(m_boundsDirty))
+        updateBounds(slot);
+    m_boundsDirty.clear();
+
+    const int stamp = ++m_viewStamp;
+    QVector<int> inView;
+    auto visit = [&](int slot) {
+        MapObject &mo = m_mapObjects[slot];
+        if (mo.viewStamp == stamp || !isInViewport(mo))
+            return;
+        mo.viewStamp = stamp;
+        inView.append(slot);
+    };
+
+    if (!culling) {
+        for (int slot = 0; slot < m_mapObjects.size(); ++slot) {
+            if (m_mapObjects.at(slot).sgObject)
+                visit(slot);
+        }
+    } else {
+        for (int slot : qAsConst(m_unindexed))
+            visit(slot);
+
+        const int firstColumn = gridColumn(m_viewport.left());
+        const int lastColumn = gridColumn(m_viewport.right());
+        const int firstRow = gridRow(m_viewport.top());
+        const int lastRow = gridRow(m_viewport.bottom());
+        const int columns = qMin(lastColumn - firstColumn + 1, gridSize);
+        const int rows = lastRow - firstRow + 1;
+        if (columns * rows >= m_grid.size()) {
+            // Zoomed out, cheaper to test everything
+            for (const QVector<int> &cell : qAsConst(m_grid)) {
+                for (int slot : cell)
+                    visit(slot);
+            }
+        } else {
+            for (int row = firstRow; row <= lastRow; ++row) {
+                for (int column = firstColumn; column < firstColumn + columns; ++column) {
+                    const auto cell = m_grid.constFind(row * gridSize + wrapColumn(column));
+                    if (cell == m_grid.constEnd())
+                        continue;
+                    for (int slot : *cell)
+                        visit(slot);
+                }
+            }
+        }
+    }
+
+    for (int i = m_visibleObjects.size() - 1; i >= 0; --i) {
+        const int slot = m_visibleObjects.at(i);
+        if (m_mapObjects.at(slot).viewStamp != stamp)
+            cullObject(slot);
+    }
+
+    for (int slot : qAsConst(inView)) {
+        MapObject &mo = m_mapObjects[slot];
         // already added as node
-        if (Q_UNLIKELY(!m_mapObjects.at(i).object)) {
-            qWarning() << "unexpected NULL pointer in m_mapObjects at "<<i;
+        if (Q_UNLIKELY(!mo.object)) {
+            qWarning() << "unexpected NULL pointer in m_mapObjects at "<<slot;
             continue;
         }
-
-        QQSGMapObject *sgo = m_mapObjects.at(i).sgObject;
-        sgo->updateGeometry();
+        if (mo.viewPosition < 0)
+            showObject(slot);
+        mo.sgObject->updateGeometry();
     }
     emit m_map->sgNodeChanged();
 }
 
+int QGeoMapObjectQSGSupport::addMapObject(const MapObject &mo)
+{
+    int slot;
+    if (m_freeSlots.isEmpty()) {
+        slot = m_mapObjects.size();
+        m_mapObjects.append(mo);
+    } else {
+        slot = m_freeSlots.takeLast();
+        m_mapObjects[slot] = mo;
+    }
+    m_slots.insert(mo.object.data(), slot);
+    m_mapObjects[slot].order = m_nextOrder++;
+
+    updateBounds(slot);
+    if (isInViewport(m_mapObjects.at(slot)))
+        showObject(slot);
+    return slot;
+}
+
+void QGeoMapObjectQSGSupport::takeMapObject(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    if (mo.viewPosition >= 0)
+        cullObject(slot);
+    leaveBatch(slot);
+    hideIcon(slot);
+    releaseIcon(slot);
+    unindexObject(slot);
+    if (mo.boundsDirty)
+        m_boundsDirty.removeOne(slot);
+    mo = MapObject();
+    m_freeSlots.append(slot);
+}
+
+void QGeoMapObjectQSGSupport::invalidateBounds(QGeoMapObject *obj)
+{
+    const int slot = m_slots.value(obj, -1);
+    if (slot < 0 || m_mapObjects.at(slot).boundsDirty)
+        return;
+    m_mapObjects[slot].boundsDirty = true;
+    m_boundsDirty.append(slot);
+}
+
+void QGeoMapObjectQSGSupport::updateBounds(int slot)
+{
+    unindexObject(slot);
+    MapObject &mo = m_mapObjects[slot];
+    mo.boundsDirty = false;
+    const QGeoRectangle rect = mo.sgObject->boundingGeoRectangle();
+    mo.bounded = rect.isValid();
+    mo.bounds = mo.bounded ? mercatorBounds(rect) : QRectF();
+    indexObject(slot);
+}
+
+void QGeoMapObjectQSGSupport::indexObject(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    const int firstColumn = gridColumn(mo.bounds.left());
+    const int lastColumn = gridColumn(mo.bounds.right());
+    const int firstRow = gridRow(mo.bounds.top());
+    const int lastRow = gridRow(mo.bounds.bottom());
+    const int cellCount = (lastColumn - firstColumn + 1) * (lastRow - firstRow + 1);
+    if (!mo.bounded || cellCount > maxIndexedCells || lastColumn - firstColumn >= gridSize) {
+        mo.unindexed = true;
+        m_unindexed.append(slot);
+        return;
+    }
+
+    mo.cells.reserve(cellCount);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const int cell = row * gridSize + wrapColumn(column);
+            m_grid[cell].append(slot);
+            mo.cells.append(cell);
+        }
+    }
+}
+
+static void removeSlot(QVector<int> &list, int slot)
+{
+    const int i = list.indexOf(slot);
+    if (i < 0)
+        return;
+    list[i] = list.last();
+    list.removeLast();
+}
+
+void QGeoMapObjectQSGSupport::unindexObject(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    if (mo.unindexed) {
+        removeSlot(m_unindexed, slot);
+        mo.unindexed = false;
+    }
+    for (int cell : qAsConst(mo.cells)) {
+        auto it = m_grid.find(cell);
+        if (it == m_grid.end())
+            continue;
+        removeSlot(*it, slot);
+        if (it->isEmpty())
+            m_grid.erase(it);
+    }
+    mo.cells.clear();
+}
+
+/*
+    Updates the culling rectangle to the bounding box of the expanded visible
+    region. Returns false when culling is not possible, in which case every
+    object is considered in view.
+*/
+bool QGeoMapObjectQSGSupport::updateViewport()
+{
+    m_viewport = QRectF();
+    if (!m_map || m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
+        return false;
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator &>(m_map->geoProjection());
+    const QGeoProjectionWebMercator::Regions &regions = p.regions();
+    if (regions.visibleExpanded.isEmpty() || p.mapWidth() <= 0.0)
+        return false;
+
+    const double margin = viewportMargin / p.mapWidth();
+    m_viewport = regions.visibleExpandedBounds.adjusted(-margin, -margin, margin, margin);
+    return true;
+}
+
+bool QGeoMapObjectQSGSupport::isInViewport(const MapObject &mo) const
+{
+    if (!mo.bounded || m_viewport.isNull())
+        return true;
+    if (mo.bounds.top() > m_viewport.bottom() || mo.bounds.bottom() < m_viewport.top())
+        return false;
+    if (m_viewport.width() >= 1.0)
+        return true;
+
+    // The viewport spans [-1, 2] at most, and the objects [0, 2]
+    for (int wrap = -2; wrap <= 1; ++wrap) {
+        if (mo.bounds.left() + wrap <= m_viewport.right() && mo.bounds.right() + wrap >= m_viewport.left())
+            return true;
+    }
+    return false;
+}
+
+void QGeoMapObjectQSGSupport::showObject(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    mo.viewPosition = m_visibleObjects.size();
+    m_visibleObjects.append(slot);
+}
+
+void QGeoMapObjectQSGSupport::cullObject(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    const int last = m_visibleObjects.takeLast();
+    if (last != slot) {
+        m_visibleObjects[mo.viewPosition] = last;
+        m_mapObjects[last].viewPosition = mo.viewPosition;
+    }
+    mo.viewPosition = -1;
+    leaveBatch(slot);
+    hideIcon(slot);
+    if (mo.qsgNode)
+        m_culledObjects.append(slot);
+}
+
+/*
+    Adds the object to the batch drawing the objects around it in stacking
+    order, if they have the same style. Otherwise it gets a batch of its own,
+    splitting the one it falls into.
+*/
+void QGeoMapObjectQSGSupport::joinBatch(int slot, const QQSGMapObjectStyle &style)
+{
+    MapObject &mo = m_mapObjects[slot];
+    const int order = mo.order;
+    const auto it = std::lower_bound(m_batches.cbegin(), m_batches.cend(), order,
+                                     [](const QGeoMapObjectQSGBatch *batch, int order) {
+        return batch->last < order;
+    });
+    const int index = int(it - m_batches.cbegin());
+
+    QGeoMapObjectQSGBatch *batch = nullptr;
+    if (index < m_batches.size() && m_batches.at(index)->first <= order) {
+        batch = m_batches.at(index);
+        if (!(batch->style == style)) {
+            splitBatch(index, order);
+            batch = insertBatch(index + 1, style, order, order);
+        }
+    } else if (index > 0 && m_batches.at(index - 1)->style == style) {
+        batch = m_batches.at(index - 1);
+        batch->last = order;
+    } else if (index < m_batches.size() && m_batches.at(index)->style == style) {
+        batch = m_batches.at(index);
+        batch->first = order;
+    } else {
+        batch = insertBatch(index, style, order, order);
+    }
+
+    mo.batch = batch;
+    mo.batchPosition = batch->members.size();
+    batch->members.append(slot);
+    batch->dirty = true;
+}
+
+void QGeoMapObjectQSGSupport::leaveBatch(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    QGeoMapObjectQSGBatch *batch = mo.batch;
+    if (!batch)
+        return;
+    const int last = batch->members.takeLast();
+    if (last != slot) {
+        batch->members[mo.batchPosition] = last;
+        m_mapObjects[last].batchPosition = mo.batchPosition;
+    }
+    mo.batch = nullptr;
+    mo.batchPosition = -1;
+    batch->dirty = true;
+}
+
+QGeoMapObjectQSGBatch *QGeoMapObjectQSGSupport::insertBatch(int index, const QQSGMapObjectStyle &style,
+                                                             int first, int last)
+{
+    QGeoMapObjectQSGBatch *batch = new QGeoMapObjectQSGBatch;
+    batch->style = style;
+    batch->first = first;
+    batch->last = last;
+    m_batches.insert(index, batch);
+    return batch;
+}
+
+// Moves the members of the batch above the order into a new batch after it
+void QGeoMapObjectQSGSupport::splitBatch(int index, int order)
+{
+    QGeoMapObjectQSGBatch *batch = m_batches.at(index);
+    QVector<int> below;
+    QVector<int> above;
+    for (int slot : qAsConst(batch->members))
+        (m_mapObjects.at(slot).order < order ? below : above).append(slot);
+
+    const int last = batch->last;
+    batch->last = order - 1;
+    if (above.isEmpty())
+        return;
+
+    QGeoMapObjectQSGBatch *upper = insertBatch(index + 1, batch->style, order + 1, last);
+    for (int i = 0; i < below.size(); ++i)
+        m_mapObjects[below.at(i)].batchPosition = i;
+    for (int i = 0; i < above.size(); ++i) {
+        m_mapObjects[above.at(i)].batch = upper;
+        m_mapObjects[above.at(i)].batchPosition = i;
+    }
+    batch->members = below;
+    batch->dirty = true;
+    upper->members = above;
+}
+
+// Moves the members of the batch into the one below it, of the same style
+void QGeoMapObjectQSGSupport::mergeBatch(int index)
+{
+    QGeoMapObjectQSGBatch *batch = m_batches.at(index);
+    QGeoMapObjectQSGBatch *lower = m_batches.at(index - 1);
+    for (int slot : qAsConst(batch->members)) {
+        MapObject &mo = m_mapObjects[slot];
+        mo.batch = lower;
+        mo.batchPosition = lower->members.size();
+        lower->members.append(slot);
+    }
+    batch->members.clear();
+    lower->last = batch->last;
+    lower->dirty = true;
+}
+
+void QGeoMapObjectQSGSupport::updateBatch(int index, QSGNode *root)
+{
+    QGeoMapObjectQSGBatch *batch = m_batches.at(index);
+    if (!batch->node) {
+        batch->node = new QSGNode;
+        batch->fillNode = createBatchNode(batch->node, batch->style.fillColor);
+        batch->borderNode = createBatchNode(batch->node, batch->style.borderColor);
+        // The batches below have their nodes already
+        if (index > 0) {
+            root->insertChildNodeAfter(batch->node, m_batches.at(index - 1)->node);
+        } else {
+            QSGNode *above = nullptr;
+            for (int i = index + 1; i < m_batches.size() && !above; ++i)
+                above = m_batches.at(i)->node;
+            if (above)
+                root->insertChildNodeBefore(batch->node, above);
+            else
+                root->appendChildNode(batch->node);
+        }
+    }
+
+    QVector<const QGeoMapItemGeometry *> fills;
+    QVector<const QGeoMapItemGeometry *> borders;
+    fills.reserve(batch->members.size());
+    borders.reserve(batch->members.size());
+    for (int slot : qAsConst(batch->members)) {
+        QQSGMapObjectStyle style;
+        QGeoMapItemGeometry *fill = nullptr;
+        QGeoMapItemGeometry *border = nullptr;
+        m_mapObjects.at(slot).sgObject->batchGeometry(&style, &fill, &border);
+        if (fill) {
+            fills.append(fill);
+            fill->setPreserveGeometry(false);
+            fill->markClean();
+        }
+        if (border) {
+            borders.append(border);
+            border->setPreserveGeometry(false);
+            border->markClean();
+        }
+    }
+
+    // Polyline shapes are strips, the borders of polygons and circles too
+    fillBatchNode(batch->fillNode, fills, false);
+    fillBatchNode(batch->borderNode, borders, true);
+    batch->dirty = false;
+}
+
+/*
+    Keeps the quad of an icon in view in sync with its image, position and
+    visibility. Takes a reference to the atlas entry of the image the first
+    time the icon is shown.
+*/
+void QGeoMapObjectQSGSupport::updateIcon(int slot, QQSGMapObjectIcon *icon)
+{
+    MapObject &mo = m_mapObjects[slot];
+    if (icon->imageDirty) {
+        hideIcon(slot);
+        releaseIcon(slot);
+        icon->imageDirty = false;
+    }
+    if (!mo.object->visible() || icon->image.isNull()) {
+        hideIcon(slot);
+        return;
+    }
+
+    if (mo.iconKey.isEmpty())
+        acquireIcon(slot, *icon);
+    if (!mo.iconPage)
+        showIcon(slot);
+    else if (icon->rectDirty)
+        mo.iconPage->dirtyQuads.append(mo.iconPosition);
+    icon->rectDirty = false;
+}
+
+void QGeoMapObjectQSGSupport::acquireIcon(int slot, const QQSGMapObjectIcon &icon)
+{
+    const QString key = icon.source.isEmpty() ? QString::number(icon.image.cacheKey())
+                                              : icon.source;
+    auto it = m_iconAtlas.find(key);
+    if (it == m_iconAtlas.end()) {
+        const QSize size = icon.image.size();
+        QGeoMapObjectQSGIconPage *page = nullptr;
+        QPoint position;
+        if (size.width() > maxAtlasedIconSize || size.height() > maxAtlasedIconSize) {
+            page = new QGeoMapObjectQSGIconPage;
+            page->shared = false;
+            page->image = icon.image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            m_iconPages.append(page);
+        } else {
+            for (int i = m_iconPages.size() - 1; i >= 0; --i) {
+                if (m_iconPages.at(i)->shared) {
+                    if (placeIcon(m_iconPages.at(i), size, &position))
+                        page = m_iconPages.at(i);
+                    break;
+                }
+            }
+            if (!page) {
+                page = new QGeoMapObjectQSGIconPage;
+                page->image = QImage(iconPageSize, iconPageSize, QImage::Format_ARGB32_Premultiplied);
+                page->image.fill(Qt::transparent);
+                placeIcon(page, size, &position);
+                m_iconPages.append(page);
+            }
+            QPainter painter(&page->image);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.drawImage(position, icon.image);
+            page->imageDirty = true;
+        }
+
+        const QSizeF pageSize = page->image.size();
+        const QRectF textureRect(position.x() / pageSize.width(), position.y() / pageSize.height(),
+                                 size.width() / pageSize.width(), size.height() / pageSize.height());
+        it = m_iconAtlas.insert(key, IconAtlasEntry{page, textureRect, 0});
+    }
+
+    ++it->references;
+    ++it->page->references;
+    MapObject &mo = m_mapObjects[slot];
+    mo.iconKey = key;
+    mo.iconTextureRect = it->textureRect;
+}
+
+void QGeoMapObjectQSGSupport::releaseIcon(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    if (mo.iconKey.isEmpty())
+        return;
+
+    // Space on shared pages is not reclaimed, pages go away once unreferenced
+    auto it = m_iconAtlas.find(mo.iconKey);
+    if (it != m_iconAtlas.end()) {
+        --it->references;
+        --it->page->references;
+    }
+    mo.iconKey.clear();
+}
+
+void QGeoMapObjectQSGSupport::showIcon(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    QGeoMapObjectQSGIconPage *page = m_iconAtlas.value(mo.iconKey).page;
+    if (!page)
+        return;
+    mo.iconPage = page;
+    mo.iconPosition = page->members.size();
+    page->members.append(slot);
+    page->dirtyQuads.append(mo.iconPosition);
+}
+
+void QGeoMapObjectQSGSupport::hideIcon(int slot)
+{
+    MapObject &mo = m_mapObjects[slot];
+    QGeoMapObjectQSGIconPage *page = mo.iconPage;
+    if (!page)
+        return;
+    const int last = page->members.takeLast();
+    if (last != slot) {
+        page->members[mo.iconPosition] = last;
+        m_mapObjects[last].iconPosition = mo.iconPosition;
+        page->dirtyQuads.append(mo.iconPosition);
+    }
+    page->dirtyQuads.append(page->members.size()); // now unused
+    mo.iconPage = nullptr;
+    mo.iconPosition = -1;
+}
+
+/*
+    Uploads the page image if icons were added to it, and rewrites the quads
+    of the icons that moved, appeared or disappeared. The geometry only gets
+    reallocated when the page outgrows it. The upload waits for a window.
+*/
+void QGeoMapObjectQSGSupport::updateIconPage(QGeoMapObjectQSGIconPage *page, QQuickWindow *window)
+{
+    if (!page->node) {
+        page->node = new QGeoMapObjectQSGIconNode;
+        m_iconRoot->appendChildNode(page->node);
+    }
+    if (page->imageDirty && window) {
+        page->node->setTexture(window->createTextureFromImage(page->image));
+        page->imageDirty = false;
+    }
+
+    QSGGeometry *geometry = page->node->geometry();
+    if (!geometry || page->members.size() > page->capacity) {
+        page->capacity = qMax(64, page->members.size() * 2);
+        const int vertexCount = page->capacity * 4;
+        const int indexType = vertexCount > 0xffff ? QSGGeometry::UnsignedIntType
+                                                   : QSGGeometry::UnsignedShortType;
+        geometry = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(),
+                                   vertexCount, page->capacity * 6, indexType);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        geometry->setIndexDataPattern(QSGGeometry::StaticPattern);
+
+        static const int quadIndices[6] = { 0, 1, 2, 2, 1, 3 };
+        quint16 *shortIndices = indexType == QSGGeometry::UnsignedShortType ? geometry->indexDataAsUShort() : nullptr;
+        quint32 *intIndices = indexType == QSGGeometry::UnsignedIntType ? geometry->indexDataAsUInt() : nullptr;
+        for (int quad = 0; quad < page->capacity; ++quad) {
+            for (int i = 0; i < 6; ++i) {
+                const quint32 index = quad * 4 + quadIndices[i];
+                if (shortIndices)
+                    *shortIndices++ = quint16(index);
+                else
+                    *intIndices++ = index;
+            }
+        }
+        memset(geometry->vertexData(), 0, vertexCount * sizeof(QSGGeometry::TexturedPoint2D));
+        page->node->setGeometry(geometry);
+
+        page->dirtyQuads.clear();
+        for (int quad = 0; quad < page->members.size(); ++quad)
+            page->dirtyQuads.append(quad);
+    }
+
+    if (page->dirtyQuads.isEmpty())
+        return;
+
+    QSGGeometry::TexturedPoint2D *vertices = geometry->vertexDataAsTexturedPoint2D();
+    for (int quad : qAsConst(page->dirtyQuads)) {
+        if (quad >= page->capacity)
+            continue;
+        if (quad >= page->members.size()) {
+            setIconQuad(vertices + quad * 4, QRectF(), QRectF());
+            continue;
+        }
+        const MapObject &mo = m_mapObjects.at(page->members.at(quad));
+        setIconQuad(vertices + quad * 4, mo.sgObject->batchIcon()->rect, mo.iconTextureRect);
+    }
+    page->dirtyQuads.clear();
+    geometry->markVertexDataDirty();
+    page->node->markDirty(QSGNode::DirtyGeometry);
+}
+
 QT_END_NAMESPACE
@@ -58,10 +58,17 @@
 #include <QtLocation/private/qmapiconobjectqsg_p_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
+struct QGeoMapObjectQSGBatch;
+struct QGeoMapObjectQSGIconPage;
+
 struct Q_LOCATION_PRIVATE_EXPORT MapObject {
+    MapObject() {}
     MapObject(QPointer<QGeoMapObject> &o, QQSGMapObject *sgo)
         : object(o), sgObject(sgo) {}
 
@@ -69,11 +76,35 @@ struct Q_LOCATION_PRIVATE_EXPORT MapObject {
     QQSGMapObject *sgObject = nullptr; // this is a QMap*ObjectPrivateQSG. it becomes invalid when the pimpl is destroyed
     VisibleNode *visibleNode = nullptr; // This is a Map*Node (like a MapPolygonNode) that is a QSGNode. This doesn't disappear by itself
     QSGNode *qsgNode = nullptr;
+
+    // Culling. Bounds are in map projection coordinates, right may exceed 1
+    // for objects crossing the dateline
+    QRectF bounds;
+    QVector<int> cells;     // grid cells the object is listed in
+    bool bounded = false;   // false for objects that are never culled
+    bool boundsDirty = false;
+    bool unindexed = false; // listed in m_unindexed instead of the grid
+    int viewPosition = -1;  // index in m_visibleObjects, -1 when culled
+    int viewStamp = 0;      // last culling pass that found the object in view
+
+    // Batching. Objects are stacked in the order they were added
+    int order = -1;
+    QGeoMapObjectQSGBatch *batch = nullptr;
+    int batchPosition = -1;
+
+    // Icons. The atlas entry is held from the first time the icon is shown
+    // until its image changes or it is removed
+    QString iconKey;
+    QRectF iconTextureRect;
+    QGeoMapObjectQSGIconPage *iconPage = nullptr;
+    int iconPosition = -1;  // quad in the vertex buffer of iconPage
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoMapObjectQSGSupport
 {
 public:
+    ~QGeoMapObjectQSGSupport();
+
     bool createMapObjectImplementation(QGeoMapObject *obj, QGeoMapPrivate *d);
     QGeoMapObjectPrivate *createMapObjectImplementationPrivate(QGeoMapObject *obj);
     QList<QGeoMapObject *> mapObjects() const;
@@ -81,10 +112,67 @@ public:
     void updateMapObjects(QSGNode *root, QQuickWindow *window);
     void updateObjectsGeometry();
 
-    QList<MapObject> m_mapObjects;
+    // Objects that got a node, addressed by slot. Free slots have no sgObject
+    QVector<MapObject> m_mapObjects;
+    QVector<int> m_freeSlots;
+    QHash<QGeoMapObject *, int> m_slots;
     QList<MapObject> m_pendingMapObjects;
     QList<MapObject> m_removedMapObjects;
     QGeoMap *m_map = nullptr;
+
+    // Bounds of the objects bucketed on a fixed grid in map projection
+    // coordinates. Only the objects in the expanded viewport get their
+    // geometry updated and their nodes synchronized.
+    QHash<int, QVector<int> > m_grid;
+    QVector<int> m_unindexed;       // objects too large to bucket, or unbounded
+    QVector<int> m_visibleObjects;  // objects in the viewport
+    QVector<int> m_boundsDirty;
+    QVector<int> m_culledObjects;   // culled since the last synchronization
+    QRectF m_viewport;              // null when culling is not possible
+    int m_viewStamp = 0;
+
+    // Consecutive objects of the same style, in the order they were added,
+    // are drawn by one batch. Batches are kept in stacking order and cover
+    // disjoint ranges of object orders, a style used again after another one
+    // gets a new batch above it.
+    QVector<QGeoMapObjectQSGBatch *> m_batches;
+    int m_nextOrder = 0;
+
+    // Icon images packed into pages, each drawn by one node. The page nodes
+    // are children of m_iconRoot, which is kept as the last child of the map
+    // root: icons are drawn above polylines, polygons and the other objects.
+    struct IconAtlasEntry {
+        QGeoMapObjectQSGIconPage *page;
+        QRectF textureRect;
+        int references;
+    };
+    QHash<QString, IconAtlasEntry> m_iconAtlas;
+    QVector<QGeoMapObjectQSGIconPage *> m_iconPages;
+    QSGNode *m_iconRoot = nullptr;
+
+private:
+    int addMapObject(const MapObject &mo);
+    void takeMapObject(int slot);
+    void invalidateBounds(QGeoMapObject *obj);
+    void updateBounds(int slot);
+    void indexObject(int slot);
+    void unindexObject(int slot);
+    bool updateViewport();
+    bool isInViewport(const MapObject &mo) const;
+    void showObject(int slot);
+    void cullObject(int slot);
+    void joinBatch(int slot, const QQSGMapObjectStyle &style);
+    void leaveBatch(int slot);
+    QGeoMapObjectQSGBatch *insertBatch(int index, const QQSGMapObjectStyle &style, int first, int last);
+    void splitBatch(int index, int order);
+    void mergeBatch(int index);
+    void updateBatch(int index, QSGNode *root);
+    void acquireIcon(int slot, const QQSGMapObjectIcon &icon);
+    void releaseIcon(int slot);
+    void updateIcon(int slot, QQSGMapObjectIcon *icon);
+    void showIcon(int slot);
+    void hideIcon(int slot);
+    void updateIconPage(QGeoMapObjectQSGIconPage *page, QQuickWindow *window);
 };
 
 QT_END_NAMESPACE
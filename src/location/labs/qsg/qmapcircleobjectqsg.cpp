@@ -35,6 +35,7 @@
 ****************************************************************************/
 
 #include "qmapcircleobjectqsg_p_p.h"
+#include <QtPositioning/QGeoCircle>
 
 QT_BEGIN_NAMESPACE
 
@@ -179,6 +180,24 @@ QSGNode *QMapCircleObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
     return node;
 }
 
+QGeoRectangle QMapCircleObjectPrivateQSG::boundingGeoRectangle() const
+{
+    if (!qIsFinite(m_radius) || !m_center.isValid())
+        return QGeoRectangle();
+    return QGeoCircle(m_center, m_radius).boundingGeoRectangle();
+}
+
+bool QMapCircleObjectPrivateQSG::batchGeometry(QQSGMapObjectStyle *style,
+                                               QGeoMapItemGeometry **fill,
+                                               QGeoMapItemGeometry **border)
+{
+    style->type = QGeoMapObject::CircleType;
+    style->fillColor = color().rgba();
+    style->borderColor = borderColor().rgba();
+    *fill = &m_geometry;
+    *border = &m_borderGeometry;
+    return true;
+}
 
 void QMapCircleObjectPrivateQSG::setCenter(const QGeoCoordinate &center)
 {
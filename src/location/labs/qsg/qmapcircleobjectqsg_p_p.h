@@ -76,6 +76,10 @@ public:
                                  VisibleNode **visibleNode,
                                  QSGNode *root,
                                  QQuickWindow *window) override;
+    QGeoRectangle boundingGeoRectangle() const override;
+    bool batchGeometry(QQSGMapObjectStyle *style,
+                       QGeoMapItemGeometry **fill,
+                       QGeoMapItemGeometry **border) override;
 
     // QGeoMapCirclePrivate interface
     void setCenter(const QGeoCoordinate &center) override;
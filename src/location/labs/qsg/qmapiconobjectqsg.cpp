@@ -43,6 +43,10 @@
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqml.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qmutex.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -89,7 +93,11 @@ void QMapIconObjectPrivateQSG::updateGeometry()
     if (m_itemPosition.isFinite()) {
         m_transformation.setToIdentity();
         m_transformation.translate(QVector3D(m_itemPosition.x(), m_itemPosition.y(), 0));
+        m_icon.rect = QRectF(m_itemPosition.toPointF(), size());
+    } else {
+        m_icon.rect = QRectF();
     }
+    m_icon.rectDirty = true;
 
     // TODO: support and test for zoomLevel
 }
@@ -113,8 +121,8 @@ QSGNode *QMapIconObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
 
     if (m_imageDirty) {
         m_imageDirty = false;
-        m_imageNode->setTexture(window->createTextureFromImage(m_image));
-        QRect rect = m_image.rect();
+        m_imageNode->setTexture(window->createTextureFromImage(m_icon.image));
+        QRect rect = m_icon.image.rect();
         m_imageNode->setSourceRect(rect);
         m_imageNode->setRect(QRectF(QPointF(0,0), m_size));
     }
@@ -135,6 +143,20 @@ QSGNode *QMapIconObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
     return node;
 }
 
+QGeoRectangle QMapIconObjectPrivateQSG::boundingGeoRectangle() const
+{
+    // The icon extends from its coordinate in screen space, which the
+    // culling margin accounts for
+    if (!coordinate().isValid())
+        return QGeoRectangle();
+    return QGeoRectangle(coordinate(), coordinate());
+}
+
+QQSGMapObjectIcon *QMapIconObjectPrivateQSG::batchIcon()
+{
+    return &m_icon;
+}
+
 void QMapIconObjectPrivateQSG::setCoordinate(const QGeoCoordinate &coordinate)
 {
     QMapIconObjectPrivateDefault::setCoordinate(coordinate);
@@ -153,9 +175,32 @@ static inline QString imageId(const QUrl &url)
     return url.toString(QUrl::RemoveScheme | QUrl::RemoveAuthority).mid(1);
 }
 
+// Icons are typically created in large numbers from a handful of files, decode
+// each of them once. The modification time is part of the key, so that a file
+// rewritten on disk is decoded again, and returned in key to identify the image
+// in the icon atlas as well
+static QImage loadImage(const QString &fileName, QString *key)
+{
+    static QBasicMutex mutex;
+    static QCache<QString, QImage> cache(16 * 1024); // in KiB
+
+    const QDateTime modified = QFileInfo(fileName).lastModified();
+    *key = fileName + QLatin1Char('@') + QString::number(modified.toMSecsSinceEpoch());
+
+    QMutexLocker locker(&mutex);
+    if (const QImage *image = cache.object(*key))
+        return *image;
+    const QImage image(fileName);
+    if (!image.isNull())
+        cache.insert(*key, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+    return image;
+}
+
 void QMapIconObjectPrivateQSG::clearContent()
 {
-    m_image = QImage();
+    m_icon.source.clear();
+    m_icon.image = QImage();
+    m_icon.imageDirty = true;
 }
 
 void QMapIconObjectPrivateQSG::setContent(const QVariant &content)
@@ -177,19 +222,20 @@ void QMapIconObjectPrivateQSG::setContent(const QVariant &content)
             // Supporting only image providers for now
             const QUrl url = content.toUrl();
             if (!url.isValid()) {
-                m_image = QImage(content.toString());
+                m_icon.image = loadImage(content.toString(), &m_icon.source);
                 m_imageDirty = true;
                 updateGeometry();
             } else if (url.scheme().isEmpty() || url.scheme() == QLatin1String("file")) {
-                m_image = QImage(url.toString(QUrl::RemoveScheme));
+                m_icon.image = loadImage(url.toString(QUrl::RemoveScheme), &m_icon.source);
                 m_imageDirty = true;
                 updateGeometry();
             } else if (url.scheme() == QLatin1String("image")) {
                 QQuickImageProvider *provider = static_cast<QQuickImageProvider *>(engine->imageProvider(url.host()));
                 QSize outSize;
-                m_image = provider->requestImage(imageId(url), &outSize, QSize());
+                m_icon.image = provider->requestImage(imageId(url), &outSize, QSize());
                 if (outSize.isEmpty())
                     break;
+                m_icon.source = url.toString();
                 m_imageDirty = true;
                 updateGeometry();
             } else { // ToDo: Use QNAM
@@ -73,6 +73,8 @@ public:
                                  VisibleNode **visibleNode,
                                  QSGNode *root,
                                  QQuickWindow *window) override;
+    QGeoRectangle boundingGeoRectangle() const override;
+    QQSGMapObjectIcon *batchIcon() override;
 
     // QGeoMapIconPrivate interface
     void setCoordinate(const QGeoCoordinate &coordinate) override;
@@ -86,7 +88,7 @@ public:
     // Data Members
     bool m_imageDirty = false;
     bool m_geometryDirty = false;
-    QImage m_image;
+    QQSGMapObjectIcon m_icon; // holds the image
     QSGImageNode *m_imageNode = nullptr;
     QDoubleVector2D m_itemPosition;
     QMatrix4x4 m_transformation;
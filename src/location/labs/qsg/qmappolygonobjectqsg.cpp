@@ -107,6 +107,23 @@ QSGNode *QMapPolygonObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
     return node;
 }
 
+QGeoRectangle QMapPolygonObjectPrivateQSG::boundingGeoRectangle() const
+{
+    return m_geoPath.boundingGeoRectangle();
+}
+
+bool QMapPolygonObjectPrivateQSG::batchGeometry(QQSGMapObjectStyle *style,
+                                                QGeoMapItemGeometry **fill,
+                                                QGeoMapItemGeometry **border)
+{
+    style->type = QGeoMapObject::PolygonType;
+    style->fillColor = fillColor().rgba();
+    style->borderColor = borderColor().rgba();
+    *fill = &m_geometry;
+    *border = &m_borderGeometry;
+    return true;
+}
+
 QList<QGeoCoordinate> QMapPolygonObjectPrivateQSG::path() const
 {
     return m_geoPath.path();
@@ -72,6 +72,10 @@ public:
                                  VisibleNode **visibleNode,
                                  QSGNode *root,
                                  QQuickWindow *window) override;
+    QGeoRectangle boundingGeoRectangle() const override;
+    bool batchGeometry(QQSGMapObjectStyle *style,
+                       QGeoMapItemGeometry **fill,
+                       QGeoMapItemGeometry **border) override;
 
     // QGeoMapPolylinePrivate interface
     QList<QGeoCoordinate> path() const override;
@@ -65,18 +65,22 @@ QMapPolylineObjectPrivateQSG::~QMapPolylineObjectPrivateQSG()
         m_map->removeMapObject(q);
 }
 
-QList<QDoubleVector2D> QMapPolylineObjectPrivateQSG::projectPath()
+// Projected once per path, camera changes only select other points of it
+QGeoSimplifiedPath &QMapPolylineObjectPrivateQSG::projectPath()
 {
-    QList<QDoubleVector2D> geopathProjected_;
-    if (!m_map || m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-        return geopathProjected_;
+    if (!m_projectedPathDirty || !m_map
+            || m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
+        return m_projectedPath;
 
     const QGeoProjectionWebMercator &p =
             static_cast<const QGeoProjectionWebMercator&>(m_map->geoProjection());
+    QList<QDoubleVector2D> geopathProjected_;
     geopathProjected_.reserve(m_geoPath.path().size());
     for (const QGeoCoordinate &c : m_geoPath.path())
         geopathProjected_ << p.geoToMapProjection(c);
-    return geopathProjected_;
+    m_projectedPath.setPath(geopathProjected_);
+    m_projectedPathDirty = false;
+    return m_projectedPath;
 }
 
 void QMapPolylineObjectPrivateQSG::updateGeometry()
@@ -88,7 +92,8 @@ void QMapPolylineObjectPrivateQSG::updateGeometry()
     QScopedValueRollback<bool> rollback(m_updatingGeometry);
     m_updatingGeometry = true;
     m_geometry.markSourceDirty();
-    const QList<QDoubleVector2D> &geopathProjected = projectPath();
+    const QList<QDoubleVector2D> &geopathProjected
+            = projectPath().simplified(QGeoSimplifiedPath::tolerance(*m_map.data()));
     m_geometry.setPreserveGeometry(true, m_geoPath.boundingGeoRectangle().topLeft());
     m_geometry.updateSourcePoints(*m_map.data(), geopathProjected, m_geoPath.boundingGeoRectangle().topLeft());
     m_geometry.updateScreenPoints(*m_map.data(), width(), false);
@@ -127,6 +132,23 @@ QSGNode *QMapPolylineObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
     return node;
 }
 
+QGeoRectangle QMapPolylineObjectPrivateQSG::boundingGeoRectangle() const
+{
+    return m_geoPath.boundingGeoRectangle();
+}
+
+bool QMapPolylineObjectPrivateQSG::batchGeometry(QQSGMapObjectStyle *style,
+                                                 QGeoMapItemGeometry **fill,
+                                                 QGeoMapItemGeometry **border)
+{
+    style->type = QGeoMapObject::PolylineType;
+    style->fillColor = 0;
+    style->borderColor = color().rgba();
+    *fill = nullptr;
+    *border = &m_geometry;
+    return true;
+}
+
 QList<QGeoCoordinate> QMapPolylineObjectPrivateQSG::path() const { return m_geoPath.path(); }
 
 QColor QMapPolylineObjectPrivateQSG::color() const { return m_color; }
@@ -136,6 +158,7 @@ qreal QMapPolylineObjectPrivateQSG::width() const { return m_width; }
 void QMapPolylineObjectPrivateQSG::setPath(const QList<QGeoCoordinate> &path)
 {
     m_geoPath.setPath(path);
+    m_projectedPathDirty = true;
     updateGeometry();
 
     if (m_map)
@@ -51,6 +51,7 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qmappolylineobject_p_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+#include <QtLocation/private/qgeosimplifiedpath_p.h>
 #include <QtLocation/private/qmappolylineobject_p.h>
 #include <QtLocation/private/qqsgmapobject_p.h>
 #include <QtCore/qscopedvaluerollback.h>
@@ -64,7 +65,7 @@ public:
     QMapPolylineObjectPrivateQSG(const QMapPolylineObjectPrivate &other);
     ~QMapPolylineObjectPrivateQSG() override;
 
-    QList<QDoubleVector2D> projectPath();
+    QGeoSimplifiedPath &projectPath();
 
     // QQSGMapObject
     void updateGeometry() override;
@@ -72,6 +73,10 @@ public:
                                  VisibleNode **visibleNode,
                                  QSGNode *root,
                                  QQuickWindow *window) override;
+    QGeoRectangle boundingGeoRectangle() const override;
+    bool batchGeometry(QQSGMapObjectStyle *style,
+                       QGeoMapItemGeometry **fill,
+                       QGeoMapItemGeometry **border) override;
 
     // QGeoMapPolylinePrivate interface
     QList<QGeoCoordinate> path() const override;
@@ -88,6 +93,8 @@ public:
     // Data Members
     QGeoMapPolylineGeometry m_geometry;
     QGeoPath m_geoPath;
+    QGeoSimplifiedPath m_projectedPath;
+    bool m_projectedPathDirty = true; // set whenever m_geoPath changes
 
     QColor m_color;
     qreal m_width = 0;
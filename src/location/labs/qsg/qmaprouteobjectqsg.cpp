@@ -74,6 +74,21 @@ QSGNode *QMapRouteObjectPrivateQSG::updateMapObjectNode(QSGNode *oldNode,
     return m_polyline->updateMapObjectNode(oldNode, visibleNode, root, window);
 }
 
+QGeoRectangle QMapRouteObjectPrivateQSG::boundingGeoRectangle() const
+{
+    return m_polyline->boundingGeoRectangle();
+}
+
+bool QMapRouteObjectPrivateQSG::batchGeometry(QQSGMapObjectStyle *style,
+                                              QGeoMapItemGeometry **fill,
+                                              QGeoMapItemGeometry **border)
+{
+    if (!m_polyline->batchGeometry(style, fill, border))
+        return false;
+    style->type = QGeoMapObject::RouteType;
+    return true;
+}
+
 void QMapRouteObjectPrivateQSG::setRoute(const QDeclarativeGeoRoute *route)
 {
     const QList<QGeoCoordinate> &path = route->route().path();
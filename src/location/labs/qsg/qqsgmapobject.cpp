@@ -63,6 +63,23 @@ void QQSGMapObject::updateGeometry()
 
 }
 
+QGeoRectangle QQSGMapObject::boundingGeoRectangle() const
+{
+    return QGeoRectangle();
+}
+
+bool QQSGMapObject::batchGeometry(QQSGMapObjectStyle * /*style*/,
+                                  QGeoMapItemGeometry ** /*fill*/,
+                                  QGeoMapItemGeometry ** /*border*/)
+{
+    return false;
+}
+
+QQSGMapObjectIcon *QQSGMapObject::batchIcon()
+{
+    return nullptr;
+}
+
 QT_END_NAMESPACE
 
 
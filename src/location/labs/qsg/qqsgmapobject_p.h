@@ -52,10 +52,49 @@
 #include <QtQuick/QSGOpacityNode>
 #include <QtLocation/private/qgeomapobject_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+#include <QtPositioning/QGeoRectangle>
+#include <QtGui/qrgb.h>
+#include <QtGui/qimage.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qhashfunctions.h>
 
 QT_BEGIN_NAMESPACE
 
 class QQuickWindow;
+class QGeoMapItemGeometry;
+
+// Objects of the same type drawn with the same flat colors share their nodes
+struct QQSGMapObjectStyle
+{
+    int type;
+    QRgb fillColor;
+    QRgb borderColor;
+
+    bool operator==(const QQSGMapObjectStyle &other) const
+    {
+        return type == other.type && fillColor == other.fillColor
+                && borderColor == other.borderColor;
+    }
+};
+
+inline uint qHash(const QQSGMapObjectStyle &style, uint seed = 0)
+{
+    return qHash(style.type, seed) ^ qHash(style.fillColor, seed)
+            ^ (qHash(style.borderColor, seed) << 1);
+}
+
+// Objects drawn as an image at a screen position. Icons with the same source
+// share one copy of the image in a texture atlas and are drawn together.
+struct QQSGMapObjectIcon
+{
+    QString source; // identifies the image, may be empty
+    QImage image;
+    QRectF rect;    // in item coordinates, null when the icon is not shown
+    bool imageDirty = true;
+    bool rectDirty = true;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QQSGMapObject
 {
 public:
@@ -67,6 +106,23 @@ public:
                                          QSGNode *root,
                                          QQuickWindow *window);
     virtual void updateGeometry();
+
+    // Used to skip the objects outside of the viewport. Objects returning an
+    // invalid rectangle are always updated.
+    virtual QGeoRectangle boundingGeoRectangle() const;
+
+    // Objects drawn as a flat colored fill and border return their screen
+    // geometry here, either may be null. They are then drawn by nodes shared
+    // with the objects of the same style and updateMapObjectNode() is not
+    // called for them.
+    virtual bool batchGeometry(QQSGMapObjectStyle *style,
+                               QGeoMapItemGeometry **fill,
+                               QGeoMapItemGeometry **border);
+
+    // Objects drawn as an image return it here, the dirty flags are reset by
+    // the caller. Like batched geometry, updateMapObjectNode() is then not
+    // called for them.
+    virtual QQSGMapObjectIcon *batchIcon();
 };
 
 QT_END_NAMESPACE
@@ -22,6 +22,8 @@ PRIVATE_HEADERS += \
                     maps/qgeocameracapabilities_p.h \
                     maps/qgeocameradata_p.h \
                     maps/qgeocameratiles_p.h \
+                    maps/qgeoconvexclipper_p.h \
+                    maps/qgeosimplifiedpath_p.h \
                     maps/qgeocodereply_p.h \
                     maps/qgeocodingmanagerengine_p.h \
                     maps/qgeocodingmanager_p.h \
@@ -54,7 +56,11 @@ PRIVATE_HEADERS += \
                     maps/qgeotiledmapreply_p.h \
                     maps/qgeotiledmapreply_p_p.h \
                     maps/qgeotilespec_p.h \
-                    maps/qgeotilespec_p_p.h \
+                    maps/qgeotilearchive_p.h \
+                    maps/qgeotilesegmentstore_p.h \
+                    maps/qgeotilecachejournal_p.h \
+                    maps/qgeotileatlas_p.h \
+                    maps/qgeotilequadtree_p.h \
                     maps/qgeorouteparser_p.h \
                     maps/qgeorouteparser_p_p.h \
                     maps/qgeorouteparserosrmv5_p.h \
@@ -70,6 +76,8 @@ SOURCES += \
             maps/qgeocameracapabilities.cpp \
             maps/qgeocameradata.cpp \
             maps/qgeocameratiles.cpp \
+            maps/qgeoconvexclipper.cpp \
+            maps/qgeosimplifiedpath.cpp \
             maps/qgeocodereply.cpp \
             maps/qgeocodingmanager.cpp \
             maps/qgeocodingmanagerengine.cpp \
@@ -93,6 +101,11 @@ SOURCES += \
             maps/qgeofiletilecache.cpp \
             maps/qgeotiledmapreply.cpp \
             maps/qgeotilespec.cpp \
+            maps/qgeotilearchive.cpp \
+            maps/qgeotilesegmentstore.cpp \
+            maps/qgeotilecachejournal.cpp \
+            maps/qgeotileatlas.cpp \
+            maps/qgeotilequadtree.cpp \
             maps/qgeotiledmap.cpp \
             maps/qgeotiledmapscene.cpp \
             maps/qgeorouteparser.cpp \
@@ -73,6 +73,48 @@ void QAbstractGeoTileCache::printStats()
 {
 }
 
+/*
+    Returns the texture for \a spec if it can be provided right away.
+    Caches that decode tiles in the background return a null texture and set
+    \a pending to true when a decode has been scheduled; tileDecoded() or
+    tileDecodingFailed() is emitted once it completes. Passing a null \a pending
+    only returns textures that do not require scheduling any work.
+    The default implementation decodes synchronously through get().
+*/
+QSharedPointer<QGeoTileTexture> QAbstractGeoTileCache::requestTexture(const QGeoTileSpec &spec, bool *pending)
+{
+    if (pending)
+        *pending = false;
+    return get(spec);
+}
+
+/*
+    Returns a texture that can be shown in place of \a spec while it is being
+    loaded, or a null texture. The spec of the returned texture differs from
+    \a spec, so the tile itself is still requested. The default implementation
+    looks for an already decoded ancestor up to 4 zoom levels up.
+*/
+QSharedPointer<QGeoTileTexture> QAbstractGeoTileCache::placeholderTexture(const QGeoTileSpec &spec)
+{
+    QGeoTileSpec ancestor = spec;
+    const int endRange = qMax(0, spec.zoom() - 4); // Using up to 4 zoom levels up. 4 is arbitrary.
+    for (int z = spec.zoom() - 1; z >= endRange; z--) {
+        const int denominator = 1 << (spec.zoom() - z);
+        ancestor.setZoom(z);
+        ancestor.setX(spec.x() / denominator);
+        ancestor.setY(spec.y() / denominator);
+        QSharedPointer<QGeoTileTexture> tt = requestTexture(ancestor, nullptr);
+        if (tt && !tt->image.isNull())
+            return tt;
+    }
+    return QSharedPointer<QGeoTileTexture>();
+}
+
+void QAbstractGeoTileCache::cancelDecoding(const QSet<QGeoTileSpec> &tiles)
+{
+    Q_UNUSED(tiles);
+}
+
 void QAbstractGeoTileCache::handleError(const QGeoTileSpec &, const QString &error)
 {
     qWarning() << "tile request error " << error;
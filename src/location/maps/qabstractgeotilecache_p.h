@@ -123,6 +123,9 @@ public:
     virtual CostStrategy costStrategyTexture() const = 0;
 
     virtual QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) = 0;
+    virtual QSharedPointer<QGeoTileTexture> requestTexture(const QGeoTileSpec &spec, bool *pending = nullptr);
+    virtual QSharedPointer<QGeoTileTexture> placeholderTexture(const QGeoTileSpec &spec);
+    virtual void cancelDecoding(const QSet<QGeoTileSpec> &tiles);
 
     virtual void insert(const QGeoTileSpec &spec,
                 const QByteArray &bytes,
@@ -134,6 +137,10 @@ public:
     static QString baseCacheDirectory();
     static QString baseLocationCacheDirectory();
 
+Q_SIGNALS:
+    void tileDecoded(const QGeoTileSpec &spec);
+    void tileDecodingFailed(const QGeoTileSpec &spec, const QString &errorString);
+
 protected:
     QAbstractGeoTileCache(QObject *parent = 0);
     virtual void printStats() = 0;
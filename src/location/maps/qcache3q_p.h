@@ -171,6 +171,14 @@ public:
     // Copy data from specific queue into list
     void serializeQueue(int queueNumber, QList<QSharedPointer<T> > &buffer);
 
+    // Calls visitor(key, value, cost, popularity) for each node of a queue, front to back.
+    // Queue 4 holds the ghosts, which have no value.
+    template <typename Visitor>
+    void visitQueue(int queueNumber, Visitor visitor) const;
+    // Appends a node to the back of a queue, for restoring a visited state.
+    // Does not evict; the next insertion or setMaxCost() rebalances.
+    void restoreNode(int queueNumber, const Key &key, QSharedPointer<T> value, int cost, quint64 pop);
+
 private:
     int maxCost_, minRecent_, maxOldPopular_;
     int hitCount_, missCount_, promote_;
@@ -223,6 +231,50 @@ void QCache3Q<Key,T,EvPolicy>::serializeQueue(int queueNumber, QList<QSharedPoin
         buffer.append(node->v);
 }
 
+template <class Key, class T, class EvPolicy>
+template <typename Visitor>
+void QCache3Q<Key,T,EvPolicy>::visitQueue(int queueNumber, Visitor visitor) const
+{
+    Q_ASSERT(queueNumber >= 1 && queueNumber <= 4);
+    const Queue *queue = queueNumber == 1 ? q1_ :
+                         queueNumber == 2 ? q2_ :
+                         queueNumber == 3 ? q3_ :
+                                            q1_evicted_;
+    for (const Node *node = queue->f; node; node = node->n)
+        visitor(node->k, node->v, node->cost, node->pop);
+}
+
+template <class Key, class T, class EvPolicy>
+void QCache3Q<Key,T,EvPolicy>::restoreNode(int queueNumber, const Key &key, QSharedPointer<T> value,
+                                           int cost, quint64 pop)
+{
+    Q_ASSERT(queueNumber >= 1 && queueNumber <= 4);
+    if (lookup_.contains(key))
+        return;
+
+    Queue *queue = queueNumber == 1 ? q1_ :
+                   queueNumber == 2 ? q2_ :
+                   queueNumber == 3 ? q3_ :
+                                      q1_evicted_;
+    Node *node = new Node;
+    node->k = key;
+    node->v = value;
+    node->cost = queue == q1_evicted_ ? 0 : cost;
+    node->pop = pop;
+    node->q = queue;
+    node->n = 0;
+    node->p = queue->l;
+    if (queue->l)
+        queue->l->n = node;
+    queue->l = node;
+    if (!queue->f)
+        queue->f = node;
+    queue->pop += pop;
+    queue->cost += node->cost;
+    queue->size++;
+    lookup_[key] = node;
+}
+
 template <class Key, class T, class EvPolicy>
 void QCache3Q<Key,T,EvPolicy>::deserializeQueue(int queueNumber, const QList<Key> &keys,
                        const QList<QSharedPointer<T> > &values, const QList<int> &costs)
@@ -49,6 +49,7 @@
 #include <QPair>
 #include <QSet>
 #include <QSize>
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -157,50 +158,183 @@ int QGeoCameraTiles::tileSize() const
     return d_ptr->m_tileSize;
 }
 
+/*
+    With a tilted camera, tiles far from the eye cover few pixels. A non zero
+    \a threshold lets createTiles() replace them with tiles of lower zoom
+    levels, as long as their texels appear at most \a threshold times as
+    large as those at the center of the view.
+*/
+void QGeoCameraTiles::setDetailThreshold(double threshold)
+{
+    if (d_ptr->m_detailThreshold == threshold)
+        return;
+
+    d_ptr->m_detailThreshold = threshold;
+    d_ptr->m_tilesZoomLevel = -1;
+    d_ptr->m_dirtyTiles = true;
+}
+
+double QGeoCameraTiles::detailThreshold() const
+{
+    return d_ptr->m_detailThreshold;
+}
+
+// The lowest zoom level the level of detail may use
+void QGeoCameraTiles::setMinimumZoomLevel(int zoomLevel)
+{
+    if (d_ptr->m_minimumZoomLevel == zoomLevel)
+        return;
+
+    d_ptr->m_minimumZoomLevel = zoomLevel;
+    d_ptr->m_tilesZoomLevel = -1;
+    d_ptr->m_dirtyTiles = true;
+}
+
+int QGeoCameraTiles::minimumZoomLevel() const
+{
+    return d_ptr->m_minimumZoomLevel;
+}
+
 const QSet<QGeoTileSpec>& QGeoCameraTiles::createTiles()
+{
+    tileSpans();
+
+    if (d_ptr->m_dirtyMetadata) {
+        // The specs of all the tiles change
+        d_ptr->m_tilesZoomLevel = -1;
+        d_ptr->m_dirtyMetadata = false;
+        d_ptr->m_dirtyTiles = true;
+    }
+
+    if (d_ptr->m_dirtyTiles) {
+        if (!d_ptr->updateDetailTiles())
+            d_ptr->updateTiles();
+        d_ptr->m_dirtyTiles = false;
+    }
+
+    return d_ptr->m_tiles;
+}
+
+const QVector<QGeoCameraTileSpan> &QGeoCameraTiles::tileSpans()
 {
     if (d_ptr->m_dirtyGeometry) {
-        d_ptr->m_tiles.clear();
         d_ptr->updateGeometry();
         d_ptr->m_dirtyGeometry = false;
+        d_ptr->m_dirtyTiles = true;
     }
 
-    if (d_ptr->m_dirtyMetadata) {
-        d_ptr->updateMetadata();
-        d_ptr->m_dirtyMetadata = false;
+    return d_ptr->m_spans;
+}
+
+int QGeoCameraTiles::tileZoomLevel() const
+{
+    return d_ptr->m_intZoomLevel;
+}
+
+// Copies without sharing, so that the buffers keep their capacity
+static void copySpans(const QVector<QGeoCameraTileSpan> &from, QVector<QGeoCameraTileSpan> *to)
+{
+    to->resize(from.size());
+    std::copy(from.cbegin(), from.cend(), to->begin());
+}
+
+// Writes the tiles covered by the spans of a, but not by those of b. Both
+// are sorted by row and column and disjoint.
+static void subtractSpans(const QVector<QGeoCameraTileSpan> &a,
+                          const QVector<QGeoCameraTileSpan> &b,
+                          QVector<QGeoCameraTileSpan> *result)
+{
+    result->clear();
+    int j = 0;
+    for (const QGeoCameraTileSpan &span : a) {
+        while (j < b.size() && (b.at(j).y < span.y || (b.at(j).y == span.y && b.at(j).maxX < span.minX)))
+            ++j;
+
+        int x = span.minX;
+        for (int k = j; k < b.size() && b.at(k).y == span.y && b.at(k).minX <= span.maxX; ++k) {
+            if (b.at(k).minX > x)
+                result->append(QGeoCameraTileSpan{span.y, x, b.at(k).minX - 1});
+            x = qMax(x, b.at(k).maxX + 1);
+        }
+        if (x <= span.maxX)
+            result->append(QGeoCameraTileSpan{span.y, x, span.maxX});
     }
+}
 
-    return d_ptr->m_tiles;
+/*
+    Reports the spans of tiles that entered and left the coverage since the
+    previous call. Returns false, with both lists empty, when the coverages
+    are at different zoom levels or on the first call; tileSpans() then
+    has to be used instead.
+*/
+bool QGeoCameraTiles::tileSpanChanges(QVector<QGeoCameraTileSpan> *entered, QVector<QGeoCameraTileSpan> *left)
+{
+    tileSpans();
+
+    entered->clear();
+    left->clear();
+    const bool comparable = d_ptr->m_reportedZoomLevel == d_ptr->m_intZoomLevel;
+    if (comparable) {
+        subtractSpans(d_ptr->m_spans, d_ptr->m_reportedSpans, entered);
+        subtractSpans(d_ptr->m_reportedSpans, d_ptr->m_spans, left);
+    }
+
+    copySpans(d_ptr->m_spans, &d_ptr->m_reportedSpans);
+    d_ptr->m_reportedZoomLevel = d_ptr->m_intZoomLevel;
+    return comparable;
 }
 
 QGeoCameraTilesPrivate::QGeoCameraTilesPrivate()
 :   m_mapVersion(-1),
     m_tileSize(0),
+    m_tilesZoomLevel(-1),
+    m_reportedZoomLevel(-1),
+    m_detailThreshold(0.0),
+    m_minimumZoomLevel(0),
     m_intZoomLevel(0),
     m_sideLength(0),
     m_dirtyGeometry(false),
     m_dirtyMetadata(false),
+    m_dirtyTiles(false),
     m_viewExpansion(1.0)
 {
 }
 
 QGeoCameraTilesPrivate::~QGeoCameraTilesPrivate() {}
 
-void QGeoCameraTilesPrivate::updateMetadata()
+/*
+    Brings m_tiles to the current coverage. At an unchanged zoom level only
+    the tiles entering and leaving the coverage are inserted and removed.
+*/
+void QGeoCameraTilesPrivate::updateTiles()
 {
-    typedef QSet<QGeoTileSpec>::const_iterator iter;
-
-    QSet<QGeoTileSpec> newTiles;
-
-    iter i = m_tiles.constBegin();
-    iter end = m_tiles.constEnd();
+    QGeoTileSpec spec(m_pluginString, m_mapType.mapId(), m_intZoomLevel, -1, -1, m_mapVersion);
+
+    if (m_tilesZoomLevel == m_intZoomLevel) {
+        subtractSpans(m_tilesSpans, m_spans, &m_changedSpans);
+        for (const QGeoCameraTileSpan &span : qAsConst(m_changedSpans)) {
+            spec.setY(span.y);
+            for (int x = span.minX; x <= span.maxX; ++x) {
+                spec.setX(x);
+                m_tiles.remove(spec);
+            }
+        }
+        subtractSpans(m_spans, m_tilesSpans, &m_changedSpans);
+    } else {
+        m_tiles.clear();
+        copySpans(m_spans, &m_changedSpans);
+    }
 
-    for (; i != end; ++i) {
-        QGeoTileSpec tile = *i;
-        newTiles.insert(QGeoTileSpec(m_pluginString, m_mapType.mapId(), tile.zoom(), tile.x(), tile.y(), m_mapVersion));
+    for (const QGeoCameraTileSpan &span : qAsConst(m_changedSpans)) {
+        spec.setY(span.y);
+        for (int x = span.minX; x <= span.maxX; ++x) {
+            spec.setX(x);
+            m_tiles.insert(spec);
+        }
     }
 
-    m_tiles = newTiles;
+    copySpans(m_spans, &m_tilesSpans);
+    m_tilesZoomLevel = m_intZoomLevel;
 }
 
 void QGeoCameraTilesPrivate::updateGeometry()
@@ -213,32 +347,152 @@ void QGeoCameraTilesPrivate::updateGeometry()
 #endif
 
     // Find the polygon where the frustum intersects the plane of the map
-    PolygonVector footprint = frustumFootprint(f);
+    m_footprint = frustumFootprint(f);
+    m_eye = f.apex;
 #ifdef QT_LOCATION_DEBUG
-    m_frustumFootprint = footprint;
+    m_frustumFootprint = m_footprint;
 #endif
 
-    // Clip the polygon to the map, split it up if it cross the dateline
-    ClippedFootprint polygons = clipFootprintToMap(footprint);
-#ifdef QT_LOCATION_DEBUG
-    m_clippedFootprint = polygons;
-#endif
+    // Scan-convert it into rows of tiles, wrapping around the dateline
+    footprintSpans(m_footprint, &m_spans);
+}
 
+// The most zoom levels the level of detail goes below the camera's
+static const int maxDetailLevels = 4;
 
-    if (!polygons.left.isEmpty()) {
-        QSet<QGeoTileSpec> tilesLeft = tilesFromPolygon(polygons.left);
-        m_tiles.unite(tilesLeft);
+// Whether the closed rectangle and the convex polygon intersect
+static bool rectIntersectsPolygon(double minX, double minY, double maxX, double maxY,
+                                  const PolygonVector &polygon)
+{
+    // Separating axes: the axes of the rectangle, then the edge normals of
+    // the polygon
+    double centerX = 0.0;
+    double centerY = 0.0;
+    bool left = true, right = true, above = true, below = true;
+    for (const QDoubleVector3D &p : polygon) {
+        centerX += p.x();
+        centerY += p.y();
+        left = left && p.x() < minX;
+        right = right && p.x() > maxX;
+        above = above && p.y() < minY;
+        below = below && p.y() > maxY;
     }
+    if (left || right || above || below)
+        return false;
+    centerX /= polygon.size();
+    centerY /= polygon.size();
+
+    const double cornersX[] = { minX, maxX, maxX, minX };
+    const double cornersY[] = { minY, minY, maxY, maxY };
+    for (int i = 0; i < polygon.size(); ++i) {
+        const QDoubleVector3D &a = polygon.at(i);
+        const QDoubleVector3D &b = polygon.at((i + 1) % polygon.size());
+        const double nx = a.y() - b.y();
+        const double ny = b.x() - a.x();
+        const double tolerance = 1e-9 * (qAbs(nx) + qAbs(ny));
+        if (tolerance == 0.0)
+            continue;
+        const double inside = nx * (centerX - a.x()) + ny * (centerY - a.y()) < 0.0 ? -1.0 : 1.0;
+        bool separated = true;
+        for (int c = 0; c < 4 && separated; ++c)
+            separated = inside * (nx * (cornersX[c] - a.x()) + ny * (cornersY[c] - a.y())) < -tolerance;
+        if (separated)
+            return false;
+    }
+    return true;
+}
+
+/*
+    Covers the footprint with tiles of several zoom levels when the camera is
+    tilted. A tile is used instead of its four children when its texels appear
+    at most m_detailThreshold times as large as those at the center of the
+    view. Their apparent size is taken to be inversely proportional to their
+    depth, which overestimates it: the tilt also foreshortens them.
+
+    Returns false, without touching m_tiles, when all the tiles would be at
+    the camera's zoom level.
+*/
+bool QGeoCameraTilesPrivate::updateDetailTiles()
+{
+    if (m_detailThreshold <= 0.0 || m_footprint.size() < 3)
+        return false;
+
+    const int minZoom = qMax(qMax(m_minimumZoomLevel, 0), m_intZoomLevel - maxDetailLevels);
+    if (minZoom >= m_intZoomLevel)
+        return false;
+    const int shift = m_intZoomLevel - minZoom;
+    const double size = 1 << shift;
+
+    // dot(p - eye, detail) is how much larger the texels at p may be than
+    // those of the camera's zoom level
+    const QDoubleVector3D center = m_sideLength * QWebMercator::coordToMercator(m_camera.center());
+    QDoubleVector3D detail = center - m_eye;
+    const double distance = detail.length();
+    if (qFuzzyIsNull(distance))
+        return false;
+    detail *= m_detailThreshold / (distance * distance);
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = minX;
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = maxX;
+    double maxDetail = 0.0;
+    for (const QDoubleVector3D &p : qAsConst(m_footprint)) {
+        if (!qIsFinite(p.x()) || !qIsFinite(p.y()))
+            return false;
+        minX = qMin(minX, p.x());
+        minY = qMin(minY, p.y());
+        maxX = qMax(maxX, p.x());
+        maxY = qMax(maxY, p.y());
+        maxDetail = qMax(maxDetail, QDoubleVector3D::dotProduct(p - m_eye, detail));
+    }
+
+    // Nothing to gain, or tiles could overlap their own wrapped copies
+    if (maxDetail < 2.0 || maxX - minX + 2.0 * size > m_sideLength)
+        return false;
 
-    if (!polygons.right.isEmpty()) {
-        QSet<QGeoTileSpec> tilesRight = tilesFromPolygon(polygons.right);
-        m_tiles.unite(tilesRight);
+    m_tiles.clear();
+    m_tilesZoomLevel = -1;
+
+    const int side = 1 << minZoom;
+    const int firstY = qMax(0, static_cast<int>(std::floor(minY / size)));
+    const int lastY = qMin(side - 1, static_cast<int>(std::floor(maxY / size)));
+    const int firstX = static_cast<int>(std::floor(minX / size));
+    const int lastX = static_cast<int>(std::floor(maxX / size));
+    for (int y = firstY; y <= lastY; ++y) {
+        for (int x = firstX; x <= lastX; ++x)
+            addDetailTiles(minZoom, x, y, detail);
     }
+    return true;
+}
+
+// x is not wrapped yet
+void QGeoCameraTilesPrivate::addDetailTiles(int zoom, int x, int y, const QDoubleVector3D &detail)
+{
+    const int shift = m_intZoomLevel - zoom;
+    const double size = 1 << shift;
+    const double minX = x * size;
+    const double minY = y * size;
+    if (!rectIntersectsPolygon(minX, minY, minX + size, minY + size, m_footprint))
+        return;
 
-    if (!polygons.mid.isEmpty()) {
-        QSet<QGeoTileSpec> tilesRight = tilesFromPolygon(polygons.mid);
-        m_tiles.unite(tilesRight);
+    if (shift > 0) {
+        // Linear in the position, so the smallest at a corner
+        double allowed = std::numeric_limits<double>::max();
+        for (int c = 0; c < 4; ++c) {
+            const QDoubleVector3D corner(minX + (c & 1) * size, minY + (c >> 1) * size, 0.0);
+            allowed = qMin(allowed, QDoubleVector3D::dotProduct(corner - m_eye, detail));
+        }
+        if (allowed < size) {
+            for (int c = 0; c < 4; ++c)
+                addDetailTiles(zoom + 1, 2 * x + (c & 1), 2 * y + (c >> 1), detail);
+            return;
+        }
     }
+
+    const int side = 1 << zoom;
+    const int wrappedX = ((x % side) + side) % side;
+    m_tiles.insert(QGeoTileSpec(m_pluginString, m_mapType.mapId(), zoom, wrappedX, y, m_mapVersion));
 }
 
 Frustum QGeoCameraTilesPrivate::createFrustum(double viewExpansion) const
@@ -389,489 +643,99 @@ PolygonVector QGeoCameraTilesPrivate::frustumFootprint(const Frustum &frustum) c
     return points;
 }
 
-QPair<PolygonVector, PolygonVector> QGeoCameraTilesPrivate::splitPolygonAtAxisValue(const PolygonVector &polygon, int axis, double value) const
+static inline bool isIntegral(double v)
 {
-    PolygonVector polygonBelow;
-    PolygonVector polygonAbove;
-
-    int size = polygon.size();
-
-    if (size == 0) {
-        return QPair<PolygonVector, PolygonVector>(polygonBelow, polygonAbove);
-    }
-
-    QVector<int> comparisons = QVector<int>(polygon.size());
-
-    for (int i = 0; i < size; ++i) {
-        double v = polygon.at(i).get(axis);
-        if (qFuzzyCompare(v - value + 1.0, 1.0)) {
-            comparisons[i] = 0;
-        } else {
-            if (v < value) {
-                comparisons[i] = -1;
-            } else if (value < v) {
-                comparisons[i] = 1;
-            }
-        }
-    }
-
-    for (int index = 0; index < size; ++index) {
-        int prevIndex = index - 1;
-        if (prevIndex < 0)
-            prevIndex += size;
-        int nextIndex = (index + 1) % size;
-
-        int prevComp = comparisons[prevIndex];
-        int comp = comparisons[index];
-        int nextComp = comparisons[nextIndex];
-
-         if (comp == 0) {
-            if (prevComp == -1) {
-                polygonBelow.append(polygon.at(index));
-                if (nextComp == 1) {
-                    polygonAbove.append(polygon.at(index));
-                }
-            } else if (prevComp == 1) {
-                polygonAbove.append(polygon.at(index));
-                if (nextComp == -1) {
-                    polygonBelow.append(polygon.at(index));
-                }
-            } else if (prevComp == 0) {
-                if (nextComp == -1) {
-                    polygonBelow.append(polygon.at(index));
-                } else if (nextComp == 1) {
-                    polygonAbove.append(polygon.at(index));
-                } else if (nextComp == 0) {
-                    // do nothing
-                }
-            }
-        } else {
-             if (comp == -1) {
-                 polygonBelow.append(polygon.at(index));
-             } else if (comp == 1) {
-                 polygonAbove.append(polygon.at(index));
-             }
-
-             // there is a point between this and the next point
-             // on the polygon that lies on the splitting line
-             // and should be added to both the below and above
-             // polygons
-             if ((nextComp != 0) && (nextComp != comp)) {
-                 QDoubleVector3D p1 = polygon.at(index);
-                 QDoubleVector3D p2 = polygon.at(nextIndex);
-
-                 double p1v = p1.get(axis);
-                 double p2v = p2.get(axis);
-
-                 double f = (p1v - value) / (p1v - p2v);
-
-                 if (((0 <= f) && (f <= 1.0))
-                         || qFuzzyCompare(f + 1.0, 1.0)
-                         || qFuzzyCompare(f + 1.0, 2.0) ) {
-                     QDoubleVector3D midPoint = (1.0 - f) * p1 + f * p2;
-                     polygonBelow.append(midPoint);
-                     polygonAbove.append(midPoint);
-                 }
-             }
-        }
-    }
-
-    return QPair<PolygonVector, PolygonVector>(polygonBelow, polygonAbove);
+    const double r = std::round(v);
+    return qFuzzyCompare(v, r) || qFuzzyCompare(v + 1.0, r + 1.0);
 }
 
-static void addXOffset(PolygonVector &footprint, double xoff)
+// Tiles on both sides of a tile boundary are included
+static inline int firstTile(double v)
 {
-    for (QDoubleVector3D &v: footprint)
-        v.setX(v.x() + xoff);
+    return isIntegral(v) ? int(std::round(v)) - 1 : int(std::floor(v));
 }
 
-QGeoCameraTilesPrivate::ClippedFootprint QGeoCameraTilesPrivate::clipFootprintToMap(const PolygonVector &footprint) const
+static inline int lastTile(double v)
 {
-    bool clipX0 = false;
-    bool clipX1 = false;
-    bool clipY0 = false;
-    bool clipY1 = false;
-
-    double side = 1.0 * m_sideLength;
-    double minX = std::numeric_limits<double>::max();
-    double maxX = std::numeric_limits<double>::lowest();
-
-    for (const QDoubleVector3D &p: footprint) {
-        if (p.y() < 0.0)
-            clipY0 = true;
-        if (p.y() > side)
-            clipY1 = true;
-    }
-
-    PolygonVector results = footprint;
-
-    if (clipY0) {
-        results = splitPolygonAtAxisValue(results, 1, 0.0).second;
-    }
-
-    if (clipY1) {
-        results = splitPolygonAtAxisValue(results, 1, side).first;
-    }
-
-    for (const QDoubleVector3D &p: results) {
-        if ((p.x() < 0.0) || (qFuzzyIsNull(p.x())))
-            clipX0 = true;
-        if ((p.x() > side) || (qFuzzyCompare(side, p.x())))
-            clipX1 = true;
-    }
-
-    for (const QDoubleVector3D &v : results) {
-        minX = qMin(v.x(), minX);
-        maxX = qMax(v.x(), maxX);
-    }
-
-    double footprintWidth = maxX - minX;
-
-    if (clipX0) {
-        if (clipX1) {
-            if (footprintWidth > side) {
-                PolygonVector rightPart = splitPolygonAtAxisValue(results, 0, side).second;
-                addXOffset(rightPart,  -side);
-                rightPart = splitPolygonAtAxisValue(rightPart, 0, side).first; // clip it again, should it tend to infinite or so
-
-                PolygonVector leftPart = splitPolygonAtAxisValue(results, 0, 0).first;
-                addXOffset(leftPart,  side);
-                leftPart = splitPolygonAtAxisValue(leftPart, 0, 0).second; // same here
-
-                results = splitPolygonAtAxisValue(results, 0, 0.0).second;
-                results = splitPolygonAtAxisValue(results, 0, side).first;
-                return ClippedFootprint(leftPart, results, rightPart);
-            } else { // fitting the WebMercator square exactly?
-                results = splitPolygonAtAxisValue(results, 0, 0.0).second;
-                results = splitPolygonAtAxisValue(results, 0, side).first;
-                return ClippedFootprint(PolygonVector(), results, PolygonVector());
-            }
-        } else {
-            QPair<PolygonVector, PolygonVector> pair = splitPolygonAtAxisValue(results, 0, 0.0);
-            if (pair.first.isEmpty()) {
-                // if we touched the line but didn't cross it...
-                for (int i = 0; i < pair.second.size(); ++i) {
-                    if (qFuzzyIsNull(pair.second.at(i).x()))
-                        pair.first.append(pair.second.at(i));
-                }
-                if (pair.first.size() == 2) {
-                    double y0 = pair.first[0].y();
-                    double y1 = pair.first[1].y();
-                    pair.first.clear();
-                    pair.first.append(QDoubleVector3D(side, y0, 0.0));
-                    pair.first.append(QDoubleVector3D(side - 0.001, y0, 0.0));
-                    pair.first.append(QDoubleVector3D(side - 0.001, y1, 0.0));
-                    pair.first.append(QDoubleVector3D(side, y1, 0.0));
-                } else if (pair.first.size() == 1) {
-                    // FIXME this is trickier
-                    // - touching at one point on the tile boundary
-                    // - probably need to build a triangular polygon across the edge
-                    // - don't want to add another y tile if we can help it
-                    //   - initial version doesn't care
-                    double y = pair.first.at(0).y();
-                    pair.first.clear();
-                    pair.first.append(QDoubleVector3D(side - 0.001, y, 0.0));
-                    pair.first.append(QDoubleVector3D(side, y + 0.001, 0.0));
-                    pair.first.append(QDoubleVector3D(side, y - 0.001, 0.0));
-                }
-            } else {
-                addXOffset(pair.first, side);
-                if (footprintWidth > side)
-                    pair.first = splitPolygonAtAxisValue(pair.first, 0, 0).second;
-            }
-            return ClippedFootprint(pair.first, pair.second, PolygonVector());
-        }
-    } else {
-        if (clipX1) {
-            QPair<PolygonVector, PolygonVector> pair = splitPolygonAtAxisValue(results, 0, side);
-            if (pair.second.isEmpty()) {
-                // if we touched the line but didn't cross it...
-                for (int i = 0; i < pair.first.size(); ++i) {
-                    if (qFuzzyCompare(side, pair.first.at(i).x()))
-                        pair.second.append(pair.first.at(i));
-                }
-                if (pair.second.size() == 2) {
-                    double y0 = pair.second[0].y();
-                    double y1 = pair.second[1].y();
-                    pair.second.clear();
-                    pair.second.append(QDoubleVector3D(0, y0, 0.0));
-                    pair.second.append(QDoubleVector3D(0.001, y0, 0.0));
-                    pair.second.append(QDoubleVector3D(0.001, y1, 0.0));
-                    pair.second.append(QDoubleVector3D(0, y1, 0.0));
-                } else if (pair.second.size() == 1) {
-                    // FIXME this is trickier
-                    // - touching at one point on the tile boundary
-                    // - probably need to build a triangular polygon across the edge
-                    // - don't want to add another y tile if we can help it
-                    //   - initial version doesn't care
-                    double y = pair.second.at(0).y();
-                    pair.second.clear();
-                    pair.second.append(QDoubleVector3D(0.001, y, 0.0));
-                    pair.second.append(QDoubleVector3D(0.0, y - 0.001, 0.0));
-                    pair.second.append(QDoubleVector3D(0.0, y + 0.001, 0.0));
-                }
-            } else {
-                addXOffset(pair.second, -side);
-                if (footprintWidth > side)
-                    pair.second = splitPolygonAtAxisValue(pair.second, 0, side).first;
-            }
-            return ClippedFootprint(PolygonVector(), pair.first, pair.second);
-        } else {
-            return ClippedFootprint(PolygonVector(), results, PolygonVector());
-        }
-    }
-
+    return isIntegral(v) ? int(std::round(v)) : int(std::floor(v));
 }
 
-QList<QPair<double, int> > QGeoCameraTilesPrivate::tileIntersections(double p1, int t1, double p2, int t2) const
+static inline bool fuzzyLessOrEqual(double a, double b)
 {
-    if (t1 == t2) {
-        QList<QPair<double, int> > results = QList<QPair<double, int> >();
-        results.append(QPair<double, int>(0.0, t1));
-        return results;
-    }
-
-    int step = 1;
-    if (t1 > t2) {
-        step = -1;
-    }
-
-    int size = 1 + ((t2 - t1) / step);
-
-    QList<QPair<double, int> > results = QList<QPair<double, int> >();
-
-    results.append(QPair<double, int>(0.0, t1));
-
-    if (step == 1) {
-        for (int i = 1; i < size; ++i) {
-            double f = (t1 + i - p1) / (p2 - p1);
-            results.append(QPair<double, int>(f, t1 + i));
-        }
-    } else {
-        for (int i = 1; i < size; ++i) {
-            double f = (t1 - i + 1 - p1) / (p2 - p1);
-            results.append(QPair<double, int>(f, t1 - i));
-        }
-    }
-
-    return results;
+    return a <= b || qFuzzyCompare(a, b) || qFuzzyCompare(a + 1.0, b + 1.0);
 }
 
-QSet<QGeoTileSpec> QGeoCameraTilesPrivate::tilesFromPolygon(const PolygonVector &polygon) const
+/*
+    Scan-converts the footprint into rows of tiles, tiles on both sides of a
+    tile boundary are included. The footprint is convex, so
+    the extent of a row is that of the parts of the edges crossing it. Rows
+    are clipped to the map, columns wrap around the dateline.
+*/
+void QGeoCameraTilesPrivate::footprintSpans(const PolygonVector &footprint, QVector<QGeoCameraTileSpan> *spans) const
 {
-    int numPoints = polygon.size();
-
-    if (numPoints == 0)
-        return QSet<QGeoTileSpec>();
-
-    QVector<int> tilesX(polygon.size());
-    QVector<int> tilesY(polygon.size());
-
-    // grab tiles at the corners of the polygon
-    for (int i = 0; i < numPoints; ++i) {
-
-        QDoubleVector2D p = polygon.at(i).toVector2D();
+    spans->clear();
 
-        int x = 0;
-        int y = 0;
-
-        if (qFuzzyCompare(p.x(), m_sideLength * 1.0))
-            x = m_sideLength - 1;
-        else {
-            x = static_cast<int>(p.x()) % m_sideLength;
-            if ( !qFuzzyCompare(p.x(), 1.0 * x) && qFuzzyCompare(p.x(), 1.0 * (x + 1)) )
-                x++;
-        }
-
-        if (qFuzzyCompare(p.y(), m_sideLength * 1.0))
-            y = m_sideLength - 1;
-        else {
-            y = static_cast<int>(p.y()) % m_sideLength;
-            if ( !qFuzzyCompare(p.y(), 1.0 * y) && qFuzzyCompare(p.y(), 1.0 * (y + 1)) )
-                y++;
-        }
+    const int size = footprint.size();
+    if (size < 3 || m_sideLength <= 0)
+        return;
 
-        tilesX[i] = x;
-        tilesY[i] = y;
+    double minY = std::numeric_limits<double>::max();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (const QDoubleVector3D &p : footprint) {
+        if (!qIsFinite(p.x()) || !qIsFinite(p.y()))
+            return;
+        minY = qMin(minY, p.y());
+        maxY = qMax(maxY, p.y());
     }
+    if (maxY < 0.0 || minY > m_sideLength)
+        return;
 
-    QGeoCameraTilesPrivate::TileMap map;
-
-    // walk along the edges of the polygon and add all tiles covered by them
-    for (int i1 = 0; i1 < numPoints; ++i1) {
-        int i2 = (i1 + 1) % numPoints;
-
-        double x1 = polygon.at(i1).get(0);
-        double x2 = polygon.at(i2).get(0);
-
-        bool xFixed = qFuzzyCompare(x1, x2);
-        bool xIntegral = qFuzzyCompare(x1, std::floor(x1)) || qFuzzyCompare(x1 + 1.0, std::floor(x1 + 1.0));
-
-        QList<QPair<double, int> > xIntersects
-                = tileIntersections(x1,
-                                    tilesX.at(i1),
-                                    x2,
-                                    tilesX.at(i2));
-
-        double y1 = polygon.at(i1).get(1);
-        double y2 = polygon.at(i2).get(1);
-
-        bool yFixed = qFuzzyCompare(y1, y2);
-        bool yIntegral = qFuzzyCompare(y1, std::floor(y1)) || qFuzzyCompare(y1 + 1.0, std::floor(y1 + 1.0));
-
-        QList<QPair<double, int> > yIntersects
-                = tileIntersections(y1,
-                                    tilesY.at(i1),
-                                    y2,
-                                    tilesY.at(i2));
-
-        int x = xIntersects.takeFirst().second;
-        int y = yIntersects.takeFirst().second;
-
-
-        /*
-          If the polygon coincides with the tile edges we must be
-          inclusive and grab all tiles on both sides. We also need
-          to handle tiles with corners coindent with the
-          corners of the polygon.
-          e.g. all tiles marked with 'x' will be added
-
-              "+" - tile boundaries
-              "O" - polygon boundary
-
-                + + + + + + + + + + + + + + + + + + + + +
-                +       +       +       +       +       +
-                +       +   x   +   x   +   x   +       +
-                +       +       +       +       +       +
-                + + + + + + + + O O O O O + + + + + + + +
-                +       +       O       0       +       +
-                +       +   x   O   x   0   x   +       +
-                +       +       O       0       +       +
-                + + + + + + + + O 0 0 0 0 + + + + + + + +
-                +       +       +       +       +       +
-                +       +   x   +   x   +   x   +       +
-                +       +       +       +       +       +
-                + + + + + + + + + + + + + + + + + + + + +
-        */
-
-
-        int xOther = x;
-        int yOther = y;
-
-        if (xFixed && xIntegral) {
-             if (y2 < y1) {
-                 xOther = qMax(0, x - 1);
-            }
-        }
-
-        if (yFixed && yIntegral) {
-            if (x1 < x2) {
-                yOther = qMax(0, y - 1);
-
-            }
-        }
-
-        if (xIntegral) {
-            map.add(xOther, y);
-            if (yIntegral)
-                map.add(xOther, yOther);
-
-        }
-
-        if (yIntegral)
-            map.add(x, yOther);
-
-        map.add(x,y);
-
-        // top left corner
-        int iPrev =  (i1 + numPoints - 1) % numPoints;
-        double xPrevious = polygon.at(iPrev).get(0);
-        double yPrevious = polygon.at(iPrev).get(1);
-        bool xPreviousFixed = qFuzzyCompare(xPrevious, x1);
-        if (xIntegral && xPreviousFixed && yIntegral && yFixed) {
-            if ((x2 > x1) && (yPrevious > y1)) {
-                if ((x - 1) > 0 && (y - 1) > 0)
-                    map.add(x - 1, y - 1);
-            } else if ((x2 < x1) && (yPrevious < y1)) {
-                // what?
-            }
-        }
-
-        // for the simple case where intersections do not coincide with
-        // the boundaries, we move along the edge and add tiles until
-        // the x and y intersection lists are exhausted
-
-        while (!xIntersects.isEmpty() && !yIntersects.isEmpty()) {
-            QPair<double, int> nextX = xIntersects.first();
-            QPair<double, int> nextY = yIntersects.first();
-            if (nextX.first < nextY.first) {
-                x = nextX.second;
-                map.add(x, y);
-                xIntersects.removeFirst();
-
-            } else if (nextX.first > nextY.first) {
-                y = nextY.second;
-                map.add(x, y);
-                yIntersects.removeFirst();
-
-            } else {
-                map.add(x, nextY.second);
-                map.add(nextX.second, y);
-                x = nextX.second;
-                y = nextY.second;
-                map.add(x, y);
-                xIntersects.removeFirst();
-                yIntersects.removeFirst();
+    const int firstRow = qMax(0, firstTile(minY));
+    const int lastRow = qMin(m_sideLength - 1, lastTile(maxY));
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const double top = row;
+        const double bottom = row + 1;
+        double minX = std::numeric_limits<double>::max();
+        double maxX = std::numeric_limits<double>::lowest();
+
+        for (int i = 0; i < size; ++i) {
+            const QDoubleVector3D &a = footprint.at(i);
+            const QDoubleVector3D &b = footprint.at((i + 1) % size);
+            const double low = qMin(a.y(), b.y());
+            const double high = qMax(a.y(), b.y());
+            if (!fuzzyLessOrEqual(top, high) || !fuzzyLessOrEqual(low, bottom))
+                continue;
+
+            if (high == low) {
+                minX = qMin(minX, qMin(a.x(), b.x()));
+                maxX = qMax(maxX, qMax(a.x(), b.x()));
+                continue;
             }
+            // The part of the edge inside the row
+            const double slope = (b.x() - a.x()) / (b.y() - a.y());
+            const double x0 = a.x() + slope * (qBound(low, top, high) - a.y());
+            const double x1 = a.x() + slope * (qBound(low, bottom, high) - a.y());
+            minX = qMin(minX, qMin(x0, x1));
+            maxX = qMax(maxX, qMax(x0, x1));
         }
-
-        while (!xIntersects.isEmpty()) {
-            x = xIntersects.takeFirst().second;
-            map.add(x, y);
-            if (yIntegral && yFixed)
-                map.add(x, yOther);
-
-        }
-
-        while (!yIntersects.isEmpty()) {
-            y = yIntersects.takeFirst().second;
-            map.add(x, y);
-            if (xIntegral && xFixed)
-                map.add(xOther, y);
+        if (minX > maxX)
+            continue;
+
+        const int first = firstTile(minX);
+        const int last = lastTile(maxX);
+        if (last - first + 1 >= m_sideLength) {
+            spans->append(QGeoCameraTileSpan{row, 0, m_sideLength - 1});
+            continue;
         }
-    }
-
-    QSet<QGeoTileSpec> results;
-
-    int z = m_intZoomLevel;
-
-    typedef QMap<int, QPair<int, int> >::const_iterator iter;
-    iter i = map.data.constBegin();
-    iter end = map.data.constEnd();
-
-    for (; i != end; ++i) {
-        int y = i.key();
-        int minX = i->first;
-        int maxX = i->second;
-        for (int x = minX; x <= maxX; ++x) {
-            results.insert(QGeoTileSpec(m_pluginString, m_mapType.mapId(), z, x, y, m_mapVersion));
+        const int wrappedFirst = ((first % m_sideLength) + m_sideLength) % m_sideLength;
+        const int wrappedLast = ((last % m_sideLength) + m_sideLength) % m_sideLength;
+        if (wrappedFirst <= wrappedLast) {
+            spans->append(QGeoCameraTileSpan{row, wrappedFirst, wrappedLast});
+        } else {
+            spans->append(QGeoCameraTileSpan{row, 0, wrappedLast});
+            spans->append(QGeoCameraTileSpan{row, wrappedFirst, m_sideLength - 1});
         }
     }
-
-    return results;
-}
-
-QGeoCameraTilesPrivate::TileMap::TileMap() {}
-
-void QGeoCameraTilesPrivate::TileMap::add(int tileX, int tileY)
-{
-    if (data.contains(tileY)) {
-        int oldMinX = data.value(tileY).first;
-        int oldMaxX = data.value(tileY).second;
-        data.insert(tileY, QPair<int, int>(qMin(tileX, oldMinX), qMax(tileX, oldMaxX)));
-    } else {
-        data.insert(tileY, QPair<int, int>(tileX, tileX));
-    }
 }
 
 QT_END_NAMESPACE
@@ -49,6 +49,7 @@
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QVector>
 #include <QRectF>
 
 QT_BEGIN_NAMESPACE
@@ -59,6 +60,14 @@ class QGeoMapType;
 class QGeoCameraTilesPrivate;
 class QSize;
 
+// A run of tiles on one row of the map, minX and maxX included
+struct QGeoCameraTileSpan
+{
+    int y;
+    int minX;
+    int maxX;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoCameraTiles {
 public:
     QGeoCameraTiles();
@@ -75,8 +84,21 @@ public:
     void setMapType(const QGeoMapType &mapType);
     QGeoMapType activeMapType() const;
     void setMapVersion(int mapVersion);
+
+    // Level of detail for tilted views, 0 disables it
+    void setDetailThreshold(double threshold);
+    double detailThreshold() const;
+    void setMinimumZoomLevel(int zoomLevel);
+    int minimumZoomLevel() const;
+
     const QSet<QGeoTileSpec>& createTiles();
 
+    // The tiles of createTiles() as spans sorted by row and column, at the
+    // integral zoom level of the camera. The level of detail is not applied.
+    const QVector<QGeoCameraTileSpan> &tileSpans();
+    int tileZoomLevel() const;
+    bool tileSpanChanges(QVector<QGeoCameraTileSpan> *entered, QVector<QGeoCameraTileSpan> *left);
+
 protected:
     QScopedPointer<QGeoCameraTilesPrivate> d_ptr;
 
@@ -84,6 +106,8 @@ protected:
     Q_DISABLE_COPY(QGeoCameraTiles)
 };
 
+Q_DECLARE_TYPEINFO(QGeoCameraTileSpan, Q_PRIMITIVE_TYPE);
+
 QT_END_NAMESPACE
 
 #endif // QGEOCAMERATILES_P_H
@@ -78,42 +78,19 @@ typedef QVector<QDoubleVector3D> PolygonVector;
 class Q_LOCATION_PRIVATE_EXPORT QGeoCameraTilesPrivate
 {
 public:
-    struct ClippedFootprint
-    {
-        ClippedFootprint()
-        {}
-        ClippedFootprint(const PolygonVector &left_, const PolygonVector &mid_, const PolygonVector &right_)
-            : left(left_), mid(mid_), right(right_)
-        {}
-        PolygonVector left;
-        PolygonVector mid;
-        PolygonVector right;
-    };
-
-    struct TileMap
-    {
-        TileMap();
-
-        void add(int tileX, int tileY);
-
-        QMap<int, QPair<int, int> > data;
-    };
-
     QGeoCameraTilesPrivate();
     ~QGeoCameraTilesPrivate();
 
 
-    void updateMetadata();
     void updateGeometry();
+    void updateTiles();
+    bool updateDetailTiles();
+    void addDetailTiles(int zoom, int x, int y, const QDoubleVector3D &viewDirection);
 
     Frustum createFrustum(double viewExpansion) const;
     PolygonVector frustumFootprint(const Frustum &frustum) const;
 
-    QPair<PolygonVector, PolygonVector> splitPolygonAtAxisValue(const PolygonVector &polygon, int axis, double value) const;
-    ClippedFootprint clipFootprintToMap(const PolygonVector &footprint) const;
-
-    QList<QPair<double, int> > tileIntersections(double p1, int t1, double p2, int t2) const;
-    QSet<QGeoTileSpec> tilesFromPolygon(const PolygonVector &polygon) const;
+    void footprintSpans(const PolygonVector &footprint, QVector<QGeoCameraTileSpan> *spans) const;
 
     static QGeoCameraTilesPrivate *get(QGeoCameraTiles *o) {
         return o->d_ptr.data();
@@ -129,15 +106,32 @@ public:
     int m_tileSize;
     QSet<QGeoTileSpec> m_tiles;
 
+    // Coverage of the current camera. m_tiles is patched with the tiles
+    // entering and leaving it, as long as the zoom level stays the same.
+    QVector<QGeoCameraTileSpan> m_spans;
+    QVector<QGeoCameraTileSpan> m_tilesSpans;   // what m_tiles holds
+    QVector<QGeoCameraTileSpan> m_changedSpans;
+    int m_tilesZoomLevel;
+    // Coverage last passed to QGeoCameraTiles::tileSpanChanges()
+    QVector<QGeoCameraTileSpan> m_reportedSpans;
+    int m_reportedZoomLevel;
+
+    // Footprint of the current camera in tiles of m_intZoomLevel, and the
+    // eye it is seen from
+    PolygonVector m_footprint;
+    QDoubleVector3D m_eye;
+    double m_detailThreshold;
+    int m_minimumZoomLevel;
+
     int m_intZoomLevel;
     int m_sideLength;
     bool m_dirtyGeometry;
     bool m_dirtyMetadata;
+    bool m_dirtyTiles;
     double m_viewExpansion;
 
 #ifdef QT_LOCATION_DEBUG
     // updateGeometry
-    ClippedFootprint m_clippedFootprint;
     PolygonVector m_frustumFootprint;
     Frustum m_frustum;
 
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeoconvexclipper_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Positive when p is on the left of the line from a to b
+static inline double side(const QDoubleVector2D &a, const QDoubleVector2D &b, const QDoubleVector2D &p)
+{
+    return (b.x() - a.x()) * (p.y() - a.y()) - (b.y() - a.y()) * (p.x() - a.x());
+}
+
+// 1 for counterclockwise polygons, -1 for clockwise ones, 0 for degenerate ones
+static double orientation(const QDoubleVector2D *polygon, int size)
+{
+    double area = 0.0;
+    for (int i = 0, j = size - 1; i < size; j = i++)
+        area += polygon[j].x() * polygon[i].y() - polygon[i].x() * polygon[j].y();
+    return area > 0.0 ? 1.0 : (area < 0.0 ? -1.0 : 0.0);
+}
+
+void QGeoConvexClipper::intersect(const QDoubleVector2D *subject, int subjectSize,
+                                  const QDoubleVector2D *clip, int clipSize,
+                                  Polygon *result)
+{
+    result->clear();
+    const double sign = orientation(clip, clipSize);
+    if (subjectSize < 3 || clipSize < 3 || sign == 0.0)
+        return;
+
+    // Clipped against one edge after the other, back and forth between the two
+    Polygon buffers[2];
+    buffers[0].append(subject, subjectSize);
+    int current = 0;
+    for (int e = 0; e < clipSize; ++e) {
+        const QDoubleVector2D &a = clip[e];
+        const QDoubleVector2D &b = clip[(e + 1) % clipSize];
+        const Polygon &input = buffers[current];
+        Polygon &output = buffers[1 - current];
+        output.clear();
+
+        QDoubleVector2D previous = input.last();
+        double previousSide = sign * side(a, b, previous);
+        for (const QDoubleVector2D &point : input) {
+            const double pointSide = sign * side(a, b, point);
+            if ((pointSide >= 0.0) != (previousSide >= 0.0))
+                output.append(previous + (point - previous) * (previousSide / (previousSide - pointSide)));
+            if (pointSide >= 0.0)
+                output.append(point);
+            previous = point;
+            previousSide = pointSide;
+        }
+
+        current = 1 - current;
+        if (output.size() < 3)
+            return;
+    }
+
+    // Vertices on the clip edges come out twice
+    const Polygon &clipped = buffers[current];
+    for (const QDoubleVector2D &point : clipped) {
+        if (result->isEmpty() || !qFuzzyCompare(result->last(), point))
+            result->append(point);
+    }
+    while (result->size() > 1 && qFuzzyCompare(result->last(), result->first()))
+        result->removeLast();
+    if (result->size() < 3)
+        result->clear();
+}
+
+bool QGeoConvexClipper::contains(const QDoubleVector2D *polygon, int size, const QDoubleVector2D &point)
+{
+    const double sign = orientation(polygon, size);
+    if (sign == 0.0)
+        return false;
+    for (int i = 0, j = size - 1; i < size; j = i++) {
+        if (sign * side(polygon[j], polygon[i], point) < 0.0)
+            return false;
+    }
+    return true;
+}
+
+/*
+    Whether all of \a points lie in the convex \a polygon. For a polygon
+    through these points, this means it needs no clipping.
+*/
+bool QGeoConvexClipper::contains(const QList<QDoubleVector2D> &polygon, const QList<QDoubleVector2D> &points)
+{
+    const int size = polygon.size();
+    if (size < 3)
+        return false;
+    Polygon vertices;
+    for (const QDoubleVector2D &v : polygon)
+        vertices.append(v);
+    const double sign = orientation(vertices.constData(), size);
+    if (sign == 0.0)
+        return false;
+
+    for (const QDoubleVector2D &point : points) {
+        for (int i = 0, j = size - 1; i < size; j = i++) {
+            if (sign * side(vertices.at(j), vertices.at(i), point) < 0.0)
+                return false;
+        }
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
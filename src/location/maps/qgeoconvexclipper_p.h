@@ -1,6 +1,6 @@
 /****************************************************************************
 **
-** Copyright (C) 2015 The Qt Company Ltd.
+** Copyright (C) 2020 The Qt Company Ltd.
 ** Contact: http://www.qt.io/licensing/
 **
 ** This file is part of the QtLocation module of the Qt Toolkit.
@@ -33,8 +33,8 @@
 ** $QT_END_LICENSE$
 **
 ****************************************************************************/
-#ifndef QGEOTILESPEC_P_H
-#define QGEOTILESPEC_P_H
+#ifndef QGEOCONVEXCLIPPER_P_H
+#define QGEOCONVEXCLIPPER_P_H
 
 //
 //  W A R N I N G
@@ -47,32 +47,36 @@
 // We mean it.
 //
 
-#include <QString>
-#include <QSharedData>
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+#include <QList>
+#include <QVarLengthArray>
 
 QT_BEGIN_NAMESPACE
 
-class QGeoTileSpecPrivate : public QSharedData
+/*
+    Clipping of convex polygons against each other, for the regions derived
+    from the camera. Polygons may have either orientation. Unlike Clipper,
+    this works on doubles directly and, for polygons of up to 16 vertices,
+    without allocating.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoConvexClipper
 {
 public:
-    QGeoTileSpecPrivate();
-    QGeoTileSpecPrivate(const QGeoTileSpecPrivate &other);
-    QGeoTileSpecPrivate(const QString &plugin, int mapId, int zoom, int x, int y, int version);
-    ~QGeoTileSpecPrivate();
-
-    QGeoTileSpecPrivate &operator = (const QGeoTileSpecPrivate &other);
+    typedef QVarLengthArray<QDoubleVector2D, 16> Polygon;
 
-    bool operator == (const QGeoTileSpecPrivate &rhs) const;
-    bool operator < (const QGeoTileSpecPrivate &rhs) const;
+    // Sutherland-Hodgman. result is left empty when the polygons do not
+    // overlap, or only along an edge or at a vertex.
+    static void intersect(const QDoubleVector2D *subject, int subjectSize,
+                          const QDoubleVector2D *clip, int clipSize,
+                          Polygon *result);
 
-    QString plugin_;
-    int mapId_;
-    int zoom_;
-    int x_;
-    int y_;
-    int version_;
+    // Points on the boundary are contained
+    static bool contains(const QDoubleVector2D *polygon, int size, const QDoubleVector2D &point);
+    static bool contains(const QList<QDoubleVector2D> &polygon, const QList<QDoubleVector2D> &points);
 };
 
 QT_END_NAMESPACE
 
-#endif // QGEOTILESPEC_P_H
+#endif // QGEOCONVEXCLIPPER_P_H
@@ -40,11 +40,16 @@
 #include "qgeomappingmanager_p.h"
 
 #include <QDir>
+#include <QFileInfo>
 #include <QStandardPaths>
 #include <QMetaType>
 #include <QPixmap>
+#include <QPainter>
+#include <QThread>
 #include <QDebug>
 
+#include <algorithm>
+
 Q_DECLARE_METATYPE(QList<QGeoTileSpec>)
 Q_DECLARE_METATYPE(QSet<QGeoTileSpec>)
 
@@ -65,6 +70,157 @@ public:
     QString format;
 };
 
+/* A tile waiting to be read and decoded by the decode pool. Only the worker
+ * writes the result fields, and only finishDecoding() reads them, after the
+ * worker is done with the job. */
+class QGeoTileDecodeJob
+{
+public:
+    QGeoTileDecodeJob()
+        : offset(0), length(-1), segmentStore(nullptr), fromDisk(false), bogus(false), failed(false),
+          missing(false) {}
+
+    // Lets compaction delete the segment the tile was read from
+    void releaseSegment()
+    {
+        if (segmentStore)
+            segmentStore->release(filename);
+        segmentStore = nullptr;
+    }
+
+    void decode()
+    {
+        if (fromDisk && filename.contains(QLatin1Char('*'))) {
+            // Offline tiles are looked up here, the directory may be large
+            const QFileInfo info(filename);
+            const QStringList matches = info.dir().entryList({ info.fileName() }, QDir::Files);
+            if (matches.isEmpty()) {
+                missing = true;
+                return;
+            }
+            filename = info.dir().absoluteFilePath(matches.first());
+            format = QFileInfo(filename).suffix();
+        }
+
+        if (fromDisk) {
+            QFile file(filename);
+            if (!file.open(QIODevice::ReadOnly)) {
+                failed = true;
+                return;
+            }
+            if (length < 0) {
+                bytes = file.readAll();
+            } else if (file.seek(offset)) {
+                bytes = file.read(length);
+                failed = bytes.size() != length;
+            } else {
+                failed = true;
+            }
+            file.close();
+            releaseSegment();
+            if (failed)
+                return;
+        }
+
+        if (bytes.size() == 7 && bytes == QByteArrayLiteral("NoRetry")) {
+            bogus = true;
+            return;
+        }
+
+        if (canceled.loadAcquire())
+            return;
+
+        if (!image.loadFromData(bytes)) {
+            failed = true;
+            return;
+        }
+
+        // Converting it here, instead of in each QSGTexture::bind()
+        if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
+            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    QGeoTileSpec spec;
+    QString filename;
+    qint64 offset; // tile bytes inside a segment file
+    int length;    // -1 for the whole file
+    QGeoTileSegmentStore *segmentStore; // set while the segment file is pinned
+    QString format;
+    QByteArray bytes;
+    QImage image;
+    bool fromDisk;
+    bool bogus;
+    bool failed;
+    bool missing; // not in the offline storage after all
+    QAtomicInt canceled;
+};
+
+class QGeoTileDecodeTask : public QRunnable
+{
+public:
+    QGeoTileDecodeTask(QGeoFileTileCache *cache, const QSharedPointer<QGeoTileDecodeJob> &job)
+        : m_cache(cache), m_job(job) {}
+
+    void run() override
+    {
+        if (!m_job->canceled.loadAcquire())
+            m_job->decode();
+        m_job->releaseSegment();
+
+        // The cache waits for the pool to drain before it goes away, and the queued
+        // call is dropped if the cache is destroyed before it gets delivered.
+        QGeoFileTileCache *cache = m_cache;
+        QSharedPointer<QGeoTileDecodeJob> job = m_job;
+        QMetaObject::invokeMethod(cache, [cache, job]() { cache->finishDecoding(job); },
+                                  Qt::QueuedConnection);
+    }
+
+private:
+    QGeoFileTileCache *m_cache;
+    QSharedPointer<QGeoTileDecodeJob> m_job;
+};
+
+class QGeoTileCompactionTask : public QRunnable
+{
+public:
+    QGeoTileCompactionTask(QGeoFileTileCache *cache) : m_cache(cache) {}
+
+    void run() override
+    {
+        // Same lifetime rules as for QGeoTileDecodeTask
+        QGeoFileTileCache *cache = m_cache;
+        cache->segmentStore_->compact();
+        QMetaObject::invokeMethod(cache, [cache]() { cache->finishCompaction(); }, Qt::QueuedConnection);
+    }
+
+private:
+    QGeoFileTileCache *m_cache;
+};
+
+class QGeoTileSnapshotTask : public QRunnable
+{
+public:
+    QGeoTileSnapshotTask(QGeoFileTileCache *cache, quint64 generation)
+        : m_cache(cache), m_generation(generation) {}
+
+    void run() override
+    {
+        // Same lifetime rules as for QGeoTileDecodeTask
+        QGeoFileTileCache *cache = m_cache;
+        const quint64 generation = m_generation;
+        const bool saved = cache->journal_->saveSnapshot(generation, queues);
+        QMetaObject::invokeMethod(cache, [cache, generation, saved]() {
+            cache->journal_->endSnapshot(generation, saved);
+        }, Qt::QueuedConnection);
+    }
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+
+private:
+    QGeoFileTileCache *m_cache;
+    quint64 m_generation;
+};
+
 void QCache3QTileEvictionPolicy::aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<QGeoCachedTileDisk> obj)
 {
     Q_UNUSED(key);
@@ -89,8 +245,20 @@ QGeoFileTileCache::QGeoFileTileCache(const QString &directory, QObject *parent)
     : QAbstractGeoTileCache(parent), directory_(directory), minTextureUsage_(0), extraTextureUsage_(0)
     ,costStrategyDisk_(ByteSize), costStrategyMemory_(ByteSize), costStrategyTexture_(ByteSize)
     ,isDiskCostSet_(false), isMemoryCostSet_(false), isTextureCostSet_(false)
+    ,diskStorage_(TileFiles)
+    ,restoringDiskCache_(false), asyncDecoding_(false), maxPendingDecodes_(64), runningDecodes_(0)
+    ,compacting_(false)
 {
-
+    // Leave room for the GUI and render threads
+    decodePool_.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+
+    // Journal records are written out in batches
+    journalFlushTimer_.setSingleShot(true);
+    journalFlushTimer_.setInterval(5000);
+    connect(&journalFlushTimer_, &QTimer::timeout, this, [this]() {
+        if (journal_)
+            journal_->flush();
+    });
 }
 
 void QGeoFileTileCache::init()
@@ -144,93 +312,199 @@ void QGeoFileTileCache::init()
             setExtraTextureUsage(30); // byte size of texture is >> compressed image, hence unitary cost should be lower
     }
 
+    if (diskStorage_ == SegmentFiles) {
+        segmentStore_.reset(new QGeoTileSegmentStore(QDir(directory_).filePath(QStringLiteral("segments"))));
+        if (!segmentStore_->open()) {
+            qWarning() << "Failed to open tile segment storage in" << directory_ << ", using tile files";
+            segmentStore_.reset();
+        }
+    }
+
     loadTiles();
 }
 
 void QGeoFileTileCache::loadTiles()
 {
-    QStringList formats;
-    formats << QLatin1String("*.*");
-
     QDir dir(directory_);
-    QStringList files = dir.entryList(formats, QDir::Files);
-#if 0 // workaround for QTBUG-60581
-    // Method:
-    // 1. read each queue file then, if each file exists, deserialize the data into the appropriate
-    // cache queue.
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::ReadOnly))
-            continue;
-        QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        QList<QGeoTileSpec> specs;
-        QList<int> costs;
-        while (!file.atEnd()) {
-            QByteArray line = file.readLine().trimmed();
-            QString filename = QString::fromLatin1(line.constData(), line.length());
-            if (dir.exists(filename)){
-                files.removeOne(filename);
-                QGeoTileSpec spec = filenameToTileSpec(filename);
-                if (spec.zoom() == -1)
-                    continue;
-                QSharedPointer<QGeoCachedTileDisk> tileDisk(new QGeoCachedTileDisk);
-                tileDisk->filename = dir.filePath(filename);
-                tileDisk->cache = this;
-                tileDisk->spec = spec;
-                QFileInfo fi(tileDisk->filename);
-                specs.append(spec);
-                queue.append(tileDisk);
-                if (costStrategyDisk_ == ByteSize)
-                    costs.append(fi.size());
-                else
-                    costs.append(1);
+    QSet<QString> files;
+    if (!segmentStore_) {
+        QStringList formats;
+        formats << QLatin1String("*.*");
+        files = QSet<QString>::fromList(dir.entryList(formats, QDir::Files));
+    }
 
-            }
-        }
+    // 1. restore the saved cache state, with the queue position and popularity of each tile
+    QSet<QGeoTileSpec> restored;
+    restoreDiskCacheState(&files, &restored);
 
-        diskCache_.deserializeQueue(i, specs, queue, costs);
-        file.close();
-    }
-#endif
-    // 2. remaining tiles that aren't registered in a queue get pushed into cache here
-    // this is a backup, in case the queue manifest files get deleted or out of sync due to
+    // 2. remaining tiles that aren't registered in the saved state get pushed into cache here
+    // this is a backup, in case the state files get deleted or out of sync due to
     // the application not closing down properly
-    for (int i = 0; i < files.size(); ++i) {
-        QGeoTileSpec spec = filenameToTileSpec(files.at(i));
+    if (segmentStore_) {
+        // Oldest first, so that the most recently stored tiles are evicted last
+        QVector<QGeoTileSegmentStore::Entry> entries = segmentStore_->entries();
+        std::sort(entries.begin(), entries.end(),
+                  [](const QGeoTileSegmentStore::Entry &a, const QGeoTileSegmentStore::Entry &b) {
+            return a.timestamp < b.timestamp;
+        });
+        for (const QGeoTileSegmentStore::Entry &entry : qAsConst(entries)) {
+            if (entry.variant == diskVariant(entry.spec) && !restored.contains(entry.spec))
+                addToDiskCache(entry.spec, entry.variant, entry.format, entry.size);
+        }
+        return;
+    }
+
+    for (const QString &file : qAsConst(files)) {
+        QGeoTileSpec spec = filenameToTileSpec(file);
         if (spec.zoom() == -1)
             continue;
-        QString filename = dir.filePath(files.at(i));
+        QString filename = dir.filePath(file);
         addToDiskCache(spec, filename);
     }
 }
 
-QGeoFileTileCache::~QGeoFileTileCache()
+/*
+    Rebuilds the disk cache queues from the snapshot and journal. Tiles that are
+    still on disk are taken out of \a files (file storage) and added to \a restored.
+*/
+void QGeoFileTileCache::restoreDiskCacheState(QSet<QString> *files, QSet<QGeoTileSpec> *restored)
 {
-#if 0 // workaround for QTBUG-60581
-    // write disk cache queues to disk
-    QDir dir(directory_);
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::WriteOnly)){
-            qWarning() << "Unable to write tile cache file " << filename;
-            continue;
+    journal_.reset(new QGeoTileCacheJournal(segmentStore_ ? QDir(directory_).filePath(QStringLiteral("segments"))
+                                                          : directory_));
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    if (!journal_->load(queues, &records)) {
+        qWarning() << "Unable to open tile cache journal in" << directory_;
+        journal_.reset();
+        return;
+    }
+
+    // Replaying evictions must not delete anything, that happened in the previous run already
+    restoringDiskCache_ = true;
+
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i) {
+        const bool ghosts = i == QGeoTileCacheJournal::QueueCount - 1;
+        for (const QGeoTileCacheJournal::Node &node : qAsConst(queues[i])) {
+            QSharedPointer<QGeoCachedTileDisk> td;
+            if (!ghosts)
+                td = createDiskTile(node.spec, node.variant, node.format);
+            diskCache_.restoreNode(i + 1, node.spec, td, node.cost, node.pop);
         }
-        QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        diskCache_.serializeQueue(i, queue);
-        foreach (const QSharedPointer<QGeoCachedTileDisk> &tile, queue) {
-            if (tile.isNull())
-                continue;
-
-            // we just want the filename here, not the full path
-            int index = tile->filename.lastIndexOf(QLatin1Char('/'));
-            QByteArray filename = tile->filename.mid(index + 1).toLatin1() + '\n';
-            file.write(filename);
+    }
+
+    for (const QGeoTileCacheJournal::Record &record : qAsConst(records)) {
+        switch (record.operation) {
+        case QGeoTileCacheJournal::Insert:
+            diskCache_.insert(record.spec, createDiskTile(record.spec, record.variant, record.format), record.cost);
+            break;
+        case QGeoTileCacheJournal::Touch:
+            diskCache_.object(record.spec);
+            break;
+        case QGeoTileCacheJournal::Remove:
+            diskCache_.remove(record.spec);
+            break;
         }
-        file.close();
     }
-#endif
+
+    // Apply the current limits to the restored queues
+    diskCache_.setMaxCost(diskCache_.maxCost());
+
+    // Drop the tiles that are gone from disk
+    QVector<QGeoTileSpec> missing;
+    for (int queue = 1; queue < QGeoTileCacheJournal::QueueCount; ++queue) {
+        diskCache_.visitQueue(queue, [&](const QGeoTileSpec &spec, const QSharedPointer<QGeoCachedTileDisk> &td,
+                                         int, quint64) {
+            bool present;
+            if (segmentStore_)
+                present = td->variant == diskVariant(spec) && segmentStore_->contains(spec, td->variant);
+            else
+                present = files->remove(QFileInfo(td->filename).fileName());
+            if (present)
+                restored->insert(spec);
+            else
+                missing.append(spec);
+        });
+    }
+    restoringDiskCache_ = false;
+
+    for (const QGeoTileSpec &spec : qAsConst(missing))
+        removeFromDiskCache(spec);
+}
+
+void QGeoFileTileCache::saveDiskCacheState()
+{
+    if (!journal_)
+        return;
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    collectDiskCacheState(queues);
+    if (!journal_->writeSnapshot(queues))
+        qWarning() << "Unable to write tile cache state in" << directory_;
+}
+
+/*
+    Like saveDiskCacheState(), but only the queues are copied here, the
+    snapshot is written in the decode pool.
+*/
+void QGeoFileTileCache::saveDiskCacheStateInBackground()
+{
+    if (!journal_)
+        return;
+
+    const quint64 generation = journal_->beginSnapshot();
+    if (!generation)
+        return;
+    QGeoTileSnapshotTask *task = new QGeoTileSnapshotTask(this, generation);
+    collectDiskCacheState(task->queues);
+    decodePool_.start(task);
+}
+
+void QGeoFileTileCache::collectDiskCacheState(QVector<QGeoTileCacheJournal::Node> *queues)
+{
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i) {
+        diskCache_.visitQueue(i + 1, [&](const QGeoTileSpec &spec, const QSharedPointer<QGeoCachedTileDisk> &td,
+                                         int cost, quint64 pop) {
+            QGeoTileCacheJournal::Node node;
+            node.spec = spec;
+            node.variant = td ? td->variant : 0;
+            node.format = td ? td->format : QString();
+            node.cost = cost;
+            node.pop = pop;
+            queues[i].append(node);
+        });
+    }
+}
+
+void QGeoFileTileCache::journalDiskCache(QGeoTileCacheJournal::Operation operation, const QGeoTileSpec &spec,
+                                         int variant, const QString &format, int cost)
+{
+    if (!journal_ || restoringDiskCache_)
+        return;
+
+    journal_->append(operation, spec, variant, format, cost);
+
+    // Bound the replay work at the next start
+    if (journal_->length() > 50000)
+        saveDiskCacheStateInBackground();
+    else if (!journalFlushTimer_.isActive())
+        journalFlushTimer_.start();
+}
+
+QGeoFileTileCache::~QGeoFileTileCache()
+{
+    for (const QSharedPointer<QGeoTileDecodeJob> &job : qAsConst(deferredDecodes_))
+        job->releaseSegment();
+    deferredDecodes_.clear();
+    cancelDecoding(QSet<QGeoTileSpec>::fromList(pendingDecodes_.keys()));
+    decodePool_.clear();
+    decodePool_.waitForDone();
+
+    journalFlushTimer_.stop();
+    saveDiskCacheState();
+
+    // Drop the entries without evicting them, the segment index is saved as it is
+    diskCache_.clear();
+    segmentStore_.reset();
 }
 
 void QGeoFileTileCache::printStats()
@@ -303,22 +577,34 @@ int QGeoFileTileCache::textureUsage() const
 
 void QGeoFileTileCache::clearAll()
 {
+    const QList<QGeoTileSpec> decoding = pendingDecodes_.keys();
+    cancelDecoding(QSet<QGeoTileSpec>::fromList(decoding));
     textureCache_.clear();
+    textureCache_.tileIndex().clear();
     memoryCache_.clear();
+    memoryCache_.tileIndex().clear();
     diskCache_.clear();
+    if (journal_)
+        journal_->clear();
+    if (segmentStore_)
+        segmentStore_->clear();
     QDir dir(directory_);
     dir.setNameFilters(QStringList() << QLatin1String("*-*-*-*.*"));
     dir.setFilter(QDir::Files);
     foreach (QString dirFile, dir.entryList()) {
         dir.remove(dirFile);
     }
+
+    // Tiles that were waiting for a decode have to be fetched again
+    for (const QGeoTileSpec &spec : decoding)
+        emit tileDecodingFailed(spec, QLatin1String("Tile cache cleared"));
 }
 
 void QGeoFileTileCache::clearMapId(const int mapId)
 {
     for (const QGeoTileSpec &k : diskCache_.keys())
         if (k.mapId() == mapId)
-            diskCache_.remove(k, true);
+            removeFromDiskCache(k, true);
     for (const QGeoTileSpec &k : memoryCache_.keys())
         if (k.mapId() == mapId)
             memoryCache_.remove(k);
@@ -326,6 +612,15 @@ void QGeoFileTileCache::clearMapId(const int mapId)
         if (k.mapId() == mapId)
             textureCache_.remove(k);
 
+    if (segmentStore_) {
+        // Also the variants that are not loaded in the disk cache
+        for (const QGeoTileSegmentStore::Entry &entry : segmentStore_->entries())
+            if (entry.spec.mapId() == mapId)
+                segmentStore_->remove(entry.spec, entry.variant);
+        startCompaction();
+        return;
+    }
+
     // TODO: It seems the cache leaves residues, like some tiles do not get picked up.
     // After the above calls, files that shouldnt be left behind are still on disk.
     // Do an additional pass and make sure what has to be deleted gets deleted.
@@ -372,6 +667,16 @@ QAbstractGeoTileCache::CostStrategy QGeoFileTileCache::costStrategyTexture() con
     return costStrategyTexture_;
 }
 
+void QGeoFileTileCache::setDiskStorage(QGeoFileTileCache::DiskStorage storage)
+{
+    diskStorage_ = storage;
+}
+
+QGeoFileTileCache::DiskStorage QGeoFileTileCache::diskStorage() const
+{
+    return diskStorage_;
+}
+
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
 {
     QSharedPointer<QGeoTileTexture> tt = getFromMemory(spec);
@@ -380,6 +685,241 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
     return getFromDisk(spec);
 }
 
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::requestTexture(const QGeoTileSpec &spec, bool *pending)
+{
+    if (pending)
+        *pending = false;
+    if (!asyncDecoding_)
+        return get(spec);
+
+    QSharedPointer<QGeoTileTexture> tt = textureCache_.object(spec);
+    if (tt || !pending)
+        return tt;
+
+    if (pendingDecodes_.contains(spec)) {
+        *pending = true;
+        return tt;
+    }
+
+    QSharedPointer<QGeoTileDecodeJob> job(new QGeoTileDecodeJob);
+    job->spec = spec;
+
+    QSharedPointer<QGeoCachedTileMemory> tm = memoryCache_.object(spec);
+    if (tm) {
+        job->bytes = tm->bytes;
+        job->format = tm->format;
+    } else if (QSharedPointer<QGeoCachedTileDisk> td = diskCacheObject(spec)) {
+        if (segmentStore_) {
+            // Pinned until read, compaction runs concurrently
+            if (!segmentStore_->acquire(spec, td->variant, &job->filename, &job->offset, &job->length))
+                return tt;
+            job->segmentStore = segmentStore_.data();
+            job->format = td->format;
+        } else {
+            job->filename = td->filename;
+            job->format = QFileInfo(td->filename).suffix();
+        }
+        job->fromDisk = true;
+    } else if (locateTile(spec, &job->filename, &job->offset, &job->length)) {
+        job->format = QFileInfo(job->filename).suffix();
+        job->fromDisk = true;
+    } else {
+        return tt;
+    }
+
+    // Past the limit the job waits for a running one to complete, instead of
+    // reading the tile right here
+    pendingDecodes_.insert(spec, job);
+    deferredDecodes_.enqueue(job);
+    startDecoding();
+    *pending = true;
+    return tt;
+}
+
+/*
+    Where \a spec can be read from when the tile is in none of the caches, for
+    caches with further storage such as offline tiles: \a length bytes at
+    \a offset in \a fileName, or the whole file for a length of -1. The file
+    is read in the decode threads, and its name may contain wildcards, which
+    are matched there too. Tiles that turn out not to exist are reported
+    through tileDecodingFailed(). The default implementation returns false.
+*/
+bool QGeoFileTileCache::locateTile(const QGeoTileSpec &spec, QString *fileName, qint64 *offset, int *length)
+{
+    Q_UNUSED(spec);
+    Q_UNUSED(fileName);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    return false;
+}
+
+void QGeoFileTileCache::startDecoding()
+{
+    while (runningDecodes_ < maxPendingDecodes_ && !deferredDecodes_.isEmpty()) {
+        QSharedPointer<QGeoTileDecodeJob> job = deferredDecodes_.dequeue();
+        if (job->canceled.loadAcquire()) {
+            job->releaseSegment();
+            continue;
+        }
+        ++runningDecodes_;
+        decodePool_.start(new QGeoTileDecodeTask(this, job));
+    }
+}
+
+/*
+    Looks for a stand-in for \a spec in the texture cache, and in the memory
+    cache when decoding is synchronous anyway, never on disk. Descendants up
+    to two zoom levels down that cover \a spec completely are preferred, as
+    they are sharper than an ancestor; they are drawn into a single image.
+    Otherwise the closest ancestor up to 4 zoom levels up is returned.
+*/
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::placeholderTexture(const QGeoTileSpec &spec)
+{
+    QVector<QGeoTileSpec> descendants;
+    if (textureCache_.tileIndex().descendants(spec, 2, &descendants)) {
+        QSharedPointer<QGeoTileTexture> tt = composeTexture(spec, descendants);
+        if (tt)
+            return tt;
+    }
+
+    QGeoTileSpec ancestor = textureCache_.tileIndex().ancestor(spec, 4);
+    if (ancestor.zoom() >= 0) {
+        QSharedPointer<QGeoTileTexture> tt = textureCache_.object(ancestor);
+        if (tt && !tt->image.isNull())
+            return tt;
+    }
+
+    if (!asyncDecoding_) {
+        ancestor = memoryCache_.tileIndex().ancestor(spec, 4);
+        if (ancestor.zoom() >= 0) {
+            QSharedPointer<QGeoTileTexture> tt = getFromMemory(ancestor);
+            if (tt && !tt->image.isNull())
+                return tt;
+        }
+    }
+    return QSharedPointer<QGeoTileTexture>();
+}
+
+/*
+    Draws the cached \a descendants of \a spec into one image of the size of
+    a tile. The result is not cached, and its spec carries placeholderVersion
+    so that it neither stands for \a spec nor for any other real tile.
+*/
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::composeTexture(const QGeoTileSpec &spec,
+                                                                  const QVector<QGeoTileSpec> &descendants)
+{
+    QVector<QSharedPointer<QGeoTileTexture> > textures;
+    textures.reserve(descendants.size());
+    for (const QGeoTileSpec &d : descendants) {
+        QSharedPointer<QGeoTileTexture> tt = textureCache_.object(d);
+        if (!tt || tt->image.isNull())
+            return QSharedPointer<QGeoTileTexture>();
+        textures.append(tt);
+    }
+
+    const QSize size = textures.first()->image.size();
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (const QSharedPointer<QGeoTileTexture> &tt : qAsConst(textures)) {
+        const int levels = tt->spec.zoom() - spec.zoom();
+        const qreal w = qreal(size.width()) / (1 << levels);
+        const qreal h = qreal(size.height()) / (1 << levels);
+        const int x = tt->spec.x() - (spec.x() << levels);
+        const int y = tt->spec.y() - (spec.y() << levels);
+        painter.drawImage(QRectF(x * w, y * h, w, h), tt->image);
+    }
+    painter.end();
+
+    QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+    tt->spec = spec;
+    tt->spec.setVersion(placeholderVersion);
+    tt->image = image;
+    return tt;
+}
+
+void QGeoFileTileCache::cancelDecoding(const QSet<QGeoTileSpec> &tiles)
+{
+    for (const QGeoTileSpec &spec : tiles) {
+        QSharedPointer<QGeoTileDecodeJob> job = pendingDecodes_.take(spec);
+        if (job)
+            job->canceled.storeRelease(1);
+    }
+}
+
+/*
+    Segments are compacted in the decode pool, one run at a time. Segments
+    pinned by decodes wait for them, so this is tried again once they finish.
+*/
+void QGeoFileTileCache::startCompaction()
+{
+    if (compacting_ || !segmentStore_ || !segmentStore_->compactionPending())
+        return;
+    compacting_ = true;
+    decodePool_.start(new QGeoTileCompactionTask(this));
+}
+
+void QGeoFileTileCache::finishCompaction()
+{
+    compacting_ = false;
+    startCompaction();
+}
+
+void QGeoFileTileCache::finishDecoding(const QSharedPointer<QGeoTileDecodeJob> &job)
+{
+    --runningDecodes_;
+    startDecoding();
+    startCompaction();
+    if (job->canceled.loadAcquire())
+        return;
+
+    // A newer job may have replaced this one after a cancel and re-request
+    if (pendingDecodes_.value(job->spec) == job)
+        pendingDecodes_.remove(job->spec);
+
+    if (job->missing) {
+        emit tileDecodingFailed(job->spec, QLatin1String("Tile not found"));
+        return;
+    }
+
+    if (job->failed) {
+        const QString error = QLatin1String("Problem with tile image");
+        handleError(job->spec, error);
+        emit tileDecodingFailed(job->spec, error);
+        return;
+    }
+
+    // Bogus tiles are cached as a texture without image, so that the lookup
+    // done on notification does not read them from disk again
+    if (!job->bogus && job->fromDisk)
+        addToMemoryCache(job->spec, job->bytes, job->format);
+    addToTextureCache(job->spec, job->bogus ? QImage() : job->image);
+    emit tileDecoded(job->spec);
+}
+
+void QGeoFileTileCache::setAsyncDecoding(bool enabled)
+{
+    // Decodes that are already scheduled still complete
+    asyncDecoding_ = enabled;
+}
+
+bool QGeoFileTileCache::asyncDecoding() const
+{
+    return asyncDecoding_;
+}
+
+void QGeoFileTileCache::setMaxPendingDecodes(int count)
+{
+    maxPendingDecodes_ = qMax(1, count);
+    startDecoding();
+}
+
+int QGeoFileTileCache::maxPendingDecodes() const
+{
+    return maxPendingDecodes_;
+}
+
 void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
                            const QByteArray &bytes,
                            const QString &format,
@@ -389,14 +929,26 @@ void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
         return;
 
     if (areas & QAbstractGeoTileCache::DiskCache) {
-        QString filename = tileSpecToFilename(spec, format, directory_);
-        addToDiskCache(spec, filename, bytes);
+        if (segmentStore_) {
+            const int variant = diskVariant(spec);
+            if (addToDiskCache(spec, variant, format, bytes.size()))
+                segmentStore_->insert(spec, variant, format, bytes);
+            startCompaction();
+        } else {
+            QString filename = tileSpecToFilename(spec, format, directory_);
+            addToDiskCache(spec, filename, bytes);
+        }
     }
 
     if (areas & QAbstractGeoTileCache::MemoryCache) {
         addToMemoryCache(spec, bytes, format);
     }
 
+    // A tile that was bogus before is decoded again when requested
+    const QSharedPointer<QGeoTileTexture> tt = textureCache_.object(spec);
+    if (tt && tt->image.isNull() && !isTileBogus(bytes))
+        textureCache_.remove(spec);
+
     /* inserts do not hit the texture cache -- this actually reduces overall
      * cache hit rates because many tiles come too late to be useful
      * and act as a poison */
@@ -469,7 +1021,12 @@ QGeoTileSpec QGeoFileTileCache::filenameToTileSpecDefault(const QString &filenam
 
 void QGeoFileTileCache::evictFromDiskCache(QGeoCachedTileDisk *td)
 {
-    QFile::remove(td->filename);
+    if (td->cache && td->cache->restoringDiskCache_)
+        return;
+    if (td->cache && td->cache->segmentStore_)
+        td->cache->segmentStore_->remove(td->spec, td->variant);
+    else
+        QFile::remove(td->filename);
 }
 
 void QGeoFileTileCache::evictFromMemoryCache(QGeoCachedTileMemory * /* tm  */)
@@ -481,6 +1038,7 @@ QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoT
     QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
     td->spec = spec;
     td->filename = filename;
+    td->format = QFileInfo(filename).suffix();
     td->cache = this;
 
     int cost = 1;
@@ -488,7 +1046,8 @@ QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoT
         QFileInfo fi(filename);
         cost = fi.size();
     }
-    diskCache_.insert(spec, td, cost);
+    if (diskCache_.insert(spec, td, cost))
+        journalDiskCache(QGeoTileCacheJournal::Insert, spec, 0, td->format, cost);
     return td;
 }
 
@@ -497,6 +1056,7 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
     QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
     td->spec = spec;
     td->filename = filename;
+    td->format = QFileInfo(filename).suffix();
     td->cache = this;
 
     int cost = 1;
@@ -504,6 +1064,7 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
         cost = bytes.size();
 
     if (diskCache_.insert(spec, td, cost)) {
+        journalDiskCache(QGeoTileCacheJournal::Insert, spec, 0, td->format, cost);
         QFile file(filename);
         file.open(QIODevice::WriteOnly);
         file.write(bytes);
@@ -513,6 +1074,60 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
     return false;
 }
 
+QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, int variant,
+                                                                     const QString &format, int size)
+{
+    QSharedPointer<QGeoCachedTileDisk> td = createDiskTile(spec, variant, format);
+    const int cost = costStrategyDisk_ == ByteSize ? size : 1;
+    if (!diskCache_.insert(spec, td, cost)) {
+        td->cache = 0; // never stored, nothing to evict
+        return QSharedPointer<QGeoCachedTileDisk>();
+    }
+    journalDiskCache(QGeoTileCacheJournal::Insert, spec, variant, format, cost);
+    return td;
+}
+
+QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::createDiskTile(const QGeoTileSpec &spec, int variant,
+                                                                     const QString &format)
+{
+    QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
+    td->spec = spec;
+    td->format = format;
+    td->variant = variant;
+    if (!segmentStore_)
+        td->filename = tileSpecToFilename(spec, format, directory_);
+    td->cache = this;
+    return td;
+}
+
+QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::diskCacheObject(const QGeoTileSpec &spec)
+{
+    // Hits change the popularity and queue order as well, misses change nothing
+    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+    if (td)
+        journalDiskCache(QGeoTileCacheJournal::Touch, spec);
+    return td;
+}
+
+void QGeoFileTileCache::removeFromDiskCache(const QGeoTileSpec &spec, bool force)
+{
+    journalDiskCache(QGeoTileCacheJournal::Remove, spec);
+    diskCache_.remove(spec, force);
+}
+
+QByteArray QGeoFileTileCache::readFromDisk(const QSharedPointer<QGeoCachedTileDisk> &td, QString *format) const
+{
+    if (segmentStore_)
+        return segmentStore_->read(td->spec, td->variant, format);
+
+    *format = QFileInfo(td->filename).suffix();
+    QFile file(td->filename);
+    file.open(QIODevice::ReadOnly);
+    QByteArray bytes = file.readAll();
+    file.close();
+    return bytes;
+}
+
 void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format)
 {
     if (isTileBogus(bytes))
@@ -527,7 +1142,8 @@ void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteAr
     int cost = 1;
     if (costStrategyMemory_ == ByteSize)
         cost = bytes.size();
-    memoryCache_.insert(spec, tm, cost);
+    if (memoryCache_.insert(spec, tm, cost))
+        memoryCache_.tileIndex().insert(spec);
 }
 
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image)
@@ -539,7 +1155,8 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoT
     int cost = 1;
     if (costStrategyTexture_ == ByteSize)
         cost = image.width() * image.height() * image.depth() / 8;
-    textureCache_.insert(spec, tt, cost);
+    if (textureCache_.insert(spec, tt, cost))
+        textureCache_.tileIndex().insert(spec);
 
     return tt;
 }
@@ -566,24 +1183,17 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileS
 
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpec &spec)
 {
-    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+    QSharedPointer<QGeoCachedTileDisk> td = diskCacheObject(spec);
     if (td) {
-        const QString format = QFileInfo(td->filename).suffix();
-        QFile file(td->filename);
-        file.open(QIODevice::ReadOnly);
-        QByteArray bytes = file.readAll();
-        file.close();
+        QString format;
+        const QByteArray bytes = readFromDisk(td, &format);
 
         QImage image;
         // Some tiles from the servers could be valid images but the tile fetcher
         // might be able to recognize them as tiles that should not be shown.
         // If that's the case, the tile fetcher should write "NoRetry" inside the file.
-        if (isTileBogus(bytes)) {
-            QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
-            tt->spec = spec;
-            tt->image = image;
-            return tt;
-        }
+        if (isTileBogus(bytes))
+            return addToTextureCache(spec, image);
 
         // This is a truly invalid image. The fetcher should try again.
         if (!image.loadFromData(bytes)) {
@@ -611,6 +1221,16 @@ bool QGeoFileTileCache::isTileBogus(const QByteArray &bytes) const
     return false;
 }
 
+/*
+    Returns the variant a tile is stored under in segment storage. Tiles stored
+    under another variant are kept on disk but not used.
+*/
+int QGeoFileTileCache::diskVariant(const QGeoTileSpec &spec) const
+{
+    Q_UNUSED(spec);
+    return 0;
+}
+
 QString QGeoFileTileCache::tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const
 {
     return tileSpecToFilenameDefault(spec, format, directory);
@@ -55,8 +55,14 @@
 #include <QSet>
 #include <QMutex>
 #include <QTimer>
+#include <QThreadPool>
+#include <QQueue>
+#include <QScopedPointer>
 
 #include "qgeotilespec_p.h"
+#include "qgeotilesegmentstore_p.h"
+#include "qgeotilecachejournal_p.h"
+#include "qgeotilequadtree_p.h"
 #include "qgeotiledmappingmanagerengine_p.h"
 #include "qabstractgeotilecache_p.h"
 
@@ -69,6 +75,10 @@ class QGeoMappingManager;
 class QGeoTile;
 class QGeoCachedTileMemory;
 class QGeoFileTileCache;
+class QGeoTileDecodeJob;
+class QGeoTileDecodeTask;
+class QGeoTileCompactionTask;
+class QGeoTileSnapshotTask;
 
 class QPixmap;
 class QThread;
@@ -83,6 +93,7 @@ public:
     QGeoTileSpec spec;
     QString filename;
     QString format;
+    int variant = 0; // segment storage only
     QGeoFileTileCache *cache;
 };
 
@@ -95,10 +106,43 @@ protected:
     void aboutToBeEvicted(const QGeoTileSpec &key, QSharedPointer<QGeoCachedTileDisk> obj);
 };
 
+/* Eviction policy for the memory and texture caches, keeping a quadtree index
+ * of their contents. Insertions are added by the cache itself */
+template <class T>
+class QCache3QTileIndexPolicy : public QCache3QDefaultEvictionPolicy<QGeoTileSpec, T>
+{
+public:
+    QGeoTileQuadtree &tileIndex() { return tileIndex_; }
+    const QGeoTileQuadtree &tileIndex() const { return tileIndex_; }
+
+protected:
+    void aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<T> obj)
+    {
+        Q_UNUSED(obj);
+        tileIndex_.remove(key);
+    }
+    void aboutToBeEvicted(const QGeoTileSpec &key, QSharedPointer<T> obj)
+    {
+        Q_UNUSED(obj);
+        tileIndex_.remove(key);
+    }
+
+private:
+    QGeoTileQuadtree tileIndex_;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoFileTileCache : public QAbstractGeoTileCache
 {
     Q_OBJECT
 public:
+    // Version of the tiles composed by placeholderTexture(), no fetched tile has it
+    enum { placeholderVersion = -2 };
+
+    enum DiskStorage {
+        TileFiles,      // one file per tile
+        SegmentFiles    // tiles packed into segment files, see QGeoTileSegmentStore
+    };
+
     QGeoFileTileCache(const QString &directory = QString(), QObject *parent = 0);
     ~QGeoFileTileCache();
 
@@ -124,8 +168,20 @@ public:
     void setCostStrategyTexture(CostStrategy costStrategy) override;
     CostStrategy costStrategyTexture() const override;
 
+    // Has to be set before init()
+    void setDiskStorage(DiskStorage storage);
+    DiskStorage diskStorage() const;
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+    QSharedPointer<QGeoTileTexture> requestTexture(const QGeoTileSpec &spec, bool *pending = nullptr) override;
+    QSharedPointer<QGeoTileTexture> placeholderTexture(const QGeoTileSpec &spec) override;
+    void cancelDecoding(const QSet<QGeoTileSpec> &tiles) override;
+
+    // Off by default. Further requests wait while count decodes are running.
+    void setAsyncDecoding(bool enabled);
+    bool asyncDecoding() const;
+    void setMaxPendingDecodes(int count);
+    int maxPendingDecodes() const;
 
     // can be called without a specific tileCache pointer
     static void evictFromDiskCache(QGeoCachedTileDisk *td);
@@ -152,14 +208,37 @@ protected:
     QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image);
     QSharedPointer<QGeoTileTexture> getFromMemory(const QGeoTileSpec &spec);
     QSharedPointer<QGeoTileTexture> getFromDisk(const QGeoTileSpec &spec);
+    QSharedPointer<QGeoTileTexture> composeTexture(const QGeoTileSpec &spec,
+                                                   const QVector<QGeoTileSpec> &descendants);
 
+    QSharedPointer<QGeoCachedTileDisk> addToDiskCache(const QGeoTileSpec &spec, int variant,
+                                                      const QString &format, int size);
+    QSharedPointer<QGeoCachedTileDisk> diskCacheObject(const QGeoTileSpec &spec);
+    void removeFromDiskCache(const QGeoTileSpec &spec, bool force = false);
+    QByteArray readFromDisk(const QSharedPointer<QGeoCachedTileDisk> &td, QString *format) const;
+
+    virtual bool locateTile(const QGeoTileSpec &spec, QString *fileName, qint64 *offset, int *length);
     virtual bool isTileBogus(const QByteArray &bytes) const;
+    virtual int diskVariant(const QGeoTileSpec &spec) const;
     virtual QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const;
     virtual QGeoTileSpec filenameToTileSpec(const QString &filename) const;
 
+    void startDecoding();
+    void finishDecoding(const QSharedPointer<QGeoTileDecodeJob> &job);
+    void startCompaction();
+    void finishCompaction();
+
+    QSharedPointer<QGeoCachedTileDisk> createDiskTile(const QGeoTileSpec &spec, int variant, const QString &format);
+    void restoreDiskCacheState(QSet<QString> *files, QSet<QGeoTileSpec> *restored);
+    void saveDiskCacheState();
+    void saveDiskCacheStateInBackground();
+    void collectDiskCacheState(QVector<QGeoTileCacheJournal::Node> *queues);
+    void journalDiskCache(QGeoTileCacheJournal::Operation operation, const QGeoTileSpec &spec,
+                          int variant = 0, const QString &format = QString(), int cost = 0);
+
     QCache3Q<QGeoTileSpec, QGeoCachedTileDisk, QCache3QTileEvictionPolicy > diskCache_;
-    QCache3Q<QGeoTileSpec, QGeoCachedTileMemory > memoryCache_;
-    QCache3Q<QGeoTileSpec, QGeoTileTexture > textureCache_;
+    QCache3Q<QGeoTileSpec, QGeoCachedTileMemory, QCache3QTileIndexPolicy<QGeoCachedTileMemory> > memoryCache_;
+    QCache3Q<QGeoTileSpec, QGeoTileTexture, QCache3QTileIndexPolicy<QGeoTileTexture> > textureCache_;
 
     QString directory_;
 
@@ -171,6 +250,23 @@ protected:
     bool isDiskCostSet_;
     bool isMemoryCostSet_;
     bool isTextureCostSet_;
+    DiskStorage diskStorage_;
+    QScopedPointer<QGeoTileSegmentStore> segmentStore_;
+    QScopedPointer<QGeoTileCacheJournal> journal_;
+    QTimer journalFlushTimer_;
+    bool restoringDiskCache_;
+
+    bool asyncDecoding_;
+    int maxPendingDecodes_;
+    int runningDecodes_;
+    QHash<QGeoTileSpec, QSharedPointer<QGeoTileDecodeJob> > pendingDecodes_; // running or waiting
+    QQueue<QSharedPointer<QGeoTileDecodeJob> > deferredDecodes_;
+    QThreadPool decodePool_; // also compacts the segment store
+    bool compacting_;
+
+    friend class QGeoTileDecodeTask;
+    friend class QGeoTileCompactionTask;
+    friend class QGeoTileSnapshotTask;
 };
 
 QT_END_NAMESPACE
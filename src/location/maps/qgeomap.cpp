@@ -319,6 +319,23 @@ QRectF QGeoMap::visibleArea() const
     return d->visibleArea();
 }
 
+/*
+    Lets the polylines on the map draw with the OpenGLExtruded backend when
+    the OpenGL scene graph backend is used. Disabled by default, to be set
+    by the plugin before map items are added.
+*/
+void QGeoMap::setExtrudedPolylinesEnabled(bool enabled)
+{
+    Q_D(QGeoMap);
+    d->m_extrudedPolylines = enabled;
+}
+
+bool QGeoMap::extrudedPolylinesEnabled() const
+{
+    Q_D(const QGeoMap);
+    return d->m_extrudedPolylines;
+}
+
 QList<QGeoMapObject *> QGeoMap::mapObjects() const
 {
     Q_D(const QGeoMap);
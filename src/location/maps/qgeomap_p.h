@@ -158,6 +158,9 @@ public:
     void setVisibleArea(const QRectF &visibleArea);
     QRectF visibleArea() const;
 
+    void setExtrudedPolylinesEnabled(bool enabled);
+    bool extrudedPolylinesEnabled() const;
+
 protected:
     QGeoMap(QGeoMapPrivate &dd, QObject *parent = 0);
     void setCameraData(const QGeoCameraData &cameraData);
@@ -124,6 +124,7 @@ protected:
     QList<QDeclarativeGeoMapItemBase *> m_mapItems;
     QGeoCameraCapabilities m_cameraCapabilities;
     bool m_copyrightVisible = true;
+    bool m_extrudedPolylines = false;
     mutable double m_maximumViewportLatitude = 0;
     mutable double m_minimumViewportLatitude = 0;
 };
@@ -35,9 +35,9 @@
 ****************************************************************************/
 
 #include "qgeoprojection_p.h"
+#include "qgeoconvexclipper_p.h"
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtPositioning/private/qlocationutils_p.h>
-#include <QtPositioning/private/qclipperutils_p.h>
 #include <QtPositioning/QGeoPolygon>
 #include <QtPositioning/QGeoRectangle>
 #include <QSize>
@@ -411,6 +411,18 @@ QMatrix4x4 QGeoProjectionWebMercator::quickItemTransformation(const QGeoCoordina
     return toMatrix4x4(m_quickItemTransformation * matTranslateScale);
 }
 
+QMatrix4x4 QGeoProjectionWebMercator::relativeItemTransformation(const QDoubleVector2D &wrappedOrigin) const
+{
+    QDoubleMatrix4x4 matTranslate;
+    matTranslate.translate(wrappedOrigin.x(), wrappedOrigin.y(), 0.0);
+    return toMatrix4x4(m_transformation * matTranslate);
+}
+
+double QGeoProjectionWebMercator::nearPlane() const
+{
+    return m_nearPlane;
+}
+
 bool QGeoProjectionWebMercator::isProjectable(const QDoubleVector2D &wrappedProjection) const
 {
     if (m_cameraData.tilt() == 0.0)
@@ -430,21 +442,28 @@ QList<QDoubleVector2D> QGeoProjectionWebMercator::visibleGeometry() const
 {
     if (m_visibleRegionDirty)
         const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
-    return m_visibleRegion;
+    return m_regions.visible;
 }
 
 QList<QDoubleVector2D> QGeoProjectionWebMercator::visibleGeometryExpanded() const
 {
     if (m_visibleRegionDirty)
         const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
-    return m_visibleRegionExpanded;
+    return m_regions.visibleExpanded;
 }
 
 QList<QDoubleVector2D> QGeoProjectionWebMercator::projectableGeometry() const
 {
     if (m_visibleRegionDirty)
         const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
-    return m_projectableRegion;
+    return m_regions.projectable;
+}
+
+const QGeoProjectionWebMercator::Regions &QGeoProjectionWebMercator::regions() const
+{
+    if (m_visibleRegionDirty)
+        const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
+    return m_regions;
 }
 
 QGeoShape QGeoProjectionWebMercator::visibleRegion() const
@@ -681,6 +700,40 @@ void QGeoProjectionWebMercator::setupCamera()
     m_visibleRegionDirty = true;
 }
 
+// Reuses the nodes of the list when its size does not change
+static void assignRegion(const QGeoConvexClipper::Polygon &polygon, QList<QDoubleVector2D> *region, QRectF *bounds)
+{
+    if (region->size() != polygon.size()) {
+        region->clear();
+        region->reserve(polygon.size());
+        for (const QDoubleVector2D &v : polygon)
+            region->append(v);
+    } else {
+        for (int i = 0; i < polygon.size(); ++i)
+            (*region)[i] = polygon.at(i);
+    }
+
+    if (polygon.isEmpty()) {
+        *bounds = QRectF();
+        return;
+    }
+    double left = polygon.first().x();
+    double right = left;
+    double top = polygon.first().y();
+    double bottom = top;
+    for (const QDoubleVector2D &v : polygon) {
+        left = qMin(left, v.x());
+        right = qMax(right, v.x());
+        top = qMin(top, v.y());
+        bottom = qMax(bottom, v.y());
+    }
+    *bounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+}
+
+/*
+    All the regions are intersections of convex quadrilaterals, so they are
+    computed with QGeoConvexClipper on the stack.
+*/
 void QGeoProjectionWebMercator::updateVisibleRegion()
 {
     m_visibleRegionDirty = false;
@@ -704,37 +757,23 @@ void QGeoProjectionWebMercator::updateVisibleRegion()
     double leftX = geoToWrappedMapProjection(QGeoCoordinate(0, mapLeftLongitude)).x();
     double rightX = geoToWrappedMapProjection(QGeoCoordinate(0, mapRightLongitude)).x();
 
-    QList<QDoubleVector2D> mapRect;
-    mapRect.push_back(QDoubleVector2D(leftX, 1.0));
-    mapRect.push_back(QDoubleVector2D(rightX, 1.0));
-    mapRect.push_back(QDoubleVector2D(rightX, 0.0));
-    mapRect.push_back(QDoubleVector2D(leftX, 0.0));
-
-    QList<QDoubleVector2D> viewportRect;
-    viewportRect.push_back(bl);
-    viewportRect.push_back(br);
-    viewportRect.push_back(tr);
-    viewportRect.push_back(tl);
-
-    c2t::clip2tri clipper;
-    clipper.clearClipper();
-    clipper.addSubjectPath(QClipperUtils::qListToPath(mapRect), true);
-    clipper.addClipPolygon(QClipperUtils::qListToPath(viewportRect));
-
-    Paths res = clipper.execute(c2t::clip2tri::Intersection);
-    m_visibleRegion.clear();
-    if (res.size())
-        m_visibleRegion = QClipperUtils::pathToQList(res[0]); // Intersection between two convex quadrilaterals should always be a single polygon
-
-    m_projectableRegion.clear();
-    mapRect.clear();
+    const QDoubleVector2D mapRect[] = { QDoubleVector2D(leftX, 1.0),
+                                        QDoubleVector2D(rightX, 1.0),
+                                        QDoubleVector2D(rightX, 0.0),
+                                        QDoubleVector2D(leftX, 0.0) };
+    const QDoubleVector2D viewportRect[] = { bl, br, tr, tl };
+
+    QGeoConvexClipper::Polygon visibleRegion;
+    QGeoConvexClipper::intersect(mapRect, 4, viewportRect, 4, &visibleRegion);
+
     // The full map rectangle in extended mercator space
-    mapRect.push_back(QDoubleVector2D(-1.0, 1.0));
-    mapRect.push_back(QDoubleVector2D( 2.0, 1.0));
-    mapRect.push_back(QDoubleVector2D( 2.0, 0.0));
-    mapRect.push_back(QDoubleVector2D(-1.0, 0.0));
+    const QDoubleVector2D extendedMapRect[] = { QDoubleVector2D(-1.0, 1.0),
+                                                QDoubleVector2D( 2.0, 1.0),
+                                                QDoubleVector2D( 2.0, 0.0),
+                                                QDoubleVector2D(-1.0, 0.0) };
+    QGeoConvexClipper::Polygon projectableRegion;
     if (m_cameraData.tilt() == 0) {
-        m_projectableRegion = mapRect;
+        projectableRegion.append(extendedMapRect, 4);
     } else {
         QGeoProjectionWebMercator::Plane nearPlane(m_centerNearPlaneMercator, m_viewNormalized);
         Line2D nearPlaneXYIntersection = nearPlane.planeXYIntersection();
@@ -753,46 +792,35 @@ void QGeoProjectionWebMercator::updateVisibleRegion()
         QDoubleVector2D br = nearPlaneXYIntersection.m_point
                             + squareHalfSide * nearPlaneXYIntersection.m_direction;
 
-        QList<QDoubleVector2D> projectableRect;
-        projectableRect.push_back(bl);
-        projectableRect.push_back(br);
-        projectableRect.push_back(tr);
-        projectableRect.push_back(tl);
-
-
-        c2t::clip2tri clipperProjectable;
-        clipperProjectable.clearClipper();
-        clipperProjectable.addSubjectPath(QClipperUtils::qListToPath(mapRect), true);
-        clipperProjectable.addClipPolygon(QClipperUtils::qListToPath(projectableRect));
-
-        Paths resProjectable = clipperProjectable.execute(c2t::clip2tri::Intersection);
-        if (resProjectable.size())
-            m_projectableRegion = QClipperUtils::pathToQList(resProjectable[0]); // Intersection between two convex quadrilaterals should always be a single polygon
-        else
-            m_projectableRegion = viewportRect;
+        const QDoubleVector2D projectableRect[] = { bl, br, tr, tl };
+        QGeoConvexClipper::intersect(extendedMapRect, 4, projectableRect, 4, &projectableRegion);
+        if (projectableRegion.isEmpty())
+            projectableRegion.append(viewportRect, 4);
     }
 
-    // Compute m_visibleRegionExpanded as a clipped expanded version of m_visibleRegion
-    QDoubleVector2D centroid;
-    for (const QDoubleVector2D &v: qAsConst(m_visibleRegion))
-        centroid += v;
-    centroid /= m_visibleRegion.size();
-
-    m_visibleRegionExpanded.clear();
-    for (const QDoubleVector2D &v: qAsConst(m_visibleRegion)) {
-        const QDoubleVector2D vc = v - centroid;
-        m_visibleRegionExpanded.push_back(centroid + vc * 1.2); // fixing expansion factor to 1.2
+    // The expanded visible region is a clipped expanded version of the visible region
+    QGeoConvexClipper::Polygon visibleRegionExpanded;
+    if (!visibleRegion.isEmpty()) {
+        QDoubleVector2D centroid;
+        for (const QDoubleVector2D &v : qAsConst(visibleRegion))
+            centroid += v;
+        centroid /= visibleRegion.size();
+
+        QGeoConvexClipper::Polygon expanded;
+        for (const QDoubleVector2D &v : qAsConst(visibleRegion))
+            expanded.append(centroid + (v - centroid) * 1.2); // fixing expansion factor to 1.2
+
+        QGeoConvexClipper::intersect(expanded.constData(), expanded.size(),
+                                     projectableRegion.constData(), projectableRegion.size(),
+                                     &visibleRegionExpanded);
+        if (visibleRegionExpanded.isEmpty())
+            visibleRegionExpanded = visibleRegion;
     }
 
-    c2t::clip2tri clipperExpanded;
-    clipperExpanded.clearClipper();
-    clipperExpanded.addSubjectPath(QClipperUtils::qListToPath(m_visibleRegionExpanded), true);
-    clipperExpanded.addClipPolygon(QClipperUtils::qListToPath(m_projectableRegion));
-    Paths resVisibleExpanded = clipperExpanded.execute(c2t::clip2tri::Intersection);
-    if (resVisibleExpanded.size())
-        m_visibleRegionExpanded = QClipperUtils::pathToQList(resVisibleExpanded[0]); // Intersection between two convex quadrilaterals should always be a single polygon
-    else
-        m_visibleRegionExpanded = m_visibleRegion;
+    assignRegion(visibleRegion, &m_regions.visible, &m_regions.visibleBounds);
+    assignRegion(visibleRegionExpanded, &m_regions.visibleExpanded, &m_regions.visibleExpandedBounds);
+    assignRegion(projectableRegion, &m_regions.projectable, &m_regions.projectableBounds);
+    ++m_regions.version;
 }
 
 QGeoCameraData QGeoProjectionWebMercator::cameraData() const
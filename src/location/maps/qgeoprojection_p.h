@@ -52,6 +52,7 @@
 #include <QtLocation/private/qgeocameradata_p.h>
 #include <QtPositioning/private/qdoublematrix4x4_p.h>
 #include <QtPositioning/QGeoShape>
+#include <QtCore/QRectF>
 
 QT_BEGIN_NAMESPACE
 
@@ -153,12 +154,35 @@ public:
     QDoubleVector2D geoToWrappedMapProjection(const QGeoCoordinate &coordinate) const;
     QGeoCoordinate wrappedMapProjectionToGeo(const QDoubleVector2D &wrappedProjection) const;
     QMatrix4x4 quickItemTransformation(const QGeoCoordinate &coordinate, const QPointF &anchorPoint, qreal zoomLevel) const;
+    // From wrapped map projection relative to wrappedOrigin to item positions,
+    // before the perspective division. Small relative coordinates keep single
+    // precision geometry accurate when transformed on the GPU.
+    QMatrix4x4 relativeItemTransformation(const QDoubleVector2D &wrappedOrigin) const;
+    // The distance of the near plane from the eye, in the units of w after
+    // the transformation above
+    double nearPlane() const;
 
     bool isProjectable(const QDoubleVector2D &wrappedProjection) const;
     QList<QDoubleVector2D> visibleGeometry() const;
     QList<QDoubleVector2D> visibleGeometryExpanded() const;
     QList<QDoubleVector2D> projectableGeometry() const;
 
+    // The geometries above, in wrapped map projection, with their bounding
+    // boxes. They are recomputed once after each change of the camera, which
+    // also changes version, so anything derived from them can be cached
+    // against it.
+    struct Regions
+    {
+        QList<QDoubleVector2D> visible;
+        QList<QDoubleVector2D> visibleExpanded;
+        QList<QDoubleVector2D> projectable;
+        QRectF visibleBounds;
+        QRectF visibleExpandedBounds;
+        QRectF projectableBounds;
+        quint64 version = 0;
+    };
+    const Regions &regions() const;
+
     inline QDoubleVector2D viewportToWrappedMapProjection(const QDoubleVector2D &itemPosition) const;
     inline QDoubleVector2D viewportToWrappedMapProjection(const QDoubleVector2D &itemPosition, double &s) const;
 
@@ -241,9 +265,7 @@ protected:
     double           m_nearPlaneMercator;
     Line2D           m_nearPlaneMapIntersection;
 
-    QList<QDoubleVector2D> m_visibleRegion;
-    QList<QDoubleVector2D> m_visibleRegionExpanded;
-    QList<QDoubleVector2D> m_projectableRegion;
+    Regions          m_regions;
     bool             m_visibleRegionDirty;
     QRectF           m_visibleArea;
 
@@ -367,7 +367,7 @@ bool QGeoRoutePrivate::equals(const QGeoRoutePrivate &other) const
             && (travelTime() == other.travelTime())
             && (distance() == other.distance())
             && (travelMode() == other.travelMode())
-            && (path() == other.path())
+            && (coordinateArray() == other.coordinateArray())
             && (metadata() == other.metadata())
             && (routeLegs() == other.routeLegs()));
 }
@@ -442,6 +442,16 @@ QList<QGeoCoordinate> QGeoRoutePrivate::path() const
     return QList<QGeoCoordinate>();
 }
 
+void QGeoRoutePrivate::setCoordinateArray(const QGeoCoordinateArray &path)
+{
+    setPath(path.toList());
+}
+
+QGeoCoordinateArray QGeoRoutePrivate::coordinateArray() const
+{
+    return QGeoCoordinateArray(path());
+}
+
 void QGeoRoutePrivate::setFirstSegment(const QGeoRouteSegment &firstSegment)
 {
     Q_UNUSED(firstSegment)
@@ -457,6 +467,11 @@ const QGeoRoutePrivate *QGeoRoutePrivate::routePrivateData(const QGeoRoute &rout
     return route.d_ptr.data();
 }
 
+QGeoRoutePrivate *QGeoRoutePrivate::get(QGeoRoute &route)
+{
+    return route.d_ptr.data();
+}
+
 QVariantMap QGeoRoutePrivate::metadata() const
 {
     return QVariantMap();
@@ -514,7 +529,12 @@ QGeoRoutePrivateDefault::QGeoRoutePrivateDefault(const QGeoRoutePrivateDefault &
       m_path(other.m_path),
       m_legs(other.m_legs),
       m_firstSegment(other.m_firstSegment),
-      m_numSegments(other.m_numSegments){}
+      m_numSegments(other.m_numSegments)
+{
+    QMutexLocker locker(&other.m_pathMutex);
+    m_pathList = other.m_pathList;
+    m_pathListDirty = other.m_pathListDirty;
+}
 
 
 QGeoRoutePrivateDefault::~QGeoRoutePrivateDefault() {}
@@ -586,10 +606,33 @@ QGeoRouteRequest::TravelMode QGeoRoutePrivateDefault::travelMode() const
 
 void QGeoRoutePrivateDefault::setPath(const QList<QGeoCoordinate> &path)
 {
-    m_path = path;
+    m_path = QGeoCoordinateArray(path);
+    m_pathList = path; // shared, so kept rather than rebuilt
+    m_pathListDirty = false;
 }
 
+/*
+    The list is built from the packed array on the first call after the
+    array changed, so callers polling path() do not convert it every time.
+*/
 QList<QGeoCoordinate> QGeoRoutePrivateDefault::path() const
+{
+    QMutexLocker locker(&m_pathMutex);
+    if (m_pathListDirty) {
+        m_pathList = m_path.toList();
+        m_pathListDirty = false;
+    }
+    return m_pathList;
+}
+
+void QGeoRoutePrivateDefault::setCoordinateArray(const QGeoCoordinateArray &path)
+{
+    m_path = path;
+    m_pathList.clear();
+    m_pathListDirty = true;
+}
+
+QGeoCoordinateArray QGeoRoutePrivateDefault::coordinateArray() const
 {
     return m_path;
 }
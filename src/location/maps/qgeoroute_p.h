@@ -54,8 +54,11 @@
 #include "qgeorectangle.h"
 #include "qgeoroutesegment.h"
 
+#include <QtPositioning/private/qgeocoordinatearray_p.h>
+
 #include <QSharedData>
 #include <QScopedPointer>
+#include <QMutex>
 
 QT_BEGIN_NAMESPACE
 
@@ -92,6 +95,11 @@ public:
     virtual void setPath(const QList<QGeoCoordinate> &path);
     virtual QList<QGeoCoordinate> path() const;
 
+    // Default implementations go through setPath() and path(). The
+    // coordinate array is only accessible to the Qt modules and plugins.
+    virtual void setCoordinateArray(const QGeoCoordinateArray &path);
+    virtual QGeoCoordinateArray coordinateArray() const;
+
     virtual void setFirstSegment(const QGeoRouteSegment &firstSegment);
     virtual QGeoRouteSegment firstSegment() const;
 
@@ -110,6 +118,7 @@ public:
     virtual QGeoRoute containingRoute() const;
 
     static const QGeoRoutePrivate *routePrivateData(const QGeoRoute &route);
+    static QGeoRoutePrivate *get(QGeoRoute &route);
 
 protected:
     virtual bool equals(const QGeoRoutePrivate &other) const;
@@ -144,6 +153,9 @@ public:
     virtual void setPath(const QList<QGeoCoordinate> &path) override;
     virtual QList<QGeoCoordinate> path() const override;
 
+    virtual void setCoordinateArray(const QGeoCoordinateArray &path) override;
+    virtual QGeoCoordinateArray coordinateArray() const override;
+
     virtual void setFirstSegment(const QGeoRouteSegment &firstSegment) override;
     virtual QGeoRouteSegment firstSegment() const override;
 
@@ -170,7 +182,11 @@ public:
 
     QGeoRouteRequest::TravelMode m_travelMode;
 
-    QList<QGeoCoordinate> m_path;
+    QGeoCoordinateArray m_path;
+    // m_path as returned by path(), built on the first call after a change
+    mutable QList<QGeoCoordinate> m_pathList;
+    mutable bool m_pathListDirty = false;
+    mutable QMutex m_pathMutex;
     QList<QGeoRouteLeg> m_legs;
     QGeoRouteSegment m_firstSegment;
     mutable int m_numSegments;
@@ -43,6 +43,8 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
+#include <QtCore/QRunnable>
+#include <QtCore/QScopedPointer>
 #include <QtPositioning/private/qlocationutils_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -59,13 +61,110 @@ QGeoRouteParserPrivate::~QGeoRouteParserPrivate()
 {
 }
 
+QGeoRouteParserSettings *QGeoRouteParserPrivate::copySettings() const
+{
+    QGeoRouteParserSettings *settings = new QGeoRouteParserSettings;
+    settings->trafficSide = trafficSide;
+    return settings;
+}
+
+/*
+    Decodes an encoded polyline with a precision of 6 digits, straight from
+    the string held by the JSON document. The offsets are summed up as
+    integers, so that no rounding error accumulates along the line.
+*/
+QGeoCoordinateArray QGeoRouteParserPrivate::decodePolyline(const QString &polyline)
+{
+    QGeoCoordinateArray path;
+    if (polyline.isEmpty())
+        return path;
+
+    // Every coordinate takes at least two characters, usually around eight
+    const int length = polyline.size();
+    path.reserve(length / 8 + 1);
+
+    const QChar *data = polyline.constData();
+    bool parsingLatitude = true;
+    int shift = 0;
+    int value = 0;
+    int latitude = 0;
+    int longitude = 0;
+
+    for (int i = 0; i < length; ++i) {
+        const int c = data[i].unicode() - 63;
+
+        value |= (c & 0x1f) << shift;
+        shift += 5;
+
+        // another chunk
+        if (c & 0x20)
+            continue;
+
+        const int diff = (value & 1) ? ~(value >> 1) : (value >> 1);
+
+        if (parsingLatitude) {
+            latitude += diff;
+        } else {
+            longitude += diff;
+            // Out of range values end up invalid, as with QGeoCoordinate's constructor
+            const double lat = latitude / 1e6;
+            const double lon = longitude / 1e6;
+            if (QLocationUtils::isValidLat(lat) && QLocationUtils::isValidLong(lon))
+                path.append(lat, lon);
+            else
+                path.append(qQNaN(), qQNaN());
+        }
+
+        parsingLatitude = !parsingLatitude;
+
+        value = 0;
+        shift = 0;
+    }
+
+    return path;
+}
+
+class QGeoRouteParseTask : public QRunnable
+{
+public:
+    QGeoRouteParseTask(const QGeoRouteParserPrivate *parser, QGeoRouteParseJob *job, const QByteArray &reply)
+        : m_parser(parser), m_settings(parser->copySettings()), m_job(job), m_reply(reply)
+    {
+    }
+
+    void run() override
+    {
+        if (!m_job->m_aborted.loadAcquire())
+            m_job->m_error = m_parser->parseReply(m_job->m_routes, m_job->m_errorString, m_reply, *m_settings);
+        m_reply.clear();
+
+        // Reported from the thread of the job, where its receivers were
+        // connected after parseReplyAsync() returned
+        QGeoRouteParseJob *job = m_job;
+        QMetaObject::invokeMethod(job, [job]() {
+            if (!job->m_aborted.loadAcquire())
+                emit job->finished();
+            job->deleteLater();
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    const QGeoRouteParserPrivate *m_parser;
+    QScopedPointer<const QGeoRouteParserSettings> m_settings;
+    QGeoRouteParseJob *m_job;
+    QByteArray m_reply;
+};
+
 /*
     Public class implementations
 */
 
 QGeoRouteParser::~QGeoRouteParser()
 {
-
+    // Parsing jobs call into the private data of the subclasses, and the
+    // pending jobs are deleted with the parser
+    Q_D(QGeoRouteParser);
+    d->threadPool.waitForDone();
 }
 
 QGeoRouteParser::QGeoRouteParser(QGeoRouteParserPrivate &dd, QObject *parent) : QObject(dd, parent)
@@ -76,7 +175,23 @@ QGeoRouteParser::QGeoRouteParser(QGeoRouteParserPrivate &dd, QObject *parent) :
 QGeoRouteReply::Error QGeoRouteParser::parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const
 {
     Q_D(const QGeoRouteParser);
-    return d->parseReply(routes, errorString, reply);
+    const QScopedPointer<const QGeoRouteParserSettings> settings(d->copySettings());
+    return d->parseReply(routes, errorString, reply, *settings);
+}
+
+/*
+    Parses \a reply on a worker thread, so that large routes do not block
+    the thread of the caller. The returned job emits finished() in the
+    thread of the caller once the routes or the error are available, and
+    deletes itself afterwards. The job is a child of the parser, pending
+    jobs are deleted with it without emitting finished().
+*/
+QGeoRouteParseJob *QGeoRouteParser::parseReplyAsync(const QByteArray &reply) const
+{
+    Q_D(const QGeoRouteParser);
+    QGeoRouteParseJob *job = new QGeoRouteParseJob(const_cast<QGeoRouteParser *>(this));
+    d->threadPool.start(new QGeoRouteParseTask(d, job, reply));
+    return job;
 }
 
 QUrl QGeoRouteParser::requestUrl(const QGeoRouteRequest &request, const QString &prefix) const
@@ -99,6 +214,39 @@ void QGeoRouteParser::setTrafficSide(QGeoRouteParser::TrafficSide trafficSide)
     Q_EMIT trafficSideChanged(trafficSide);
 }
 
+QGeoRouteParseJob::QGeoRouteParseJob(QObject *parent)
+    : QObject(parent), m_error(QGeoRouteReply::NoError), m_aborted(0)
+{
+}
+
+QGeoRouteParseJob::~QGeoRouteParseJob()
+{
+}
+
+QList<QGeoRoute> QGeoRouteParseJob::routes() const
+{
+    return m_routes;
+}
+
+QGeoRouteReply::Error QGeoRouteParseJob::error() const
+{
+    return m_error;
+}
+
+QString QGeoRouteParseJob::errorString() const
+{
+    return m_errorString;
+}
+
+/*
+    Skips the parsing if it has not started yet. The job does not emit
+    finished() anymore, and still deletes itself.
+*/
+void QGeoRouteParseJob::abort()
+{
+    m_aborted.storeRelease(1);
+}
+
 QT_END_NAMESPACE
 
 
@@ -53,9 +53,11 @@
 #include <QtLocation/qgeorouterequest.h>
 #include <QtCore/QByteArray>
 #include <QtCore/QUrl>
+#include <QtCore/QAtomicInt>
 
 QT_BEGIN_NAMESPACE
 
+class QGeoRouteParseJob;
 class QGeoRouteParserPrivate;
 class Q_LOCATION_PRIVATE_EXPORT QGeoRouteParser : public QObject
 {
@@ -70,6 +72,7 @@ public:
     };
     virtual ~QGeoRouteParser();
     QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const;
+    QGeoRouteParseJob *parseReplyAsync(const QByteArray &reply) const;
     QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const;
 
     TrafficSide trafficSide() const;
@@ -87,6 +90,35 @@ private:
     Q_DISABLE_COPY(QGeoRouteParser)
 };
 
+class Q_LOCATION_PRIVATE_EXPORT QGeoRouteParseJob : public QObject
+{
+    Q_OBJECT
+public:
+    ~QGeoRouteParseJob();
+
+    QList<QGeoRoute> routes() const;
+    QGeoRouteReply::Error error() const;
+    QString errorString() const;
+
+public Q_SLOTS:
+    void abort();
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    explicit QGeoRouteParseJob(QObject *parent);
+
+    QList<QGeoRoute> m_routes;
+    QGeoRouteReply::Error m_error;
+    QString m_errorString;
+    QAtomicInt m_aborted;
+
+    friend class QGeoRouteParser;
+    friend class QGeoRouteParseTask;
+    Q_DISABLE_COPY(QGeoRouteParseJob)
+};
+
 QT_END_NAMESPACE
 
 #endif // QOSRMROUTEPARSER_P_H
@@ -50,11 +50,25 @@
 
 #include <QtCore/private/qobject_p.h>
 #include <QtCore/QUrl>
+#include <QtCore/QThreadPool>
+#include <QtCore/QSharedPointer>
 #include <QtLocation/qgeoroutereply.h>
 #include <QtLocation/qgeorouterequest.h>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/private/qgeocoordinatearray_p.h>
 
 QT_BEGIN_NAMESPACE
 
+// The settings a reply is parsed with. Asynchronous parses work on a copy
+// taken when they are started, so the parser can be changed meanwhile.
+class QGeoRouteParserSettings
+{
+public:
+    virtual ~QGeoRouteParserSettings() {}
+
+    QGeoRouteParser::TrafficSide trafficSide = QGeoRouteParser::RightHandTraffic;
+};
+
 class QGeoRouteParserPrivate :  public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QGeoRouteParser)
@@ -62,10 +76,15 @@ public:
     QGeoRouteParserPrivate();
     virtual ~QGeoRouteParserPrivate();
 
-    virtual QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const = 0;
+    virtual QGeoRouteParserSettings *copySettings() const;
+    virtual QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply,
+                                             const QGeoRouteParserSettings &settings) const = 0;
     virtual QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const = 0;
 
+    static QGeoCoordinateArray decodePolyline(const QString &polyline);
+
     QGeoRouteParser::TrafficSide trafficSide;
+    mutable QThreadPool threadPool; // runs parseReplyAsync()
 };
 
 QT_END_NAMESPACE
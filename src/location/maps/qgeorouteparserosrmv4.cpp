@@ -36,7 +36,9 @@
 
 #include "qgeorouteparserosrmv4_p.h"
 #include "qgeorouteparser_p_p.h"
+#include "qgeoroute_p.h"
 #include "qgeoroutesegment.h"
+#include "qgeoroutesegment_p.h"
 #include "qgeomaneuver.h"
 
 #include <QtCore/private/qobject_p.h>
@@ -47,45 +49,6 @@
 
 QT_BEGIN_NAMESPACE
 
-static QList<QGeoCoordinate> parsePolyline(const QByteArray &data)
-{
-    QList<QGeoCoordinate> path;
-
-    bool parsingLatitude = true;
-
-    int shift = 0;
-    int value = 0;
-
-    QGeoCoordinate coord(0, 0);
-
-    for (int i = 0; i < data.length(); ++i) {
-        unsigned char c = data.at(i) - 63;
-
-        value |= (c & 0x1f) << shift;
-        shift += 5;
-
-        // another chunk
-        if (c & 0x20)
-            continue;
-
-        int diff = (value & 1) ? ~(value >> 1) : (value >> 1);
-
-        if (parsingLatitude) {
-            coord.setLatitude(coord.latitude() + (double)diff/1e6);
-        } else {
-            coord.setLongitude(coord.longitude() + (double)diff/1e6);
-            path.append(coord);
-        }
-
-        parsingLatitude = !parsingLatitude;
-
-        value = 0;
-        shift = 0;
-    }
-
-    return path;
-}
-
 static QGeoManeuver::InstructionDirection osrmInstructionDirection(const QString &instructionCode, QGeoRouteParser::TrafficSide trafficSide)
 {
     if (instructionCode == QLatin1String("0"))
@@ -245,12 +208,12 @@ static QString osrmInstructionText(const QString &instructionCode, const QString
     }
 }
 
-static QGeoRoute constructRoute(const QByteArray &geometry, const QJsonArray &instructions,
+static QGeoRoute constructRoute(const QString &geometry, const QJsonArray &instructions,
                                 const QJsonObject &summary, QGeoRouteParser::TrafficSide trafficSide)
 {
     QGeoRoute route;
 
-    QList<QGeoCoordinate> path = parsePolyline(geometry);
+    const QGeoCoordinateArray path = QGeoRouteParserPrivate::decodePolyline(geometry);
 
     QGeoRouteSegment firstSegment;
     int firstPosition = -1;
@@ -286,12 +249,13 @@ static QGeoRoute constructRoute(const QByteArray &geometry, const QJsonArray &in
 
         segment.setManeuver(maneuver);
 
+        QGeoRouteSegmentPrivate *segmentPrivate = QGeoRouteSegmentPrivate::get(segment);
         if (firstPosition == -1)
-            segment.setPath(path.mid(position));
+            segmentPrivate->setCoordinateArray(path.mid(position));
         else
-            segment.setPath(path.mid(position, firstPosition - position));
+            segmentPrivate->setCoordinateArray(path.mid(position, firstPosition - position));
 
-        segmentPathLengthCount += segment.path().length();
+        segmentPathLengthCount += segmentPrivate->coordinateArray().size();
 
         segment.setTravelTime(time);
 
@@ -304,7 +268,7 @@ static QGeoRoute constructRoute(const QByteArray &geometry, const QJsonArray &in
     route.setDistance(summary.value(QStringLiteral("total_distance")).toDouble());
     route.setTravelTime(summary.value(QStringLiteral("total_time")).toDouble());
     route.setFirstRouteSegment(firstSegment);
-    route.setPath(path);
+    QGeoRoutePrivate::get(route)->setCoordinateArray(path);
 
     return route;
 }
@@ -316,7 +280,8 @@ public:
     QGeoRouteParserOsrmV4Private();
     virtual ~QGeoRouteParserOsrmV4Private();
 
-    QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const override;
+    QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply,
+                                     const QGeoRouteParserSettings &settings) const override;
     QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const override;
 };
 
@@ -328,7 +293,8 @@ QGeoRouteParserOsrmV4Private::~QGeoRouteParserOsrmV4Private()
 {
 }
 
-QGeoRouteReply::Error QGeoRouteParserOsrmV4Private::parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const
+QGeoRouteReply::Error QGeoRouteParserOsrmV4Private::parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply,
+                                                               const QGeoRouteParserSettings &settings) const
 {
     // OSRM v4 specs: https://github.com/Project-OSRM/osrm-backend/wiki/Server-API---v4,-old
     QJsonDocument document = QJsonDocument::fromJson(reply);
@@ -350,12 +316,11 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV4Private::parseReply(QList<QGeoRoute>
 
         QJsonObject routeSummary = object.value(QStringLiteral("route_summary")).toObject();
 
-        QByteArray routeGeometry =
-            object.value(QStringLiteral("route_geometry")).toString().toLatin1();
+        const QString routeGeometry = object.value(QStringLiteral("route_geometry")).toString();
 
         QJsonArray routeInstructions = object.value(QStringLiteral("route_instructions")).toArray();
 
-        QGeoRoute route = constructRoute(routeGeometry, routeInstructions, routeSummary, trafficSide);
+        QGeoRoute route = constructRoute(routeGeometry, routeInstructions, routeSummary, settings.trafficSide);
 
         routes.append(route);
 
@@ -369,10 +334,10 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV4Private::parseReply(QList<QGeoRoute>
         if (alternativeSummaries.count() == alternativeGeometries.count() &&
             alternativeSummaries.count() == alternativeInstructions.count()) {
             for (int i = 0; i < alternativeSummaries.count(); ++i) {
-                route = constructRoute(alternativeGeometries.at(i).toString().toLatin1(),
+                route = constructRoute(alternativeGeometries.at(i).toString(),
                                        alternativeInstructions.at(i).toArray(),
                                        alternativeSummaries.at(i).toObject(),
-                                       trafficSide);
+                                       settings.trafficSide);
                 //routes.append(route);
             }
         }
@@ -52,49 +52,6 @@
 
 QT_BEGIN_NAMESPACE
 
-static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
-{
-    QList<QGeoCoordinate> path;
-    if (polylineString.isEmpty())
-        return path;
-
-    QByteArray data = polylineString.toLatin1();
-
-    bool parsingLatitude = true;
-
-    int shift = 0;
-    int value = 0;
-
-    QGeoCoordinate coord(0, 0);
-
-    for (int i = 0; i < data.length(); ++i) {
-        unsigned char c = data.at(i) - 63;
-
-        value |= (c & 0x1f) << shift;
-        shift += 5;
-
-        // another chunk
-        if (c & 0x20)
-            continue;
-
-        int diff = (value & 1) ? ~(value >> 1) : (value >> 1);
-
-        if (parsingLatitude) {
-            coord.setLatitude(coord.latitude() + (double)diff/1e6);
-        } else {
-            coord.setLongitude(coord.longitude() + (double)diff/1e6);
-            path.append(coord);
-        }
-
-        parsingLatitude = !parsingLatitude;
-
-        value = 0;
-        shift = 0;
-    }
-
-    return path;
-}
-
 static QString cardinalDirection4(QLocationUtils::CardinalDirection direction)
 {
     switch (direction) {
@@ -803,6 +760,13 @@ static QGeoManeuver::InstructionDirection instructionDirection(const QJsonObject
         return QGeoManeuver::NoDirection;
 }
 
+class QGeoRouteParserOsrmV5Settings : public QGeoRouteParserSettings
+{
+public:
+    // Shared with the parses still running when the extension is replaced
+    QSharedPointer<const QGeoRouteParserOsrmV5Extension> extension;
+};
+
 class QGeoRouteParserOsrmV5Private :  public QGeoRouteParserPrivate
 {
     Q_DECLARE_PUBLIC(QGeoRouteParserOsrmV5)
@@ -810,15 +774,18 @@ public:
     QGeoRouteParserOsrmV5Private();
     virtual ~QGeoRouteParserOsrmV5Private();
 
-    QGeoRouteSegment parseStep(const QJsonObject &step, int legIndex, int stepIndex) const;
+    QGeoRouteSegment parseStep(const QJsonObject &step, int legIndex, int stepIndex,
+                               const QGeoRouteParserOsrmV5Settings &settings) const;
 
     // QGeoRouteParserPrivate
 
-    QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const override;
+    QGeoRouteParserSettings *copySettings() const override;
+    QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply,
+                                     const QGeoRouteParserSettings &settings) const override;
     QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const override;
 
     QVariantMap m_vendorParams;
-    const QGeoRouteParserOsrmV5Extension *m_extension = nullptr;
+    QSharedPointer<const QGeoRouteParserOsrmV5Extension> m_extension;
 };
 
 QGeoRouteParserOsrmV5Private::QGeoRouteParserOsrmV5Private()
@@ -828,10 +795,18 @@ QGeoRouteParserOsrmV5Private::QGeoRouteParserOsrmV5Private()
 
 QGeoRouteParserOsrmV5Private::~QGeoRouteParserOsrmV5Private()
 {
-    delete m_extension;
 }
 
-QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step, int legIndex, int stepIndex) const {
+QGeoRouteParserSettings *QGeoRouteParserOsrmV5Private::copySettings() const
+{
+    QGeoRouteParserOsrmV5Settings *settings = new QGeoRouteParserOsrmV5Settings;
+    settings->trafficSide = trafficSide;
+    settings->extension = m_extension;
+    return settings;
+}
+
+QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step, int legIndex, int stepIndex,
+                                                         const QGeoRouteParserOsrmV5Settings &settings) const {
     // OSRM Instructions documentation: https://github.com/Project-OSRM/osrm-text-instructions
     // This goes on top of OSRM: https://github.com/Project-OSRM/osrm-backend/blob/master/docs/http.md
     // Mapbox however, includes this in the reply, under "instruction".
@@ -859,9 +834,9 @@ QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step
     QGeoCoordinate coord(latitude, longitude);
 
     QString geometry = step.value(QLatin1String("geometry")).toString();
-    QList<QGeoCoordinate> path = decodePolyline(geometry);
+    const QGeoCoordinateArray path = decodePolyline(geometry);
 
-    QGeoManeuver::InstructionDirection maneuverInstructionDirection = instructionDirection(maneuver, trafficSide);
+    QGeoManeuver::InstructionDirection maneuverInstructionDirection = instructionDirection(maneuver, settings.trafficSide);
 
     QString maneuverInstructionText = instructionText(step, maneuver, maneuverInstructionDirection);
 
@@ -892,16 +867,19 @@ QGeoRouteSegment QGeoRouteParserOsrmV5Private::parseStep(const QJsonObject &step
     geoManeuver.setExtendedAttributes(extraAttributes);
 
     segment.setDistance(distance);
-    segment.setPath(path);
+    QGeoRouteSegmentPrivate::get(segment)->setCoordinateArray(path);
     segment.setTravelTime(time);
     segment.setManeuver(geoManeuver);
-    if (m_extension)
-        m_extension->updateSegment(segment, step, maneuver);
+    if (settings.extension)
+        settings.extension->updateSegment(segment, step, maneuver);
     return segment;
 }
 
-QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const
+QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply,
+                                                               const QGeoRouteParserSettings &settings) const
 {
+    const QGeoRouteParserOsrmV5Settings &osrmSettings = static_cast<const QGeoRouteParserOsrmV5Settings &>(settings);
+
     // OSRM v5 specs: https://github.com/Project-OSRM/osrm-backend/blob/master/docs/http.md
     // Mapbox Directions API spec: https://www.mapbox.com/api-documentation/#directions
     QJsonDocument document = QJsonDocument::fromJson(reply);
@@ -937,6 +915,7 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
 
             QJsonArray legs = routeObject.value(QLatin1String("legs")).toArray();
             QList<QGeoRouteLeg> routeLegs;
+            QGeoCoordinateArray routePath;
             QGeoRoute route;
             for (int legIndex = 0; legIndex < legs.size(); ++legIndex) {
                 const QJsonValue &l = legs.at(legIndex);
@@ -961,7 +940,7 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
                         error = true;
                         break;
                     }
-                    segment = parseStep(s.toObject(), legIndex, stepIndex);
+                    segment = parseStep(s.toObject(), legIndex, stepIndex, osrmSettings);
                     if (segment.isValid()) {
                         // setNextRouteSegment done below for all segments in the route.
                         legSegments.append(segment);
@@ -975,15 +954,20 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
 
                 QGeoRouteSegmentPrivate *segmentPrivate = QGeoRouteSegmentPrivate::get(segment);
                 segmentPrivate->setLegLastSegment(true);
-                QList<QGeoCoordinate> path;
+                int pathSize = 0;
+                for (const QGeoRouteSegment &s: qAsConst(legSegments))
+                    pathSize += QGeoRouteSegmentPrivate::get(s)->coordinateArray().size();
+                QGeoCoordinateArray path;
+                path.reserve(pathSize);
                 for (const QGeoRouteSegment &s: qAsConst(legSegments))
-                    path.append(s.path());
+                    path.append(QGeoRouteSegmentPrivate::get(s)->coordinateArray());
+                routePath.append(path);
                 routeLeg.setLegIndex(legIndex);
                 routeLeg.setOverallRoute(route); // QGeoRoute::d_ptr is explicitlySharedDataPointer. Modifiers below won't detach it.
                 routeLeg.setDistance(legDistance);
                 routeLeg.setTravelTime(legTravelTime);
                 if (!path.isEmpty()) {
-                    routeLeg.setPath(path);
+                    QGeoRoutePrivate::get(routeLeg)->setCoordinateArray(path);
                     routeLeg.setFirstRouteSegment(legSegments.first());
                 }
                 routeLegs << routeLeg;
@@ -992,9 +976,7 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
             }
 
             if (!error) {
-                QList<QGeoCoordinate> path;
-                foreach (const QGeoRouteSegment &s, segments)
-                    path.append(s.path());
+                const QGeoCoordinateArray &path = routePath;
 
                 for (int i = segments.size() - 1; i > 0; --i)
                     segments[i-1].setNextRouteSegment(segments[i]);
@@ -1002,8 +984,8 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
                 route.setDistance(distance);
                 route.setTravelTime(travelTime);
                 if (!path.isEmpty()) {
-                    route.setPath(path);
-                    route.setBounds(QGeoPath(path).boundingGeoRectangle());
+                    QGeoRoutePrivate::get(route)->setCoordinateArray(path);
+                    route.setBounds(QGeoPath(path.toList()).boundingGeoRectangle());
                     route.setFirstRouteSegment(segments.first());
                 }
                 route.setRouteLegs(routeLegs);
@@ -1071,8 +1053,9 @@ QGeoRouteParserOsrmV5::~QGeoRouteParserOsrmV5()
 void QGeoRouteParserOsrmV5::setExtension(const QGeoRouteParserOsrmV5Extension *extension)
 {
     Q_D(QGeoRouteParserOsrmV5);
+    // Running parses keep the previous extension until they are done
     if (extension)
-        d->m_extension = extension;
+        d->m_extension.reset(extension);
 }
 
 QT_END_NAMESPACE
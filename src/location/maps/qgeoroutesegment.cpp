@@ -287,7 +287,7 @@ bool QGeoRouteSegmentPrivate::equals(const QGeoRouteSegmentPrivate &other) const
     return ((valid() == other.valid())
             && (travelTime() == other.travelTime())
             && (distance() == other.distance())
-            && (path() == other.path())
+            && (coordinateArray() == other.coordinateArray())
             && (maneuver() == other.maneuver()));
 }
 
@@ -341,6 +341,16 @@ void QGeoRouteSegmentPrivate::setPath(const QList<QGeoCoordinate> &path)
     Q_UNUSED(path)
 }
 
+QGeoCoordinateArray QGeoRouteSegmentPrivate::coordinateArray() const
+{
+    return QGeoCoordinateArray(path());
+}
+
+void QGeoRouteSegmentPrivate::setCoordinateArray(const QGeoCoordinateArray &path)
+{
+    setPath(path.toList());
+}
+
 QGeoManeuver QGeoRouteSegmentPrivate::maneuver() const
 {
     return QGeoManeuver();
@@ -366,6 +376,11 @@ QGeoRouteSegmentPrivate *QGeoRouteSegmentPrivate::get(QGeoRouteSegment &segment)
     return segment.d_ptr.data();
 }
 
+const QGeoRouteSegmentPrivate *QGeoRouteSegmentPrivate::get(const QGeoRouteSegment &segment)
+{
+    return segment.d_ptr.data();
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
@@ -385,7 +400,9 @@ QGeoRouteSegmentPrivateDefault::QGeoRouteSegmentPrivateDefault(const QGeoRouteSe
       m_path(other.m_path),
       m_maneuver(other.m_maneuver)
 {
-
+    QMutexLocker locker(&other.m_pathMutex);
+    m_pathList = other.m_pathList;
+    m_pathListDirty = other.m_pathListDirty;
 }
 
 QGeoRouteSegmentPrivateDefault::~QGeoRouteSegmentPrivateDefault()
@@ -443,14 +460,37 @@ void QGeoRouteSegmentPrivateDefault::setDistance(qreal distance)
     m_distance = distance;
 }
 
+/*
+    The list is built from the packed array on the first call after the
+    array changed, so callers polling path() do not convert it every time.
+*/
 QList<QGeoCoordinate> QGeoRouteSegmentPrivateDefault::path() const
 {
-    return m_path;
+    QMutexLocker locker(&m_pathMutex);
+    if (m_pathListDirty) {
+        m_pathList = m_path.toList();
+        m_pathListDirty = false;
+    }
+    return m_pathList;
 }
 
 void QGeoRouteSegmentPrivateDefault::setPath(const QList<QGeoCoordinate> &path)
+{
+    m_path = QGeoCoordinateArray(path);
+    m_pathList = path; // shared, so kept rather than rebuilt
+    m_pathListDirty = false;
+}
+
+QGeoCoordinateArray QGeoRouteSegmentPrivateDefault::coordinateArray() const
+{
+    return m_path;
+}
+
+void QGeoRouteSegmentPrivateDefault::setCoordinateArray(const QGeoCoordinateArray &path)
 {
     m_path = path;
+    m_pathList.clear();
+    m_pathListDirty = true;
 }
 
 QGeoManeuver QGeoRouteSegmentPrivateDefault::maneuver() const
@@ -51,10 +51,11 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/qgeomaneuver.h>
 #include <QtLocation/qgeoroutesegment.h>
-
+#include <QtPositioning/private/qgeocoordinatearray_p.h>
 
 #include <QSharedData>
 #include <QList>
+#include <QMutex>
 #include <QString>
 
 QT_BEGIN_NAMESPACE
@@ -86,6 +87,10 @@ public:
     virtual QList<QGeoCoordinate> path() const;
     virtual void setPath(const QList<QGeoCoordinate> &path);
 
+    // Default implementations go through path() and setPath()
+    virtual QGeoCoordinateArray coordinateArray() const;
+    virtual void setCoordinateArray(const QGeoCoordinateArray &path);
+
     virtual QGeoManeuver maneuver() const;
     virtual void setManeuver(const QGeoManeuver &maneuver);
 
@@ -94,6 +99,7 @@ public:
 
     QExplicitlySharedDataPointer<QGeoRouteSegmentPrivate> m_nextSegment;
     static QGeoRouteSegmentPrivate *get(QGeoRouteSegment &segment);
+    static const QGeoRouteSegmentPrivate *get(const QGeoRouteSegment &segment);
 
 protected:
     virtual bool equals(const QGeoRouteSegmentPrivate &other) const;
@@ -126,6 +132,9 @@ public:
     virtual QList<QGeoCoordinate> path() const override;
     virtual void setPath(const QList<QGeoCoordinate> &path) override;
 
+    virtual QGeoCoordinateArray coordinateArray() const override;
+    virtual void setCoordinateArray(const QGeoCoordinateArray &path) override;
+
     virtual QGeoManeuver maneuver() const override;
     virtual void setManeuver(const QGeoManeuver &maneuver) override;
 
@@ -134,7 +143,11 @@ public:
     bool m_legLastSegment = false;
     int m_travelTime;
     qreal m_distance;
-    QList<QGeoCoordinate> m_path;
+    QGeoCoordinateArray m_path;
+    // m_path as returned by path(), built on the first call after a change
+    mutable QList<QGeoCoordinate> m_pathList;
+    mutable bool m_pathListDirty = false;
+    mutable QMutex m_pathMutex;
     QGeoManeuver m_maneuver;
 };
 
@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeosimplifiedpath_p.h"
+#include "qgeomap_p.h"
+#include "qgeoprojection_p.h"
+
+#include <QtCore/QVarLengthArray>
+#include <QtCore/qnumeric.h>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+// Consecutive chunks share their end points, which are always kept
+static const int chunkSize = 4096;
+
+static double segmentDistance(const QDoubleVector2D &p, const QDoubleVector2D &a, const QDoubleVector2D &b)
+{
+    const QDoubleVector2D ab = b - a;
+    const double lengthSquared = QDoubleVector2D::dotProduct(ab, ab);
+    double t = 0.0;
+    if (lengthSquared > 0.0)
+        t = qBound(0.0, QDoubleVector2D::dotProduct(p - a, ab) / lengthSquared, 1.0);
+    return (a + ab * t - p).length();
+}
+
+QGeoSimplifiedPath::QGeoSimplifiedPath()
+:   rankedChunks_(0), simplifiedLevel_(0), simplifiedValid_(false)
+{
+}
+
+void QGeoSimplifiedPath::setPath(const QList<QDoubleVector2D> &path)
+{
+    path_ = path;
+    ranks_.clear();
+    rankedChunks_ = 0;
+    simplifiedValid_ = false;
+}
+
+void QGeoSimplifiedPath::append(const QDoubleVector2D &point)
+{
+    path_.append(point);
+    simplifiedValid_ = false;
+}
+
+void QGeoSimplifiedPath::clear()
+{
+    setPath(QList<QDoubleVector2D>());
+}
+
+const QVector<double> &QGeoSimplifiedPath::ranks()
+{
+    if (ranks_.size() != path_.size())
+        updateRanks();
+    return ranks_;
+}
+
+const QList<QDoubleVector2D> &QGeoSimplifiedPath::simplified(double tolerance)
+{
+    if (!(tolerance > 0.0) || !qIsFinite(tolerance))
+        return path_;
+
+    const int level = int(std::floor(std::log2(tolerance)));
+    if (simplifiedValid_ && level == simplifiedLevel_)
+        return simplified_;
+
+    const QVector<double> &r = ranks();
+    const double threshold = std::ldexp(1.0, level);
+    simplified_.clear();
+    for (int i = 0; i < r.size(); ++i) {
+        if (r.at(i) > threshold)
+            simplified_.append(path_.at(i));
+    }
+    simplifiedLevel_ = level;
+    simplifiedValid_ = true;
+    return simplified_;
+}
+
+void QGeoSimplifiedPath::updateRanks()
+{
+    const int size = path_.size();
+    ranks_.resize(size);
+    if (size < 3) {
+        ranks_.fill(qInf());
+        rankedChunks_ = 0;
+        return;
+    }
+
+    const int segments = size - 1;
+    const int chunks = (segments + chunkSize - 1) / chunkSize;
+    for (int chunk = rankedChunks_; chunk < chunks; ++chunk)
+        rankChunk(chunk * chunkSize, qMin((chunk + 1) * chunkSize, segments));
+    rankedChunks_ = segments / chunkSize;
+}
+
+/*
+    Douglas-Peucker from first to last, with the rank of a point limited by
+    the ranks of the points that split the path before it. Keeping the points
+    ranked above a tolerance is then what Douglas-Peucker keeps at that
+    tolerance.
+*/
+void QGeoSimplifiedPath::rankChunk(int first, int last)
+{
+    struct Range
+    {
+        int first;
+        int last;
+        double rank;
+    };
+
+    ranks_[first] = qInf();
+    ranks_[last] = qInf();
+
+    QVarLengthArray<Range, 64> stack;
+    stack.append({ first, last, qInf() });
+    while (!stack.isEmpty()) {
+        const Range range = stack.last();
+        stack.removeLast();
+        if (range.last - range.first < 2)
+            continue;
+
+        const QDoubleVector2D &a = path_.at(range.first);
+        const QDoubleVector2D &b = path_.at(range.last);
+        int split = range.first + 1;
+        double distance = -1.0;
+        for (int i = range.first + 1; i < range.last; ++i) {
+            const double d = segmentDistance(path_.at(i), a, b);
+            if (d > distance) {
+                distance = d;
+                split = i;
+            }
+        }
+
+        const double rank = qMin(distance, range.rank);
+        ranks_[split] = rank;
+        stack.append({ range.first, split, rank });
+        stack.append({ split, range.last, rank });
+    }
+}
+
+double QGeoSimplifiedPath::tolerance(const QGeoMap &map, double pixels)
+{
+    if (map.geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
+        return 0.0;
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator &>(map.geoProjection());
+    const double flat = pixels / p.mapWidth();
+    if (p.cameraData().tilt() == 0.0)
+        return flat;
+
+    // Tilted, the map is largest along the bottom of the viewport
+    const double x = map.viewportWidth() * 0.5;
+    const double y = map.viewportHeight() - 1.0;
+    const QDoubleVector2D bottom = p.itemPositionToWrappedMapProjection(QDoubleVector2D(x, y));
+    const QDoubleVector2D right = p.itemPositionToWrappedMapProjection(QDoubleVector2D(x + 1.0, y));
+    const QDoubleVector2D up = p.itemPositionToWrappedMapProjection(QDoubleVector2D(x, y - 1.0));
+    const double step = qMin((right - bottom).length(), (up - bottom).length());
+    if (!qIsFinite(step) || step <= 0.0)
+        return flat;
+    return qMin(flat, pixels * step);
+}
+
+QT_END_NAMESPACE
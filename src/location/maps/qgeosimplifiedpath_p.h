@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOSIMPLIFIEDPATH_P_H
+#define QGEOSIMPLIFIEDPATH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+#include <QList>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoMap;
+
+/*
+    A path in map projection with the Douglas-Peucker rank of every point:
+    the largest tolerance at which the point is kept. The ranks are computed
+    once per path, in chunks of consecutive points sharing their end points,
+    which are always kept, so that appending a point only ranks the last
+    chunk again. Selecting the points significant at a
+    tolerance is then a single pass, and is cached for tolerances rounded
+    down to powers of two, so that it only runs when the zoom level changes
+    by about one.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoSimplifiedPath
+{
+public:
+    QGeoSimplifiedPath();
+
+    void setPath(const QList<QDoubleVector2D> &path);
+    void append(const QDoubleVector2D &point);
+    void clear();
+
+    inline const QList<QDoubleVector2D> &path() const { return path_; }
+    inline int size() const { return path_.size(); }
+    inline bool isEmpty() const { return path_.isEmpty(); }
+
+    // The points of the path which are further than tolerance, in map
+    // projection, from the simplified path. The first and last points are
+    // always kept.
+    const QList<QDoubleVector2D> &simplified(double tolerance);
+    const QVector<double> &ranks();
+
+    // pixels in map projection at the scale of the nearest visible part
+    // of the map.
+    static double tolerance(const QGeoMap &map, double pixels = 0.5);
+
+private:
+    void updateRanks();
+    void rankChunk(int first, int last);
+
+    QList<QDoubleVector2D> path_;
+    QVector<double> ranks_;
+    int rankedChunks_; // Chunks of ranks_ which appending does not change
+    QList<QDoubleVector2D> simplified_;
+    int simplifiedLevel_;
+    bool simplifiedValid_;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOSIMPLIFIEDPATH_P_H
@@ -0,0 +1,339 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotilearchive_p.h"
+
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Layout, all integers little endian:
+//   header: magic[4] "QGTA", quint32 version, quint32 tileCount, quint32 reserved,
+//           quint64 indexOffset, quint64 reserved
+//   data:   tile bytes, back to back
+//   index:  tileCount entries of quint64 key, quint64 offset, quint32 size, quint32 reserved
+//           sorted by key, starting on an 8 byte boundary
+const char archiveMagic[4] = { 'Q', 'G', 'T', 'A' };
+const quint32 archiveVersion = 1;
+const int headerSize = 32;
+const int entrySize = 24;
+
+}
+
+QGeoTileArchive::QGeoTileArchive()
+:   m_data(nullptr), m_size(0), m_index(nullptr), m_count(0)
+{
+}
+
+QGeoTileArchive::~QGeoTileArchive()
+{
+    close();
+}
+
+bool QGeoTileArchive::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    const uchar *data = size >= headerSize ? m_file.map(0, size) : nullptr;
+    if (!data) {
+        m_errorString = size < headerSize ? QStringLiteral("Tile archive is truncated")
+                                          : m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    const quint32 version = qFromLittleEndian<quint32>(data + 4);
+    const quint32 count = qFromLittleEndian<quint32>(data + 8);
+    const quint64 indexOffset = qFromLittleEndian<quint64>(data + 16);
+    if (memcmp(data, archiveMagic, sizeof(archiveMagic)) != 0 || version != archiveVersion) {
+        m_errorString = QStringLiteral("Not a tile archive");
+    } else if (indexOffset < quint64(headerSize) || indexOffset > quint64(size)
+               || (quint64(size) - indexOffset) / entrySize < count) {
+        m_errorString = QStringLiteral("Tile archive index is corrupted");
+    } else {
+        m_data = data;
+        m_size = size;
+        m_index = data + indexOffset;
+        m_count = count;
+        m_errorString.clear();
+        return true;
+    }
+
+    m_file.unmap(const_cast<uchar *>(data));
+    m_file.close();
+    return false;
+}
+
+void QGeoTileArchive::close()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar *>(m_data));
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_index = nullptr;
+    m_count = 0;
+}
+
+bool QGeoTileArchive::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+QString QGeoTileArchive::fileName() const
+{
+    return m_file.fileName();
+}
+
+QString QGeoTileArchive::errorString() const
+{
+    return m_errorString;
+}
+
+int QGeoTileArchive::tileCount() const
+{
+    return int(m_count);
+}
+
+bool QGeoTileArchive::contains(int mapId, int zoom, int x, int y, int variant) const
+{
+    quint64 key;
+    return tileKey(mapId, zoom, x, y, variant, &key) && findEntry(key);
+}
+
+/*
+    Returns the bytes of the tile, or an empty array if the archive does not contain it.
+    The returned array references the mapped file and is only valid while the archive is open.
+*/
+QByteArray QGeoTileArchive::tileData(int mapId, int zoom, int x, int y, int variant) const
+{
+    quint64 key;
+    if (!tileKey(mapId, zoom, x, y, variant, &key))
+        return QByteArray();
+
+    const uchar *entry = findEntry(key);
+    if (!entry)
+        return QByteArray();
+
+    const quint64 offset = qFromLittleEndian<quint64>(entry + 8);
+    const quint32 size = qFromLittleEndian<quint32>(entry + 16);
+    if (offset < quint64(headerSize) || offset + size > quint64(m_size))
+        return QByteArray();
+
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(m_data + offset), int(size));
+}
+
+bool QGeoTileArchive::locate(int mapId, int zoom, int x, int y, int variant, qint64 *offset, int *length) const
+{
+    quint64 key;
+    if (!tileKey(mapId, zoom, x, y, variant, &key))
+        return false;
+
+    const uchar *entry = findEntry(key);
+    if (!entry)
+        return false;
+
+    const quint64 tileOffset = qFromLittleEndian<quint64>(entry + 8);
+    const quint32 size = qFromLittleEndian<quint32>(entry + 16);
+    if (tileOffset < quint64(headerSize) || tileOffset + size > quint64(m_size))
+        return false;
+
+    *offset = qint64(tileOffset);
+    *length = int(size);
+    return true;
+}
+
+bool QGeoTileArchive::tileKey(int mapId, int zoom, int x, int y, int variant, quint64 *key)
+{
+    if (mapId < 0 || mapId > 0xff || variant < 0 || variant > 7 || zoom < 0 || zoom > 24)
+        return false;
+    const int side = 1 << zoom;
+    if (x < 0 || x >= side || y < 0 || y >= side)
+        return false;
+
+    *key = (quint64(mapId) << 56) | (quint64(variant) << 53) | (quint64(zoom) << 48)
+            | (quint64(x) << 24) | quint64(y);
+    return true;
+}
+
+const uchar *QGeoTileArchive::findEntry(quint64 key) const
+{
+    quint32 lo = 0;
+    quint32 hi = m_count;
+    while (lo < hi) {
+        const quint32 mid = lo + (hi - lo) / 2;
+        const uchar *entry = m_index + quint64(mid) * entrySize;
+        const quint64 k = qFromLittleEndian<quint64>(entry);
+        if (k == key)
+            return entry;
+        if (k < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return nullptr;
+}
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoTileArchiveWriter::QGeoTileArchiveWriter()
+{
+}
+
+QGeoTileArchiveWriter::~QGeoTileArchiveWriter()
+{
+}
+
+bool QGeoTileArchiveWriter::addTile(int mapId, int zoom, int x, int y, int variant, const QString &fileName)
+{
+    Source source;
+    if (!QGeoTileArchive::tileKey(mapId, zoom, x, y, variant, &source.key))
+        return false;
+    source.fileName = fileName;
+    m_tiles.append(source);
+    return true;
+}
+
+bool QGeoTileArchiveWriter::addTile(int mapId, int zoom, int x, int y, int variant, const QByteArray &data)
+{
+    Source source;
+    if (!QGeoTileArchive::tileKey(mapId, zoom, x, y, variant, &source.key))
+        return false;
+    source.data = data;
+    m_tiles.append(source);
+    return true;
+}
+
+int QGeoTileArchiveWriter::tileCount() const
+{
+    return m_tiles.size();
+}
+
+bool QGeoTileArchiveWriter::write(const QString &fileName)
+{
+    // Keep the last tile added for each key
+    std::stable_sort(m_tiles.begin(), m_tiles.end(), [](const Source &a, const Source &b) {
+        return a.key < b.key;
+    });
+    QVector<Source> tiles;
+    tiles.reserve(m_tiles.size());
+    for (int i = 0; i < m_tiles.size(); ++i) {
+        if (i + 1 < m_tiles.size() && m_tiles.at(i + 1).key == m_tiles.at(i).key)
+            continue;
+        tiles.append(m_tiles.at(i));
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    uchar header[headerSize] = {};
+    if (file.write(reinterpret_cast<const char *>(header), headerSize) != headerSize) {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    QByteArray index(tiles.size() * entrySize, Qt::Uninitialized);
+    uchar *entry = reinterpret_cast<uchar *>(index.data());
+    quint64 offset = headerSize;
+    for (const Source &tile : qAsConst(tiles)) {
+        QByteArray bytes = tile.data;
+        if (!tile.fileName.isEmpty()) {
+            QFile source(tile.fileName);
+            if (!source.open(QIODevice::ReadOnly)) {
+                m_errorString = source.errorString();
+                return false;
+            }
+            bytes = source.readAll();
+        }
+        if (file.write(bytes) != bytes.size()) {
+            m_errorString = file.errorString();
+            return false;
+        }
+
+        qToLittleEndian<quint64>(tile.key, entry);
+        qToLittleEndian<quint64>(offset, entry + 8);
+        qToLittleEndian<quint32>(quint32(bytes.size()), entry + 16);
+        qToLittleEndian<quint32>(0, entry + 20);
+        entry += entrySize;
+        offset += quint64(bytes.size());
+    }
+
+    const int padding = int((8 - offset % 8) % 8);
+    const quint64 indexOffset = offset + padding;
+    if (file.write(QByteArray(padding, '\0')) != padding || file.write(index) != index.size()) {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    memcpy(header, archiveMagic, sizeof(archiveMagic));
+    qToLittleEndian<quint32>(archiveVersion, header + 4);
+    qToLittleEndian<quint32>(quint32(tiles.size()), header + 8);
+    qToLittleEndian<quint64>(indexOffset, header + 16);
+    if (!file.seek(0) || file.write(reinterpret_cast<const char *>(header), headerSize) != headerSize) {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    if (!file.commit()) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    m_errorString.clear();
+    return true;
+}
+
+QString QGeoTileArchiveWriter::errorString() const
+{
+    return m_errorString;
+}
+
+QT_END_NAMESPACE
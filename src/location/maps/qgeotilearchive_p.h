@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILEARCHIVE_P_H
+#define QGEOTILEARCHIVE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Read-only single file tile archive.
+
+    The file starts with a fixed header, followed by the tile data and an index
+    sorted by tile key. The whole file is memory mapped; lookups are a binary
+    search over the index and return the tile bytes without copying them.
+
+    A tile key packs (mapId, variant, zoom, x, y) into 64 bits, so mapId must be
+    below 256, variant below 8 and zoom at most 24.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileArchive
+{
+public:
+    QGeoTileArchive();
+    ~QGeoTileArchive();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const;
+
+    QString fileName() const;
+    QString errorString() const;
+    int tileCount() const;
+
+    bool contains(int mapId, int zoom, int x, int y, int variant = 0) const;
+    QByteArray tileData(int mapId, int zoom, int x, int y, int variant = 0) const;
+    // Where the tile bytes are in fileName(), for reading them without the mapping
+    bool locate(int mapId, int zoom, int x, int y, int variant, qint64 *offset, int *length) const;
+
+    static bool tileKey(int mapId, int zoom, int x, int y, int variant, quint64 *key);
+
+private:
+    const uchar *findEntry(quint64 key) const;
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    const uchar *m_index;
+    quint32 m_count;
+    QString m_errorString;
+
+    Q_DISABLE_COPY(QGeoTileArchive)
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileArchiveWriter
+{
+public:
+    QGeoTileArchiveWriter();
+    ~QGeoTileArchiveWriter();
+
+    // Tiles added later replace earlier ones with the same key
+    bool addTile(int mapId, int zoom, int x, int y, int variant, const QString &fileName);
+    bool addTile(int mapId, int zoom, int x, int y, int variant, const QByteArray &data);
+    int tileCount() const;
+
+    bool write(const QString &fileName);
+    QString errorString() const;
+
+private:
+    struct Source
+    {
+        quint64 key;
+        QString fileName;
+        QByteArray data;
+    };
+
+    QVector<Source> m_tiles;
+    QString m_errorString;
+
+    Q_DISABLE_COPY(QGeoTileArchiveWriter)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEARCHIVE_P_H
@@ -0,0 +1,326 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeotileatlas_p.h"
+
+#if QT_CONFIG(opengl)
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+#endif
+
+#include <QtCore/QRunnable>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+#if QT_CONFIG(opengl)
+namespace {
+
+class QGeoTileAtlasCleanup : public QRunnable
+{
+public:
+    explicit QGeoTileAtlasCleanup(uint id) : m_id(id) {}
+
+    void run() override
+    {
+        if (QOpenGLContext *context = QOpenGLContext::currentContext())
+            context->functions()->glDeleteTextures(1, &m_id);
+    }
+
+private:
+    uint m_id;
+};
+
+}
+#endif
+
+QGeoTileAtlasAllocator::QGeoTileAtlasAllocator(const QSize &pageSize)
+:   m_pageSize(pageSize), m_frame(0)
+{
+}
+
+/*
+    Starts a new frame. Slots found or allocated from now on are in use and
+    will not be handed out again until the next frame.
+*/
+void QGeoTileAtlasAllocator::beginFrame()
+{
+    ++m_frame;
+}
+
+bool QGeoTileAtlasAllocator::find(const QGeoTileSpec &spec, Slot *slot)
+{
+    const auto it = m_lookup.constFind(spec);
+    if (it == m_lookup.constEnd())
+        return false;
+
+    const int id = it.value();
+    m_nodes[id].frame = m_frame;
+    unlink(id);
+    append(id);
+    *slot = this->slot(m_nodes.at(id));
+    return true;
+}
+
+/*
+    Returns a slot of \a size for \a spec. If a slot used in an earlier frame
+    had to be reused, its tile is stored in \a evicted.
+*/
+QGeoTileAtlasAllocator::Slot QGeoTileAtlasAllocator::allocate(const QGeoTileSpec &spec, const QSize &size,
+                                                              QGeoTileSpec *evicted)
+{
+    release(spec);
+
+    int sizeClass = 0;
+    while (sizeClass < m_classes.size() && m_classes.at(sizeClass).slotSize != size)
+        ++sizeClass;
+    if (sizeClass == m_classes.size())
+        m_classes.append(SizeClass{size, -1, -1, QVector<int>()});
+
+    SizeClass &sc = m_classes[sizeClass];
+    int id = -1;
+    if (!sc.free.isEmpty()) {
+        id = sc.free.takeLast();
+    } else {
+        for (int p = 0; p < m_pages.size() && id < 0; ++p) {
+            Page &page = m_pages[p];
+            if (page.sizeClass == sizeClass && page.allocated < page.columns * page.rows) {
+                id = m_nodes.size();
+                m_nodes.append(Node{QGeoTileSpec(), p, page.allocated++, -1, -1, 0, false});
+            }
+        }
+        if (id < 0 && sc.head >= 0 && m_nodes.at(sc.head).frame < m_frame) {
+            id = sc.head;
+            unlink(id);
+            m_lookup.remove(m_nodes.at(id).spec);
+            if (evicted)
+                *evicted = m_nodes.at(id).spec;
+        }
+        if (id < 0) {
+            const int columns = qMax(1, m_pageSize.width() / size.width());
+            const int rows = qMax(1, m_pageSize.height() / size.height());
+            m_pages.append(Page{sizeClass, columns, rows, 1});
+            id = m_nodes.size();
+            m_nodes.append(Node{QGeoTileSpec(), m_pages.size() - 1, 0, -1, -1, 0, false});
+        }
+    }
+
+    Node &node = m_nodes[id];
+    node.spec = spec;
+    node.frame = m_frame;
+    node.live = true;
+    m_lookup.insert(spec, id);
+    append(id);
+    return slot(node);
+}
+
+void QGeoTileAtlasAllocator::release(const QGeoTileSpec &spec)
+{
+    const auto it = m_lookup.find(spec);
+    if (it == m_lookup.end())
+        return;
+
+    const int id = it.value();
+    m_lookup.erase(it);
+    unlink(id);
+    m_nodes[id].live = false;
+    m_classes[m_pages.at(m_nodes.at(id).page).sizeClass].free.append(id);
+}
+
+void QGeoTileAtlasAllocator::clear()
+{
+    m_nodes.clear();
+    m_pages.clear();
+    m_classes.clear();
+    m_lookup.clear();
+}
+
+int QGeoTileAtlasAllocator::count() const
+{
+    return m_lookup.size();
+}
+
+int QGeoTileAtlasAllocator::pageCount() const
+{
+    return m_pages.size();
+}
+
+QSize QGeoTileAtlasAllocator::pageSize(int page) const
+{
+    const Page &p = m_pages.at(page);
+    const QSize slotSize = m_classes.at(p.sizeClass).slotSize;
+    return QSize(p.columns * slotSize.width(), p.rows * slotSize.height());
+}
+
+QGeoTileAtlasAllocator::Slot QGeoTileAtlasAllocator::slot(const Node &node) const
+{
+    const Page &page = m_pages.at(node.page);
+    const QSize slotSize = m_classes.at(page.sizeClass).slotSize;
+    const int column = node.index % page.columns;
+    const int row = node.index / page.columns;
+    return Slot{node.page, QRect(QPoint(column * slotSize.width(), row * slotSize.height()), slotSize)};
+}
+
+void QGeoTileAtlasAllocator::unlink(int id)
+{
+    Node &node = m_nodes[id];
+    SizeClass &sc = m_classes[m_pages.at(node.page).sizeClass];
+    if (node.prev >= 0)
+        m_nodes[node.prev].next = node.next;
+    else if (sc.head == id)
+        sc.head = node.next;
+    if (node.next >= 0)
+        m_nodes[node.next].prev = node.prev;
+    else if (sc.tail == id)
+        sc.tail = node.prev;
+    node.prev = -1;
+    node.next = -1;
+}
+
+void QGeoTileAtlasAllocator::append(int id)
+{
+    Node &node = m_nodes[id];
+    SizeClass &sc = m_classes[m_pages.at(node.page).sizeClass];
+    node.prev = sc.tail;
+    node.next = -1;
+    if (sc.tail >= 0)
+        m_nodes[sc.tail].next = id;
+    else
+        sc.head = id;
+    sc.tail = id;
+}
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoTileAtlasTexture::QGeoTileAtlasTexture(const QSize &size, QQuickWindow *window)
+:   m_size(size), m_window(window), m_id(0), m_hasAlpha(false)
+{
+}
+
+QGeoTileAtlasTexture::~QGeoTileAtlasTexture()
+{
+#if QT_CONFIG(opengl)
+    if (!m_id || !m_context)
+        return; // never created, or gone with its context
+
+    QOpenGLContext *current = QOpenGLContext::currentContext();
+    if (current && (current == m_context || QOpenGLContext::areSharing(current, m_context)))
+        current->functions()->glDeleteTextures(1, &m_id);
+    else if (m_window)
+        m_window->scheduleRenderJob(new QGeoTileAtlasCleanup(m_id), QQuickWindow::NoStage);
+#endif
+}
+
+/*
+    Queues \a image for upload into \a slot, which must be two pixels wider
+    and higher than the image to leave room for the border.
+*/
+void QGeoTileAtlasTexture::upload(const QRect &slot, const QImage &image)
+{
+    Q_ASSERT(slot.width() >= image.width() + 2 && slot.height() >= image.height() + 2);
+    if (image.isNull())
+        return;
+
+    const QImage source = image.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+    const int w = source.width();
+    const int h = source.height();
+    QImage padded(w + 2, h + 2, QImage::Format_RGBA8888_Premultiplied);
+    for (int y = 0; y < h + 2; ++y) {
+        const quint32 *src = reinterpret_cast<const quint32 *>(source.constScanLine(qBound(0, y - 1, h - 1)));
+        quint32 *dst = reinterpret_cast<quint32 *>(padded.scanLine(y));
+        dst[0] = src[0];
+        memcpy(dst + 1, src, size_t(w) * sizeof(quint32));
+        dst[w + 1] = src[w - 1];
+    }
+
+    m_hasAlpha = m_hasAlpha || image.hasAlphaChannel();
+    m_uploads.append(Upload{slot.topLeft(), padded});
+}
+
+int QGeoTileAtlasTexture::textureId() const
+{
+    return int(m_id);
+}
+
+QSize QGeoTileAtlasTexture::textureSize() const
+{
+    return m_size;
+}
+
+bool QGeoTileAtlasTexture::hasAlphaChannel() const
+{
+    return m_hasAlpha;
+}
+
+bool QGeoTileAtlasTexture::hasMipmaps() const
+{
+    return false;
+}
+
+void QGeoTileAtlasTexture::bind()
+{
+#if QT_CONFIG(opengl)
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if (!context)
+        return;
+    QOpenGLFunctions *f = context->functions();
+
+    if (!m_id) {
+        m_context = context;
+        f->glGenTextures(1, &m_id);
+        f->glBindTexture(GL_TEXTURE_2D, m_id);
+        f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_size.width(), m_size.height(), 0,
+                        GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        updateBindOptions(true);
+    } else {
+        f->glBindTexture(GL_TEXTURE_2D, m_id);
+        updateBindOptions(false);
+    }
+
+    if (!m_uploads.isEmpty()) {
+        f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        for (const Upload &upload : qAsConst(m_uploads)) {
+            f->glTexSubImage2D(GL_TEXTURE_2D, 0, upload.position.x(), upload.position.y(),
+                               upload.image.width(), upload.image.height(),
+                               GL_RGBA, GL_UNSIGNED_BYTE, upload.image.constBits());
+        }
+        m_uploads.clear();
+    }
+#endif
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOTILEATLAS_P_H
+#define QGEOTILEATLAS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QHash>
+#include <QImage>
+#include <QPointer>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGTexture>
+
+#include "qgeotilespec_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QOpenGLContext;
+
+/*
+    Packs tile images into a few large pages.
+
+    Every page is a grid of equally sized slots, so allocating and freeing a
+    slot is O(1). Slots of the same size are kept in least recently used
+    order; when a page runs full, the slot that has gone unused the longest is
+    handed out again, and a new page is only added when every slot of that
+    size was used in the current frame.
+
+    The allocator only does the bookkeeping, the pixels live in
+    QGeoTileAtlasTexture.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileAtlasAllocator
+{
+public:
+    struct Slot
+    {
+        int page;
+        QRect rect;
+    };
+
+    explicit QGeoTileAtlasAllocator(const QSize &pageSize = QSize(2048, 2048));
+
+    void beginFrame();
+
+    bool find(const QGeoTileSpec &spec, Slot *slot);
+    Slot allocate(const QGeoTileSpec &spec, const QSize &size, QGeoTileSpec *evicted = nullptr);
+    void release(const QGeoTileSpec &spec);
+    void clear();
+
+    int count() const;
+    int pageCount() const;
+    QSize pageSize(int page) const;
+
+private:
+    struct Node
+    {
+        QGeoTileSpec spec;
+        int page;
+        int index;
+        int prev;
+        int next;
+        quint64 frame;
+        bool live;
+    };
+
+    struct Page
+    {
+        int sizeClass;
+        int columns;
+        int rows;
+        int allocated;
+    };
+
+    struct SizeClass
+    {
+        QSize slotSize;
+        int head; // least recently used
+        int tail;
+        QVector<int> free;
+    };
+
+    Slot slot(const Node &node) const;
+    void unlink(int node);
+    void append(int node);
+
+    QSize m_pageSize;
+    quint64 m_frame;
+    QVector<Node> m_nodes;
+    QVector<Page> m_pages;
+    QVector<SizeClass> m_classes;
+    QHash<QGeoTileSpec, int> m_lookup;
+};
+
+Q_DECLARE_TYPEINFO(QGeoTileAtlasAllocator::Slot, Q_MOVABLE_TYPE);
+
+/*
+    One atlas page. Tiles are queued with upload() and copied into the
+    texture with glTexSubImage2D the next time the page is bound. Each tile
+    gets a one pixel border repeating its edge, so linear filtering does not
+    pick up texels of the neighbouring slot.
+
+    The texture object is deleted right away when its context is current on
+    destruction, and otherwise by a render job scheduled on \a window.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileAtlasTexture : public QSGTexture
+{
+    Q_OBJECT
+public:
+    QGeoTileAtlasTexture(const QSize &size, QQuickWindow *window);
+    ~QGeoTileAtlasTexture();
+
+    void upload(const QRect &slot, const QImage &image);
+
+    int textureId() const override;
+    QSize textureSize() const override;
+    bool hasAlphaChannel() const override;
+    bool hasMipmaps() const override;
+    void bind() override;
+
+private:
+    struct Upload
+    {
+        QPoint position;
+        QImage image;
+    };
+
+    QSize m_size;
+    QPointer<QQuickWindow> m_window;
+    QPointer<QOpenGLContext> m_context; // the texture was created in
+    uint m_id;
+    bool m_hasAlpha;
+    QVector<Upload> m_uploads;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEATLAS_P_H
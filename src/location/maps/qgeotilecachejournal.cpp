@@ -0,0 +1,382 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotilecachejournal_p.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const quint32 snapshotMagic = 0x51474353; // "QGCS"
+const quint32 snapshotVersion = 1;
+
+// Journal: magic[4] "QGCJ", quint32 version, quint64 generation, then records of
+//   quint16 length, payload, quint16 checksum of the payload
+// Payload: quint8 operation, quint8 variant, quint8 pluginLength, quint8 formatLength,
+//   qint32 mapId, zoom, x, y, version, cost, plugin name, format
+const char journalMagic[4] = { 'Q', 'G', 'C', 'J' };
+const quint32 journalVersion = 1;
+const int journalHeaderSize = 16;
+const int payloadHeaderSize = 28;
+
+// Buffered records are written out once they reach this size, or on flush()
+const int maxBufferSize = 16 * 1024;
+
+}
+
+QGeoTileCacheJournal::QGeoTileCacheJournal(const QString &directory)
+:   m_directory(directory), m_generation(0), m_length(0), m_loaded(false),
+    m_pendingGeneration(0), m_pendingLength(0), m_savedGeneration(0)
+{
+    m_journal.setFileName(QDir(directory).filePath(QStringLiteral("cache.journal")));
+}
+
+QGeoTileCacheJournal::~QGeoTileCacheJournal()
+{
+    flush();
+}
+
+/*
+    Reads the snapshot into \a queues, an array of QueueCount vectors, and the
+    journal records written after it into \a records. Must be called once,
+    before anything is appended.
+*/
+bool QGeoTileCacheJournal::load(QVector<Node> *queues, QVector<Record> *records)
+{
+    for (int i = 0; i < QueueCount; ++i)
+        queues[i].clear();
+    records->clear();
+    m_generation = 0;
+    m_length = 0;
+    m_loaded = true;
+
+    QFile snapshot(QDir(m_directory).filePath(QStringLiteral("cache.state")));
+    if (snapshot.open(QIODevice::ReadOnly)) {
+        const QByteArray data = snapshot.readAll();
+        snapshot.close();
+
+        QDataStream stream(data);
+        stream.setVersion(QDataStream::Qt_5_6);
+        quint32 magic = 0, version = 0;
+        quint64 generation = 0;
+        QVector<QString> plugins, formats;
+        stream >> magic >> version >> generation >> plugins >> formats;
+
+        QVector<QGeoTileSpec> prototypes;
+        for (const QString &plugin : qAsConst(plugins))
+            prototypes.append(QGeoTileSpec(plugin, 0, 0, 0, 0));
+
+        bool ok = magic == snapshotMagic && version == snapshotVersion && stream.status() == QDataStream::Ok;
+        for (int i = 0; i < QueueCount && ok; ++i) {
+            quint32 count = 0;
+            stream >> count;
+            queues[i].reserve(int(qMin<quint32>(count, 1 << 20)));
+            for (quint32 j = 0; j < count && ok; ++j) {
+                quint16 plugin, format;
+                quint8 variant;
+                qint32 mapId, zoom, x, y, tileVersion, cost;
+                quint64 pop;
+                stream >> plugin >> variant >> format >> mapId >> zoom >> x >> y >> tileVersion >> cost >> pop;
+                ok = stream.status() == QDataStream::Ok && plugin < prototypes.size() && format < formats.size();
+                if (!ok)
+                    break;
+
+                Node node;
+                node.spec = prototypes.at(plugin);
+                node.spec.setMapId(mapId);
+                node.spec.setZoom(zoom);
+                node.spec.setX(x);
+                node.spec.setY(y);
+                node.spec.setVersion(tileVersion);
+                node.variant = variant;
+                node.format = formats.at(format);
+                node.cost = cost;
+                node.pop = pop;
+                queues[i].append(node);
+            }
+        }
+
+        if (ok) {
+            m_generation = generation;
+            m_savedGeneration = generation;
+        } else {
+            for (int i = 0; i < QueueCount; ++i)
+                queues[i].clear();
+        }
+    }
+
+    if (!m_journal.open(QIODevice::ReadWrite))
+        return false;
+
+    const QByteArray data = m_journal.readAll();
+    const uchar *header = reinterpret_cast<const uchar *>(data.constData());
+    if (data.size() < journalHeaderSize || memcmp(header, journalMagic, sizeof(journalMagic)) != 0
+            || qFromLittleEndian<quint32>(header + 4) != journalVersion
+            || qFromLittleEndian<quint64>(header + 8) != m_generation) {
+        // Missing, or written for another snapshot
+        m_journal.close();
+        return resetJournal();
+    }
+
+    int pos = journalHeaderSize;
+    while (pos + 2 <= data.size()) {
+        const uchar *record = header + pos;
+        const int length = qFromLittleEndian<quint16>(record);
+        if (length < payloadHeaderSize || pos + 2 + length + 2 > data.size())
+            break;
+        const uchar *payload = record + 2;
+        if (qChecksum(reinterpret_cast<const char *>(payload), uint(length))
+                != qFromLittleEndian<quint16>(payload + length)) {
+            break;
+        }
+        const int pluginLength = payload[2];
+        const int formatLength = payload[3];
+        if (payloadHeaderSize + pluginLength + formatLength != length)
+            break;
+
+        Record r;
+        r.operation = Operation(payload[0]);
+        r.variant = payload[1];
+        r.spec = QGeoTileSpec(QString::fromLatin1(reinterpret_cast<const char *>(payload) + payloadHeaderSize, pluginLength),
+                              qFromLittleEndian<qint32>(payload + 4), qFromLittleEndian<qint32>(payload + 8),
+                              qFromLittleEndian<qint32>(payload + 12), qFromLittleEndian<qint32>(payload + 16),
+                              qFromLittleEndian<qint32>(payload + 20));
+        r.cost = qFromLittleEndian<qint32>(payload + 24);
+        r.format = QString::fromLatin1(reinterpret_cast<const char *>(payload) + payloadHeaderSize + pluginLength,
+                                       formatLength);
+        records->append(r);
+        pos += 2 + length + 2;
+    }
+    m_length = records->size();
+
+    // Cut off a torn record so new ones follow the last valid one
+    if (pos < data.size())
+        m_journal.resize(pos);
+    m_journal.seek(pos);
+    return true;
+}
+
+void QGeoTileCacheJournal::append(Operation operation, const QGeoTileSpec &spec, int variant,
+                                  const QString &format, int cost)
+{
+    if (!m_loaded)
+        return;
+
+    const QByteArray plugin = spec.plugin().toLatin1().left(255);
+    const QByteArray formatName = format.toLatin1().left(255);
+    const int length = payloadHeaderSize + plugin.size() + formatName.size();
+
+    const int start = m_buffer.size();
+    m_buffer.resize(start + 2 + length + 2);
+    uchar *record = reinterpret_cast<uchar *>(m_buffer.data()) + start;
+    qToLittleEndian<quint16>(quint16(length), record);
+    uchar *payload = record + 2;
+    payload[0] = quint8(operation);
+    payload[1] = quint8(variant);
+    payload[2] = quint8(plugin.size());
+    payload[3] = quint8(formatName.size());
+    qToLittleEndian<qint32>(spec.mapId(), payload + 4);
+    qToLittleEndian<qint32>(spec.zoom(), payload + 8);
+    qToLittleEndian<qint32>(spec.x(), payload + 12);
+    qToLittleEndian<qint32>(spec.y(), payload + 16);
+    qToLittleEndian<qint32>(spec.version(), payload + 20);
+    qToLittleEndian<qint32>(cost, payload + 24);
+    memcpy(payload + payloadHeaderSize, plugin.constData(), size_t(plugin.size()));
+    memcpy(payload + payloadHeaderSize + plugin.size(), formatName.constData(), size_t(formatName.size()));
+    qToLittleEndian<quint16>(qChecksum(reinterpret_cast<const char *>(payload), uint(length)), payload + length);
+
+    if (m_pendingGeneration) {
+        m_pendingBuffer.append(m_buffer.constData() + start, m_buffer.size() - start);
+        ++m_pendingLength;
+    }
+
+    ++m_length;
+    if (m_buffer.size() >= maxBufferSize)
+        flush();
+}
+
+void QGeoTileCacheJournal::flush()
+{
+    if (m_buffer.isEmpty() || !m_journal.isOpen())
+        return;
+    m_journal.write(m_buffer);
+    m_journal.flush();
+    m_buffer.clear();
+}
+
+int QGeoTileCacheJournal::length() const
+{
+    return m_length;
+}
+
+/*
+    Replaces the snapshot with \a queues, an array of QueueCount vectors, and
+    starts an empty journal for it. A snapshot still being written in the
+    background is superseded.
+*/
+bool QGeoTileCacheJournal::writeSnapshot(const QVector<Node> *queues)
+{
+    const quint64 generation = qMax(m_generation, m_pendingGeneration) + 1;
+    m_pendingGeneration = 0;
+    m_pendingBuffer.clear();
+    m_pendingLength = 0;
+    if (!saveSnapshot(generation, queues))
+        return false;
+
+    // The buffered records are part of the snapshot now
+    m_generation = generation;
+    m_buffer.clear();
+    m_length = 0;
+    m_loaded = true;
+    return resetJournal();
+}
+
+/*
+    Starts a snapshot of the current state, to be written by saveSnapshot().
+    Returns its generation, or 0 if another one is still being written.
+*/
+quint64 QGeoTileCacheJournal::beginSnapshot()
+{
+    if (m_pendingGeneration || !m_loaded)
+        return 0;
+    m_pendingGeneration = m_generation + 1;
+    return m_pendingGeneration;
+}
+
+/*
+    Writes the snapshot file for \a generation from \a queues, an array of
+    QueueCount vectors. Can be called from any thread; does nothing and
+    returns false if a newer generation got written already.
+*/
+bool QGeoTileCacheJournal::saveSnapshot(quint64 generation, const QVector<Node> *queues)
+{
+    QMutexLocker locker(&m_snapshotLock);
+    if (generation <= m_savedGeneration)
+        return false;
+
+    QSaveFile file(QDir(m_directory).filePath(QStringLiteral("cache.state")));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QHash<int, quint16> pluginIndex;
+    QVector<QString> plugins;
+    QHash<QString, quint16> formatIndex;
+    QVector<QString> formats;
+    for (int i = 0; i < QueueCount; ++i) {
+        for (const Node &node : queues[i]) {
+            if (!pluginIndex.contains(node.spec.pluginId())) {
+                pluginIndex.insert(node.spec.pluginId(), quint16(plugins.size()));
+                plugins.append(node.spec.plugin());
+            }
+            if (!formatIndex.contains(node.format)) {
+                formatIndex.insert(node.format, quint16(formats.size()));
+                formats.append(node.format);
+            }
+        }
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << snapshotMagic << snapshotVersion << generation << plugins << formats;
+    for (int i = 0; i < QueueCount; ++i) {
+        stream << quint32(queues[i].size());
+        for (const Node &node : queues[i]) {
+            stream << pluginIndex.value(node.spec.pluginId()) << quint8(node.variant)
+                   << formatIndex.value(node.format)
+                   << qint32(node.spec.mapId()) << qint32(node.spec.zoom())
+                   << qint32(node.spec.x()) << qint32(node.spec.y()) << qint32(node.spec.version())
+                   << qint32(node.cost) << node.pop;
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit())
+        return false;
+    m_savedGeneration = generation;
+    return true;
+}
+
+/*
+    Switches to a new journal for the snapshot started with \a generation if
+    it was \a saved, holding the records appended since it was started.
+*/
+void QGeoTileCacheJournal::endSnapshot(quint64 generation, bool saved)
+{
+    if (generation != m_pendingGeneration)
+        return;
+
+    if (saved) {
+        m_generation = generation;
+        m_buffer = m_pendingBuffer;
+        m_length = m_pendingLength;
+        resetJournal();
+        flush();
+    }
+    m_pendingGeneration = 0;
+    m_pendingBuffer.clear();
+    m_pendingLength = 0;
+}
+
+void QGeoTileCacheJournal::clear()
+{
+    writeSnapshot(QVector<QVector<Node> >(QueueCount).constData());
+}
+
+bool QGeoTileCacheJournal::resetJournal()
+{
+    m_journal.close();
+    if (!m_journal.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    uchar header[journalHeaderSize];
+    memcpy(header, journalMagic, sizeof(journalMagic));
+    qToLittleEndian<quint32>(journalVersion, header + 4);
+    qToLittleEndian<quint64>(m_generation, header + 8);
+    const bool ok = m_journal.write(reinterpret_cast<const char *>(header), journalHeaderSize) == journalHeaderSize;
+    m_journal.flush();
+    return ok;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILECACHEJOURNAL_P_H
+#define QGEOTILECACHEJOURNAL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "qgeotilespec_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Persists the state of the disk tile cache across restarts.
+
+    The snapshot holds the queues of the 3Q cache in order, with the cost and
+    popularity of every node. Between snapshots, the operations applied to
+    the cache are appended to a journal. Replaying them on top of the snapshot
+    gives back the state the cache had when it was last flushed.
+
+    Both files are read in one go. The snapshot is replaced atomically and
+    the journal names the snapshot generation it belongs to; every journal
+    record carries a checksum, so a torn tail is simply dropped.
+
+    A snapshot can also be written from another thread: beginSnapshot() on
+    the owning thread, saveSnapshot() anywhere, then endSnapshot() back on
+    the owning thread. Records appended in between stay in the old journal
+    and are moved to the new one once the snapshot is in place.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileCacheJournal
+{
+public:
+    enum { QueueCount = 4 };
+
+    enum Operation {
+        Insert = 1,
+        Touch = 2,
+        Remove = 3
+    };
+
+    struct Node
+    {
+        QGeoTileSpec spec;
+        int variant;
+        QString format;
+        int cost;
+        quint64 pop;
+    };
+
+    struct Record
+    {
+        Operation operation;
+        QGeoTileSpec spec;
+        int variant;
+        QString format;
+        int cost;
+    };
+
+    explicit QGeoTileCacheJournal(const QString &directory);
+    ~QGeoTileCacheJournal();
+
+    bool load(QVector<Node> *queues, QVector<Record> *records);
+
+    void append(Operation operation, const QGeoTileSpec &spec, int variant = 0,
+                const QString &format = QString(), int cost = 0);
+    void flush();
+    int length() const;
+
+    bool writeSnapshot(const QVector<Node> *queues);
+    void clear();
+
+    quint64 beginSnapshot();
+    bool saveSnapshot(quint64 generation, const QVector<Node> *queues);
+    void endSnapshot(quint64 generation, bool saved);
+
+private:
+    bool resetJournal();
+
+    QString m_directory;
+    QFile m_journal;
+    QByteArray m_buffer;
+    quint64 m_generation;
+    int m_length;
+    bool m_loaded;
+
+    // Snapshot written in the background, if any, and the records appended since
+    quint64 m_pendingGeneration;
+    QByteArray m_pendingBuffer;
+    int m_pendingLength;
+
+    QMutex m_snapshotLock;
+    quint64 m_savedGeneration; // guarded by m_snapshotLock
+
+    Q_DISABLE_COPY(QGeoTileCacheJournal)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILECACHEJOURNAL_P_H
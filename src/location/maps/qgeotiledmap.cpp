@@ -112,12 +112,45 @@ void QGeoTiledMap::updateTile(const QGeoTileSpec &spec)
     d->updateTile(spec);
 }
 
+/*
+    Returns the fetch priorities of \a tiles for this map; lower values are fetched first.
+*/
+QHash<QGeoTileSpec, int> QGeoTiledMap::tilePriorities(const QSet<QGeoTileSpec> &tiles)
+{
+    Q_D(QGeoTiledMap);
+    return d->tilePriorities(tiles);
+}
+
 void QGeoTiledMap::setPrefetchStyle(QGeoTiledMap::PrefetchStyle style)
 {
     Q_D(QGeoTiledMap);
     d->m_prefetchStyle = style;
 }
 
+void QGeoTiledMap::setTileAtlasEnabled(bool enabled)
+{
+    Q_D(QGeoTiledMap);
+    d->m_mapScene->setTileAtlasEnabled(enabled);
+    emit sgNodeChanged();
+}
+
+/*
+    Sets how much the tiles far from a tilted camera may be magnified before
+    tiles of the camera's zoom level are used, 0 disabling the level of
+    detail, which is the default. Applies to the prefetched tiles too.
+*/
+void QGeoTiledMap::setDetailThreshold(double threshold)
+{
+    Q_D(QGeoTiledMap);
+    if (threshold == d->m_visibleTiles->detailThreshold())
+        return;
+
+    d->m_visibleTiles->setDetailThreshold(threshold);
+    d->m_prefetchTiles->setDetailThreshold(threshold);
+    d->updateScene();
+    emit sgNodeChanged();
+}
+
 QAbstractGeoTileCache *QGeoTiledMap::tileCache()
 {
     Q_D(QGeoTiledMap);
@@ -203,6 +236,8 @@ QGeoTiledMapPrivate::QGeoTiledMapPrivate(QGeoTiledMappingManagerEngine *engine)
     m_prefetchTiles->setTileSize(tileSize);
     m_visibleTiles->setPluginString(pluginString);
     m_prefetchTiles->setPluginString(pluginString);
+    m_visibleTiles->setMinimumZoomLevel(m_minZoomLevel);
+    m_prefetchTiles->setMinimumZoomLevel(m_minZoomLevel);
     m_mapScene->setTileSize(tileSize);
 }
 
@@ -270,7 +305,8 @@ void QGeoTiledMapPrivate::prefetchTiles()
             break;
         }
 
-        m_tileRequests->requestTiles(tiles - m_mapScene->texturedTiles());
+        // Prefetched tiles are not shown, they need no placeholders
+        m_tileRequests->requestTiles(tiles - m_mapScene->texturedTiles(), false);
     }
 }
 
@@ -283,8 +319,11 @@ QGeoMapType QGeoTiledMapPrivate::activeMapType()
 void QGeoTiledMapPrivate::onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities)
 {
     // Handle varying min/maxZoomLevel
-    if (oldCameraCapabilities.minimumZoomLevel() != m_cameraCapabilities.minimumZoomLevel())
+    if (oldCameraCapabilities.minimumZoomLevel() != m_cameraCapabilities.minimumZoomLevel()) {
         m_minZoomLevel = static_cast<int>(std::ceil(m_cameraCapabilities.minimumZoomLevel()));
+        m_visibleTiles->setMinimumZoomLevel(m_minZoomLevel);
+        m_prefetchTiles->setMinimumZoomLevel(m_minZoomLevel);
+    }
     if (oldCameraCapabilities.maximumZoomLevel() != m_cameraCapabilities.maximumZoomLevel())
         m_maxZoomLevel = static_cast<int>(std::ceil(m_cameraCapabilities.maximumZoomLevel()));
 
@@ -445,6 +484,44 @@ void QGeoTiledMapPrivate::updateTile(const QGeoTileSpec &spec)
     }
 }
 
+QHash<QGeoTileSpec, int> QGeoTiledMapPrivate::tilePriorities(const QSet<QGeoTileSpec> &tiles)
+{
+    // Visible tiles come first, closest to the center of the viewport first,
+    // then prefetched tiles, the ones on the current zoom level before the
+    // neighbour layers.
+    static const int prefetchBand = 1 << 20;
+    static const int layerStep = 1 << 16;
+
+    QHash<QGeoTileSpec, int> priorities;
+    if (tiles.isEmpty())
+        return priorities;
+    priorities.reserve(tiles.size());
+
+    const QGeoCameraData camera = m_visibleTiles->cameraData();
+    const QDoubleVector2D center = QWebMercator::coordToMercator(camera.center());
+    const int zoom = int(std::floor(camera.zoomLevel()));
+    const QSet<QGeoTileSpec> &visible = m_visibleTiles->createTiles();
+
+    for (const QGeoTileSpec &spec : tiles) {
+        const int side = 1 << spec.zoom();
+        double dx = spec.x() + 0.5 - center.x() * side;
+        if (dx > side / 2.0)
+            dx -= side;
+        else if (dx < -side / 2.0)
+            dx += side;
+        const double dy = spec.y() + 0.5 - center.y() * side;
+        const int distance = int(qMin(dx * dx + dy * dy, double(layerStep - 1)));
+
+        if (visible.contains(spec)) {
+            priorities.insert(spec, distance);
+        } else {
+            const int layer = qAbs(spec.zoom() - zoom);
+            priorities.insert(spec, prefetchBand + qMin(layer, 8) * layerStep + distance);
+        }
+    }
+    return priorities;
+}
+
 QSGNode *QGeoTiledMapPrivate::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
 {
     return m_mapScene->updateSceneGraph(oldNode, window);
@@ -82,7 +82,10 @@ public:
     QAbstractGeoTileCache *tileCache();
     QGeoTileRequestManager *requestManager();
     void updateTile(const QGeoTileSpec &spec);
+    QHash<QGeoTileSpec, int> tilePriorities(const QSet<QGeoTileSpec> &tiles);
     void setPrefetchStyle(PrefetchStyle style);
+    void setTileAtlasEnabled(bool enabled);
+    void setDetailThreshold(double threshold);
 
     void prefetchData() override;
     void clearData() override;
@@ -78,6 +78,7 @@ public:
     QSGNode *updateSceneGraph(QSGNode *node, QQuickWindow *window);
 
     void updateTile(const QGeoTileSpec &spec);
+    QHash<QGeoTileSpec, int> tilePriorities(const QSet<QGeoTileSpec> &tiles);
     void prefetchTiles();
     QGeoMapType activeMapType();
     void onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities);
@@ -124,6 +124,14 @@ void QGeoTiledMappingManagerEngine::releaseMap(QGeoTiledMap *map)
         }
     }
     d_ptr->tileHash_ = newTileHash;
+
+    for (auto it = d_ptr->decodeHash_.begin(); it != d_ptr->decodeHash_.end(); ) {
+        it.value().remove(map);
+        if (it.value().isEmpty())
+            it = d_ptr->decodeHash_.erase(it);
+        else
+            ++it;
+    }
 }
 
 void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
@@ -181,10 +189,28 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
 
     cancelTiles -= reqTiles;
 
-    QMetaObject::invokeMethod(d->fetcher_, "updateTileRequests",
-                              Qt::QueuedConnection,
-                              Q_ARG(QSet<QGeoTileSpec>, reqTiles),
-                              Q_ARG(QSet<QGeoTileSpec>, cancelTiles));
+    // tiles that were waiting for a background decode
+    QSet<QGeoTileSpec> cancelDecodes;
+    for (rem = tilesRemoved.constBegin(); rem != remEnd; ++rem) {
+        auto it = d->decodeHash_.find(*rem);
+        if (it == d->decodeHash_.end())
+            continue;
+        it.value().remove(map);
+        if (it.value().isEmpty()) {
+            d->decodeHash_.erase(it);
+            cancelDecodes.insert(*rem);
+        }
+    }
+    if (!cancelDecodes.isEmpty())
+        tileCache()->cancelDecoding(cancelDecodes);
+
+    // already queued tiles are reprioritized for the map that asked for them last
+    const QHash<QGeoTileSpec, int> priorities = map->tilePriorities(tilesAdded);
+
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    QMetaObject::invokeMethod(fetcher, [fetcher, reqTiles, cancelTiles, priorities]() {
+        fetcher->updateTileRequests(reqTiles, cancelTiles, priorities);
+    }, Qt::QueuedConnection);
 }
 
 void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format)
@@ -242,6 +268,27 @@ void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, co
     emit tileError(spec, errorString);
 }
 
+void QGeoTiledMappingManagerEngine::engineTileDecoded(const QGeoTileSpec &spec)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    const QSet<QGeoTiledMap *> maps = d->decodeHash_.take(spec);
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileFetched(spec);
+}
+
+void QGeoTiledMappingManagerEngine::engineTileDecodingFailed(const QGeoTileSpec &spec, const QString &errorString)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    Q_UNUSED(errorString);
+
+    // The cached copy is unusable, go through the fetcher instead
+    const QSet<QGeoTiledMap *> maps = d->decodeHash_.take(spec);
+    const QSet<QGeoTileSpec> tiles { spec };
+    for (QGeoTiledMap *map : maps)
+        updateTileRequests(map, tiles, QSet<QGeoTileSpec>());
+}
+
 void QGeoTiledMappingManagerEngine::setTileSize(const QSize &tileSize)
 {
     Q_D(QGeoTiledMappingManagerEngine);
@@ -291,6 +338,10 @@ void QGeoTiledMappingManagerEngine::setTileCache(QAbstractGeoTileCache *cache)
     cache->setParent(this);
     d->tileCache_ = cache;
     d->tileCache_->init();
+    connect(d->tileCache_, &QAbstractGeoTileCache::tileDecoded,
+            this, &QGeoTiledMappingManagerEngine::engineTileDecoded);
+    connect(d->tileCache_, &QAbstractGeoTileCache::tileDecodingFailed,
+            this, &QGeoTiledMappingManagerEngine::engineTileDecodingFailed);
 }
 
 QAbstractGeoTileCache *QGeoTiledMappingManagerEngine::tileCache()
@@ -302,6 +353,10 @@ QAbstractGeoTileCache *QGeoTiledMappingManagerEngine::tileCache()
             cacheDirectory = QAbstractGeoTileCache::baseLocationCacheDirectory() + managerName();
         d->tileCache_ = new QGeoFileTileCache(cacheDirectory);
         d->tileCache_->init();
+        connect(d->tileCache_, &QAbstractGeoTileCache::tileDecoded,
+                this, &QGeoTiledMappingManagerEngine::engineTileDecoded);
+        connect(d->tileCache_, &QAbstractGeoTileCache::tileDecodingFailed,
+                this, &QGeoTiledMappingManagerEngine::engineTileDecodingFailed);
     }
     return d->tileCache_;
 }
@@ -311,6 +366,30 @@ QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::getTileTexture(co
     return d_ptr->tileCache_->get(spec);
 }
 
+/*
+    Like getTileTexture(), but lets the cache decode the tile in the background.
+    When \a pending is set to true, \a map is notified through its request manager
+    once the texture is ready. A null \a pending only returns decoded textures.
+*/
+QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::requestTileTexture(QGeoTiledMap *map, const QGeoTileSpec &spec, bool *pending)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    QSharedPointer<QGeoTileTexture> tex = d->tileCache_->requestTexture(spec, pending);
+    if (pending && *pending)
+        d->decodeHash_[spec].insert(map);
+    return tex;
+}
+
+/*
+    Returns a texture from the cache that can be shown in place of \a spec
+    until the tile itself is available. Never blocks on the disk.
+*/
+QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::placeholderTileTexture(const QGeoTileSpec &spec)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    return d->tileCache_->placeholderTexture(spec);
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
@@ -88,12 +88,16 @@ public:
 
     QAbstractGeoTileCache *tileCache();
     virtual QSharedPointer<QGeoTileTexture> getTileTexture(const QGeoTileSpec &spec);
+    QSharedPointer<QGeoTileTexture> requestTileTexture(QGeoTiledMap *map, const QGeoTileSpec &spec, bool *pending);
+    QSharedPointer<QGeoTileTexture> placeholderTileTexture(const QGeoTileSpec &spec);
 
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
 
 protected Q_SLOTS:
     virtual void engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
     virtual void engineTileError(const QGeoTileSpec &spec, const QString &errorString);
+    virtual void engineTileDecoded(const QGeoTileSpec &spec);
+    virtual void engineTileDecodingFailed(const QGeoTileSpec &spec, const QString &errorString);
 
 Q_SIGNALS:
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
@@ -71,6 +71,7 @@ public:
     int m_tileVersion;
     QHash<QGeoTiledMap *, QSet<QGeoTileSpec> > mapHash_;
     QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > tileHash_;
+    QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > decodeHash_;
     QAbstractGeoTileCache::CacheAreas cacheHint_;
     QAbstractGeoTileCache *tileCache_;
     QGeoTileFetcher *fetcher_;
@@ -44,7 +44,10 @@
 #include <QtCore/private/qobject_p.h>
 #include <QtQuick/QQuickWindow>
 #include <QtGui/QVector3D>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iterator>
 #include <QtPositioning/private/qlocationutils_p.h>
 #include <QtPositioning/private/qdoublematrix4x4_p.h>
 #include <QtPositioning/private/qwebmercator_p.h>
@@ -74,7 +77,10 @@ void QGeoTiledMapScene::setScreenSize(const QSize &size)
 void QGeoTiledMapScene::updateSceneParameters()
 {
     Q_D(QGeoTiledMapScene);
+    const int intZoomLevel = d->m_intZoomLevel;
     d->m_intZoomLevel = static_cast<int>(std::floor(d->m_cameraData.zoomLevel()));
+    if (d->m_intZoomLevel != intZoomLevel)
+        d->m_geometryChanged = true;
     const float delta = d->m_cameraData.zoomLevel() - d->m_intZoomLevel;
     d->m_linearScaling = qAbs(delta) > 0.05 || d->isTiltedOrRotated();
     d->m_sideLength = 1 << d->m_intZoomLevel;
@@ -88,6 +94,7 @@ void QGeoTiledMapScene::setTileSize(int tileSize)
         return;
 
     d->m_tileSize = tileSize;
+    d->m_geometryChanged = true;
     updateSceneParameters();
 }
 
@@ -142,6 +149,23 @@ void QGeoTiledMapScene::clearTexturedTiles()
     d->m_dropTextures = true;
 }
 
+/*
+    In atlas mode tile images are packed into a few large textures, and all
+    tiles sharing one are drawn as a single geometry node. This needs OpenGL;
+    other graphics backends keep using one image node per tile.
+*/
+void QGeoTiledMapScene::setTileAtlasEnabled(bool enabled)
+{
+    Q_D(QGeoTiledMapScene);
+    d->m_tileAtlas = enabled;
+}
+
+bool QGeoTiledMapScene::tileAtlasEnabled() const
+{
+    Q_D(const QGeoTiledMapScene);
+    return d->m_tileAtlas;
+}
+
 QGeoTiledMapScenePrivate::QGeoTiledMapScenePrivate()
     : QObjectPrivate(),
       m_tileSize(0),
@@ -158,7 +182,9 @@ QGeoTiledMapScenePrivate::QGeoTiledMapScenePrivate()
       m_maxTileY(-1),
       m_tileXWrapsBelow(0),
       m_linearScaling(false),
-      m_dropTextures(false)
+      m_dropTextures(false),
+      m_tileAtlas(false),
+      m_geometryChanged(true)
 {
 }
 
@@ -167,36 +193,61 @@ QGeoTiledMapScenePrivate::~QGeoTiledMapScenePrivate()
 }
 
 bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming)
+{
+    QRectF rect;
+    QRectF sourceRect;
+    if (!buildGeometry(spec, imageNode->texture()->textureSize(), rect, sourceRect, overzooming))
+        return false;
+
+    imageNode->setRect(rect);
+    imageNode->setTextureCoordinatesTransform(QSGImageNode::MirrorVertically);
+    imageNode->setSourceRect(sourceRect);
+    return true;
+}
+
+/*
+    Computes the rectangle \a spec covers in the scene and the part of its
+    texture, of \a textureSize pixels, to be drawn there. The texture is
+    meant to be mirrored vertically.
+*/
+bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, const QSize &textureSize,
+                                             QRectF &rect, QRectF &sourceRect, bool &overzooming)
 {
     overzooming = false;
-    int x = spec.x();
+
+    // Tiles of lower zoom levels come from the level of detail of tilted
+    // views and cover several tiles of the camera's zoom level
+    const int shift = m_intZoomLevel - spec.zoom();
+    if (shift < 0)
+        return false;
+    const int size = 1 << shift;
+    int x = spec.x() << shift;
+    const int y = spec.y() << shift;
 
     if (x < m_tileXWrapsBelow)
         x += m_sideLength;
 
     if ((x < m_minTileX)
-            || (m_maxTileX < x)
-            || (spec.y() < m_minTileY)
-            || (m_maxTileY < spec.y())
-            || (spec.zoom() != m_intZoomLevel)) {
+            || (m_maxTileX < x + size - 1)
+            || (y < m_minTileY)
+            || (m_maxTileY < y + size - 1)) {
         return false;
     }
 
     double edge = m_scaleFactor * m_tileSize;
 
     double x1 = (x - m_minTileX);
-    double x2 = x1 + 1.0;
+    double x2 = x1 + size;
 
-    double y1 = (m_minTileY - spec.y());
-    double y2 = y1 - 1.0;
+    double y1 = (m_minTileY - y);
+    double y2 = y1 - size;
 
     x1 *= edge;
     x2 *= edge;
     y1 *= edge;
     y2 *= edge;
 
-    imageNode->setRect(QRectF(QPointF(x1, y2), QPointF(x2, y1)));
-    imageNode->setTextureCoordinatesTransform(QSGImageNode::MirrorVertically);
+    rect = QRectF(QPointF(x1, y2), QPointF(x2, y1));
 
     // Calculate the texture mapping, in case we are magnifying some lower ZL tile
     const auto it = m_textures.find(spec); // This should be always found, but apparently sometimes it isn't, possibly due to memory shortage
@@ -204,17 +255,17 @@ bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageN
         if (it.value()->spec.zoom() < spec.zoom()) {
             // Currently only using lower ZL tiles for the overzoom.
             const int tilesPerTexture = 1 << (spec.zoom() - it.value()->spec.zoom());
-            const int mappedSize = imageNode->texture()->textureSize().width() / tilesPerTexture;
+            const int mappedSize = textureSize.width() / tilesPerTexture;
             const int x = (spec.x() % tilesPerTexture) * mappedSize;
             const int y = (spec.y() % tilesPerTexture) * mappedSize;
-            imageNode->setSourceRect(QRectF(x, y, mappedSize, mappedSize));
+            sourceRect = QRectF(x, y, mappedSize, mappedSize);
             overzooming = true;
         } else {
-            imageNode->setSourceRect(QRectF(QPointF(0,0), imageNode->texture()->textureSize()));
+            sourceRect = QRectF(QPointF(0,0), textureSize);
         }
     } else {
         qWarning() << "!! buildGeometry: tileSpec not present in m_textures !!";
-        imageNode->setSourceRect(QRectF(QPointF(0,0), imageNode->texture()->textureSize()));
+        sourceRect = QRectF(QPointF(0,0), textureSize);
     }
 
     return true;
@@ -228,20 +279,39 @@ void QGeoTiledMapScenePrivate::addTile(const QGeoTileSpec &spec, QSharedPointer<
     if (m_textures.contains(spec))
         m_updatedTextures.append(spec);
     m_textures.insert(spec, texture);
+    m_changedTiles.insert(spec);
 }
 
 void QGeoTiledMapScenePrivate::setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles)
 {
     // work out the tile bounds for the new scene
+    const int oldBounds[] = { m_minTileX, m_minTileY, m_maxTileX, m_maxTileY, m_tileXWrapsBelow };
     updateTileBounds(visibleTiles);
+    const int newBounds[] = { m_minTileX, m_minTileY, m_maxTileX, m_maxTileY, m_tileXWrapsBelow };
+    if (!std::equal(std::begin(oldBounds), std::end(oldBounds), std::begin(newBounds)))
+        m_geometryChanged = true;
 
     // set up the gl camera for the new scene
     setupCamera();
 
-    QSet<QGeoTileSpec> toRemove = m_visibleTiles - visibleTiles;
+    if (visibleTiles == m_visibleTiles)
+        return;
+
+    QSet<QGeoTileSpec> toRemove;
+    for (const QGeoTileSpec &tile : qAsConst(m_visibleTiles)) {
+        if (!visibleTiles.contains(tile))
+            toRemove.insert(tile);
+    }
     if (!toRemove.isEmpty())
         removeTiles(toRemove);
 
+    // A tile removed and added back before the next update stays in
+    // m_removedTiles, so its old node and texture are dropped first
+    for (const QGeoTileSpec &tile : visibleTiles) {
+        if (!m_visibleTiles.contains(tile))
+            m_changedTiles.insert(tile);
+    }
+
     m_visibleTiles = visibleTiles;
 }
 
@@ -254,18 +324,23 @@ void QGeoTiledMapScenePrivate::removeTiles(const QSet<QGeoTileSpec> &oldTiles)
     for (; i != end; ++i) {
         QGeoTileSpec tile = *i;
         m_textures.remove(tile);
+        m_changedTiles.remove(tile);
+        m_removedTiles.insert(tile);
     }
 }
 
+/*
+    Tiles of lower zoom levels, from the level of detail of tilted views,
+    count with the range of tiles of the camera's zoom level they cover.
+*/
 void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
 {
-    if (tiles.isEmpty()) {
-        m_minTileX = -1;
-        m_minTileY = -1;
-        m_maxTileX = -1;
-        m_maxTileY = -1;
+    m_minTileX = -1;
+    m_minTileY = -1;
+    m_maxTileX = -1;
+    m_maxTileY = -1;
+    if (tiles.isEmpty())
         return;
-    }
 
     typedef QSet<QGeoTileSpec>::const_iterator iter;
     iter i = tiles.constBegin();
@@ -279,8 +354,18 @@ void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
     bool hasMidRight = false;
 
     for (; i != end; ++i) {
-        if ((*i).zoom() != m_intZoomLevel)
+        const int shift = m_intZoomLevel - (*i).zoom();
+        if (shift < 0)
             continue;
+        if (shift > 0) {
+            const int minX = (*i).x() << shift;
+            const int maxX = minX + (1 << shift) - 1;
+            hasFarLeft |= minX == 0;
+            hasFarRight |= maxX == m_sideLength - 1;
+            hasMidLeft |= minX <= (m_sideLength / 2) - 1 && (m_sideLength / 2) - 1 <= maxX;
+            hasMidRight |= minX <= m_sideLength / 2 && m_sideLength / 2 <= maxX;
+            continue;
+        }
         int x = (*i).x();
         if (x == 0)
             hasFarLeft = true;
@@ -305,35 +390,33 @@ void QGeoTiledMapScenePrivate::updateTileBounds(const QSet<QGeoTileSpec> &tiles)
         }
     }
 
-    // finally, determine the min and max bounds
-    i = tiles.constBegin();
-
-    QGeoTileSpec tile = *i;
-
-    int x = tile.x();
-    if (tile.x() < m_tileXWrapsBelow)
-        x += m_sideLength;
-
-    m_minTileX = x;
-    m_maxTileX = x;
-    m_minTileY = tile.y();
-    m_maxTileY = tile.y();
-
-    ++i;
-
-    for (; i != end; ++i) {
-        tile = *i;
-        if (tile.zoom() != m_intZoomLevel)
+    // finally, determine the min and max bounds. A tile of a lower zoom
+    // level never straddles the wrap point, it would have been a mid tile.
+    bool first = true;
+    for (i = tiles.constBegin(); i != end; ++i) {
+        const QGeoTileSpec &tile = *i;
+        const int shift = m_intZoomLevel - tile.zoom();
+        if (shift < 0)
             continue;
 
-        int x = tile.x();
-        if (tile.x() < m_tileXWrapsBelow)
+        int x = tile.x() << shift;
+        if (x < m_tileXWrapsBelow)
             x += m_sideLength;
-
+        const int y = tile.y() << shift;
+        const int last = (1 << shift) - 1;
+
+        if (first) {
+            m_minTileX = x;
+            m_maxTileX = x + last;
+            m_minTileY = y;
+            m_maxTileY = y + last;
+            first = false;
+            continue;
+        }
         m_minTileX = qMin(m_minTileX, x);
-        m_maxTileX = qMax(m_maxTileX, x);
-        m_minTileY = qMin(m_minTileY, tile.y());
-        m_maxTileY = qMax(m_maxTileY, tile.y());
+        m_maxTileX = qMax(m_maxTileX, x + last);
+        m_minTileY = qMin(m_minTileY, y);
+        m_maxTileY = qMax(m_maxTileY, y + last);
     }
 }
 
@@ -480,11 +563,35 @@ static bool qgeotiledmapscene_isTileInViewport(const QRectF &tileRect, const QMa
     return qgeotiledmapscene_isTileInViewport_rotationTilt(tileRect, matrix);
 }
 
+static void qgeotiledmapscene_setTileFiltering(QSGImageNode *node, QGeoTiledMapScenePrivate *d,
+                                               bool overzooming, qreal pixelRatio, bool ogl)
+{
+    if (node->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
+        node->setFiltering(QSGTexture::Linear); // With mipmapping QSGTexture::Nearest generates artifacts
+        node->setMipmapFiltering(QSGTexture::Linear);
+    } else {
+        node->setFiltering((d->m_linearScaling || overzooming) ? QSGTexture::Linear : QSGTexture::Nearest);
+    }
+#if QT_CONFIG(opengl)
+    if (ogl)
+        static_cast<QSGDefaultImageNode *>(node)->setAnisotropyLevel(QSGTexture::Anisotropy16x);
+#else
+    Q_UNUSED(ogl)
+#endif
+}
+
+/*
+    Brings the nodes of \a root up to date. Unless \a fullUpdate is set or
+    the camera matrix changed, only \a changedTiles are looked at: the
+    geometry and the culling of all other nodes are still valid.
+*/
 void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
                                        QGeoTiledMapScenePrivate *d,
                                        double camAdjust,
                                        QQuickWindow *window,
-                                       bool ogl)
+                                       bool ogl,
+                                       const QSet<QGeoTileSpec> &changedTiles,
+                                       bool fullUpdate)
 {
     // Set up the matrix...
     QDoubleVector3D eye = d->m_cameraEye;
@@ -493,86 +600,233 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
     center.setX(center.x() + camAdjust);
     QMatrix4x4 cameraMatrix;
     cameraMatrix.lookAt(toVector3D(eye), toVector3D(center), toVector3D(d->m_cameraUp));
-    root->setMatrix(d->m_projectionMatrix * cameraMatrix);
-
-    const QSet<QGeoTileSpec> tilesInSG = QSet<QGeoTileSpec>::fromList(root->tiles.keys());
-    const QSet<QGeoTileSpec> toRemove = tilesInSG - d->m_visibleTiles;
-    const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - tilesInSG;
+    const QMatrix4x4 matrix = d->m_projectionMatrix * cameraMatrix;
+    if (matrix != root->matrix()) {
+        root->setMatrix(matrix);
+        fullUpdate = true;
+    }
 
-    for (const QGeoTileSpec &s : toRemove)
-        delete root->tiles.take(s);
-    bool straight = !d->isTiltedOrRotated();
-    bool overzooming;
-    qreal pixelRatio = window->effectiveDevicePixelRatio();
+    const bool straight = !d->isTiltedOrRotated();
+    const qreal pixelRatio = window->effectiveDevicePixelRatio();
 #ifdef QT_LOCATION_DEBUG
     QList<QGeoTileSpec> droppedTiles;
 #endif
-    for (QHash<QGeoTileSpec, QSGImageNode *>::iterator it = root->tiles.begin();
-         it != root->tiles.end(); ) {
-        QSGImageNode *node = it.value();
-        bool ok = d->buildGeometry(it.key(), node, overzooming)
-                && qgeotiledmapscene_isTileInViewport(node->rect(), root->matrix(), straight);
 
-        QSGNode::DirtyState dirtyBits = 0;
+    const QSet<QGeoTileSpec> &tiles = fullUpdate ? d->m_visibleTiles : changedTiles;
+    for (const QGeoTileSpec &s : tiles) {
+        QSGImageNode *node = root->tiles.value(s);
+        const bool added = !node;
+        if (added) {
+            QSGTexture *texture = textures.value(s);
+            if (!texture) {
+#ifdef QT_LOCATION_DEBUG
+                droppedTiles.append(s);
+#endif
+                continue;
+            }
+            node = window->createImageNode();
+            // note: setTexture will update coordinates so do it here, before we buildGeometry
+            node->setTexture(texture);
+        }
 
-        if (!ok) {
+        bool overzooming;
+        if (!d->buildGeometry(s, node, overzooming)
+                || !qgeotiledmapscene_isTileInViewport(node->rect(), root->matrix(), straight)) {
 #ifdef QT_LOCATION_DEBUG
-            droppedTiles.append(it.key());
+            droppedTiles.append(s);
 #endif
-            it = root->tiles.erase(it);
+            if (!added)
+                root->tiles.remove(s);
             delete node;
-        } else {
-            if (isTextureLinear != d->m_linearScaling) {
-                if (node->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
-                    node->setFiltering(QSGTexture::Linear); // With mipmapping QSGTexture::Nearest generates artifacts
-                    node->setMipmapFiltering(QSGTexture::Linear);
-                } else {
-                    node->setFiltering((d->m_linearScaling || overzooming) ? QSGTexture::Linear : QSGTexture::Nearest);
-                }
-#if QT_CONFIG(opengl)
-                if (ogl)
-                    static_cast<QSGDefaultImageNode *>(node)->setAnisotropyLevel(QSGTexture::Anisotropy16x);
-#else
-    Q_UNUSED(ogl)
+            continue;
+        }
+
+        if (added) {
+            qgeotiledmapscene_setTileFiltering(node, d, overzooming, pixelRatio, ogl);
+            root->addChild(s, node);
+        } else if (filteringChanged) { // the scaling mode or the pixel ratio
+            qgeotiledmapscene_setTileFiltering(node, d, overzooming, pixelRatio, ogl);
+            node->markDirty(QSGNode::DirtyMaterial);
+        }
+    }
+
+#ifdef QT_LOCATION_DEBUG
+    m_droppedTiles[camAdjust] = droppedTiles;
 #endif
-                dirtyBits |= QSGNode::DirtyMaterial;
+}
+
+/*
+    Makes sure the image of every visible tile is in an atlas page. Images are
+    keyed by their own spec, so a lower zoom level tile magnified for several
+    visible tiles is uploaded once, and tiles scrolled out and back in are
+    found where they were as long as their slot has not been reused.
+*/
+void QGeoTiledMapRootNode::updateAtlas(QGeoTiledMapScenePrivate *d, QQuickWindow *window)
+{
+    atlas.beginFrame();
+    atlasTiles.clear();
+
+    for (const QGeoTileSpec &spec : qAsConst(d->m_visibleTiles)) {
+        const QGeoTileTexture *tileTexture = d->m_textures.value(spec).data();
+        if (!tileTexture || tileTexture->image.isNull())
+            continue;
+
+        QGeoTileAtlasAllocator::Slot slot;
+        if (!atlas.find(tileTexture->spec, &slot)) {
+            slot = atlas.allocate(tileTexture->spec, tileTexture->image.size() + QSize(2, 2));
+            for (int page = atlasPages.size(); page < atlas.pageCount(); ++page) {
+                QGeoTileAtlasTexture *texture = new QGeoTileAtlasTexture(atlas.pageSize(page), window);
+                texture->setAnisotropyLevel(QSGTexture::Anisotropy16x);
+                atlasPages.append(texture);
             }
-            if (dirtyBits != 0)
-                node->markDirty(dirtyBits);
-            it++;
+            atlasPages.at(slot.page)->upload(slot.rect, tileTexture->image);
         }
+        atlasTiles.insert(spec, AtlasTile{slot.page, slot.rect.adjusted(1, 1, -1, -1)});
     }
+}
 
-    for (const QGeoTileSpec &s : toAdd) {
-        QGeoTileTexture *tileTexture = d->m_textures.value(s).data();
-        if (!tileTexture || tileTexture->image.isNull()) {
+void QGeoTiledMapTileBatchNode::setQuad(const QGeoTileSpec &spec, const QSGGeometry::TexturedPoint2D *vertices)
+{
+    int quad = quads.value(spec, -1);
+    if (quad < 0) {
+        if (freeQuads.isEmpty()) {
+            // Grow geometrically, keeping the quads in place
+            const int count = geometry.vertexCount() / QuadVertices;
+            const int capacity = qMax(16, count * 2);
+            const QByteArray old(static_cast<const char *>(geometry.vertexData()),
+                                 geometry.vertexCount() * geometry.sizeOfVertex());
+            geometry.allocate(capacity * QuadVertices);
+            char *data = static_cast<char *>(geometry.vertexData());
+            memcpy(data, old.constData(), size_t(old.size()));
+            memset(data + old.size(), 0, size_t(geometry.vertexCount() * geometry.sizeOfVertex() - old.size()));
+            for (int i = capacity - 1; i >= count; --i)
+                freeQuads.append(i);
+            geometryChanged = true;
+        }
+        quad = freeQuads.takeLast();
+        quads.insert(spec, quad);
+    }
+
+    QSGGeometry::TexturedPoint2D *data = geometry.vertexDataAsTexturedPoint2D() + quad * QuadVertices;
+    if (memcmp(data, vertices, QuadVertices * sizeof(QSGGeometry::TexturedPoint2D)) != 0) {
+        memcpy(data, vertices, QuadVertices * sizeof(QSGGeometry::TexturedPoint2D));
+        geometryChanged = true;
+    }
+}
+
+// Collapses the quad of spec into a point, so that it draws nothing until reused
+void QGeoTiledMapTileBatchNode::removeQuad(const QGeoTileSpec &spec)
+{
+    const auto it = quads.find(spec);
+    if (it == quads.end())
+        return;
+    const int quad = it.value();
+    quads.erase(it);
+    memset(geometry.vertexDataAsTexturedPoint2D() + quad * QuadVertices, 0,
+           QuadVertices * sizeof(QSGGeometry::TexturedPoint2D));
+    freeQuads.append(quad);
+    geometryChanged = true;
+}
+
+void QGeoTiledMapTileBatchNode::commit()
+{
+    if (geometryChanged) {
+        markDirty(DirtyGeometry);
+        geometryChanged = false;
+    }
+}
+
+void QGeoTiledMapRootNode::updateAtlasTiles(QGeoTiledMapTileContainerNode *root,
+                                            QGeoTiledMapScenePrivate *d,
+                                            double camAdjust,
+                                            QQuickWindow *window,
+                                            bool tilesChanged)
+{
+    // Set up the matrix...
+    QDoubleVector3D eye = d->m_cameraEye;
+    eye.setX(eye.x() + camAdjust);
+    QDoubleVector3D center = d->m_cameraCenter;
+    center.setX(center.x() + camAdjust);
+    QMatrix4x4 cameraMatrix;
+    cameraMatrix.lookAt(toVector3D(eye), toVector3D(center), toVector3D(d->m_cameraUp));
+    const QMatrix4x4 matrix = d->m_projectionMatrix * cameraMatrix;
+    if (!tilesChanged && matrix == root->matrix())
+        return;
+    root->setMatrix(matrix);
+
+    const bool straight = !d->isTiltedOrRotated();
+    const qreal pixelRatio = window->effectiveDevicePixelRatio();
+    QVector<bool> linear(atlasPages.size(), d->m_linearScaling);
+    root->batches.resize(atlasPages.size());
 #ifdef QT_LOCATION_DEBUG
-            droppedTiles.append(s);
+    QList<QGeoTileSpec> droppedTiles;
 #endif
+
+    // Tiles that went away, or whose image moved to another page
+    for (int page = 0; page < root->batches.size(); ++page) {
+        QGeoTiledMapTileBatchNode *node = root->batches.at(page);
+        if (!node)
             continue;
+        const QList<QGeoTileSpec> specs = node->quads.keys();
+        for (const QGeoTileSpec &spec : specs) {
+            const auto it = atlasTiles.constFind(spec);
+            if (it == atlasTiles.constEnd() || it->page != page)
+                node->removeQuad(spec);
         }
-        QSGImageNode *tileNode = window->createImageNode();
-        // note: setTexture will update coordinates so do it here, before we buildGeometry
-        tileNode->setTexture(textures.value(s));
-        if (d->buildGeometry(s, tileNode, overzooming)
-                && qgeotiledmapscene_isTileInViewport(tileNode->rect(), root->matrix(), straight)) {
-            if (tileNode->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
-                tileNode->setFiltering(QSGTexture::Linear); // with mipmapping QSGTexture::Nearest generates artifacts
-                tileNode->setMipmapFiltering(QSGTexture::Linear);
-            } else {
-                tileNode->setFiltering((d->m_linearScaling || overzooming) ? QSGTexture::Linear : QSGTexture::Nearest);
-            }
-#if QT_CONFIG(opengl)
-            if (ogl)
-                static_cast<QSGDefaultImageNode *>(tileNode)->setAnisotropyLevel(QSGTexture::Anisotropy16x);
-#endif
-            root->addChild(s, tileNode);
-        } else {
+    }
+
+    for (auto it = atlasTiles.cbegin(), end = atlasTiles.cend(); it != end; ++it) {
+        const AtlasTile &tile = it.value();
+        QGeoTiledMapTileBatchNode *node = root->batches.at(tile.page);
+        QRectF rect;
+        QRectF sourceRect;
+        bool overzooming;
+        if (!d->buildGeometry(it.key(), tile.rect.size(), rect, sourceRect, overzooming)
+                || !qgeotiledmapscene_isTileInViewport(rect, root->matrix(), straight)) {
 #ifdef QT_LOCATION_DEBUG
-            droppedTiles.append(s);
+            droppedTiles.append(it.key());
 #endif
-            delete tileNode;
+            if (node)
+                node->removeQuad(it.key());
+            continue;
+        }
+        if (overzooming || tile.rect.width() > d->m_tileSize * pixelRatio)
+            linear[tile.page] = true;
+
+        const QSizeF pageSize = atlasPages.at(tile.page)->textureSize();
+        sourceRect.translate(tile.rect.topLeft());
+        const float u1 = sourceRect.left() / pageSize.width();
+        const float u2 = sourceRect.right() / pageSize.width();
+        const float v1 = sourceRect.top() / pageSize.height();
+        const float v2 = sourceRect.bottom() / pageSize.height();
+
+        // Mirrored vertically: y grows northwards, the first image row is the northern edge
+        QSGGeometry::TexturedPoint2D nw, ne, sw, se;
+        nw.set(rect.left(), rect.bottom(), u1, v1);
+        ne.set(rect.right(), rect.bottom(), u2, v1);
+        sw.set(rect.left(), rect.top(), u1, v2);
+        se.set(rect.right(), rect.top(), u2, v2);
+        const QSGGeometry::TexturedPoint2D quad[QGeoTiledMapTileBatchNode::QuadVertices] = { nw, ne, sw, ne, se, sw };
+
+        if (!node) {
+            node = new QGeoTiledMapTileBatchNode();
+            root->batches[tile.page] = node;
+            root->appendChildNode(node);
         }
+        node->setQuad(it.key(), quad);
+    }
+
+    for (int page = 0; page < atlasPages.size(); ++page) {
+        QGeoTiledMapTileBatchNode *node = root->batches.at(page);
+        if (!node)
+            continue;
+        if (node->quads.isEmpty()) {
+            delete node;
+            root->batches[page] = nullptr;
+            continue;
+        }
+        node->commit();
+        node->setTexture(atlasPages.at(page), linear.at(page) ? QSGTexture::Linear : QSGTexture::Nearest);
     }
 
 #ifdef QT_LOCATION_DEBUG
@@ -580,6 +834,38 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
 #endif
 }
 
+void QGeoTiledMapRootNode::removeTile(const QGeoTileSpec &spec)
+{
+    for (QGeoTiledMapTileContainerNode *container : { tiles, wrapLeft, wrapRight })
+        delete container->tiles.take(spec);
+    if (QSGTexture *texture = textures.take(spec))
+        texture->deleteLater();
+}
+
+void QGeoTiledMapRootNode::dropTextures()
+{
+    for (QGeoTiledMapTileContainerNode *container : { tiles, wrapLeft, wrapRight }) {
+        qDeleteAll(container->tiles);
+        container->tiles.clear();
+    }
+    for (QSGTexture *texture : qAsConst(textures))
+        texture->deleteLater();
+    textures.clear();
+}
+
+void QGeoTiledMapRootNode::dropAtlas()
+{
+    for (QGeoTiledMapTileContainerNode *container : { tiles, wrapLeft, wrapRight }) {
+        qDeleteAll(container->batches);
+        container->batches.clear();
+    }
+    for (QGeoTileAtlasTexture *texture : qAsConst(atlasPages))
+        texture->deleteLater();
+    atlasPages.clear();
+    atlasTiles.clear();
+    atlas.clear();
+}
+
 QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
 {
     Q_D(QGeoTiledMapScene);
@@ -592,8 +878,12 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
 
     bool isOpenGL = (window->rendererInterface()->graphicsApi() == QSGRendererInterface::OpenGL);
     QGeoTiledMapRootNode *mapRoot = static_cast<QGeoTiledMapRootNode *>(oldNode);
-    if (!mapRoot)
+    bool fullUpdate = d->m_geometryChanged;
+    if (!mapRoot) {
         mapRoot = new QGeoTiledMapRootNode();
+        fullUpdate = true;
+    }
+    d->m_geometryChanged = false;
 
 #ifdef QT_LOCATION_DEBUG
     mapRoot->m_droppedTiles.clear();
@@ -607,59 +897,78 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     itemSpaceMatrix.scale(w / 2, h / 2);
     itemSpaceMatrix.translate(1, 1);
     itemSpaceMatrix.scale(1, -1);
-    mapRoot->root->setMatrix(itemSpaceMatrix);
+    if (itemSpaceMatrix != mapRoot->root->matrix())
+        mapRoot->root->setMatrix(itemSpaceMatrix);
 
     if (d->m_dropTextures) {
-        for (const QGeoTileSpec &s : mapRoot->tiles->tiles.keys())
-            delete mapRoot->tiles->tiles.take(s);
-        for (const QGeoTileSpec &s : mapRoot->wrapLeft->tiles.keys())
-            delete mapRoot->wrapLeft->tiles.take(s);
-        for (const QGeoTileSpec &s : mapRoot->wrapRight->tiles.keys())
-            delete mapRoot->wrapRight->tiles.take(s);
-        for (const QGeoTileSpec &spec : mapRoot->textures.keys())
-            mapRoot->textures.take(spec)->deleteLater();
+        mapRoot->dropTextures();
+        mapRoot->dropAtlas();
         d->m_dropTextures = false;
+        fullUpdate = true;
     }
 
-    // Evicting loZL tiles temporarily used in place of hiZL ones
-    if (d->m_updatedTextures.size()) {
-        const QVector<QGeoTileSpec> &toRemove = d->m_updatedTextures;
-        for (const QGeoTileSpec &s : toRemove) {
-            if (mapRoot->tiles->tiles.contains(s))
-                delete mapRoot->tiles->tiles.take(s);
-
-            if (mapRoot->wrapLeft->tiles.contains(s))
-                delete mapRoot->wrapLeft->tiles.take(s);
+    // Only the tiles that came, went or got a texture since the last update are looked at
+    QSet<QGeoTileSpec> changedTiles;
+    QSet<QGeoTileSpec> removedTiles;
+    qSwap(changedTiles, d->m_changedTiles);
+    qSwap(removedTiles, d->m_removedTiles);
+
+    const qreal pixelRatio = window->effectiveDevicePixelRatio();
+    mapRoot->filteringChanged = pixelRatio != mapRoot->pixelRatio
+            || d->m_linearScaling != mapRoot->isTextureLinear;
+    if (mapRoot->filteringChanged) {
+        mapRoot->pixelRatio = pixelRatio;
+        fullUpdate = true;
+    }
 
-            if (mapRoot->wrapRight->tiles.contains(s))
-                delete mapRoot->wrapRight->tiles.take(s);
+    double sideLength = d->m_scaleFactor * d->m_tileSize * d->m_sideLength;
+#ifdef QT_LOCATION_DEBUG
+    d->m_sideLengthPixel = sideLength;
+#endif
 
-            if (mapRoot->textures.contains(s))
-                mapRoot->textures.take(s)->deleteLater();
-        }
+    if (d->m_tileAtlas && isOpenGL) {
+        if (!mapRoot->textures.isEmpty())
+            mapRoot->dropTextures();
+        // Replaced textures come with a spec of their own, nothing to evict here
         d->m_updatedTextures.clear();
+
+        const bool tilesChanged = fullUpdate || !changedTiles.isEmpty() || !removedTiles.isEmpty();
+        if (tilesChanged)
+            mapRoot->updateAtlas(d, window);
+        mapRoot->updateAtlasTiles(mapRoot->tiles, d, 0, window, tilesChanged);
+        mapRoot->updateAtlasTiles(mapRoot->wrapLeft, d, +sideLength, window, tilesChanged);
+        mapRoot->updateAtlasTiles(mapRoot->wrapRight, d, -sideLength, window, tilesChanged);
+        mapRoot->isTextureLinear = d->m_linearScaling;
+        return mapRoot;
+    }
+    if (!mapRoot->atlasPages.isEmpty()) {
+        mapRoot->dropAtlas();
+        fullUpdate = true;
     }
 
-    const QSet<QGeoTileSpec> textures = QSet<QGeoTileSpec>::fromList(mapRoot->textures.keys());
-    const QSet<QGeoTileSpec> toRemove = textures - d->m_visibleTiles;
-    const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - textures;
+    for (const QGeoTileSpec &s : qAsConst(removedTiles))
+        mapRoot->removeTile(s);
 
-    for (const QGeoTileSpec &spec : toRemove)
-        mapRoot->textures.take(spec)->deleteLater();
+    // Evicting loZL tiles temporarily used in place of hiZL ones
+    for (const QGeoTileSpec &s : qAsConst(d->m_updatedTextures)) {
+        mapRoot->removeTile(s);
+        changedTiles.insert(s);
+    }
+    d->m_updatedTextures.clear();
+
+    const QSet<QGeoTileSpec> &toAdd = fullUpdate ? d->m_visibleTiles : changedTiles;
     for (const QGeoTileSpec &spec : toAdd) {
+        if (mapRoot->textures.contains(spec))
+            continue;
         QGeoTileTexture *tileTexture = d->m_textures.value(spec).data();
         if (!tileTexture || tileTexture->image.isNull())
             continue;
         mapRoot->textures.insert(spec, window->createTextureFromImage(tileTexture->image));
     }
 
-    double sideLength = d->m_scaleFactor * d->m_tileSize * d->m_sideLength;
-#ifdef QT_LOCATION_DEBUG
-    d->m_sideLengthPixel = sideLength;
-#endif
-    mapRoot->updateTiles(mapRoot->tiles, d, 0, window, isOpenGL);
-    mapRoot->updateTiles(mapRoot->wrapLeft, d, +sideLength, window, isOpenGL);
-    mapRoot->updateTiles(mapRoot->wrapRight, d, -sideLength, window, isOpenGL);
+    mapRoot->updateTiles(mapRoot->tiles, d, 0, window, isOpenGL, changedTiles, fullUpdate);
+    mapRoot->updateTiles(mapRoot->wrapLeft, d, +sideLength, window, isOpenGL, changedTiles, fullUpdate);
+    mapRoot->updateTiles(mapRoot->wrapRight, d, -sideLength, window, isOpenGL, changedTiles, fullUpdate);
 
     mapRoot->isTextureLinear = d->m_linearScaling;
 
@@ -85,6 +85,9 @@ public:
 
     void clearTexturedTiles();
 
+    void setTileAtlasEnabled(bool enabled);
+    bool tileAtlasEnabled() const;
+
 Q_SIGNALS:
     void newTilesVisible(const QSet<QGeoTileSpec> &newTiles);
 
@@ -51,13 +51,63 @@
 #include <QtCore/private/qobject_p.h>
 #include <QtPositioning/private/qdoublevector3d_p.h>
 #include <QtQuick/QSGImageNode>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGTextureMaterial>
 #include <QtQuick/private/qsgdefaultimagenode_p.h>
 #include <QtQuick/QQuickWindow>
 #include "qgeocameradata_p.h"
 #include "qgeotilespec_p.h"
+#include "qgeotileatlas_p.h"
 
 QT_BEGIN_NAMESPACE
 
+/*
+    All the tiles of one container that live in the same atlas page, drawn
+    with a single call. Every tile owns a quad of six vertices in the
+    geometry; quads of tiles that went away are collapsed and reused, so an
+    update only touches the quads that changed.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapTileBatchNode : public QSGGeometryNode
+{
+public:
+    enum { QuadVertices = 6 };
+
+    QGeoTiledMapTileBatchNode()
+        : geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 0), geometryChanged(false)
+    {
+        geometry.setDrawingMode(QSGGeometry::DrawTriangles);
+        setGeometry(&geometry);
+        setMaterial(&material);
+        setOpaqueMaterial(&opaqueMaterial);
+    }
+
+    void setTexture(QSGTexture *texture, QSGTexture::Filtering filtering)
+    {
+        const bool blending = texture->hasAlphaChannel();
+        if (material.texture() == texture && material.filtering() == filtering
+                && opaqueMaterial.flags().testFlag(QSGMaterial::Blending) == blending) {
+            return;
+        }
+        material.setTexture(texture);
+        material.setFiltering(filtering);
+        opaqueMaterial.setTexture(texture);
+        opaqueMaterial.setFiltering(filtering);
+        opaqueMaterial.setFlag(QSGMaterial::Blending, blending);
+        markDirty(DirtyMaterial);
+    }
+
+    void setQuad(const QGeoTileSpec &spec, const QSGGeometry::TexturedPoint2D *vertices);
+    void removeQuad(const QGeoTileSpec &spec);
+    void commit();
+
+    QSGGeometry geometry;
+    QSGTextureMaterial material;
+    QSGOpaqueTextureMaterial opaqueMaterial;
+    QHash<QGeoTileSpec, int> quads;
+    QVector<int> freeQuads;
+    bool geometryChanged;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapTileContainerNode : public QSGTransformNode
 {
 public:
@@ -67,6 +117,7 @@ public:
         appendChildNode(node);
     }
     QHash<QGeoTileSpec, QSGImageNode *> tiles;
+    QVector<QGeoTiledMapTileBatchNode *> batches; // per atlas page, only in atlas mode
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapRootNode : public QSGClipNode
@@ -74,6 +125,8 @@ class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMapRootNode : public QSGClipNode
 public:
     QGeoTiledMapRootNode()
         : isTextureLinear(false)
+        , filteringChanged(false)
+        , pixelRatio(0)
         , geometry(QSGGeometry::defaultAttributes_Point2D(), 4)
         , root(new QSGTransformNode())
         , tiles(new QGeoTiledMapTileContainerNode())
@@ -91,6 +144,7 @@ public:
     ~QGeoTiledMapRootNode()
     {
         qDeleteAll(textures);
+        qDeleteAll(atlasPages);
     }
 
     void setClipRect(const QRect &rect)
@@ -107,9 +161,22 @@ public:
                      QGeoTiledMapScenePrivate *d,
                      double camAdjust,
                      QQuickWindow *window,
-                     bool ogl);
+                     bool ogl,
+                     const QSet<QGeoTileSpec> &changedTiles,
+                     bool fullUpdate);
+    void updateAtlas(QGeoTiledMapScenePrivate *d, QQuickWindow *window);
+    void updateAtlasTiles(QGeoTiledMapTileContainerNode *root,
+                          QGeoTiledMapScenePrivate *d,
+                          double camAdjust,
+                          QQuickWindow *window,
+                          bool tilesChanged);
+    void removeTile(const QGeoTileSpec &spec);
+    void dropTextures();
+    void dropAtlas();
 
     bool isTextureLinear;
+    bool filteringChanged; // in the current update
+    qreal pixelRatio;
 
     QSGGeometry geometry;
     QRect clipRect;
@@ -122,6 +189,16 @@ public:
 
     QHash<QGeoTileSpec, QSGTexture *> textures;
 
+    // Atlas mode: the visible tiles and the part of an atlas page holding their image
+    struct AtlasTile
+    {
+        int page;
+        QRect rect;
+    };
+    QGeoTileAtlasAllocator atlas;
+    QVector<QGeoTileAtlasTexture *> atlasPages;
+    QHash<QGeoTileSpec, AtlasTile> atlasTiles;
+
 #ifdef QT_LOCATION_DEBUG
     double m_sideLengthPixel;
     QMap<double, QList<QGeoTileSpec>> m_droppedTiles;
@@ -140,6 +217,8 @@ public:
     void setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles);
     void removeTiles(const QSet<QGeoTileSpec> &oldTiles);
     bool buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming);
+    bool buildGeometry(const QGeoTileSpec &spec, const QSize &textureSize,
+                       QRectF &rect, QRectF &sourceRect, bool &overzooming);
     void updateTileBounds(const QSet<QGeoTileSpec> &tiles);
     void setupCamera();
     inline bool isTiltedOrRotated() { return (m_cameraData.tilt() > 0.0) || (m_cameraData.bearing() > 0.0); }
@@ -173,6 +252,12 @@ public:
     QHash<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > m_textures;
     QVector<QGeoTileSpec> m_updatedTextures;
 
+    // Changes not yet applied to the scene graph: tiles that became visible or
+    // got a texture, tiles that went away, and whether the tile grid moved
+    QSet<QGeoTileSpec> m_changedTiles;
+    QSet<QGeoTileSpec> m_removedTiles;
+    bool m_geometryChanged;
+
     // tilesToGrid transform
     int m_minTileX; // the minimum tile index, i.e. 0 to sideLength which is 1<< zoomLevel
     int m_minTileY;
@@ -181,6 +266,7 @@ public:
     int m_tileXWrapsBelow; // the wrap point as a tile index
     bool m_linearScaling;
     bool m_dropTextures;
+    bool m_tileAtlas;
 
 #ifdef QT_LOCATION_DEBUG
     double m_sideLengthPixel;
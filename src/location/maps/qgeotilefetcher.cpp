@@ -36,6 +36,8 @@
 
 #include <QtCore/QTimerEvent>
 
+#include <algorithm>
+
 #include "qgeomappingmanagerengine_p.h"
 #include "qgeotilefetcher_p.h"
 #include "qgeotilefetcher_p_p.h"
@@ -66,8 +68,43 @@ QGeoTileFetcher::~QGeoTileFetcher()
 {
 }
 
+/*
+    Sets the maximum number of replies that may be in flight at the same time.
+    Queued tiles are only dispatched when a slot becomes free, so the most urgent
+    tiles are requested first instead of piling up in the network layer.
+    A value of 0 or less, the default, removes the limit.
+*/
+void QGeoTileFetcher::setMaxConcurrentRequests(int count)
+{
+    Q_D(QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    d->maxConcurrentRequests_ = count;
+
+    if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
+}
+
+int QGeoTileFetcher::maxConcurrentRequests() const
+{
+    Q_D(const QGeoTileFetcher);
+    return d->maxConcurrentRequests_;
+}
+
 void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
                                                   const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    updateTileRequests(tilesAdded, tilesRemoved, QHash<QGeoTileSpec, int>());
+}
+
+/*
+    Queues \a tilesAdded and cancels \a tilesRemoved. Tiles are dispatched in
+    ascending order of their value in \a priorities; tiles without an entry get
+    priority 0. Entries for tiles that are already queued reprioritize them.
+*/
+void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
+                                         const QSet<QGeoTileSpec> &tilesRemoved,
+                                         const QHash<QGeoTileSpec, int> &priorities)
 {
     Q_D(QGeoTileFetcher);
 
@@ -75,7 +112,14 @@ void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
 
     cancelTileRequests(tilesRemoved);
 
-    d->queue_ += tilesAdded.toList();
+    for (const QGeoTileSpec &tile : tilesAdded) {
+        if (!d->invmap_.contains(tile))
+            d->queue_.insert(tile, priorities.value(tile, 0));
+    }
+    for (auto it = priorities.cbegin(), end = priorities.cend(); it != end; ++it) {
+        if (d->queue_.contains(it.key()))
+            d->queue_.insert(it.key(), it.value());
+    }
 
     if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
         d->timer_.start(0, this);
@@ -97,7 +141,7 @@ void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
             if (reply->isFinished())
                 reply->deleteLater();
         }
-        d->queue_.removeAll(*tile);
+        d->queue_.remove(*tile);
     }
 }
 
@@ -110,35 +154,40 @@ void QGeoTileFetcher::requestNextTile()
     if (!d->enabled_)
         return;
 
-    if (d->queue_.isEmpty())
-        return;
-
-    QGeoTileSpec ts = d->queue_.takeFirst();
-    if (d->queue_.isEmpty())
-        d->timer_.stop();
-
-    // Check against min/max zoom to prevent sending requests for not existing objects
-    const QGeoCameraCapabilities & cameraCaps = d->engine_->cameraCapabilities(ts.mapId());
-    // the ZL in QGeoTileSpec is relative to the native tile size of the provider.
-    // It gets denormalized in QGeoTiledMap.
-    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled())
-        return;
-
-    QGeoTiledMapReply *reply = getTileImage(ts);
-    if (!reply)
-        return;
-
-    if (reply->isFinished()) {
-        handleReply(reply, ts);
-    } else {
-        connect(reply,
-                SIGNAL(finished()),
-                this,
-                SLOT(finished()),
-                Qt::QueuedConnection);
-
-        d->invmap_.insert(ts, reply);
+    // Dispatch tiles until the queue is drained or all request slots are taken.
+    // Replies that finish immediately do not occupy a slot.
+    while (!d->queue_.isEmpty()) {
+        if (d->maxConcurrentRequests_ > 0 && d->invmap_.size() >= d->maxConcurrentRequests_)
+            break;
+
+        QGeoTileSpec ts = d->queue_.takeFirst();
+
+        // Check against min/max zoom to prevent sending requests for not existing objects
+        const QGeoCameraCapabilities & cameraCaps = d->engine_->cameraCapabilities(ts.mapId());
+        // the ZL in QGeoTileSpec is relative to the native tile size of the provider.
+        // It gets denormalized in QGeoTiledMap.
+        if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled())
+            continue;
+
+        QGeoTiledMapReply *reply = getTileImage(ts);
+        if (!reply)
+            continue;
+
+        if (reply->isFinished()) {
+            handleReply(reply, ts);
+        } else {
+            connect(reply,
+                    SIGNAL(finished()),
+                    this,
+                    SLOT(finished()),
+                    Qt::QueuedConnection);
+
+            d->invmap_.insert(ts, reply);
+        }
     }
+
+    // Restarted from finished() once a slot frees up
+    d->timer_.stop();
 }
 
 void QGeoTileFetcher::finished()
@@ -161,6 +210,9 @@ void QGeoTileFetcher::finished()
     d->invmap_.remove(spec);
 
     handleReply(reply, spec);
+
+    if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
 }
 
 void QGeoTileFetcher::timerEvent(QTimerEvent *event)
@@ -213,7 +265,7 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
 *******************************************************************************/
 
 QGeoTileFetcherPrivate::QGeoTileFetcherPrivate()
-:   QObjectPrivate(), enabled_(false), engine_(0)
+:   QObjectPrivate(), enabled_(false), maxConcurrentRequests_(0), engine_(0)
 {
 }
 
@@ -221,4 +273,89 @@ QGeoTileFetcherPrivate::~QGeoTileFetcherPrivate()
 {
 }
 
+/*******************************************************************************
+*******************************************************************************/
+
+namespace {
+// Heap comparator: the item with the lowest priority, then the oldest, ends up on top
+struct QGeoTileFetchItemLater
+{
+    template <typename Item>
+    bool operator()(const Item &a, const Item &b) const
+    {
+        if (a.priority != b.priority)
+            return a.priority > b.priority;
+        return a.sequence > b.sequence;
+    }
+};
+}
+
+QGeoTileFetchQueue::QGeoTileFetchQueue()
+:   m_sequence(0)
+{
+}
+
+void QGeoTileFetchQueue::insert(const QGeoTileSpec &spec, int priority)
+{
+    auto it = m_entries.find(spec);
+    if (it != m_entries.end()) {
+        if (it->priority == priority)
+            return;
+        // The previous heap item goes stale, its sequence no longer matches
+        it->priority = priority;
+        it->sequence = ++m_sequence;
+    } else {
+        it = m_entries.insert(spec, Entry{priority, ++m_sequence});
+    }
+
+    m_heap.append(Item{priority, it->sequence, spec});
+    std::push_heap(m_heap.begin(), m_heap.end(), QGeoTileFetchItemLater());
+
+    if (m_heap.size() > 2 * m_entries.size() + 64)
+        compact();
+}
+
+bool QGeoTileFetchQueue::remove(const QGeoTileSpec &spec)
+{
+    if (!m_entries.remove(spec))
+        return false;
+
+    if (m_entries.isEmpty())
+        m_heap.clear();
+    else if (m_heap.size() > 2 * m_entries.size() + 64)
+        compact();
+    return true;
+}
+
+QGeoTileSpec QGeoTileFetchQueue::takeFirst()
+{
+    while (!m_heap.isEmpty()) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), QGeoTileFetchItemLater());
+        const Item item = m_heap.takeLast();
+
+        auto it = m_entries.find(item.spec);
+        if (it != m_entries.end() && it->sequence == item.sequence) {
+            m_entries.erase(it);
+            return item.spec;
+        }
+    }
+    return QGeoTileSpec();
+}
+
+void QGeoTileFetchQueue::clear()
+{
+    m_heap.clear();
+    m_entries.clear();
+}
+
+void QGeoTileFetchQueue::compact()
+{
+    auto stale = [this](const Item &item) {
+        auto it = m_entries.constFind(item.spec);
+        return it == m_entries.constEnd() || it->sequence != item.sequence;
+    };
+    m_heap.erase(std::remove_if(m_heap.begin(), m_heap.end(), stale), m_heap.end());
+    std::make_heap(m_heap.begin(), m_heap.end(), QGeoTileFetchItemLater());
+}
+
 QT_END_NAMESPACE
@@ -71,8 +71,13 @@ public:
     QGeoTileFetcher(QGeoMappingManagerEngine *parent);
     virtual ~QGeoTileFetcher();
 
+    void setMaxConcurrentRequests(int count);
+    int maxConcurrentRequests() const;
+
 public Q_SLOTS:
     void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved);
+    void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved,
+                            const QHash<QGeoTileSpec, int> &priorities);
 
 private Q_SLOTS:
     void cancelTileRequests(const QSet<QGeoTileSpec> &tiles);
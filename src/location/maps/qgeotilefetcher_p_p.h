@@ -59,7 +59,9 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QHash>
+#include <QVector>
 #include "qgeomaptype_p.h"
+#include "qgeotilespec_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -67,6 +69,43 @@ class QGeoTileSpec;
 class QGeoTiledMapReply;
 class QGeoMappingManagerEngine;
 
+// Pending tile requests ordered by priority (lower values first, FIFO among equal
+// priorities). Removing or reprioritizing a tile only touches the hash; the stale
+// heap entries are skipped when they reach the top.
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileFetchQueue
+{
+public:
+    QGeoTileFetchQueue();
+
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    int size() const { return m_entries.size(); }
+    bool contains(const QGeoTileSpec &spec) const { return m_entries.contains(spec); }
+
+    void insert(const QGeoTileSpec &spec, int priority);
+    bool remove(const QGeoTileSpec &spec);
+    QGeoTileSpec takeFirst();
+    void clear();
+
+private:
+    struct Item
+    {
+        int priority;
+        quint64 sequence;
+        QGeoTileSpec spec;
+    };
+    struct Entry
+    {
+        int priority;
+        quint64 sequence;
+    };
+
+    void compact();
+
+    QVector<Item> m_heap;
+    QHash<QGeoTileSpec, Entry> m_entries;
+    quint64 m_sequence;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoTileFetcherPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QGeoTileFetcher)
@@ -77,8 +116,9 @@ public:
     bool enabled_;
     QBasicTimer timer_;
     QMutex queueMutex_;
-    QList<QGeoTileSpec> queue_;
+    QGeoTileFetchQueue queue_;
     QHash<QGeoTileSpec, QGeoTiledMapReply *> invmap_;
+    int maxConcurrentRequests_;
     QGeoMappingManagerEngine *engine_;
 
 private:
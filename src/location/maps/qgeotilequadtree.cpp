@@ -0,0 +1,196 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeotilequadtree_p.h"
+
+QT_BEGIN_NAMESPACE
+
+QGeoTileQuadtree::QGeoTileQuadtree()
+:   m_size(0)
+{
+}
+
+void QGeoTileQuadtree::insert(const QGeoTileSpec &spec)
+{
+    if (spec.zoom() < 0)
+        return;
+
+    Node &node = m_nodes[spec];
+    if (node.present)
+        return;
+
+    bool becameCovered = !covered(node);
+    node.present = true;
+    ++node.count;
+    ++m_size;
+
+    QGeoTileSpec s = spec;
+    while (s.zoom() > 0) {
+        const int index = childIndex(s);
+        s = parent(s);
+        Node &p = m_nodes[s];
+        ++p.count;
+        if (becameCovered) {
+            const bool wasCovered = covered(p);
+            p.coveredChildren |= quint8(1 << index);
+            becameCovered = !wasCovered && covered(p);
+        }
+    }
+}
+
+void QGeoTileQuadtree::remove(const QGeoTileSpec &spec)
+{
+    auto it = m_nodes.find(spec);
+    if (it == m_nodes.end() || !it->present)
+        return;
+
+    const bool wasCovered = covered(*it);
+    it->present = false;
+    bool lostCover = wasCovered && !covered(*it);
+    if (--it->count == 0)
+        m_nodes.erase(it);
+    --m_size;
+
+    QGeoTileSpec s = spec;
+    while (s.zoom() > 0) {
+        const int index = childIndex(s);
+        s = parent(s);
+        auto p = m_nodes.find(s);
+        Q_ASSERT(p != m_nodes.end());
+        if (lostCover) {
+            const bool parentWasCovered = covered(*p);
+            p->coveredChildren &= quint8(~(1 << index));
+            lostCover = parentWasCovered && !covered(*p);
+        }
+        if (--p->count == 0)
+            m_nodes.erase(p);
+    }
+}
+
+void QGeoTileQuadtree::clear()
+{
+    m_nodes.clear();
+    m_size = 0;
+}
+
+bool QGeoTileQuadtree::contains(const QGeoTileSpec &spec) const
+{
+    const auto it = m_nodes.constFind(spec);
+    return it != m_nodes.constEnd() && it->present;
+}
+
+int QGeoTileQuadtree::size() const
+{
+    return m_size;
+}
+
+/*
+    Returns the closest present ancestor of \a spec at most \a maxLevels zoom
+    levels up, or a default constructed spec if there is none.
+*/
+QGeoTileSpec QGeoTileQuadtree::ancestor(const QGeoTileSpec &spec, int maxLevels) const
+{
+    QGeoTileSpec s = spec;
+    for (int level = 0; level < maxLevels && s.zoom() > 0; ++level) {
+        s = parent(s);
+        if (contains(s))
+            return s;
+    }
+    return QGeoTileSpec();
+}
+
+/*
+    Fills \a tiles with present descendants of \a spec, at most \a maxLevels
+    zoom levels down, that together cover the whole of \a spec. Larger tiles
+    are preferred over their children. Returns false, leaving \a tiles
+    untouched, if there is no such set.
+*/
+bool QGeoTileQuadtree::descendants(const QGeoTileSpec &spec, int maxLevels, QVector<QGeoTileSpec> *tiles) const
+{
+    const auto it = m_nodes.constFind(spec);
+    if (it == m_nodes.constEnd() || it->coveredChildren != 0xf || maxLevels < 1)
+        return false;
+
+    const int start = tiles->size();
+    for (int i = 0; i < 4; ++i) {
+        if (!collect(child(spec, i), maxLevels - 1, tiles)) {
+            tiles->resize(start);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool QGeoTileQuadtree::collect(const QGeoTileSpec &spec, int levels, QVector<QGeoTileSpec> *tiles) const
+{
+    const auto it = m_nodes.constFind(spec);
+    if (it == m_nodes.constEnd())
+        return false;
+    if (it->present) {
+        tiles->append(spec);
+        return true;
+    }
+    if (levels == 0 || it->coveredChildren != 0xf)
+        return false;
+    for (int i = 0; i < 4; ++i) {
+        if (!collect(child(spec, i), levels - 1, tiles))
+            return false;
+    }
+    return true;
+}
+
+QGeoTileSpec QGeoTileQuadtree::parent(const QGeoTileSpec &spec)
+{
+    QGeoTileSpec p = spec;
+    p.setZoom(spec.zoom() - 1);
+    p.setX(spec.x() >> 1);
+    p.setY(spec.y() >> 1);
+    return p;
+}
+
+/*
+    Returns child \a index of \a spec, 0 to 3 in the order top left, top
+    right, bottom left, bottom right.
+*/
+QGeoTileSpec QGeoTileQuadtree::child(const QGeoTileSpec &spec, int index)
+{
+    QGeoTileSpec c = spec;
+    c.setZoom(spec.zoom() + 1);
+    c.setX((spec.x() << 1) | (index & 1));
+    c.setY((spec.y() << 1) | (index >> 1));
+    return c;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOTILEQUADTREE_P_H
+#define QGEOTILEQUADTREE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QHash>
+#include <QVector>
+
+#include "qgeotilespec_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Index of the tiles held by a cache, organized by their position in the
+    tile pyramid of each plugin, map and version.
+
+    Besides the tiles themselves, every ancestor of a tile has a node that
+    counts the tiles below it and knows which of its four children are
+    covered, i.e. present or completely covered by their own children.
+    Inserting or removing a tile updates its ancestors, so both the closest
+    present ancestor and a complete set of present descendants of any tile
+    are found in time proportional to the zoom distance, plus the size of the
+    result.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileQuadtree
+{
+public:
+    QGeoTileQuadtree();
+
+    void insert(const QGeoTileSpec &spec);
+    void remove(const QGeoTileSpec &spec);
+    void clear();
+
+    bool contains(const QGeoTileSpec &spec) const;
+    int size() const;
+
+    QGeoTileSpec ancestor(const QGeoTileSpec &spec, int maxLevels) const;
+    bool descendants(const QGeoTileSpec &spec, int maxLevels, QVector<QGeoTileSpec> *tiles) const;
+
+    static QGeoTileSpec parent(const QGeoTileSpec &spec);
+    static QGeoTileSpec child(const QGeoTileSpec &spec, int index);
+
+private:
+    struct Node
+    {
+        bool present = false;
+        quint8 coveredChildren = 0; // bit i set when child(i) is covered
+        int count = 0;              // present tiles in this subtree, including this one
+    };
+
+    static bool covered(const Node &node) { return node.present || node.coveredChildren == 0xf; }
+    static int childIndex(const QGeoTileSpec &spec) { return (spec.x() & 1) | ((spec.y() & 1) << 1); }
+    bool collect(const QGeoTileSpec &spec, int levels, QVector<QGeoTileSpec> *tiles) const;
+
+    QHash<QGeoTileSpec, Node> m_nodes;
+    int m_size;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEQUADTREE_P_H
@@ -53,7 +53,7 @@ public:
     QGeoTiledMap *m_map;
     QPointer<QGeoTiledMappingManagerEngine> m_engine;
 
-    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &tiles);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &tiles, bool placeholders);
     void tileError(const QGeoTileSpec &tile, const QString &errorString);
 
     QHash<QGeoTileSpec, int> m_retries;
@@ -74,9 +74,15 @@ QGeoTileRequestManager::~QGeoTileRequestManager()
 
 }
 
-QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTiles(const QSet<QGeoTileSpec> &tiles)
+/*
+    Requests \a tiles and returns the textures that are available right away.
+    With \a placeholders set, tiles that have to be loaded first get a
+    texture from another zoom level to be shown in the meantime.
+*/
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTiles(const QSet<QGeoTileSpec> &tiles,
+                                                                                          bool placeholders)
 {
-    return d_ptr->requestTiles(tiles);
+    return d_ptr->requestTiles(tiles, placeholders);
 }
 
 void QGeoTileRequestManager::tileFetched(const QGeoTileSpec &spec)
@@ -107,11 +113,13 @@ QGeoTileRequestManagerPrivate::~QGeoTileRequestManagerPrivate()
 {
 }
 
-QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileSpec> &tiles)
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileSpec> &tiles,
+                                                                                                 bool placeholders)
 {
     QSet<QGeoTileSpec> cancelTiles = m_requested - tiles;
     QSet<QGeoTileSpec> requestTiles = tiles - m_requested;
     QSet<QGeoTileSpec> cached;
+    QSet<QGeoTileSpec> decoding;
 //    int tileSize = tiles.size();
 //    int newTiles = requestTiles.size();
 
@@ -125,25 +133,22 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
         iter end = requestTiles.constEnd();
         for (; i != end; ++i) {
             QGeoTileSpec tile = *i;
-            QSharedPointer<QGeoTileTexture> tex = m_engine->getTileTexture(tile);
+            bool pending = false;
+            QSharedPointer<QGeoTileTexture> tex = m_engine->requestTileTexture(m_map, tile, &pending);
             if (tex) {
                 if (!tex->image.isNull())
                     cachedTex.insert(tile, tex);
                 cached.insert(tile);
             } else {
-                // Try to use textures from lower zoom levels, but still request the proper tile
-                QGeoTileSpec spec = tile;
-                const int endRange = qMax(0, tile.zoom() - 4); // Using up to 4 zoom levels up. 4 is arbitrary.
-                for (int z = tile.zoom() - 1; z >= endRange; z--) {
-                    int denominator = 1 << (tile.zoom() - z);
-                    spec.setZoom(z);
-                    spec.setX(tile.x() / denominator);
-                    spec.setY(tile.y() / denominator);
-                    QSharedPointer<QGeoTileTexture> t = m_engine->getTileTexture(spec);
-                    if (t && !t->image.isNull()) {
+                // Being decoded by the cache, tileFetched() is called once the texture is ready
+                if (pending)
+                    decoding.insert(tile);
+
+                // Try to use textures from other zoom levels, but still request the proper tile
+                if (placeholders) {
+                    QSharedPointer<QGeoTileTexture> t = m_engine->placeholderTileTexture(tile);
+                    if (t && !t->image.isNull())
                         cachedTex.insert(tile, t);
-                        break;
-                    }
                 }
             }
         }
@@ -154,6 +159,9 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
     m_requested -= cancelTiles;
     m_requested += requestTiles;
 
+    // decoding tiles stay requested, but do not go to the fetcher
+    requestTiles -= decoding;
+
 //    qDebug() << "required # tiles: " << tileSize << ", new tiles: " << newTiles << ", total server requests: " << requested_.size();
 
     if (!requestTiles.isEmpty() || !cancelTiles.isEmpty()) {
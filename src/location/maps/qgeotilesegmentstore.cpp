@@ -0,0 +1,750 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotilesegmentstore_p.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QtEndian>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Segment file: magic "QGSG", quint32 version, then records back to back.
+// Record, integers little endian:
+//   magic[4] "QGRC", quint8 type, quint8 variant, quint8 formatLength, quint8 pluginLength,
+//   qint32 mapId, zoom, x, y, version, quint32 timestamp, quint32 size,
+//   plugin name, format, tile bytes
+const char segmentMagic[4] = { 'Q', 'G', 'S', 'G' };
+const char recordMagic[4] = { 'Q', 'G', 'R', 'C' };
+const quint32 segmentVersion = 1;
+const int segmentHeaderSize = 8;
+const int recordHeaderSize = 36;
+
+const quint8 tileRecord = 1;
+const quint8 tombstoneRecord = 2;
+
+const quint32 indexMagic = 0x51475349; // "QGSI"
+const quint32 indexVersion = 2;
+
+// Sealed segments are compacted once less than this fraction of them is live
+const qint64 compactionRatio = 2;
+
+QString indexPath(const QString &directory)
+{
+    return QDir(directory).filePath(QStringLiteral("segments.idx"));
+}
+
+// "seg-00000001.qgs"
+quint32 segmentId(const QString &fileName, bool *ok)
+{
+    const QString name = QFileInfo(fileName).fileName();
+    return name.mid(4, name.size() - 8).toUInt(ok);
+}
+
+}
+
+QGeoTileSegmentStore::QGeoTileSegmentStore(const QString &directory)
+:   m_directory(directory), m_activeId(0), m_maxSegmentSize(8 * 1024 * 1024), m_generation(0),
+    m_open(false)
+{
+}
+
+QGeoTileSegmentStore::~QGeoTileSegmentStore()
+{
+    close();
+}
+
+bool QGeoTileSegmentStore::open()
+{
+    QMutexLocker locker(&m_lock);
+    if (m_open)
+        return true;
+
+    if (!QDir::root().mkpath(m_directory))
+        return false;
+
+    if (!loadIndex() && !rebuildIndex())
+        return false;
+
+    // Keep appending to the last segment if it has room left
+    if (!m_segments.isEmpty() && m_segments.last().size < m_maxSegmentSize) {
+        m_activeId = m_segments.lastKey();
+        m_active.setFileName(segmentPath(m_activeId));
+        if (!m_active.open(QIODevice::WriteOnly | QIODevice::Append) && !startSegment())
+            return false;
+    } else if (!startSegment()) {
+        return false;
+    }
+
+    m_open = true;
+    return true;
+}
+
+void QGeoTileSegmentStore::close()
+{
+    QMutexLocker locker(&m_lock);
+    if (!m_open)
+        return;
+
+    m_active.close();
+    writeIndex();
+
+    m_index.clear();
+    m_segments.clear();
+    m_formats.clear();
+    m_pins.clear();
+    m_compactQueue.clear();
+    ++m_generation;
+    m_open = false;
+}
+
+bool QGeoTileSegmentStore::isOpen() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_open;
+}
+
+bool QGeoTileSegmentStore::insert(const QGeoTileSpec &spec, int variant, const QString &format,
+                                  const QByteArray &bytes)
+{
+    QMutexLocker locker(&m_lock);
+    if (!m_open)
+        return false;
+
+    const Key key = { spec, variant };
+    Location location;
+    if (!appendRecord(false, key, formatId(format), bytes, quint32(QDateTime::currentSecsSinceEpoch()), &location))
+        return false;
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        const Location old = it.value();
+        it.value() = location;
+        markDead(old);
+        maybeCompact(old.segment);
+    } else {
+        m_index.insert(key, location);
+    }
+    return true;
+}
+
+bool QGeoTileSegmentStore::remove(const QGeoTileSpec &spec, int variant)
+{
+    QMutexLocker locker(&m_lock);
+    const Key key = { spec, variant };
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+        return false;
+
+    const Location old = it.value();
+    m_index.erase(it);
+    markDead(old);
+    appendRecord(true, key, 0, QByteArray(), 0, nullptr);
+    maybeCompact(old.segment);
+    return true;
+}
+
+bool QGeoTileSegmentStore::contains(const QGeoTileSpec &spec, int variant) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_index.contains(Key{spec, variant});
+}
+
+QByteArray QGeoTileSegmentStore::read(const QGeoTileSpec &spec, int variant, QString *format) const
+{
+    QMutexLocker locker(&m_lock);
+    auto it = m_index.constFind(Key{spec, variant});
+    if (it == m_index.constEnd())
+        return QByteArray();
+    if (format)
+        *format = m_formats.value(it->format);
+    return readLocation(it.value());
+}
+
+bool QGeoTileSegmentStore::locate(const QGeoTileSpec &spec, int variant, QString *fileName,
+                                  qint64 *offset, int *size, QString *format) const
+{
+    QMutexLocker locker(&m_lock);
+    auto it = m_index.constFind(Key{spec, variant});
+    if (it == m_index.constEnd())
+        return false;
+    *fileName = segmentPath(it->segment);
+    *offset = it->offset;
+    *size = int(it->size);
+    if (format)
+        *format = m_formats.value(it->format);
+    return true;
+}
+
+/*
+    Like locate(), but the segment holding the tile is not deleted by
+    compact() until it is released again, so it can be read from another
+    thread after the tile was replaced or moved.
+*/
+bool QGeoTileSegmentStore::acquire(const QGeoTileSpec &spec, int variant, QString *fileName,
+                                   qint64 *offset, int *size)
+{
+    QMutexLocker locker(&m_lock);
+    auto it = m_index.constFind(Key{spec, variant});
+    if (it == m_index.constEnd())
+        return false;
+    *fileName = segmentPath(it->segment);
+    *offset = it->offset;
+    *size = int(it->size);
+    ++m_pins[it->segment];
+    return true;
+}
+
+void QGeoTileSegmentStore::release(const QString &fileName)
+{
+    QMutexLocker locker(&m_lock);
+    bool ok = false;
+    const quint32 id = segmentId(fileName, &ok);
+    auto it = m_pins.find(id);
+    if (!ok || it == m_pins.end())
+        return;
+    if (--it.value() <= 0)
+        m_pins.erase(it);
+}
+
+QVector<QGeoTileSegmentStore::Entry> QGeoTileSegmentStore::entries() const
+{
+    QMutexLocker locker(&m_lock);
+    QVector<Entry> result;
+    result.reserve(m_index.size());
+    for (auto it = m_index.cbegin(), end = m_index.cend(); it != end; ++it) {
+        Entry entry;
+        entry.spec = it.key().spec;
+        entry.variant = it.key().variant;
+        entry.format = m_formats.value(it->format);
+        entry.size = int(it->size);
+        entry.timestamp = it->timestamp;
+        result.append(entry);
+    }
+    return result;
+}
+
+void QGeoTileSegmentStore::clear()
+{
+    QMutexLocker locker(&m_lock);
+    m_active.close();
+    for (auto it = m_segments.cbegin(), end = m_segments.cend(); it != end; ++it)
+        QFile::remove(segmentPath(it.key()));
+    QFile::remove(indexPath(m_directory));
+
+    m_index.clear();
+    m_segments.clear();
+    m_formats.clear();
+    m_compactQueue.clear();
+    ++m_generation;
+    if (m_open)
+        m_open = startSegment();
+}
+
+int QGeoTileSegmentStore::tileCount() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_index.size();
+}
+
+qint64 QGeoTileSegmentStore::diskUsage() const
+{
+    QMutexLocker locker(&m_lock);
+    qint64 usage = 0;
+    for (const Segment &segment : m_segments)
+        usage += segment.size;
+    return usage;
+}
+
+void QGeoTileSegmentStore::setMaxSegmentSize(qint64 size)
+{
+    QMutexLocker locker(&m_lock);
+    m_maxSegmentSize = qBound(qint64(64 * 1024), size, qint64(1024) * 1024 * 1024);
+}
+
+qint64 QGeoTileSegmentStore::maxSegmentSize() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_maxSegmentSize;
+}
+
+// Whether compact() has work to do right now
+bool QGeoTileSegmentStore::compactionPending() const
+{
+    QMutexLocker locker(&m_lock);
+    for (quint32 segment : m_compactQueue) {
+        if (!m_pins.contains(segment))
+            return true;
+    }
+    return false;
+}
+
+/*
+    Compacts the queued segments that are not pinned. Meant to run in a worker
+    thread: the lock is only held while a single tile is moved, so the store
+    stays usable meanwhile.
+*/
+void QGeoTileSegmentStore::compact()
+{
+    QMutexLocker locker(&m_lock);
+    for (int i = 0; i < m_compactQueue.size(); ) {
+        const quint32 segment = m_compactQueue.at(i);
+        if (m_pins.contains(segment)) {
+            ++i;
+            continue;
+        }
+        m_compactQueue.remove(i);
+        compactSegment(&locker, segment);
+        // The queue may have changed while the lock was released
+        i = 0;
+    }
+}
+
+QString QGeoTileSegmentStore::segmentPath(quint32 id) const
+{
+    return QDir(m_directory).filePath(QStringLiteral("seg-%1.qgs").arg(id, 8, 10, QLatin1Char('0')));
+}
+
+bool QGeoTileSegmentStore::startSegment()
+{
+    m_active.close();
+    m_activeId = m_segments.isEmpty() ? 1 : m_segments.lastKey() + 1;
+    m_active.setFileName(segmentPath(m_activeId));
+    if (!m_active.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    uchar header[segmentHeaderSize];
+    memcpy(header, segmentMagic, sizeof(segmentMagic));
+    qToLittleEndian<quint32>(segmentVersion, header + 4);
+    if (m_active.write(reinterpret_cast<const char *>(header), segmentHeaderSize) != segmentHeaderSize)
+        return false;
+    m_active.flush();
+
+    m_segments.insert(m_activeId, Segment{segmentHeaderSize, 0});
+    return true;
+}
+
+bool QGeoTileSegmentStore::appendRecord(bool tombstone, const Key &key, quint16 format,
+                                        const QByteArray &bytes, quint32 timestamp, Location *location)
+{
+    const QByteArray plugin = key.spec.plugin().toLatin1().left(255);
+    const QByteArray formatName = tombstone ? QByteArray() : m_formats.value(format).toLatin1().left(255);
+    const qint64 recordSize = recordHeaderSize + plugin.size() + formatName.size() + bytes.size();
+
+    if (!m_active.isOpen())
+        return false;
+    if (m_segments.value(m_activeId).size + recordSize > m_maxSegmentSize
+            && m_segments.value(m_activeId).size > segmentHeaderSize && !startSegment()) {
+        return false;
+    }
+
+    QByteArray record(recordHeaderSize, Qt::Uninitialized);
+    uchar *header = reinterpret_cast<uchar *>(record.data());
+    memcpy(header, recordMagic, sizeof(recordMagic));
+    header[4] = tombstone ? tombstoneRecord : tileRecord;
+    header[5] = quint8(key.variant);
+    header[6] = quint8(formatName.size());
+    header[7] = quint8(plugin.size());
+    qToLittleEndian<qint32>(key.spec.mapId(), header + 8);
+    qToLittleEndian<qint32>(key.spec.zoom(), header + 12);
+    qToLittleEndian<qint32>(key.spec.x(), header + 16);
+    qToLittleEndian<qint32>(key.spec.y(), header + 20);
+    qToLittleEndian<qint32>(key.spec.version(), header + 24);
+    qToLittleEndian<quint32>(timestamp, header + 28);
+    qToLittleEndian<quint32>(quint32(bytes.size()), header + 32);
+    record += plugin;
+    record += formatName;
+    record += bytes;
+
+    Segment &segment = m_segments[m_activeId];
+    if (m_active.write(record) != record.size()) {
+        // Drop the partial record so the segment stays parseable
+        m_active.resize(segment.size);
+        return false;
+    }
+    m_active.flush();
+
+    if (location) {
+        location->segment = m_activeId;
+        location->offset = quint32(segment.size + recordHeaderSize + plugin.size() + formatName.size());
+        location->size = quint32(bytes.size());
+        location->recordSize = quint32(recordSize);
+        location->timestamp = timestamp;
+        location->format = format;
+        segment.live += recordSize;
+    }
+    segment.size += recordSize;
+    return true;
+}
+
+QByteArray QGeoTileSegmentStore::readLocation(const Location &location) const
+{
+    QFile file(segmentPath(location.segment));
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(location.offset))
+        return QByteArray();
+    QByteArray bytes = file.read(location.size);
+    if (bytes.size() != int(location.size))
+        return QByteArray();
+    return bytes;
+}
+
+void QGeoTileSegmentStore::markDead(const Location &location)
+{
+    auto it = m_segments.find(location.segment);
+    if (it != m_segments.end())
+        it->live -= location.recordSize;
+}
+
+void QGeoTileSegmentStore::maybeCompact(quint32 segment)
+{
+    if (segment == m_activeId || m_compactQueue.contains(segment))
+        return;
+    auto it = m_segments.constFind(segment);
+    if (it == m_segments.constEnd())
+        return;
+    if (it->live * compactionRatio < it->size - segmentHeaderSize)
+        m_compactQueue.append(segment);
+}
+
+/*
+    Moves the live tiles of a sealed segment to the active one and deletes the segment.
+    Tombstones are not carried over: after a crash, tiles they covered in older
+    segments can come back, which is harmless for a cache.
+
+    Called and returns with the lock held, but releases it between tiles. A
+    segment that got pinned in the meantime is queued again instead of deleted.
+*/
+bool QGeoTileSegmentStore::compactSegment(QMutexLocker *locker, quint32 segment)
+{
+    const int generation = m_generation;
+    QVector<Key> keys;
+    for (auto it = m_index.cbegin(), end = m_index.cend(); it != end; ++it) {
+        if (it->segment == segment)
+            keys.append(it.key());
+    }
+
+    for (const Key &key : qAsConst(keys)) {
+        locker->unlock();
+        locker->relock();
+        if (m_generation != generation)
+            return false;
+
+        // Replaced or removed since
+        auto it = m_index.find(key);
+        if (it == m_index.end() || it->segment != segment)
+            continue;
+
+        const Location old = it.value();
+        const QByteArray bytes = readLocation(old);
+        Location location;
+        if (bytes.size() != int(old.size) || !appendRecord(false, key, old.format, bytes, old.timestamp, &location)) {
+            // Keep the segment around, the tiles that could not be moved are still in it
+            return false;
+        }
+        it.value() = location;
+    }
+
+    if (m_pins.contains(segment)) {
+        m_compactQueue.append(segment);
+        return false;
+    }
+    QFile::remove(segmentPath(segment));
+    m_segments.remove(segment);
+    return true;
+}
+
+quint16 QGeoTileSegmentStore::formatId(const QString &format)
+{
+    int id = m_formats.indexOf(format);
+    if (id < 0) {
+        id = m_formats.size();
+        m_formats.append(format);
+    }
+    return quint16(id);
+}
+
+/*
+    Reads the snapshot, then catches up with whatever was written after it:
+    segments that grew are scanned from where the snapshot ended, new segments
+    completely, and entries of segments that were compacted away are dropped,
+    as their tiles were written again further on.
+*/
+bool QGeoTileSegmentStore::loadIndex()
+{
+    QFile file(indexPath(m_directory));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = file.readAll();
+    file.close();
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if (magic != indexMagic || version != indexVersion)
+        return false;
+
+    quint32 segmentCount = 0;
+    stream >> segmentCount;
+    QMap<quint32, Segment> segments;
+    QSet<quint32> removed;
+    for (quint32 i = 0; i < segmentCount && stream.status() == QDataStream::Ok; ++i) {
+        quint32 id = 0;
+        qint64 size = 0;
+        stream >> id >> size;
+        const QFileInfo info(segmentPath(id));
+        if (!info.exists())
+            removed.insert(id);
+        else if (info.size() < size)
+            return false;
+        else
+            segments.insert(id, Segment{size, 0});
+    }
+
+    QVector<QString> plugins;
+    QVector<QString> formats;
+    stream >> plugins >> formats;
+
+    // Intern each plugin name once
+    QVector<QGeoTileSpec> prototypes;
+    prototypes.reserve(plugins.size());
+    for (const QString &plugin : qAsConst(plugins))
+        prototypes.append(QGeoTileSpec(plugin, 0, 0, 0, 0));
+
+    quint32 entryCount = 0;
+    stream >> entryCount;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    QHash<Key, Location> index;
+    index.reserve(int(entryCount));
+    for (quint32 i = 0; i < entryCount; ++i) {
+        quint16 plugin, format;
+        quint8 variant;
+        qint32 mapId, zoom, x, y, tileVersion;
+        Location location;
+        stream >> plugin >> variant >> format >> mapId >> zoom >> x >> y >> tileVersion
+               >> location.segment >> location.offset >> location.size >> location.recordSize
+               >> location.timestamp;
+        if (stream.status() != QDataStream::Ok || plugin >= prototypes.size() || format >= formats.size())
+            return false;
+        if (removed.contains(location.segment))
+            continue;
+
+        auto segment = segments.find(location.segment);
+        if (segment == segments.end() || qint64(location.offset) + location.size > segment->size)
+            return false;
+        segment->live += location.recordSize;
+        location.format = format;
+
+        Key key;
+        key.spec = prototypes.at(plugin);
+        key.spec.setMapId(mapId);
+        key.spec.setZoom(zoom);
+        key.spec.setX(x);
+        key.spec.setY(y);
+        key.spec.setVersion(tileVersion);
+        key.variant = variant;
+        index.insert(key, location);
+    }
+
+    m_segments = segments;
+    m_formats = formats;
+    m_index = index;
+
+    const QStringList files = QDir(m_directory).entryList({ QStringLiteral("seg-*.qgs") }, QDir::Files, QDir::Name);
+    for (const QString &name : files) {
+        bool ok = false;
+        const quint32 id = segmentId(name, &ok);
+        if (!ok || removed.contains(id))
+            continue;
+        auto it = m_segments.constFind(id);
+        if (!scanSegment(id, it != m_segments.constEnd() ? it->size : 0)) {
+            m_index.clear();
+            m_segments.clear();
+            m_formats.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool QGeoTileSegmentStore::rebuildIndex()
+{
+    m_index.clear();
+    m_segments.clear();
+    m_formats.clear();
+
+    const QStringList files = QDir(m_directory).entryList({ QStringLiteral("seg-*.qgs") }, QDir::Files, QDir::Name);
+    for (const QString &name : files) {
+        bool ok = false;
+        const quint32 id = segmentId(name, &ok);
+        if (ok)
+            scanSegment(id, 0);
+    }
+    return true;
+}
+
+/*
+    Adds the records of segment \a id from byte \a from on to the index, 0
+    meaning the whole segment. A segment with a broken header is deleted, and
+    whatever a crash left half written at the end is cut off. Returns false
+    if the segment cannot be read.
+*/
+bool QGeoTileSegmentStore::scanSegment(quint32 id, qint64 from)
+{
+    QFile file(segmentPath(id));
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+    const qint64 fileSize = file.size();
+
+    if (from == 0) {
+        const QByteArray header = file.read(segmentHeaderSize);
+        if (header.size() != segmentHeaderSize || memcmp(header.constData(), segmentMagic, sizeof(segmentMagic)) != 0
+                || qFromLittleEndian<quint32>(header.constData() + 4) != segmentVersion) {
+            file.close();
+            file.remove();
+            return true;
+        }
+        m_segments.insert(id, Segment{segmentHeaderSize, 0});
+    } else if (!file.seek(from)) {
+        return false;
+    }
+
+    Segment &segment = m_segments[id];
+    while (segment.size < fileSize) {
+        const QByteArray record = file.read(recordHeaderSize);
+        if (record.size() != recordHeaderSize || memcmp(record.constData(), recordMagic, sizeof(recordMagic)) != 0)
+            break;
+        const uchar *h = reinterpret_cast<const uchar *>(record.constData());
+        const int formatLength = h[6];
+        const int pluginLength = h[7];
+        const quint32 size = qFromLittleEndian<quint32>(h + 32);
+        const qint64 recordSize = recordHeaderSize + formatLength + pluginLength + qint64(size);
+        if (segment.size + recordSize > fileSize)
+            break;
+
+        const QByteArray names = file.read(pluginLength + formatLength);
+        if (names.size() != pluginLength + formatLength)
+            break;
+
+        Key key;
+        key.spec = QGeoTileSpec(QString::fromLatin1(names.left(pluginLength)),
+                                qFromLittleEndian<qint32>(h + 8), qFromLittleEndian<qint32>(h + 12),
+                                qFromLittleEndian<qint32>(h + 16), qFromLittleEndian<qint32>(h + 20),
+                                qFromLittleEndian<qint32>(h + 24));
+        key.variant = h[5];
+
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            markDead(it.value());
+            m_index.erase(it);
+        }
+
+        if (h[4] == tileRecord) {
+            Location location;
+            location.segment = id;
+            location.offset = quint32(segment.size + recordHeaderSize + pluginLength + formatLength);
+            location.size = size;
+            location.recordSize = quint32(recordSize);
+            location.timestamp = qFromLittleEndian<quint32>(h + 28);
+            location.format = formatId(QString::fromLatin1(names.mid(pluginLength)));
+            m_index.insert(key, location);
+            segment.live += recordSize;
+        }
+
+        segment.size += recordSize;
+        if (!file.seek(segment.size))
+            break;
+    }
+
+    // Drop whatever a crash left half written
+    if (segment.size < fileSize)
+        file.resize(segment.size);
+    return true;
+}
+
+bool QGeoTileSegmentStore::writeIndex()
+{
+    QSaveFile file(indexPath(m_directory));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << indexMagic << indexVersion;
+
+    stream << quint32(m_segments.size());
+    for (auto it = m_segments.cbegin(), end = m_segments.cend(); it != end; ++it)
+        stream << it.key() << it->size;
+
+    QHash<int, quint16> pluginIndex;
+    QVector<QString> plugins;
+    for (auto it = m_index.cbegin(), end = m_index.cend(); it != end; ++it) {
+        const int pluginId = it.key().spec.pluginId();
+        if (!pluginIndex.contains(pluginId)) {
+            pluginIndex.insert(pluginId, quint16(plugins.size()));
+            plugins.append(QGeoTileSpec::pluginName(pluginId));
+        }
+    }
+    stream << plugins << m_formats;
+
+    stream << quint32(m_index.size());
+    for (auto it = m_index.cbegin(), end = m_index.cend(); it != end; ++it) {
+        const QGeoTileSpec &spec = it.key().spec;
+        const Location &location = it.value();
+        stream << pluginIndex.value(spec.pluginId()) << quint8(it.key().variant) << location.format
+               << qint32(spec.mapId()) << qint32(spec.zoom()) << qint32(spec.x()) << qint32(spec.y())
+               << qint32(spec.version())
+               << location.segment << location.offset << location.size << location.recordSize
+               << location.timestamp;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILESEGMENTSTORE_P_H
+#define QGEOTILESEGMENTSTORE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "qgeotilespec_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Log structured disk storage for cached tiles.
+
+    Tiles are appended to segment files of bounded size instead of being
+    written one file per tile. Removing a tile appends a tombstone and marks
+    its bytes dead; sealed segments that are mostly dead are queued, and
+    compact() copies their live tiles forward and deletes them. Segments
+    pinned through acquire() are only deleted once released, so they can be
+    read without holding on to the store. All functions are thread safe.
+
+    The index is written as a single snapshot on close and read back on open,
+    so opening costs time proportional to the index, not to the number of
+    files. The snapshot stays in place until it is replaced; records written
+    after it, for example before a crash, are found by scanning only the
+    segment bytes it does not cover. Without a snapshot the index is rebuilt
+    by scanning all record headers.
+
+    Tiles are keyed by their spec and a small variant number, which lets a
+    plugin keep e.g. low and high dpi versions of the same tile apart.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileSegmentStore
+{
+public:
+    struct Entry
+    {
+        QGeoTileSpec spec;
+        int variant;
+        QString format;
+        int size;
+        qint64 timestamp; // seconds since epoch
+    };
+
+    explicit QGeoTileSegmentStore(const QString &directory);
+    ~QGeoTileSegmentStore();
+
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    bool insert(const QGeoTileSpec &spec, int variant, const QString &format, const QByteArray &bytes);
+    bool remove(const QGeoTileSpec &spec, int variant = 0);
+    bool contains(const QGeoTileSpec &spec, int variant = 0) const;
+    QByteArray read(const QGeoTileSpec &spec, int variant = 0, QString *format = nullptr) const;
+    bool locate(const QGeoTileSpec &spec, int variant, QString *fileName, qint64 *offset, int *size,
+                QString *format = nullptr) const;
+    bool acquire(const QGeoTileSpec &spec, int variant, QString *fileName, qint64 *offset, int *size);
+    void release(const QString &fileName);
+    QVector<Entry> entries() const;
+    void clear();
+
+    int tileCount() const;
+    qint64 diskUsage() const;
+
+    void setMaxSegmentSize(qint64 size);
+    qint64 maxSegmentSize() const;
+
+    bool compactionPending() const;
+    void compact();
+
+private:
+    struct Key
+    {
+        QGeoTileSpec spec;
+        int variant;
+
+        bool operator==(const Key &other) const
+        {
+            return variant == other.variant && spec == other.spec;
+        }
+        friend uint qHash(const Key &key, uint seed = 0)
+        {
+            return ::qHash(key.spec, seed) ^ uint(key.variant);
+        }
+    };
+
+    struct Location
+    {
+        quint32 segment;
+        quint32 offset;     // of the tile bytes
+        quint32 size;       // of the tile bytes
+        quint32 recordSize; // header, names and tile bytes
+        quint32 timestamp;
+        quint16 format;
+    };
+
+    struct Segment
+    {
+        qint64 size;
+        qint64 live;
+    };
+
+    QString segmentPath(quint32 id) const;
+    bool startSegment();
+    bool appendRecord(bool tombstone, const Key &key, quint16 format, const QByteArray &bytes,
+                      quint32 timestamp, Location *location);
+    QByteArray readLocation(const Location &location) const;
+    void markDead(const Location &location);
+    void maybeCompact(quint32 segment);
+    bool compactSegment(QMutexLocker *locker, quint32 segment);
+    quint16 formatId(const QString &format);
+
+    bool loadIndex();
+    bool rebuildIndex();
+    bool scanSegment(quint32 id, qint64 from);
+    bool writeIndex();
+
+    QString m_directory;
+    QHash<Key, Location> m_index;
+    QMap<quint32, Segment> m_segments;
+    QVector<QString> m_formats;
+    QHash<quint32, int> m_pins;
+    QVector<quint32> m_compactQueue;
+    mutable QMutex m_lock;
+    QFile m_active;
+    quint32 m_activeId;
+    qint64 m_maxSegmentSize;
+    int m_generation; // bumped whenever segment ids may be reused
+    bool m_open;
+
+    Q_DISABLE_COPY(QGeoTileSegmentStore)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILESEGMENTSTORE_P_H
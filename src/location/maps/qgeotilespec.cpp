@@ -35,107 +35,120 @@
 ****************************************************************************/
 
 #include "qgeotilespec_p.h"
-#include "qgeotilespec_p_p.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
-QGeoTileSpec::QGeoTileSpec()
-    : d(QSharedDataPointer<QGeoTileSpecPrivate>(new QGeoTileSpecPrivate())) {}
+namespace {
+
+// There is one entry per geo service plugin, so this stays tiny. Id 0 is the null plugin.
+class QGeoTilePluginRegistry
+{
+public:
+    QGeoTilePluginRegistry()
+    {
+        names.append(QString());
+    }
+
+    int idFor(const QString &plugin)
+    {
+        if (plugin.isEmpty())
+            return 0;
+        {
+            QReadLocker locker(&lock);
+            const int id = ids.value(plugin, -1);
+            if (id != -1)
+                return id;
+        }
+        QWriteLocker locker(&lock);
+        const int id = ids.value(plugin, -1);
+        if (id != -1)
+            return id;
+        ids.insert(plugin, names.size());
+        names.append(plugin);
+        return names.size() - 1;
+    }
+
+    QString name(int id)
+    {
+        QReadLocker locker(&lock);
+        return names.value(id);
+    }
+
+private:
+    QReadWriteLock lock;
+    QHash<QString, int> ids;
+    QVector<QString> names;
+};
+
+inline quint64 mix64(quint64 h)
+{
+    // MurmurHash3 finalizer
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}
+
+}
+
+Q_GLOBAL_STATIC(QGeoTilePluginRegistry, pluginRegistry)
 
 QGeoTileSpec::QGeoTileSpec(const QString &plugin, int mapId, int zoom, int x, int y, int version)
-        : d(QSharedDataPointer<QGeoTileSpecPrivate>(new QGeoTileSpecPrivate(plugin, mapId, zoom, x, y, version))) {}
-
-QGeoTileSpec::QGeoTileSpec(const QGeoTileSpec &other)
-    : d(other.d) {}
-
-QGeoTileSpec::~QGeoTileSpec() {
-}
-
-QGeoTileSpec &QGeoTileSpec::operator = (const QGeoTileSpec &other)
-{
-    if (this == &other)
-        return *this;
-
-    d = other.d;
-    return *this;
-}
+    : m_pluginId(pluginIdFor(plugin)),
+      m_mapId(mapId),
+      m_zoom(zoom),
+      m_x(x),
+      m_y(y),
+      m_version(version) {}
 
 QString QGeoTileSpec::plugin() const
 {
-    return d->plugin_;
-}
-
-void QGeoTileSpec::setZoom(int zoom)
-{
-    d->zoom_ = zoom;
-}
-
-int QGeoTileSpec::zoom() const
-{
-    return d->zoom_;
+    return pluginName(m_pluginId);
 }
 
-void QGeoTileSpec::setX(int x)
+int QGeoTileSpec::pluginIdFor(const QString &plugin)
 {
-    d->x_ = x;
+    return pluginRegistry()->idFor(plugin);
 }
 
-int QGeoTileSpec::x() const
+QString QGeoTileSpec::pluginName(int pluginId)
 {
-    return d->x_;
-}
-
-void QGeoTileSpec::setY(int y)
-{
-    d->y_ = y;
-}
-
-int QGeoTileSpec::y() const
-{
-    return d->y_;
-}
-
-void QGeoTileSpec::setMapId(int mapId)
-{
-    d->mapId_ = mapId;
-}
-
-int QGeoTileSpec::mapId() const
-{
-    return d->mapId_;
-}
-
-void QGeoTileSpec::setVersion(int version)
-{
-    d->version_ = version;
-}
-
-int QGeoTileSpec::version() const
-{
-    return d->version_;
-}
-
-bool QGeoTileSpec::operator == (const QGeoTileSpec &rhs) const
-{
-    return (*(d.constData()) == *(rhs.d.constData()));
+    return pluginRegistry()->name(pluginId);
 }
 
+// Plugins are ordered by their ids, that is in the order they were first used
 bool QGeoTileSpec::operator < (const QGeoTileSpec &rhs) const
 {
-    return (*(d.constData()) < *(rhs.d.constData()));
+    if (m_pluginId != rhs.m_pluginId)
+        return m_pluginId < rhs.m_pluginId;
+    if (m_mapId != rhs.m_mapId)
+        return m_mapId < rhs.m_mapId;
+    if (m_zoom != rhs.m_zoom)
+        return m_zoom < rhs.m_zoom;
+    if (m_x != rhs.m_x)
+        return m_x < rhs.m_x;
+    if (m_y != rhs.m_y)
+        return m_y < rhs.m_y;
+    return m_version < rhs.m_version;
 }
 
-unsigned int qHash(const QGeoTileSpec &spec)
+unsigned int qHash(const QGeoTileSpec &spec, unsigned int seed)
 {
-    unsigned int result = (qHash(spec.plugin()) * 13) % 31;
-    result += ((spec.mapId() * 17) % 31) << 5;
-    result += ((spec.zoom() * 19) % 31) << 10;
-    result += ((spec.x() * 23) % 31) << 15;
-    result += ((spec.y() * 29) % 31) << 20;
-    result += (spec.version() % 3) << 25;
-    return result;
+    const quint64 position = (quint64(quint32(spec.x())) << 32) | quint32(spec.y());
+    const quint64 layer = (quint64(quint32(spec.zoom())) << 40)
+            ^ (quint64(quint32(spec.mapId())) << 20)
+            ^ (quint64(quint32(spec.pluginId())) << 52)
+            ^ quint32(spec.version());
+    // The seed goes through both mixes, so that it moves every bucket
+    const quint64 h = mix64(position ^ mix64(layer ^ seed));
+    return uint(h ^ (h >> 32));
 }
 
 QDebug operator<< (QDebug dbg, const QGeoTileSpec &spec)
@@ -144,98 +157,4 @@ QDebug operator<< (QDebug dbg, const QGeoTileSpec &spec)
     return dbg;
 }
 
-QGeoTileSpecPrivate::QGeoTileSpecPrivate()
-    : mapId_(0),
-    zoom_(-1),
-    x_(-1),
-    y_(-1),
-    version_(-1) {}
-
-QGeoTileSpecPrivate::QGeoTileSpecPrivate(const QGeoTileSpecPrivate &other)
-    : QSharedData(other),
-      plugin_(other.plugin_),
-      mapId_(other.mapId_),
-      zoom_(other.zoom_),
-      x_(other.x_),
-      y_(other.y_),
-      version_(other.version_) {}
-
-QGeoTileSpecPrivate::QGeoTileSpecPrivate(const QString &plugin, int mapId, int zoom, int x, int y, int version)
-    : plugin_(plugin),
-      mapId_(mapId),
-      zoom_(zoom),
-      x_(x),
-      y_(y),
-      version_(version) {}
-
-QGeoTileSpecPrivate::~QGeoTileSpecPrivate() {}
-
-QGeoTileSpecPrivate &QGeoTileSpecPrivate::operator = (const QGeoTileSpecPrivate &other)
-{
-    if (this == &other)
-        return *this;
-
-    plugin_ = other.plugin_;
-    mapId_ = other.mapId_;
-    zoom_ = other.zoom_;
-    x_ = other.x_;
-    y_ = other.y_;
-    version_ = other.version_;
-
-    return *this;
-}
-
-bool QGeoTileSpecPrivate::operator == (const QGeoTileSpecPrivate &rhs) const
-{
-    if (plugin_ != rhs.plugin_)
-        return false;
-
-    if (mapId_ != rhs.mapId_)
-        return false;
-
-    if (zoom_ != rhs.zoom_)
-        return false;
-
-    if (x_ != rhs.x_)
-        return false;
-
-    if (y_ != rhs.y_)
-        return false;
-
-    if (version_ != rhs.version_)
-        return false;
-
-    return true;
-}
-
-bool QGeoTileSpecPrivate::operator < (const QGeoTileSpecPrivate &rhs) const
-{
-    if (plugin_ < rhs.plugin_)
-        return true;
-    if (plugin_ > rhs.plugin_)
-        return false;
-
-    if (mapId_ < rhs.mapId_)
-        return true;
-    if (mapId_ > rhs.mapId_)
-        return false;
-
-    if (zoom_ < rhs.zoom_)
-        return true;
-    if (zoom_ > rhs.zoom_)
-        return false;
-
-    if (x_ < rhs.x_)
-        return true;
-    if (x_ > rhs.x_)
-        return false;
-
-    if (y_ < rhs.y_)
-        return true;
-    if (y_ > rhs.y_)
-        return false;
-
-    return (version_ < rhs.version_);
-}
-
 QT_END_NAMESPACE
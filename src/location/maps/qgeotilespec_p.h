@@ -52,47 +52,59 @@
 #include <QtCore/QMetaType>
 #include <QString>
 
-#include <QSharedDataPointer>
-
 QT_BEGIN_NAMESPACE
 
-class QGeoTileSpecPrivate;
-
+// Plain value type: the plugin name is interned into a small integer id, so
+// copying, comparing and hashing a tile spec never touches the heap.
 class Q_LOCATION_PRIVATE_EXPORT QGeoTileSpec
 {
 public:
-    QGeoTileSpec();
-    QGeoTileSpec(const QGeoTileSpec &other);
+    QGeoTileSpec()
+        : m_pluginId(0), m_mapId(0), m_zoom(-1), m_x(-1), m_y(-1), m_version(-1) {}
     QGeoTileSpec(const QString &plugin, int mapId, int zoom, int x, int y, int version = -1);
-    ~QGeoTileSpec();
-
-    QGeoTileSpec &operator = (const QGeoTileSpec &other);
 
     QString plugin() const;
+    int pluginId() const { return m_pluginId; }
 
-    void setZoom(int zoom);
-    int zoom() const;
+    void setZoom(int zoom) { m_zoom = zoom; }
+    int zoom() const { return m_zoom; }
 
-    void setX(int x);
-    int x() const;
+    void setX(int x) { m_x = x; }
+    int x() const { return m_x; }
 
-    void setY(int y);
-    int y() const;
+    void setY(int y) { m_y = y; }
+    int y() const { return m_y; }
 
-    void setMapId(int mapId);
-    int mapId() const;
+    void setMapId(int mapId) { m_mapId = mapId; }
+    int mapId() const { return m_mapId; }
 
-    void setVersion(int version);
-    int version() const;
+    void setVersion(int version) { m_version = version; }
+    int version() const { return m_version; }
 
-    bool operator == (const QGeoTileSpec &rhs) const;
+    bool operator == (const QGeoTileSpec &rhs) const
+    {
+        return m_x == rhs.m_x && m_y == rhs.m_y && m_zoom == rhs.m_zoom
+                && m_mapId == rhs.m_mapId && m_version == rhs.m_version
+                && m_pluginId == rhs.m_pluginId;
+    }
+    bool operator != (const QGeoTileSpec &rhs) const { return !operator==(rhs); }
     bool operator < (const QGeoTileSpec &rhs) const;
 
+    static int pluginIdFor(const QString &plugin);
+    static QString pluginName(int pluginId);
+
 private:
-    QSharedDataPointer<QGeoTileSpecPrivate> d;
+    int m_pluginId;
+    int m_mapId;
+    int m_zoom;
+    int m_x;
+    int m_y;
+    int m_version;
 };
 
-Q_LOCATION_PRIVATE_EXPORT unsigned int qHash(const QGeoTileSpec &spec);
+Q_DECLARE_TYPEINFO(QGeoTileSpec, Q_PRIMITIVE_TYPE);
+
+Q_LOCATION_PRIVATE_EXPORT unsigned int qHash(const QGeoTileSpec &spec, unsigned int seed = 0);
 
 Q_LOCATION_PRIVATE_EXPORT QDebug operator<<(QDebug, const QGeoTileSpec &);
 
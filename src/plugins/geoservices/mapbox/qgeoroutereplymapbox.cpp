@@ -122,11 +122,20 @@ void QGeoRouteReplyMapbox::networkReplyFinished()
     QGeoRoutingManagerEngineMapbox *engine = qobject_cast<QGeoRoutingManagerEngineMapbox *>(parent());
     const QGeoRouteParser *parser = engine->routeParser();
 
-    QList<QGeoRoute> routes;
-    QString errorString;
+    // Large routes take a while to parse, keep the thread of the reply responsive
+    const QByteArray routeReply = reply->readAll();
+    QGeoRouteParseJob *job = parser->parseReplyAsync(routeReply);
+    connect(job, &QGeoRouteParseJob::finished, this, [this, job, routeReply]() {
+        parseFinished(job, routeReply);
+    });
+    connect(this, &QGeoRouteReply::aborted, job, &QGeoRouteParseJob::abort);
+}
 
-    QByteArray routeReply = reply->readAll();
-    QGeoRouteReply::Error error = parser->parseReply(routes, errorString, routeReply);
+void QGeoRouteReplyMapbox::parseFinished(QGeoRouteParseJob *job, const QByteArray &routeReply)
+{
+    QList<QGeoRoute> routes = job->routes();
+    const QString errorString = job->errorString();
+    const QGeoRouteReply::Error error = job->error();
     // Setting the request into the result
     for (QGeoRoute &route : routes) {
         route.setRequest(request());
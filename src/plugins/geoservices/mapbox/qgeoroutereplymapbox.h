@@ -46,6 +46,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QGeoRouteParseJob;
+
 class QGeoRouteReplyMapbox : public QGeoRouteReply
 {
     Q_OBJECT
@@ -58,6 +60,9 @@ public:
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
+
+private:
+    void parseFinished(QGeoRouteParseJob *job, const QByteArray &routeReply);
 };
 
 QT_END_NAMESPACE
@@ -42,6 +42,7 @@
 #include <QDateTime>
 #include <QtConcurrent>
 #include <QThread>
+#include <QFutureWatcher>
 
 QT_BEGIN_NAMESPACE
 
@@ -51,6 +52,8 @@ QGeoFileTileCacheOsm::QGeoFileTileCacheOsm(const QVector<QGeoTileProviderOsm *>
                                            QObject *parent)
 :   QGeoFileTileCache(directory, parent), m_offlineDirectory(offlineDirectory), m_offlineData(false), m_providers(providers)
 {
+    // Offline tiles and the disk cache are read in the background
+    setAsyncDecoding(true);
     m_highDpi.resize(providers.size());
     if (!offlineDirectory.isEmpty()) {
         m_offlineDirectory = QDir(offlineDirectory);
@@ -79,6 +82,122 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::get(const QGeoTileSpec &sp
     return getFromDisk(spec);
 }
 
+/*
+    Uses the tile archive \a fileName as offline storage instead of scanning the
+    offline directory. Returns false if the archive cannot be opened.
+*/
+bool QGeoFileTileCacheOsm::setOfflineArchive(const QString &fileName)
+{
+    if (!m_offlineArchive.open(fileName)) {
+        qWarning() << "QGeoFileTileCacheOsm: cannot open offline archive" << fileName
+                   << ":" << m_offlineArchive.errorString();
+        return false;
+    }
+    m_offlineData = true;
+    return true;
+}
+
+/*
+    Packs the tiles of \a offlineDirectory into the tile archive \a archiveFileName.
+    When a tile is present in more than one version, the newest one is kept.
+*/
+bool QGeoFileTileCacheOsm::buildOfflineArchive(const QString &offlineDirectory,
+                                               const QString &archiveFileName,
+                                               QString *errorString)
+{
+    // key -> (version, file)
+    QHash<quint64, QPair<int, QString> > tiles;
+
+    QDirIterator it(offlineDirectory, QDir::Files);
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        const QString name = it.fileName().section(QLatin1Char('.'), 0, 0);
+        const QStringList fields = name.split(QLatin1Char('-'));
+        if (fields.length() != 6 && fields.length() != 7)
+            continue;
+        if (fields.at(1) != QLatin1String("h") && fields.at(1) != QLatin1String("l"))
+            continue;
+
+        int numbers[5] = { 0, 0, 0, 0, -1 };
+        bool ok = true;
+        for (int i = 2; i < fields.length() && ok; ++i)
+            numbers[i - 2] = fields.at(i).toInt(&ok);
+
+        quint64 key;
+        const int variant = fields.at(1) == QLatin1String("h") ? 1 : 0;
+        if (!ok || !QGeoTileArchive::tileKey(numbers[0], numbers[1], numbers[2], numbers[3], variant, &key))
+            continue;
+
+        auto existing = tiles.find(key);
+        if (existing == tiles.end())
+            tiles.insert(key, qMakePair(numbers[4], filePath));
+        else if (numbers[4] > existing->first)
+            *existing = qMakePair(numbers[4], filePath);
+    }
+
+    QGeoTileArchiveWriter writer;
+    for (auto tile = tiles.cbegin(), end = tiles.cend(); tile != end; ++tile) {
+        const quint64 key = tile.key();
+        writer.addTile(int(key >> 56), int((key >> 48) & 0x1f), int((key >> 24) & 0xffffff),
+                       int(key & 0xffffff), int((key >> 53) & 0x7), tile->second);
+    }
+
+    if (!writer.write(archiveFileName)) {
+        if (errorString)
+            *errorString = writer.errorString();
+        return false;
+    }
+    return true;
+}
+
+/*
+    Packs the offline directory into the tile archive \a archiveFileName on a
+    separate thread, and uses the archive once it is written. Until then, the
+    tiles are read from the directory.
+*/
+void QGeoFileTileCacheOsm::buildOfflineArchiveInBackground(const QString &archiveFileName)
+{
+    typedef QPair<bool, QString> Result;
+    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, archiveFileName]() {
+        const Result result = watcher->result();
+        if (result.first)
+            setOfflineArchive(archiveFileName);
+        else
+            qWarning() << "Cannot build offline tile archive" << archiveFileName << ":" << result.second;
+        watcher->deleteLater();
+    });
+
+    const QString offlineDirectory = m_offlineDirectory.absolutePath();
+    watcher->setFuture(QtConcurrent::run([offlineDirectory, archiveFileName]() {
+        QString errorString;
+        const bool built = buildOfflineArchive(offlineDirectory, archiveFileName, &errorString);
+        return Result(built, errorString);
+    }));
+}
+
+// The asynchronous counterpart of getFromOfflineStorage()
+bool QGeoFileTileCacheOsm::locateTile(const QGeoTileSpec &spec, QString *fileName, qint64 *offset, int *length)
+{
+    if (!m_offlineData)
+        return false;
+
+    int providerId = spec.mapId() - 1;
+    if (providerId < 0 || providerId >= m_providers.size())
+        return false;
+
+    if (m_offlineArchive.isOpen()) {
+        const int variant = m_providers[providerId]->isHighDpi() ? 1 : 0;
+        if (!m_offlineArchive.locate(spec.mapId(), spec.zoom(), spec.x(), spec.y(), variant, offset, length))
+            return false;
+        *fileName = m_offlineArchive.fileName();
+        return true;
+    }
+
+    *fileName = m_offlineDirectory.absoluteFilePath(tileSpecToFilename(spec, QStringLiteral("*"), providerId));
+    return true;
+}
+
 void QGeoFileTileCacheOsm::onProviderResolutionFinished(const QGeoTileProviderOsm *provider)
 {
     clearObsoleteTiles(provider);
@@ -140,6 +259,17 @@ void QGeoFileTileCacheOsm::init()
     // Base class ::init()
     QGeoFileTileCache::init();
 
+    if (segmentStore_) {
+        for (const QGeoTileSegmentStore::Entry &entry : segmentStore_->entries()) {
+            const int mapId = entry.spec.mapId();
+            if (mapId < 0 || mapId >= m_maxMapIdTimestamps.size())
+                continue;
+            const QDateTime modified = QDateTime::fromSecsSinceEpoch(entry.timestamp);
+            if (modified > m_maxMapIdTimestamps[mapId])
+                m_maxMapIdTimestamps[mapId] = modified;
+        }
+    }
+
     for (QGeoTileProviderOsm * p: m_providers)
         clearObsoleteTiles(p);
 }
@@ -153,6 +283,21 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(cons
     if (providerId < 0 || providerId >= m_providers.size())
         return QSharedPointer<QGeoTileTexture>();
 
+    if (m_offlineArchive.isOpen()) {
+        // The archive is mapped already, so the bytes skip the memory cache
+        const int variant = m_providers[providerId]->isHighDpi() ? 1 : 0;
+        const QByteArray bytes = m_offlineArchive.tileData(spec.mapId(), spec.zoom(), spec.x(), spec.y(), variant);
+        if (bytes.isEmpty())
+            return QSharedPointer<QGeoTileTexture>();
+
+        QImage image;
+        if (!image.loadFromData(bytes)) {
+            handleError(spec, QLatin1String("Problem with tile image"));
+            return QSharedPointer<QGeoTileTexture>(0);
+        }
+        return addToTextureCache(spec, image);
+    }
+
     const QString fileName = tileSpecToFilename(spec, QStringLiteral("*"), providerId);
     QStringList validTiles = m_offlineDirectory.entryList({fileName});
     if (!validTiles.size())
@@ -190,11 +335,19 @@ void QGeoFileTileCacheOsm::dropTiles(int mapId)
     keys = diskCache_.keys();
     for (const QGeoTileSpec &k : keys)
         if (k.mapId() == mapId)
-            diskCache_.remove(k);
+            removeFromDiskCache(k);
 }
 
 void QGeoFileTileCacheOsm::loadTiles(int mapId)
 {
+    if (segmentStore_) {
+        for (const QGeoTileSegmentStore::Entry &entry : segmentStore_->entries()) {
+            if (entry.spec.mapId() == mapId && entry.variant == diskVariant(entry.spec))
+                addToDiskCache(entry.spec, entry.variant, entry.format, entry.size);
+        }
+        return;
+    }
+
     QStringList formats;
     formats << QLatin1String("*.*");
 
@@ -245,6 +398,15 @@ QString QGeoFileTileCacheOsm::tileSpecToFilename(const QGeoTileSpec &spec, const
     return filename;
 }
 
+// Low and high dpi tiles are stored side by side, like the 'l' and 'h' in the file names
+int QGeoFileTileCacheOsm::diskVariant(const QGeoTileSpec &spec) const
+{
+    const int providerId = spec.mapId() - 1;
+    if (providerId < 0 || providerId >= m_providers.size())
+        return 0;
+    return m_providers[providerId]->isHighDpi() ? 1 : 0;
+}
+
 QGeoTileSpec QGeoFileTileCacheOsm::filenameToTileSpec(const QString &filename) const
 {
     QGeoTileSpec emptySpec;
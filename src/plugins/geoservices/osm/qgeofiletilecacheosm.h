@@ -39,6 +39,7 @@
 
 #include "qgeotileproviderosm.h"
 #include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeotilearchive_p.h>
 #include <QHash>
 #include <QtConcurrent>
 #include <qatomic.h>
@@ -57,6 +58,11 @@ public:
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
 
+    bool setOfflineArchive(const QString &fileName);
+    static bool buildOfflineArchive(const QString &offlineDirectory, const QString &archiveFileName,
+                                    QString *errorString = nullptr);
+    void buildOfflineArchiveInBackground(const QString &archiveFileName);
+
 Q_SIGNALS:
     void mapDataUpdated(int mapId);
 
@@ -69,6 +75,8 @@ protected:
     inline QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, int providerId) const;
     QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const override;
     QGeoTileSpec filenameToTileSpec(const QString &filename) const override;
+    int diskVariant(const QGeoTileSpec &spec) const override;
+    bool locateTile(const QGeoTileSpec &spec, QString *fileName, qint64 *offset, int *length) override;
     QSharedPointer<QGeoTileTexture> getFromOfflineStorage(const QGeoTileSpec &spec);
     void dropTiles(int mapId);
     void loadTiles(int mapId);
@@ -76,6 +84,7 @@ protected:
     void clearObsoleteTiles(const QGeoTileProviderOsm *p);
 
     QDir m_offlineDirectory;
+    QGeoTileArchive m_offlineArchive;
     bool m_offlineData;
     QVector<QGeoTileProviderOsm *> m_providers;
     QVector<bool> m_highDpi;
@@ -72,9 +72,17 @@ void QGeoRouteReplyOsm::networkReplyFinished()
     QGeoRoutingManagerEngineOsm *engine = qobject_cast<QGeoRoutingManagerEngineOsm *>(parent());
     const QGeoRouteParser *parser = engine->routeParser();
 
-    QList<QGeoRoute> routes;
-    QString errorString;
-    QGeoRouteReply::Error error = parser->parseReply(routes, errorString, reply->readAll());
+    // Large routes take a while to parse, keep the thread of the reply responsive
+    QGeoRouteParseJob *job = parser->parseReplyAsync(reply->readAll());
+    connect(job, &QGeoRouteParseJob::finished, this, [this, job]() { parseFinished(job); });
+    connect(this, &QGeoRouteReply::aborted, job, &QGeoRouteParseJob::abort);
+}
+
+void QGeoRouteReplyOsm::parseFinished(QGeoRouteParseJob *job)
+{
+    QList<QGeoRoute> routes = job->routes();
+    const QString errorString = job->errorString();
+    const QGeoRouteReply::Error error = job->error();
     // Setting the request into the result
     for (QGeoRoute &route : routes) {
         route.setRequest(request());
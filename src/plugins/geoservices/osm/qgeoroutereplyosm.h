@@ -45,6 +45,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QGeoRouteParseJob;
+
 class QGeoRouteReplyOsm : public QGeoRouteReply
 {
     Q_OBJECT
@@ -57,6 +59,9 @@ public:
 private Q_SLOTS:
     void networkReplyFinished();
     void networkReplyError(QNetworkReply::NetworkError error);
+
+private:
+    void parseFinished(QGeoRouteParseJob *job);
 };
 
 QT_END_NAMESPACE
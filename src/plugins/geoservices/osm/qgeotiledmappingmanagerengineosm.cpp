@@ -49,11 +49,13 @@
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkDiskCache>
+#include <QFileInfo>
 
 QT_BEGIN_NAMESPACE
 
 QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVariantMap &parameters, QGeoServiceProvider::Error *error, QString *errorString)
-:   QGeoTiledMappingManagerEngine()
+:   QGeoTiledMappingManagerEngine(), m_tileAtlas(false), m_detailThreshold(0.0),
+    m_extrudedPolylines(false)
 {
     QGeoCameraCapabilities cameraCaps;
     cameraCaps.setMinimumZoomLevel(0.0);
@@ -252,6 +254,16 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         m_offlineDirectory = parameters.value(QStringLiteral("osm.mapping.offline.directory")).toString();
     QGeoFileTileCacheOsm *tileCache = new QGeoFileTileCacheOsm(m_providers, m_offlineDirectory, m_cacheDirectory);
 
+    if (parameters.contains(QStringLiteral("osm.mapping.offline.archive"))) {
+        const QString archive = parameters.value(QStringLiteral("osm.mapping.offline.archive")).toString();
+        // Convert the offline directory the first time an archive is requested for it,
+        // in the background. The directory is used until the archive is ready.
+        if (!QFileInfo::exists(archive) && !m_offlineDirectory.isEmpty())
+            tileCache->buildOfflineArchiveInBackground(archive);
+        else
+            tileCache->setOfflineArchive(archive);
+    }
+
     /*
      * Disk cache setup -- defaults to ByteSize (old behavior)
      */
@@ -264,6 +276,13 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
     } else {
         tileCache->setCostStrategyDisk(QGeoFileTileCache::ByteSize);
     }
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.disk.storage"))) {
+        QString storage = parameters.value(QStringLiteral("osm.mapping.cache.disk.storage")).toString().toLower();
+        if (storage == QLatin1String("segments"))
+            tileCache->setDiskStorage(QGeoFileTileCache::SegmentFiles);
+        else
+            tileCache->setDiskStorage(QGeoFileTileCache::TileFiles);
+    }
     if (parameters.contains(QStringLiteral("osm.mapping.cache.disk.size"))) {
         bool ok = false;
         int cacheSize = parameters.value(QStringLiteral("osm.mapping.cache.disk.size")).toString().toInt(&ok);
@@ -319,6 +338,14 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         const QByteArray ua = parameters.value(QStringLiteral("osm.useragent")).toString().toLatin1();
         tileFetcher->setUserAgent(ua);
     }
+    // Be nice to the tile servers, see their usage policies
+    tileFetcher->setMaxConcurrentRequests(6);
+    if (parameters.contains(QStringLiteral("osm.mapping.max_concurrent_requests"))) {
+        bool ok = false;
+        int maxRequests = parameters.value(QStringLiteral("osm.mapping.max_concurrent_requests")).toString().toInt(&ok);
+        if (ok)
+            tileFetcher->setMaxConcurrentRequests(maxRequests);
+    }
     setTileFetcher(tileFetcher);
 
     /* PREFETCHING */
@@ -331,6 +358,16 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
     }
+    if (parameters.contains(QStringLiteral("osm.mapping.tile_atlas")))
+        m_tileAtlas = parameters.value(QStringLiteral("osm.mapping.tile_atlas")).toBool();
+    if (parameters.contains(QStringLiteral("osm.mapping.detail_threshold"))) {
+        bool ok = false;
+        const double threshold = parameters.value(QStringLiteral("osm.mapping.detail_threshold")).toString().toDouble(&ok);
+        if (ok && threshold >= 0.0)
+            m_detailThreshold = threshold;
+    }
+    if (parameters.contains(QStringLiteral("osm.mapping.extruded_polylines")))
+        m_extrudedPolylines = parameters.value(QStringLiteral("osm.mapping.extruded_polylines")).toBool();
 
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
@@ -346,6 +383,9 @@ QGeoMap *QGeoTiledMappingManagerEngineOsm::createMap()
     connect(qobject_cast<QGeoFileTileCacheOsm *>(tileCache()), &QGeoFileTileCacheOsm::mapDataUpdated
             , map, &QGeoTiledMap::clearScene);
     map->setPrefetchStyle(m_prefetchStyle);
+    map->setTileAtlasEnabled(m_tileAtlas);
+    map->setDetailThreshold(m_detailThreshold);
+    map->setExtrudedPolylinesEnabled(m_extrudedPolylines);
     return map;
 }
 
@@ -75,6 +75,9 @@ private:
     QString m_customCopyright;
     QString m_cacheDirectory;
     QString m_offlineDirectory;
+    bool m_tileAtlas;
+    double m_detailThreshold; // 0 when disabled
+    bool m_extrudedPolylines;
 };
 
 QT_END_NAMESPACE
@@ -46,11 +46,34 @@
 #include <QtCore/qtimer.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qmutex.h>
+#include <QtCore/qvector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #define UPDATE_INTERVAL_5S  5000
 
-typedef QHash<QString, QGeoAreaMonitorInfo> MonitorTable;
+/*
+ * Monitors are bucketed by their bounding box on a fixed latitude/longitude
+ * grid. A position fix is only tested against the monitors of its own cell,
+ * the few monitors too large to bucket and the monitors it is currently
+ * inside of, instead of against every active monitor.
+ */
+static const int gridCellsPerDegree = 10;
+static const int gridColumns = 360 * gridCellsPerDegree;
+static const int gridRows = 180 * gridCellsPerDegree;
+static const int maxIndexedCells = 256;
+
+static int gridColumn(double longitude)
+{
+    return qBound(0, int(std::floor((longitude + 180.0) * gridCellsPerDegree)), gridColumns - 1);
+}
 
+static int gridRow(double latitude)
+{
+    return qBound(0, int(std::floor((latitude + 90.0) * gridCellsPerDegree)), gridRows - 1);
+}
 
 static QMetaMethod areaEnteredSignal()
 {
@@ -74,7 +97,7 @@ class QGeoAreaMonitorPollingPrivate : public QObject
 {
     Q_OBJECT
 public:
-    QGeoAreaMonitorPollingPrivate() : source(0), mutex(QMutex::Recursive)
+    QGeoAreaMonitorPollingPrivate() : source(0), visitCounter(0), mutex(QMutex::Recursive)
     {
         nextExpiryTimer = new QTimer(this);
         nextExpiryTimer->setSingleShot(true);
@@ -86,8 +109,7 @@ public:
     {
         QMutexLocker locker(&mutex);
 
-        activeMonitorAreas.insert(monitor.identifier(), monitor);
-        singleShotTrigger.remove(monitor.identifier());
+        insertMonitor(monitor, -1);
 
         checkStartStop();
         setupNextExpiryTimeout();
@@ -97,8 +119,7 @@ public:
     {
         QMutexLocker locker(&mutex);
 
-        activeMonitorAreas.insert(monitor.identifier(), monitor);
-        singleShotTrigger.insert(monitor.identifier(), signalId);
+        insertMonitor(monitor, signalId);
 
         checkStartStop();
         setupNextExpiryTimeout();
@@ -108,7 +129,10 @@ public:
     {
         QMutexLocker locker(&mutex);
 
-        QGeoAreaMonitorInfo mon = activeMonitorAreas.take(monitor.identifier());
+        QGeoAreaMonitorInfo mon;
+        const int handle = handles.value(monitor.identifier(), -1);
+        if (handle >= 0)
+            mon = removeMonitor(handle);
 
         checkStartStop();
         setupNextExpiryTimeout();
@@ -173,11 +197,29 @@ public:
         return source;
     }
 
-    MonitorTable activeMonitors() const
+    QList<QGeoAreaMonitorInfo> activeMonitors() const
+    {
+        QMutexLocker locker(&mutex);
+
+        QList<QGeoAreaMonitorInfo> result;
+        result.reserve(handles.size());
+        for (const Monitor &m : monitors) {
+            if (m.inUse)
+                result.append(m.info);
+        }
+        return result;
+    }
+
+    QList<QGeoAreaMonitorInfo> activeMonitors(const QGeoShape &region) const
     {
         QMutexLocker locker(&mutex);
 
-        return activeMonitorAreas;
+        QList<QGeoAreaMonitorInfo> result;
+        for (const Monitor &m : monitors) {
+            if (m.inUse && region.contains(m.info.area().center()))
+                result.append(m.info);
+        }
+        return result;
     }
 
     void checkStartStop()
@@ -192,7 +234,7 @@ public:
             }
         }
 
-        if (signalsConnected && !activeMonitorAreas.isEmpty()) {
+        if (signalsConnected && !handles.isEmpty()) {
             if (source)
                 source->startUpdates();
             else
@@ -205,67 +247,199 @@ public:
     }
 
 private:
-    void setupNextExpiryTimeout()
+    struct Monitor
     {
-        nextExpiryTimer->stop();
-        activeExpiry.first = QDateTime();
-        activeExpiry.second = QString();
-
-        foreach (const QGeoAreaMonitorInfo &info, activeMonitors()) {
-            if (info.expiration().isValid()) {
-                if (!activeExpiry.first.isValid()) {
-                    activeExpiry.first = info.expiration();
-                    activeExpiry.second = info.identifier();
-                    continue;
-                }
-                if (info.expiration() < activeExpiry.first) {
-                    activeExpiry.first = info.expiration();
-                    activeExpiry.second = info.identifier();
-                }
-            }
+        QGeoAreaMonitorInfo info;
+        QVector<int> cells;         // grid cells the monitor is listed in
+        int singleShotSignal = -1;  // signal that finishes a requestUpdate() monitor
+        int insideIndex = -1;       // position in insideHandles, -1 when outside
+        quint32 generation = 0;     // bumped on every change, invalidates expiry entries
+        quint32 lastVisit = 0;
+        bool large = false;
+        bool inUse = false;
+    };
+
+    struct ExpiryEntry
+    {
+        qint64 msecs;
+        int handle;
+        quint32 generation;
+    };
+
+    // Heap comparator: the earliest expiry ends up on top
+    struct ExpiryLater
+    {
+        bool operator()(const ExpiryEntry &a, const ExpiryEntry &b) const
+        {
+            return a.msecs > b.msecs;
         }
+    };
 
-        if (activeExpiry.first.isValid())
-            nextExpiryTimer->start(QDateTime::currentDateTime().msecsTo(activeExpiry.first));
+    // Adds the monitor or updates the one with the same identifier in place,
+    // keeping its handle and its inside/outside state.
+    void insertMonitor(const QGeoAreaMonitorInfo &info, int singleShotSignal)
+    {
+        int handle = handles.value(info.identifier(), -1);
+        if (handle >= 0) {
+            unindexMonitor(handle);
+        } else if (!freeHandles.isEmpty()) {
+            handle = freeHandles.takeLast();
+        } else {
+            handle = monitors.size();
+            monitors.append(Monitor());
+        }
+        handles.insert(info.identifier(), handle);
+
+        Monitor &m = monitors[handle];
+        m.info = info;
+        m.singleShotSignal = singleShotSignal;
+        m.inUse = true;
+        ++m.generation;
+
+        indexMonitor(handle);
+
+        if (info.expiration().isValid()) {
+            expiryHeap.append(ExpiryEntry{info.expiration().toMSecsSinceEpoch(),
+                                          handle, m.generation});
+            std::push_heap(expiryHeap.begin(), expiryHeap.end(), ExpiryLater());
+            if (expiryHeap.size() > 2 * handles.size() + 64)
+                compactExpiryHeap();
+        }
     }
 
+    QGeoAreaMonitorInfo removeMonitor(int handle)
+    {
+        Monitor &m = monitors[handle];
+        unindexMonitor(handle);
+        setInside(handle, false);
+
+        const QGeoAreaMonitorInfo info = m.info;
+        handles.remove(info.identifier());
+        m.info = QGeoAreaMonitorInfo();
+        m.singleShotSignal = -1;
+        m.inUse = false;
+        ++m.generation;
+        freeHandles.append(handle);
+
+        return info;
+    }
 
-    //returns true if areaEntered should be emitted
-    bool processInsideArea(const QString &monitorIdent)
+    void indexMonitor(int handle)
     {
-        if (!insideArea.contains(monitorIdent)) {
-            if (singleShotTrigger.value(monitorIdent, -1) == areaEnteredSignal().methodIndex()) {
-                //this is the finishing singleshot event
-                singleShotTrigger.remove(monitorIdent);
-                activeMonitorAreas.remove(monitorIdent);
-                setupNextExpiryTimeout();
-            } else {
-                insideArea.insert(monitorIdent);
+        Monitor &m = monitors[handle];
+
+        const QGeoRectangle bounds = m.info.area().boundingGeoRectangle();
+        if (!bounds.isValid()) {
+            m.large = true;
+            largeMonitors.append(handle);
+            return;
+        }
+
+        const int top = gridRow(bounds.topLeft().latitude());
+        const int bottom = gridRow(bounds.bottomRight().latitude());
+        const int left = gridColumn(bounds.topLeft().longitude());
+        const int right = gridColumn(bounds.bottomRight().longitude());
+        // a box crossing the dateline wraps around the last column
+        const int columns = left <= right ? right - left + 1 : gridColumns - left + right + 1;
+
+        if ((top - bottom + 1) * columns > maxIndexedCells) {
+            m.large = true;
+            largeMonitors.append(handle);
+            return;
+        }
+
+        m.large = false;
+        m.cells.reserve((top - bottom + 1) * columns);
+        for (int row = bottom; row <= top; ++row) {
+            for (int i = 0; i < columns; ++i) {
+                const int cell = row * gridColumns + (left + i) % gridColumns;
+                grid[cell].append(handle);
+                m.cells.append(cell);
             }
-            return true;
         }
+    }
 
-        return false;
+    void unindexMonitor(int handle)
+    {
+        Monitor &m = monitors[handle];
+
+        if (m.large) {
+            largeMonitors.removeOne(handle);
+            m.large = false;
+            return;
+        }
+
+        for (int cell : qAsConst(m.cells)) {
+            auto it = grid.find(cell);
+            if (it == grid.end())
+                continue;
+            it->removeOne(handle);
+            if (it->isEmpty())
+                grid.erase(it);
+        }
+        m.cells.clear();
     }
 
-    //returns true if areaExited should be emitted
-    bool processOutsideArea(const QString &monitorIdent)
+    void setInside(int handle, bool inside)
     {
-        if (insideArea.contains(monitorIdent)) {
-            if (singleShotTrigger.value(monitorIdent, -1) == areaExitedSignal().methodIndex()) {
-                //this is the finishing singleShot event
-                singleShotTrigger.remove(monitorIdent);
-                activeMonitorAreas.remove(monitorIdent);
-                setupNextExpiryTimeout();
-            } else {
-                insideArea.remove(monitorIdent);
+        Monitor &m = monitors[handle];
+        if (inside == (m.insideIndex >= 0))
+            return;
+
+        if (inside) {
+            m.insideIndex = insideHandles.size();
+            insideHandles.append(handle);
+        } else {
+            const int last = insideHandles.takeLast();
+            if (last != handle) {
+                insideHandles[m.insideIndex] = last;
+                monitors[last].insideIndex = m.insideIndex;
             }
-            return true;
+            m.insideIndex = -1;
         }
-        return false;
     }
 
+    bool isStale(const ExpiryEntry &entry) const
+    {
+        const Monitor &m = monitors.at(entry.handle);
+        return !m.inUse || m.generation != entry.generation;
+    }
+
+    void popExpiry()
+    {
+        std::pop_heap(expiryHeap.begin(), expiryHeap.end(), ExpiryLater());
+        expiryHeap.removeLast();
+    }
+
+    void compactExpiryHeap()
+    {
+        auto stale = [this](const ExpiryEntry &entry) { return isStale(entry); };
+        expiryHeap.erase(std::remove_if(expiryHeap.begin(), expiryHeap.end(), stale),
+                         expiryHeap.end());
+        std::make_heap(expiryHeap.begin(), expiryHeap.end(), ExpiryLater());
+    }
+
+    void setupNextExpiryTimeout()
+    {
+        nextExpiryTimer->stop();
 
+        while (!expiryHeap.isEmpty() && isStale(expiryHeap.first()))
+            popExpiry();
+
+        if (!expiryHeap.isEmpty()) {
+            const qint64 msecs = expiryHeap.first().msecs - QDateTime::currentMSecsSinceEpoch();
+            nextExpiryTimer->start(int(qBound<qint64>(0, msecs, std::numeric_limits<int>::max())));
+        }
+    }
+
+    void collectCandidate(int handle)
+    {
+        Monitor &m = monitors[handle];
+        if (m.lastVisit != visitCounter) {
+            m.lastVisit = visitCounter;
+            candidates.append(handle);
+        }
+    }
 
 Q_SIGNALS:
     void timeout(const QGeoAreaMonitorInfo &info);
@@ -279,33 +453,99 @@ private Q_SLOTS:
          * Don't block timer firing even if monitorExpiredSignal is not connected.
          * This allows us to continue to remove the existing monitors as they expire.
          **/
-        const QGeoAreaMonitorInfo info = activeMonitorAreas.take(activeExpiry.second);
-        setupNextExpiryTimeout();
-        emit timeout(info);
+        QList<QGeoAreaMonitorInfo> expired;
+        {
+            QMutexLocker locker(&mutex);
+
+            const qint64 now = QDateTime::currentMSecsSinceEpoch();
+            while (!expiryHeap.isEmpty()) {
+                const ExpiryEntry entry = expiryHeap.first();
+                const bool stale = isStale(entry);
+                if (!stale && entry.msecs > now)
+                    break;
+                popExpiry();
+                if (!stale)
+                    expired.append(removeMonitor(entry.handle));
+            }
+            setupNextExpiryTimeout();
+        }
 
+        for (const QGeoAreaMonitorInfo &info : qAsConst(expired))
+            emit timeout(info);
     }
 
     void positionUpdated(const QGeoPositionInfo &info)
     {
-        foreach (const QGeoAreaMonitorInfo &monInfo, activeMonitors()) {
-            const QString identifier = monInfo.identifier();
-            if (monInfo.area().contains(info.coordinate())) {
-                if (processInsideArea(identifier))
-                    emit areaEventDetected(monInfo, info, true);
-            } else {
-                if (processOutsideArea(identifier))
-                    emit areaEventDetected(monInfo, info, false);
+        QVector<QPair<QGeoAreaMonitorInfo, bool> > events;
+        {
+            QMutexLocker locker(&mutex);
+
+            if (++visitCounter == 0) {
+                for (Monitor &m : monitors)
+                    m.lastVisit = 0;
+                visitCounter = 1;
             }
+
+            const QGeoCoordinate coordinate = info.coordinate();
+            candidates.clear();
+            if (coordinate.isValid()) {
+                const int cell = gridRow(coordinate.latitude()) * gridColumns
+                        + gridColumn(coordinate.longitude());
+                const auto it = grid.constFind(cell);
+                if (it != grid.constEnd()) {
+                    for (int handle : *it)
+                        collectCandidate(handle);
+                }
+            }
+            for (int handle : qAsConst(largeMonitors))
+                collectCandidate(handle);
+            for (int handle : qAsConst(insideHandles))
+                collectCandidate(handle);
+
+            // report events in a stable order
+            std::sort(candidates.begin(), candidates.end());
+
+            bool removed = false;
+            for (int handle : qAsConst(candidates)) {
+                Monitor &m = monitors[handle];
+                const bool inside = m.info.area().contains(coordinate);
+                if (inside == (m.insideIndex >= 0))
+                    continue;
+
+                events.append(qMakePair(m.info, inside));
+
+                const int finishingSignal = inside ? areaEnteredSignal().methodIndex()
+                                                   : areaExitedSignal().methodIndex();
+                if (m.singleShotSignal == finishingSignal) {
+                    //this is the finishing singleshot event
+                    removeMonitor(handle);
+                    removed = true;
+                } else {
+                    setInside(handle, inside);
+                }
+            }
+
+            if (removed)
+                setupNextExpiryTimeout();
         }
+
+        for (const auto &event : qAsConst(events))
+            emit areaEventDetected(event.first, info, event.second);
     }
 
 private:
-    QPair<QDateTime, QString> activeExpiry;
-    QHash<QString, int> singleShotTrigger;
-    QTimer* nextExpiryTimer;
-    QSet<QString> insideArea;
+    QVector<Monitor> monitors;
+    QVector<int> freeHandles;
+    QHash<QString, int> handles;
+
+    QHash<int, QVector<int> > grid;
+    QVector<int> largeMonitors;
+    QVector<int> insideHandles;
+    QVector<int> candidates;
+    quint32 visitCounter;
 
-    MonitorTable activeMonitorAreas;
+    QVector<ExpiryEntry> expiryHeap;
+    QTimer* nextExpiryTimer;
 
     QGeoPositionInfoSource* source;
     QList<QGeoAreaMonitorPolling*> registeredClients;
@@ -415,22 +655,15 @@ bool QGeoAreaMonitorPolling::stopMonitoring(const QGeoAreaMonitorInfo &monitor)
 
 QList<QGeoAreaMonitorInfo> QGeoAreaMonitorPolling::activeMonitors() const
 {
-    return d->activeMonitors().values();
+    return d->activeMonitors();
 }
 
 QList<QGeoAreaMonitorInfo> QGeoAreaMonitorPolling::activeMonitors(const QGeoShape &region) const
 {
-    QList<QGeoAreaMonitorInfo> results;
     if (region.isEmpty())
-        return results;
-
-    const MonitorTable list = d->activeMonitors();
-    foreach (const QGeoAreaMonitorInfo &monitor, list) {
-        if (region.contains(monitor.area().center()))
-            results.append(monitor);
-    }
+        return QList<QGeoAreaMonitorInfo>();
 
-    return results;
+    return d->activeMonitors(region);
 }
 
 QGeoAreaMonitorSource::AreaMonitorFeatures QGeoAreaMonitorPolling::supportedAreaMonitorFeatures() const
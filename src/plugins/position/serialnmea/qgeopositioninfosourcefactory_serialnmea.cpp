@@ -39,35 +39,88 @@
 
 #include "qgeopositioninfosourcefactory_serialnmea.h"
 #include <QtPositioning/qnmeapositioninfosource.h>
+#include <QtPositioning/private/qnmeasatelliteinfosource_p.h>
 #include <QtSerialPort/qserialport.h>
 #include <QtSerialPort/qserialportinfo.h>
 #include <QtCore/qloggingcategory.h>
 #include <QSet>
+#include <QVector>
 
 Q_LOGGING_CATEGORY(lcSerial, "qt.positioning.serialnmea")
 
-class NmeaSource : public QNmeaPositionInfoSource
+class NmeaSource;
+
+/*
+    Owns the serial port, which can only be opened once, and the one NMEA
+    source parsing it. Every source created by the plugin keeps a reference
+    to it: the satellite sources attach to the NMEA source, the position
+    sources forward its updates. The port is closed when the last source is
+    destroyed.
+*/
+class NmeaSerialPort
 {
 public:
-    NmeaSource(QObject *parent);
-    bool isValid() const { return !m_port.isNull(); }
+    static QSharedPointer<NmeaSerialPort> open();
+
+    QNmeaPositionInfoSource *source() { return &m_source; }
+
+    void addPositionSource(NmeaSource *source);
+    void removePositionSource(NmeaSource *source);
+    void updateSource();
 
 private:
-    QScopedPointer<QSerialPort> m_port;
+    NmeaSerialPort();
+
+    QSerialPort m_port;
+    QNmeaPositionInfoSource m_source;
+    QVector<NmeaSource *> m_positionSources;
 };
 
-NmeaSource::NmeaSource(QObject *parent)
-    : QNmeaPositionInfoSource(RealTimeMode, parent),
-      m_port(new QSerialPort)
+/*
+    The position source handed out by the plugin. Several of them can be
+    alive on one port, the NMEA source runs while one of them is started
+    and at the shortest of their update intervals.
+*/
+class NmeaSource : public QGeoPositionInfoSource
 {
+public:
+    NmeaSource(const QSharedPointer<NmeaSerialPort> &port, QObject *parent);
+    ~NmeaSource();
+
+    void setUpdateInterval(int msec) override;
+    QGeoPositionInfo lastKnownPosition(bool fromSatellitePositioningMethodsOnly = false) const override;
+    PositioningMethods supportedPositioningMethods() const override;
+    int minimumUpdateInterval() const override;
+    Error error() const override;
+
+    void startUpdates() override;
+    void stopUpdates() override;
+    void requestUpdate(int timeout = 0) override;
+
+    bool isStarted() const { return m_started; }
+
+private:
+    QSharedPointer<NmeaSerialPort> m_port;
+    bool m_started = false;
+    bool m_requested = false;
+};
+
+NmeaSerialPort::NmeaSerialPort()
+    : m_source(QNmeaPositionInfoSource::RealTimeMode)
+{
+}
+
+QSharedPointer<NmeaSerialPort> NmeaSerialPort::open()
+{
+    QSharedPointer<NmeaSerialPort> nmeaPort(new NmeaSerialPort);
+    QSerialPort &port = nmeaPort->m_port;
     QByteArray requestedPort = qgetenv("QT_NMEA_SERIAL_PORT");
     if (requestedPort.isEmpty()) {
         const QList<QSerialPortInfo> ports = QSerialPortInfo::availablePorts();
         qCDebug(lcSerial) << "Found" << ports.count() << "serial ports";
         if (ports.isEmpty()) {
             qWarning("serialnmea: No serial ports found");
-            m_port.reset();
-            return;
+            return QSharedPointer<NmeaSerialPort>();
         }
 
         // Try to find a well-known device.
@@ -75,49 +128,185 @@ NmeaSource::NmeaSource(QObject *parent)
         supportedDevices << 0x67b; // GlobalSat (BU-353S4 and probably others)
         supportedDevices << 0xe8d; // Qstarz MTK II
         QString portName;
-        foreach (const QSerialPortInfo& port, ports) {
-            if (port.hasVendorIdentifier() && supportedDevices.contains(port.vendorIdentifier())) {
-                portName = port.portName();
+        foreach (const QSerialPortInfo& info, ports) {
+            if (info.hasVendorIdentifier() && supportedDevices.contains(info.vendorIdentifier())) {
+                portName = info.portName();
                 break;
             }
         }
 
         if (portName.isEmpty()) {
             qWarning("serialnmea: No known GPS device found. Specify the COM port via QT_NMEA_SERIAL_PORT.");
-            m_port.reset();
-            return;
+            return QSharedPointer<NmeaSerialPort>();
         }
 
-        m_port->setPortName(portName);
+        port.setPortName(portName);
     } else {
-        m_port->setPortName(QString::fromUtf8(requestedPort));
+        port.setPortName(QString::fromUtf8(requestedPort));
     }
 
-    m_port->setBaudRate(4800);
+    port.setBaudRate(4800);
 
-    qCDebug(lcSerial) << "Opening serial port" << m_port->portName();
+    qCDebug(lcSerial) << "Opening serial port" << port.portName();
 
-    if (!m_port->open(QIODevice::ReadOnly)) {
-        qWarning("serialnmea: Failed to open %s", qPrintable(m_port->portName()));
-        m_port.reset();
-        return;
+    if (!port.open(QIODevice::ReadOnly)) {
+        qWarning("serialnmea: Failed to open %s", qPrintable(port.portName()));
+        return QSharedPointer<NmeaSerialPort>();
     }
 
-    setDevice(m_port.data());
-
     qCDebug(lcSerial) << "Opened successfully";
+    nmeaPort->m_source.setDevice(&port);
+    return nmeaPort;
+}
+
+void NmeaSerialPort::addPositionSource(NmeaSource *source)
+{
+    m_positionSources.append(source);
+}
+
+void NmeaSerialPort::removePositionSource(NmeaSource *source)
+{
+    m_positionSources.removeOne(source);
+    updateSource();
+}
+
+void NmeaSerialPort::updateSource()
+{
+    bool started = false;
+    int interval = -1;
+    for (NmeaSource *source : qAsConst(m_positionSources)) {
+        if (!source->isStarted())
+            continue;
+        started = true;
+        interval = interval < 0 ? source->updateInterval() : qMin(interval, source->updateInterval());
+    }
+
+    if (started) {
+        m_source.setUpdateInterval(interval);
+        m_source.startUpdates();
+    } else {
+        m_source.stopUpdates();
+    }
+}
+
+NmeaSource::NmeaSource(const QSharedPointer<NmeaSerialPort> &port, QObject *parent)
+    : QGeoPositionInfoSource(parent),
+      m_port(port)
+{
+    m_port->addPositionSource(this);
+
+    QNmeaPositionInfoSource *source = m_port->source();
+    connect(source, &QGeoPositionInfoSource::positionUpdated, this, [this](const QGeoPositionInfo &info) {
+        if (!m_started && !m_requested)
+            return;
+        m_requested = false;
+        emit positionUpdated(info);
+    });
+    connect(source, &QGeoPositionInfoSource::updateTimeout, this, [this]() {
+        if (!m_started && !m_requested)
+            return;
+        m_requested = false;
+        emit updateTimeout();
+    });
+    connect(source, QOverload<QGeoPositionInfoSource::Error>::of(&QGeoPositionInfoSource::error),
+            this, QOverload<QGeoPositionInfoSource::Error>::of(&QGeoPositionInfoSource::error));
+}
+
+NmeaSource::~NmeaSource()
+{
+    m_port->removePositionSource(this);
+}
+
+void NmeaSource::setUpdateInterval(int msec)
+{
+    QGeoPositionInfoSource::setUpdateInterval(msec);
+    if (m_started)
+        m_port->updateSource();
+}
+
+QGeoPositionInfo NmeaSource::lastKnownPosition(bool fromSatellitePositioningMethodsOnly) const
+{
+    return m_port->source()->lastKnownPosition(fromSatellitePositioningMethodsOnly);
+}
+
+QGeoPositionInfoSource::PositioningMethods NmeaSource::supportedPositioningMethods() const
+{
+    return m_port->source()->supportedPositioningMethods();
+}
+
+int NmeaSource::minimumUpdateInterval() const
+{
+    return m_port->source()->minimumUpdateInterval();
+}
+
+QGeoPositionInfoSource::Error NmeaSource::error() const
+{
+    return m_port->source()->error();
+}
+
+void NmeaSource::startUpdates()
+{
+    if (m_started)
+        return;
+    m_started = true;
+    m_port->updateSource();
+}
+
+void NmeaSource::stopUpdates()
+{
+    if (!m_started)
+        return;
+    m_started = false;
+    m_port->updateSource();
+}
+
+void NmeaSource::requestUpdate(int timeout)
+{
+    m_requested = true;
+    m_port->source()->requestUpdate(timeout);
+}
+
+// Attached to the NMEA source of the port, which parses the satellites too
+class NmeaSatelliteSource : public QNmeaSatelliteInfoSource
+{
+public:
+    NmeaSatelliteSource(const QSharedPointer<NmeaSerialPort> &port, QObject *parent);
+
+private:
+    QSharedPointer<NmeaSerialPort> m_port;
+};
+
+NmeaSatelliteSource::NmeaSatelliteSource(const QSharedPointer<NmeaSerialPort> &port, QObject *parent)
+    : QNmeaSatelliteInfoSource(port->source(), parent),
+      m_port(port)
+{
+}
+
+// The sources created while one of them is alive share its serial port
+QSharedPointer<NmeaSerialPort> QGeoPositionInfoSourceFactorySerialNmea::serialPort()
+{
+    QSharedPointer<NmeaSerialPort> port = m_serialPort.toStrongRef();
+    if (!port) {
+        port = NmeaSerialPort::open();
+        m_serialPort = port;
+    }
+    return port;
 }
 
 QGeoPositionInfoSource *QGeoPositionInfoSourceFactorySerialNmea::positionInfoSource(QObject *parent)
 {
-    QScopedPointer<NmeaSource> src(new NmeaSource(parent));
-    return src->isValid() ? src.take() : nullptr;
+    const QSharedPointer<NmeaSerialPort> port = serialPort();
+    if (!port)
+        return nullptr;
+    return new NmeaSource(port, parent);
 }
 
 QGeoSatelliteInfoSource *QGeoPositionInfoSourceFactorySerialNmea::satelliteInfoSource(QObject *parent)
 {
-    Q_UNUSED(parent);
-    return nullptr;
+    const QSharedPointer<NmeaSerialPort> port = serialPort();
+    if (!port)
+        return nullptr;
+    return new NmeaSatelliteSource(port, parent);
 }
 
 QGeoAreaMonitorSource *QGeoPositionInfoSourceFactorySerialNmea::areaMonitor(QObject *parent)
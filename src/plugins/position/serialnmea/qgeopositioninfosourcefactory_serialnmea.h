@@ -41,8 +41,11 @@
 #define QGEOPOSITIONINFOSOURCEFACTORY_SERIALNMEA_H
 
 #include <QObject>
+#include <QWeakPointer>
 #include <qgeopositioninfosourcefactory.h>
 
+class NmeaSerialPort;
+
 class QGeoPositionInfoSourceFactorySerialNmea : public QObject, public QGeoPositionInfoSourceFactory
 {
     Q_OBJECT
@@ -54,6 +57,11 @@ public:
     QGeoPositionInfoSource *positionInfoSource(QObject *parent);
     QGeoSatelliteInfoSource *satelliteInfoSource(QObject *parent);
     QGeoAreaMonitorSource *areaMonitor(QObject *parent);
+
+private:
+    QSharedPointer<NmeaSerialPort> serialPort();
+
+    QWeakPointer<NmeaSerialPort> m_serialPort;
 };
 
 #endif
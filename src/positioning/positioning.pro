@@ -47,7 +47,9 @@ PRIVATE_HEADERS += \
                     qgeolocation_p.h \
                     qlocationutils_p.h \
                     qnmeapositioninfosource_p.h \
+                    qnmeasatelliteinfosource_p.h \
                     qgeocoordinate_p.h \
+                    qgeocoordinatearray_p.h \
                     qgeopositioninfosource_p.h \
                     qdeclarativegeoaddress_p.h \
                     qdeclarativegeolocation_p.h \
@@ -60,7 +62,10 @@ PRIVATE_HEADERS += \
                     qgeopath_p.h \
                     qgeocoordinateobject_p.h \
                     qgeopositioninfo_p.h \
-                    qclipperutils_p.h
+                    qclipperutils_p.h \
+                    qgeocoordinatebatch_p.h \
+                    qnmeatokenizer_p.h \
+                    qnmealogindex_p.h
 
 SOURCES += \
             qgeoaddress.cpp \
@@ -70,6 +75,7 @@ SOURCES += \
             qgeorectangle.cpp \
             qgeocircle.cpp \
             qgeocoordinate.cpp \
+            qgeocoordinatearray.cpp \
             qgeolocation.cpp \
             qgeopositioninfo.cpp \
             qgeopositioninfosource.cpp \
@@ -77,6 +83,7 @@ SOURCES += \
             qgeosatelliteinfosource.cpp \
             qlocationutils.cpp \
             qnmeapositioninfosource.cpp \
+            qnmeasatelliteinfosource.cpp \
             qgeopositioninfosourcefactory.cpp \
             qdeclarativegeoaddress.cpp \
             qdeclarativegeolocation.cpp \
@@ -88,7 +95,12 @@ SOURCES += \
             qwebmercator.cpp \
             qdoublematrix4x4.cpp \
             qclipperutils.cpp \
-            qgeocoordinateobject.cpp
+            qgeocoordinateobject.cpp \
+            qgeocoordinatebatch.cpp \
+            qnmeatokenizer.cpp \
+            qnmealogindex.cpp
+
+AVX2_SOURCES += qgeocoordinatebatch_avx2.cpp
 
 HEADERS += $$PUBLIC_HEADERS $$PRIVATE_HEADERS
 
@@ -0,0 +1,322 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeocoordinatearray_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QGeoCoordinateArray
+    \inmodule QtPositioning
+    \internal
+
+    \brief The QGeoCoordinateArray class stores a sequence of coordinates
+    in a single contiguous buffer.
+
+    Each QGeoCoordinate owns a separately allocated, reference counted
+    value. Paths and routes with many vertices are cheaper to build,
+    copy and traverse as a QGeoCoordinateArray, which keeps the latitude,
+    longitude and altitude of all points as plain values in one implicitly
+    shared block of memory.
+
+    The private classes of QGeoPath, QGeoPolygon, QGeoRoute and
+    QGeoRouteSegment store their coordinates in one.
+
+    Elements compare equal under the same rules as QGeoCoordinate.
+*/
+
+/*!
+    \class QGeoCoordinateArray::Point
+    \inmodule QtPositioning
+    \internal
+
+    \brief The Point struct holds the latitude, longitude and altitude of an
+    element of a QGeoCoordinateArray, in degrees and meters.
+*/
+
+static bool pointsEqual(const QGeoCoordinateArray::Point &a, const QGeoCoordinateArray::Point &b)
+{
+    // Same rules as QGeoCoordinate::operator==()
+    bool latEqual = (qIsNaN(a.latitude) && qIsNaN(b.latitude))
+                        || qFuzzyCompare(a.latitude, b.latitude);
+    bool lngEqual = (qIsNaN(a.longitude) && qIsNaN(b.longitude))
+                        || qFuzzyCompare(a.longitude, b.longitude);
+    bool altEqual = (qIsNaN(a.altitude) && qIsNaN(b.altitude))
+                        || qFuzzyCompare(a.altitude, b.altitude);
+
+    if (!qIsNaN(a.latitude) && ((a.latitude == 90.0) || (a.latitude == -90.0)))
+        lngEqual = true;
+
+    return (latEqual && lngEqual && altEqual);
+}
+
+static inline QGeoCoordinateArray::Point toPoint(const QGeoCoordinate &coordinate)
+{
+    return QGeoCoordinateArray::Point{coordinate.latitude(), coordinate.longitude(),
+                                      coordinate.altitude()};
+}
+
+/*!
+    Constructs an empty coordinate array.
+*/
+QGeoCoordinateArray::QGeoCoordinateArray()
+{
+}
+
+/*!
+    Constructs a coordinate array holding the values of \a coordinates.
+*/
+QGeoCoordinateArray::QGeoCoordinateArray(const QList<QGeoCoordinate> &coordinates)
+{
+    m_points.reserve(coordinates.size());
+    for (const QGeoCoordinate &c : coordinates)
+        m_points.append(toPoint(c));
+}
+
+/*!
+    Returns true if both arrays have the same size and all their elements
+    compare equal.
+*/
+bool QGeoCoordinateArray::operator==(const QGeoCoordinateArray &other) const
+{
+    if (m_points.size() != other.m_points.size())
+        return false;
+    const Point *a = m_points.constData();
+    const Point *b = other.m_points.constData();
+    if (a == b)
+        return true;
+    for (int i = 0; i < m_points.size(); ++i) {
+        if (!pointsEqual(a[i], b[i]))
+            return false;
+    }
+    return true;
+}
+
+/*!
+    \fn bool QGeoCoordinateArray::operator!=(const QGeoCoordinateArray &other) const
+
+    Returns true if \a other differs from this array.
+*/
+
+/*!
+    \fn bool QGeoCoordinateArray::isEmpty() const
+
+    Returns true if the array holds no coordinates.
+*/
+
+/*!
+    \fn int QGeoCoordinateArray::size() const
+
+    Returns the number of coordinates in the array.
+*/
+
+/*!
+    Allocates memory for at least \a size coordinates.
+*/
+void QGeoCoordinateArray::reserve(int size)
+{
+    m_points.reserve(size);
+}
+
+/*!
+    Removes all coordinates from the array.
+*/
+void QGeoCoordinateArray::clear()
+{
+    m_points.clear();
+}
+
+/*!
+    Appends the coordinate at \a latitude, \a longitude and \a altitude.
+*/
+void QGeoCoordinateArray::append(double latitude, double longitude, double altitude)
+{
+    m_points.append(Point{latitude, longitude, altitude});
+}
+
+/*!
+    \overload
+*/
+void QGeoCoordinateArray::append(const QGeoCoordinate &coordinate)
+{
+    m_points.append(toPoint(coordinate));
+}
+
+/*!
+    \overload
+
+    Appends all coordinates of \a other.
+*/
+void QGeoCoordinateArray::append(const QGeoCoordinateArray &other)
+{
+    m_points += other.m_points;
+}
+
+/*!
+    Inserts \a coordinate at position \a index.
+*/
+void QGeoCoordinateArray::insert(int index, const QGeoCoordinate &coordinate)
+{
+    m_points.insert(index, toPoint(coordinate));
+}
+
+/*!
+    Replaces the coordinate at position \a index with \a coordinate.
+*/
+void QGeoCoordinateArray::replace(int index, const QGeoCoordinate &coordinate)
+{
+    m_points.replace(index, toPoint(coordinate));
+}
+
+/*!
+    Removes \a count coordinates starting at position \a index.
+*/
+void QGeoCoordinateArray::remove(int index, int count)
+{
+    m_points.remove(index, count);
+}
+
+/*!
+    Returns the coordinate at position \a index.
+*/
+QGeoCoordinate QGeoCoordinateArray::at(int index) const
+{
+    // The setters keep the values as they are, invalid ones included
+    const Point &p = m_points.at(index);
+    QGeoCoordinate coordinate;
+    coordinate.setLatitude(p.latitude);
+    coordinate.setLongitude(p.longitude);
+    coordinate.setAltitude(p.altitude);
+    return coordinate;
+}
+
+/*!
+    \fn const QGeoCoordinateArray::Point &QGeoCoordinateArray::point(int index) const
+
+    Returns the values of the coordinate at position \a index.
+*/
+
+/*!
+    \fn double QGeoCoordinateArray::latitude(int index) const
+
+    Returns the latitude of the coordinate at position \a index.
+*/
+
+/*!
+    \fn double QGeoCoordinateArray::longitude(int index) const
+
+    Returns the longitude of the coordinate at position \a index.
+*/
+
+/*!
+    \fn double QGeoCoordinateArray::altitude(int index) const
+
+    Returns the altitude of the coordinate at position \a index.
+*/
+
+/*!
+    Returns the position of the first occurrence of \a coordinate at or
+    after \a from, or -1 if there is none.
+*/
+int QGeoCoordinateArray::indexOf(const QGeoCoordinate &coordinate, int from) const
+{
+    const Point p = toPoint(coordinate);
+    for (int i = qMax(from, 0); i < m_points.size(); ++i) {
+        if (pointsEqual(m_points.at(i), p))
+            return i;
+    }
+    return -1;
+}
+
+/*!
+    Returns the position of the last occurrence of \a coordinate at or
+    before \a from, or -1 if there is none. A negative \a from counts from
+    the end.
+*/
+int QGeoCoordinateArray::lastIndexOf(const QGeoCoordinate &coordinate, int from) const
+{
+    const Point p = toPoint(coordinate);
+    if (from < 0)
+        from += m_points.size();
+    for (int i = qMin(from, m_points.size() - 1); i >= 0; --i) {
+        if (pointsEqual(m_points.at(i), p))
+            return i;
+    }
+    return -1;
+}
+
+/*!
+    Returns \a length coordinates starting at \a position, or all remaining
+    ones if \a length is -1.
+*/
+QGeoCoordinateArray QGeoCoordinateArray::mid(int position, int length) const
+{
+    QGeoCoordinateArray result;
+    result.m_points = m_points.mid(position, length);
+    return result;
+}
+
+/*!
+    \fn const QGeoCoordinateArray::Point *QGeoCoordinateArray::constData() const
+
+    Returns a pointer to the first element of the contiguous storage.
+*/
+
+/*!
+    Returns a pointer to the first element of the contiguous storage,
+    detaching it if it is shared.
+*/
+QGeoCoordinateArray::Point *QGeoCoordinateArray::data()
+{
+    return m_points.data();
+}
+
+/*!
+    Returns the coordinates as a list of QGeoCoordinate.
+*/
+QList<QGeoCoordinate> QGeoCoordinateArray::toList() const
+{
+    QList<QGeoCoordinate> result;
+    result.reserve(m_points.size());
+    for (int i = 0; i < m_points.size(); ++i)
+        result.append(at(i));
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOCOORDINATEARRAY_P_H
+#define QGEOCOORDINATEARRAY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QMetaType>
+#include <QtCore/QVector>
+#include <QtCore/QList>
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/qgeocoordinate.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_POSITIONING_PRIVATE_EXPORT QGeoCoordinateArray
+{
+public:
+    struct Point
+    {
+        double latitude;
+        double longitude;
+        double altitude;
+    };
+
+    QGeoCoordinateArray();
+    explicit QGeoCoordinateArray(const QList<QGeoCoordinate> &coordinates);
+
+    bool operator==(const QGeoCoordinateArray &other) const;
+    bool operator!=(const QGeoCoordinateArray &other) const {
+        return !(other == *this);
+    }
+
+    bool isEmpty() const { return m_points.isEmpty(); }
+    int size() const { return m_points.size(); }
+    void reserve(int size);
+    void clear();
+
+    void append(double latitude, double longitude, double altitude = qQNaN());
+    void append(const QGeoCoordinate &coordinate);
+    void append(const QGeoCoordinateArray &other);
+    void insert(int index, const QGeoCoordinate &coordinate);
+    void replace(int index, const QGeoCoordinate &coordinate);
+    void remove(int index, int count = 1);
+
+    QGeoCoordinate at(int index) const;
+    const Point &point(int index) const { return m_points.at(index); }
+    double latitude(int index) const { return m_points.at(index).latitude; }
+    double longitude(int index) const { return m_points.at(index).longitude; }
+    double altitude(int index) const { return m_points.at(index).altitude; }
+
+    int indexOf(const QGeoCoordinate &coordinate, int from = 0) const;
+    int lastIndexOf(const QGeoCoordinate &coordinate, int from = -1) const;
+
+    QGeoCoordinateArray mid(int position, int length = -1) const;
+
+    const Point *constData() const { return m_points.constData(); }
+    Point *data();
+
+    QList<QGeoCoordinate> toList() const;
+
+private:
+    QVector<Point> m_points;
+};
+
+Q_DECLARE_TYPEINFO(QGeoCoordinateArray::Point, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(QGeoCoordinateArray, Q_MOVABLE_TYPE);
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoCoordinateArray)
+
+#endif // QGEOCOORDINATEARRAY_P_H
@@ -0,0 +1,183 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeocoordinatebatch_p.h"
+#include "qlocationutils_p.h"
+
+#include <QtCore/private/qsimd_p.h>
+#include <QtCore/qmath.h>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+void qt_geoDistances_avx2(const double *latitudes, const double *longitudes, int count,
+                          double *result);
+void qt_geoToMercator_avx2(const double *latitudes, const double *longitudes, int count,
+                           double *x, double *y);
+void qt_geoFromMercator_avx2(const double *x, const double *y, int count,
+                             double *latitudes, double *longitudes);
+void qt_geoAtDistanceAndAzimuth_avx2(double latitude, double longitude, double distance,
+                                     const double *azimuths, int count,
+                                     double *latitudes, double *longitudes);
+#endif
+
+bool QGeoCoordinateBatch::isVectorized()
+{
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+    return qCpuHasFeature(AVX2);
+#else
+    return false;
+#endif
+}
+
+void QGeoCoordinateBatch::distances(const double *latitudes, const double *longitudes, int count,
+                                    double *result)
+{
+    if (count < 2)
+        return;
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+    if (qCpuHasFeature(AVX2)) {
+        qt_geoDistances_avx2(latitudes, longitudes, count, result);
+        return;
+    }
+#endif
+
+    // Haversine formula, each cosine is shared by two segments
+    double cosLat = std::cos(qDegreesToRadians(latitudes[0]));
+    for (int i = 1; i < count; ++i) {
+        const double cosNextLat = std::cos(qDegreesToRadians(latitudes[i]));
+        const double dlat = qDegreesToRadians(latitudes[i] - latitudes[i - 1]);
+        const double dlon = qDegreesToRadians(longitudes[i] - longitudes[i - 1]);
+        double haversine_dlat = std::sin(dlat / 2.0);
+        haversine_dlat *= haversine_dlat;
+        double haversine_dlon = std::sin(dlon / 2.0);
+        haversine_dlon *= haversine_dlon;
+        const double y = haversine_dlat + cosLat * cosNextLat * haversine_dlon;
+        result[i - 1] = 2 * std::asin(std::sqrt(y)) * QLocationUtils::earthMeanRadius();
+        cosLat = cosNextLat;
+    }
+}
+
+void QGeoCoordinateBatch::cumulativeDistances(const double *latitudes, const double *longitudes,
+                                              int count, double *result)
+{
+    if (count < 1)
+        return;
+
+    result[0] = 0.0;
+    distances(latitudes, longitudes, count, result + 1);
+    for (int i = 1; i < count; ++i)
+        result[i] += result[i - 1];
+}
+
+void QGeoCoordinateBatch::toMercator(const double *latitudes, const double *longitudes, int count,
+                                     double *x, double *y)
+{
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+    if (qCpuHasFeature(AVX2)) {
+        qt_geoToMercator_avx2(latitudes, longitudes, count, x, y);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < count; ++i) {
+        x[i] = longitudes[i] / 360.0 + 0.5;
+        const double lat = 0.5 - (std::log(std::tan((M_PI / 4.0) + (M_PI / 2.0) * latitudes[i] / 180.0)) / M_PI) / 2.0;
+        y[i] = qBound(0.0, lat, 1.0);
+    }
+}
+
+void QGeoCoordinateBatch::fromMercator(const double *x, const double *y, int count,
+                                       double *latitudes, double *longitudes)
+{
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+    if (qCpuHasFeature(AVX2)) {
+        qt_geoFromMercator_avx2(x, y, count, latitudes, longitudes);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < count; ++i) {
+        const double fy = qBound(0.0, y[i], 1.0);
+        if (fy == 0.0)
+            latitudes[i] = 90.0;
+        else if (fy == 1.0)
+            latitudes[i] = -90.0;
+        else
+            latitudes[i] = qRadiansToDegrees(2.0 * std::atan(std::exp(M_PI * (1.0 - 2.0 * fy))) - (M_PI / 2.0));
+
+        longitudes[i] = (x[i] - std::floor(x[i])) * 360.0 - 180.0;
+    }
+}
+
+void QGeoCoordinateBatch::atDistanceAndAzimuth(double latitude, double longitude, double distance,
+                                               const double *azimuths, int count,
+                                               double *latitudes, double *longitudes)
+{
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+    if (qCpuHasFeature(AVX2)) {
+        qt_geoAtDistanceAndAzimuth_avx2(latitude, longitude, distance, azimuths, count,
+                                        latitudes, longitudes);
+        return;
+    }
+#endif
+
+    const double latRad = qDegreesToRadians(latitude);
+    const double lonRad = qDegreesToRadians(longitude);
+    const double cosLatRad = std::cos(latRad);
+    const double sinLatRad = std::sin(latRad);
+    const double ratio = distance / QLocationUtils::earthMeanRadius();
+    const double cosRatio = std::cos(ratio);
+    const double sinRatio = std::sin(ratio);
+
+    for (int i = 0; i < count; ++i) {
+        const double azimuthRad = qDegreesToRadians(azimuths[i]);
+        const double resultLatRad = std::asin(sinLatRad * cosRatio
+                                              + cosLatRad * sinRatio * std::cos(azimuthRad));
+        const double resultLonRad = lonRad + std::atan2(std::sin(azimuthRad) * sinRatio * cosLatRad,
+                                                        cosRatio - sinLatRad * std::sin(resultLatRad));
+        latitudes[i] = qRadiansToDegrees(resultLatRad);
+        longitudes[i] = qRadiansToDegrees(resultLonRad);
+    }
+}
+
+QT_END_NAMESPACE
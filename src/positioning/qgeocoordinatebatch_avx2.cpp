@@ -0,0 +1,384 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeocoordinatebatch_p.h"
+#include "qlocationutils_p.h"
+
+#include <QtCore/private/qsimd_p.h>
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Four lane double precision kernels. The polynomials are the Cephes ones
+// used by most libm implementations, accurate to a few ulp over the reduced
+// ranges.
+
+typedef __m256d V;
+
+inline V set1(double d) { return _mm256_set1_pd(d); }
+inline V add(V a, V b) { return _mm256_add_pd(a, b); }
+inline V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+inline V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+inline V divV(V a, V b) { return _mm256_div_pd(a, b); }
+inline V madd(V a, V b, V c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+inline V select(V mask, V ifTrue, V ifFalse) { return _mm256_blendv_pd(ifFalse, ifTrue, mask); }
+inline V signBit(V a) { return _mm256_and_pd(a, set1(-0.0)); }
+inline V absV(V a) { return _mm256_andnot_pd(set1(-0.0), a); }
+
+template <int N>
+inline V polevl(V x, const double (&c)[N])
+{
+    V r = set1(c[0]);
+    for (int i = 1; i < N; ++i)
+        r = madd(r, x, set1(c[i]));
+    return r;
+}
+
+// As polevl() with an implicit leading coefficient of 1
+template <int N>
+inline V p1evl(V x, const double (&c)[N])
+{
+    V r = add(x, set1(c[0]));
+    for (int i = 1; i < N; ++i)
+        r = madd(r, x, set1(c[i]));
+    return r;
+}
+
+// Sine and cosine for |x| < 2^20
+inline void sinCosV(V x, V *s, V *c)
+{
+    static const double sinCoefficients[] = {
+        1.58962301576546568060E-10, -2.50507477628578072866E-8,
+        2.75573136213857245213E-6, -1.98412698295895385996E-4,
+        8.33333333332211858878E-3, -1.66666666666666307295E-1
+    };
+    static const double cosCoefficients[] = {
+        -1.13585365213876817300E-11, 2.08757008419747316778E-9,
+        -2.75573141792967388112E-7, 2.48015872888517045348E-5,
+        -1.38888888888730564116E-3, 4.16666666666665929218E-2
+    };
+
+    // Cody-Waite reduction to [-pi/4, pi/4] and the quadrant
+    const V q = _mm256_round_pd(mul(x, set1(0.63661977236758134308)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    V r = sub(x, mul(q, set1(1.57079632673412561417e+00)));
+    r = sub(r, mul(q, set1(6.07710050630396597660e-11)));
+    r = sub(r, mul(q, set1(2.02226624871116645580e-21)));
+
+    const V z = mul(r, r);
+    const V sr = madd(mul(r, z), polevl(z, sinCoefficients), r);
+    const V cr = madd(mul(z, z), polevl(z, cosCoefficients), sub(set1(1.0), mul(z, set1(0.5))));
+
+    const __m256i quadrant = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(q));
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i two = _mm256_set1_epi64x(2);
+    const V odd = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quadrant, one), one));
+    const V sinSign = _mm256_castsi256_pd(
+                _mm256_slli_epi64(_mm256_and_si256(quadrant, two), 62));
+    const V cosSign = _mm256_castsi256_pd(
+                _mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(quadrant, one), two), 62));
+
+    *s = _mm256_xor_pd(select(odd, cr, sr), sinSign);
+    *c = _mm256_xor_pd(select(odd, sr, cr), cosSign);
+}
+
+// Arc tangent for 0 <= t <= 1
+inline V atanUnitV(V t)
+{
+    static const double p[] = {
+        -8.750608600031904122785E-1, -1.615753718733365076637E1,
+        -7.500855792314704667340E1, -1.228866684490136173410E2,
+        -6.485021904942025371773E1
+    };
+    static const double q[] = {
+        2.485846490142306297962E1, 1.650270098316988542046E2,
+        4.328810604912902668951E2, 4.853903996359136964868E2,
+        1.945506571482613964425E2
+    };
+
+    // Above tan(pi/8) shift by pi/4
+    const V large = _mm256_cmp_pd(t, set1(0.66), _CMP_GT_OQ);
+    const V x = select(large, divV(sub(t, set1(1.0)), add(t, set1(1.0))), t);
+    const V base = select(large, set1(M_PI_4), _mm256_setzero_pd());
+    const V moreBits = select(large, set1(0.5 * 6.123233995736765886130E-17), _mm256_setzero_pd());
+
+    const V z = mul(x, x);
+    const V y = divV(mul(z, polevl(z, p)), p1evl(z, q));
+    return add(base, add(madd(x, y, x), moreBits));
+}
+
+inline V atan2V(V y, V x)
+{
+    const V ax = absV(x);
+    const V ay = absV(y);
+    const V hi = _mm256_max_pd(ax, ay);
+    const V lo = _mm256_min_pd(ax, ay);
+
+    V a = atanUnitV(divV(lo, hi));
+    a = select(_mm256_cmp_pd(hi, _mm256_setzero_pd(), _CMP_EQ_OQ), _mm256_setzero_pd(), a);
+    a = select(_mm256_cmp_pd(ay, ax, _CMP_GT_OQ), sub(set1(M_PI_2), a), a);
+    a = select(signBit(x), sub(set1(M_PI), a), a);
+    return _mm256_xor_pd(a, signBit(y));
+}
+
+// Arc sine for -1 <= x <= 1
+inline V asinV(V x)
+{
+    return atan2V(x, _mm256_sqrt_pd(mul(sub(set1(1.0), x), add(set1(1.0), x))));
+}
+
+// Natural logarithm for positive normal x
+inline V logV(V x)
+{
+    static const double p[] = {
+        1.01875663804580931796E-4, 4.97494994976747001425E-1,
+        4.70579119878881725854E0, 1.44989225341610930846E1,
+        1.79368678507819816313E1, 7.70838733755885391666E0
+    };
+    static const double q[] = {
+        1.12873587189167450590E1, 4.52279145837532221105E1,
+        8.29875266912776603211E1, 7.11544750618767552360E1,
+        2.31251620126765340583E1
+    };
+
+    // x = m * 2^e with 0.5 <= m < 1
+    const __m256i bits = _mm256_castpd_si256(x);
+    const __m256i exponentBits = _mm256_or_si256(_mm256_srli_epi64(bits, 52),
+                                                 _mm256_set1_epi64x(0x4330000000000000LL));
+    V e = sub(_mm256_castsi256_pd(exponentBits), set1(4503599627370496.0 + 1022.0));
+    V m = _mm256_castsi256_pd(_mm256_or_si256(
+                _mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffffLL)),
+                _mm256_set1_epi64x(0x3fe0000000000000LL)));
+
+    const V small = _mm256_cmp_pd(m, set1(0.70710678118654752440), _CMP_LT_OQ);
+    e = sub(e, _mm256_and_pd(small, set1(1.0)));
+    m = sub(select(small, add(m, m), m), set1(1.0));
+
+    const V z = mul(m, m);
+    V y = mul(m, divV(mul(z, polevl(m, p)), p1evl(m, q)));
+    y = sub(y, mul(e, set1(2.121944400546905827679E-4)));
+    y = sub(y, mul(z, set1(0.5)));
+    return madd(e, set1(0.693359375), add(m, y));
+}
+
+// Exponential for |x| < 700
+inline V expV(V x)
+{
+    static const double p[] = {
+        1.26177193074810590878E-4, 3.02994407707441961300E-2,
+        9.99999999999999999910E-1
+    };
+    static const double q[] = {
+        3.00198505138664455042E-6, 2.52448340349684104192E-3,
+        2.27265548208155028766E-1, 2.00000000000000000009E0
+    };
+
+    const V n = _mm256_floor_pd(madd(x, set1(1.4426950408889634073599), set1(0.5)));
+    x = sub(x, mul(n, set1(6.93145751953125E-1)));
+    x = sub(x, mul(n, set1(1.42860682030941723212E-6)));
+
+    const V xx = mul(x, x);
+    const V px = mul(x, polevl(xx, p));
+    x = divV(px, sub(polevl(xx, q), px));
+    x = madd(x, set1(2.0), set1(1.0));
+
+    // Scale by 2^n
+    const __m256i shift = _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n)), 52);
+    return _mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(x), shift));
+}
+
+inline V radians(V degrees) { return mul(degrees, set1(M_PI / 180.0)); }
+inline V degrees(V radians) { return mul(radians, set1(180.0 / M_PI)); }
+
+/*
+    Runs kernel over count items four at a time. The remainder is copied to
+    padded buffers, so that every item goes through the same code path no
+    matter where it is in the array. Inputs are read with an extra lookahead
+    of the given number of items.
+*/
+template <int Inputs, int Outputs, int Lookahead, typename Kernel>
+void forEachBlock(const double *const (&in)[Inputs], double *const (&out)[Outputs],
+                  int count, Kernel kernel)
+{
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        V args[Inputs];
+        for (int k = 0; k < Inputs; ++k)
+            args[k] = _mm256_loadu_pd(in[k] + i);
+        V results[Outputs];
+        kernel(args, results, in, i);
+        for (int k = 0; k < Outputs; ++k)
+            _mm256_storeu_pd(out[k] + i, results[k]);
+    }
+    if (i == count)
+        return;
+
+    const int rest = count - i;
+    double inBuffer[Inputs][4 + Lookahead];
+    const double *padded[Inputs];
+    for (int k = 0; k < Inputs; ++k) {
+        const int available = rest + Lookahead;
+        std::copy(in[k] + i, in[k] + i + available, inBuffer[k]);
+        std::fill(inBuffer[k] + available, inBuffer[k] + 4 + Lookahead, in[k][i + available - 1]);
+        padded[k] = inBuffer[k];
+    }
+
+    V args[Inputs];
+    for (int k = 0; k < Inputs; ++k)
+        args[k] = _mm256_loadu_pd(padded[k]);
+    V results[Outputs];
+    kernel(args, results, padded, 0);
+
+    double outBuffer[4];
+    for (int k = 0; k < Outputs; ++k) {
+        _mm256_storeu_pd(outBuffer, results[k]);
+        std::copy(outBuffer, outBuffer + rest, out[k] + i);
+    }
+}
+
+} // namespace
+
+void qt_geoDistances_avx2(const double *latitudes, const double *longitudes, int count,
+                          double *result)
+{
+    const double *const in[] = { latitudes, longitudes };
+    double *const out[] = { result };
+    const V radius = set1(QLocationUtils::earthMeanRadius());
+
+    // count - 1 segments, each reading the next point as well
+    forEachBlock<2, 1, 1>(in, out, count - 1,
+                          [&](const V *args, V *results, const double *const *ptrs, int i) {
+        const V lat2 = _mm256_loadu_pd(ptrs[0] + i + 1);
+        const V lon2 = _mm256_loadu_pd(ptrs[1] + i + 1);
+        const V lat1Rad = radians(args[0]);
+        const V lat2Rad = radians(lat2);
+
+        V s, c, cosLat1, cosLat2, sinHalfDlat, sinHalfDlon;
+        sinCosV(lat1Rad, &s, &cosLat1);
+        sinCosV(lat2Rad, &s, &cosLat2);
+        sinCosV(mul(radians(sub(lat2, args[0])), set1(0.5)), &sinHalfDlat, &c);
+        sinCosV(mul(radians(sub(lon2, args[1])), set1(0.5)), &sinHalfDlon, &c);
+
+        V y = madd(mul(cosLat1, cosLat2), mul(sinHalfDlon, sinHalfDlon),
+                   mul(sinHalfDlat, sinHalfDlat));
+        y = _mm256_min_pd(y, set1(1.0));
+        results[0] = mul(mul(asinV(_mm256_sqrt_pd(y)), set1(2.0)), radius);
+    });
+}
+
+void qt_geoToMercator_avx2(const double *latitudes, const double *longitudes, int count,
+                           double *x, double *y)
+{
+    const double *const in[] = { latitudes, longitudes };
+    double *const out[] = { x, y };
+
+    forEachBlock<2, 2, 0>(in, out, count,
+                          [](const V *args, V *results, const double *const *, int) {
+        results[0] = add(divV(args[1], set1(360.0)), set1(0.5));
+
+        // ln(tan(pi/4 + lat/2)) = atanh(sin(lat)), clamped short of the poles
+        // where the result is out of bounds anyway
+        V s, c;
+        sinCosV(radians(args[0]), &s, &c);
+        s = _mm256_max_pd(_mm256_min_pd(s, set1(0.9999)), set1(-0.9999));
+        const V l = mul(logV(divV(add(set1(1.0), s), sub(set1(1.0), s))), set1(0.5));
+        const V lat = sub(set1(0.5), mul(l, set1(0.5 / M_PI)));
+        results[1] = _mm256_max_pd(_mm256_min_pd(lat, set1(1.0)), _mm256_setzero_pd());
+    });
+}
+
+void qt_geoFromMercator_avx2(const double *x, const double *y, int count,
+                             double *latitudes, double *longitudes)
+{
+    const double *const in[] = { x, y };
+    double *const out[] = { latitudes, longitudes };
+
+    forEachBlock<2, 2, 0>(in, out, count,
+                          [](const V *args, V *results, const double *const *, int) {
+        const V fy = _mm256_max_pd(_mm256_min_pd(args[1], set1(1.0)), _mm256_setzero_pd());
+        const V e = expV(mul(sub(set1(1.0), add(fy, fy)), set1(M_PI)));
+        V lat = degrees(sub(mul(atan2V(e, set1(1.0)), set1(2.0)), set1(M_PI_2)));
+        lat = select(_mm256_cmp_pd(fy, _mm256_setzero_pd(), _CMP_EQ_OQ), set1(90.0), lat);
+        lat = select(_mm256_cmp_pd(fy, set1(1.0), _CMP_EQ_OQ), set1(-90.0), lat);
+        results[0] = lat;
+
+        const V lng = sub(args[0], _mm256_floor_pd(args[0]));
+        results[1] = madd(lng, set1(360.0), set1(-180.0));
+    });
+}
+
+void qt_geoAtDistanceAndAzimuth_avx2(double latitude, double longitude, double distance,
+                                     const double *azimuths, int count,
+                                     double *latitudes, double *longitudes)
+{
+    const double latRad = latitude * (M_PI / 180.0);
+    const double ratio = distance / QLocationUtils::earthMeanRadius();
+    const V lonRad = set1(longitude * (M_PI / 180.0));
+    const V sinLatRad = set1(std::sin(latRad));
+    const V cosRatio = set1(std::cos(ratio));
+    const V cosLatSinRatio = set1(std::cos(latRad) * std::sin(ratio));
+    const V sinLatCosRatio = set1(std::sin(latRad) * std::cos(ratio));
+
+    const double *const in[] = { azimuths };
+    double *const out[] = { latitudes, longitudes };
+
+    forEachBlock<1, 2, 0>(in, out, count,
+                          [&](const V *args, V *results, const double *const *, int) {
+        V sinAzimuth, cosAzimuth;
+        sinCosV(radians(args[0]), &sinAzimuth, &cosAzimuth);
+
+        // sin(resultLat) is the argument of the arc sine
+        V sinResultLat = madd(cosLatSinRatio, cosAzimuth, sinLatCosRatio);
+        sinResultLat = _mm256_max_pd(_mm256_min_pd(sinResultLat, set1(1.0)), set1(-1.0));
+
+        results[0] = degrees(asinV(sinResultLat));
+        results[1] = degrees(add(lonRad, atan2V(mul(sinAzimuth, cosLatSinRatio),
+                                               sub(cosRatio, mul(sinLatRad, sinResultLat)))));
+    });
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_COMPILER_SUPPORTS_AVX2
@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOCOORDINATEBATCH_P_H
+#define QGEOCOORDINATEBATCH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Geodesic functions over contiguous arrays of latitudes and longitudes in
+    degrees, for loops that would otherwise call QGeoCoordinate and
+    QWebMercator once per point.
+
+    On CPUs with AVX2 the kernels process four points at a time with
+    polynomial approximations of the transcendental functions. Distances
+    match the scalar functions to within 1e-12 relative, coordinates to
+    within 1e-10 degrees or mercator units and mercator x exactly. Results
+    never depend on the position of a point within the array. Inputs must be
+    valid coordinates.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QGeoCoordinateBatch
+{
+public:
+    // Great circle distance in meters from each point to the next one,
+    // count - 1 values as QGeoCoordinate::distanceTo()
+    static void distances(const double *latitudes, const double *longitudes, int count,
+                          double *result);
+
+    // Length in meters of the path up to each point, count values
+    static void cumulativeDistances(const double *latitudes, const double *longitudes, int count,
+                                    double *result);
+
+    // As QWebMercator::coordToMercator()
+    static void toMercator(const double *latitudes, const double *longitudes, int count,
+                           double *x, double *y);
+
+    // As QWebMercator::mercatorToCoord()
+    static void fromMercator(const double *x, const double *y, int count,
+                             double *latitudes, double *longitudes);
+
+    // Points reached traveling distance meters from the origin at each of
+    // azimuths (degrees), as QGeoCoordinate::atDistanceAndAzimuth() but
+    // without wrapping the longitudes
+    static void atDistanceAndAzimuth(double latitude, double longitude, double distance,
+                                     const double *azimuths, int count,
+                                     double *latitudes, double *longitudes);
+
+    static bool isVectorized();
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOCOORDINATEBATCH_P_H
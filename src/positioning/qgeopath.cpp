@@ -40,6 +40,7 @@
 #include "qgeopath.h"
 #include "qgeopolygon.h"
 #include "qgeopath_p.h"
+#include "qgeocoordinatebatch_p.h"
 
 #include "qgeocoordinate.h"
 #include "qnumeric.h"
@@ -48,6 +49,11 @@
 
 #include "qdoublevector2d_p.h"
 #include "qdoublevector3d_p.h"
+
+#include <QtCore/QVarLengthArray>
+
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -233,9 +239,11 @@ void QGeoPath::setVariantPath(const QVariantList &path)
 QVariantList QGeoPath::variantPath() const
 {
     Q_D(const QGeoPath);
+    const QGeoCoordinateArray &path = d->coordinateArray();
     QVariantList p;
-    for (const auto &c: d->path())
-        p << QVariant::fromValue(c);
+    p.reserve(path.size());
+    for (int i = 0; i < path.size(); ++i)
+        p << QVariant::fromValue(path.at(i));
     return p;
 }
 
@@ -399,22 +407,32 @@ QString QGeoPath::toString() const
 *******************************************************************************/
 
 QGeoPathPrivate::QGeoPathPrivate(QGeoShape::ShapeType type)
-:   QGeoShapePrivate(type), m_width(0), m_clipperDirty(true)
+:   QGeoShapePrivate(type), m_pathDirty(false), m_width(0), m_clipperDirty(true)
 {
 }
 
 QGeoPathPrivate::QGeoPathPrivate(QGeoShape::ShapeType type, const QList<QGeoCoordinate> &path, const qreal width)
-:   QGeoShapePrivate(type), m_width(0), m_clipperDirty(true)
+:   QGeoShapePrivate(type), m_pathDirty(false), m_width(0), m_clipperDirty(true)
 {
     setPath(path);
     setWidth(width);
 }
 
+QGeoPathPrivate::QGeoPathPrivate(QGeoShape::ShapeType type, const QGeoCoordinateArray &path, const qreal width)
+:   QGeoShapePrivate(type), m_pathDirty(false), m_width(0), m_clipperDirty(true)
+{
+    setCoordinateArray(path);
+    setWidth(width);
+}
+
 QGeoPathPrivate::QGeoPathPrivate(const QGeoPathPrivate &other)
-:   QGeoShapePrivate(other.type), m_path(other.m_path),
+:   QGeoShapePrivate(other.type), m_coordinates(other.m_coordinates), m_holes(other.m_holes),
     m_deltaXs(other.m_deltaXs), m_minX(other.m_minX), m_maxX(other.m_maxX), m_minLati(other.m_minLati),
     m_maxLati(other.m_maxLati), m_bbox(other.m_bbox), m_width(other.m_width), m_clipperDirty(true)
 {
+    QMutexLocker locker(&other.m_pathMutex);
+    m_path = other.m_path;
+    m_pathDirty = other.m_pathDirty;
 }
 
 QGeoPathPrivate::~QGeoPathPrivate() {}
@@ -430,13 +448,13 @@ bool QGeoPathPrivate::operator==(const QGeoShapePrivate &other) const
         return false;
 
     const QGeoPathPrivate &otherPath = static_cast<const QGeoPathPrivate &>(other);
-    if (m_path.size() != otherPath.m_path.size())
+    if (m_coordinates.size() != otherPath.m_coordinates.size())
         return false;
 
     if (type == QGeoShape::PathType)
-        return m_width == otherPath.m_width && m_path == otherPath.m_path;
+        return m_width == otherPath.m_width && m_coordinates == otherPath.m_coordinates;
     else
-        return m_path == otherPath.m_path;
+        return m_coordinates == otherPath.m_coordinates;
 }
 
 bool QGeoPathPrivate::isValid() const
@@ -444,17 +462,28 @@ bool QGeoPathPrivate::isValid() const
     if (type == QGeoShape::PathType)
         return !isEmpty();
     else
-        return m_path.size() > 2;
+        return m_coordinates.size() > 2;
 
 }
 
 bool QGeoPathPrivate::isEmpty() const
 {
-    return m_path.isEmpty(); // this should perhaps return geometric emptiness, less than 2 points for line, or empty polygon for polygons
+    return m_coordinates.isEmpty(); // this should perhaps return geometric emptiness, less than 2 points for line, or empty polygon for polygons
 }
 
+/*
+    The geometry is computed on m_coordinates. path() returns a reference to
+    a list, which is only built when it is asked for. The list is built under
+    a lock, as concurrent reads of the same shape are allowed; changes detach
+    the private first.
+*/
 const QList<QGeoCoordinate> &QGeoPathPrivate::path() const
 {
+    QMutexLocker locker(&m_pathMutex);
+    if (m_pathDirty) {
+        m_path = m_coordinates.toList();
+        m_pathDirty = false;
+    }
     return m_path;
 }
 
@@ -463,13 +492,46 @@ void QGeoPathPrivate::setPath(const QList<QGeoCoordinate> &path)
     for (const QGeoCoordinate &c: path)
         if (!c.isValid())
             return;
-    m_path = path;
+    m_coordinates = QGeoCoordinateArray(path);
+    m_path = path; // shared, so kept rather than rebuilt
+    m_pathDirty = false;
     computeBoundingBox();
 }
 
-void QGeoPathPrivate::clearPath()
+void QGeoPathPrivate::markPathDirty()
 {
     m_path.clear();
+    m_pathDirty = true;
+}
+
+const QGeoCoordinateArray &QGeoPathPrivate::coordinateArray() const
+{
+    return m_coordinates;
+}
+
+static bool isValidArray(const QGeoCoordinateArray &path)
+{
+    for (int i = 0; i < path.size(); ++i) {
+        const QGeoCoordinateArray::Point &p = path.point(i);
+        if (!QLocationUtils::isValidLat(p.latitude) || !QLocationUtils::isValidLong(p.longitude))
+            return false;
+    }
+    return true;
+}
+
+void QGeoPathPrivate::setCoordinateArray(const QGeoCoordinateArray &path)
+{
+    if (!isValidArray(path))
+        return;
+    m_coordinates = path;
+    markPathDirty();
+    computeBoundingBox();
+}
+
+void QGeoPathPrivate::clearPath()
+{
+    m_coordinates.clear();
+    markPathDirty();
     computeBoundingBox();
 }
 
@@ -487,25 +549,45 @@ void QGeoPathPrivate::setWidth(const qreal &width)
 
 double QGeoPathPrivate::length(int indexFrom, int indexTo) const
 {
-    if (path().isEmpty())
+    if (m_coordinates.isEmpty())
         return 0.0;
 
     bool wrap = indexTo == -1;
-    if (indexTo < 0 || indexTo >= path().size())
-        indexTo = path().size() - 1;
-    double len = 0.0;
+    if (indexTo < 0 || indexTo >= m_coordinates.size())
+        indexTo = m_coordinates.size() - 1;
+
+    QVarLengthArray<double, 256> latitudes;
+    QVarLengthArray<double, 256> longitudes;
+    auto append = [&](int i) {
+        latitudes.append(m_coordinates.latitude(i));
+        longitudes.append(m_coordinates.longitude(i));
+    };
+    if (indexFrom < indexTo) {
+        for (int i = indexFrom; i <= indexTo; i++)
+            append(i);
+    }
+    if (wrap) {
+        if (latitudes.isEmpty())
+            append(m_coordinates.size() - 1);
+        append(0);
+    }
+    if (latitudes.size() < 2)
+        return 0.0;
+
     // TODO: consider calculating the length of the actual rhumb line segments
     // instead of the shortest path from A to B.
-    for (int i = indexFrom; i < indexTo; i++)
-        len += m_path[i].distanceTo(m_path[i+1]);
-    if (wrap)
-        len += m_path.last().distanceTo(m_path.first());
+    QVarLengthArray<double, 256> distances(latitudes.size() - 1);
+    QGeoCoordinateBatch::distances(latitudes.constData(), longitudes.constData(),
+                                   latitudes.size(), distances.data());
+    double len = 0.0;
+    for (double d : qAsConst(distances))
+        len += d;
     return len;
 }
 
 int QGeoPathPrivate::size() const
 {
-    return m_path.size();
+    return m_coordinates.size();
 }
 
 /*!
@@ -521,71 +603,17 @@ bool QGeoPathPrivate::contains(const QGeoCoordinate &coordinate) const
 
 bool QGeoPathPrivate::lineContains(const QGeoCoordinate &coordinate) const
 {
-    // Unoptimized approach:
-    // - consider each segment of the path
-    // - project it into mercator space (rhumb lines are straight in mercator space)
-    // - find closest point to coordinate
-    // - unproject the closest point
-    // - calculate coordinate to closest point distance with distanceTo()
-    // - if not within lineRadius, advance
-    //
-    // To keep wrapping into the equation:
-    //   If the mercator x value of a coordinate of the line, or the coordinate parameter, is less
-    // than mercator(m_bbox).x, add that to the conversion.
-
     double lineRadius = qMax(width() * 0.5, 0.2); // minimum radius: 20cm
 
-    if (!m_path.size())
+    if (!m_coordinates.size())
         return false;
-    else if (m_path.size() == 1)
-        return (m_path[0].distanceTo(coordinate) <= lineRadius);
-
-    double leftBoundMercator = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
+    else if (m_coordinates.size() == 1)
+        return (m_coordinates.at(0).distanceTo(coordinate) <= lineRadius);
 
-    QDoubleVector2D p = QWebMercator::coordToMercator(coordinate);
-    if (p.x() < leftBoundMercator)
-        p.setX(p.x() + leftBoundMercator);  // unwrap X
-
-    QDoubleVector2D a;
-    QDoubleVector2D b;
-    if (m_path.size()) {
-        a = QWebMercator::coordToMercator(m_path[0]);
-        if (a.x() < leftBoundMercator)
-            a.setX(a.x() + leftBoundMercator);  // unwrap X
-    }
-    for (int i = 1; i < m_path.size(); i++) {
-        b = QWebMercator::coordToMercator(m_path[i]);
-        if (b.x() < leftBoundMercator)
-            b.setX(b.x() + leftBoundMercator);  // unwrap X
-        if (b == a)
-            continue;
-
-        double u = ((p.x() - a.x()) * (b.x() - a.x()) + (p.y() - a.y()) * (b.y() - a.y()) ) / (b - a).lengthSquared();
-        QDoubleVector2D intersection(a.x() + u * (b.x() - a.x()) , a.y() + u * (b.y() - a.y()) );
-
-        QDoubleVector2D candidate = ( (p-a).length() < (p-b).length() ) ? a : b;
-
-        if (u > 0 && u < 1
-            && (p-intersection).length() < (p-candidate).length()  ) // And it falls in the segment
-                candidate = intersection;
-
-
-        if (candidate.x() > 1.0)
-            candidate.setX(candidate.x() - leftBoundMercator); // wrap X
-
-        QGeoCoordinate closest = QWebMercator::mercatorToCoord(candidate);
-
-        double distanceMeters = coordinate.distanceTo(closest);
-        if (distanceMeters <= lineRadius)
-            return true;
-
-        // swap
-        a = b;
-    }
+    if (m_clipperDirty)
+        const_cast<QGeoPathPrivate *>(this)->updateClipperPath();
 
-    // Last check if the coordinate is on the left of leftBoundMercator, but close enough to
-    // m_path[0]
-    return (m_path[0].distanceTo(coordinate) <= lineRadius);
+    return m_prepared.lineContains(coordinate, lineRadius);
 }
 
 /*!
@@ -597,24 +625,13 @@ bool QGeoPathPrivate::polygonContains(const QGeoCoordinate &coordinate) const
         const_cast<QGeoPathPrivate *>(this)->updateClipperPath();
 
     // iterates the holes List checking whether the point is contained inside the holes
-    for (const QList<QGeoCoordinate> &holePath : qAsConst(m_holesList)) {
-
-        QGeoPolygon holePolygon;
-        holePolygon.setPath(holePath);
-        QGeoPath holeBoundary;
-        holeBoundary.setPath(holePath);
-
-        if (holePolygon.contains(coordinate) && !(holeBoundary.contains(coordinate)))
+    for (int i = 0; i < m_preparedHoles.size(); i += 2) {
+        if (m_preparedHoles.at(i).pointInPolygon(coordinate) != 0
+                && !m_preparedHoles.at(i + 1).lineContains(coordinate, 0.2))
             return false;
     }
 
-    QDoubleVector2D coord = QWebMercator::coordToMercator(coordinate);
-    double tlx = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
-    if (coord.x() < tlx)
-        coord.setX(coord.x() + 1.0);
-
-    IntPoint intCoord = QClipperUtils::toIntPoint(coord);
-    return c2t::clip2tri::pointInPolygon(intCoord, m_clipperPath) != 0;
+    return m_prepared.pointInPolygon(coordinate) != 0;
 }
 
 QGeoCoordinate QGeoPathPrivate::center() const
@@ -634,107 +651,120 @@ void QGeoPathPrivate::extendShape(const QGeoCoordinate &coordinate)
     addCoordinate(coordinate);
 }
 
+static void translateArray(QGeoCoordinateArray &path, double degreesLatitude, double degreesLongitude)
+{
+    QGeoCoordinateArray::Point *p = path.data();
+    for (int i = 0; i < path.size(); ++i) {
+        p[i].latitude += degreesLatitude;
+        p[i].longitude = QLocationUtils::wrapLong(p[i].longitude + degreesLongitude);
+    }
+}
+
 void QGeoPathPrivate::translate(double degreesLatitude, double degreesLongitude)
 {
     if (degreesLatitude > 0.0)
         degreesLatitude = qMin(degreesLatitude, 90.0 - m_maxLati);
     else
         degreesLatitude = qMax(degreesLatitude, -90.0 - m_minLati);
-    for (QGeoCoordinate &p: m_path) {
-        p.setLatitude(p.latitude() + degreesLatitude);
-        p.setLongitude(QLocationUtils::wrapLong(p.longitude() + degreesLongitude));
-    }
-    if (!m_holesList.isEmpty()){
-        for (QList<QGeoCoordinate> &hole: m_holesList){
-            for (QGeoCoordinate &holeVertex: hole){
-                holeVertex.setLatitude(holeVertex.latitude() + degreesLatitude);
-                holeVertex.setLongitude(QLocationUtils::wrapLong(holeVertex.longitude() + degreesLongitude));
-            }
-        }
-    }
+    translateArray(m_coordinates, degreesLatitude, degreesLongitude);
+    for (QGeoCoordinateArray &hole : m_holes)
+        translateArray(hole, degreesLatitude, degreesLongitude);
+    markPathDirty();
     m_bbox.translate(degreesLatitude, degreesLongitude);
     m_minLati += degreesLatitude;
     m_maxLati += degreesLatitude;
+    m_clipperDirty = true;
 }
 
 void QGeoPathPrivate::addCoordinate(const QGeoCoordinate &coordinate)
 {
     if (!coordinate.isValid())
         return;
-    m_path.append(coordinate);
+    m_coordinates.append(coordinate);
+    if (!m_pathDirty && !m_path.isEmpty())
+        m_path.append(coordinate); // in use, cheaper than building it again
+    else
+        markPathDirty();
     updateBoundingBox();
 }
 
 void QGeoPathPrivate::insertCoordinate(int index, const QGeoCoordinate &coordinate)
 {
-    if (index < 0 || index > m_path.size() || !coordinate.isValid())
+    if (index < 0 || index > m_coordinates.size() || !coordinate.isValid())
         return;
 
-    m_path.insert(index, coordinate);
+    m_coordinates.insert(index, coordinate);
+    markPathDirty();
     computeBoundingBox();
 }
 
 void QGeoPathPrivate::replaceCoordinate(int index, const QGeoCoordinate &coordinate)
 {
-    if (index < 0 || index >= m_path.size() || !coordinate.isValid())
+    if (index < 0 || index >= m_coordinates.size() || !coordinate.isValid())
         return;
 
-    m_path[index] = coordinate;
+    m_coordinates.replace(index, coordinate);
+    markPathDirty();
     computeBoundingBox();
 }
 
 QGeoCoordinate QGeoPathPrivate::coordinateAt(int index) const
 {
-    if (index < 0 || index >= m_path.size())
+    if (index < 0 || index >= m_coordinates.size())
         return QGeoCoordinate();
 
-    return m_path.at(index);
+    return m_coordinates.at(index);
 }
 
 bool QGeoPathPrivate::containsCoordinate(const QGeoCoordinate &coordinate) const
 {
-    return m_path.indexOf(coordinate) > -1;
+    return m_coordinates.indexOf(coordinate) > -1;
 }
 
 void QGeoPathPrivate::removeCoordinate(const QGeoCoordinate &coordinate)
 {
-    int index = m_path.lastIndexOf(coordinate);
+    int index = m_coordinates.lastIndexOf(coordinate);
     removeCoordinate(index);
 }
 
 void QGeoPathPrivate::removeCoordinate(int index)
 {
-    if (index < 0 || index >= m_path.size())
+    if (index < 0 || index >= m_coordinates.size())
         return;
 
-    m_path.removeAt(index);
+    m_coordinates.remove(index);
+    markPathDirty();
     computeBoundingBox();
 }
 
-void QGeoPathPrivate::computeBoundingBox()
-{
-    m_clipperDirty = true;
-    if (m_path.isEmpty()) {
-        m_deltaXs.clear();
-        m_minX = qInf();
-        m_maxX = -qInf();
-        m_minLati = qInf();
-        m_maxLati = -qInf();
-        m_bbox = QGeoRectangle();
-        return;
-    }
-
-    m_minLati = m_maxLati = m_path.at(0).latitude();
+/*
+    Bounding box of a path that may cross the antimeridian, but not the poles.
+    The longitudes are unwrapped along the path, their offsets from the first
+    one are stored in deltaXs when given, and their range in minX and maxX.
+*/
+static QGeoRectangle pathBoundingBox(const QGeoCoordinateArray &path, QVector<double> *deltaXs = nullptr,
+                                     double *minX = nullptr, double *maxX = nullptr)
+{
+    if (path.isEmpty())
+        return QGeoRectangle();
+
+    const QGeoCoordinateArray::Point *points = path.constData();
+    double minLati = points[0].latitude;
+    double maxLati = minLati;
+    double deltaX = 0.0;
+    double minDeltaX = 0.0;
+    double maxDeltaX = 0.0;
     int minId = 0;
     int maxId = 0;
-    m_deltaXs.resize(m_path.size());
-    m_deltaXs[0] = m_minX = m_maxX = 0.0;
-
-    for (int i = 1; i < m_path.size(); i++) {
-        const QGeoCoordinate &geoFrom = m_path.at(i-1);
-        const QGeoCoordinate &geoTo   = m_path.at(i);
-        double longiFrom    = geoFrom.longitude();
-        double longiTo      = geoTo.longitude();
+    if (deltaXs) {
+        deltaXs->resize(path.size());
+        (*deltaXs)[0] = 0.0;
+    }
+    for (int i = 1; i < path.size(); i++) {
+        const QGeoCoordinateArray::Point &geoFrom = points[i-1];
+        const QGeoCoordinateArray::Point &geoTo   = points[i];
+        double longiFrom    = geoFrom.longitude;
+        double longiTo      = geoTo.longitude;
         double deltaLongi = longiTo - longiFrom;
         if (qAbs(deltaLongi) > 180.0) {
             if (longiTo > 0.0)
@@ -743,29 +773,54 @@ void QGeoPathPrivate::computeBoundingBox()
                 longiTo += 360.0;
             deltaLongi =  longiTo - longiFrom;
         }
-        m_deltaXs[i] = m_deltaXs[i-1] + deltaLongi;
-        if (m_deltaXs[i] < m_minX) {
-            m_minX = m_deltaXs[i];
+        deltaX += deltaLongi;
+        if (deltaXs)
+            (*deltaXs)[i] = deltaX;
+        if (deltaX < minDeltaX) {
+            minDeltaX = deltaX;
             minId = i;
         }
-        if (m_deltaXs[i] > m_maxX) {
-            m_maxX = m_deltaXs[i];
+        if (deltaX > maxDeltaX) {
+            maxDeltaX = deltaX;
             maxId = i;
         }
-        if (geoTo.latitude() > m_maxLati)
-            m_maxLati = geoTo.latitude();
-        if (geoTo.latitude() < m_minLati)
-            m_minLati = geoTo.latitude();
+        if (geoTo.latitude > maxLati)
+            maxLati = geoTo.latitude;
+        if (geoTo.latitude < minLati)
+            minLati = geoTo.latitude;
+    }
+
+    if (minX)
+        *minX = minDeltaX;
+    if (maxX)
+        *maxX = maxDeltaX;
+    return QGeoRectangle(QGeoCoordinate(maxLati, points[minId].longitude),
+                         QGeoCoordinate(minLati, points[maxId].longitude));
+}
+
+void QGeoPathPrivate::computeBoundingBox()
+{
+    m_clipperDirty = true;
+    if (m_coordinates.isEmpty()) {
+        m_deltaXs.clear();
+        m_minX = qInf();
+        m_maxX = -qInf();
+        m_minLati = qInf();
+        m_maxLati = -qInf();
+        m_bbox = QGeoRectangle();
+        return;
     }
 
-    m_bbox = QGeoRectangle(QGeoCoordinate(m_maxLati, m_path.at(minId).longitude()),
-                           QGeoCoordinate(m_minLati, m_path.at(maxId).longitude()));
+    m_bbox = pathBoundingBox(m_coordinates, &m_deltaXs, &m_minX, &m_maxX);
+    m_maxLati = m_bbox.topLeft().latitude();
+    m_minLati = m_bbox.bottomRight().latitude();
 }
 
 void QGeoPathPrivate::updateBoundingBox()
 {
     m_clipperDirty = true;
-    if (m_path.isEmpty()) {
+    const int count = m_coordinates.size();
+    if (count == 0) {
         m_deltaXs.clear();
         m_minX = qInf();
         m_maxX = -qInf();
@@ -773,22 +828,22 @@ void QGeoPathPrivate::updateBoundingBox()
         m_maxLati = -qInf();
         m_bbox = QGeoRectangle();
         return;
-    } else if (m_path.size() == 1) { // was 0  now is 1
+    } else if (count == 1) { // was 0  now is 1
         m_deltaXs.resize(1);
         m_deltaXs[0] = m_minX = m_maxX = 0.0;
-        m_minLati = m_maxLati = m_path.at(0).latitude();
-        m_bbox = QGeoRectangle(QGeoCoordinate(m_maxLati, m_path.at(0).longitude()),
-                               QGeoCoordinate(m_minLati, m_path.at(0).longitude()));
+        m_minLati = m_maxLati = m_coordinates.latitude(0);
+        m_bbox = QGeoRectangle(QGeoCoordinate(m_maxLati, m_coordinates.longitude(0)),
+                               QGeoCoordinate(m_minLati, m_coordinates.longitude(0)));
         return;
-    } else if ( m_path.size() != m_deltaXs.size() + 1 ) {  // this case should not happen
+    } else if ( count != m_deltaXs.size() + 1 ) {  // this case should not happen
         computeBoundingBox(); // something went wrong
         return;
     }
 
-    const QGeoCoordinate &geoFrom = m_path.at(m_path.size()-2);
-    const QGeoCoordinate &geoTo   = m_path.last();
-    double longiFrom    = geoFrom.longitude();
-    double longiTo      = geoTo.longitude();
+    const QGeoCoordinateArray::Point &geoFrom = m_coordinates.point(count - 2);
+    const QGeoCoordinateArray::Point &geoTo   = m_coordinates.point(count - 1);
+    double longiFrom    = geoFrom.longitude;
+    double longiTo      = geoTo.longitude;
     double deltaLongi = longiTo - longiFrom;
     if (qAbs(deltaLongi) > 180.0) {
         if (longiTo > 0.0)
@@ -803,16 +858,16 @@ void QGeoPathPrivate::updateBoundingBox()
     double currentMaxLongi = m_bbox.bottomRight().longitude();
     if (m_deltaXs.last() < m_minX) {
         m_minX = m_deltaXs.last();
-        currentMinLongi = geoTo.longitude();
+        currentMinLongi = geoTo.longitude;
     }
     if (m_deltaXs.last() > m_maxX) {
         m_maxX = m_deltaXs.last();
-        currentMaxLongi = geoTo.longitude();
+        currentMaxLongi = geoTo.longitude;
     }
-    if (geoTo.latitude() > m_maxLati)
-        m_maxLati = geoTo.latitude();
-    if (geoTo.latitude() < m_minLati)
-        m_minLati = geoTo.latitude();
+    if (geoTo.latitude > m_maxLati)
+        m_maxLati = geoTo.latitude;
+    if (geoTo.latitude < m_minLati)
+        m_minLati = geoTo.latitude;
     m_bbox = QGeoRectangle(QGeoCoordinate(m_maxLati, currentMinLongi),
                            QGeoCoordinate(m_minLati, currentMaxLongi));
 }
@@ -820,15 +875,24 @@ void QGeoPathPrivate::updateBoundingBox()
 void QGeoPathPrivate::updateClipperPath()
 {
     m_clipperDirty = false;
-    double tlx = QWebMercator::coordToMercator(m_bbox.topLeft()).x();
-    QList<QDoubleVector2D> preservedPath;
-    for (const QGeoCoordinate &c : m_path) {
-        QDoubleVector2D crd = QWebMercator::coordToMercator(c);
-        if (crd.x() < tlx)
-            crd.setX(crd.x() + 1.0);
-        preservedPath << crd;
+    m_preparedHoles.clear();
+
+    if (type == QGeoShape::PathType) {
+        m_prepared.prepare(m_coordinates, m_bbox, QGeoPreparedPath::Line);
+        return;
+    }
+
+    m_prepared.prepare(m_coordinates, m_bbox, QGeoPreparedPath::Polygon);
+
+    // Holes are tested as a polygon, and as a boundary line of default width
+    // that still counts as inside
+    m_preparedHoles.resize(2 * m_holes.size());
+    for (int i = 0; i < m_holes.size(); ++i) {
+        const QGeoCoordinateArray &holePath = m_holes.at(i);
+        const QGeoRectangle holeBox = pathBoundingBox(holePath);
+        m_preparedHoles[2 * i].prepare(holePath, holeBox, QGeoPreparedPath::Polygon);
+        m_preparedHoles[2 * i + 1].prepare(holePath, holeBox, QGeoPreparedPath::Line);
     }
-    m_clipperPath = QClipperUtils::qListToPath(preservedPath);
 }
 
 
@@ -841,7 +905,20 @@ void QGeoPathPrivate::addHole(const QList<QGeoCoordinate> &holePath)
         if (!holeVertex.isValid())
             return;
 
-    m_holesList << holePath;
+    m_holes << QGeoCoordinateArray(holePath);
+    m_clipperDirty = true;
+}
+
+/*!
+    \overload
+*/
+void QGeoPathPrivate::addHole(const QGeoCoordinateArray &holePath)
+{
+    if (!isValidArray(holePath))
+        return;
+
+    m_holes << holePath;
+    m_clipperDirty = true;
 }
 
 /*!
@@ -849,19 +926,27 @@ void QGeoPathPrivate::addHole(const QList<QGeoCoordinate> &holePath)
 */
 const QList<QGeoCoordinate> QGeoPathPrivate::holePath(int index) const
 {
-    return m_holesList.at(index);
+    return m_holes.at(index).toList();
 }
 
+/*!
+    Returns the coordinates of the hole at \a index.
+*/
+const QGeoCoordinateArray &QGeoPathPrivate::holeCoordinateArray(int index) const
+{
+    return m_holes.at(index);
+}
 
 /*!
     Removes element at position \a index from the holes QList.
 */
 void QGeoPathPrivate::removeHole(int index)
 {
-    if (index < 0 || index >= m_holesList.size())
+    if (index < 0 || index >= m_holes.size())
         return;
 
-    m_holesList.removeAt(index);
+    m_holes.remove(index);
+    m_clipperDirty = true;
 }
 
 /*!
@@ -869,7 +954,233 @@ void QGeoPathPrivate::removeHole(int index)
 */
 int QGeoPathPrivate::holesCount() const
 {
-    return m_holesList.size();
+    return m_holes.size();
+}
+
+/*******************************************************************************
+ * QGeoPreparedPath
+*******************************************************************************/
+
+QGeoPreparedPath::QGeoPreparedPath()
+:   m_leftBound(0.0), m_minY(0.0), m_maxY(0.0), m_slabScale(0.0), m_slabCount(0)
+{
+}
+
+void QGeoPreparedPath::prepare(const QGeoCoordinateArray &path, const QGeoRectangle &bbox, Mode mode)
+{
+    m_first = path.isEmpty() ? QGeoCoordinate() : path.at(0);
+    m_points.clear();
+    m_intPoints.clear();
+    m_slabOffsets.clear();
+    m_slabEdges.clear();
+    m_slabCount = 0;
+
+    if (path.isEmpty())
+        return;
+
+    m_leftBound = QWebMercator::coordToMercator(bbox.topLeft()).x();
+
+    const QGeoCoordinateArray::Point *points = path.constData();
+    QVector<double> ys;
+    if (mode == Polygon) {
+        // Projected one by one like the probed coordinates, so that a vertex
+        // always tests as on the boundary
+        ys.reserve(path.size());
+        m_intPoints.reserve(path.size());
+        for (int i = 0; i < path.size(); ++i) {
+            QDoubleVector2D crd = QWebMercator::coordToMercator(points[i].latitude, points[i].longitude);
+            if (crd.x() < m_leftBound)
+                crd.setX(crd.x() + 1.0);
+            m_intPoints.push_back(QClipperUtils::toIntPoint(crd));
+            ys.append(double(m_intPoints.back().Y));
+        }
+        buildSlabs(ys, path.size());
+    } else {
+        QVarLengthArray<double, 256> latitudes(path.size());
+        QVarLengthArray<double, 256> longitudes(path.size());
+        for (int i = 0; i < path.size(); ++i) {
+            latitudes[i] = points[i].latitude;
+            longitudes[i] = points[i].longitude;
+        }
+        QVarLengthArray<double, 256> xs(path.size());
+        ys.resize(path.size());
+        QGeoCoordinateBatch::toMercator(latitudes.constData(), longitudes.constData(), path.size(),
+                                        xs.data(), ys.data());
+
+        m_points.resize(path.size());
+        for (int i = 0; i < path.size(); ++i) {
+            double x = xs[i];
+            if (x < m_leftBound)
+                x += m_leftBound;  // unwrap X
+            m_points[i] = QDoubleVector2D(x, ys.at(i));
+        }
+        buildSlabs(ys, path.size() - 1);
+    }
+}
+
+void QGeoPreparedPath::buildSlabs(const QVector<double> &ys, int edgeCount)
+{
+    if (edgeCount < 1)
+        return;
+
+    const int count = ys.size();
+    m_minY = *std::min_element(ys.cbegin(), ys.cend());
+    m_maxY = *std::max_element(ys.cbegin(), ys.cend());
+    m_slabCount = qBound(1, edgeCount / 2, 4096);
+    m_slabScale = m_maxY > m_minY ? m_slabCount / (m_maxY - m_minY) : 0.0;
+
+    // Counting pass, then every edge is listed in all the slabs it spans
+    m_slabOffsets.fill(0, m_slabCount + 1);
+    for (int i = 0; i < edgeCount; ++i) {
+        const double y0 = ys.at(i);
+        const double y1 = ys.at((i + 1) % count);
+        const int last = slabAt(qMax(y0, y1));
+        for (int s = slabAt(qMin(y0, y1)); s <= last; ++s)
+            ++m_slabOffsets[s + 1];
+    }
+    for (int s = 0; s < m_slabCount; ++s)
+        m_slabOffsets[s + 1] += m_slabOffsets[s];
+
+    m_slabEdges.resize(m_slabOffsets.last());
+    QVector<int> fill(m_slabOffsets);
+    for (int i = 0; i < edgeCount; ++i) {
+        const double y0 = ys.at(i);
+        const double y1 = ys.at((i + 1) % count);
+        const int last = slabAt(qMax(y0, y1));
+        for (int s = slabAt(qMin(y0, y1)); s <= last; ++s)
+            m_slabEdges[fill[s]++] = i;
+    }
+}
+
+int QGeoPreparedPath::slabAt(double y) const
+{
+    return int(qBound(0.0, (y - m_minY) * m_slabScale, double(m_slabCount - 1)));
+}
+
+/*
+    Returns 0 if \a coordinate is outside the polygon, +1 if it is inside and
+    -1 if it is on the boundary, like c2t::clip2tri::pointInPolygon().
+*/
+int QGeoPreparedPath::pointInPolygon(const QGeoCoordinate &coordinate) const
+{
+    if (m_intPoints.size() < 3 || !coordinate.isValid())
+        return 0;
+
+    QDoubleVector2D coord = QWebMercator::coordToMercator(coordinate);
+    if (coord.x() < m_leftBound)
+        coord.setX(coord.x() + 1.0);
+    const IntPoint pt = QClipperUtils::toIntPoint(coord);
+
+    const double y = double(pt.Y);
+    if (y < m_minY || y > m_maxY)
+        return 0;
+
+    // Same crossing rules as ClipperLib::PointInPolygon(), restricted to the
+    // edges whose vertical extent includes the point
+    const int cnt = int(m_intPoints.size());
+    const int slab = slabAt(y);
+    int result = 0;
+    for (int k = m_slabOffsets.at(slab), end = m_slabOffsets.at(slab + 1); k < end; ++k) {
+        const int i = m_slabEdges.at(k);
+        const IntPoint &ip = m_intPoints[i];
+        const IntPoint &ipNext = m_intPoints[i + 1 == cnt ? 0 : i + 1];
+        if (ipNext.Y == pt.Y) {
+            if ((ipNext.X == pt.X) || (ip.Y == pt.Y &&
+                ((ipNext.X > pt.X) == (ip.X < pt.X))))
+                return -1;
+        }
+        if ((ip.Y < pt.Y) != (ipNext.Y < pt.Y)) {
+            if (ip.X >= pt.X) {
+                if (ipNext.X > pt.X) {
+                    result = 1 - result;
+                } else {
+                    double d = double(ip.X - pt.X) * (ipNext.Y - pt.Y) -
+                            double(ipNext.X - pt.X) * (ip.Y - pt.Y);
+                    if (!d)
+                        return -1;
+                    if ((d > 0) == (ipNext.Y > ip.Y))
+                        result = 1 - result;
+                }
+            } else if (ipNext.X > pt.X) {
+                double d = double(ip.X - pt.X) * (ipNext.Y - pt.Y) -
+                        double(ipNext.X - pt.X) * (ip.Y - pt.Y);
+                if (!d)
+                    return -1;
+                if ((d > 0) == (ipNext.Y > ip.Y))
+                    result = 1 - result;
+            }
+        }
+    }
+    return result;
+}
+
+bool QGeoPreparedPath::lineContains(const QGeoCoordinate &coordinate, double lineRadius) const
+{
+    // Approach:
+    // - consider each segment of the path near the coordinate
+    // - find closest point to coordinate in mercator space (rhumb lines are straight there)
+    // - unproject the closest point
+    // - calculate coordinate to closest point distance with distanceTo()
+    // - if not within lineRadius, advance
+    //
+    // To keep wrapping into the equation:
+    //   If the mercator x value of a coordinate of the line, or the coordinate parameter, is less
+    // than mercator(m_bbox).x, add that to the conversion.
+
+    if (m_points.size() > 1 && coordinate.isValid()) {
+        QDoubleVector2D p = QWebMercator::coordToMercator(coordinate);
+        if (p.x() < m_leftBound)
+            p.setX(p.x() + m_leftBound);  // unwrap X
+
+        // A point within lineRadius is at most that far north or south of the
+        // coordinate, which bounds the mercator y of the segments to test.
+        const double deltaLatitude = qRadiansToDegrees(lineRadius / QLocationUtils::earthMeanRadius()) * 1.001;
+        const double north = qMin(coordinate.latitude() + deltaLatitude, 90.0);
+        const double south = qMax(coordinate.latitude() - deltaLatitude, -90.0);
+        const double top = QWebMercator::coordToMercator(QGeoCoordinate(north, 0.0)).y() - 1e-9;
+        const double bottom = QWebMercator::coordToMercator(QGeoCoordinate(south, 0.0)).y() + 1e-9;
+
+        if (bottom >= m_minY && top <= m_maxY) {
+            const int firstSlab = slabAt(top);
+            const int lastSlab = slabAt(bottom);
+            for (int slab = firstSlab; slab <= lastSlab; ++slab) {
+                for (int k = m_slabOffsets.at(slab), end = m_slabOffsets.at(slab + 1); k < end; ++k) {
+                    const int i = m_slabEdges.at(k);
+                    const QDoubleVector2D &a = m_points.at(i);
+                    const QDoubleVector2D &b = m_points.at(i + 1);
+
+                    // Edges spanning several slabs are only tested in the first one
+                    const double minY = qMin(a.y(), b.y());
+                    if (slab != qMax(firstSlab, slabAt(minY)))
+                        continue;
+                    if (minY > bottom || qMax(a.y(), b.y()) < top || b == a)
+                        continue;
+
+                    double u = ((p.x() - a.x()) * (b.x() - a.x()) + (p.y() - a.y()) * (b.y() - a.y()) ) / (b - a).lengthSquared();
+                    QDoubleVector2D intersection(a.x() + u * (b.x() - a.x()) , a.y() + u * (b.y() - a.y()) );
+
+                    QDoubleVector2D candidate = ( (p-a).length() < (p-b).length() ) ? a : b;
+
+                    if (u > 0 && u < 1
+                        && (p-intersection).length() < (p-candidate).length()  ) // And it falls in the segment
+                            candidate = intersection;
+
+                    if (candidate.x() > 1.0)
+                        candidate.setX(candidate.x() - m_leftBound); // wrap X
+
+                    QGeoCoordinate closest = QWebMercator::mercatorToCoord(candidate);
+
+                    double distanceMeters = coordinate.distanceTo(closest);
+                    if (distanceMeters <= lineRadius)
+                        return true;
+                }
+            }
+        }
+    }
+
+    // Last check if the coordinate is on the left of leftBoundMercator, but close enough to
+    // m_path[0]
+    return (m_first.distanceTo(coordinate) <= lineRadius);
 }
 
 QT_END_NAMESPACE
@@ -53,18 +53,55 @@
 
 #include "qgeoshape_p.h"
 #include "qgeocoordinate.h"
+#include "qgeocoordinatearray_p.h"
+#include "qgeorectangle.h"
 #include "qlocationutils_p.h"
 #include <QtPositioning/private/qclipperutils_p.h>
 
 #include <QtCore/QVector>
+#include <QtCore/QMutex>
 
 QT_BEGIN_NAMESPACE
 
+// Mercator projection of a path with its edges bucketed into horizontal slabs,
+// so that containment tests only visit the edges near the probed latitude.
+class QGeoPreparedPath
+{
+public:
+    enum Mode {
+        Polygon,
+        Line
+    };
+
+    QGeoPreparedPath();
+
+    void prepare(const QGeoCoordinateArray &path, const QGeoRectangle &bbox, Mode mode);
+
+    int pointInPolygon(const QGeoCoordinate &coordinate) const;
+    bool lineContains(const QGeoCoordinate &coordinate, double lineRadius) const;
+
+private:
+    void buildSlabs(const QVector<double> &ys, int edgeCount);
+    int slabAt(double y) const;
+
+    QGeoCoordinate m_first;
+    QVector<QDoubleVector2D> m_points; // Line mode, unwrapped past m_leftBound
+    Path m_intPoints;                  // Polygon mode, as fed to clipper
+    double m_leftBound;
+    double m_minY;
+    double m_maxY;
+    double m_slabScale;
+    int m_slabCount;
+    QVector<int> m_slabOffsets;        // start of each slab in m_slabEdges
+    QVector<int> m_slabEdges;          // index of the first vertex of each edge
+};
+
 class QGeoPathPrivate : public QGeoShapePrivate
 {
 public:
     QGeoPathPrivate(QGeoShape::ShapeType type);
     QGeoPathPrivate(QGeoShape::ShapeType type, const QList<QGeoCoordinate> &path, const qreal width = 0.0);
+    QGeoPathPrivate(QGeoShape::ShapeType type, const QGeoCoordinateArray &path, const qreal width = 0.0);
     QGeoPathPrivate(const QGeoPathPrivate &other);
     ~QGeoPathPrivate();
 
@@ -85,6 +122,8 @@ public:
 
     const QList<QGeoCoordinate> &path() const;
     void setPath(const QList<QGeoCoordinate> &path);
+    const QGeoCoordinateArray &coordinateArray() const;
+    void setCoordinateArray(const QGeoCoordinateArray &path);
     void clearPath();
 
     qreal width() const;
@@ -98,17 +137,24 @@ public:
     bool containsCoordinate(const QGeoCoordinate &coordinate) const;
     void removeCoordinate(const QGeoCoordinate &coordinate);
     void removeCoordinate(int index);
+    void markPathDirty();
     void computeBoundingBox();
     void updateBoundingBox();
     void updateClipperPath();
     void addHole(const QList<QGeoCoordinate> &holePath);
+    void addHole(const QGeoCoordinateArray &holePath);
     const QList<QGeoCoordinate> holePath(int index) const;
+    const QGeoCoordinateArray &holeCoordinateArray(int index) const;
     void removeHole(int index);
     int holesCount() const;
 
 
-    QList<QGeoCoordinate> m_path;
-    QList<QList<QGeoCoordinate>> m_holesList;
+    QGeoCoordinateArray m_coordinates;
+    // m_coordinates as returned by path(), built on the first call after a change
+    mutable QList<QGeoCoordinate> m_path;
+    mutable bool m_pathDirty;
+    mutable QMutex m_pathMutex;
+    QVector<QGeoCoordinateArray> m_holes;
     QVector<double> m_deltaXs; // longitude deltas from m_path[0]
     double m_minX;             // minimum value inside deltaXs
     double m_maxX;             // maximum value inside deltaXs
@@ -117,7 +163,8 @@ public:
     QGeoRectangle m_bbox;
     qreal m_width;
     bool m_clipperDirty;
-    QtClipperLib::Path m_clipperPath;
+    QGeoPreparedPath m_prepared;
+    QVector<QGeoPreparedPath> m_preparedHoles; // area and boundary of each hole
 };
 
 QT_END_NAMESPACE
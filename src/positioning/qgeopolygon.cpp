@@ -219,9 +219,11 @@ void QGeoPolygon::setPerimeter(const QVariantList &path)
 QVariantList QGeoPolygon::perimeter() const
 {
     Q_D(const QGeoPolygon);
+    const QGeoCoordinateArray &path = d->coordinateArray();
     QVariantList p;
-    for (const auto &c: d->path())
-        p << QVariant::fromValue(c);
+    p.reserve(path.size());
+    for (int i = 0; i < path.size(); ++i)
+        p << QVariant::fromValue(path.at(i));
     return p;
 }
 
@@ -393,9 +395,10 @@ void QGeoPolygon::addHole(const QList<QGeoCoordinate> &holePath)
 const QVariantList QGeoPolygon::hole(int index) const
 {
     Q_D(const QGeoPolygon);
+    const QGeoCoordinateArray &holePath = d->holeCoordinateArray(index);
     QVariantList holeCoordinates;
-    for (const QGeoCoordinate &coords: d->holePath(index))
-        holeCoordinates << QVariant::fromValue(coords);
+    for (int i = 0; i < holePath.size(); ++i)
+        holeCoordinates << QVariant::fromValue(holePath.at(i));
     return holeCoordinates;
 }
 
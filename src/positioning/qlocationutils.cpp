@@ -40,9 +40,9 @@
 ****************************************************************************/
 #include "qlocationutils_p.h"
 #include "qgeopositioninfo.h"
+#include "qnmeatokenizer_p.h"
 
 #include <QTime>
-#include <QList>
 #include <QByteArray>
 #include <QDebug>
 
@@ -50,34 +50,24 @@
 
 QT_BEGIN_NAMESPACE
 
-// converts e.g. 15306.0235 from NMEA sentence to 153.100392
-static double qlocationutils_nmeaDegreesToDecimal(double nmeaDegrees)
-{
-    double deg;
-    double min = 100.0 * modf(nmeaDegrees / 100.0, &deg);
-    return deg + (min / 60.0);
-}
-
-static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo *info, double uere,
+static void qlocationutils_readGga(const QNmeaTokenizer &parts, QGeoPositionInfo *info, double uere,
                                    bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
     QGeoCoordinate coord;
 
-    if (hasFix && parts.count() > 6 && parts[6].count() > 0)
+    if (hasFix && parts.count() > 6 && parts[6].size() > 0)
         *hasFix = parts[6].toInt() > 0;
 
-    if (parts.count() > 1 && parts[1].count() > 0) {
+    if (parts.count() > 1 && parts[1].size() > 0) {
         QTime time;
         if (QLocationUtils::getNmeaTime(parts[1], &time))
             info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
     }
 
-    if (parts.count() > 5 && parts[3].count() == 1 && parts[5].count() == 1) {
+    if (parts.count() > 5 && parts[3].size() == 1 && parts[5].size() == 1) {
         double lat;
         double lng;
-        if (QLocationUtils::getNmeaLatLong(parts[2], parts[3][0], parts[4], parts[5][0], &lat, &lng)) {
+        if (QLocationUtils::getNmeaLatLong(parts[2], parts[3].at(0), parts[4], parts[5].at(0), &lat, &lng)) {
             coord.setLatitude(lat);
             coord.setLongitude(lng);
         }
@@ -90,7 +80,7 @@ static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo
             info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * hdop * uere);
     }
 
-    if (parts.count() > 9 && parts[9].count() > 0) {
+    if (parts.count() > 9 && parts[9].size() > 0) {
         bool hasAlt = false;
         double alt = parts[9].toDouble(&hasAlt);
         if (hasAlt)
@@ -101,11 +91,9 @@ static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo
         info->setCoordinate(coord);
 }
 
-static void qlocationutils_readGsa(const char *data, int size, QGeoPositionInfo *info, double uere,
+static void qlocationutils_readGsa(const QNmeaTokenizer &parts, QGeoPositionInfo *info, double uere,
                                    bool *hasFix)
 {
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
-
     if (hasFix && parts.count() > 2 && !parts[2].isEmpty())
         *hasFix = parts[2].toInt() > 0;
 
@@ -124,25 +112,23 @@ static void qlocationutils_readGsa(const char *data, int size, QGeoPositionInfo
     }
 }
 
-static void qlocationutils_readGll(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+static void qlocationutils_readGll(const QNmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
     QGeoCoordinate coord;
 
-    if (hasFix && parts.count() > 6 && parts[6].count() > 0)
-        *hasFix = (parts[6][0] == 'A');
+    if (hasFix && parts.count() > 6 && parts[6].size() > 0)
+        *hasFix = (parts[6].at(0) == 'A');
 
-    if (parts.count() > 5 && parts[5].count() > 0) {
+    if (parts.count() > 5 && parts[5].size() > 0) {
         QTime time;
         if (QLocationUtils::getNmeaTime(parts[5], &time))
             info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
     }
 
-    if (parts.count() > 4 && parts[2].count() == 1 && parts[4].count() == 1) {
+    if (parts.count() > 4 && parts[2].size() == 1 && parts[4].size() == 1) {
         double lat;
         double lng;
-        if (QLocationUtils::getNmeaLatLong(parts[1], parts[2][0], parts[3], parts[4][0], &lat, &lng)) {
+        if (QLocationUtils::getNmeaLatLong(parts[1], parts[2].at(0), parts[3], parts[4].at(0), &lat, &lng)) {
             coord.setLatitude(lat);
             coord.setLongitude(lng);
         }
@@ -152,32 +138,25 @@ static void qlocationutils_readGll(const char *data, int size, QGeoPositionInfo
         info->setCoordinate(coord);
 }
 
-static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+static void qlocationutils_readRmc(const QNmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
     QGeoCoordinate coord;
     QDate date;
     QTime time;
 
-    if (hasFix && parts.count() > 2 && parts[2].count() > 0)
-        *hasFix = (parts[2][0] == 'A');
+    if (hasFix && parts.count() > 2 && parts[2].size() > 0)
+        *hasFix = (parts[2].at(0) == 'A');
 
-    if (parts.count() > 9 && parts[9].count() == 6) {
-        date = QDate::fromString(QString::fromLatin1(parts[9]), QStringLiteral("ddMMyy"));
-        if (date.isValid())
-            date = date.addYears(100);     // otherwise starts from 1900
-        else
-            date = QDate();
-    }
+    if (parts.count() > 9 && parts[9].size() == 6)
+        parts[9].toDate(&date);     // two-digit year, taken to be after 2000
 
-    if (parts.count() > 1 && parts[1].count() > 0)
+    if (parts.count() > 1 && parts[1].size() > 0)
         QLocationUtils::getNmeaTime(parts[1], &time);
 
-    if (parts.count() > 6 && parts[4].count() == 1 && parts[6].count() == 1) {
+    if (parts.count() > 6 && parts[4].size() == 1 && parts[6].size() == 1) {
         double lat;
         double lng;
-        if (QLocationUtils::getNmeaLatLong(parts[3], parts[4][0], parts[5], parts[6][0], &lat, &lng)) {
+        if (QLocationUtils::getNmeaLatLong(parts[3], parts[4].at(0), parts[5], parts[6].at(0), &lat, &lng)) {
             coord.setLatitude(lat);
             coord.setLongitude(lng);
         }
@@ -185,21 +164,21 @@ static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo
 
     bool parsed = false;
     double value = 0.0;
-    if (parts.count() > 7 && parts[7].count() > 0) {
+    if (parts.count() > 7 && parts[7].size() > 0) {
         value = parts[7].toDouble(&parsed);
         if (parsed)
             info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value * 1.852 / 3.6));    // knots -> m/s
     }
-    if (parts.count() > 8 && parts[8].count() > 0) {
+    if (parts.count() > 8 && parts[8].size() > 0) {
         value = parts[8].toDouble(&parsed);
         if (parsed)
             info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
     }
-    if (parts.count() > 11 && parts[11].count() == 1
-            && (parts[11][0] == 'E' || parts[11][0] == 'W')) {
+    if (parts.count() > 11 && parts[11].size() == 1
+            && (parts[11].at(0) == 'E' || parts[11].at(0) == 'W')) {
         value = parts[10].toDouble(&parsed);
         if (parsed) {
-            if (parts[11][0] == 'W')
+            if (parts[11].at(0) == 'W')
                 value *= -1;
             info->setAttribute(QGeoPositionInfo::MagneticVariation, qreal(value));
         }
@@ -211,43 +190,38 @@ static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo
     info->setTimestamp(QDateTime(date, time, Qt::UTC));
 }
 
-static void qlocationutils_readVtg(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+static void qlocationutils_readVtg(const QNmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
-
     bool parsed = false;
     double value = 0.0;
-    if (parts.count() > 1 && parts[1].count() > 0) {
+    if (parts.count() > 1 && parts[1].size() > 0) {
         value = parts[1].toDouble(&parsed);
         if (parsed)
             info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
     }
-    if (parts.count() > 7 && parts[7].count() > 0) {
+    if (parts.count() > 7 && parts[7].size() > 0) {
         value = parts[7].toDouble(&parsed);
         if (parsed)
             info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value / 3.6));    // km/h -> m/s
     }
 }
 
-static void qlocationutils_readZda(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+static void qlocationutils_readZda(const QNmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
     QDate date;
     QTime time;
 
-    if (parts.count() > 1 && parts[1].count() > 0)
+    if (parts.count() > 1 && parts[1].size() > 0)
         QLocationUtils::getNmeaTime(parts[1], &time);
 
-    if (parts.count() > 4 && parts[2].count() > 0 && parts[3].count() > 0
-            && parts[4].count() == 4) {     // must be full 4-digit year
+    if (parts.count() > 4 && parts[2].size() > 0 && parts[3].size() > 0
+            && parts[4].size() == 4) {     // must be full 4-digit year
         int day = parts[2].toUInt();
         int month = parts[3].toUInt();
         int year = parts[4].toUInt();
@@ -258,6 +232,17 @@ static void qlocationutils_readZda(const char *data, int size, QGeoPositionInfo
     info->setTimestamp(QDateTime(date, time, Qt::UTC));
 }
 
+static inline int qlocationutils_hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
 QLocationUtils::NmeaSentence QLocationUtils::getNmeaSentenceType(const char *data, int size)
 {
     if (size < 6 || data[0] != '$' || !hasValidNmeaChecksum(data, size))
@@ -281,6 +266,9 @@ QLocationUtils::NmeaSentence QLocationUtils::getNmeaSentenceType(const char *dat
     if (data[3] == 'Z' && data[4] == 'D' && data[5] == 'A')
         return NmeaSentenceZDA;
 
+    if (data[3] == 'G' && data[4] == 'S' && data[5] == 'V')
+        return NmeaSentenceGSV;
+
     return NmeaSentenceInvalid;
 }
 
@@ -305,24 +293,26 @@ bool QLocationUtils::getPosInfoFromNmea(const char *data, int size, QGeoPosition
         }
     }
 
+    const QNmeaTokenizer parts(data, size);
+
     switch (nmeaType) {
     case NmeaSentenceGGA:
-        qlocationutils_readGga(data, size, info, uere, hasFix);
+        qlocationutils_readGga(parts, info, uere, hasFix);
         return true;
     case NmeaSentenceGSA:
-        qlocationutils_readGsa(data, size, info, uere, hasFix);
+        qlocationutils_readGsa(parts, info, uere, hasFix);
         return true;
     case NmeaSentenceGLL:
-        qlocationutils_readGll(data, size, info, hasFix);
+        qlocationutils_readGll(parts, info, hasFix);
         return true;
     case NmeaSentenceRMC:
-        qlocationutils_readRmc(data, size, info, hasFix);
+        qlocationutils_readRmc(parts, info, hasFix);
         return true;
     case NmeaSentenceVTG:
-        qlocationutils_readVtg(data, size, info, hasFix);
+        qlocationutils_readVtg(parts, info, hasFix);
         return true;
     case NmeaSentenceZDA:
-        qlocationutils_readZda(data, size, info, hasFix);
+        qlocationutils_readZda(parts, info, hasFix);
         return true;
     default:
         return false;
@@ -353,53 +343,40 @@ bool QLocationUtils::hasValidNmeaChecksum(const char *data, int size)
         return ::strncmp(calc, &data[asteriskIndex+1], 2) == 0;
         */
 
-    QByteArray checkSumBytes(&data[asteriskIndex + 1], 2);
-    bool ok = false;
-    int checksum = checkSumBytes.toInt(&ok,16);
-    return ok && checksum == result;
+    const int high = qlocationutils_hexDigit(data[asteriskIndex + 1]);
+    const int low = qlocationutils_hexDigit(data[asteriskIndex + 2]);
+    return high >= 0 && low >= 0 && (high << 4 | low) == result;
 }
 
 bool QLocationUtils::getNmeaTime(const QByteArray &bytes, QTime *time)
 {
-    int dotIndex = bytes.indexOf('.');
-    QTime tempTime;
-
-    if (dotIndex < 0) {
-        tempTime = QTime::fromString(QString::fromLatin1(bytes.constData()),
-                                     QStringLiteral("hhmmss"));
-    } else {
-        tempTime = QTime::fromString(QString::fromLatin1(bytes.mid(0, dotIndex)),
-                                     QStringLiteral("hhmmss"));
-        bool hasMsecs = false;
-        int midLen = qMin(3, bytes.size() - dotIndex - 1);
-        int msecs = bytes.mid(dotIndex + 1, midLen).toUInt(&hasMsecs);
-        if (hasMsecs)
-            tempTime = tempTime.addMSecs(msecs*(midLen == 3 ? 1 : midLen == 2 ? 10 : 100));
-    }
+    return getNmeaTime(QNmeaField(bytes.constData(), bytes.size()), time);
+}
 
-    if (tempTime.isValid()) {
-        *time = tempTime;
-        return true;
-    }
-    return false;
+bool QLocationUtils::getNmeaTime(const QNmeaField &field, QTime *time)
+{
+    return field.toTime(time);
 }
 
 bool QLocationUtils::getNmeaLatLong(const QByteArray &latString, char latDirection, const QByteArray &lngString, char lngDirection, double *lat, double *lng)
+{
+    return getNmeaLatLong(QNmeaField(latString.constData(), latString.size()), latDirection,
+                          QNmeaField(lngString.constData(), lngString.size()), lngDirection,
+                          lat, lng);
+}
+
+bool QLocationUtils::getNmeaLatLong(const QNmeaField &latString, char latDirection, const QNmeaField &lngString, char lngDirection, double *lat, double *lng)
 {
     if ((latDirection != 'N' && latDirection != 'S')
             || (lngDirection != 'E' && lngDirection != 'W')) {
         return false;
     }
 
-    bool hasLat = false;
-    bool hasLong = false;
-    double tempLat = latString.toDouble(&hasLat);
-    double tempLng = lngString.toDouble(&hasLong);
-    if (hasLat && hasLong) {
-        tempLat = qlocationutils_nmeaDegreesToDecimal(tempLat);
+    double tempLat;
+    double tempLng;
+    if (latString.toDegrees(&tempLat) && lngString.toDegrees(&tempLng)) {
         if (latDirection == 'S')
             tempLat *= -1;
-        tempLng = qlocationutils_nmeaDegreesToDecimal(tempLng);
         if (lngDirection == 'W')
             tempLng *= -1;
 
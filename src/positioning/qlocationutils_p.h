@@ -63,6 +63,7 @@ static const double rightOffset = 180.0 - offsetEpsilon;
 QT_BEGIN_NAMESPACE
 class QTime;
 class QByteArray;
+class QNmeaField;
 
 class QGeoPositionInfo;
 class Q_POSITIONING_PRIVATE_EXPORT QLocationUtils
@@ -94,7 +95,8 @@ public:
         NmeaSentenceGLL, // Lat/Lon data
         NmeaSentenceRMC, // Recommended minimum data for gps
         NmeaSentenceVTG, // Vector track an Speed over the Ground
-        NmeaSentenceZDA  // Date and Time
+        NmeaSentenceZDA, // Date and Time
+        NmeaSentenceGSV  // Satellites in view
     };
 
     inline static bool isValidLat(double lat) {
@@ -284,6 +286,7 @@ public:
         Returns time from a string in hhmmss or hhmmss.z+ format.
     */
     static bool getNmeaTime(const QByteArray &bytes, QTime *time);
+    static bool getNmeaTime(const QNmeaField &field, QTime *time);
 
     /*
         Accepts for example ("2734.7964", 'S', "15306.0124", 'E') and returns the
@@ -295,6 +298,12 @@ public:
                                char lngDirection,
                                double *lat,
                                double *lon);
+    static bool getNmeaLatLong(const QNmeaField &latString,
+                               char latDirection,
+                               const QNmeaField &lngString,
+                               char lngDirection,
+                               double *lat,
+                               double *lon);
 };
 
 QT_END_NAMESPACE
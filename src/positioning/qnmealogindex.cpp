@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qnmealogindex_p.h"
+#include "qlocationutils_p.h"
+#include "qnmeatokenizer_p.h"
+
+#include <QtCore/QIODevice>
+
+#include <algorithm>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+static const qint64 MSecsPerDay = 24 * 3600 * 1000;
+// Lines are handed over at most this long, like the 1024 byte buffer of the readers
+static const int MaxLineSize = 1023;
+
+QNmeaLogIndex::QNmeaLogIndex(int granularity)
+    : m_granularity(qMax(1, granularity))
+{
+    clear();
+}
+
+void QNmeaLogIndex::clear()
+{
+    m_entries.clear();
+    m_firstDate = QDate();
+    m_day = 0;
+    m_lastTime = -1;
+    m_lastMsecs = -1;
+}
+
+/*
+    Indexes a whole log held in memory, such as a mapped file.
+*/
+void QNmeaLogIndex::build(const char *data, qint64 size)
+{
+    clear();
+
+    qint64 offset = 0;
+    while (offset < size) {
+        const char *line = data + offset;
+        const qint64 remaining = size - offset;
+        const int length = int(qMin(remaining, qint64(MaxLineSize)));
+        const char *end = static_cast<const char *>(memchr(line, '\n', length));
+        const int lineSize = end ? int(end - line) + 1 : length;
+
+        addLine(line, lineSize, offset);
+        offset += lineSize;
+    }
+}
+
+/*
+    Indexes a random access device from its start, restoring its position
+    afterwards. Returns false for sequential or unreadable devices.
+*/
+bool QNmeaLogIndex::build(QIODevice *device)
+{
+    if (!device || device->isSequential() || !device->isReadable())
+        return false;
+
+    clear();
+
+    const qint64 position = device->pos();
+    if (!device->seek(0))
+        return false;
+
+    char buf[MaxLineSize + 1];
+    forever {
+        const qint64 offset = device->pos();
+        const qint64 size = device->readLine(buf, sizeof(buf));
+        if (size <= 0)
+            break;
+        addLine(buf, int(size), offset);
+    }
+
+    device->seek(position);
+    return true;
+}
+
+void QNmeaLogIndex::addLine(const char *data, int size, qint64 offset)
+{
+    const QLocationUtils::NmeaSentence type = QLocationUtils::getNmeaSentenceType(data, size);
+
+    int timeField;
+    switch (type) {
+    case QLocationUtils::NmeaSentenceGGA:
+    case QLocationUtils::NmeaSentenceRMC:
+    case QLocationUtils::NmeaSentenceZDA:
+        timeField = 1;
+        break;
+    case QLocationUtils::NmeaSentenceGLL:
+        timeField = 5;
+        break;
+    default:
+        return;
+    }
+
+    // Adjust size so that * and following characters are not parsed.
+    for (int i = 0; i < size; ++i) {
+        if (data[i] == '*') {
+            size = i;
+            break;
+        }
+    }
+
+    const QNmeaTokenizer parts(data, size);
+    QTime time;
+    if (!parts[timeField].toTime(&time))
+        return;
+
+    QDate date;
+    if (type == QLocationUtils::NmeaSentenceRMC) {
+        parts[9].toDate(&date);
+    } else if (type == QLocationUtils::NmeaSentenceZDA && parts[4].size() == 4) {
+        const int day = parts[2].toUInt();
+        const int month = parts[3].toUInt();
+        const int year = parts[4].toUInt();
+        if (day > 0 && month > 0 && year > 0)
+            date.setDate(year, month, day);
+    }
+
+    // Dates are authoritative when present, time of day rollovers count
+    // the days otherwise
+    const int timeOfDay = time.msecsSinceStartOfDay();
+    if (date.isValid() && m_firstDate.isValid())
+        m_day = qMax(m_day, int(m_firstDate.daysTo(date)));
+    else if (m_lastTime >= 0 && timeOfDay < m_lastTime - MSecsPerDay / 2)
+        ++m_day;
+    if (date.isValid() && !m_firstDate.isValid())
+        m_firstDate = date.addDays(-m_day);
+
+    const qint64 msecs = m_day * MSecsPerDay + timeOfDay;
+    if (msecs <= m_lastMsecs)   // same update, or out of order data the replay discards
+        return;
+    m_lastMsecs = msecs;
+    m_lastTime = timeOfDay;
+
+    if (m_entries.isEmpty() || msecs >= m_entries.last().msecs + m_granularity) {
+        const Entry entry = { msecs, offset };
+        m_entries.append(entry);
+    }
+}
+
+QDateTime QNmeaLogIndex::toDateTime(qint64 msecs) const
+{
+    if (m_firstDate.isValid())
+        return QDateTime(m_firstDate, QTime(0, 0), Qt::UTC).addMSecs(msecs);
+    return QDateTime(QDate(), QTime::fromMSecsSinceStartOfDay(int(msecs % MSecsPerDay)), Qt::UTC);
+}
+
+QDateTime QNmeaLogIndex::firstTimestamp() const
+{
+    return m_entries.isEmpty() ? QDateTime() : toDateTime(m_entries.first().msecs);
+}
+
+QDateTime QNmeaLogIndex::lastTimestamp() const
+{
+    return m_entries.isEmpty() ? QDateTime() : toDateTime(m_entries.last().msecs);
+}
+
+qint64 QNmeaLogIndex::offsetAt(const QDateTime &timestamp) const
+{
+    if (m_entries.isEmpty() || !timestamp.time().isValid())
+        return -1;
+
+    qint64 msecs;
+    if (m_firstDate.isValid() && timestamp.date().isValid()) {
+        msecs = QDateTime(m_firstDate, QTime(0, 0), Qt::UTC).msecsTo(timestamp);
+    } else {
+        // Time only, taken as the first such time since the start of the log
+        msecs = timestamp.time().msecsSinceStartOfDay();
+        if (msecs < m_entries.first().msecs % MSecsPerDay)
+            msecs += MSecsPerDay;
+        msecs += (m_entries.first().msecs / MSecsPerDay) * MSecsPerDay;
+    }
+
+    auto it = std::upper_bound(m_entries.cbegin(), m_entries.cend(), msecs,
+                               [](qint64 value, const Entry &entry) { return value < entry.msecs; });
+    if (it != m_entries.cbegin())
+        --it;
+    return it->offset;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QNMEALOGINDEX_P_H
+#define QNMEALOGINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtCore/QDateTime>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+/*
+    Maps the timestamps of a recorded NMEA log to the offsets of the lines
+    that start each update, so a replay can be resumed anywhere in the log
+    without parsing everything before it.
+
+    Timestamps are kept as milliseconds since midnight of the first day of
+    the log, days being counted from time of day rollovers, so logs made of
+    time-only sentences (GGA, GLL) can be indexed as well. At most one entry
+    is recorded per granularity interval.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QNmeaLogIndex
+{
+public:
+    explicit QNmeaLogIndex(int granularity = 1000);
+
+    void build(const char *data, qint64 size);
+    bool build(QIODevice *device);
+    void clear();
+
+    void addLine(const char *data, int size, qint64 offset);
+
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    int size() const { return m_entries.size(); }
+
+    QDateTime firstTimestamp() const;
+    QDateTime lastTimestamp() const;
+
+    // Offset of the last indexed update not later than timestamp, or of the
+    // first update if the log starts after it. -1 if the index is empty
+    qint64 offsetAt(const QDateTime &timestamp) const;
+
+private:
+    QDateTime toDateTime(qint64 msecs) const;
+
+    struct Entry
+    {
+        qint64 msecs;
+        qint64 offset;
+    };
+
+    QVector<Entry> m_entries;
+    int m_granularity;
+    QDate m_firstDate;   // date of the first day, once a sentence carried one
+    int m_day;
+    int m_lastTime;      // msecs since midnight of the last timestamp, -1 if none
+    qint64 m_lastMsecs;
+};
+
+QT_END_NAMESPACE
+
+#endif // QNMEALOGINDEX_P_H
@@ -43,12 +43,16 @@
 #include "qlocationutils_p.h"
 
 #include <QIODevice>
+#include <QFile>
+#include <QElapsedTimer>
 #include <QBasicTimer>
 #include <QTimerEvent>
 #include <QTimer>
 #include <array>
 #include <QDebug>
 #include <QtCore/QtNumeric>
+#include <limits.h>
+#include <string.h>
 
 
 QT_BEGIN_NAMESPACE
@@ -134,7 +138,8 @@ static bool propagateAttributes(QGeoPositionInfo &dst, const QGeoPositionInfo &s
 
 // returns false if src does not contain any additional or different data than dst,
 // true otherwise.
-static bool mergePositions(QGeoPositionInfo &dst, const QGeoPositionInfo &src, QByteArray nmeaSentence)
+static bool mergePositions(QGeoPositionInfo &dst, const QGeoPositionInfo &src,
+                           const char *nmeaSentence, int size)
 {
     bool updated = false;
 
@@ -144,13 +149,41 @@ static bool mergePositions(QGeoPositionInfo &dst, const QGeoPositionInfo &src, Q
 
 #if USE_NMEA_PIMPL
     QGeoPositionInfoPrivateNmea *dstPimpl = static_cast<QGeoPositionInfoPrivateNmea *>(QGeoPositionInfoPrivate::get(dst));
-    dstPimpl->nmeaSentences.append(nmeaSentence);
+    dstPimpl->nmeaSentences.append(QByteArray(nmeaSentence, size));
 #else
     Q_UNUSED(nmeaSentence)
+    Q_UNUSED(size)
 #endif
     return updated;
 }
 
+// Clears the parsed data in place, so the same private can be reused for the next sentence
+static void resetPosition(QGeoPositionInfo &info)
+{
+    QGeoPositionInfoPrivateNmea *pimpl = static_cast<QGeoPositionInfoPrivateNmea *>(QGeoPositionInfoPrivate::get(info));
+    pimpl->timestamp = QDateTime();
+    pimpl->coord.setLatitude(qQNaN());
+    pimpl->coord.setLongitude(qQNaN());
+    pimpl->coord.setAltitude(qQNaN());
+    pimpl->doubleAttribs.clear();
+#if USE_NMEA_PIMPL
+    pimpl->nmeaSentences.clear();
+#endif
+}
+
+// Exchanges the contents of two positions without cloning either private
+static void swapPositions(QGeoPositionInfo &a, QGeoPositionInfo &b)
+{
+    QGeoPositionInfoPrivateNmea *pa = static_cast<QGeoPositionInfoPrivateNmea *>(QGeoPositionInfoPrivate::get(a));
+    QGeoPositionInfoPrivateNmea *pb = static_cast<QGeoPositionInfoPrivateNmea *>(QGeoPositionInfoPrivate::get(b));
+    pa->timestamp.swap(pb->timestamp);
+    qSwap(pa->coord, pb->coord);
+    pa->doubleAttribs.swap(pb->doubleAttribs);
+#if USE_NMEA_PIMPL
+    pa->nmeaSentences.swap(pb->nmeaSentences);
+#endif
+}
+
 static qint64 msecsTo(const QDateTime &from, const QDateTime &to)
 {
     if (!from.time().isValid() || !to.time().isValid())
@@ -163,7 +196,8 @@ static qint64 msecsTo(const QDateTime &from, const QDateTime &to)
 }
 
 QNmeaRealTimeReader::QNmeaRealTimeReader(QNmeaPositionInfoSourcePrivate *sourcePrivate)
-        : QNmeaReader(sourcePrivate), m_update(*new QGeoPositionInfoPrivateNmea)
+        : QNmeaReader(sourcePrivate), m_update(*new QGeoPositionInfoPrivateNmea),
+          m_pos(*new QGeoPositionInfoPrivateNmea)
 {
     // An env var controlling the number of milliseconds to use to withold
     // an update and wait for additional data to combine.
@@ -191,8 +225,8 @@ void QNmeaRealTimeReader::readAvailableData()
         const QTime infoTime = m_update.timestamp().time(); // if update has been set, time must be valid.
         const QDate infoDate = m_update.timestamp().date(); // this one might not be valid, as some sentences do not contain it
 
-        QGeoPositionInfoPrivateNmea *pimpl = new QGeoPositionInfoPrivateNmea;
-        QGeoPositionInfo pos(*pimpl);
+        QGeoPositionInfo &pos = m_pos;
+        resetPosition(pos);
 
         char buf[1024];
         qint64 size = m_proxy->m_device->readLine(buf, sizeof(buf));
@@ -233,12 +267,12 @@ void QNmeaRealTimeReader::readAvailableData()
                     m_timer.stop();
                     // next update data
                     propagateAttributes(pos, m_update, false);
-                    m_update = pos;
+                    swapPositions(m_update, pos);
                     m_hasFix = hasFix;
                 } else {
                     if (infoTime == pos.timestamp().time())
                         // timestamps match -- merge into m_update
-                        if (mergePositions(m_update, pos, QByteArray(buf, size))) {
+                        if (mergePositions(m_update, pos, buf, size)) {
                             // Reset the timer only if new info has been received.
                             // Else the source might be keep repeating outdated info until
                             // new info become available.
@@ -248,16 +282,17 @@ void QNmeaRealTimeReader::readAvailableData()
                 }
             } else {
                 // no timestamp available in parsed update-- merge into m_update
-                if (mergePositions(m_update, pos, QByteArray(buf, size)))
+                if (mergePositions(m_update, pos, buf, size))
                     m_timer.stop();
             }
         } else {
             // there was no info with valid TS. Overwrite with whatever is parsed.
 #if USE_NMEA_PIMPL
-            pimpl->nmeaSentences.append(QByteArray(buf, size));
+            static_cast<QGeoPositionInfoPrivateNmea *>(QGeoPositionInfoPrivate::get(pos))
+                    ->nmeaSentences.append(QByteArray(buf, size));
 #endif
             propagateAttributes(pos, m_update);
-            m_update = pos;
+            swapPositions(m_update, pos);
             m_timer.stop();
         }
     }
@@ -289,7 +324,15 @@ void QNmeaRealTimeReader::notifyNewUpdate()
 QNmeaSimulatedReader::QNmeaSimulatedReader(QNmeaPositionInfoSourcePrivate *sourcePrivate)
         : QNmeaReader(sourcePrivate),
         m_currTimerId(-1),
-        m_hasValidDateTime(false)
+        m_hasValidDateTime(false),
+        m_line(0),
+        m_lineSize(0),
+        m_unreadLine(false),
+        m_map(0),
+        m_mapSize(0),
+        m_mapPosition(0),
+        m_mapChecked(false),
+        m_indexBuilt(false)
 {
 }
 
@@ -297,6 +340,8 @@ QNmeaSimulatedReader::~QNmeaSimulatedReader()
 {
     if (m_currTimerId > 0)
         killTimer(m_currTimerId);
+    if (m_map && m_mappedFile)
+        m_mappedFile->unmap(reinterpret_cast<uchar *>(const_cast<char *>(m_map)));
 }
 
 void QNmeaSimulatedReader::readAvailableData()
@@ -307,6 +352,7 @@ void QNmeaSimulatedReader::readAvailableData()
     if (!m_hasValidDateTime) {      // first update
         Q_ASSERT(m_proxy->m_device && (m_proxy->m_device->openMode() & QIODevice::ReadOnly));
 
+        mapDevice();
         if (!setFirstDateTime()) {
             //m_proxy->notifyReachedEndOfFile();
             qWarning("QNmeaPositionInfoSource: cannot find NMEA sentence with valid date & time");
@@ -322,11 +368,82 @@ void QNmeaSimulatedReader::readAvailableData()
     }
 }
 
-static int processSentence(QGeoPositionInfo &info,
-                           QByteArray &m_nextLine,
-                           QNmeaPositionInfoSourcePrivate *m_proxy,
-                           QQueue<QPendingGeoPositionInfo> &m_pendingUpdates,
-                           bool &hasFix)
+/*
+    Replays files from a memory mapping, so long logs are neither copied
+    line by line nor read through the device buffer. The file position
+    follows the lines consumed from the mapping, data appended to the file
+    after the replay started is read through the device.
+*/
+void QNmeaSimulatedReader::mapDevice()
+{
+    if (m_mapChecked)
+        return;
+    m_mapChecked = true;
+
+    QFile *file = qobject_cast<QFile *>(m_proxy->m_device.data());
+    if (!file || file->isSequential() || file->size() <= 0)
+        return;
+
+    uchar *map = file->map(0, file->size());
+    if (!map)
+        return;
+
+    m_mappedFile = file;
+    m_map = reinterpret_cast<const char *>(map);
+    m_mapSize = file->size();
+    m_mapPosition = file->pos();
+    // Closing the file invalidates the mapping
+    connect(file, SIGNAL(aboutToClose()), SLOT(unmapDevice()));
+}
+
+void QNmeaSimulatedReader::unmapDevice()
+{
+    if (m_map && m_mappedFile) {
+        m_mappedFile->unmap(reinterpret_cast<uchar *>(const_cast<char *>(m_map)));
+        disconnect(m_mappedFile, 0, this, 0);
+    }
+    m_mappedFile = 0;
+    m_map = 0;
+    m_mapSize = 0;
+    m_mapPosition = 0;
+    m_unreadLine = false;
+}
+
+bool QNmeaSimulatedReader::readLine(const char **line, int *size)
+{
+    if (m_unreadLine) {
+        // Read something in the previous call, but TS was later.
+        m_unreadLine = false;
+        *line = m_line;
+        *size = m_lineSize;
+        return true;
+    }
+
+    if (m_map && m_mapPosition < m_mapSize) {
+        // At most as much as QIODevice::readLine() would return into m_buffer
+        const char *start = m_map + m_mapPosition;
+        const int length = int(qMin(m_mapSize - m_mapPosition, qint64(sizeof(m_buffer) - 1)));
+        const char *end = static_cast<const char *>(memchr(start, '\n', length));
+        m_line = start;
+        m_lineSize = end ? int(end - start) + 1 : length;
+        m_mapPosition += m_lineSize;
+        m_mappedFile->seek(m_mapPosition);
+    } else {
+        m_lineSize = 0;
+        while (m_lineSize <= 0) {
+            if (!m_proxy->m_device || m_proxy->m_device->bytesAvailable() <= 0)
+                return false;
+            m_lineSize = int(m_proxy->m_device->readLine(m_buffer, sizeof(m_buffer)));
+        }
+        m_line = m_buffer;
+    }
+
+    *line = m_line;
+    *size = m_lineSize;
+    return true;
+}
+
+int QNmeaSimulatedReader::processSentence(QGeoPositionInfo &info, bool &hasFix)
 {
     int timeToNextUpdate = -1;
     QDateTime prevTs;
@@ -335,24 +452,9 @@ static int processSentence(QGeoPositionInfo &info,
 
     // find the next update with a valid time (as long as the time is valid,
     // we can calculate when the update should be emitted)
-    while (m_nextLine.size() || (m_proxy->m_device && m_proxy->m_device->bytesAvailable() > 0)) {
-        char static_buf[1024];
-        char *buf = static_buf;
-        QByteArray nextLine;
-        qint64 size = 0;
-        if (m_nextLine.size()) {
-            // Read something in the previous call, but TS was later.
-            size = m_nextLine.size();
-            nextLine = m_nextLine;
-            m_nextLine.clear();
-            buf = nextLine.data();
-        } else {
-            size = m_proxy->m_device->readLine(buf, sizeof(static_buf));
-        }
-
-        if (size <= 0)
-            continue;
-
+    const char *buf;
+    int size;
+    while (readLine(&buf, &size)) {
         const QTime infoTime = info.timestamp().time(); // if info has been set, time must be valid.
         const QDate infoDate = info.timestamp().date(); // this one might not be valid, as some sentences do not contain it
 
@@ -387,18 +489,19 @@ static int processSentence(QGeoPositionInfo &info,
                                             && pos.timestamp().date().isValid()
                                             && infoDate < pos.timestamp().date());
                     if (newerTime || newerDate) {
-                        // Effectively read data for different update, that is also newer, so copy buf into m_nextLine
-                        m_nextLine = QByteArray(buf, size);
+                        // Effectively read data for different update, that is also newer,
+                        // so hand the line out again with the next read
+                        m_unreadLine = true;
                         break;
                     } else {
                         if (infoTime == pos.timestamp().time())
                             // timestamps match -- merge into info
-                            mergePositions(info, pos, QByteArray(buf, size));
+                            mergePositions(info, pos, buf, size);
                         // else discard out of order outdated info.
                     }
                 } else {
                     // no timestamp available -- merge into info
-                    mergePositions(info, pos, QByteArray(buf, size));
+                    mergePositions(info, pos, buf, size);
                 }
             } else {
                 // there was no info with valid TS. Overwrite with whatever is parsed.
@@ -424,26 +527,36 @@ bool QNmeaSimulatedReader::setFirstDateTime()
     // find the first update with valid date and time
     QGeoPositionInfo info(*new QGeoPositionInfoPrivateNmea);
     bool hasFix = false;
-    processSentence(info, m_nextLine, m_proxy, m_pendingUpdates, hasFix);
+    processSentence(info, hasFix);
 
     if (info.timestamp().time().isValid()) { // NMEA may have sentences with only time and no date. These would generate invalid positions
         QPendingGeoPositionInfo pending;
         pending.info = info;
         pending.hasFix = hasFix;
+        m_proxy->takeSatelliteUpdates(&pending);
         m_pendingUpdates.enqueue(pending);
         return true;
     }
     return false;
 }
 
-void QNmeaSimulatedReader::simulatePendingUpdate()
+void QNmeaSimulatedReader::notifyPendingUpdate()
 {
     if (m_pendingUpdates.size() > 0) {
         // will be dequeued in processNextSentence()
         QPendingGeoPositionInfo &pending = m_pendingUpdates.head();
         m_proxy->notifyNewUpdate(&pending.info, pending.hasFix);
+        if (pending.satelliteUpdates) {
+            m_proxy->notifySatelliteUpdate(pending.satelliteUpdates, pending.satellitesInView,
+                                           pending.satellitesInUse);
+            pending.satelliteUpdates = QNmeaSatelliteParser::NoUpdate;
+        }
     }
+}
 
+void QNmeaSimulatedReader::simulatePendingUpdate()
+{
+    notifyPendingUpdate();
     processNextSentence();
 }
 
@@ -454,22 +567,88 @@ void QNmeaSimulatedReader::timerEvent(QTimerEvent *event)
     simulatePendingUpdate();
 }
 
+int QNmeaSimulatedReader::scaledInterval(int msec) const
+{
+    const qreal speed = m_proxy->m_simulationSpeed;
+    if (speed <= 0)
+        return 0;
+    if (speed == 1)
+        return msec;
+    return int(qMin(qreal(INT_MAX), msec / speed + qreal(0.5)));
+}
+
 void QNmeaSimulatedReader::processNextSentence()
 {
-    QGeoPositionInfo info(*new QGeoPositionInfoPrivateNmea);
-    bool hasFix = false;
+    // Updates that are already due are delivered from this loop instead of
+    // going through a zero timer each. The event loop still gets to run
+    // every few milliseconds when replaying as fast as possible.
+    const int maxBatchDuration = 10;
+    QElapsedTimer batch;
+    batch.start();
+
+    forever {
+        QGeoPositionInfo info(*new QGeoPositionInfoPrivateNmea);
+        bool hasFix = false;
+
+        int timeToNextUpdate = processSentence(info, hasFix);
+        if (timeToNextUpdate < 0)
+            return;
 
-    int timeToNextUpdate = processSentence(info, m_nextLine, m_proxy, m_pendingUpdates, hasFix);
-    if (timeToNextUpdate < 0)
-        return;
+        m_pendingUpdates.dequeue();
+
+        QPendingGeoPositionInfo pending;
+        pending.info = info;
+        pending.hasFix = hasFix;
+        m_proxy->takeSatelliteUpdates(&pending);
+        m_pendingUpdates.enqueue(pending);
+
+        const int interval = scaledInterval(timeToNextUpdate);
+        if (interval > 0 || batch.elapsed() >= maxBatchDuration) {
+            m_currTimerId = startTimer(interval);
+            return;
+        }
+
+        notifyPendingUpdate();
+        // A receiver may have moved the replay elsewhere with a seek
+        if (m_currTimerId > 0 || m_pendingUpdates.isEmpty())
+            return;
+    }
+}
+
+/*
+    Moves the replay to the update of \a timestamp, or the closest indexed one
+    before it. The index is built the first time the log is seeked. Replay
+    resumes with the next readAvailableData().
+*/
+bool QNmeaSimulatedReader::seek(const QDateTime &timestamp)
+{
+    mapDevice();
+
+    if (!m_indexBuilt) {
+        if (m_map)
+            m_index.build(m_map, m_mapSize);
+        else if (!m_index.build(m_proxy->m_device))
+            return false;
+        m_indexBuilt = true;
+    }
+
+    const qint64 offset = m_index.offsetAt(timestamp);
+    if (offset < 0)
+        return false;
 
-    m_pendingUpdates.dequeue();
+    if (!m_proxy->m_device->seek(offset))
+        return false;
+    if (m_map)
+        m_mapPosition = offset;
 
-    QPendingGeoPositionInfo pending;
-    pending.info = info;
-    pending.hasFix = hasFix;
-    m_pendingUpdates.enqueue(pending);
-    m_currTimerId = startTimer(timeToNextUpdate);
+    if (m_currTimerId > 0) {
+        killTimer(m_currTimerId);
+        m_currTimerId = -1;
+    }
+    m_pendingUpdates.clear();
+    m_unreadLine = false;
+    m_hasValidDateTime = false;
+    return true;
 }
 
 
@@ -483,6 +662,7 @@ QNmeaPositionInfoSourcePrivate::QNmeaPositionInfoSourcePrivate(QNmeaPositionInfo
         m_invokedStart(false),
         m_positionError(QGeoPositionInfoSource::UnknownSourceError),
         m_userEquivalentRangeError(qQNaN()),
+        m_simulationSpeed(1),
         m_source(parent),
         m_nmeaReader(0),
         m_updateTimer(0),
@@ -493,6 +673,11 @@ QNmeaPositionInfoSourcePrivate::QNmeaPositionInfoSourcePrivate(QNmeaPositionInfo
         m_updateTimeoutSent(false),
         m_connectedReadyRead(false)
 {
+    // Undocumented, sets the initial replay speed of SimulationMode sources so
+    // regression runs can replay logs faster without changing the application
+    QByteArray simulationSpeed = qgetenv("QT_NMEA_SIMULATION_SPEED");
+    if (!simulationSpeed.isEmpty())
+        m_simulationSpeed = qMax(qreal(0), QString::fromLatin1(simulationSpeed).toDouble());
 }
 
 QNmeaPositionInfoSourcePrivate::~QNmeaPositionInfoSourcePrivate()
@@ -501,6 +686,11 @@ QNmeaPositionInfoSourcePrivate::~QNmeaPositionInfoSourcePrivate()
     delete m_updateTimer;
 }
 
+QNmeaPositionInfoSourcePrivate *QNmeaPositionInfoSourcePrivate::get(QNmeaPositionInfoSource &source)
+{
+    return source.d;
+}
+
 bool QNmeaPositionInfoSourcePrivate::openSourceDevice()
 {
     if (!m_device) {
@@ -565,9 +755,116 @@ void QNmeaPositionInfoSourcePrivate::prepareSourceDevice()
 bool QNmeaPositionInfoSourcePrivate::parsePosInfoFromNmeaData(const char *data, int size,
         QGeoPositionInfo *posInfo, bool *hasFix)
 {
+    // Every line read from the device passes through here once, so this is
+    // where satellite sentences are picked up for attached satellite sources
+    if (m_satelliteParser) {
+        const QNmeaSatelliteParser::Updates updates = m_satelliteParser->parseSentence(data, size);
+        if (updates) {
+            if (m_updateMode == QNmeaPositionInfoSource::RealTimeMode) {
+                notifySatelliteUpdate(updates,
+                                      updates & QNmeaSatelliteParser::SatellitesInViewUpdated
+                                          ? m_satelliteParser->satellitesInView()
+                                          : QList<QGeoSatelliteInfo>(),
+                                      updates & QNmeaSatelliteParser::SatellitesInUseUpdated
+                                          ? m_satelliteParser->satellitesInUse()
+                                          : QList<QGeoSatelliteInfo>());
+            } else {
+                // Delivered with the position update the sentences belong to
+                m_satelliteUpdates |= updates;
+            }
+        }
+    }
+
     return m_source->parsePosInfoFromNmeaData(data, size, posInfo, hasFix);
 }
 
+bool QNmeaPositionInfoSourcePrivate::attachSatelliteSource(QNmeaSatelliteInfoSourcePrivate *satelliteSource)
+{
+    if (!initialize())
+        return false;
+
+    if (!m_satelliteSources.contains(satelliteSource))
+        m_satelliteSources.append(satelliteSource);
+    if (!m_satelliteParser)
+        m_satelliteParser.reset(new QNmeaSatelliteParser);
+
+    prepareSourceDevice();
+    return true;
+}
+
+void QNmeaPositionInfoSourcePrivate::detachSatelliteSource(QNmeaSatelliteInfoSourcePrivate *satelliteSource)
+{
+    m_satelliteSources.removeAll(satelliteSource);
+    if (m_satelliteSources.isEmpty()) {
+        m_satelliteParser.reset();
+        m_satelliteUpdates = QNmeaSatelliteParser::NoUpdate;
+    }
+}
+
+void QNmeaPositionInfoSourcePrivate::takeSatelliteUpdates(QPendingGeoPositionInfo *pending)
+{
+    pending->satelliteUpdates = m_satelliteUpdates;
+    if (!m_satelliteUpdates)
+        return;
+
+    if (m_satelliteUpdates & QNmeaSatelliteParser::SatellitesInViewUpdated)
+        pending->satellitesInView = m_satelliteParser->satellitesInView();
+    if (m_satelliteUpdates & QNmeaSatelliteParser::SatellitesInUseUpdated)
+        pending->satellitesInUse = m_satelliteParser->satellitesInUse();
+    m_satelliteUpdates = QNmeaSatelliteParser::NoUpdate;
+}
+
+void QNmeaPositionInfoSourcePrivate::notifySatelliteUpdate(QNmeaSatelliteParser::Updates updates,
+                                                           const QList<QGeoSatelliteInfo> &inView,
+                                                           const QList<QGeoSatelliteInfo> &inUse)
+{
+    // A receiver may destroy a satellite source while it is being notified
+    const QList<QNmeaSatelliteInfoSourcePrivate *> satelliteSources = m_satelliteSources;
+    for (QNmeaSatelliteInfoSourcePrivate *satelliteSource : satelliteSources) {
+        if (m_satelliteSources.contains(satelliteSource))
+            satelliteSource->notifyNewUpdate(updates, inView, inUse);
+    }
+}
+
+/*
+    Sets the replay speed of a SimulationMode source to speed times the rate
+    at which the data was recorded. A speed of 0 replays as fast as possible.
+    The new speed applies from the next update on.
+*/
+void QNmeaPositionInfoSourcePrivate::setSimulationSpeed(qreal speed)
+{
+    if (speed < 0) {
+        qWarning("QNmeaPositionInfoSource: the simulation speed cannot be negative");
+        return;
+    }
+    m_simulationSpeed = speed;
+}
+
+qreal QNmeaPositionInfoSourcePrivate::simulationSpeed() const
+{
+    return m_simulationSpeed;
+}
+
+/*
+    Moves the replay to the update recorded at timestamp, or at most about a
+    second before it. The first call builds an index of the data, which
+    requires a random access device.
+*/
+bool QNmeaPositionInfoSourcePrivate::seekSimulation(const QDateTime &timestamp)
+{
+    if (m_updateMode != QNmeaPositionInfoSource::SimulationMode || !initialize())
+        return false;
+
+    QNmeaSimulatedReader *reader = static_cast<QNmeaSimulatedReader *>(m_nmeaReader);
+    if (!reader->seek(timestamp))
+        return false;
+
+    // Otherwise the replay resumes from there with startUpdates() or requestUpdate()
+    if (m_invokedStart || (m_requestTimer && m_requestTimer->isActive()))
+        reader->readAvailableData();
+    return true;
+}
+
 void QNmeaPositionInfoSourcePrivate::startUpdates()
 {
     if (m_invokedStart)
@@ -88,6 +88,7 @@ protected:
 private:
     Q_DISABLE_COPY(QNmeaPositionInfoSource)
     friend class QNmeaPositionInfoSourcePrivate;
+    friend class QNmeaSatelliteInfoSourcePrivate;
     QNmeaPositionInfoSourcePrivate *d;
     void setError(QGeoPositionInfoSource::Error positionError);
 };
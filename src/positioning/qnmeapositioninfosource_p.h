@@ -51,11 +51,14 @@
 //
 
 #include "qnmeapositioninfosource.h"
+#include "qnmeasatelliteinfosource_p.h"
+#include "qnmealogindex_p.h"
 #include "qgeopositioninfo.h"
 
 #include <QObject>
 #include <QQueue>
 #include <QPointer>
+#include <QScopedPointer>
 #include <QtCore/qtimer.h>
 
 QT_BEGIN_NAMESPACE
@@ -63,16 +66,21 @@ QT_BEGIN_NAMESPACE
 class QBasicTimer;
 class QTimerEvent;
 class QTimer;
+class QFile;
 
 class QNmeaReader;
 struct QPendingGeoPositionInfo
 {
     QGeoPositionInfo info;
     bool hasFix;
+    // Satellite groups completed along with this update, SimulationMode only
+    QNmeaSatelliteParser::Updates satelliteUpdates;
+    QList<QGeoSatelliteInfo> satellitesInView;
+    QList<QGeoSatelliteInfo> satellitesInUse;
 };
 
 
-class QNmeaPositionInfoSourcePrivate : public QObject
+class Q_POSITIONING_PRIVATE_EXPORT QNmeaPositionInfoSourcePrivate : public QObject
 {
     Q_OBJECT
 public:
@@ -90,12 +98,27 @@ public:
 
     void notifyNewUpdate(QGeoPositionInfo *update, bool fixStatus);
 
+    bool attachSatelliteSource(QNmeaSatelliteInfoSourcePrivate *satelliteSource);
+    void detachSatelliteSource(QNmeaSatelliteInfoSourcePrivate *satelliteSource);
+    void takeSatelliteUpdates(QPendingGeoPositionInfo *pending);
+    void notifySatelliteUpdate(QNmeaSatelliteParser::Updates updates,
+                               const QList<QGeoSatelliteInfo> &inView,
+                               const QList<QGeoSatelliteInfo> &inUse);
+
+    // SimulationMode replay control, for testing
+    void setSimulationSpeed(qreal speed);
+    qreal simulationSpeed() const;
+    bool seekSimulation(const QDateTime &timestamp);
+
+    static QNmeaPositionInfoSourcePrivate *get(QNmeaPositionInfoSource &source);
+
     QNmeaPositionInfoSource::UpdateMode m_updateMode;
     QPointer<QIODevice> m_device;
     QGeoPositionInfo m_lastUpdate;
     bool m_invokedStart;
     QGeoPositionInfoSource::Error m_positionError;
     double m_userEquivalentRangeError;
+    qreal m_simulationSpeed; // 0 replays as fast as possible
 
 public Q_SLOTS:
     void readyRead();
@@ -125,6 +148,11 @@ private:
     bool m_noUpdateLastInterval;
     bool m_updateTimeoutSent;
     bool m_connectedReadyRead;
+
+    // Satellite sources reading through this source's device
+    QList<QNmeaSatelliteInfoSourcePrivate *> m_satelliteSources;
+    QScopedPointer<QNmeaSatelliteParser> m_satelliteParser;
+    QNmeaSatelliteParser::Updates m_satelliteUpdates;
 };
 
 
@@ -151,6 +179,7 @@ public:
 
     // Data members
     QGeoPositionInfo m_update;
+    QGeoPositionInfo m_pos; // parsed sentence, reused for every line
     QDateTime m_lastPushedTS;
     bool m_updateParsed = false;
     bool m_hasFix = false;
@@ -167,20 +196,44 @@ public:
     ~QNmeaSimulatedReader();
     virtual void readAvailableData();
 
+    bool seek(const QDateTime &timestamp);
+
 protected:
     virtual void timerEvent(QTimerEvent *event);
 
 private Q_SLOTS:
     void simulatePendingUpdate();
+    void unmapDevice();
 
 private:
+    void mapDevice();
+    bool readLine(const char **line, int *size);
+    int processSentence(QGeoPositionInfo &info, bool &hasFix);
     bool setFirstDateTime();
     void processNextSentence();
+    void notifyPendingUpdate();
+    int scaledInterval(int msec) const;
 
     QQueue<QPendingGeoPositionInfo> m_pendingUpdates;
-    QByteArray m_nextLine;
     int m_currTimerId;
     bool m_hasValidDateTime;
+
+    // The line last returned by readLine(), handed out again when m_unreadLine
+    // is set. It points into m_buffer or into the mapped file
+    const char *m_line;
+    int m_lineSize;
+    bool m_unreadLine;
+    char m_buffer[1024];
+
+    // Files are replayed from memory rather than through QIODevice::readLine()
+    QPointer<QFile> m_mappedFile;
+    const char *m_map;
+    qint64 m_mapSize;
+    qint64 m_mapPosition;
+    bool m_mapChecked;
+
+    QNmeaLogIndex m_index;
+    bool m_indexBuilt;
 };
 
 QT_END_NAMESPACE
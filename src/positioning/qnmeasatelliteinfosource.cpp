@@ -0,0 +1,586 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qnmeasatelliteinfosource_p.h"
+#include "qnmeapositioninfosource_p.h"
+#include "qnmeatokenizer_p.h"
+#include "qlocationutils_p.h"
+
+#include <QIODevice>
+#include <QTimer>
+#include <QTimerEvent>
+#include <QtCore/QtNumeric>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+QNmeaSatelliteParser::QNmeaSatelliteParser()
+{
+    clear();
+}
+
+void QNmeaSatelliteParser::clear()
+{
+    for (int i = 0; i < TalkerCount; ++i) {
+        m_receiving[i].count = 0;
+        m_messageCount[i] = 0;
+        m_nextMessage[i] = 0;
+        m_inView[i].count = 0;
+        m_inUseCount[i] = 0;
+    }
+}
+
+QNmeaSatelliteParser::Updates QNmeaSatelliteParser::parseSentence(const char *data, int size)
+{
+    const QLocationUtils::NmeaSentence type = QLocationUtils::getNmeaSentenceType(data, size);
+    if (type != QLocationUtils::NmeaSentenceGSV && type != QLocationUtils::NmeaSentenceGSA)
+        return NoUpdate;
+
+    // Adjust size so that * and following characters are not parsed.
+    for (int i = 0; i < size; ++i) {
+        if (data[i] == '*') {
+            size = i;
+            break;
+        }
+    }
+
+    Talker talker = TalkerCombined;
+    if (data[1] == 'G' && data[2] == 'P')
+        talker = TalkerGps;
+    else if (data[1] == 'G' && data[2] == 'L')
+        talker = TalkerGlonass;
+    else if (data[1] == 'G' && data[2] == 'A')
+        talker = TalkerGalileo;
+    else if ((data[1] == 'G' && data[2] == 'B') || (data[1] == 'B' && data[2] == 'D'))
+        talker = TalkerBeidou;
+
+    const QNmeaTokenizer parts(data, size);
+    if (type == QLocationUtils::NmeaSentenceGSV)
+        return parseGsv(parts, talker);
+    return parseGsa(parts, talker);
+}
+
+/*
+    $GPGSV,<message count>,<message number>,<satellites in view>,
+           then up to four times <id>,<elevation>,<azimuth>,<SNR>
+*/
+QNmeaSatelliteParser::Updates QNmeaSatelliteParser::parseGsv(const QNmeaTokenizer &parts, Talker talker)
+{
+    bool hasCount = false;
+    bool hasNumber = false;
+    const int messageCount = parts[1].toInt(&hasCount);
+    const int message = parts[2].toInt(&hasNumber);
+    if (!hasCount || !hasNumber || messageCount < 1 || message < 1 || message > messageCount)
+        return NoUpdate;
+
+    Group &group = m_receiving[talker];
+    if (message == 1) {
+        group.count = 0;
+        m_messageCount[talker] = messageCount;
+    } else if (message != m_nextMessage[talker] || messageCount != m_messageCount[talker]) {
+        // A sentence of the group went missing, wait for the next group
+        m_nextMessage[talker] = 0;
+        return NoUpdate;
+    }
+
+    // NMEA 4.1 appends a signal id, which the i + 3 bound skips
+    for (int i = 4; i + 3 < parts.count() && group.count < MaxSatellites; i += 4) {
+        bool ok = false;
+        const int identifier = parts[i].toInt(&ok);
+        if (!ok || identifier <= 0)
+            continue;
+
+        Satellite &satellite = group.satellites[group.count++];
+        satellite.identifier = identifier;
+        satellite.elevation = parts[i + 1].toDouble(&ok);
+        if (!ok)
+            satellite.elevation = qQNaN();
+        satellite.azimuth = parts[i + 2].toDouble(&ok);
+        if (!ok)
+            satellite.azimuth = qQNaN();
+        satellite.signalStrength = parts[i + 3].toInt(&ok);
+        if (!ok)
+            satellite.signalStrength = -1;
+    }
+
+    if (message < messageCount) {
+        m_nextMessage[talker] = message + 1;
+        return NoUpdate;
+    }
+
+    Group &inView = m_inView[talker];
+    std::copy(group.satellites, group.satellites + group.count, inView.satellites);
+    inView.count = group.count;
+    m_nextMessage[talker] = 0;
+    return SatellitesInViewUpdated;
+}
+
+/*
+    $GPGSA,<mode>,<fix type>,<12 satellite ids>,<PDOP>,<HDOP>,<VDOP>[,<system id>]
+*/
+QNmeaSatelliteParser::Updates QNmeaSatelliteParser::parseGsa(const QNmeaTokenizer &parts, Talker talker)
+{
+    int identifiers[MaxSatellitesInUse];
+    int count = 0;
+    for (int i = 3; i < 3 + MaxSatellitesInUse && i < parts.count(); ++i) {
+        bool ok = false;
+        const int identifier = parts[i].toInt(&ok);
+        if (ok && identifier > 0)
+            identifiers[count++] = identifier;
+    }
+
+    if (talker == TalkerCombined) {
+        // Combined receivers send one GSA per system. NMEA 4.1 names the
+        // system, older receivers only tell through the satellite ids.
+        bool ok = false;
+        const int systemId = parts[18].toInt(&ok);
+        if (ok && systemId >= 1 && systemId <= 4)
+            talker = Talker(TalkerGps + systemId - 1);
+        else if (count > 0 && identifiers[0] <= 64)
+            talker = TalkerGps;
+        else if (count > 0 && identifiers[0] <= 96)
+            talker = TalkerGlonass;
+    }
+
+    std::copy(identifiers, identifiers + count, m_inUse[talker]);
+    m_inUseCount[talker] = count;
+    return SatellitesInUseUpdated;
+}
+
+QGeoSatelliteInfo QNmeaSatelliteParser::satelliteInfo(const Satellite &satellite, Talker talker) const
+{
+    QGeoSatelliteInfo info;
+    info.setSatelliteIdentifier(satellite.identifier);
+    info.setSignalStrength(satellite.signalStrength);
+    if (!qIsNaN(satellite.elevation))
+        info.setAttribute(QGeoSatelliteInfo::Elevation, satellite.elevation);
+    if (!qIsNaN(satellite.azimuth))
+        info.setAttribute(QGeoSatelliteInfo::Azimuth, satellite.azimuth);
+
+    switch (talker) {
+    case TalkerGps:
+        info.setSatelliteSystem(QGeoSatelliteInfo::GPS);
+        break;
+    case TalkerGlonass:
+        info.setSatelliteSystem(QGeoSatelliteInfo::GLONASS);
+        break;
+    case TalkerCombined:
+        // GPS and SBAS ids come first, followed by GLONASS
+        if (satellite.identifier <= 64)
+            info.setSatelliteSystem(QGeoSatelliteInfo::GPS);
+        else if (satellite.identifier <= 96)
+            info.setSatelliteSystem(QGeoSatelliteInfo::GLONASS);
+        break;
+    default:
+        break;
+    }
+    return info;
+}
+
+const QNmeaSatelliteParser::Satellite *QNmeaSatelliteParser::findInView(int identifier, Talker talker) const
+{
+    const Group &group = m_inView[talker];
+    for (int i = 0; i < group.count; ++i) {
+        if (group.satellites[i].identifier == identifier)
+            return &group.satellites[i];
+    }
+    return nullptr;
+}
+
+QList<QGeoSatelliteInfo> QNmeaSatelliteParser::satellitesInView() const
+{
+    int count = 0;
+    for (int t = 0; t < TalkerCount; ++t)
+        count += m_inView[t].count;
+
+    QList<QGeoSatelliteInfo> satellites;
+    satellites.reserve(count);
+    for (int t = 0; t < TalkerCount; ++t) {
+        const Group &group = m_inView[t];
+        for (int i = 0; i < group.count; ++i)
+            satellites.append(satelliteInfo(group.satellites[i], Talker(t)));
+    }
+    return satellites;
+}
+
+QList<QGeoSatelliteInfo> QNmeaSatelliteParser::satellitesInUse() const
+{
+    int count = 0;
+    for (int t = 0; t < TalkerCount; ++t)
+        count += m_inUseCount[t];
+
+    QList<QGeoSatelliteInfo> satellites;
+    satellites.reserve(count);
+    for (int t = 0; t < TalkerCount; ++t) {
+        for (int i = 0; i < m_inUseCount[t]; ++i) {
+            const int identifier = m_inUse[t][i];
+
+            // Take elevation, azimuth and signal strength from the satellites in view,
+            // a combined GSA may refer to satellites reported by a per system GSV
+            Talker inViewTalker = Talker(t);
+            const Satellite *satellite = findInView(identifier, inViewTalker);
+            for (int other = 0; !satellite && other < TalkerCount; ++other) {
+                if (other == t || (t != TalkerCombined && other != TalkerCombined))
+                    continue;
+                inViewTalker = Talker(other);
+                satellite = findInView(identifier, inViewTalker);
+            }
+
+            if (satellite) {
+                satellites.append(satelliteInfo(*satellite, inViewTalker));
+            } else {
+                const Satellite unknown = { identifier, -1, qQNaN(), qQNaN() };
+                satellites.append(satelliteInfo(unknown, Talker(t)));
+            }
+        }
+    }
+    return satellites;
+}
+
+//============================================================
+
+QNmeaSatelliteInfoSourcePrivate::QNmeaSatelliteInfoSourcePrivate(QNmeaSatelliteInfoSource *parent,
+                                                                 QNmeaPositionInfoSource *positionSource)
+    : QObject(parent),
+      m_source(parent),
+      m_positionSource(positionSource),
+      m_invokedStart(false),
+      m_satelliteError(QGeoSatelliteInfoSource::NoError),
+      m_requestTimer(0),
+      m_attached(false)
+{
+}
+
+QNmeaSatelliteInfoSourcePrivate::~QNmeaSatelliteInfoSourcePrivate()
+{
+    if (m_attached && m_positionSource)
+        m_positionSource->d->detachSatelliteSource(this);
+}
+
+bool QNmeaSatelliteInfoSourcePrivate::attach()
+{
+    if (m_attached)
+        return true;
+
+    if (!m_positionSource) {
+        qWarning("QNmeaSatelliteInfoSource: the position source has been destroyed");
+        return false;
+    }
+
+    m_attached = m_positionSource->d->attachSatelliteSource(this);
+    return m_attached;
+}
+
+void QNmeaSatelliteInfoSourcePrivate::startUpdates()
+{
+    if (m_invokedStart)
+        return;
+
+    m_invokedStart = true;
+    m_pendingUpdates = QNmeaSatelliteParser::NoUpdate;
+
+    m_updateTimer.stop();
+    if (m_source->updateInterval() > 0)
+        m_updateTimer.start(m_source->updateInterval(), this);
+
+    // In SimulationMode attaching may already deliver the first update
+    if (!attach()) {
+        stopUpdates();
+        m_source->setError(QGeoSatelliteInfoSource::AccessError);
+    }
+}
+
+void QNmeaSatelliteInfoSourcePrivate::stopUpdates()
+{
+    m_invokedStart = false;
+    m_updateTimer.stop();
+    m_pendingUpdates = QNmeaSatelliteParser::NoUpdate;
+}
+
+void QNmeaSatelliteInfoSourcePrivate::requestUpdate(int msec)
+{
+    if (m_requestTimer && m_requestTimer->isActive())
+        return;
+
+    if (msec <= 0 || msec < m_source->minimumUpdateInterval()) {
+        emit m_source->requestTimeout();
+        return;
+    }
+
+    if (!m_requestTimer) {
+        m_requestTimer = new QTimer(this);
+        connect(m_requestTimer, SIGNAL(timeout()), SLOT(updateRequestTimeout()));
+    }
+
+    m_requestTimer->start(msec);
+    if (!attach()) {
+        m_requestTimer->stop();
+        m_source->setError(QGeoSatelliteInfoSource::AccessError);
+        emit m_source->requestTimeout();
+    }
+}
+
+void QNmeaSatelliteInfoSourcePrivate::updateRequestTimeout()
+{
+    m_requestTimer->stop();
+    emit m_source->requestTimeout();
+}
+
+void QNmeaSatelliteInfoSourcePrivate::notifyNewUpdate(QNmeaSatelliteParser::Updates updates,
+                                                      const QList<QGeoSatelliteInfo> &inView,
+                                                      const QList<QGeoSatelliteInfo> &inUse)
+{
+    if (updates & QNmeaSatelliteParser::SatellitesInViewUpdated)
+        m_pendingInView = inView;
+    if (updates & QNmeaSatelliteParser::SatellitesInUseUpdated)
+        m_pendingInUse = inUse;
+    m_pendingUpdates |= updates;
+
+    if (m_requestTimer && m_requestTimer->isActive()) { // User called requestUpdate()
+        m_requestTimer->stop();
+        emitPendingUpdate();
+    } else if (m_invokedStart) { // user called startUpdates()
+        // for periodic updates, only the most recent lists are sent in timerEvent()
+        if (!m_updateTimer.isActive())
+            emitPendingUpdate();
+    } else {
+        m_pendingUpdates = QNmeaSatelliteParser::NoUpdate;
+    }
+}
+
+void QNmeaSatelliteInfoSourcePrivate::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_updateTimer.timerId()) {
+        QObject::timerEvent(event);
+        return;
+    }
+    emitPendingUpdate();
+}
+
+void QNmeaSatelliteInfoSourcePrivate::emitPendingUpdate()
+{
+    const QNmeaSatelliteParser::Updates updates = m_pendingUpdates;
+    m_pendingUpdates = QNmeaSatelliteParser::NoUpdate;
+
+    if (updates & QNmeaSatelliteParser::SatellitesInViewUpdated)
+        emit m_source->satellitesInViewUpdated(m_pendingInView);
+    if (updates & QNmeaSatelliteParser::SatellitesInUseUpdated)
+        emit m_source->satellitesInUseUpdated(m_pendingInUse);
+}
+
+//=========================================================
+
+/*!
+    \class QNmeaSatelliteInfoSource
+    \internal
+
+    \brief The QNmeaSatelliteInfoSource class provides satellite information using a NMEA data source.
+
+    The QNmeaSatelliteInfoSource class reads the GSV and GSA sentences of NMEA
+    data and reports the satellites in view and the satellites used in the
+    current fix. Sentences describing a group of satellites over several lines
+    are collected and reported once the group is complete.
+
+    Like QNmeaPositionInfoSource, a QNmeaSatelliteInfoSource operates in either
+    \l {RealTimeMode} or \l {SimulationMode}, and the source of NMEA data is set
+    with setDevice().
+
+    A GPS device usually delivers positions and satellites over the same
+    stream. To receive both without reading the device twice, construct the
+    satellite source with the QNmeaPositionInfoSource that reads the device.
+    Each sentence is then read once and dispatched to both sources.
+
+    Use startUpdates() to start receiving regular satellite updates and
+    stopUpdates() to stop these updates. If you only require updates
+    occasionally, you can call requestUpdate() to request a single update.
+*/
+
+/*!
+    \enum QNmeaSatelliteInfoSource::UpdateMode
+    Defines the available update modes.
+
+    \value RealTimeMode Satellite data is read and distributed from the data source as it becomes available.
+    \value SimulationMode Satellite data is distributed along with the position it was recorded with, at the rate at which the data was originally recorded.
+*/
+
+/*!
+    Constructs a QNmeaSatelliteInfoSource instance with the given \a parent
+    and \a updateMode.
+*/
+QNmeaSatelliteInfoSource::QNmeaSatelliteInfoSource(UpdateMode updateMode, QObject *parent)
+        : QGeoSatelliteInfoSource(parent),
+        d(new QNmeaSatelliteInfoSourcePrivate(this, nullptr))
+{
+    d->m_positionSource = new QNmeaPositionInfoSource(
+                QNmeaPositionInfoSource::UpdateMode(updateMode), d);
+}
+
+/*!
+    Constructs a QNmeaSatelliteInfoSource instance with the given \a parent
+    that reads the NMEA data of \a positionSource.
+
+    The update mode and the device are those of \a positionSource. The
+    position source must outlive the satellite source.
+*/
+QNmeaSatelliteInfoSource::QNmeaSatelliteInfoSource(QNmeaPositionInfoSource *positionSource,
+                                                   QObject *parent)
+        : QGeoSatelliteInfoSource(parent),
+        d(new QNmeaSatelliteInfoSourcePrivate(this, positionSource))
+{
+    if (!positionSource)
+        qWarning("QNmeaSatelliteInfoSource: no position source given");
+}
+
+/*!
+    Destroys the satellite source.
+*/
+QNmeaSatelliteInfoSource::~QNmeaSatelliteInfoSource()
+{
+    delete d;
+}
+
+/*!
+    Returns the update mode.
+*/
+QNmeaSatelliteInfoSource::UpdateMode QNmeaSatelliteInfoSource::updateMode() const
+{
+    if (!d->m_positionSource)
+        return RealTimeMode;
+    return UpdateMode(d->m_positionSource->updateMode());
+}
+
+/*!
+    Sets the NMEA data source to \a device. If the device is not open, it
+    will be opened in QIODevice::ReadOnly mode.
+
+    The source device can only be set once and must be set before calling
+    startUpdates() or requestUpdate(). When the satellite source reads through
+    a QNmeaPositionInfoSource, this sets the device of that source.
+
+    \b {Note:} The \a device must emit QIODevice::readyRead() for the
+    source to be notified when data is available for reading.
+    QNmeaSatelliteInfoSource does not assume the ownership of the device,
+    and hence does not deallocate it upon destruction.
+*/
+void QNmeaSatelliteInfoSource::setDevice(QIODevice *device)
+{
+    if (d->m_positionSource)
+        d->m_positionSource->setDevice(device);
+}
+
+/*!
+    Returns the NMEA data source.
+*/
+QIODevice *QNmeaSatelliteInfoSource::device() const
+{
+    return d->m_positionSource ? d->m_positionSource->device() : nullptr;
+}
+
+/*!
+    Returns the position source whose NMEA data is read. If the satellite
+    source was not constructed with a position source, this is an internal
+    source owned by the satellite source.
+*/
+QNmeaPositionInfoSource *QNmeaSatelliteInfoSource::positionInfoSource() const
+{
+    return d->m_positionSource;
+}
+
+/*!
+    \reimp
+*/
+void QNmeaSatelliteInfoSource::setUpdateInterval(int msec)
+{
+    int interval = msec;
+    if (interval != 0)
+        interval = qMax(msec, minimumUpdateInterval());
+    QGeoSatelliteInfoSource::setUpdateInterval(interval);
+    if (d->m_invokedStart) {
+        d->stopUpdates();
+        d->startUpdates();
+    }
+}
+
+/*!
+    \reimp
+*/
+int QNmeaSatelliteInfoSource::minimumUpdateInterval() const
+{
+    return 2; // Some chips are capable of over 100 updates per seconds.
+}
+
+/*!
+    \reimp
+*/
+QGeoSatelliteInfoSource::Error QNmeaSatelliteInfoSource::error() const
+{
+    return d->m_satelliteError;
+}
+
+/*!
+    \reimp
+*/
+void QNmeaSatelliteInfoSource::startUpdates()
+{
+    d->startUpdates();
+}
+
+/*!
+    \reimp
+*/
+void QNmeaSatelliteInfoSource::stopUpdates()
+{
+    d->stopUpdates();
+}
+
+/*!
+    \reimp
+*/
+void QNmeaSatelliteInfoSource::requestUpdate(int msec)
+{
+    d->requestUpdate(msec == 0 ? 60000 * 5 : msec); // 5min default timeout
+}
+
+void QNmeaSatelliteInfoSource::setError(QGeoSatelliteInfoSource::Error satelliteError)
+{
+    d->m_satelliteError = satelliteError;
+    emit QGeoSatelliteInfoSource::error(satelliteError);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,221 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QNMEASATELLITEINFOSOURCE_P_H
+#define QNMEASATELLITEINFOSOURCE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qnmeapositioninfosource.h"
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/QGeoSatelliteInfo>
+#include <QtPositioning/QGeoSatelliteInfoSource>
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QBasicTimer>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+class QTimer;
+class QTimerEvent;
+class QNmeaTokenizer;
+
+class QNmeaSatelliteInfoSourcePrivate;
+class Q_POSITIONING_PRIVATE_EXPORT QNmeaSatelliteInfoSource : public QGeoSatelliteInfoSource
+{
+    Q_OBJECT
+public:
+    enum UpdateMode {
+        RealTimeMode = 1,
+        SimulationMode
+    };
+
+    explicit QNmeaSatelliteInfoSource(UpdateMode updateMode, QObject *parent = nullptr);
+    explicit QNmeaSatelliteInfoSource(QNmeaPositionInfoSource *positionSource,
+                                      QObject *parent = nullptr);
+    ~QNmeaSatelliteInfoSource();
+
+    UpdateMode updateMode() const;
+
+    void setDevice(QIODevice *source);
+    QIODevice *device() const;
+
+    QNmeaPositionInfoSource *positionInfoSource() const;
+
+    void setUpdateInterval(int msec);
+    int minimumUpdateInterval() const;
+    Error error() const;
+
+public Q_SLOTS:
+    void startUpdates();
+    void stopUpdates();
+    void requestUpdate(int timeout = 0);
+
+private:
+    Q_DISABLE_COPY(QNmeaSatelliteInfoSource)
+    friend class QNmeaSatelliteInfoSourcePrivate;
+    QNmeaSatelliteInfoSourcePrivate *d;
+    void setError(QGeoSatelliteInfoSource::Error satelliteError);
+};
+
+/*
+    Collects GSV and GSA sentences into the satellites in view and in use.
+
+    GSV groups span several sentences and are received into fixed storage,
+    a group only becomes visible once its last sentence arrived. Each talker
+    (GP, GL, GA, ...) has its own groups, the reported lists combine them.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QNmeaSatelliteParser
+{
+public:
+    enum Update {
+        NoUpdate = 0x0,
+        SatellitesInViewUpdated = 0x1,
+        SatellitesInUseUpdated = 0x2
+    };
+    Q_DECLARE_FLAGS(Updates, Update)
+
+    QNmeaSatelliteParser();
+
+    Updates parseSentence(const char *data, int size);
+    void clear();
+
+    QList<QGeoSatelliteInfo> satellitesInView() const;
+    QList<QGeoSatelliteInfo> satellitesInUse() const;
+
+private:
+    enum {
+        MaxSatellites = 64,     // per talker, more than any GSV group carries
+        MaxSatellitesInUse = 12 // fixed by the GSA sentence
+    };
+
+    enum Talker {
+        TalkerGps,
+        TalkerGlonass,
+        TalkerGalileo,
+        TalkerBeidou,
+        TalkerCombined,
+        TalkerCount
+    };
+
+    struct Satellite
+    {
+        int identifier;
+        int signalStrength;
+        double elevation;
+        double azimuth;
+    };
+
+    struct Group
+    {
+        Satellite satellites[MaxSatellites];
+        int count;
+    };
+
+    Updates parseGsv(const QNmeaTokenizer &parts, Talker talker);
+    Updates parseGsa(const QNmeaTokenizer &parts, Talker talker);
+    QGeoSatelliteInfo satelliteInfo(const Satellite &satellite, Talker talker) const;
+    const Satellite *findInView(int identifier, Talker talker) const;
+
+    Group m_receiving[TalkerCount];
+    int m_messageCount[TalkerCount];
+    int m_nextMessage[TalkerCount];
+
+    Group m_inView[TalkerCount];
+    int m_inUse[TalkerCount][MaxSatellitesInUse];
+    int m_inUseCount[TalkerCount];
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QNmeaSatelliteParser::Updates)
+
+class QNmeaSatelliteInfoSourcePrivate : public QObject
+{
+    Q_OBJECT
+public:
+    QNmeaSatelliteInfoSourcePrivate(QNmeaSatelliteInfoSource *parent,
+                                    QNmeaPositionInfoSource *positionSource);
+    ~QNmeaSatelliteInfoSourcePrivate();
+
+    void startUpdates();
+    void stopUpdates();
+    void requestUpdate(int msec);
+
+    // Called by the position source for every completed group
+    void notifyNewUpdate(QNmeaSatelliteParser::Updates updates,
+                         const QList<QGeoSatelliteInfo> &inView,
+                         const QList<QGeoSatelliteInfo> &inUse);
+
+    QNmeaSatelliteInfoSource *m_source;
+    QPointer<QNmeaPositionInfoSource> m_positionSource;
+    bool m_invokedStart;
+    QGeoSatelliteInfoSource::Error m_satelliteError;
+
+protected:
+    void timerEvent(QTimerEvent *event);
+
+private Q_SLOTS:
+    void updateRequestTimeout();
+
+private:
+    bool attach();
+    void emitPendingUpdate();
+
+    QList<QGeoSatelliteInfo> m_pendingInView;
+    QList<QGeoSatelliteInfo> m_pendingInUse;
+    QNmeaSatelliteParser::Updates m_pendingUpdates;
+    QBasicTimer m_updateTimer; // the timer used in startUpdates()
+    QTimer *m_requestTimer; // the timer used in requestUpdate()
+    bool m_attached;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,277 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qnmeatokenizer_p.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+
+#include <math.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The conversions below take a fast path for the plain decimal numbers NMEA
+    devices emit and defer anything else to QByteArray, so that the results
+    never differ from what splitting the sentence into QByteArrays gave.
+
+    A mantissa of at most 15 digits and a power of ten up to 10^22 are both
+    exact doubles, so their quotient is correctly rounded, as with strtod().
+*/
+
+static const double qnmea_powersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+enum {
+    MaxExactDigits = 15,
+    MaxIntDigits = 9
+};
+
+static inline bool qnmea_isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline int qnmea_digitsAt(const char *data, int size, int from, int count)
+{
+    int value = 0;
+    for (int i = from; i < from + count && i < size; ++i)
+        value = value * 10 + (data[i] - '0');
+    return value;
+}
+
+double QNmeaField::toDouble(bool *ok) const
+{
+    int i = 0;
+    bool negative = false;
+    if (i < m_size && (m_data[i] == '-' || m_data[i] == '+'))
+        negative = (m_data[i++] == '-');
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int decimals = 0;
+    bool seenDot = false;
+    for (; i < m_size; ++i) {
+        const char c = m_data[i];
+        if (qnmea_isDigit(c)) {
+            mantissa = mantissa * 10 + quint64(c - '0');
+            ++digits;
+            if (seenDot)
+                ++decimals;
+        } else if (c == '.' && !seenDot) {
+            seenDot = true;
+        } else {
+            break;
+        }
+    }
+
+    if (i == m_size && digits > 0 && digits <= MaxExactDigits) {
+        if (ok)
+            *ok = true;
+        const double value = double(mantissa) / qnmea_powersOf10[decimals];
+        return negative ? -value : value;
+    }
+
+    return QByteArray::fromRawData(m_data, m_size).toDouble(ok);
+}
+
+int QNmeaField::toInt(bool *ok) const
+{
+    int i = 0;
+    bool negative = false;
+    if (i < m_size && (m_data[i] == '-' || m_data[i] == '+'))
+        negative = (m_data[i++] == '-');
+
+    const int digits = m_size - i;
+    if (digits > 0 && digits <= MaxIntDigits) {
+        int value = 0;
+        for (; i < m_size && qnmea_isDigit(m_data[i]); ++i)
+            value = value * 10 + (m_data[i] - '0');
+        if (i == m_size) {
+            if (ok)
+                *ok = true;
+            return negative ? -value : value;
+        }
+    }
+
+    return QByteArray::fromRawData(m_data, m_size).toInt(ok);
+}
+
+uint QNmeaField::toUInt(bool *ok) const
+{
+    if (m_size > 0 && m_size <= MaxIntDigits) {
+        uint value = 0;
+        int i = 0;
+        for (; i < m_size && qnmea_isDigit(m_data[i]); ++i)
+            value = value * 10 + uint(m_data[i] - '0');
+        if (i == m_size) {
+            if (ok)
+                *ok = true;
+            return value;
+        }
+    }
+
+    return QByteArray::fromRawData(m_data, m_size).toUInt(ok);
+}
+
+bool QNmeaField::toDegrees(double *degrees) const
+{
+    // Fixed point: the integer part holds degrees and whole minutes, so only
+    // the fraction of the minutes needs floating point
+    int i = 0;
+    int whole = 0;
+    for (; i < m_size && i < MaxIntDigits && qnmea_isDigit(m_data[i]); ++i)
+        whole = whole * 10 + (m_data[i] - '0');
+    const int wholeDigits = i;
+
+    quint64 fraction = 0;
+    int decimals = 0;
+    if (i < m_size && m_data[i] == '.') {
+        for (++i; i < m_size && decimals < MaxExactDigits && qnmea_isDigit(m_data[i]); ++i) {
+            fraction = fraction * 10 + quint64(m_data[i] - '0');
+            ++decimals;
+        }
+    }
+
+    if (i == m_size && wholeDigits + decimals > 0) {
+        const double minutes = (whole % 100) + double(fraction) / qnmea_powersOf10[decimals];
+        *degrees = (whole / 100) + minutes / 60.0;
+        return true;
+    }
+
+    bool ok = false;
+    const double value = QByteArray::fromRawData(m_data, m_size).toDouble(&ok);
+    if (!ok)
+        return false;
+    double deg;
+    const double min = 100.0 * modf(value / 100.0, &deg);
+    *degrees = deg + (min / 60.0);
+    return true;
+}
+
+bool QNmeaField::toTime(QTime *time) const
+{
+    int dotIndex = -1;
+    for (int i = 0; i < m_size; ++i) {
+        if (m_data[i] == '.') {
+            dotIndex = i;
+            break;
+        }
+    }
+    const int hmsSize = dotIndex < 0 ? m_size : dotIndex;
+
+    QTime tempTime;
+    bool allDigits = hmsSize == 6;
+    for (int i = 0; allDigits && i < hmsSize; ++i)
+        allDigits = qnmea_isDigit(m_data[i]);
+    if (allDigits) {
+        const int h = qnmea_digitsAt(m_data, m_size, 0, 2);
+        const int m = qnmea_digitsAt(m_data, m_size, 2, 2);
+        const int s = qnmea_digitsAt(m_data, m_size, 4, 2);
+        if (QTime::isValid(h, m, s))
+            tempTime = QTime(h, m, s);
+    } else {
+        tempTime = QTime::fromString(QString::fromLatin1(m_data, hmsSize),
+                                     QStringLiteral("hhmmss"));
+    }
+
+    if (dotIndex >= 0) {
+        bool hasMsecs = false;
+        const int midLen = qMin(3, m_size - dotIndex - 1);
+        const int msecs = QNmeaField(m_data + dotIndex + 1, midLen).toUInt(&hasMsecs);
+        if (hasMsecs)
+            tempTime = tempTime.addMSecs(msecs * (midLen == 3 ? 1 : midLen == 2 ? 10 : 100));
+    }
+
+    if (tempTime.isValid()) {
+        *time = tempTime;
+        return true;
+    }
+    return false;
+}
+
+bool QNmeaField::toDate(QDate *date) const
+{
+    bool allDigits = m_size == 6;
+    for (int i = 0; allDigits && i < m_size; ++i)
+        allDigits = qnmea_isDigit(m_data[i]);
+
+    QDate tempDate;
+    if (allDigits) {
+        const int d = qnmea_digitsAt(m_data, m_size, 0, 2);
+        const int m = qnmea_digitsAt(m_data, m_size, 2, 2);
+        const int y = qnmea_digitsAt(m_data, m_size, 4, 2);
+        // Validated as a 20th century date, like QDate::fromString() does
+        if (QDate::isValid(1900 + y, m, d))
+            tempDate = QDate(2000 + y, m, d);
+    } else {
+        tempDate = QDate::fromString(QString::fromLatin1(m_data, m_size), QStringLiteral("ddMMyy"));
+        if (tempDate.isValid())
+            tempDate = tempDate.addYears(100);
+    }
+
+    *date = tempDate;
+    return tempDate.isValid();
+}
+
+QByteArray QNmeaField::toByteArray() const
+{
+    return QByteArray(m_data, m_size);
+}
+
+QNmeaTokenizer::QNmeaTokenizer(const char *data, int size)
+    : m_data(data), m_count(1)
+{
+    m_starts[0] = 0;
+    int i = 0;
+    for (; i < size; ++i) {
+        if (data[i] == ',') {
+            if (m_count == MaxFields)
+                break;
+            m_starts[m_count++] = i + 1;
+        }
+    }
+    // Sentinel so that field i always ends at m_starts[i + 1] - 1
+    m_starts[m_count] = i + 1;
+}
+
+QT_END_NAMESPACE
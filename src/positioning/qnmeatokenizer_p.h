@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QNMEATOKENIZER_P_H
+#define QNMEATOKENIZER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QByteArray;
+class QDate;
+class QTime;
+
+// A field of an NMEA sentence, pointing into the buffer of the sentence
+class Q_POSITIONING_PRIVATE_EXPORT QNmeaField
+{
+public:
+    QNmeaField() : m_data(nullptr), m_size(0) {}
+    QNmeaField(const char *data, int size) : m_data(data), m_size(size) {}
+
+    const char *data() const { return m_data; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    char at(int i) const { return m_data[i]; }
+
+    // Same results as the QByteArray conversions, without allocating for
+    // plain decimal numbers
+    double toDouble(bool *ok = nullptr) const;
+    int toInt(bool *ok = nullptr) const;
+    uint toUInt(bool *ok = nullptr) const;
+
+    // ddmm.mmmm or dddmm.mmmm to decimal degrees, without the hemisphere
+    bool toDegrees(double *degrees) const;
+    // hhmmss or hhmmss.sss
+    bool toTime(QTime *time) const;
+    // ddMMyy, in the 21st century
+    bool toDate(QDate *date) const;
+
+    QByteArray toByteArray() const;
+
+private:
+    const char *m_data;
+    int m_size;
+};
+
+/*
+    Splits an NMEA sentence at the commas, in place. The data must remain
+    valid while the tokenizer is in use and should not include the checksum.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QNmeaTokenizer
+{
+public:
+    enum { MaxFields = 64 };
+
+    QNmeaTokenizer(const char *data, int size);
+
+    int count() const { return m_count; }
+    QNmeaField field(int i) const
+    {
+        if (i < 0 || i >= m_count)
+            return QNmeaField();
+        return QNmeaField(m_data + m_starts[i], m_starts[i + 1] - m_starts[i] - 1);
+    }
+    QNmeaField operator[](int i) const { return field(i); }
+
+private:
+    const char *m_data;
+    int m_count;
+    int m_starts[MaxFields + 1]; // offset of each field, one past the end of the last
+};
+
+QT_END_NAMESPACE
+
+#endif // QNMEATOKENIZER_P_H
@@ -49,12 +49,17 @@
 QT_BEGIN_NAMESPACE
 
 QDoubleVector2D QWebMercator::coordToMercator(const QGeoCoordinate &coord)
+{
+    return coordToMercator(coord.latitude(), coord.longitude());
+}
+
+QDoubleVector2D QWebMercator::coordToMercator(double latitude, double longitude)
 {
     const double pi = M_PI;
 
-    double lon = coord.longitude() / 360.0 + 0.5;
+    double lon = longitude / 360.0 + 0.5;
 
-    double lat = coord.latitude();
+    double lat = latitude;
     lat = 0.5 - (std::log(std::tan((pi / 4.0) + (pi / 2.0) * lat / 180.0)) / pi) / 2.0;
     lat = qBound(0.0, lat, 1.0);
 
@@ -49,9 +49,22 @@ qtHaveModule(location) {
            qgeoroutesegment \
            qgeoroutingmanagerplugins \
            qgeotilespec \
+           qgeofiletilecache \
+           qgeotilefetchqueue \
+           qgeotilearchive \
+           qgeotilesegmentstore \
+           qgeotilecachejournal \
+           qgeotileatlas \
+           qgeotilequadtree \
            qgeoroutexmlparser \
+           qgeorouteparser \
            maptype \
-           qgeocameratiles
+           qgeocameratiles \
+           qgeoconvexclipper \
+           qgeosimplifiedpath
+
+    qtHaveModule(quick): SUBDIRS += qgeomappolylinegeometry \
+                                    qgeomapobjectqsgsupport
 
     # These use plugins
     !android: SUBDIRS += qgeoserviceprovider \
@@ -77,6 +90,9 @@ SUBDIRS += \
            qgeopath \
            qgeopolygon \
            qgeocoordinate \
+           qgeocoordinatearray \
+           qgeocoordinatebatch \
+           qnmeatokenizer \
            qgeolocation \
            qgeopositioninfo \
            qgeosatelliteinfo \
@@ -87,4 +103,5 @@ SUBDIRS += \
             qgeoareamonitor \
             qgeopositioninfosource \
             qgeosatelliteinfosource \
-            qnmeapositioninfosource
+            qnmeapositioninfosource \
+            qnmeasatelliteinfosource
@@ -37,6 +37,7 @@
 
 #include <QDebug>
 #include <QDataStream>
+#include <QHash>
 
 #include <QtPositioning/qgeoareamonitorinfo.h>
 #include <QtPositioning/qgeoareamonitorsource.h>
@@ -69,6 +70,38 @@ void tst_qgeoareamonitorinfo_messageHandler(QtMsgType type,
     }
 }
 
+// Reports the positions handed to it, to place fixes exactly
+class ScriptedPositionSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+public:
+    ScriptedPositionSource(QObject *parent = 0) : QGeoPositionInfoSource(parent) {}
+
+    void moveTo(const QGeoCoordinate &coordinate)
+    {
+        lastPosition = QGeoPositionInfo(coordinate, QDateTime::currentDateTime());
+        emit positionUpdated(lastPosition);
+    }
+
+    QGeoPositionInfo lastKnownPosition(bool fromSatellitePositioningMethodsOnly = false) const override
+    {
+        Q_UNUSED(fromSatellitePositioningMethodsOnly);
+        return lastPosition;
+    }
+
+    PositioningMethods supportedPositioningMethods() const override { return AllPositioningMethods; }
+    int minimumUpdateInterval() const override { return 0; }
+    Error error() const override { return NoError; }
+
+public slots:
+    void startUpdates() override {}
+    void stopUpdates() override {}
+    void requestUpdate(int timeout = 5000) override { Q_UNUSED(timeout); }
+
+private:
+    QGeoPositionInfo lastPosition;
+};
+
 class tst_QGeoAreaMonitorSource : public QObject
 {
     Q_OBJECT
@@ -709,6 +742,157 @@ private slots:
         delete obj2;
     }
 
+    // Monitors whose bounding box crosses the dateline are indexed in the
+    // cells on both sides of it
+    void tst_datelineMonitor()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+        QSignalSpy enteredSpy(obj, SIGNAL(areaEntered(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+        QSignalSpy exitedSpy(obj, SIGNAL(areaExited(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+
+        ScriptedPositionSource *source = new ScriptedPositionSource(this);
+        obj->setPositionInfoSource(source);
+
+        QGeoAreaMonitorInfo infoRectangle("DatelineRectangle");
+        infoRectangle.setArea(QGeoRectangle(QGeoCoordinate(10.0, 179.75), QGeoCoordinate(9.0, -179.75)));
+        QVERIFY(obj->startMonitoring(infoRectangle));
+
+        QGeoAreaMonitorInfo infoCircle("DatelineCircle");
+        infoCircle.setArea(QGeoCircle(QGeoCoordinate(-20.0, 180.0), 20000));
+        QVERIFY(obj->startMonitoring(infoCircle));
+
+        // east of the dateline
+        source->moveTo(QGeoCoordinate(9.5, 179.9));
+        QCOMPARE(enteredSpy.count(), 1);
+        QCOMPARE(enteredSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoRectangle);
+
+        // across it, still inside
+        source->moveTo(QGeoCoordinate(9.5, -179.9));
+        QCOMPARE(enteredSpy.count(), 0);
+        QCOMPARE(exitedSpy.count(), 0);
+
+        source->moveTo(QGeoCoordinate(9.5, -179.5));
+        QCOMPARE(exitedSpy.count(), 1);
+        QCOMPARE(exitedSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoRectangle);
+
+        // the circle, entered from the west and left to the east
+        source->moveTo(QGeoCoordinate(-20.0, -179.95));
+        QCOMPARE(enteredSpy.count(), 1);
+        QCOMPARE(enteredSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoCircle);
+
+        source->moveTo(QGeoCoordinate(-20.0, 179.95));
+        QCOMPARE(exitedSpy.count(), 0);
+
+        source->moveTo(QGeoCoordinate(-20.0, 179.5));
+        QCOMPARE(exitedSpy.count(), 1);
+        QCOMPARE(exitedSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoCircle);
+        QCOMPARE(enteredSpy.count(), 0);
+
+        delete obj;
+    }
+
+    // Monitors spanning several cells, or too many to be indexed, report
+    // once when entered and once when left, wherever that happens
+    void tst_largeMonitor()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+        QSignalSpy enteredSpy(obj, SIGNAL(areaEntered(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+        QSignalSpy exitedSpy(obj, SIGNAL(areaExited(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+
+        ScriptedPositionSource *source = new ScriptedPositionSource(this);
+        obj->setPositionInfoSource(source);
+
+        // 10 x 10 cells of 0.1 degrees
+        QGeoAreaMonitorInfo infoMedium("Medium");
+        infoMedium.setArea(QGeoRectangle(QGeoCoordinate(51.0, 0.0), QGeoCoordinate(50.0, 1.0)));
+        QVERIFY(obj->startMonitoring(infoMedium));
+
+        // far more cells than are indexed
+        QGeoAreaMonitorInfo infoLarge("Large");
+        infoLarge.setArea(QGeoRectangle(QGeoCoordinate(60.0, -10.0), QGeoCoordinate(40.0, 10.0)));
+        QVERIFY(obj->startMonitoring(infoLarge));
+
+        source->moveTo(QGeoCoordinate(45.0, -5.0));
+        QCOMPARE(enteredSpy.count(), 1);
+        QCOMPARE(enteredSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoLarge);
+
+        // the opposite corners of the medium monitor, in different cells
+        source->moveTo(QGeoCoordinate(50.05, 0.05));
+        QCOMPARE(enteredSpy.count(), 1);
+        QCOMPARE(enteredSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoMedium);
+        source->moveTo(QGeoCoordinate(50.95, 0.95));
+        source->moveTo(QGeoCoordinate(50.5, 0.5));
+        QCOMPARE(enteredSpy.count(), 0);
+        QCOMPARE(exitedSpy.count(), 0);
+
+        // left from a cell the medium monitor is not listed in
+        source->moveTo(QGeoCoordinate(55.0, 5.0));
+        QCOMPARE(exitedSpy.count(), 1);
+        QCOMPARE(exitedSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoMedium);
+
+        source->moveTo(QGeoCoordinate(-45.0, 5.0));
+        QCOMPARE(exitedSpy.count(), 1);
+        QCOMPARE(exitedSpy.takeFirst().at(0).value<QGeoAreaMonitorInfo>(), infoLarge);
+        QCOMPARE(enteredSpy.count(), 0);
+
+        // both at once
+        source->moveTo(QGeoCoordinate(50.5, 0.5));
+        QCOMPARE(enteredSpy.count(), 2);
+        QStringList entered;
+        for (const QList<QVariant> &arguments : qAsConst(enteredSpy))
+            entered.append(arguments.at(0).value<QGeoAreaMonitorInfo>().name());
+        entered.sort();
+        QCOMPARE(entered, QStringList() << "Large" << "Medium");
+
+        delete obj;
+    }
+
+    // Monitors expire in the order of their expiry time, also when they were
+    // added out of order, updated or stopped before they expired
+    void tst_expiryOrder()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+        QSignalSpy expirySpy(obj, SIGNAL(monitorExpired(QGeoAreaMonitorInfo)));
+
+        const QDateTime now = QDateTime::currentDateTime();
+        const QGeoRectangle area(QGeoCoordinate(1.0, 1.0), 1.0, 1.0);
+        const char *names[] = { "c", "a", "d", "b", "e" };
+        const int msecs[] = { 1500, 500, 750, 1000, 1250 };
+        QHash<QString, QGeoAreaMonitorInfo> infos;
+        for (int i = 0; i < 5; ++i) {
+            QGeoAreaMonitorInfo mon(QLatin1String(names[i]));
+            mon.setArea(area);
+            mon.setExpiration(now.addMSecs(msecs[i]));
+            QVERIFY(obj->startMonitoring(mon));
+            infos.insert(mon.name(), mon);
+        }
+
+        // moved behind c, its first entry in the heap is stale
+        QGeoAreaMonitorInfo monD = infos.value(QStringLiteral("d"));
+        monD.setExpiration(now.addMSecs(2000));
+        QVERIFY(obj->startMonitoring(monD));
+
+        // stopped, never expires
+        QVERIFY(obj->stopMonitoring(infos.value(QStringLiteral("e"))));
+        QCOMPARE(obj->activeMonitors().count(), 4);
+
+        QTRY_COMPARE_WITH_TIMEOUT(expirySpy.count(), 4, 5000);
+        QStringList order;
+        for (const QList<QVariant> &arguments : qAsConst(expirySpy))
+            order.append(arguments.at(0).value<QGeoAreaMonitorInfo>().name());
+        QCOMPARE(order, QStringList() << "a" << "b" << "c" << "d");
+        QCOMPARE(obj->activeMonitors().count(), 0);
+
+        // the stale entries do not fire
+        QTest::qWait(500);
+        QCOMPARE(expirySpy.count(), 4);
+
+        delete obj;
+    }
+
     void debug_data()
     {
         QTest::addColumn<QGeoAreaMonitorInfo>("info");
@@ -70,6 +70,9 @@ private slots:
     void tilesPositions();
     void tilesPositions_data();
     void test_tilted_frustum();
+    void tileSpans();
+    void detailTiles_data();
+    void detailTiles();
 };
 
 void tst_QGeoCameraTiles::row(const PositionTestInfo &pti, int xOffset, int yOffset, int tileX, int tileY, int tileW, int tileH)
@@ -140,6 +143,122 @@ void tst_QGeoCameraTiles::test_tilted_frustum()
     QCOMPARE(ct.createTiles(), ctFull.createTiles());
 }
 
+static QSet<QGeoTileSpec> tilesFromSpans(const QVector<QGeoCameraTileSpan> &spans, int zoom)
+{
+    QSet<QGeoTileSpec> tiles;
+    for (const QGeoCameraTileSpan &span : spans) {
+        for (int x = span.minX; x <= span.maxX; ++x)
+            tiles.insert(QGeoTileSpec(QString(), 0, zoom, x, span.y));
+    }
+    return tiles;
+}
+
+void tst_QGeoCameraTiles::tileSpans()
+{
+    QGeoCameraTiles ct;
+    ct.setTileSize(256);
+    ct.setScreenSize(QSize(640, 360));
+
+    QSet<QGeoTileSpec> reported;
+    QVector<QGeoCameraTileSpan> entered;
+    QVector<QGeoCameraTileSpan> left;
+
+    // Pans across the dateline, then zooms in
+    for (int i = 0; i < 40; ++i) {
+        QGeoCameraData camera;
+        camera.setZoomLevel(i < 30 ? 5.5 : 6.5);
+        camera.setTilt(45);
+        camera.setBearing(20);
+        camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.95 + i * 0.004, 0.4)));
+        ct.setCameraData(camera);
+
+        const int zoom = ct.tileZoomLevel();
+        const QSet<QGeoTileSpec> tiles = tilesFromSpans(ct.tileSpans(), zoom);
+
+        // The tiles patched in place match those of a fresh instance
+        QGeoCameraTiles fresh;
+        fresh.setTileSize(256);
+        fresh.setScreenSize(QSize(640, 360));
+        fresh.setCameraData(camera);
+        QCOMPARE(ct.createTiles(), fresh.createTiles());
+        QCOMPARE(ct.createTiles(), tiles);
+
+        if (ct.tileSpanChanges(&entered, &left)) {
+            QVERIFY(i != 0 && i != 30);
+            reported.subtract(tilesFromSpans(left, zoom));
+            QVERIFY(!reported.intersects(tilesFromSpans(entered, zoom)));
+            reported.unite(tilesFromSpans(entered, zoom));
+        } else {
+            QVERIFY(i == 0 || i == 30);
+            QVERIFY(entered.isEmpty());
+            QVERIFY(left.isEmpty());
+            reported = tiles;
+        }
+        QCOMPARE(reported, tiles);
+    }
+}
+
+void tst_QGeoCameraTiles::detailTiles_data()
+{
+    QTest::addColumn<double>("zoomLevel");
+    QTest::addColumn<double>("tilt");
+    QTest::addColumn<double>("minimumReduction");
+
+    QTest::newRow("z14 tilt 0") << 14.0 << 0.0 << 1.0;
+    QTest::newRow("z14 tilt 30") << 14.0 << 30.0 << 1.0;
+    QTest::newRow("z14 tilt 60") << 14.0 << 60.0 << 3.0;
+    QTest::newRow("z14.5 tilt 60") << 14.5 << 60.0 << 3.0;
+    QTest::newRow("z2.5 tilt 60") << 2.5 << 60.0 << 1.0;
+}
+
+void tst_QGeoCameraTiles::detailTiles()
+{
+    QFETCH(double, zoomLevel);
+    QFETCH(double, tilt);
+    QFETCH(double, minimumReduction);
+
+    QGeoCameraData camera;
+    camera.setZoomLevel(zoomLevel);
+    camera.setTilt(tilt);
+    camera.setBearing(30);
+    camera.setCenter(QGeoCoordinate(48.5, 9.0));
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(256);
+    ct.setScreenSize(QSize(1280, 720));
+    ct.setCameraData(camera);
+    const QSet<QGeoTileSpec> tiles = ct.createTiles();
+
+    ct.setDetailThreshold(1.25);
+    const QSet<QGeoTileSpec> detailTiles = ct.createTiles();
+    QVERIFY(tiles.size() >= minimumReduction * detailTiles.size());
+    if (tilt == 0.0)
+        QCOMPARE(detailTiles, tiles);
+
+    // The tiles cover the same area, once
+    const int zoom = ct.tileZoomLevel();
+    QSet<QGeoTileSpec> covered;
+    for (const QGeoTileSpec &tile : detailTiles) {
+        QVERIFY(tile.zoom() <= zoom);
+        const int shift = zoom - tile.zoom();
+        for (int y = tile.y() << shift; y < (tile.y() + 1) << shift; ++y) {
+            for (int x = tile.x() << shift; x < (tile.x() + 1) << shift; ++x) {
+                const QGeoTileSpec spec(QString(), 0, zoom, x, y);
+                QVERIFY(!covered.contains(spec));
+                covered.insert(spec);
+            }
+        }
+    }
+    QVERIFY(covered.contains(tiles));
+
+    // Disabled again, or limited to the camera's zoom level
+    ct.setMinimumZoomLevel(zoom);
+    QCOMPARE(ct.createTiles(), tiles);
+    ct.setMinimumZoomLevel(0);
+    ct.setDetailThreshold(0.0);
+    QCOMPARE(ct.createTiles(), tiles);
+}
+
 void tst_QGeoCameraTiles::tilesPlugin()
 {
     QGeoCameraData camera;
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoconvexclipper
+
+SOURCES += tst_qgeoconvexclipper.cpp
+
+QT += location-private positioning-private testlib
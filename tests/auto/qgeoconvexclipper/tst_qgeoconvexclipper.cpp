@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtLocation/private/qgeoconvexclipper_p.h>
+
+QT_USE_NAMESPACE
+
+static double area(const QGeoConvexClipper::Polygon &polygon)
+{
+    double result = 0.0;
+    for (int i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+        result += polygon.at(j).x() * polygon.at(i).y() - polygon.at(i).x() * polygon.at(j).y();
+    return qAbs(result) * 0.5;
+}
+
+class tst_QGeoConvexClipper : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void intersect_data();
+    void intersect();
+    void contains();
+};
+
+void tst_QGeoConvexClipper::intersect_data()
+{
+    QTest::addColumn<QList<QDoubleVector2D> >("subject");
+    QTest::addColumn<QList<QDoubleVector2D> >("clip");
+    QTest::addColumn<int>("vertices");
+    QTest::addColumn<double>("area");
+
+    const QList<QDoubleVector2D> square = { QDoubleVector2D(0, 0), QDoubleVector2D(2, 0),
+                                            QDoubleVector2D(2, 2), QDoubleVector2D(0, 2) };
+    QList<QDoubleVector2D> clockwise = square;
+    std::reverse(clockwise.begin(), clockwise.end());
+
+    QTest::newRow("overlap")
+            << square
+            << QList<QDoubleVector2D>{ QDoubleVector2D(1, 1), QDoubleVector2D(3, 1),
+                                       QDoubleVector2D(3, 3), QDoubleVector2D(1, 3) }
+            << 4 << 1.0;
+    QTest::newRow("clockwise clip")
+            << QList<QDoubleVector2D>{ QDoubleVector2D(1, 1), QDoubleVector2D(3, 1),
+                                       QDoubleVector2D(3, 3), QDoubleVector2D(1, 3) }
+            << clockwise << 4 << 1.0;
+    QTest::newRow("inside")
+            << QList<QDoubleVector2D>{ QDoubleVector2D(0.5, 0.5), QDoubleVector2D(1.5, 0.5),
+                                       QDoubleVector2D(1, 1.5) }
+            << square << 3 << 0.5;
+    QTest::newRow("diamond")
+            << square
+            << QList<QDoubleVector2D>{ QDoubleVector2D(1, -0.5), QDoubleVector2D(2.5, 1),
+                                       QDoubleVector2D(1, 2.5), QDoubleVector2D(-0.5, 1) }
+            << 8 << 3.5;
+    QTest::newRow("same")
+            << square << clockwise << 4 << 4.0;
+    QTest::newRow("shared edge")
+            << square
+            << QList<QDoubleVector2D>{ QDoubleVector2D(2, 0), QDoubleVector2D(4, 0),
+                                       QDoubleVector2D(4, 2), QDoubleVector2D(2, 2) }
+            << 0 << 0.0;
+    QTest::newRow("disjoint")
+            << square
+            << QList<QDoubleVector2D>{ QDoubleVector2D(5, 5), QDoubleVector2D(6, 5),
+                                       QDoubleVector2D(6, 6) }
+            << 0 << 0.0;
+    QTest::newRow("degenerate clip")
+            << square
+            << QList<QDoubleVector2D>{ QDoubleVector2D(0, 0), QDoubleVector2D(1, 1),
+                                       QDoubleVector2D(2, 2) }
+            << 0 << 0.0;
+}
+
+void tst_QGeoConvexClipper::intersect()
+{
+    QFETCH(QList<QDoubleVector2D>, subject);
+    QFETCH(QList<QDoubleVector2D>, clip);
+    QFETCH(int, vertices);
+    QFETCH(double, area);
+
+    const QVector<QDoubleVector2D> s = subject.toVector();
+    const QVector<QDoubleVector2D> c = clip.toVector();
+    QGeoConvexClipper::Polygon result;
+    result.append(QDoubleVector2D(42, 42)); // Replaced
+    QGeoConvexClipper::intersect(s.constData(), s.size(), c.constData(), c.size(), &result);
+
+    QCOMPARE(result.size(), vertices);
+    QVERIFY(qAbs(::area(result) - area) < 1e-12);
+    for (const QDoubleVector2D &v : result) {
+        QVERIFY(QGeoConvexClipper::contains(s.constData(), s.size(), v));
+        QVERIFY(QGeoConvexClipper::contains(c.constData(), c.size(), v));
+    }
+}
+
+void tst_QGeoConvexClipper::contains()
+{
+    const QList<QDoubleVector2D> triangle = { QDoubleVector2D(0, 0), QDoubleVector2D(0, 2),
+                                              QDoubleVector2D(2, 0) };
+    const QVector<QDoubleVector2D> t = triangle.toVector();
+
+    QVERIFY(QGeoConvexClipper::contains(t.constData(), t.size(), QDoubleVector2D(0.5, 0.5)));
+    QVERIFY(QGeoConvexClipper::contains(t.constData(), t.size(), QDoubleVector2D(1, 1)));
+    QVERIFY(QGeoConvexClipper::contains(t.constData(), t.size(), QDoubleVector2D(0, 0)));
+    QVERIFY(!QGeoConvexClipper::contains(t.constData(), t.size(), QDoubleVector2D(1.5, 1.5)));
+    QVERIFY(!QGeoConvexClipper::contains(t.constData(), t.size(), QDoubleVector2D(-0.1, 0.5)));
+
+    QVERIFY(QGeoConvexClipper::contains(triangle, { QDoubleVector2D(0.1, 0.1), QDoubleVector2D(1, 0.5) }));
+    QVERIFY(!QGeoConvexClipper::contains(triangle, { QDoubleVector2D(0.1, 0.1), QDoubleVector2D(3, 0.5) }));
+    QVERIFY(!QGeoConvexClipper::contains(QList<QDoubleVector2D>(), { QDoubleVector2D(0, 0) }));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoConvexClipper)
+
+#include "tst_qgeoconvexclipper.moc"
@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/private/qgeocoordinatearray_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoCoordinateArray : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructor();
+    void listConstructor();
+    void modifiers();
+    void comparison_data();
+    void comparison();
+    void indexOf();
+    void mid();
+    void implicitSharing();
+};
+
+void tst_QGeoCoordinateArray::defaultConstructor()
+{
+    QGeoCoordinateArray a;
+    QVERIFY(a.isEmpty());
+    QCOMPARE(a.size(), 0);
+    QVERIFY(a.toList().isEmpty());
+}
+
+void tst_QGeoCoordinateArray::listConstructor()
+{
+    QGeoCoordinate partial;
+    partial.setLatitude(10.0);
+
+    QList<QGeoCoordinate> list;
+    list << QGeoCoordinate(1.0, 2.0)
+         << QGeoCoordinate(-45.5, 170.25, 100.0)
+         << QGeoCoordinate()
+         << partial;
+
+    QGeoCoordinateArray a(list);
+    QCOMPARE(a.size(), list.size());
+    QCOMPARE(a.latitude(1), -45.5);
+    QCOMPARE(a.longitude(1), 170.25);
+    QCOMPARE(a.altitude(1), 100.0);
+    QVERIFY(qIsNaN(a.altitude(0)));
+
+    // Values are kept as they are, invalid ones included
+    const QList<QGeoCoordinate> back = a.toList();
+    QCOMPARE(back, list);
+    QVERIFY(!back.at(2).isValid());
+    QCOMPARE(back.at(3).latitude(), 10.0);
+    QVERIFY(qIsNaN(back.at(3).longitude()));
+}
+
+void tst_QGeoCoordinateArray::modifiers()
+{
+    QGeoCoordinateArray a;
+    a.reserve(4);
+    a.append(1.0, 1.0);
+    a.append(QGeoCoordinate(3.0, 3.0));
+    a.insert(1, QGeoCoordinate(2.0, 2.0));
+    QCOMPARE(a.size(), 3);
+    QCOMPARE(a.at(1), QGeoCoordinate(2.0, 2.0));
+
+    a.replace(0, QGeoCoordinate(0.0, 0.0, 5.0));
+    QCOMPARE(a.at(0), QGeoCoordinate(0.0, 0.0, 5.0));
+    QCOMPARE(a.point(0).altitude, 5.0);
+
+    QGeoCoordinateArray b;
+    b.append(4.0, 4.0);
+    a.append(b);
+    QCOMPARE(a.size(), 4);
+    QCOMPARE(a.at(3), QGeoCoordinate(4.0, 4.0));
+
+    a.remove(1, 2);
+    QCOMPARE(a.size(), 2);
+    QCOMPARE(a.at(1), QGeoCoordinate(4.0, 4.0));
+
+    a.data()[0].latitude = -1.0;
+    QCOMPARE(a.constData()[0].latitude, -1.0);
+
+    a.clear();
+    QVERIFY(a.isEmpty());
+}
+
+void tst_QGeoCoordinateArray::comparison_data()
+{
+    QTest::addColumn<QGeoCoordinate>("first");
+    QTest::addColumn<QGeoCoordinate>("second");
+
+    QTest::newRow("equal") << QGeoCoordinate(1.0, 2.0) << QGeoCoordinate(1.0, 2.0);
+    QTest::newRow("different") << QGeoCoordinate(1.0, 2.0) << QGeoCoordinate(1.0, 2.5);
+    QTest::newRow("altitude") << QGeoCoordinate(1.0, 2.0, 3.0) << QGeoCoordinate(1.0, 2.0);
+    QTest::newRow("pole") << QGeoCoordinate(90.0, 10.0) << QGeoCoordinate(90.0, -20.0);
+    QTest::newRow("invalid") << QGeoCoordinate() << QGeoCoordinate();
+    QTest::newRow("fuzzy") << QGeoCoordinate(1.0, 2.0) << QGeoCoordinate(1.0 + 1e-15, 2.0);
+}
+
+void tst_QGeoCoordinateArray::comparison()
+{
+    QFETCH(QGeoCoordinate, first);
+    QFETCH(QGeoCoordinate, second);
+
+    // Same rules as QGeoCoordinate
+    QGeoCoordinateArray a;
+    a.append(first);
+    QGeoCoordinateArray b;
+    b.append(second);
+    QCOMPARE(a == b, first == second);
+    QCOMPARE(a != b, first != second);
+
+    b.append(second);
+    QVERIFY(a != b);
+}
+
+void tst_QGeoCoordinateArray::indexOf()
+{
+    QGeoCoordinateArray a;
+    a.append(1.0, 1.0);
+    a.append(2.0, 2.0);
+    a.append(1.0, 1.0);
+
+    QCOMPARE(a.indexOf(QGeoCoordinate(1.0, 1.0)), 0);
+    QCOMPARE(a.indexOf(QGeoCoordinate(1.0, 1.0), 1), 2);
+    QCOMPARE(a.indexOf(QGeoCoordinate(3.0, 3.0)), -1);
+    QCOMPARE(a.lastIndexOf(QGeoCoordinate(1.0, 1.0)), 2);
+    QCOMPARE(a.lastIndexOf(QGeoCoordinate(1.0, 1.0), 1), 0);
+    QCOMPARE(a.lastIndexOf(QGeoCoordinate(2.0, 2.0), -2), 1);
+    QCOMPARE(a.lastIndexOf(QGeoCoordinate(3.0, 3.0)), -1);
+}
+
+void tst_QGeoCoordinateArray::mid()
+{
+    QGeoCoordinateArray a;
+    for (int i = 0; i < 5; ++i)
+        a.append(i, i);
+
+    const QGeoCoordinateArray tail = a.mid(3);
+    QCOMPARE(tail.size(), 2);
+    QCOMPARE(tail.at(0), QGeoCoordinate(3.0, 3.0));
+
+    const QGeoCoordinateArray middle = a.mid(1, 2);
+    QCOMPARE(middle.size(), 2);
+    QCOMPARE(middle.at(1), QGeoCoordinate(2.0, 2.0));
+}
+
+void tst_QGeoCoordinateArray::implicitSharing()
+{
+    QGeoCoordinateArray a;
+    a.append(1.0, 1.0);
+
+    QGeoCoordinateArray b(a);
+    QCOMPARE(b.constData(), a.constData());
+
+    b.data()[0].longitude = 5.0;
+    QCOMPARE(a.longitude(0), 1.0);
+    QCOMPARE(b.longitude(0), 5.0);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoCoordinateArray)
+
+#include "tst_qgeocoordinatearray.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeocoordinatebatch
+
+SOURCES += tst_qgeocoordinatebatch.cpp
+
+QT += core-private positioning-private testlib
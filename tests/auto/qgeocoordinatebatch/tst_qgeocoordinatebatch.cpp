@@ -0,0 +1,243 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/private/qsimd_p.h>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/private/qgeocoordinatebatch_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+
+QT_USE_NAMESPACE
+
+// Tolerances documented in qgeocoordinatebatch_p.h
+static const double relativeDistanceTolerance = 1e-12;
+static const double coordinateTolerance = 1e-10;
+
+class tst_QGeoCoordinateBatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void vectorized();
+    void distances_data();
+    void distances();
+    void cumulativeDistances();
+    void mercator_data();
+    void mercator();
+    void atDistanceAndAzimuth_data();
+    void atDistanceAndAzimuth();
+    void positionIndependent();
+
+private:
+    QVector<double> m_latitudes;
+    QVector<double> m_longitudes;
+};
+
+void tst_QGeoCoordinateBatch::initTestCase()
+{
+    // A mix of short hops, long jumps, poles and dateline crossings
+    quint32 state = 7;
+    auto random = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / double(1 << 24);
+    };
+    for (int i = 0; i < 1001; ++i) {
+        if (i % 3) {
+            m_latitudes << qBound(-90.0, m_latitudes.last() + (random() - 0.5) * 0.01, 90.0);
+            m_longitudes << QLocationUtils::wrapLong(m_longitudes.last() + (random() - 0.5) * 0.01);
+        } else {
+            m_latitudes << random() * 180.0 - 90.0;
+            m_longitudes << random() * 360.0 - 180.0;
+        }
+    }
+    m_latitudes << 90.0 << -90.0 << 0.0 << 0.0;
+    m_longitudes << 0.0 << 0.0 << 179.999 << -179.999;
+}
+
+// The comparisons below only cover the AVX2 kernels where they are used
+void tst_QGeoCoordinateBatch::vectorized()
+{
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+    if (!qCpuHasFeature(AVX2))
+        QSKIP("The CPU does not support AVX2, the scalar functions are tested");
+    QVERIFY(QGeoCoordinateBatch::isVectorized());
+#else
+    QVERIFY(!QGeoCoordinateBatch::isVectorized());
+    QSKIP("Built without AVX2 support, the scalar functions are tested");
+#endif
+}
+
+void tst_QGeoCoordinateBatch::distances_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("single") << 1;
+    QTest::newRow("one segment") << 2;
+    QTest::newRow("partial block") << 7;
+    QTest::newRow("all") << m_latitudes.size();
+}
+
+void tst_QGeoCoordinateBatch::distances()
+{
+    QFETCH(int, count);
+
+    QVector<double> result(qMax(count - 1, 1), -1.0);
+    QGeoCoordinateBatch::distances(m_latitudes.constData(), m_longitudes.constData(), count,
+                                   result.data());
+    if (count < 2) {
+        QCOMPARE(result.first(), -1.0);
+        return;
+    }
+
+    for (int i = 0; i < count - 1; ++i) {
+        const QGeoCoordinate from(m_latitudes.at(i), m_longitudes.at(i));
+        const QGeoCoordinate to(m_latitudes.at(i + 1), m_longitudes.at(i + 1));
+        const double expected = from.distanceTo(to);
+        QVERIFY2(qAbs(result.at(i) - expected) <= expected * relativeDistanceTolerance + 1e-9,
+                 qPrintable(QString::number(i)));
+    }
+}
+
+void tst_QGeoCoordinateBatch::cumulativeDistances()
+{
+    const int count = m_latitudes.size();
+    QVector<double> distances(count - 1);
+    QVector<double> cumulative(count);
+    QGeoCoordinateBatch::distances(m_latitudes.constData(), m_longitudes.constData(), count,
+                                   distances.data());
+    QGeoCoordinateBatch::cumulativeDistances(m_latitudes.constData(), m_longitudes.constData(),
+                                             count, cumulative.data());
+
+    QCOMPARE(cumulative.first(), 0.0);
+    double sum = 0.0;
+    for (int i = 1; i < count; ++i) {
+        sum += distances.at(i - 1);
+        QCOMPARE(cumulative.at(i), sum);
+    }
+}
+
+void tst_QGeoCoordinateBatch::mercator_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("single") << 1;
+    QTest::newRow("partial block") << 6;
+    QTest::newRow("all") << m_latitudes.size();
+}
+
+void tst_QGeoCoordinateBatch::mercator()
+{
+    QFETCH(int, count);
+
+    QVector<double> x(count);
+    QVector<double> y(count);
+    QGeoCoordinateBatch::toMercator(m_latitudes.constData(), m_longitudes.constData(), count,
+                                    x.data(), y.data());
+
+    QVector<double> latitudes(count);
+    QVector<double> longitudes(count);
+    QGeoCoordinateBatch::fromMercator(x.constData(), y.constData(), count,
+                                      latitudes.data(), longitudes.data());
+
+    for (int i = 0; i < count; ++i) {
+        const QGeoCoordinate coordinate(m_latitudes.at(i), m_longitudes.at(i));
+        const QDoubleVector2D expected = QWebMercator::coordToMercator(coordinate);
+        QCOMPARE(x.at(i), expected.x());
+        QVERIFY2(qAbs(y.at(i) - expected.y()) <= coordinateTolerance, qPrintable(QString::number(i)));
+
+        const QGeoCoordinate back = QWebMercator::mercatorToCoord(QDoubleVector2D(x.at(i), y.at(i)));
+        QVERIFY2(qAbs(latitudes.at(i) - back.latitude()) <= coordinateTolerance,
+                 qPrintable(QString::number(i)));
+        QVERIFY2(qAbs(longitudes.at(i) - back.longitude()) <= coordinateTolerance,
+                 qPrintable(QString::number(i)));
+    }
+}
+
+void tst_QGeoCoordinateBatch::atDistanceAndAzimuth_data()
+{
+    QTest::addColumn<QGeoCoordinate>("origin");
+    QTest::addColumn<double>("distance");
+
+    QTest::newRow("equator, 1 m") << QGeoCoordinate(0.0, 10.0) << 1.0;
+    QTest::newRow("mid latitude, 5 km") << QGeoCoordinate(45.0, 7.0) << 5000.0;
+    QTest::newRow("dateline, 500 km") << QGeoCoordinate(-20.0, 179.5) << 500000.0;
+    QTest::newRow("near pole, 100 km") << QGeoCoordinate(89.0, -45.0) << 100000.0;
+    QTest::newRow("half the earth") << QGeoCoordinate(10.0, 20.0) << 19000000.0;
+}
+
+void tst_QGeoCoordinateBatch::atDistanceAndAzimuth()
+{
+    QFETCH(QGeoCoordinate, origin);
+    QFETCH(double, distance);
+
+    QVector<double> azimuths;
+    for (int i = 0; i < 129; ++i)
+        azimuths << i * 360.0 / 128 - 90.0;
+
+    QVector<double> latitudes(azimuths.size());
+    QVector<double> longitudes(azimuths.size());
+    QGeoCoordinateBatch::atDistanceAndAzimuth(origin.latitude(), origin.longitude(), distance,
+                                              azimuths.constData(), azimuths.size(),
+                                              latitudes.data(), longitudes.data());
+
+    for (int i = 0; i < azimuths.size(); ++i) {
+        const QGeoCoordinate expected = origin.atDistanceAndAzimuth(distance, azimuths.at(i));
+        QVERIFY2(qAbs(latitudes.at(i) - expected.latitude()) <= coordinateTolerance,
+                 qPrintable(QString::number(i)));
+        const double longitude = QLocationUtils::wrapLong(longitudes.at(i));
+        double difference = qAbs(longitude - expected.longitude());
+        difference = qMin(difference, 360.0 - difference);
+        QVERIFY2(difference <= coordinateTolerance, qPrintable(QString::number(i)));
+    }
+}
+
+void tst_QGeoCoordinateBatch::positionIndependent()
+{
+    // The same point gives the same result wherever it is in the batch
+    const int count = m_latitudes.size();
+    QVector<double> all(count - 1);
+    QGeoCoordinateBatch::distances(m_latitudes.constData(), m_longitudes.constData(), count,
+                                   all.data());
+
+    for (int offset = 1; offset < 8; ++offset) {
+        QVector<double> shifted(count - 1 - offset);
+        QGeoCoordinateBatch::distances(m_latitudes.constData() + offset,
+                                       m_longitudes.constData() + offset,
+                                       count - offset, shifted.data());
+        for (int i = 0; i < shifted.size(); ++i)
+            QCOMPARE(shifted.at(i), all.at(i + offset));
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoCoordinateBatch)
+
+#include "tst_qgeocoordinatebatch.moc"
@@ -0,0 +1,323 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QBuffer>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+
+#include "qgeofiletilecache_p.h"
+#include "qgeotilespec_p.h"
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoFileTileCache::DiskStorage)
+Q_DECLARE_METATYPE(QAbstractGeoTileCache::CacheArea)
+
+class TestTileCache : public QGeoFileTileCache
+{
+public:
+    TestTileCache(const QString &directory) : QGeoFileTileCache(directory) {}
+
+    using QGeoFileTileCache::init;
+
+    int journalLength() const { return journal_ ? journal_->length() : 0; }
+
+    // Offline tiles, located by a wildcard as in the OSM plugin
+    QString offlineDirectory;
+
+protected:
+    bool locateTile(const QGeoTileSpec &spec, QString *fileName, qint64 *offset, int *length) override
+    {
+        Q_UNUSED(offset);
+        Q_UNUSED(length);
+        if (offlineDirectory.isEmpty())
+            return false;
+        *fileName = offlineDirectory + QStringLiteral("/offline-%1-%2-%3.*")
+                .arg(spec.zoom()).arg(spec.x()).arg(spec.y());
+        return true;
+    }
+};
+
+class tst_QGeoFileTileCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoTileSpec tile(int x)
+    {
+        return QGeoTileSpec(QStringLiteral("test"), 1, 12, x, 0);
+    }
+    static QByteArray png(int x)
+    {
+        QImage image(256, 256, QImage::Format_ARGB32_Premultiplied);
+        image.fill(QColor::fromHsv((x * 37) % 360, 255, 255));
+        QByteArray bytes;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        return bytes;
+    }
+    void prepare(TestTileCache *cache, QGeoFileTileCache::DiskStorage storage = QGeoFileTileCache::TileFiles)
+    {
+        cache->setDiskStorage(storage);
+        cache->setMaxMemoryUsage(64 * 1024 * 1024);
+        cache->setExtraTextureUsage(64 * 1024 * 1024);
+        cache->setAsyncDecoding(true);
+        cache->init();
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void synchronousByDefault();
+    void decode_data();
+    void decode();
+    void notCached();
+    void decodingFailed();
+    void offline();
+    void cancel();
+    void boundedQueue();
+    void journalHits();
+};
+
+void tst_QGeoFileTileCache::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    qRegisterMetaType<QGeoTileSpec>();
+}
+
+void tst_QGeoFileTileCache::synchronousByDefault()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TestTileCache cache(dir.path());
+    QVERIFY(!cache.asyncDecoding());
+    cache.init();
+    cache.insert(tile(0), png(0), QStringLiteral("png"));
+
+    bool pending = true;
+    QSharedPointer<QGeoTileTexture> tt = cache.requestTexture(tile(0), &pending);
+    QVERIFY(tt);
+    QVERIFY(!pending);
+    QCOMPARE(tt->image.size(), QSize(256, 256));
+}
+
+void tst_QGeoFileTileCache::decode_data()
+{
+    QTest::addColumn<QGeoFileTileCache::DiskStorage>("storage");
+    QTest::addColumn<QAbstractGeoTileCache::CacheArea>("area");
+
+    QTest::newRow("memory") << QGeoFileTileCache::TileFiles << QAbstractGeoTileCache::MemoryCache;
+    QTest::newRow("tile files") << QGeoFileTileCache::TileFiles << QAbstractGeoTileCache::DiskCache;
+    QTest::newRow("segment files") << QGeoFileTileCache::SegmentFiles << QAbstractGeoTileCache::DiskCache;
+}
+
+// Decoded in the background, then served from the texture cache
+void tst_QGeoFileTileCache::decode()
+{
+    QFETCH(QGeoFileTileCache::DiskStorage, storage);
+    QFETCH(QAbstractGeoTileCache::CacheArea, area);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TestTileCache cache(dir.path());
+    prepare(&cache, storage);
+    cache.insert(tile(0), png(0), QStringLiteral("png"), area);
+    QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+
+    bool pending = false;
+    QVERIFY(!cache.requestTexture(tile(0), &pending));
+    QVERIFY(pending);
+
+    // Requested again while decoding
+    pending = false;
+    QVERIFY(!cache.requestTexture(tile(0), &pending));
+    QVERIFY(pending);
+
+    QTRY_COMPARE(decoded.count(), 1);
+    QCOMPARE(decoded.first().first().value<QGeoTileSpec>(), tile(0));
+
+    QSharedPointer<QGeoTileTexture> tt = cache.requestTexture(tile(0), &pending);
+    QVERIFY(tt);
+    QVERIFY(!pending);
+    QCOMPARE(tt->image.size(), QSize(256, 256));
+    QCOMPARE(tt->image.pixel(128, 128), QColor::fromHsv(0, 255, 255).rgb());
+}
+
+// Neither decoded nor pending, so that the tile gets fetched
+void tst_QGeoFileTileCache::notCached()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TestTileCache cache(dir.path());
+    prepare(&cache);
+
+    bool pending = true;
+    QVERIFY(!cache.requestTexture(tile(0), &pending));
+    QVERIFY(!pending);
+}
+
+void tst_QGeoFileTileCache::decodingFailed()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TestTileCache cache(dir.path());
+    prepare(&cache);
+    cache.insert(tile(0), QByteArray(1000, 'x'), QStringLiteral("png"));
+    QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+    QSignalSpy failed(&cache, &QAbstractGeoTileCache::tileDecodingFailed);
+
+    bool pending = false;
+    QVERIFY(!cache.requestTexture(tile(0), &pending));
+    QVERIFY(pending);
+    QTRY_COMPARE(failed.count(), 1);
+    QCOMPARE(failed.first().first().value<QGeoTileSpec>(), tile(0));
+    QCOMPARE(decoded.count(), 0);
+}
+
+// Tiles beyond the caches are looked up in the decode threads
+void tst_QGeoFileTileCache::offline()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QTemporaryDir offlineDir;
+    QVERIFY(offlineDir.isValid());
+    QFile file(offlineDir.path() + QStringLiteral("/offline-12-1-0.png"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(png(1));
+    file.close();
+
+    TestTileCache cache(dir.path());
+    cache.offlineDirectory = offlineDir.path();
+    prepare(&cache);
+    QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+    QSignalSpy failed(&cache, &QAbstractGeoTileCache::tileDecodingFailed);
+
+    bool pending = false;
+    QVERIFY(!cache.requestTexture(tile(1), &pending));
+    QVERIFY(pending);
+    QVERIFY(!cache.requestTexture(tile(2), &pending));
+    QVERIFY(pending);
+
+    QTRY_COMPARE(decoded.count() + failed.count(), 2);
+    QCOMPARE(decoded.count(), 1);
+    QCOMPARE(decoded.first().first().value<QGeoTileSpec>(), tile(1));
+    QCOMPARE(failed.first().first().value<QGeoTileSpec>(), tile(2));
+    QVERIFY(cache.requestTexture(tile(1), &pending));
+}
+
+// Cancelled decodes are neither reported nor cached
+void tst_QGeoFileTileCache::cancel()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TestTileCache cache(dir.path());
+    prepare(&cache);
+    cache.setMaxPendingDecodes(1);
+    QSet<QGeoTileSpec> canceled;
+    for (int x = 0; x < 8; ++x) {
+        cache.insert(tile(x), png(x), QStringLiteral("png"));
+        if (x > 0)
+            canceled.insert(tile(x));
+    }
+    QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+
+    bool pending = false;
+    for (int x = 0; x < 8; ++x) {
+        QVERIFY(!cache.requestTexture(tile(x), &pending));
+        QVERIFY(pending);
+    }
+
+    // As when the tiles leave the view: only the first one is decoding yet
+    cache.cancelDecoding(canceled);
+    QTRY_COMPARE(decoded.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(decoded.count(), 1);
+    QCOMPARE(decoded.first().first().value<QGeoTileSpec>(), tile(0));
+    for (const QGeoTileSpec &spec : qAsConst(canceled))
+        QVERIFY(!cache.requestTexture(spec));
+
+    // Requested again when they come back
+    QVERIFY(!cache.requestTexture(tile(1), &pending));
+    QVERIFY(pending);
+    QTRY_COMPARE(decoded.count(), 2);
+    QCOMPARE(decoded.last().first().value<QGeoTileSpec>(), tile(1));
+}
+
+// Past the limit, tiles wait for a decode thread instead of being decoded
+// right away on the calling thread
+void tst_QGeoFileTileCache::boundedQueue()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TestTileCache cache(dir.path());
+    prepare(&cache);
+    cache.setMaxPendingDecodes(2);
+    QCOMPARE(cache.maxPendingDecodes(), 2);
+    for (int x = 0; x < 16; ++x)
+        cache.insert(tile(x), png(x), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    QSignalSpy decoded(&cache, &QAbstractGeoTileCache::tileDecoded);
+
+    bool pending = false;
+    for (int x = 0; x < 16; ++x) {
+        QVERIFY(!cache.requestTexture(tile(x), &pending));
+        QVERIFY(pending);
+    }
+
+    QTRY_COMPARE(decoded.count(), 16);
+    QSet<QGeoTileSpec> tiles;
+    for (const QList<QVariant> &arguments : qAsConst(decoded))
+        tiles.insert(arguments.first().value<QGeoTileSpec>());
+    QCOMPARE(tiles.size(), 16);
+    for (int x = 0; x < 16; ++x)
+        QVERIFY(cache.requestTexture(tile(x)));
+}
+
+// Only lookups that find the tile on disk are journaled
+void tst_QGeoFileTileCache::journalHits()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    TestTileCache cache(dir.path());
+    cache.init();
+    cache.insert(tile(0), png(0), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    const int length = cache.journalLength();
+    QVERIFY(length > 0);
+
+    for (int x = 1; x < 100; ++x)
+        QVERIFY(!cache.get(tile(x)));
+    QCOMPARE(cache.journalLength(), length);
+
+    QVERIFY(cache.get(tile(0)));
+    QCOMPARE(cache.journalLength(), length + 1);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoFileTileCache)
+
+#include "tst_qgeofiletilecache.moc"
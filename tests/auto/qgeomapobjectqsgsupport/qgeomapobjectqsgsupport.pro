@@ -0,0 +1,8 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomapobjectqsgsupport
+INCLUDEPATH += ../geotestplugin
+
+SOURCES += tst_qgeomapobjectqsgsupport.cpp
+
+QT += location-private positioning-private quick testlib
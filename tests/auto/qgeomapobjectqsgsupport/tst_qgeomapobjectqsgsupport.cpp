@@ -0,0 +1,425 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotiledmap_test.h"
+#include "qgeotiledmappingmanagerengine_test.h"
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+#include <QtQuick/QSGNode>
+#include <QtQuick/QSGFlatColorMaterial>
+#include <QtGui/QImage>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeomapobjectqsgsupport_p.h>
+#include <QtLocation/private/qmapcircleobject_p.h>
+#include <QtLocation/private/qmapiconobject_p.h>
+
+QT_USE_NAMESPACE
+
+// Top left corner of each quad drawn by an icon page node
+static QVector<QPointF> iconQuads(QSGNode *pageNode)
+{
+    QVector<QPointF> quads;
+    const QSGGeometry *geometry = static_cast<QSGGeometryNode *>(pageNode)->geometry();
+    const QSGGeometry::TexturedPoint2D *vertices = geometry->vertexDataAsTexturedPoint2D();
+    for (int i = 0; i < geometry->vertexCount(); i += 4)
+        quads.append(QPointF(vertices[i].x, vertices[i].y));
+    return quads;
+}
+
+class tst_QGeoMapObjectQSGSupport : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void stackingOrder();
+    void restyle();
+    void restyleBetween();
+    void iconsOnTop();
+    void iconAtlasSharing();
+    void iconPageRelease();
+    void iconDirtyQuads();
+    void iconImageChange();
+
+private:
+    QVector<QRgb> batchColors() const;
+    QMapCircleObject *addCircle(const QColor &color, double offset = 0.0);
+    QString writeIcon(const QString &name, const QColor &color);
+    QMapIconObject *addIcon(const QString &fileName, double offset = 0.0);
+    const MapObject &mapObject(QGeoMapObject *object) const;
+    QPointF iconPosition(QMapIconObject *icon) const;
+    void removeObject(QGeoMapObject *object);
+    void update();
+
+    QScopedPointer<QGeoServiceProvider> m_provider;
+    QScopedPointer<QGeoTiledMapTest> m_map;
+    QScopedPointer<QGeoMapObjectQSGSupport> m_support;
+    QScopedPointer<QSGNode> m_root;
+    QList<QGeoMapObject *> m_objects;
+    QTemporaryDir m_iconDir;
+};
+
+void tst_QGeoMapObjectQSGSupport::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    m_provider.reset(new QGeoServiceProvider("qmlgeo.test.plugin", parameters));
+    m_provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = m_provider->mappingManager();
+    QVERIFY2(m_provider->error() == QGeoServiceProvider::NoError, "Could not load plugin: " + m_provider->errorString().toLatin1());
+    m_map.reset(static_cast<QGeoTiledMapTest*>(mappingManager->createMap(this)));
+    QVERIFY(m_map);
+    m_map->setActiveMapType(m_map->m_engine->supportedMapTypes().first());
+    m_map->setViewportSize(QSize(1280, 720));
+
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(50.0, 9.0));
+    camera.setZoomLevel(12.0);
+    m_map->setCameraData(camera);
+
+    QVERIFY(m_iconDir.isValid());
+}
+
+void tst_QGeoMapObjectQSGSupport::init()
+{
+    m_root.reset(new QSGNode);
+    m_support.reset(new QGeoMapObjectQSGSupport);
+    m_support->m_map = m_map.data();
+}
+
+void tst_QGeoMapObjectQSGSupport::cleanup()
+{
+    for (QGeoMapObject *object : qAsConst(m_objects))
+        m_support->removeMapObject(object);
+    update();
+    qDeleteAll(m_objects);
+    m_objects.clear();
+    m_support.reset();
+    m_root.reset();
+}
+
+// Fill colors of the batch nodes under the root, from bottom to top
+QVector<QRgb> tst_QGeoMapObjectQSGSupport::batchColors() const
+{
+    QVector<QRgb> colors;
+    for (QSGNode *node = m_root->firstChild(); node; node = node->nextSibling()) {
+        if (node == m_support->m_iconRoot || node->type() != QSGNode::BasicNodeType || !node->firstChild())
+            continue;
+        QSGGeometryNode *fill = static_cast<QSGGeometryNode *>(node->firstChild());
+        colors.append(static_cast<QSGFlatColorMaterial *>(fill->material())->color().rgba());
+    }
+    return colors;
+}
+
+// A circle in view, offset in degrees of longitude from the map center
+QMapCircleObject *tst_QGeoMapObjectQSGSupport::addCircle(const QColor &color, double offset)
+{
+    QMapCircleObject *circle = new QMapCircleObject;
+    circle->setCenter(QGeoCoordinate(50.0, 9.0 + offset));
+    circle->setRadius(200.0);
+    circle->setColor(color);
+
+    QGeoMapObjectPrivate *pimpl = m_support->createMapObjectImplementationPrivate(circle);
+    circle->setImplementation(QExplicitlySharedDataPointer<QGeoMapObjectPrivate>(pimpl));
+    pimpl->setMap(m_map.data());
+    m_objects.append(circle);
+    return circle;
+}
+
+// A 16x16 image of the given color, in the temporary directory
+QString tst_QGeoMapObjectQSGSupport::writeIcon(const QString &name, const QColor &color)
+{
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(color);
+    const QString fileName = m_iconDir.filePath(name + QStringLiteral(".png"));
+    image.save(fileName);
+    return fileName;
+}
+
+// An icon in view, offset in degrees of longitude from the map center
+QMapIconObject *tst_QGeoMapObjectQSGSupport::addIcon(const QString &fileName, double offset)
+{
+    QMapIconObject *icon = new QMapIconObject;
+    icon->setCoordinate(QGeoCoordinate(50.0, 9.0 + offset));
+    icon->setSize(QSizeF(16, 16));
+    icon->setContent(fileName);
+
+    QGeoMapObjectPrivate *pimpl = m_support->createMapObjectImplementationPrivate(icon);
+    icon->setImplementation(QExplicitlySharedDataPointer<QGeoMapObjectPrivate>(pimpl));
+    pimpl->setMap(m_map.data());
+    m_objects.append(icon);
+    return icon;
+}
+
+const MapObject &tst_QGeoMapObjectQSGSupport::mapObject(QGeoMapObject *object) const
+{
+    return m_support->m_mapObjects.at(m_support->m_slots.value(object));
+}
+
+// Where the top left corner of the icon is drawn, in vertex precision
+QPointF tst_QGeoMapObjectQSGSupport::iconPosition(QMapIconObject *icon) const
+{
+    const QDoubleVector2D position = m_map->geoProjection().coordinateToItemPosition(icon->coordinate(), false);
+    return QPointF(float(position.x()), float(position.y()));
+}
+
+void tst_QGeoMapObjectQSGSupport::removeObject(QGeoMapObject *object)
+{
+    m_support->removeMapObject(object);
+    m_objects.removeOne(object);
+    delete object;
+}
+
+// As the labs map does on every frame
+void tst_QGeoMapObjectQSGSupport::update()
+{
+    m_support->updateObjectsGeometry();
+    m_support->updateMapObjects(m_root.data(), nullptr);
+}
+
+// Objects are stacked in the order they were added, runs of objects of the
+// same style share a batch
+void tst_QGeoMapObjectQSGSupport::stackingOrder()
+{
+    const QRgb red = QColor(Qt::red).rgba();
+    const QRgb blue = QColor(Qt::blue).rgba();
+    addCircle(Qt::blue);
+    QMapCircleObject *between = addCircle(Qt::red, 0.001);
+    addCircle(Qt::blue, 0.002);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue << red << blue);
+
+    // Joins the run below it
+    QMapCircleObject *last = addCircle(Qt::blue, 0.003);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue << red << blue);
+
+    // Stable over updates
+    m_map->setCameraData(m_map->cameraData());
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue << red << blue);
+
+    // The runs separated by the removed object are drawn together
+    removeObject(between);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue);
+
+    // A style used again goes on top
+    addCircle(Qt::red, 0.004);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue << red);
+    removeObject(last);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue << red);
+}
+
+// An object whose colors change moves to a batch of its new style, in place
+void tst_QGeoMapObjectQSGSupport::restyle()
+{
+    QMapCircleObject *first = addCircle(Qt::red);
+    addCircle(Qt::blue, 0.001);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << QColor(Qt::red).rgba() << QColor(Qt::blue).rgba());
+
+    first->setColor(Qt::blue);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << QColor(Qt::blue).rgba());
+
+    first->setColor(Qt::green);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << QColor(Qt::green).rgba() << QColor(Qt::blue).rgba());
+}
+
+// Restyling an object in the middle of a run splits the batch around it
+void tst_QGeoMapObjectQSGSupport::restyleBetween()
+{
+    const QRgb blue = QColor(Qt::blue).rgba();
+    addCircle(Qt::blue);
+    QMapCircleObject *between = addCircle(Qt::blue, 0.001);
+    addCircle(Qt::blue, 0.002);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue);
+
+    between->setColor(Qt::green);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue << QColor(Qt::green).rgba() << blue);
+
+    between->setColor(Qt::blue);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << blue);
+}
+
+// Icons are drawn above the batches, also of styles first used after them
+void tst_QGeoMapObjectQSGSupport::iconsOnTop()
+{
+    addCircle(Qt::red);
+    addIcon(writeIcon(QStringLiteral("red"), Qt::red), 0.001);
+    update();
+    QVERIFY(m_support->m_iconRoot);
+    QCOMPARE(m_root->lastChild(), m_support->m_iconRoot);
+    QCOMPARE(m_support->m_iconRoot->childCount(), 1);
+
+    addCircle(Qt::blue, 0.002);
+    update();
+    QCOMPARE(batchColors(), QVector<QRgb>() << QColor(Qt::red).rgba() << QColor(Qt::blue).rgba());
+    QCOMPARE(m_root->lastChild(), m_support->m_iconRoot);
+}
+
+// Icons of the same image share its place in the atlas, and are drawn together
+void tst_QGeoMapObjectQSGSupport::iconAtlasSharing()
+{
+    const QString red = writeIcon(QStringLiteral("red"), Qt::red);
+    QMapIconObject *first = addIcon(red);
+    QMapIconObject *second = addIcon(red, 0.001);
+    QMapIconObject *other = addIcon(writeIcon(QStringLiteral("blue"), Qt::blue), 0.002);
+    update();
+
+    QCOMPARE(m_support->m_iconPages.size(), 1);
+    QCOMPARE(m_support->m_iconAtlas.size(), 2);
+    const QString key = mapObject(first).iconKey;
+    QCOMPARE(mapObject(second).iconKey, key);
+    QCOMPARE(m_support->m_iconAtlas.value(key).references, 2);
+    QCOMPARE(m_support->m_iconAtlas.value(mapObject(other).iconKey).references, 1);
+    QCOMPARE(mapObject(second).iconTextureRect, mapObject(first).iconTextureRect);
+    QVERIFY(mapObject(other).iconTextureRect != mapObject(first).iconTextureRect);
+    QVERIFY(!mapObject(first).iconTextureRect.intersects(mapObject(other).iconTextureRect));
+
+    QCOMPARE(m_support->m_iconRoot->childCount(), 1);
+    const QVector<QPointF> quads = iconQuads(m_support->m_iconRoot->firstChild());
+    QCOMPARE(quads.at(mapObject(first).iconPosition), iconPosition(first));
+    QCOMPARE(quads.at(mapObject(second).iconPosition), iconPosition(second));
+    QCOMPARE(quads.at(mapObject(other).iconPosition), iconPosition(other));
+}
+
+// Pages and their atlas entries go away with the last icon using them
+void tst_QGeoMapObjectQSGSupport::iconPageRelease()
+{
+    const QString red = writeIcon(QStringLiteral("red"), Qt::red);
+    QMapIconObject *first = addIcon(red);
+    QMapIconObject *second = addIcon(red, 0.001);
+    update();
+    QCOMPARE(m_support->m_iconPages.size(), 1);
+
+    removeObject(first);
+    update();
+    QCOMPARE(m_support->m_iconPages.size(), 1);
+    QCOMPARE(m_support->m_iconAtlas.value(mapObject(second).iconKey).references, 1);
+
+    removeObject(second);
+    update();
+    QVERIFY(m_support->m_iconPages.isEmpty());
+    QVERIFY(m_support->m_iconAtlas.isEmpty());
+    QVERIFY(!m_support->m_iconRoot);
+    QCOMPARE(m_root->childCount(), 0);
+}
+
+// Only the quads of the icons that moved, appeared or disappeared are rewritten
+void tst_QGeoMapObjectQSGSupport::iconDirtyQuads()
+{
+    const QString red = writeIcon(QStringLiteral("red"), Qt::red);
+    QMapIconObject *first = addIcon(red);
+    QMapIconObject *second = addIcon(red, 0.001);
+    update();
+    QSGNode *page = m_support->m_iconRoot->firstChild();
+    QCOMPARE(mapObject(first).iconPosition, 0);
+    QCOMPARE(mapObject(second).iconPosition, 1);
+
+    // Moved
+    first->setCoordinate(QGeoCoordinate(50.001, 9.0));
+    update();
+    QCOMPARE(iconQuads(page).at(0), iconPosition(first));
+    QCOMPARE(iconQuads(page).at(1), iconPosition(second));
+
+    // Hidden, the last icon takes over its quad and the last quad is unused
+    first->setVisible(false);
+    update();
+    QCOMPARE(mapObject(first).iconPosition, -1);
+    QCOMPARE(mapObject(second).iconPosition, 0);
+    QCOMPARE(iconQuads(page).at(0), iconPosition(second));
+    QCOMPARE(iconQuads(page).at(1), QPointF());
+
+    // Shown again, in the next quad
+    first->setVisible(true);
+    update();
+    QCOMPARE(mapObject(first).iconPosition, 1);
+    QCOMPARE(iconQuads(page).at(1), iconPosition(first));
+}
+
+// A new image, or the same file rewritten, gets a new atlas entry
+void tst_QGeoMapObjectQSGSupport::iconImageChange()
+{
+    const QString red = writeIcon(QStringLiteral("red"), Qt::red);
+    const QString blue = writeIcon(QStringLiteral("blue"), Qt::blue);
+    QMapIconObject *icon = addIcon(red);
+    update();
+    const QString redKey = mapObject(icon).iconKey;
+    const QRectF redRect = mapObject(icon).iconTextureRect;
+
+    icon->setContent(blue);
+    update();
+    const QString blueKey = mapObject(icon).iconKey;
+    QVERIFY(blueKey != redKey);
+    QVERIFY(mapObject(icon).iconTextureRect != redRect);
+    QCOMPARE(m_support->m_iconAtlas.value(redKey).references, 0);
+    QCOMPARE(m_support->m_iconAtlas.value(blueKey).references, 1);
+    QCOMPARE(iconQuads(m_support->m_iconRoot->firstChild()).at(0), iconPosition(icon));
+
+    // Not the decoded image of the old file
+    writeIcon(QStringLiteral("red"), Qt::green);
+    QFile file(red);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+    icon->setContent(red);
+    update();
+    QVERIFY(mapObject(icon).iconKey != redKey);
+    QVERIFY(mapObject(icon).iconTextureRect != redRect);
+    QCOMPARE(m_support->m_iconAtlas.value(mapObject(icon).iconKey).references, 1);
+    QCOMPARE(m_support->m_iconAtlas.value(blueKey).references, 0);
+}
+
+QTEST_MAIN(tst_QGeoMapObjectQSGSupport)
+
+#include "tst_qgeomapobjectqsgsupport.moc"
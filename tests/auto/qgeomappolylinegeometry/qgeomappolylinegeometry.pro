@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomappolylinegeometry
+
+SOURCES += tst_qgeomappolylinegeometry.cpp
+
+QT += location-private positioning-private quick testlib
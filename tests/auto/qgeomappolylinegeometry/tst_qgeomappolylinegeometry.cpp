@@ -0,0 +1,186 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+
+QT_USE_NAMESPACE
+
+typedef QGeoMapPolylineGeometryExtruded::Vertex Vertex;
+
+// The vertices are in single precision
+static bool equal(const QDoubleVector2D &v1, const QDoubleVector2D &v2)
+{
+    return (v1 - v2).length() < 1e-6;
+}
+
+static QDoubleVector2D position(const Vertex &v)
+{
+    return QDoubleVector2D(v.x, v.y);
+}
+
+static QDoubleVector2D other(const Vertex &v)
+{
+    return QDoubleVector2D(v.otherX, v.otherY);
+}
+
+static QDoubleVector2D neighbor(const Vertex &v)
+{
+    return QDoubleVector2D(v.neighborX, v.neighborY);
+}
+
+class tst_QGeoMapPolylineGeometry : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void extrudedVertices();
+    void extrudedUnwrapping();
+    void extrudedDegenerate();
+    void extrudedRebase();
+};
+
+void tst_QGeoMapPolylineGeometry::extrudedVertices()
+{
+    const QDoubleVector2D origin(0.25, 0.5);
+    QList<QDoubleVector2D> path;
+    path << QDoubleVector2D(0.25, 0.5) << QDoubleVector2D(0.26, 0.5)
+         << QDoubleVector2D(0.26, 0.5) // Repeated points are dropped
+         << QDoubleVector2D(0.26, 0.51) << QDoubleVector2D(0.25, 0.52);
+
+    QGeoMapPolylineGeometryExtruded geometry;
+    QVERIFY(geometry.isSourceDirty());
+    geometry.updateSourcePoints(path, origin, origin);
+    QVERIFY(!geometry.isSourceDirty());
+    QVERIFY(geometry.isVertexDataDirty());
+    QCOMPARE(geometry.origin(), origin);
+
+    const QVector<Vertex> &vertices = geometry.vertices();
+    QCOMPARE(vertices.size(), 3 * 6);
+
+    const QDoubleVector2D points[] = { path.at(0) - origin, path.at(1) - origin,
+                                       path.at(3) - origin, path.at(4) - origin };
+    for (int segment = 0; segment < 3; ++segment) {
+        const Vertex *quad = vertices.constData() + segment * 6;
+        const QDoubleVector2D &start = points[segment];
+        const QDoubleVector2D &end = points[segment + 1];
+        const QDoubleVector2D before = segment > 0 ? points[segment - 1] : start;
+        const QDoubleVector2D after = segment < 2 ? points[segment + 2] : end;
+
+        // Two triangles, startLeft startRight endRight and startLeft endRight endLeft
+        for (int i : { 0, 1, 3 }) {
+            QVERIFY(equal(position(quad[i]), start));
+            QVERIFY(equal(other(quad[i]), end));
+            QVERIFY(equal(neighbor(quad[i]), before));
+        }
+        for (int i : { 2, 4, 5 }) {
+            QVERIFY(equal(position(quad[i]), end));
+            QVERIFY(equal(other(quad[i]), start));
+            QVERIFY(equal(neighbor(quad[i]), after));
+        }
+        QCOMPARE(quad[0].side, 1.0f);
+        QCOMPARE(quad[1].side, -1.0f);
+        QCOMPARE(quad[2].side, 1.0f);
+        QCOMPARE(quad[5].side, -1.0f);
+    }
+
+    // Not rebuilt until the source is marked dirty
+    geometry.markClean();
+    geometry.updateSourcePoints(QList<QDoubleVector2D>(), origin, origin);
+    QCOMPARE(geometry.vertices().size(), 3 * 6);
+    QVERIFY(!geometry.isVertexDataDirty());
+}
+
+void tst_QGeoMapPolylineGeometry::extrudedUnwrapping()
+{
+    // Across the antimeridian, with the left bound east of it
+    const QDoubleVector2D origin(0.99, 0.5);
+    QList<QDoubleVector2D> path;
+    path << QDoubleVector2D(0.99, 0.5) << QDoubleVector2D(0.01, 0.5);
+
+    QGeoMapPolylineGeometryExtruded geometry;
+    geometry.updateSourcePoints(path, origin, origin);
+    QCOMPARE(geometry.vertices().size(), 6);
+    const Vertex &end = geometry.vertices().at(2);
+    QVERIFY(qAbs(end.x - 0.02f) < 1e-6f);
+    QVERIFY(qAbs(end.y) < 1e-6f);
+}
+
+void tst_QGeoMapPolylineGeometry::extrudedDegenerate()
+{
+    QGeoMapPolylineGeometryExtruded geometry;
+    QList<QDoubleVector2D> path;
+    path << QDoubleVector2D(0.5, 0.5) << QDoubleVector2D(0.5, 0.5);
+    geometry.updateSourcePoints(path, QDoubleVector2D(0.5, 0.5), QDoubleVector2D(0.5, 0.5));
+    QVERIFY(geometry.vertices().isEmpty());
+
+    geometry.markSourceDirty();
+    path.clear();
+    path << QDoubleVector2D(0.5, 0.5) << QDoubleVector2D(qQNaN(), 0.5) << QDoubleVector2D(0.6, 0.5);
+    geometry.updateSourcePoints(path, QDoubleVector2D(0.5, 0.5), QDoubleVector2D(0.5, 0.5));
+    QCOMPARE(geometry.vertices().size(), 6);
+}
+
+void tst_QGeoMapPolylineGeometry::extrudedRebase()
+{
+    // Two points a fraction of a pixel apart at zoom level 20, far from the
+    // left bound of the path
+    const QDoubleVector2D origin(0.25, 0.5);
+    const QDoubleVector2D center(0.7, 0.5);
+    const QDoubleVector2D step(1e-9, 0.0);
+    QList<QDoubleVector2D> path;
+    path << origin << center << center + step;
+
+    QGeoMapPolylineGeometryExtruded geometry;
+    geometry.updateSourcePoints(path, origin, center);
+    QVERIFY(equal(geometry.base(), center));
+    QCOMPARE(geometry.vertices().size(), 2 * 6);
+
+    // The difference is kept, which it would not be relative to the origin
+    const Vertex &start = geometry.vertices().at(6);
+    const Vertex &end = geometry.vertices().at(8);
+    QVERIFY(qAbs(start.x) < 1e-12f);
+    QVERIFY(qAbs((end.x - start.x) - 1e-9f) < 1e-12f);
+    QVERIFY(float(path.at(2).x() - origin.x()) == float(path.at(1).x() - origin.x()));
+
+    // Not rewritten while the camera stays close to the base
+    geometry.markClean();
+    QVERIFY(!geometry.rebase(center + QDoubleVector2D(0.001, 0.0), 0.01));
+    QVERIFY(!geometry.isVertexDataDirty());
+    QVERIFY(equal(geometry.base(), center));
+
+    QVERIFY(geometry.rebase(origin, 0.01));
+    QVERIFY(geometry.isVertexDataDirty());
+    QVERIFY(equal(geometry.base(), origin));
+    QVERIFY(equal(position(geometry.vertices().at(0)), QDoubleVector2D(0.0, 0.0)));
+    QVERIFY(equal(position(geometry.vertices().at(2)), center - origin));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoMapPolylineGeometry)
+
+#include "tst_qgeomappolylinegeometry.moc"
@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <QtTest/QtTest>
+#include <QtCore/qmath.h>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPath>
@@ -46,6 +47,7 @@ private slots:
     void type();
 
     void path();
+    void pathFollowsChanges();
     void width();
     void size();
 
@@ -57,6 +59,7 @@ private slots:
 
     void contains_data();
     void contains();
+    void containsManySegments();
 
     void boundingGeoRectangle_data();
     void boundingGeoRectangle();
@@ -187,6 +190,40 @@ void tst_QGeoPath::path()
     QVERIFY(p.boundingGeoRectangle().isEmpty());
 }
 
+void tst_QGeoPath::pathFollowsChanges()
+{
+    QList<QGeoCoordinate> coords;
+    coords.append(QGeoCoordinate(1.0, 1.0));
+    coords.append(QGeoCoordinate(2.0, 2.0, 10.0));
+    coords.append(QGeoCoordinate(3.0, 0.0));
+
+    QGeoPath p(coords, 5.0);
+    QCOMPARE(p.size(), 3);
+    QCOMPARE(p.path(), coords);
+    QCOMPARE(p.coordinateAt(1), QGeoCoordinate(2.0, 2.0, 10.0));
+
+    // path() returns a reference, it must be kept in step with the geometry
+    p.addCoordinate(QGeoCoordinate(4.0, 4.0));
+    p.removeCoordinate(0);
+    QCOMPARE(p.path().size(), 3);
+    QCOMPARE(p.path().last(), QGeoCoordinate(4.0, 4.0));
+    p.insertCoordinate(1, QGeoCoordinate(2.5, 1.0));
+    QCOMPARE(p.path().at(1), QGeoCoordinate(2.5, 1.0));
+    p.replaceCoordinate(1, QGeoCoordinate(2.5, 2.0));
+    QCOMPARE(p.path().at(1), QGeoCoordinate(2.5, 2.0));
+    p.translate(1.0, 1.0);
+    QCOMPARE(p.path().first(), QGeoCoordinate(3.0, 3.0, 10.0));
+    QCOMPARE(p.coordinateAt(0), QGeoCoordinate(3.0, 3.0, 10.0));
+    QCOMPARE(p.boundingGeoRectangle(), QGeoPath(p.path()).boundingGeoRectangle());
+
+    // A copy keeps its own path when the original changes
+    const QGeoPath copy(p);
+    p.clearPath();
+    QVERIFY(p.path().isEmpty());
+    QCOMPARE(copy.path().size(), 4);
+    QCOMPARE(copy.path().first(), QGeoCoordinate(3.0, 3.0, 10.0));
+}
+
 void tst_QGeoPath::width()
 {
     QGeoPath p;
@@ -332,6 +369,28 @@ void tst_QGeoPath::contains()
     QCOMPARE(area.contains(probe), result);
 }
 
+void tst_QGeoPath::containsManySegments()
+{
+    // A 4 km wide corridor winding east along the equator
+    QList<QGeoCoordinate> route;
+    for (int i = 0; i <= 2000; ++i)
+        route << QGeoCoordinate(0.1 * qSin(i * 0.01), i * 0.005);
+    QGeoPath p(route, 4000.0);
+
+    for (int i = 0; i <= 2000; i += 37) {
+        const QGeoCoordinate c = route.at(i);
+        QVERIFY(p.contains(c));
+        QVERIFY(p.contains(QGeoCoordinate(c.latitude() + 0.015, c.longitude())));
+        QVERIFY(!p.contains(QGeoCoordinate(c.latitude() + 0.03, c.longitude())));
+    }
+    QVERIFY(!p.contains(QGeoCoordinate(0.0, -0.1)));
+    QVERIFY(!p.contains(QGeoCoordinate(0.0, 10.1)));
+
+    p.translate(1.0, 0.0);
+    QVERIFY(!p.contains(route.at(1000)));
+    QVERIFY(p.contains(QGeoCoordinate(route.at(1000).latitude() + 1.0, route.at(1000).longitude())));
+}
+
 void tst_QGeoPath::boundingGeoRectangle_data()
 {
     QTest::addColumn<QGeoCoordinate>("c1");
@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <QtTest/QtTest>
+#include <QtCore/qmath.h>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPolygon>
@@ -46,6 +47,7 @@ private slots:
     void type();
 
     void path();
+    void holesDetach();
     void size();
 
     void translate_data();
@@ -56,6 +58,8 @@ private slots:
 
     void contains_data();
     void contains();
+    void containsAfterChange();
+    void containsManyVertices();
 
     void boundingGeoRectangle_data();
     void boundingGeoRectangle();
@@ -189,6 +193,42 @@ void tst_QGeoPolygon::path()
     }
 }
 
+void tst_QGeoPolygon::holesDetach()
+{
+    QList<QGeoCoordinate> perimeter;
+    perimeter.append(QGeoCoordinate(0.0, 0.0));
+    perimeter.append(QGeoCoordinate(0.0, 10.0));
+    perimeter.append(QGeoCoordinate(10.0, 10.0));
+    perimeter.append(QGeoCoordinate(10.0, 0.0));
+    QList<QGeoCoordinate> hole;
+    hole.append(QGeoCoordinate(4.0, 4.0));
+    hole.append(QGeoCoordinate(4.0, 6.0));
+    hole.append(QGeoCoordinate(6.0, 6.0));
+    hole.append(QGeoCoordinate(6.0, 4.0));
+
+    QGeoPolygon p(perimeter);
+    p.addHole(hole);
+    QCOMPARE(p.path(), perimeter);
+    QCOMPARE(p.holesCount(), 1);
+    QCOMPARE(p.holePath(0), hole);
+    QVERIFY(p.contains(QGeoCoordinate(2.0, 2.0)));
+    QVERIFY(!p.contains(QGeoCoordinate(5.0, 5.0)));
+
+    // Holes survive the copy made when a shared polygon is modified
+    QGeoPolygon copy(p);
+    copy.addCoordinate(QGeoCoordinate(5.0, -1.0));
+    QCOMPARE(copy.holesCount(), 1);
+    QCOMPARE(copy.holePath(0), hole);
+    QVERIFY(!copy.contains(QGeoCoordinate(5.0, 5.0)));
+    QCOMPARE(copy.path().size(), 5);
+    QCOMPARE(p.size(), 4);
+    QCOMPARE(p.path(), perimeter);
+
+    p.setPath(hole);
+    QCOMPARE(p.path(), hole);
+    QCOMPARE(copy.path().size(), 5);
+}
+
 void tst_QGeoPolygon::size()
 {
     QList<QGeoCoordinate> coords;
@@ -321,6 +361,54 @@ void tst_QGeoPolygon::contains()
     QCOMPARE(area.contains(probe), result);
 }
 
+void tst_QGeoPolygon::containsAfterChange()
+{
+    QList<QGeoCoordinate> square;
+    square << QGeoCoordinate(0, 0) << QGeoCoordinate(0, 10)
+           << QGeoCoordinate(10, 10) << QGeoCoordinate(10, 0);
+    QGeoPolygon p(square);
+    const QGeoCoordinate probe(5, 5);
+    QVERIFY(p.contains(probe));
+
+    QList<QGeoCoordinate> hole;
+    hole << QGeoCoordinate(4, 4) << QGeoCoordinate(4, 6)
+         << QGeoCoordinate(6, 6) << QGeoCoordinate(6, 4);
+    p.addHole(hole);
+    QVERIFY(!p.contains(probe));
+    QVERIFY(p.contains(QGeoCoordinate(4, 5))); // on the hole boundary
+    QVERIFY(p.contains(QGeoCoordinate(2, 2)));
+
+    p.removeHole(0);
+    QVERIFY(p.contains(probe));
+
+    p.translate(0, 20);
+    QVERIFY(!p.contains(probe));
+    QVERIFY(p.contains(QGeoCoordinate(5, 25)));
+
+    p.replaceCoordinate(0, QGeoCoordinate(-10, 20));
+    QVERIFY(p.contains(QGeoCoordinate(-5, 21)));
+}
+
+void tst_QGeoPolygon::containsManyVertices()
+{
+    // A ring of 2 degrees radius around (0, 0), dense enough to need the edge index
+    QList<QGeoCoordinate> ring;
+    for (int i = 0; i < 3600; ++i) {
+        const double angle = qDegreesToRadians(i * 0.1);
+        ring << QGeoCoordinate(2.0 * qSin(angle), 2.0 * qCos(angle));
+    }
+    QGeoPolygon p(ring);
+
+    for (int i = 0; i < 360; i += 7) {
+        const double angle = qDegreesToRadians(double(i));
+        QVERIFY(p.contains(QGeoCoordinate(1.9 * qSin(angle), 1.9 * qCos(angle))));
+        QVERIFY(!p.contains(QGeoCoordinate(2.1 * qSin(angle), 2.1 * qCos(angle))));
+    }
+    QVERIFY(p.contains(ring.at(1234)));
+    QVERIFY(!p.contains(QGeoCoordinate(3.0, 0.0)));
+    QVERIFY(!p.contains(QGeoCoordinate(-3.0, 0.0)));
+}
+
 void tst_QGeoPolygon::boundingGeoRectangle_data()
 {
     QTest::addColumn<QGeoCoordinate>("c1");
@@ -28,6 +28,7 @@
 
 #include "tst_qgeoroute.h"
 #include "../geotestplugin/qgeoroutingmanagerengine_test.h"
+#include <QtLocation/private/qgeoroute_p.h>
 
 
 tst_QGeoRoute::tst_QGeoRoute()
@@ -143,6 +144,12 @@ void tst_QGeoRoute::path()
     for (int i = 0; i < pathRetrieved.size(); i++) {
         QCOMPARE(pathRetrieved.at(i), path.at(i));
     }
+
+    QCOMPARE(QGeoRoutePrivate::routePrivateData(*qgeoroute)->coordinateArray(), QGeoCoordinateArray(path));
+
+    QGeoRoute route;
+    QGeoRoutePrivate::get(route)->setCoordinateArray(QGeoCoordinateArray(path));
+    QCOMPARE(route.path(), path);
 }
 
 void tst_QGeoRoute::path_data()
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeorouteparser
+
+SOURCES += tst_qgeorouteparser.cpp
+
+QT += location-private positioning testlib
@@ -0,0 +1,329 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointer>
+#include <QtCore/QUrlQuery>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+#include <QtLocation/QGeoManeuver>
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtLocation/private/qgeorouteparser_p.h>
+#include <QtLocation/private/qgeorouteparserosrmv4_p.h>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoRouteReply::Error)
+
+// Tags the instruction of every segment, to tell which extension parsed it
+class TagExtension : public QGeoRouteParserOsrmV5Extension
+{
+public:
+    explicit TagExtension(const QString &tag) : m_tag(tag) {}
+
+    void updateQuery(QUrlQuery &query) const override
+    {
+        Q_UNUSED(query);
+    }
+
+    void updateSegment(QGeoRouteSegment &segment, const QJsonObject &step, const QJsonObject &maneuver) const override
+    {
+        Q_UNUSED(step);
+        Q_UNUSED(maneuver);
+        QGeoManeuver geoManeuver = segment.maneuver();
+        geoManeuver.setInstructionText(m_tag);
+        segment.setManeuver(geoManeuver);
+    }
+
+private:
+    QString m_tag;
+};
+
+// Two steps from (45, 7) to (45.001, 7.001), the second one a U-turn
+static QByteArray osrmV5Reply()
+{
+    QJsonArray steps;
+    const QString geometries[] = { QStringLiteral("_sqytA_{fjLg^g^"), QStringLiteral("grrytAgzgjLg^g^") };
+    const QString types[] = { QStringLiteral("depart"), QStringLiteral("turn") };
+    const QString modifiers[] = { QStringLiteral("straight"), QStringLiteral("uturn") };
+    for (int s = 0; s < 2; ++s) {
+        const QJsonObject maneuver {
+            { QStringLiteral("location"), QJsonArray { 7.0 + s * 0.0005, 45.0 + s * 0.0005 } },
+            { QStringLiteral("bearing_before"), 40 },
+            { QStringLiteral("bearing_after"), 50 },
+            { QStringLiteral("type"), types[s] },
+            { QStringLiteral("modifier"), modifiers[s] } };
+        steps.append(QJsonObject {
+                         { QStringLiteral("distance"), 70.0 },
+                         { QStringLiteral("duration"), 10.0 },
+                         { QStringLiteral("name"), QStringLiteral("Street %1").arg(s) },
+                         { QStringLiteral("mode"), QStringLiteral("driving") },
+                         { QStringLiteral("geometry"), geometries[s] },
+                         { QStringLiteral("maneuver"), maneuver },
+                         { QStringLiteral("intersections"), QJsonArray() } });
+    }
+
+    const QJsonObject leg {
+        { QStringLiteral("distance"), 140.0 },
+        { QStringLiteral("duration"), 20.0 },
+        { QStringLiteral("steps"), steps } };
+    const QJsonObject route {
+        { QStringLiteral("distance"), 140.0 },
+        { QStringLiteral("duration"), 20.0 },
+        { QStringLiteral("legs"), QJsonArray { leg } } };
+    const QJsonObject object {
+        { QStringLiteral("code"), QStringLiteral("Ok") },
+        { QStringLiteral("routes"), QJsonArray { route } } };
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+static QByteArray osrmV4Reply()
+{
+    const QJsonArray instructions {
+        QJsonArray { QStringLiteral("10"), QStringLiteral("Street 0"), 70.0, 0, 10,
+                     QStringLiteral("70m"), QStringLiteral("NE"), 45.0 },
+        QJsonArray { QStringLiteral("15"), QString(), 0.0, 2, 0,
+                     QStringLiteral("0m"), QStringLiteral("N"), 0.0 } };
+    QJsonObject object {
+        { QStringLiteral("status"), 0 },
+        { QStringLiteral("route_geometry"), QStringLiteral("_sqytA_{fjLg^g^g^g^") },
+        { QStringLiteral("route_instructions"), instructions },
+        { QStringLiteral("route_summary"), QJsonObject {
+              { QStringLiteral("total_distance"), 140.0 },
+              { QStringLiteral("total_time"), 20.0 } } } };
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+// Collects the result of a job, before the event loop can run it
+class JobResult
+{
+public:
+    explicit JobResult(QGeoRouteParseJob *job) : job(job)
+    {
+        QObject::connect(job, &QGeoRouteParseJob::finished, job, [this, job]() {
+            ++finished;
+            routes = job->routes();
+            error = job->error();
+            errorString = job->errorString();
+        });
+    }
+
+    // Until the job has reported once and deleted itself
+    bool wait()
+    {
+        return QTest::qWaitFor([this]() { return job.isNull(); }) && finished == 1;
+    }
+
+    QPointer<QGeoRouteParseJob> job;
+    int finished = 0;
+    QList<QGeoRoute> routes;
+    QGeoRouteReply::Error error = QGeoRouteReply::UnknownError;
+    QString errorString;
+
+private:
+    Q_DISABLE_COPY(JobResult)
+};
+
+class tst_QGeoRouteParser : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void parseAsync_data();
+    void parseAsync();
+    void errorReply_data();
+    void errorReply();
+    void abort();
+    void settingsSnapshot();
+    void extensionSnapshot();
+    void deleteParser();
+};
+
+void tst_QGeoRouteParser::initTestCase()
+{
+    qRegisterMetaType<QGeoRouteReply::Error>();
+}
+
+void tst_QGeoRouteParser::parseAsync_data()
+{
+    QTest::addColumn<bool>("v5");
+    QTest::addColumn<QByteArray>("reply");
+    QTest::addColumn<int>("pathSize");
+
+    // v5 joins the step paths, with their common points
+    QTest::newRow("osrm v4") << false << osrmV4Reply() << 3;
+    QTest::newRow("osrm v5") << true << osrmV5Reply() << 4;
+}
+
+// The routes are delivered in the thread of the caller, as parsed synchronously
+void tst_QGeoRouteParser::parseAsync()
+{
+    QFETCH(bool, v5);
+    QFETCH(QByteArray, reply);
+    QFETCH(int, pathSize);
+
+    QGeoRouteParserOsrmV4 parserV4;
+    QGeoRouteParserOsrmV5 parserV5;
+    const QGeoRouteParser &parser = v5 ? static_cast<const QGeoRouteParser &>(parserV5)
+                                       : static_cast<const QGeoRouteParser &>(parserV4);
+
+    QList<QGeoRoute> expected;
+    QString errorString;
+    QCOMPARE(parser.parseReply(expected, errorString, reply), QGeoRouteReply::NoError);
+    QCOMPARE(expected.size(), 1);
+
+    JobResult result(parser.parseReplyAsync(reply));
+    QCOMPARE(result.job->thread(), QThread::currentThread());
+    QVERIFY(result.wait());
+    QCOMPARE(result.error, QGeoRouteReply::NoError);
+    QVERIFY(result.errorString.isEmpty());
+    QCOMPARE(result.routes.size(), 1);
+
+    const QGeoRoute &route = result.routes.first();
+    QCOMPARE(route.path().size(), pathSize);
+    QCOMPARE(route.path(), expected.first().path());
+    QCOMPARE(route.path().last(), QGeoCoordinate(45.001, 7.001));
+    QCOMPARE(route.distance(), 140.0);
+    QCOMPARE(route.travelTime(), 20);
+    QVERIFY(route.firstRouteSegment().isValid());
+    QCOMPARE(route.firstRouteSegment().maneuver().instructionText(),
+             expected.first().firstRouteSegment().maneuver().instructionText());
+}
+
+void tst_QGeoRouteParser::errorReply_data()
+{
+    QTest::addColumn<bool>("v5");
+    QTest::addColumn<QByteArray>("reply");
+    QTest::addColumn<QGeoRouteReply::Error>("error");
+    QTest::addColumn<QString>("errorString");
+
+    QTest::newRow("osrm v4, no json") << false << QByteArray("<html>") << QGeoRouteReply::ParseError
+                                      << QStringLiteral("Couldn't parse json.");
+    QTest::newRow("osrm v4, no route") << false
+                                       << QByteArray("{\"status\":207,\"status_message\":\"Cannot find route\"}")
+                                       << QGeoRouteReply::UnknownError << QStringLiteral("Cannot find route");
+    QTest::newRow("osrm v5, no json") << true << QByteArray("<html>") << QGeoRouteReply::ParseError
+                                      << QStringLiteral("Couldn't parse json.");
+    QTest::newRow("osrm v5, no route") << true << QByteArray("{\"code\":\"NoRoute\"}")
+                                       << QGeoRouteReply::UnknownError << QStringLiteral("NoRoute");
+    QTest::newRow("osrm v5, no routes") << true << QByteArray("{\"code\":\"Ok\"}")
+                                        << QGeoRouteReply::ParseError << QStringLiteral("No routes found");
+}
+
+// Errors are delivered through the job as well, with finished()
+void tst_QGeoRouteParser::errorReply()
+{
+    QFETCH(bool, v5);
+    QFETCH(QByteArray, reply);
+    QFETCH(QGeoRouteReply::Error, error);
+    QFETCH(QString, errorString);
+
+    QGeoRouteParserOsrmV4 parserV4;
+    QGeoRouteParserOsrmV5 parserV5;
+    const QGeoRouteParser &parser = v5 ? static_cast<const QGeoRouteParser &>(parserV5)
+                                       : static_cast<const QGeoRouteParser &>(parserV4);
+
+    JobResult result(parser.parseReplyAsync(reply));
+    QVERIFY(result.wait());
+    QCOMPARE(result.error, error);
+    QCOMPARE(result.errorString, errorString);
+    QVERIFY(result.routes.isEmpty());
+}
+
+// An aborted job does not report anything, and still deletes itself
+void tst_QGeoRouteParser::abort()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QGeoRouteParseJob *job = parser.parseReplyAsync(osrmV5Reply());
+    QSignalSpy finishedSpy(job, &QGeoRouteParseJob::finished);
+    QSignalSpy destroyedSpy(job, &QObject::destroyed);
+    job->abort();
+
+    QTRY_COMPARE(destroyedSpy.count(), 1);
+    QCOMPARE(finishedSpy.count(), 0);
+}
+
+// A reply is parsed with the settings of the parser when the parse was started
+void tst_QGeoRouteParser::settingsSnapshot()
+{
+    QGeoRouteParserOsrmV5 parser;
+    parser.setTrafficSide(QGeoRouteParser::LeftHandTraffic);
+    JobResult left(parser.parseReplyAsync(osrmV5Reply()));
+    parser.setTrafficSide(QGeoRouteParser::RightHandTraffic);
+    JobResult right(parser.parseReplyAsync(osrmV5Reply()));
+
+    QVERIFY(left.wait());
+    QVERIFY(right.wait());
+    QCOMPARE(left.routes.size(), 1);
+    QCOMPARE(right.routes.size(), 1);
+    QCOMPARE(left.routes.first().firstRouteSegment().nextRouteSegment().maneuver().direction(),
+             QGeoManeuver::DirectionUTurnRight);
+    QCOMPARE(right.routes.first().firstRouteSegment().nextRouteSegment().maneuver().direction(),
+             QGeoManeuver::DirectionUTurnLeft);
+}
+
+// Replacing the extension does not wait for, or affect, running parses
+void tst_QGeoRouteParser::extensionSnapshot()
+{
+    QGeoRouteParserOsrmV5 parser;
+    parser.setExtension(new TagExtension(QStringLiteral("first")));
+    JobResult first(parser.parseReplyAsync(osrmV5Reply()));
+    parser.setExtension(new TagExtension(QStringLiteral("second")));
+    JobResult second(parser.parseReplyAsync(osrmV5Reply()));
+
+    QVERIFY(first.wait());
+    QVERIFY(second.wait());
+    QCOMPARE(first.routes.size(), 1);
+    QCOMPARE(second.routes.size(), 1);
+    QCOMPARE(first.routes.first().firstRouteSegment().maneuver().instructionText(), QStringLiteral("first"));
+    QCOMPARE(second.routes.first().firstRouteSegment().maneuver().instructionText(), QStringLiteral("second"));
+}
+
+// Pending jobs are deleted with the parser
+void tst_QGeoRouteParser::deleteParser()
+{
+    QScopedPointer<QGeoRouteParserOsrmV5> parser(new QGeoRouteParserOsrmV5);
+    QGeoRouteParseJob *job = parser->parseReplyAsync(osrmV5Reply());
+    QCOMPARE(job->parent(), parser.data());
+    QSignalSpy finishedSpy(job, &QGeoRouteParseJob::finished);
+    QSignalSpy destroyedSpy(job, &QObject::destroyed);
+
+    parser.reset();
+    QCOMPARE(destroyedSpy.count(), 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(finishedSpy.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteParser)
+
+#include "tst_qgeorouteparser.moc"
@@ -6,4 +6,4 @@ TARGET=tst_qgeoroutesegment
 HEADERS += tst_qgeoroutesegment.h
 SOURCES += tst_qgeoroutesegment.cpp
 
-QT += location testlib
+QT += location-private testlib
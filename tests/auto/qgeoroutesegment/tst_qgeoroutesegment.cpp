@@ -28,6 +28,8 @@
 
 #include "tst_qgeoroutesegment.h"
 
+#include <QtLocation/private/qgeoroutesegment_p.h>
+
 QT_USE_NAMESPACE
 
 tst_QGeoRouteSegment::tst_QGeoRouteSegment()
@@ -156,6 +158,12 @@ void tst_QGeoRouteSegment::path()
     for (int i = 0; i < pathretrieved.size(); i++) {
         QCOMPARE(pathretrieved.at(i), path.at(i));
     }
+
+    QCOMPARE(QGeoRouteSegmentPrivate::get(qAsConst(sgmt))->coordinateArray(), QGeoCoordinateArray(path));
+
+    QGeoRouteSegment other;
+    QGeoRouteSegmentPrivate::get(other)->setCoordinateArray(QGeoCoordinateArray(path));
+    QCOMPARE(other.path(), path);
 }
 
 void tst_QGeoRouteSegment::path_data()
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeosimplifiedpath
+
+SOURCES += tst_qgeosimplifiedpath.cpp
+
+QT += location-private positioning-private testlib
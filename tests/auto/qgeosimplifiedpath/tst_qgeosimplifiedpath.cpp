@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtLocation/private/qgeosimplifiedpath_p.h>
+
+QT_USE_NAMESPACE
+
+static double segmentDistance(const QDoubleVector2D &p, const QDoubleVector2D &a, const QDoubleVector2D &b)
+{
+    const QDoubleVector2D ab = b - a;
+    const double lengthSquared = QDoubleVector2D::dotProduct(ab, ab);
+    double t = 0.0;
+    if (lengthSquared > 0.0)
+        t = qBound(0.0, QDoubleVector2D::dotProduct(p - a, ab) / lengthSquared, 1.0);
+    return (a + ab * t - p).length();
+}
+
+static void douglasPeucker(const QList<QDoubleVector2D> &path, int first, int last, double tolerance,
+                           QVector<bool> *keep)
+{
+    if (last - first < 2)
+        return;
+    int split = first + 1;
+    double distance = -1.0;
+    for (int i = first + 1; i < last; ++i) {
+        const double d = segmentDistance(path.at(i), path.at(first), path.at(last));
+        if (d > distance) {
+            distance = d;
+            split = i;
+        }
+    }
+    if (distance <= tolerance)
+        return;
+    (*keep)[split] = true;
+    douglasPeucker(path, first, split, tolerance, keep);
+    douglasPeucker(path, split, last, tolerance, keep);
+}
+
+static QList<QDoubleVector2D> randomWalk(int size, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QList<QDoubleVector2D> path;
+    QDoubleVector2D p(0.5, 0.5);
+    for (int i = 0; i < size; ++i) {
+        p = p + QDoubleVector2D(random.generateDouble() - 0.5, random.generateDouble() - 0.5) * 1e-3;
+        path << p;
+    }
+    return path;
+}
+
+class tst_QGeoSimplifiedPath : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void douglasPeucker_data();
+    void douglasPeucker();
+    void tolerance_data();
+    void tolerance();
+    void collinear();
+    void append();
+    void levels();
+};
+
+void tst_QGeoSimplifiedPath::douglasPeucker_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<double>("tolerance");
+
+    const int sizes[] = { 2, 3, 10, 1000 };
+    const double tolerances[] = { 0.25e-3, 1e-3, 16e-3 };
+    for (int size : sizes) {
+        for (double tolerance : tolerances) {
+            QTest::newRow(qPrintable(QStringLiteral("%1 points, %2").arg(size).arg(tolerance)))
+                    << size << tolerance;
+        }
+    }
+}
+
+// Tolerances are rounded down to powers of two, these are exact
+void tst_QGeoSimplifiedPath::douglasPeucker()
+{
+    QFETCH(int, size);
+    QFETCH(double, tolerance);
+
+    const double exact = std::ldexp(1.0, int(std::floor(std::log2(tolerance))));
+    const QList<QDoubleVector2D> path = randomWalk(size, quint32(size));
+    QVector<bool> keep(size, false);
+    keep.first() = keep.last() = true;
+    ::douglasPeucker(path, 0, size - 1, exact, &keep);
+    QList<QDoubleVector2D> expected;
+    for (int i = 0; i < size; ++i) {
+        if (keep.at(i))
+            expected << path.at(i);
+    }
+
+    QGeoSimplifiedPath simplified;
+    simplified.setPath(path);
+    QCOMPARE(simplified.simplified(tolerance), expected);
+}
+
+void tst_QGeoSimplifiedPath::tolerance_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<double>("tolerance");
+
+    QTest::newRow("10000 points, fine") << 10000 << 1e-4;
+    QTest::newRow("10000 points, coarse") << 10000 << 1e-2;
+    QTest::newRow("100000 points, fine") << 100000 << 1e-4;
+    QTest::newRow("100000 points, coarse") << 100000 << 1e-2;
+}
+
+// Long paths: no dropped point is further than tolerance from the simplified path
+void tst_QGeoSimplifiedPath::tolerance()
+{
+    QFETCH(int, size);
+    QFETCH(double, tolerance);
+
+    const QList<QDoubleVector2D> path = randomWalk(size, 1);
+    QGeoSimplifiedPath simplified;
+    simplified.setPath(path);
+    const QList<QDoubleVector2D> &result = simplified.simplified(tolerance);
+    QVERIFY(result.size() < size);
+    QCOMPARE(result.first(), path.first());
+    QCOMPARE(result.last(), path.last());
+
+    int next = 0;
+    for (int i = 0; i < size; ++i) {
+        if (path.at(i) == result.at(next)) {
+            ++next;
+            continue;
+        }
+        QVERIFY(next > 0 && next < result.size());
+        QVERIFY(segmentDistance(path.at(i), result.at(next - 1), result.at(next)) <= tolerance);
+    }
+    QCOMPARE(next, result.size());
+}
+
+void tst_QGeoSimplifiedPath::collinear()
+{
+    QList<QDoubleVector2D> path;
+    for (int i = 0; i < 100; ++i)
+        path << QDoubleVector2D(i * 0.01, i * 0.005);
+
+    QGeoSimplifiedPath simplified;
+    simplified.setPath(path);
+    const QList<QDoubleVector2D> expected = { path.first(), path.last() };
+    QCOMPARE(simplified.simplified(1e-9), expected);
+    QCOMPARE(simplified.ranks().first(), qInf());
+    QCOMPARE(simplified.ranks().last(), qInf());
+
+    // Not simplified at all
+    QCOMPARE(simplified.simplified(0.0), path);
+    QCOMPARE(simplified.simplified(-1.0), path);
+}
+
+// Appending ranks the same as setting the whole path
+void tst_QGeoSimplifiedPath::append()
+{
+    const QList<QDoubleVector2D> path = randomWalk(10000, 2);
+    QGeoSimplifiedPath whole;
+    whole.setPath(path);
+
+    QGeoSimplifiedPath appended;
+    for (int i = 0; i < path.size(); ++i) {
+        appended.append(path.at(i));
+        if (i % 997 == 0)
+            appended.simplified(1e-3);
+    }
+    QCOMPARE(appended.path(), path);
+    QCOMPARE(appended.ranks(), whole.ranks());
+    QCOMPARE(appended.simplified(1e-3), whole.simplified(1e-3));
+
+    appended.clear();
+    QVERIFY(appended.isEmpty());
+    QVERIFY(appended.simplified(1e-3).isEmpty());
+}
+
+// Selections are cached per power of two, and are conservative
+void tst_QGeoSimplifiedPath::levels()
+{
+    const QList<QDoubleVector2D> path = randomWalk(1000, 3);
+    QGeoSimplifiedPath simplified;
+    simplified.setPath(path);
+
+    const QList<QDoubleVector2D> atLevel = simplified.simplified(1.0 / 1024);
+    QCOMPARE(simplified.simplified(1.5 / 1024), atLevel);
+    QCOMPARE(simplified.simplified(1.99 / 1024), atLevel);
+    QVERIFY(simplified.simplified(2.0 / 1024).size() <= atLevel.size());
+    QVERIFY(simplified.simplified(0.5 / 1024).size() >= atLevel.size());
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoSimplifiedPath)
+
+#include "tst_qgeosimplifiedpath.moc"
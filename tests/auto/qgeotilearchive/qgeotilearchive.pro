@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilearchive
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilearchive.cpp
+
+QT += location-private testlib
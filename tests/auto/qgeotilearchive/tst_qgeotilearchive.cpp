@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "qgeotilearchive_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileArchive : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void roundTrip();
+    void replaceDuplicates();
+    void fromFiles();
+    void invalidKeys();
+    void invalidFile();
+};
+
+void tst_QGeoTileArchive::roundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("tiles.qgta"));
+
+    QGeoTileArchiveWriter writer;
+    for (int x = 0; x < 16; ++x) {
+        for (int y = 0; y < 16; ++y)
+            QVERIFY(writer.addTile(1, 4, x, y, 0, QByteArray::number(x * 16 + y)));
+    }
+    QVERIFY(writer.addTile(2, 0, 0, 0, 1, QByteArrayLiteral("hidpi")));
+    QVERIFY(writer.write(path));
+
+    QGeoTileArchive archive;
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.tileCount(), 257);
+
+    for (int x = 0; x < 16; ++x) {
+        for (int y = 0; y < 16; ++y)
+            QCOMPARE(archive.tileData(1, 4, x, y), QByteArray::number(x * 16 + y));
+    }
+    QCOMPARE(archive.tileData(2, 0, 0, 0, 1), QByteArrayLiteral("hidpi"));
+    QVERIFY(!archive.contains(2, 0, 0, 0, 0));
+    QVERIFY(!archive.contains(1, 5, 0, 0));
+    QVERIFY(archive.tileData(3, 0, 0, 0).isNull());
+}
+
+void tst_QGeoTileArchive::replaceDuplicates()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("tiles.qgta"));
+
+    QGeoTileArchiveWriter writer;
+    QVERIFY(writer.addTile(1, 10, 5, 7, 0, QByteArrayLiteral("old")));
+    QVERIFY(writer.addTile(1, 10, 5, 7, 0, QByteArrayLiteral("new")));
+    QVERIFY(writer.write(path));
+
+    QGeoTileArchive archive;
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.tileCount(), 1);
+    QCOMPARE(archive.tileData(1, 10, 5, 7), QByteArrayLiteral("new"));
+}
+
+void tst_QGeoTileArchive::fromFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString tilePath = dir.filePath(QStringLiteral("tile.png"));
+    QFile tile(tilePath);
+    QVERIFY(tile.open(QIODevice::WriteOnly));
+    tile.write("png bytes");
+    tile.close();
+
+    const QString path = dir.filePath(QStringLiteral("tiles.qgta"));
+    QGeoTileArchiveWriter writer;
+    QVERIFY(writer.addTile(1, 1, 1, 0, 0, tilePath));
+    QVERIFY(writer.write(path));
+
+    QGeoTileArchive archive;
+    QVERIFY(archive.open(path));
+    QCOMPARE(archive.tileData(1, 1, 1, 0), QByteArrayLiteral("png bytes"));
+}
+
+void tst_QGeoTileArchive::invalidKeys()
+{
+    QGeoTileArchiveWriter writer;
+    QVERIFY(!writer.addTile(256, 1, 0, 0, 0, QByteArray("x")));
+    QVERIFY(!writer.addTile(1, 25, 0, 0, 0, QByteArray("x")));
+    QVERIFY(!writer.addTile(1, 2, 4, 0, 0, QByteArray("x")));
+    QVERIFY(!writer.addTile(1, 2, 0, -1, 0, QByteArray("x")));
+    QVERIFY(!writer.addTile(1, 2, 0, 0, 8, QByteArray("x")));
+    QCOMPARE(writer.tileCount(), 0);
+}
+
+void tst_QGeoTileArchive::invalidFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("garbage.qgta"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(64, 'x'));
+    file.close();
+
+    QGeoTileArchive archive;
+    QVERIFY(!archive.open(path));
+    QVERIFY(!archive.isOpen());
+    QVERIFY(!archive.open(dir.filePath(QStringLiteral("missing.qgta"))));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileArchive)
+
+#include "tst_qgeotilearchive.moc"
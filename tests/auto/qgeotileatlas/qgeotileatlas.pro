@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotileatlas
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotileatlas.cpp
+
+QT += location-private positioning-private quick-private testlib
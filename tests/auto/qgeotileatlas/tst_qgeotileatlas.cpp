@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "qgeotilespec_p.h"
+#include "qgeotileatlas_p.h"
+#include "qgeotiledmapscene_p_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileAtlas : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoTileSpec tile(int x, int y = 0)
+    {
+        return QGeoTileSpec(QStringLiteral("osm"), 1, 12, x, y);
+    }
+    static void quad(float x, QSGGeometry::TexturedPoint2D *vertices)
+    {
+        for (int i = 0; i < QGeoTiledMapTileBatchNode::QuadVertices; ++i)
+            vertices[i].set(x + i, x, 0.5f, 0.5f);
+    }
+    static bool hasQuad(const QGeoTiledMapTileBatchNode &node, const QGeoTileSpec &spec, float x)
+    {
+        const int index = node.quads.value(spec, -1);
+        if (index < 0)
+            return false;
+        QSGGeometry::TexturedPoint2D expected[QGeoTiledMapTileBatchNode::QuadVertices];
+        quad(x, expected);
+        return memcmp(node.geometry.vertexDataAsTexturedPoint2D() + index * QGeoTiledMapTileBatchNode::QuadVertices,
+                      expected, sizeof(expected)) == 0;
+    }
+
+private Q_SLOTS:
+    void allocate();
+    void reuseLeastRecentlyUsed();
+    void release();
+    void sizeClasses();
+    void clear();
+    void batchQuads();
+};
+
+void tst_QGeoTileAtlas::allocate()
+{
+    QGeoTileAtlasAllocator atlas(QSize(1024, 1024));
+    atlas.beginFrame();
+
+    const QSize slotSize(258, 258);
+    QVector<QPair<int, QPoint> > used;
+    for (int i = 0; i < 16; ++i) {
+        const QGeoTileAtlasAllocator::Slot slot = atlas.allocate(tile(i), slotSize);
+        QCOMPARE(slot.rect.size(), slotSize);
+        QVERIFY(QRect(QPoint(0, 0), atlas.pageSize(slot.page)).contains(slot.rect));
+        QVERIFY(!used.contains(qMakePair(slot.page, slot.rect.topLeft())));
+        used.append(qMakePair(slot.page, slot.rect.topLeft()));
+    }
+    // 3 x 3 slots fit in a page
+    QCOMPARE(atlas.pageSize(0), QSize(774, 774));
+    QCOMPARE(atlas.pageCount(), 2);
+    QCOMPARE(atlas.count(), 16);
+
+    QGeoTileAtlasAllocator::Slot slot;
+    QVERIFY(atlas.find(tile(3), &slot));
+    QVERIFY(used.contains(qMakePair(slot.page, slot.rect.topLeft())));
+    QVERIFY(!atlas.find(tile(16), &slot));
+}
+
+void tst_QGeoTileAtlas::reuseLeastRecentlyUsed()
+{
+    QGeoTileAtlasAllocator atlas(QSize(512, 512));
+    const QSize slotSize(256, 256);
+
+    atlas.beginFrame();
+    QVector<QGeoTileAtlasAllocator::Slot> slots;
+    for (int i = 0; i < 4; ++i)
+        slots.append(atlas.allocate(tile(i), slotSize));
+    QCOMPARE(atlas.pageCount(), 1);
+
+    // Every slot is in use in this frame, so a new page is needed
+    QGeoTileSpec evicted;
+    const QGeoTileAtlasAllocator::Slot extra = atlas.allocate(tile(4), slotSize, &evicted);
+    QCOMPARE(extra.page, 1);
+    QCOMPARE(evicted, QGeoTileSpec());
+
+    // Touch everything but tile 2 and fill the second page
+    atlas.beginFrame();
+    QGeoTileAtlasAllocator::Slot slot;
+    for (int i : { 1, 0, 3, 4 })
+        QVERIFY(atlas.find(tile(i), &slot));
+    for (int i = 5; i < 8; ++i)
+        QCOMPARE(atlas.allocate(tile(i), slotSize).page, 1);
+
+    atlas.beginFrame();
+    QVERIFY(atlas.find(tile(5), &slot));
+    slot = atlas.allocate(tile(8), slotSize, &evicted);
+    QCOMPARE(evicted, tile(2));
+    QCOMPARE(slot.page, slots.at(2).page);
+    QCOMPARE(slot.rect, slots.at(2).rect);
+    QVERIFY(!atlas.find(tile(2), &slot));
+
+    // Then in the order the slots were last used
+    atlas.allocate(tile(9), slotSize, &evicted);
+    QCOMPARE(evicted, tile(1));
+    atlas.allocate(tile(10), slotSize, &evicted);
+    QCOMPARE(evicted, tile(0));
+    QCOMPARE(atlas.pageCount(), 2);
+    QCOMPARE(atlas.count(), 8);
+}
+
+void tst_QGeoTileAtlas::release()
+{
+    QGeoTileAtlasAllocator atlas(QSize(512, 512));
+    const QSize slotSize(256, 256);
+
+    atlas.beginFrame();
+    for (int i = 0; i < 4; ++i)
+        atlas.allocate(tile(i), slotSize);
+
+    QGeoTileAtlasAllocator::Slot released;
+    QVERIFY(atlas.find(tile(2), &released));
+    atlas.release(tile(2));
+    QCOMPARE(atlas.count(), 3);
+
+    // Freed slots are used before anything gets evicted or a page is added
+    QGeoTileSpec evicted;
+    const QGeoTileAtlasAllocator::Slot slot = atlas.allocate(tile(4), slotSize, &evicted);
+    QCOMPARE(evicted, QGeoTileSpec());
+    QCOMPARE(slot.page, released.page);
+    QCOMPARE(slot.rect, released.rect);
+    QCOMPARE(atlas.pageCount(), 1);
+}
+
+void tst_QGeoTileAtlas::sizeClasses()
+{
+    QGeoTileAtlasAllocator atlas(QSize(1024, 1024));
+    atlas.beginFrame();
+
+    const QGeoTileAtlasAllocator::Slot small = atlas.allocate(tile(0), QSize(258, 258));
+    const QGeoTileAtlasAllocator::Slot large = atlas.allocate(tile(1), QSize(514, 514));
+    QVERIFY(small.page != large.page);
+    QCOMPARE(atlas.pageSize(large.page), QSize(514, 514));
+
+    // Larger than a page: the page grows to hold one slot
+    const QGeoTileAtlasAllocator::Slot huge = atlas.allocate(tile(2), QSize(2050, 2050));
+    QCOMPARE(atlas.pageSize(huge.page), QSize(2050, 2050));
+    QCOMPARE(atlas.pageCount(), 3);
+}
+
+void tst_QGeoTileAtlas::clear()
+{
+    QGeoTileAtlasAllocator atlas;
+    atlas.beginFrame();
+    atlas.allocate(tile(0), QSize(258, 258));
+    atlas.clear();
+
+    QGeoTileAtlasAllocator::Slot slot;
+    QVERIFY(!atlas.find(tile(0), &slot));
+    QCOMPARE(atlas.count(), 0);
+    QCOMPARE(atlas.pageCount(), 0);
+}
+
+// Quads are updated in place, and only a growing batch reallocates its geometry
+void tst_QGeoTileAtlas::batchQuads()
+{
+    QGeoTiledMapTileBatchNode node;
+    QSGGeometry::TexturedPoint2D vertices[QGeoTiledMapTileBatchNode::QuadVertices];
+    for (int i = 0; i < 10; ++i) {
+        quad(i * 10, vertices);
+        node.setQuad(tile(i), vertices);
+    }
+    QVERIFY(node.geometryChanged);
+    node.commit();
+    QVERIFY(!node.geometryChanged);
+    const int vertexCount = node.geometry.vertexCount();
+    QCOMPARE(vertexCount % QGeoTiledMapTileBatchNode::QuadVertices, 0);
+    QVERIFY(vertexCount >= 10 * QGeoTiledMapTileBatchNode::QuadVertices);
+
+    // Setting the same quad again changes nothing
+    quad(30, vertices);
+    node.setQuad(tile(3), vertices);
+    QVERIFY(!node.geometryChanged);
+
+    // A removed quad draws nothing and its place is taken by the next tile
+    const int removed = node.quads.value(tile(4));
+    node.removeQuad(tile(4));
+    QVERIFY(node.geometryChanged);
+    const QSGGeometry::TexturedPoint2D *data = node.geometry.vertexDataAsTexturedPoint2D()
+            + removed * QGeoTiledMapTileBatchNode::QuadVertices;
+    for (int i = 0; i < QGeoTiledMapTileBatchNode::QuadVertices; ++i)
+        QVERIFY(data[i].x == 0 && data[i].y == 0);
+    quad(100, vertices);
+    node.setQuad(tile(100), vertices);
+    QCOMPARE(node.quads.value(tile(100)), removed);
+    QCOMPARE(node.geometry.vertexCount(), vertexCount);
+
+    // Growing keeps the quads that are there
+    for (int i = 10; i < 40; ++i) {
+        quad(i * 10, vertices);
+        node.setQuad(tile(i), vertices);
+    }
+    QVERIFY(node.geometry.vertexCount() > vertexCount);
+    QCOMPARE(node.quads.size(), 40);
+    for (int i = 0; i < 40; ++i) {
+        if (i != 4)
+            QVERIFY(hasQuad(node, tile(i), i * 10));
+    }
+    QVERIFY(hasQuad(node, tile(100), 100));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileAtlas)
+
+#include "tst_qgeotileatlas.moc"
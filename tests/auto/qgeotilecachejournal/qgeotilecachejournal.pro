@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilecachejournal
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilecachejournal.cpp
+
+QT += location-private testlib
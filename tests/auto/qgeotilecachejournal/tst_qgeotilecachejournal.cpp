@@ -0,0 +1,365 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "qgeotilespec_p.h"
+#include "qgeotilecachejournal_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileCacheJournal : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoTileSpec tile(int x, int y = 0)
+    {
+        return QGeoTileSpec(QStringLiteral("osm"), 1, 12, x, y);
+    }
+    static QGeoTileCacheJournal::Node node(int x, int cost, quint64 pop)
+    {
+        QGeoTileCacheJournal::Node n;
+        n.spec = tile(x);
+        n.variant = x % 2;
+        n.format = QStringLiteral("png");
+        n.cost = cost;
+        n.pop = pop;
+        return n;
+    }
+
+private Q_SLOTS:
+    void emptyDirectory();
+    void snapshot();
+    void journal();
+    void tornRecord();
+    void staleJournal();
+    void backgroundSnapshot();
+    void supersededSnapshot();
+    void clear();
+};
+
+void tst_QGeoTileCacheJournal::emptyDirectory()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoTileCacheJournal journal(dir.path());
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    QVERIFY(journal.load(queues, &records));
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i)
+        QVERIFY(queues[i].isEmpty());
+    QVERIFY(records.isEmpty());
+    QCOMPARE(journal.length(), 0);
+}
+
+void tst_QGeoTileCacheJournal::snapshot()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i) {
+        for (int j = 0; j < 10 * (i + 1); ++j)
+            queues[i].append(node(i * 100 + j, 1000 + j, quint64(i * j)));
+    }
+    queues[3][0].format = QString();
+    queues[3][1].spec = QGeoTileSpec(QStringLiteral("mapbox"), 2, 3, 4, 5, 6);
+
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVector<QGeoTileCacheJournal::Node> loaded[QGeoTileCacheJournal::QueueCount];
+        QVector<QGeoTileCacheJournal::Record> records;
+        QVERIFY(journal.load(loaded, &records));
+        QVERIFY(journal.writeSnapshot(queues));
+    }
+
+    QGeoTileCacheJournal journal(dir.path());
+    QVector<QGeoTileCacheJournal::Node> loaded[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    QVERIFY(journal.load(loaded, &records));
+    QVERIFY(records.isEmpty());
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i) {
+        QCOMPARE(loaded[i].size(), queues[i].size());
+        for (int j = 0; j < queues[i].size(); ++j) {
+            QCOMPARE(loaded[i].at(j).spec, queues[i].at(j).spec);
+            QCOMPARE(loaded[i].at(j).variant, queues[i].at(j).variant);
+            QCOMPARE(loaded[i].at(j).format, queues[i].at(j).format);
+            QCOMPARE(loaded[i].at(j).cost, queues[i].at(j).cost);
+            QCOMPARE(loaded[i].at(j).pop, queues[i].at(j).pop);
+        }
+    }
+}
+
+void tst_QGeoTileCacheJournal::journal()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+        QVector<QGeoTileCacheJournal::Record> records;
+        QVERIFY(journal.load(queues, &records));
+        queues[0].append(node(1, 10, 0));
+        QVERIFY(journal.writeSnapshot(queues));
+
+        // Enough records to go through both the buffer and the file
+        for (int i = 0; i < 1000; ++i)
+            journal.append(QGeoTileCacheJournal::Insert, tile(i), 1, QStringLiteral("jpg"), i);
+        journal.append(QGeoTileCacheJournal::Touch, tile(5));
+        journal.append(QGeoTileCacheJournal::Remove, tile(7));
+        QCOMPARE(journal.length(), 1002);
+    }
+
+    QGeoTileCacheJournal journal(dir.path());
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    QVERIFY(journal.load(queues, &records));
+    QCOMPARE(queues[0].size(), 1);
+    QCOMPARE(records.size(), 1002);
+    QCOMPARE(journal.length(), 1002);
+    for (int i = 0; i < 1000; ++i) {
+        QCOMPARE(records.at(i).operation, QGeoTileCacheJournal::Insert);
+        QCOMPARE(records.at(i).spec, tile(i));
+        QCOMPARE(records.at(i).variant, 1);
+        QCOMPARE(records.at(i).format, QStringLiteral("jpg"));
+        QCOMPARE(records.at(i).cost, i);
+    }
+    QCOMPARE(records.at(1000).operation, QGeoTileCacheJournal::Touch);
+    QCOMPARE(records.at(1000).spec, tile(5));
+    QCOMPARE(records.at(1001).operation, QGeoTileCacheJournal::Remove);
+    QCOMPARE(records.at(1001).spec, tile(7));
+
+    // New records follow the ones already in the file
+    journal.append(QGeoTileCacheJournal::Touch, tile(9));
+    journal.flush();
+
+    QGeoTileCacheJournal reopened(dir.path());
+    QVERIFY(reopened.load(queues, &records));
+    QCOMPARE(records.size(), 1003);
+    QCOMPARE(records.last().spec, tile(9));
+}
+
+void tst_QGeoTileCacheJournal::tornRecord()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = QDir(dir.path()).filePath(QStringLiteral("cache.journal"));
+
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+        QVector<QGeoTileCacheJournal::Record> records;
+        QVERIFY(journal.load(queues, &records));
+        for (int i = 0; i < 3; ++i)
+            journal.append(QGeoTileCacheJournal::Insert, tile(i), 0, QStringLiteral("png"), 1);
+    }
+
+    // Cut the last record in half, as a crash in the middle of a write would
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 fullSize = file.size();
+    QVERIFY(file.resize(fullSize - 10));
+    file.close();
+
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+        QVector<QGeoTileCacheJournal::Record> records;
+        QVERIFY(journal.load(queues, &records));
+        QCOMPARE(records.size(), 2);
+        journal.append(QGeoTileCacheJournal::Touch, tile(0));
+    }
+
+    // Flip a byte in the second record, its checksum no longer matches
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray data = file.readAll();
+    // 16 byte header, then records of 2 + 28 + "osm" + "png" + 2 bytes
+    const int second = 16 + 38;
+    data[second + 10] = char(data.at(second + 10) ^ 0x5a);
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.write(data), qint64(data.size()));
+    file.close();
+
+    QGeoTileCacheJournal journal(dir.path());
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    QVERIFY(journal.load(queues, &records));
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records.at(0).spec, tile(0));
+}
+
+void tst_QGeoTileCacheJournal::staleJournal()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString journalName = QDir(dir.path()).filePath(QStringLiteral("cache.journal"));
+    const QString stateName = QDir(dir.path()).filePath(QStringLiteral("cache.state"));
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVERIFY(journal.load(queues, &records));
+        QVERIFY(journal.writeSnapshot(queues));
+        journal.append(QGeoTileCacheJournal::Insert, tile(1), 0, QStringLiteral("png"), 1);
+    }
+    QVERIFY(QFile::copy(journalName, journalName + QStringLiteral(".old")));
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVERIFY(journal.load(queues, &records));
+        QCOMPARE(records.size(), 1);
+        queues[0].append(node(1, 1, 0));
+        QVERIFY(journal.writeSnapshot(queues));
+    }
+
+    // A journal left over from an older snapshot must not be replayed
+    QVERIFY(QFile::remove(journalName));
+    QVERIFY(QFile::rename(journalName + QStringLiteral(".old"), journalName));
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVERIFY(journal.load(queues, &records));
+        QCOMPARE(queues[0].size(), 1);
+        QVERIFY(records.isEmpty());
+    }
+
+    // Without a readable snapshot the journal is dropped as well
+    QFile state(stateName);
+    QVERIFY(state.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    state.write("garbage");
+    state.close();
+
+    QGeoTileCacheJournal journal(dir.path());
+    QVERIFY(journal.load(queues, &records));
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i)
+        QVERIFY(queues[i].isEmpty());
+    QVERIFY(records.isEmpty());
+}
+
+void tst_QGeoTileCacheJournal::backgroundSnapshot()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVERIFY(journal.load(queues, &records));
+        journal.append(QGeoTileCacheJournal::Insert, tile(1), 0, QStringLiteral("png"), 1);
+
+        queues[0].append(node(1, 1, 0));
+        const quint64 generation = journal.beginSnapshot();
+        QVERIFY(generation);
+        QCOMPARE(journal.beginSnapshot(), quint64(0));
+
+        // Appended while the snapshot is written, they have to survive it
+        journal.append(QGeoTileCacheJournal::Insert, tile(2), 0, QStringLiteral("png"), 1);
+        journal.append(QGeoTileCacheJournal::Touch, tile(1));
+
+        bool saved = false;
+        QScopedPointer<QThread> thread(QThread::create([&]() {
+            saved = journal.saveSnapshot(generation, queues);
+        }));
+        thread->start();
+        QVERIFY(thread->wait());
+        QVERIFY(saved);
+        journal.endSnapshot(generation, saved);
+        QCOMPARE(journal.length(), 2);
+        journal.append(QGeoTileCacheJournal::Remove, tile(2));
+    }
+
+    QGeoTileCacheJournal journal(dir.path());
+    QVERIFY(journal.load(queues, &records));
+    QCOMPARE(queues[0].size(), 1);
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records.at(0).operation, QGeoTileCacheJournal::Insert);
+    QCOMPARE(records.at(0).spec, tile(2));
+    QCOMPARE(records.at(1).operation, QGeoTileCacheJournal::Touch);
+    QCOMPARE(records.at(2).operation, QGeoTileCacheJournal::Remove);
+}
+
+// A snapshot written in the foreground wins over one still being written
+void tst_QGeoTileCacheJournal::supersededSnapshot()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVERIFY(journal.load(queues, &records));
+        queues[0].append(node(1, 1, 0));
+        const quint64 generation = journal.beginSnapshot();
+        QVERIFY(generation);
+
+        journal.clear();
+        QVERIFY(!journal.saveSnapshot(generation, queues));
+        journal.endSnapshot(generation, false);
+        journal.append(QGeoTileCacheJournal::Insert, tile(2), 0, QStringLiteral("png"), 1);
+    }
+
+    QGeoTileCacheJournal journal(dir.path());
+    QVERIFY(journal.load(queues, &records));
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i)
+        QVERIFY(queues[i].isEmpty());
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records.at(0).spec, tile(2));
+}
+
+void tst_QGeoTileCacheJournal::clear()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QVector<QGeoTileCacheJournal::Node> queues[QGeoTileCacheJournal::QueueCount];
+    QVector<QGeoTileCacheJournal::Record> records;
+    {
+        QGeoTileCacheJournal journal(dir.path());
+        QVERIFY(journal.load(queues, &records));
+        queues[1].append(node(1, 1, 1));
+        QVERIFY(journal.writeSnapshot(queues));
+        journal.append(QGeoTileCacheJournal::Insert, tile(2), 0, QStringLiteral("png"), 1);
+        journal.clear();
+        QCOMPARE(journal.length(), 0);
+    }
+
+    QGeoTileCacheJournal journal(dir.path());
+    QVERIFY(journal.load(queues, &records));
+    for (int i = 0; i < QGeoTileCacheJournal::QueueCount; ++i)
+        QVERIFY(queues[i].isEmpty());
+    QVERIFY(records.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileCacheJournal)
+
+#include "tst_qgeotilecachejournal.moc"
@@ -30,6 +30,7 @@
 
 #include "qgeotilespec_p.h"
 #include "qgeotiledmapscene_p.h"
+#include "qgeotiledmapscene_p_p.h"
 #include "qgeocameratiles_p.h"
 #include "qgeocameradata_p.h"
 #include "qabstractgeotilecache_p.h"
@@ -38,6 +39,9 @@
 #include <QtPositioning/private/qdoublevector2d_p.h>
 
 #include <qtest.h>
+#include <QtCore/qmath.h>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGImageNode>
 
 #include <QList>
 #include <QPair>
@@ -288,6 +292,56 @@ class tst_QGeoTiledMapScene : public QObject
         screenCameraPositions(name, zoom, tileSize, screenWidth, screenHeight);
     }
 
+    // Tiles 2 to 9 of row 8 at zoom level 4, the screen is two tiles wide
+    static QGeoTileSpec tile(int x)
+    {
+        return QGeoTileSpec(QStringLiteral("test"), 1, 4, x, 8);
+    }
+
+    static QSharedPointer<QGeoTileTexture> texture(const QGeoTileSpec &spec, int size = 256)
+    {
+        QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+        tt->spec = spec;
+        tt->image = QImage(size, size, QImage::Format_RGB32);
+        tt->image.fill(Qt::gray);
+        return tt;
+    }
+
+    // Centered on the tile coordinates x, 8.5
+    static void setCamera(QGeoTiledMapScene *scene, double x, double zoom = 4.0)
+    {
+        QGeoCameraData camera;
+        camera.setZoomLevel(zoom);
+        camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(x / 16.0, 8.5 / 16.0)));
+        scene->setCameraData(camera);
+        scene->setVisibleTiles(scene->visibleTiles());
+    }
+
+    static void setUpScene(QGeoTiledMapScene *scene, int textureSize = 256)
+    {
+        scene->setScreenSize(QSize(512, 512));
+        scene->setTileSize(256);
+        QSet<QGeoTileSpec> tiles;
+        for (int x = 2; x < 10; ++x)
+            tiles.insert(tile(x));
+        scene->setVisibleTiles(tiles);
+        setCamera(scene, 8.5);
+        for (const QGeoTileSpec &spec : tiles)
+            scene->addTile(spec, texture(spec, textureSize));
+    }
+
+    QGeoTiledMapRootNode *sync(QGeoTiledMapScene *scene, QGeoTiledMapRootNode *root)
+    {
+        return static_cast<QGeoTiledMapRootNode *>(scene->updateSceneGraph(root, m_window.data()));
+    }
+
+    static QSGImageNode *node(QGeoTiledMapRootNode *root, int x)
+    {
+        return root->tiles->tiles.value(tile(x));
+    }
+
+    QScopedPointer<QQuickWindow> m_window;
+
     // Calculates the distance in mercator space of 2 x coordinates, assuming that 1 == 0
     double wrappedMercatorDistance(double x1, double x2)
     {
@@ -295,6 +349,17 @@ class tst_QGeoTiledMapScene : public QObject
     }
 
     private slots:
+        // The scene graph of the software backend is updated on this thread
+        void initTestCase()
+        {
+            QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+            m_window.reset(new QQuickWindow);
+            m_window->resize(512, 512);
+            m_window->show();
+            QVERIFY(QTest::qWaitForWindowExposed(m_window.data()));
+            QTRY_VERIFY(m_window->isSceneGraphInitialized());
+        }
+
         void screenToMercatorPositions(){
             QFETCH(double, screenX);
             QFETCH(double, screenY);
@@ -394,7 +459,111 @@ class tst_QGeoTiledMapScene : public QObject
             populateScreenMercatorData();
         }
 
+        void removeAndReAddTile()
+        {
+            QGeoTiledMapScene scene;
+            setUpScene(&scene);
+            QScopedPointer<QGeoTiledMapRootNode> root(sync(&scene, nullptr));
+            QVERIFY(root);
+            QVERIFY(node(root.data(), 8));
+            QCOMPARE(node(root.data(), 8)->texture()->textureSize(), QSize(256, 256));
+
+            // Gone and back with another texture: the old node must not survive
+            const QSet<QGeoTileSpec> tiles = scene.visibleTiles();
+            scene.setVisibleTiles(QSet<QGeoTileSpec>(tiles).subtract({ tile(8) }));
+            scene.setVisibleTiles(tiles);
+            scene.addTile(tile(8), texture(tile(8), 128));
+            QCOMPARE(sync(&scene, root.data()), root.data());
+            QVERIFY(node(root.data(), 8));
+            QCOMPARE(node(root.data(), 8)->texture()->textureSize(), QSize(128, 128));
+            QCOMPARE(root->textures.value(tile(8))->textureSize(), QSize(128, 128));
+
+            // Gone and back without a texture: no node until the texture arrives
+            scene.setVisibleTiles(QSet<QGeoTileSpec>(tiles).subtract({ tile(8) }));
+            scene.setVisibleTiles(tiles);
+            sync(&scene, root.data());
+            QVERIFY(!node(root.data(), 8));
+            QVERIFY(!root->textures.contains(tile(8)));
+            scene.addTile(tile(8), texture(tile(8)));
+            sync(&scene, root.data());
+            QVERIFY(node(root.data(), 8));
+            QCOMPARE(node(root.data(), 8)->texture()->textureSize(), QSize(256, 256));
+        }
+
+        void cullAndShowAgain()
+        {
+            QGeoTiledMapScene scene;
+            setUpScene(&scene);
+            QScopedPointer<QGeoTiledMapRootNode> root(sync(&scene, nullptr));
+            QVERIFY(node(root.data(), 8));
+            QVERIFY(node(root.data(), 9));
+            QVERIFY(!node(root.data(), 2));
+            QVERIFY(!node(root.data(), 3));
+
+            setCamera(&scene, 3.5);
+            sync(&scene, root.data());
+            QVERIFY(node(root.data(), 2));
+            QVERIFY(node(root.data(), 3));
+            QVERIFY(!node(root.data(), 8));
+            QVERIFY(!node(root.data(), 9));
+
+            // The textures of culled tiles are kept, nothing has to be added again
+            setCamera(&scene, 8.5);
+            sync(&scene, root.data());
+            QVERIFY(node(root.data(), 8));
+            QVERIFY(node(root.data(), 9));
+            QVERIFY(!node(root.data(), 2));
+            QCOMPARE(node(root.data(), 9)->texture(), root->textures.value(tile(9)));
+        }
+
+        void pixelRatioChange()
+        {
+            // Twice the device pixels of a tile, scaled down with linear filtering
+            const int textureSize = qCeil(2 * 256 * m_window->effectiveDevicePixelRatio());
+            QGeoTiledMapScene scene;
+            setUpScene(&scene, textureSize);
+            QScopedPointer<QGeoTiledMapRootNode> root(sync(&scene, nullptr));
+            QVERIFY(!root->tiles->tiles.isEmpty());
+            for (QSGImageNode *imageNode : qAsConst(root->tiles->tiles))
+                QCOMPARE(imageNode->filtering(), QSGTexture::Linear);
+
+            // As if the last update was on a screen with four times the ratio,
+            // where these textures were not scaled down
+            for (QSGImageNode *imageNode : qAsConst(root->tiles->tiles))
+                imageNode->setFiltering(QSGTexture::Nearest);
+            root->pixelRatio = 4 * m_window->effectiveDevicePixelRatio();
+
+            sync(&scene, root.data());
+            QCOMPARE(root->pixelRatio, m_window->effectiveDevicePixelRatio());
+            for (QSGImageNode *imageNode : qAsConst(root->tiles->tiles))
+                QCOMPARE(imageNode->filtering(), QSGTexture::Linear);
+        }
+
+        void toggleLinearScaling()
+        {
+            QGeoTiledMapScene scene;
+            setUpScene(&scene);
+            QScopedPointer<QGeoTiledMapRootNode> root(sync(&scene, nullptr));
+            QVERIFY(!root->tiles->tiles.isEmpty());
+            for (QSGImageNode *imageNode : qAsConst(root->tiles->tiles))
+                QCOMPARE(imageNode->filtering(), QSGTexture::Nearest);
+
+            // A fractional zoom level scales the tiles
+            setCamera(&scene, 8.5, 4.5);
+            sync(&scene, root.data());
+            QVERIFY(root->isTextureLinear);
+            QVERIFY(node(root.data(), 8));
+            for (QSGImageNode *imageNode : qAsConst(root->tiles->tiles))
+                QCOMPARE(imageNode->filtering(), QSGTexture::Linear);
+
+            setCamera(&scene, 8.5, 4.0);
+            sync(&scene, root.data());
+            QVERIFY(!root->isTextureLinear);
+            for (QSGImageNode *imageNode : qAsConst(root->tiles->tiles))
+                QCOMPARE(imageNode->filtering(), QSGTexture::Nearest);
+        }
+
 };
 
-QTEST_GUILESS_MAIN(tst_QGeoTiledMapScene)
+QTEST_MAIN(tst_QGeoTiledMapScene)
 #include "tst_qgeotiledmapscene.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilefetchqueue
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilefetchqueue.cpp
+
+QT += location-private testlib
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "qgeotilespec_p.h"
+#include "qgeotilefetcher_p_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileFetchQueue : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoTileSpec tile(int x, int y = 0)
+    {
+        return QGeoTileSpec(QStringLiteral("test"), 1, 10, x, y);
+    }
+
+private Q_SLOTS:
+    void priorityOrder();
+    void fifoWithinPriority();
+    void remove();
+    void reprioritize();
+    void manyCancellations();
+};
+
+void tst_QGeoTileFetchQueue::priorityOrder()
+{
+    QGeoTileFetchQueue queue;
+    queue.insert(tile(0), 30);
+    queue.insert(tile(1), 10);
+    queue.insert(tile(2), 20);
+    QCOMPARE(queue.size(), 3);
+
+    QCOMPARE(queue.takeFirst(), tile(1));
+    QCOMPARE(queue.takeFirst(), tile(2));
+    QCOMPARE(queue.takeFirst(), tile(0));
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(queue.takeFirst(), QGeoTileSpec());
+}
+
+void tst_QGeoTileFetchQueue::fifoWithinPriority()
+{
+    QGeoTileFetchQueue queue;
+    for (int i = 0; i < 10; ++i)
+        queue.insert(tile(i), 0);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(queue.takeFirst(), tile(i));
+}
+
+void tst_QGeoTileFetchQueue::remove()
+{
+    QGeoTileFetchQueue queue;
+    queue.insert(tile(0), 0);
+    queue.insert(tile(1), 1);
+    queue.insert(tile(2), 2);
+
+    QVERIFY(queue.remove(tile(0)));
+    QVERIFY(!queue.remove(tile(0)));
+    QVERIFY(!queue.contains(tile(0)));
+    QCOMPARE(queue.size(), 2);
+
+    QCOMPARE(queue.takeFirst(), tile(1));
+    QCOMPARE(queue.takeFirst(), tile(2));
+    QVERIFY(queue.isEmpty());
+}
+
+void tst_QGeoTileFetchQueue::reprioritize()
+{
+    QGeoTileFetchQueue queue;
+    queue.insert(tile(0), 5);
+    queue.insert(tile(1), 10);
+    queue.insert(tile(1), 1);
+    QCOMPARE(queue.size(), 2);
+
+    QCOMPARE(queue.takeFirst(), tile(1));
+    QCOMPARE(queue.takeFirst(), tile(0));
+    QVERIFY(queue.isEmpty());
+
+    // The stale entry of a lowered priority must not resurface
+    queue.insert(tile(2), 1);
+    queue.insert(tile(3), 5);
+    queue.insert(tile(2), 10);
+    QCOMPARE(queue.takeFirst(), tile(3));
+    QCOMPARE(queue.takeFirst(), tile(2));
+    QVERIFY(queue.isEmpty());
+}
+
+void tst_QGeoTileFetchQueue::manyCancellations()
+{
+    QGeoTileFetchQueue queue;
+    for (int i = 0; i < 1000; ++i)
+        queue.insert(tile(i % 100, i / 100), i);
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 10)
+            QVERIFY(queue.remove(tile(i % 100, i / 100)));
+    }
+    QCOMPARE(queue.size(), 100);
+
+    for (int i = 0; i < 1000; i += 10)
+        QCOMPARE(queue.takeFirst(), tile(i % 100, i / 100));
+    QVERIFY(queue.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileFetchQueue)
+
+#include "tst_qgeotilefetchqueue.moc"
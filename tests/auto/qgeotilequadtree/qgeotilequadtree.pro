@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilequadtree
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilequadtree.cpp
+
+QT += location-private testlib
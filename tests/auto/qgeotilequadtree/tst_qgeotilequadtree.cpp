@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "qgeotilespec_p.h"
+#include "qgeotilequadtree_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileQuadtree : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoTileSpec tile(int zoom, int x, int y)
+    {
+        return QGeoTileSpec(QStringLiteral("osm"), 1, zoom, x, y);
+    }
+
+private Q_SLOTS:
+    void insertRemove();
+    void ancestor();
+    void descendants();
+    void descendantsMixedLevels();
+    void removalBreaksCoverage();
+    void separateMaps();
+};
+
+void tst_QGeoTileQuadtree::insertRemove()
+{
+    QGeoTileQuadtree index;
+    QCOMPARE(index.size(), 0);
+
+    index.insert(tile(5, 3, 4));
+    index.insert(tile(5, 3, 4));
+    QCOMPARE(index.size(), 1);
+    QVERIFY(index.contains(tile(5, 3, 4)));
+    QVERIFY(!index.contains(tile(4, 1, 2)));
+
+    index.remove(tile(4, 1, 2));
+    QCOMPARE(index.size(), 1);
+
+    index.remove(tile(5, 3, 4));
+    QCOMPARE(index.size(), 0);
+    QVERIFY(!index.contains(tile(5, 3, 4)));
+
+    index.insert(tile(5, 3, 4));
+    index.clear();
+    QCOMPARE(index.size(), 0);
+    QVERIFY(!index.contains(tile(5, 3, 4)));
+}
+
+void tst_QGeoTileQuadtree::ancestor()
+{
+    QGeoTileQuadtree index;
+    index.insert(tile(3, 1, 1));
+    index.insert(tile(5, 5, 6));
+
+    QCOMPARE(index.ancestor(tile(6, 11, 13), 4), tile(5, 5, 6));
+    QCOMPARE(index.ancestor(tile(6, 8, 8), 4), tile(3, 1, 1));
+    QCOMPARE(index.ancestor(tile(6, 8, 8), 2).zoom(), -1);
+    QCOMPARE(index.ancestor(tile(6, 0, 0), 6).zoom(), -1);
+
+    // A tile is not its own ancestor
+    QCOMPARE(index.ancestor(tile(3, 1, 1), 4).zoom(), -1);
+}
+
+void tst_QGeoTileQuadtree::descendants()
+{
+    QGeoTileQuadtree index;
+    QVector<QGeoTileSpec> tiles;
+
+    for (int i = 0; i < 3; ++i)
+        index.insert(QGeoTileQuadtree::child(tile(4, 2, 3), i));
+    QVERIFY(!index.descendants(tile(4, 2, 3), 2, &tiles));
+    QVERIFY(tiles.isEmpty());
+
+    index.insert(QGeoTileQuadtree::child(tile(4, 2, 3), 3));
+    QVERIFY(index.descendants(tile(4, 2, 3), 1, &tiles));
+    QCOMPARE(tiles.size(), 4);
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(tiles.contains(QGeoTileQuadtree::child(tile(4, 2, 3), i)));
+
+    // Coverage propagates to the ancestors of the covered tile, but not
+    // beyond the requested depth
+    tiles.clear();
+    QVERIFY(!index.descendants(tile(3, 1, 1), 2, &tiles));
+    QVERIFY(!index.descendants(tile(4, 2, 3), 0, &tiles));
+    QVERIFY(tiles.isEmpty());
+}
+
+void tst_QGeoTileQuadtree::descendantsMixedLevels()
+{
+    QGeoTileQuadtree index;
+    const QGeoTileSpec root = tile(2, 1, 1);
+
+    // Three children directly, the fourth through its own four children
+    for (int i = 0; i < 3; ++i)
+        index.insert(QGeoTileQuadtree::child(root, i));
+    const QGeoTileSpec last = QGeoTileQuadtree::child(root, 3);
+    for (int i = 0; i < 4; ++i)
+        index.insert(QGeoTileQuadtree::child(last, i));
+
+    QVector<QGeoTileSpec> tiles;
+    QVERIFY(!index.descendants(root, 1, &tiles));
+    QVERIFY(index.descendants(root, 2, &tiles));
+    QCOMPARE(tiles.size(), 7);
+    QVERIFY(!tiles.contains(last));
+
+    // Once present, the larger tile is preferred over its children
+    index.insert(last);
+    tiles.clear();
+    QVERIFY(index.descendants(root, 2, &tiles));
+    QCOMPARE(tiles.size(), 4);
+    QVERIFY(tiles.contains(last));
+}
+
+void tst_QGeoTileQuadtree::removalBreaksCoverage()
+{
+    QGeoTileQuadtree index;
+    const QGeoTileSpec root = tile(2, 0, 1);
+    const QGeoTileSpec last = QGeoTileQuadtree::child(root, 3);
+    for (int i = 0; i < 3; ++i)
+        index.insert(QGeoTileQuadtree::child(root, i));
+    for (int i = 0; i < 4; ++i)
+        index.insert(QGeoTileQuadtree::child(last, i));
+
+    QVector<QGeoTileSpec> tiles;
+    QVERIFY(index.descendants(root, 2, &tiles));
+
+    index.remove(QGeoTileQuadtree::child(last, 2));
+    tiles.clear();
+    QVERIFY(!index.descendants(root, 2, &tiles));
+
+    index.insert(last);
+    QVERIFY(index.descendants(root, 2, &tiles));
+
+    index.remove(last);
+    tiles.clear();
+    QVERIFY(!index.descendants(root, 2, &tiles));
+    QCOMPARE(index.size(), 6);
+    QCOMPARE(index.ancestor(QGeoTileQuadtree::child(last, 0), 1).zoom(), -1);
+}
+
+void tst_QGeoTileQuadtree::separateMaps()
+{
+    QGeoTileQuadtree index;
+    QGeoTileSpec other = tile(3, 2, 2);
+    other.setMapId(2);
+    index.insert(other);
+
+    QCOMPARE(index.ancestor(tile(4, 4, 4), 2).zoom(), -1);
+    QCOMPARE(index.ancestor(QGeoTileQuadtree::child(other, 0), 2), other);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileQuadtree)
+
+#include "tst_qgeotilequadtree.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilesegmentstore
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilesegmentstore.cpp
+
+QT += location-private testlib
@@ -0,0 +1,317 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "qgeotilespec_p.h"
+#include "qgeotilesegmentstore_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileSegmentStore : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QGeoTileSpec tile(int x, int y = 0)
+    {
+        return QGeoTileSpec(QStringLiteral("osm"), 1, 12, x, y);
+    }
+    static QByteArray payload(int x, int size = 100)
+    {
+        return QByteArray(size, char('a' + x % 26));
+    }
+
+private Q_SLOTS:
+    void insertReadRemove();
+    void variants();
+    void reopen();
+    void rebuildWithoutIndex();
+    void staleIndex();
+    void truncatedSegment();
+    void compaction();
+    void pinnedCompaction();
+    void clear();
+};
+
+void tst_QGeoTileSegmentStore::insertReadRemove()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+
+    QVERIFY(store.insert(tile(1), 0, QStringLiteral("png"), payload(1)));
+    QVERIFY(store.contains(tile(1)));
+    QString format;
+    QCOMPARE(store.read(tile(1), 0, &format), payload(1));
+    QCOMPARE(format, QStringLiteral("png"));
+
+    QString fileName;
+    qint64 offset = 0;
+    int size = 0;
+    QVERIFY(store.locate(tile(1), 0, &fileName, &offset, &size));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.seek(offset));
+    QCOMPARE(file.read(size), payload(1));
+
+    QVERIFY(store.insert(tile(1), 0, QStringLiteral("jpg"), payload(2)));
+    QCOMPARE(store.tileCount(), 1);
+    QCOMPARE(store.read(tile(1), 0, &format), payload(2));
+    QCOMPARE(format, QStringLiteral("jpg"));
+
+    QVERIFY(store.remove(tile(1)));
+    QVERIFY(!store.remove(tile(1)));
+    QVERIFY(!store.contains(tile(1)));
+    QVERIFY(store.read(tile(1)).isNull());
+}
+
+void tst_QGeoTileSegmentStore::variants()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+
+    QVERIFY(store.insert(tile(1), 0, QStringLiteral("png"), payload(1)));
+    QVERIFY(store.insert(tile(1), 1, QStringLiteral("png"), payload(2)));
+    QCOMPARE(store.tileCount(), 2);
+    QCOMPARE(store.read(tile(1), 0), payload(1));
+    QCOMPARE(store.read(tile(1), 1), payload(2));
+}
+
+void tst_QGeoTileSegmentStore::reopen()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        QGeoTileSegmentStore store(dir.path());
+        QVERIFY(store.open());
+        for (int x = 0; x < 50; ++x)
+            QVERIFY(store.insert(tile(x), x % 2, QStringLiteral("png"), payload(x)));
+        QVERIFY(store.remove(tile(10), 0));
+    }
+    QVERIFY(QFile::exists(QDir(dir.path()).filePath(QStringLiteral("segments.idx"))));
+
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+    QCOMPARE(store.tileCount(), 49);
+    QVERIFY(!store.contains(tile(10), 0));
+    for (int x = 0; x < 50; ++x) {
+        if (x != 10)
+            QCOMPARE(store.read(tile(x), x % 2), payload(x));
+    }
+
+    const QVector<QGeoTileSegmentStore::Entry> entries = store.entries();
+    QCOMPARE(entries.size(), 49);
+    for (const QGeoTileSegmentStore::Entry &entry : entries) {
+        QCOMPARE(entry.spec.plugin(), QStringLiteral("osm"));
+        QCOMPARE(entry.format, QStringLiteral("png"));
+        QCOMPARE(entry.size, 100);
+        QVERIFY(entry.timestamp > 0);
+    }
+}
+
+void tst_QGeoTileSegmentStore::rebuildWithoutIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        QGeoTileSegmentStore store(dir.path());
+        QVERIFY(store.open());
+        store.setMaxSegmentSize(64 * 1024);
+        for (int x = 0; x < 100; ++x)
+            QVERIFY(store.insert(tile(x), 0, QStringLiteral("png"), payload(x, 2000)));
+        QVERIFY(store.remove(tile(5)));
+        QVERIFY(store.insert(tile(6), 0, QStringLiteral("png"), payload(60, 2000)));
+    }
+    // Simulate a crash: no index snapshot
+    QVERIFY(QFile::remove(QDir(dir.path()).filePath(QStringLiteral("segments.idx"))));
+
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+    QCOMPARE(store.tileCount(), 99);
+    QVERIFY(!store.contains(tile(5)));
+    QCOMPARE(store.read(tile(6)), payload(60, 2000));
+    QCOMPARE(store.read(tile(99)), payload(99, 2000));
+}
+
+void tst_QGeoTileSegmentStore::staleIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString indexFile = QDir(dir.path()).filePath(QStringLiteral("segments.idx"));
+    const QString staleFile = QDir(dir.path()).filePath(QStringLiteral("stale.idx"));
+    {
+        QGeoTileSegmentStore store(dir.path());
+        QVERIFY(store.open());
+        store.setMaxSegmentSize(64 * 1024);
+        for (int x = 0; x < 100; ++x)
+            QVERIFY(store.insert(tile(x), 0, QStringLiteral("png"), payload(x, 2000)));
+    }
+    QVERIFY(QFile::copy(indexFile, staleFile));
+    {
+        QGeoTileSegmentStore store(dir.path());
+        QVERIFY(store.open());
+        // The snapshot is only replaced on close
+        QVERIFY(QFile::exists(indexFile));
+
+        store.setMaxSegmentSize(64 * 1024);
+        for (int x = 0; x < 40; ++x)
+            QVERIFY(store.remove(tile(x)));
+        QVERIFY(store.insert(tile(50), 0, QStringLiteral("png"), payload(7, 2000)));
+        for (int x = 100; x < 150; ++x)
+            QVERIFY(store.insert(tile(x), 0, QStringLiteral("png"), payload(x, 2000)));
+        store.compact();
+    }
+    // Simulate a crash before the new snapshot got written
+    QVERIFY(QFile::remove(indexFile));
+    QVERIFY(QFile::rename(staleFile, indexFile));
+
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+    QCOMPARE(store.tileCount(), 110);
+    for (int x = 0; x < 40; ++x)
+        QVERIFY(!store.contains(tile(x)));
+    QCOMPARE(store.read(tile(50)), payload(7, 2000));
+    for (int x = 40; x < 150; ++x) {
+        if (x != 50)
+            QCOMPARE(store.read(tile(x)), payload(x, 2000));
+    }
+}
+
+void tst_QGeoTileSegmentStore::truncatedSegment()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    {
+        QGeoTileSegmentStore store(dir.path());
+        QVERIFY(store.open());
+        QVERIFY(store.insert(tile(1), 0, QStringLiteral("png"), payload(1)));
+        QVERIFY(store.insert(tile(2), 0, QStringLiteral("png"), payload(2)));
+    }
+    QVERIFY(QFile::remove(QDir(dir.path()).filePath(QStringLiteral("segments.idx"))));
+
+    // Cut the last record in half
+    const QStringList segments = QDir(dir.path()).entryList({ QStringLiteral("seg-*.qgs") }, QDir::Files);
+    QCOMPARE(segments.size(), 1);
+    QFile segment(QDir(dir.path()).filePath(segments.first()));
+    QVERIFY(segment.resize(segment.size() - 50));
+
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+    QCOMPARE(store.tileCount(), 1);
+    QCOMPARE(store.read(tile(1)), payload(1));
+
+    // Appending after the recovered end still works
+    QVERIFY(store.insert(tile(3), 0, QStringLiteral("png"), payload(3)));
+    QCOMPARE(store.read(tile(3)), payload(3));
+}
+
+void tst_QGeoTileSegmentStore::compaction()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+    store.setMaxSegmentSize(64 * 1024);
+
+    for (int x = 0; x < 200; ++x)
+        QVERIFY(store.insert(tile(x), 0, QStringLiteral("png"), payload(x, 4000)));
+    const qint64 usage = store.diskUsage();
+    QVERIFY(usage > 200 * 4000);
+
+    for (int x = 0; x < 200; ++x) {
+        if (x % 4)
+            QVERIFY(store.remove(tile(x)));
+    }
+
+    // Removing only queues the segments
+    QVERIFY(store.diskUsage() > usage);
+    QVERIFY(store.compactionPending());
+    store.compact();
+    QVERIFY(!store.compactionPending());
+
+    QCOMPARE(store.tileCount(), 50);
+    QVERIFY(store.diskUsage() < usage / 2);
+    for (int x = 0; x < 200; x += 4)
+        QCOMPARE(store.read(tile(x)), payload(x, 4000));
+}
+
+void tst_QGeoTileSegmentStore::pinnedCompaction()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+    store.setMaxSegmentSize(64 * 1024);
+
+    for (int x = 0; x < 40; ++x)
+        QVERIFY(store.insert(tile(x), 0, QStringLiteral("png"), payload(x, 4000)));
+
+    QString fileName;
+    qint64 offset = 0;
+    int size = 0;
+    QVERIFY(store.acquire(tile(0), 0, &fileName, &offset, &size));
+    for (int x = 1; x < 40; ++x)
+        QVERIFY(store.remove(tile(x)));
+    QVERIFY(store.remove(tile(0)));
+
+    // The segment of tile 0 stays readable while it is pinned
+    store.compact();
+    QVERIFY(!store.compactionPending());
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.seek(offset));
+    QCOMPARE(file.read(size), payload(0, 4000));
+    file.close();
+
+    store.release(fileName);
+    QVERIFY(store.compactionPending());
+    store.compact();
+    QVERIFY(!QFile::exists(fileName));
+}
+
+void tst_QGeoTileSegmentStore::clear()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QGeoTileSegmentStore store(dir.path());
+    QVERIFY(store.open());
+    QVERIFY(store.insert(tile(1), 0, QStringLiteral("png"), payload(1)));
+    store.clear();
+    QCOMPARE(store.tileCount(), 0);
+    QVERIFY(store.insert(tile(2), 0, QStringLiteral("png"), payload(2)));
+    QCOMPARE(store.read(tile(2)), payload(2));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileSegmentStore)
+
+#include "tst_qgeotilesegmentstore.moc"
@@ -59,6 +59,7 @@ private Q_SLOTS:
     void lessThanOperatorTest();
     void qHashTest_data();
     void qHashTest();
+    void qHashSeedTest();
 };
 
 tst_QGeoTileSpec::tst_QGeoTileSpec()
@@ -312,6 +313,20 @@ void tst_QGeoTileSpec::qHashTest()
     QVERIFY(hash2 != hash3);
 }
 
+// A different seed reorders the buckets instead of just renaming them
+void tst_QGeoTileSpec::qHashSeedTest()
+{
+    QSet<uint> differences;
+    for (int x = 0; x < 16; ++x) {
+        for (int y = 0; y < 16; ++y) {
+            const QGeoTileSpec spec(QStringLiteral("seed plugin"), 1, 8, x, y);
+            differences.insert(qHash(spec, 1) ^ qHash(spec, 2));
+            QCOMPARE(qHash(spec, 1), qHash(QGeoTileSpec(spec), 1));
+        }
+    }
+    QVERIFY(differences.size() > 200);
+}
+
 QTEST_APPLESS_MAIN(tst_QGeoTileSpec)
 
 #include "tst_qgeotilespec.moc"
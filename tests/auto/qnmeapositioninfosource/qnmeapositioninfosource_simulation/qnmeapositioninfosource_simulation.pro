@@ -1,6 +1,6 @@
 TEMPLATE = app
 CONFIG+=testcase
-QT += network positioning testlib
+QT += network positioning-private testlib
 TARGET = tst_qnmeapositioninfosource_simulation
 
 INCLUDEPATH += ..
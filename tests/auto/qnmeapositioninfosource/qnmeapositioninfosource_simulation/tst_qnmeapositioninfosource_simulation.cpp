@@ -30,12 +30,206 @@
 
 #include "tst_qnmeapositioninfosource.h"
 
+#include <QtPositioning/private/qnmeapositioninfosource_p.h>
+
 class tst_QNmeaPositionInfoSource_Simulation : public tst_QNmeaPositionInfoSource
 {
     Q_OBJECT
 public:
     tst_QNmeaPositionInfoSource_Simulation()
         : tst_QNmeaPositionInfoSource(QNmeaPositionInfoSource::SimulationMode) {}
+
+private:
+    static QList<QDateTime> recordedDateTimes(int count)
+    {
+        QList<QDateTime> dateTimes;
+        const QDateTime start(QDate(2020, 5, 1), QTime(10, 0), Qt::UTC);
+        for (int i = 0; i < count; ++i)
+            dateTimes << start.addSecs(i);
+        return dateTimes;
+    }
+
+    static QByteArray recordedLog(const QList<QDateTime> &dateTimes)
+    {
+        QByteArray bytes;
+        for (const QDateTime &dt : dateTimes) {
+            bytes += QLocationTestUtils::createRmcSentence(dt).toLatin1();
+            bytes += QLocationTestUtils::createGgaSentence(dt.time()).toLatin1();
+        }
+        return bytes;
+    }
+
+    static QNmeaPositionInfoSourcePrivate *simulation(QNmeaPositionInfoSource &source)
+    {
+        return QNmeaPositionInfoSourcePrivate::get(source);
+    }
+
+private slots:
+    void simulationSpeed()
+    {
+        QNmeaPositionInfoSource source(QNmeaPositionInfoSource::SimulationMode);
+        simulation(source)->setSimulationSpeed(4);
+        QCOMPARE(simulation(source)->simulationSpeed(), qreal(4));
+        simulation(source)->setSimulationSpeed(0);
+        QCOMPARE(simulation(source)->simulationSpeed(), qreal(0));
+
+        QTest::ignoreMessage(QtWarningMsg, "QNmeaPositionInfoSource: the simulation speed cannot be negative");
+        simulation(source)->setSimulationSpeed(-1);
+        QCOMPARE(simulation(source)->simulationSpeed(), qreal(0));
+    }
+
+    void simulationSpeed_scaled()
+    {
+        // 4 seconds of recorded updates
+        const QList<QDateTime> dateTimes = recordedDateTimes(5);
+        QBuffer buffer;
+        buffer.setData(recordedLog(dateTimes));
+
+        QNmeaPositionInfoSource source(QNmeaPositionInfoSource::SimulationMode);
+        QSignalSpy spy(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.setDevice(&buffer);
+        simulation(source)->setSimulationSpeed(20);
+        source.startUpdates();
+
+        QTRY_COMPARE_WITH_TIMEOUT(spy.count(), dateTimes.count(), 2000);
+        for (int i = 0; i < dateTimes.count(); ++i)
+            QCOMPARE(spy.at(i).at(0).value<QGeoPositionInfo>().timestamp(), dateTimes[i]);
+    }
+
+    void simulationSpeed_asFastAsPossible()
+    {
+        // An hour of recorded updates
+        const QList<QDateTime> dateTimes = recordedDateTimes(3600);
+        QBuffer buffer;
+        buffer.setData(recordedLog(dateTimes));
+
+        QNmeaPositionInfoSource source(QNmeaPositionInfoSource::SimulationMode);
+        QSignalSpy spy(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.setDevice(&buffer);
+        simulation(source)->setSimulationSpeed(0);
+        source.startUpdates();
+
+        QTRY_COMPARE(spy.count(), dateTimes.count());
+        QCOMPARE(spy.first().at(0).value<QGeoPositionInfo>().timestamp(), dateTimes.first());
+        QCOMPARE(spy.last().at(0).value<QGeoPositionInfo>().timestamp(), dateTimes.last());
+    }
+
+    void playToEnd_data()
+    {
+        QTest::addColumn<bool>("mapped");
+
+        QTest::newRow("buffer") << false;
+        QTest::newRow("file") << true;
+    }
+
+    void playToEnd()
+    {
+        QFETCH(bool, mapped);
+
+        const QList<QDateTime> dateTimes = recordedDateTimes(200);
+        const QByteArray log = recordedLog(dateTimes.mid(0, 150));
+
+        QBuffer buffer;
+        QTemporaryFile file;
+        if (mapped) {
+            QVERIFY(file.open());
+            QCOMPARE(file.write(log), qint64(log.size()));
+            QVERIFY(file.seek(0));
+        } else {
+            buffer.setData(log);
+            QVERIFY(buffer.open(QIODevice::ReadOnly));
+        }
+        QIODevice *device = mapped ? static_cast<QIODevice *>(&file) : &buffer;
+
+        QNmeaPositionInfoSource source(QNmeaPositionInfoSource::SimulationMode);
+        QSignalSpy spy(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.setDevice(device);
+        simulation(source)->setSimulationSpeed(0);
+        source.startUpdates();
+
+        // The device position follows the replay, so it ends at the end of the data
+        QTRY_COMPARE(spy.count(), 150);
+        for (int i = 0; i < spy.count(); ++i)
+            QCOMPARE(spy.at(i).at(0).value<QGeoPositionInfo>().timestamp(), dateTimes[i]);
+        QCOMPARE(device->pos(), qint64(log.size()));
+        QVERIFY(device->atEnd());
+        QCOMPARE(device->bytesAvailable(), qint64(0));
+
+        // Data arriving after the end is replayed from there on
+        const QByteArray more = recordedLog(dateTimes.mid(150));
+        if (mapped) {
+            QFile appender(file.fileName());
+            QVERIFY(appender.open(QIODevice::Append));
+            QCOMPARE(appender.write(more), qint64(more.size()));
+            appender.close();
+        } else {
+            buffer.buffer().append(more);
+        }
+        emit device->readyRead();
+        QTRY_COMPARE(spy.count(), dateTimes.count());
+        QCOMPARE(spy.last().at(0).value<QGeoPositionInfo>().timestamp(), dateTimes.last());
+        QVERIFY(device->atEnd());
+    }
+
+    void seekSimulation_data()
+    {
+        QTest::addColumn<bool>("mapped");
+
+        QTest::newRow("buffer") << false;
+        QTest::newRow("file") << true;
+    }
+
+    void seekSimulation()
+    {
+        QFETCH(bool, mapped);
+
+        const QList<QDateTime> dateTimes = recordedDateTimes(100);
+        const QByteArray log = recordedLog(dateTimes);
+
+        QBuffer buffer;
+        QTemporaryFile file;
+        if (mapped) {
+            QVERIFY(file.open());
+            QCOMPARE(file.write(log), qint64(log.size()));
+            QVERIFY(file.seek(0));
+        } else {
+            buffer.setData(log);
+        }
+
+        QNmeaPositionInfoSource source(QNmeaPositionInfoSource::SimulationMode);
+        QSignalSpy spy(&source, SIGNAL(positionUpdated(QGeoPositionInfo)));
+        source.setDevice(mapped ? static_cast<QIODevice *>(&file) : &buffer);
+        simulation(source)->setSimulationSpeed(0);
+
+        // Before the updates are started, replay begins at the seeked update
+        QVERIFY(simulation(source)->seekSimulation(dateTimes[60]));
+        source.startUpdates();
+        QTRY_COMPARE(spy.count(), 40);
+        QCOMPARE(spy.first().at(0).value<QGeoPositionInfo>().timestamp(), dateTimes[60]);
+        QCOMPARE(spy.last().at(0).value<QGeoPositionInfo>().timestamp(), dateTimes.last());
+
+        // While updates are active, the seeked update is delivered right away
+        spy.clear();
+        QVERIFY(simulation(source)->seekSimulation(dateTimes[10].addMSecs(500)));
+        QTRY_COMPARE(spy.count(), 90);
+        QCOMPARE(spy.first().at(0).value<QGeoPositionInfo>().timestamp(), dateTimes[10]);
+
+        // Timestamps before the recording start from its first update
+        spy.clear();
+        QVERIFY(simulation(source)->seekSimulation(dateTimes.first().addDays(-1)));
+        QTRY_COMPARE(spy.count(), 100);
+        QCOMPARE(spy.first().at(0).value<QGeoPositionInfo>().timestamp(), dateTimes.first());
+    }
+
+    void seekSimulation_realTime()
+    {
+        QBuffer buffer;
+        buffer.setData(recordedLog(recordedDateTimes(2)));
+
+        QNmeaPositionInfoSource source(QNmeaPositionInfoSource::RealTimeMode);
+        source.setDevice(&buffer);
+        QVERIFY(!simulation(source)->seekSimulation(recordedDateTimes(1).first()));
+    }
 };
 
 #include "tst_qnmeapositioninfosource_simulation.moc"
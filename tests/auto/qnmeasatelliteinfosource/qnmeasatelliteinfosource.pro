@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qnmeasatelliteinfosource
+
+INCLUDEPATH += ../utils
+
+HEADERS += ../utils/qlocationtestutils_p.h
+
+SOURCES += ../utils/qlocationtestutils.cpp \
+           tst_qnmeasatelliteinfosource.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,323 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtPositioning/QNmeaPositionInfoSource>
+#include <QtPositioning/private/qnmeasatelliteinfosource_p.h>
+
+#include "qlocationtestutils_p.h"
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QList<QGeoSatelliteInfo>)
+
+static QByteArray sentence(const char *text)
+{
+    return QLocationTestUtils::addNmeaChecksumAndBreaks(QString::fromLatin1(text)).toLatin1();
+}
+
+static QByteArray gpsSatellites()
+{
+    return sentence("$GPGSV,2,1,07,07,79,048,42,02,51,062,43,26,36,256,42,27,27,138,42*")
+         + sentence("$GPGSV,2,2,07,09,23,313,42,04,19,159,41,15,12,041,42*")
+         + sentence("$GPGSA,A,3,07,02,26,27,09,04,15,,,,,,1.8,1.0,1.5*");
+}
+
+static QByteArray glonassSatellites()
+{
+    return sentence("$GLGSV,1,1,02,65,45,120,38,72,10,300,*")
+         + sentence("$GNGSA,A,3,65,72,,,,,,,,,,,1.8,1.0,1.5*");
+}
+
+static QList<int> identifiers(const QList<QGeoSatelliteInfo> &satellites)
+{
+    QList<int> result;
+    for (const QGeoSatelliteInfo &info : satellites)
+        result << info.satelliteIdentifier();
+    return result;
+}
+
+class tst_QNmeaSatelliteInfoSource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void parseGroup();
+    void parseMissingSentence();
+    void parseInUse();
+    void parseSystems();
+    void parseBadChecksum();
+
+    void realTime();
+    void sharedDevice();
+    void simulation();
+    void requestUpdate();
+};
+
+void tst_QNmeaSatelliteInfoSource::initTestCase()
+{
+    qRegisterMetaType<QList<QGeoSatelliteInfo> >();
+}
+
+void tst_QNmeaSatelliteInfoSource::parseGroup()
+{
+    QNmeaSatelliteParser parser;
+    const QByteArray first = sentence("$GPGSV,2,1,07,07,79,048,42,02,51,062,43,26,36,256,42,27,27,138,42*");
+    const QByteArray second = sentence("$GPGSV,2,2,07,09,23,313,42,04,19,159,41,15,12,041,*");
+
+    QCOMPARE(int(parser.parseSentence(first.constData(), first.size())), int(QNmeaSatelliteParser::NoUpdate));
+    QVERIFY(parser.satellitesInView().isEmpty());
+    QCOMPARE(int(parser.parseSentence(second.constData(), second.size())),
+             int(QNmeaSatelliteParser::SatellitesInViewUpdated));
+
+    const QList<QGeoSatelliteInfo> inView = parser.satellitesInView();
+    QCOMPARE(identifiers(inView), QList<int>() << 7 << 2 << 26 << 27 << 9 << 4 << 15);
+
+    const QGeoSatelliteInfo &info = inView.first();
+    QCOMPARE(info.satelliteSystem(), QGeoSatelliteInfo::GPS);
+    QCOMPARE(info.signalStrength(), 42);
+    QCOMPARE(info.attribute(QGeoSatelliteInfo::Elevation), qreal(79));
+    QCOMPARE(info.attribute(QGeoSatelliteInfo::Azimuth), qreal(48));
+    QCOMPARE(inView.last().signalStrength(), -1);
+
+    // The next group replaces the previous one once it is complete
+    const QByteArray single = sentence("$GPGSV,1,1,01,12,10,100,30*");
+    QCOMPARE(int(parser.parseSentence(single.constData(), single.size())),
+             int(QNmeaSatelliteParser::SatellitesInViewUpdated));
+    QCOMPARE(identifiers(parser.satellitesInView()), QList<int>() << 12);
+
+    const QByteArray none = sentence("$GPGSV,1,1,00*");
+    QCOMPARE(int(parser.parseSentence(none.constData(), none.size())),
+             int(QNmeaSatelliteParser::SatellitesInViewUpdated));
+    QVERIFY(parser.satellitesInView().isEmpty());
+}
+
+void tst_QNmeaSatelliteInfoSource::parseMissingSentence()
+{
+    QNmeaSatelliteParser parser;
+    const QByteArray first = sentence("$GPGSV,3,1,09,07,79,048,42,02,51,062,43,26,36,256,42,27,27,138,42*");
+    const QByteArray third = sentence("$GPGSV,3,3,09,30,05,020,*");
+
+    QCOMPARE(int(parser.parseSentence(first.constData(), first.size())), int(QNmeaSatelliteParser::NoUpdate));
+    QCOMPARE(int(parser.parseSentence(third.constData(), third.size())), int(QNmeaSatelliteParser::NoUpdate));
+    QVERIFY(parser.satellitesInView().isEmpty());
+}
+
+void tst_QNmeaSatelliteInfoSource::parseInUse()
+{
+    QNmeaSatelliteParser parser;
+    const QByteArray data = gpsSatellites();
+    QNmeaSatelliteParser::Updates updates;
+    for (const QByteArray &line : data.split('\n')) {
+        if (!line.isEmpty())
+            updates |= parser.parseSentence(line.constData(), line.size());
+    }
+    QCOMPARE(int(updates), int(QNmeaSatelliteParser::SatellitesInViewUpdated
+                               | QNmeaSatelliteParser::SatellitesInUseUpdated));
+
+    const QList<QGeoSatelliteInfo> inUse = parser.satellitesInUse();
+    QCOMPARE(identifiers(inUse), QList<int>() << 7 << 2 << 26 << 27 << 9 << 4 << 15);
+    // Details are taken from the satellites in view
+    QCOMPARE(inUse.at(1).signalStrength(), 43);
+    QCOMPARE(inUse.at(1).attribute(QGeoSatelliteInfo::Elevation), qreal(51));
+
+    // Satellites in use that are not in view are still reported
+    const QByteArray gsa = sentence("$GPGSA,A,3,07,31,,,,,,,,,,,1.8,1.0,1.5*");
+    parser.parseSentence(gsa.constData(), gsa.size());
+    const QList<QGeoSatelliteInfo> updated = parser.satellitesInUse();
+    QCOMPARE(identifiers(updated), QList<int>() << 7 << 31);
+    QCOMPARE(updated.at(1).signalStrength(), -1);
+    QVERIFY(!updated.at(1).hasAttribute(QGeoSatelliteInfo::Elevation));
+}
+
+void tst_QNmeaSatelliteInfoSource::parseSystems()
+{
+    QNmeaSatelliteParser parser;
+    const QByteArray data = gpsSatellites() + glonassSatellites();
+    for (const QByteArray &line : data.split('\n')) {
+        if (!line.isEmpty())
+            parser.parseSentence(line.constData(), line.size());
+    }
+
+    const QList<QGeoSatelliteInfo> inView = parser.satellitesInView();
+    QCOMPARE(inView.count(), 9);
+    QCOMPARE(inView.at(7).satelliteIdentifier(), 65);
+    QCOMPARE(inView.at(7).satelliteSystem(), QGeoSatelliteInfo::GLONASS);
+
+    // The combined GSA does not replace the GPS satellites in use
+    const QList<QGeoSatelliteInfo> inUse = parser.satellitesInUse();
+    QCOMPARE(identifiers(inUse), QList<int>() << 7 << 2 << 26 << 27 << 9 << 4 << 15 << 65 << 72);
+    QCOMPARE(inUse.at(7).satelliteSystem(), QGeoSatelliteInfo::GLONASS);
+    QCOMPARE(inUse.at(7).signalStrength(), 38);
+}
+
+void tst_QNmeaSatelliteInfoSource::parseBadChecksum()
+{
+    QNmeaSatelliteParser parser;
+    QByteArray data = sentence("$GPGSV,1,1,01,12,10,100,30*");
+    data[data.indexOf('*') - 1] = '1';
+    QCOMPARE(int(parser.parseSentence(data.constData(), data.size())), int(QNmeaSatelliteParser::NoUpdate));
+
+    // Position sentences are ignored
+    const QByteArray rmc = QLocationTestUtils::createRmcSentence(QDateTime::currentDateTimeUtc()).toLatin1();
+    QCOMPARE(int(parser.parseSentence(rmc.constData(), rmc.size())), int(QNmeaSatelliteParser::NoUpdate));
+}
+
+void tst_QNmeaSatelliteInfoSource::realTime()
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QNmeaSatelliteInfoSource source(QNmeaSatelliteInfoSource::RealTimeMode);
+    QCOMPARE(source.updateMode(), QNmeaSatelliteInfoSource::RealTimeMode);
+    source.setDevice(&buffer);
+    QCOMPARE(source.device(), &buffer);
+
+    QSignalSpy spyInView(&source, SIGNAL(satellitesInViewUpdated(QList<QGeoSatelliteInfo>)));
+    QSignalSpy spyInUse(&source, SIGNAL(satellitesInUseUpdated(QList<QGeoSatelliteInfo>)));
+    source.startUpdates();
+
+    data.append(gpsSatellites());
+    emit buffer.readyRead();
+    QCOMPARE(spyInView.count(), 1);
+    QCOMPARE(spyInUse.count(), 1);
+    QCOMPARE(spyInView.at(0).at(0).value<QList<QGeoSatelliteInfo> >().count(), 7);
+
+    source.stopUpdates();
+    data.append(gpsSatellites());
+    emit buffer.readyRead();
+    QCOMPARE(spyInView.count(), 1);
+}
+
+void tst_QNmeaSatelliteInfoSource::sharedDevice()
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QNmeaPositionInfoSource positionSource(QNmeaPositionInfoSource::RealTimeMode);
+    positionSource.setUserEquivalentRangeError(5.1);
+    positionSource.setDevice(&buffer);
+    QNmeaSatelliteInfoSource source(&positionSource);
+    QCOMPARE(source.positionInfoSource(), &positionSource);
+    QCOMPARE(source.device(), &buffer);
+
+    QSignalSpy spyPosition(&positionSource, SIGNAL(positionUpdated(QGeoPositionInfo)));
+    QSignalSpy spyInView(&source, SIGNAL(satellitesInViewUpdated(QList<QGeoSatelliteInfo>)));
+    QSignalSpy spyInUse(&source, SIGNAL(satellitesInUseUpdated(QList<QGeoSatelliteInfo>)));
+    positionSource.startUpdates();
+    source.startUpdates();
+
+    const QDateTime dt = QDateTime::currentDateTimeUtc();
+    data.append(QLocationTestUtils::createRmcSentence(dt).toLatin1());
+    data.append(gpsSatellites());
+    emit buffer.readyRead();
+
+    QCOMPARE(spyInView.count(), 1);
+    QCOMPARE(spyInUse.count(), 1);
+    QTRY_COMPARE(spyPosition.count(), 1);
+    // The GSA read for the satellites was merged into the position as well
+    const QGeoPositionInfo info = spyPosition.at(0).at(0).value<QGeoPositionInfo>();
+    QCOMPARE(info.timestamp(), dt);
+    QVERIFY(qFuzzyCompare(info.attribute(QGeoPositionInfo::HorizontalAccuracy), 2 * 1.0 * 5.1));
+    QCOMPARE(buffer.bytesAvailable(), qint64(0));
+}
+
+void tst_QNmeaSatelliteInfoSource::simulation()
+{
+    const QDateTime dt(QDate(2019, 3, 15), QTime(6, 0), Qt::UTC);
+    QByteArray data = QLocationTestUtils::createRmcSentence(dt).toLatin1();
+    data += gpsSatellites();
+    data += QLocationTestUtils::createRmcSentence(dt.addMSecs(200)).toLatin1();
+    data += gpsSatellites() + glonassSatellites();
+    QBuffer buffer(&data);
+
+    QNmeaSatelliteInfoSource source(QNmeaSatelliteInfoSource::SimulationMode);
+    QCOMPARE(source.updateMode(), QNmeaSatelliteInfoSource::SimulationMode);
+    source.setDevice(&buffer);
+
+    QSignalSpy spyInView(&source, SIGNAL(satellitesInViewUpdated(QList<QGeoSatelliteInfo>)));
+    QElapsedTimer timer;
+    timer.start();
+    source.startUpdates();
+
+    // The satellites are replayed along with the position they were recorded with
+    QCOMPARE(spyInView.count(), 1);
+    QCOMPARE(spyInView.at(0).at(0).value<QList<QGeoSatelliteInfo> >().count(), 7);
+    QTRY_COMPARE(spyInView.count(), 2);
+    QVERIFY(timer.elapsed() >= 150);
+    QCOMPARE(spyInView.at(1).at(0).value<QList<QGeoSatelliteInfo> >().count(), 9);
+}
+
+void tst_QNmeaSatelliteInfoSource::requestUpdate()
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QNmeaSatelliteInfoSource source(QNmeaSatelliteInfoSource::RealTimeMode);
+    source.setDevice(&buffer);
+
+    QSignalSpy spyInView(&source, SIGNAL(satellitesInViewUpdated(QList<QGeoSatelliteInfo>)));
+    QSignalSpy spyTimeout(&source, SIGNAL(requestTimeout()));
+
+    source.requestUpdate(-1);
+    QTRY_COMPARE(spyTimeout.count(), 1);
+
+    source.requestUpdate(100);
+    QTRY_COMPARE(spyTimeout.count(), 2);
+    QCOMPARE(spyInView.count(), 0);
+
+    source.requestUpdate(5000);
+    data.append(sentence("$GPGSV,1,1,01,12,10,100,30*"));
+    emit buffer.readyRead();
+    QCOMPARE(spyInView.count(), 1);
+
+    QGeoSatelliteInfo expected;
+    expected.setSatelliteIdentifier(12);
+    expected.setSatelliteSystem(QGeoSatelliteInfo::GPS);
+    expected.setSignalStrength(30);
+    expected.setAttribute(QGeoSatelliteInfo::Elevation, 10);
+    expected.setAttribute(QGeoSatelliteInfo::Azimuth, 100);
+    QCOMPARE(spyInView.at(0).at(0).value<QList<QGeoSatelliteInfo> >(),
+             QList<QGeoSatelliteInfo>() << expected);
+
+    // Only a single update is delivered
+    data.append(sentence("$GPGSV,1,1,01,12,10,100,30*"));
+    emit buffer.readyRead();
+    QCOMPARE(spyInView.count(), 1);
+    QCOMPARE(spyTimeout.count(), 2);
+}
+
+QTEST_GUILESS_MAIN(tst_QNmeaSatelliteInfoSource)
+
+#include "tst_qnmeasatelliteinfosource.moc"
@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qnmeatokenizer
+
+INCLUDEPATH += ../utils
+
+HEADERS += ../utils/qlocationtestutils_p.h
+
+SOURCES += ../utils/qlocationtestutils.cpp \
+           tst_qnmeatokenizer.cpp
+
+QT += positioning-private testlib
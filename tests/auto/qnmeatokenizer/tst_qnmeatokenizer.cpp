@@ -0,0 +1,448 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/private/qnmeatokenizer_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+
+#include "qlocationtestutils_p.h"
+
+#include <cmath>
+#include <math.h>
+
+QT_USE_NAMESPACE
+
+// The conversions used before the tokenizer, kept as the reference
+static bool referenceDegrees(const QByteArray &bytes, double *degrees)
+{
+    bool ok = false;
+    const double value = bytes.toDouble(&ok);
+    if (!ok)
+        return false;
+    double deg;
+    const double min = 100.0 * modf(value / 100.0, &deg);
+    *degrees = deg + (min / 60.0);
+    return true;
+}
+
+static bool referenceLatLong(const QByteArray &latString, char latDirection,
+                             const QByteArray &lngString, char lngDirection,
+                             double *lat, double *lng)
+{
+    if ((latDirection != 'N' && latDirection != 'S')
+            || (lngDirection != 'E' && lngDirection != 'W')) {
+        return false;
+    }
+
+    bool hasLat = false;
+    bool hasLong = false;
+    double tempLat = latString.toDouble(&hasLat);
+    double tempLng = lngString.toDouble(&hasLong);
+    if (!hasLat || !hasLong)
+        return false;
+
+    double deg;
+    double min = 100.0 * modf(tempLat / 100.0, &deg);
+    tempLat = deg + (min / 60.0);
+    if (latDirection == 'S')
+        tempLat *= -1;
+    min = 100.0 * modf(tempLng / 100.0, &deg);
+    tempLng = deg + (min / 60.0);
+    if (lngDirection == 'W')
+        tempLng *= -1;
+
+    if (!QLocationUtils::isValidLat(tempLat) || !QLocationUtils::isValidLong(tempLng))
+        return false;
+    *lat = tempLat;
+    *lng = tempLng;
+    return true;
+}
+
+static bool referenceTime(const QByteArray &bytes, QTime *time)
+{
+    int dotIndex = bytes.indexOf('.');
+    QTime tempTime;
+
+    if (dotIndex < 0) {
+        tempTime = QTime::fromString(QString::fromLatin1(bytes), QStringLiteral("hhmmss"));
+    } else {
+        tempTime = QTime::fromString(QString::fromLatin1(bytes.mid(0, dotIndex)),
+                                     QStringLiteral("hhmmss"));
+        bool hasMsecs = false;
+        int midLen = qMin(3, bytes.size() - dotIndex - 1);
+        int msecs = bytes.mid(dotIndex + 1, midLen).toUInt(&hasMsecs);
+        if (hasMsecs)
+            tempTime = tempTime.addMSecs(msecs*(midLen == 3 ? 1 : midLen == 2 ? 10 : 100));
+    }
+
+    if (tempTime.isValid()) {
+        *time = tempTime;
+        return true;
+    }
+    return false;
+}
+
+static QNmeaField field(const QByteArray &bytes)
+{
+    return QNmeaField(bytes.constData(), bytes.size());
+}
+
+class tst_QNmeaTokenizer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tokenize_data();
+    void tokenize();
+    void tooManyFields();
+    void numbers_data();
+    void numbers();
+    void degrees_data();
+    void degrees();
+    void latLong_data();
+    void latLong();
+    void time_data();
+    void time();
+    void date_data();
+    void date();
+    void checksum();
+    void sentences_data();
+    void sentences();
+};
+
+void tst_QNmeaTokenizer::tokenize_data()
+{
+    QTest::addColumn<QByteArray>("sentence");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("comma") << QByteArray(",");
+    QTest::newRow("trailing comma") << QByteArray("$GPGSA,A,3,");
+    QTest::newRow("empty fields") << QByteArray("$GPGSA,A,3,,,,,,,,,,,,,3.0,3.5,4.0");
+    QTest::newRow("gga") << QByteArray("$GPGGA,060613.626,2734.76859,S,15305.99361,E,1,04,3.5,49.4,M,39.2,M,,");
+}
+
+void tst_QNmeaTokenizer::tokenize()
+{
+    QFETCH(QByteArray, sentence);
+
+    const QList<QByteArray> parts = sentence.split(',');
+    const QNmeaTokenizer tokenizer(sentence.constData(), sentence.size());
+
+    QCOMPARE(tokenizer.count(), parts.count());
+    for (int i = 0; i < parts.count(); ++i)
+        QCOMPARE(tokenizer[i].toByteArray(), parts.at(i));
+    QVERIFY(tokenizer[-1].isEmpty());
+    QVERIFY(tokenizer[parts.count()].isEmpty());
+}
+
+void tst_QNmeaTokenizer::tooManyFields()
+{
+    QByteArray sentence("$GPXXX");
+    for (int i = 0; i < QNmeaTokenizer::MaxFields + 10; ++i)
+        sentence += ',' + QByteArray::number(i);
+
+    const QNmeaTokenizer tokenizer(sentence.constData(), sentence.size());
+    QCOMPARE(tokenizer.count(), int(QNmeaTokenizer::MaxFields));
+    QCOMPARE(tokenizer[0].toByteArray(), QByteArray("$GPXXX"));
+    const int last = QNmeaTokenizer::MaxFields - 1;
+    QCOMPARE(tokenizer[last].toByteArray(), QByteArray::number(last - 1));
+}
+
+void tst_QNmeaTokenizer::numbers_data()
+{
+    QTest::addColumn<QByteArray>("bytes");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("zero") << QByteArray("0");
+    QTest::newRow("negative zero") << QByteArray("-0.0");
+    QTest::newRow("integer") << QByteArray("49");
+    QTest::newRow("signed") << QByteArray("+12");
+    QTest::newRow("decimal") << QByteArray("49.4");
+    QTest::newRow("negative") << QByteArray("-39.25");
+    QTest::newRow("leading dot") << QByteArray(".5");
+    QTest::newRow("trailing dot") << QByteArray("300.");
+    QTest::newRow("precise") << QByteArray("15301.8784412345");
+    QTest::newRow("16 digits") << QByteArray("1234567890.123456");
+    QTest::newRow("long integer") << QByteArray("12345678901234567890");
+    QTest::newRow("exponent") << QByteArray("1.5e3");
+    QTest::newRow("dot") << QByteArray(".");
+    QTest::newRow("sign") << QByteArray("-");
+    QTest::newRow("two dots") << QByteArray("1.2.3");
+    QTest::newRow("letters") << QByteArray("A");
+    QTest::newRow("spaces") << QByteArray(" 12 ");
+}
+
+void tst_QNmeaTokenizer::numbers()
+{
+    QFETCH(QByteArray, bytes);
+
+    bool ok = false;
+    bool expectedOk = false;
+    const double d = field(bytes).toDouble(&ok);
+    const double expectedD = bytes.toDouble(&expectedOk);
+    QCOMPARE(ok, expectedOk);
+    if (ok) {
+        // Identical, not just fuzzy equal
+        QVERIFY(d == expectedD);
+        QCOMPARE(std::signbit(d), std::signbit(expectedD));
+    }
+
+    const int i = field(bytes).toInt(&ok);
+    const int expectedI = bytes.toInt(&expectedOk);
+    QCOMPARE(ok, expectedOk);
+    QCOMPARE(i, expectedI);
+
+    const uint u = field(bytes).toUInt(&ok);
+    const uint expectedU = bytes.toUInt(&expectedOk);
+    QCOMPARE(ok, expectedOk);
+    QCOMPARE(u, expectedU);
+}
+
+void tst_QNmeaTokenizer::degrees_data()
+{
+    QTest::addColumn<QByteArray>("bytes");
+
+    QTest::newRow("latitude") << QByteArray("2730.83609");
+    QTest::newRow("longitude") << QByteArray("15301.87844");
+    QTest::newRow("whole minutes") << QByteArray("2700.00000");
+    QTest::newRow("trailing dot") << QByteArray("15300.");
+    QTest::newRow("no dot") << QByteArray("4916");
+    QTest::newRow("leading dot") << QByteArray(".5");
+    QTest::newRow("minutes only") << QByteArray("0059.99999");
+    QTest::newRow("one decimal") << QByteArray("18000.0");
+    QTest::newRow("many decimals") << QByteArray("2730.83609123456789");
+    QTest::newRow("negative") << QByteArray("-2730.5");
+    QTest::newRow("exponent") << QByteArray("2.73083609e3");
+    QTest::newRow("garbage") << QByteArray("27x0.8");
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("dot") << QByteArray(".");
+
+    // Every whole degree with minutes exercising all digits of the fraction
+    for (int deg = 1; deg <= 180; ++deg) {
+        const double minutes = std::fmod(deg * 7.123457, 60.0);
+        const QByteArray bytes = QByteArray::number(deg * 100 + minutes, 'f', 5);
+        QTest::newRow(bytes.constData()) << bytes;
+    }
+}
+
+// The fixed point conversion in toDegrees() against the modf based one it replaced
+void tst_QNmeaTokenizer::degrees()
+{
+    QFETCH(QByteArray, bytes);
+
+    double expected = 0.0;
+    const bool expectedOk = referenceDegrees(bytes, &expected);
+
+    double result = 0.0;
+    QCOMPARE(field(bytes).toDegrees(&result), expectedOk);
+    if (!expectedOk)
+        return;
+    if (qFuzzyIsNull(expected))
+        QVERIFY(qFuzzyIsNull(result));
+    else
+        QVERIFY2(qFuzzyCompare(result, expected),
+                 qPrintable(QString::number(result, 'g', 17) + QLatin1String(" != ")
+                            + QString::number(expected, 'g', 17)));
+}
+
+void tst_QNmeaTokenizer::latLong_data()
+{
+    QTest::addColumn<QByteArray>("lat");
+    QTest::addColumn<char>("latDirection");
+    QTest::addColumn<QByteArray>("lng");
+    QTest::addColumn<char>("lngDirection");
+
+    QTest::newRow("rmc") << QByteArray("2730.83609") << 'S' << QByteArray("15301.87844") << 'E';
+    QTest::newRow("gga") << QByteArray("2734.76859") << 'N' << QByteArray("15305.99361") << 'W';
+    QTest::newRow("whole degrees") << QByteArray("2700.00000") << 'S' << QByteArray("15300.") << 'E';
+    QTest::newRow("no fraction") << QByteArray("0000") << 'N' << QByteArray("00000") << 'E';
+    QTest::newRow("limits") << QByteArray("9000.0") << 'S' << QByteArray("18000.0") << 'W';
+    QTest::newRow("invalid lat") << QByteArray("9100.0") << 'N' << QByteArray("100.0") << 'E';
+    QTest::newRow("invalid long") << QByteArray("100.0") << 'N' << QByteArray("18100.0") << 'E';
+    QTest::newRow("bad direction") << QByteArray("2730.83609") << 'E' << QByteArray("15301.87844") << 'E';
+    QTest::newRow("empty") << QByteArray() << 'N' << QByteArray("15301.87844") << 'E';
+    QTest::newRow("garbage") << QByteArray("27x0.8") << 'N' << QByteArray("15301.87844") << 'E';
+    QTest::newRow("negative") << QByteArray("-2730.5") << 'N' << QByteArray("15301.87844") << 'E';
+    QTest::newRow("many decimals") << QByteArray("2730.83609123456789") << 'N'
+                                   << QByteArray("15301.87844") << 'E';
+}
+
+void tst_QNmeaTokenizer::latLong()
+{
+    QFETCH(QByteArray, lat);
+    QFETCH(char, latDirection);
+    QFETCH(QByteArray, lng);
+    QFETCH(char, lngDirection);
+
+    double expectedLat = 0.0;
+    double expectedLng = 0.0;
+    const bool expectedOk = referenceLatLong(lat, latDirection, lng, lngDirection,
+                                             &expectedLat, &expectedLng);
+
+    double resultLat = 0.0;
+    double resultLng = 0.0;
+    QCOMPARE(QLocationUtils::getNmeaLatLong(lat, latDirection, lng, lngDirection,
+                                            &resultLat, &resultLng), expectedOk);
+    if (expectedOk) {
+        // The fixed point conversion may differ in the last bit
+        QVERIFY(qAbs(resultLat - expectedLat) < 1e-12);
+        QVERIFY(qAbs(resultLng - expectedLng) < 1e-12);
+    }
+}
+
+void tst_QNmeaTokenizer::time_data()
+{
+    QTest::addColumn<QByteArray>("bytes");
+
+    QTest::newRow("seconds") << QByteArray("060613");
+    QTest::newRow("msecs") << QByteArray("060613.626");
+    QTest::newRow("centisecs") << QByteArray("235959.99");
+    QTest::newRow("decisecs") << QByteArray("000000.5");
+    QTest::newRow("more digits") << QByteArray("123456.7891");
+    QTest::newRow("trailing dot") << QByteArray("123456.");
+    QTest::newRow("bad msecs") << QByteArray("123456.a");
+    QTest::newRow("bad hour") << QByteArray("243456");
+    QTest::newRow("bad minute") << QByteArray("126000.000");
+    QTest::newRow("short") << QByteArray("12345");
+    QTest::newRow("long") << QByteArray("1234567");
+    QTest::newRow("letters") << QByteArray("12ab56");
+    QTest::newRow("empty") << QByteArray();
+}
+
+void tst_QNmeaTokenizer::time()
+{
+    QFETCH(QByteArray, bytes);
+
+    QTime expected;
+    const bool expectedOk = referenceTime(bytes, &expected);
+
+    QTime result;
+    QCOMPARE(QLocationUtils::getNmeaTime(bytes, &result), expectedOk);
+    QCOMPARE(result, expected);
+}
+
+void tst_QNmeaTokenizer::date_data()
+{
+    QTest::addColumn<QByteArray>("bytes");
+
+    QTest::newRow("date") << QByteArray("150319");
+    QTest::newRow("y2k") << QByteArray("010100");
+    QTest::newRow("leap day") << QByteArray("290204");
+    // Validated against 1900, which is not a leap year
+    QTest::newRow("leap day 2000") << QByteArray("290200");
+    QTest::newRow("bad day") << QByteArray("320119");
+    QTest::newRow("bad month") << QByteArray("011319");
+    QTest::newRow("letters") << QByteArray("01a119");
+}
+
+void tst_QNmeaTokenizer::date()
+{
+    QFETCH(QByteArray, bytes);
+
+    QDate expected = QDate::fromString(QString::fromLatin1(bytes), QStringLiteral("ddMMyy"));
+    if (expected.isValid())
+        expected = expected.addYears(100);
+
+    QDate result;
+    QCOMPARE(field(bytes).toDate(&result), expected.isValid());
+    QCOMPARE(result, expected);
+}
+
+void tst_QNmeaTokenizer::checksum()
+{
+    const QByteArray sentence = QLocationTestUtils::createGsaSentence().toLatin1();
+    QVERIFY(QLocationUtils::hasValidNmeaChecksum(sentence.constData(), sentence.size()));
+    QVERIFY(QLocationUtils::hasValidNmeaChecksum(sentence.toUpper().constData(), sentence.size()));
+
+    QByteArray broken = sentence;
+    broken[broken.indexOf('*') + 1] = 'g';
+    QVERIFY(!QLocationUtils::hasValidNmeaChecksum(broken.constData(), broken.size()));
+
+    broken = sentence;
+    broken[1] = 'X';
+    QVERIFY(!QLocationUtils::hasValidNmeaChecksum(broken.constData(), broken.size()));
+}
+
+void tst_QNmeaTokenizer::sentences_data()
+{
+    QTest::addColumn<QByteArray>("sentence");
+    QTest::addColumn<QGeoPositionInfo>("expected");
+    QTest::addColumn<bool>("expectedFix");
+
+    const QDateTime dt(QDate(2019, 3, 15), QTime(6, 6, 13, 626), Qt::UTC);
+    const double uere = 5.1;
+
+    QGeoPositionInfo info;
+    info.setTimestamp(dt);
+    info.setCoordinate(QGeoCoordinate(-(27 + 30.83609 / 60), 153 + 1.87844 / 60));
+    info.setAttribute(QGeoPositionInfo::GroundSpeed, 0.7 * 1.852 / 3.6);
+    info.setAttribute(QGeoPositionInfo::Direction, 9.0);
+    info.setAttribute(QGeoPositionInfo::MagneticVariation, -11.2);
+    QTest::newRow("rmc") << QLocationTestUtils::createRmcSentence(dt).toLatin1() << info << true;
+
+    info = QGeoPositionInfo();
+    info.setTimestamp(QDateTime(QDate(), dt.time(), Qt::UTC));
+    info.setCoordinate(QGeoCoordinate(-(27 + 34.76859 / 60), 153 + 5.99361 / 60, 49.4));
+    info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * 3.5 * uere);
+    QTest::newRow("gga") << QLocationTestUtils::createGgaSentence(dt.time()).toLatin1() << info << true;
+
+    info = QGeoPositionInfo();
+    info.setTimestamp(QDateTime(QDate(), dt.time(), Qt::UTC));
+    info.setCoordinate(QGeoCoordinate(-20, 130, 49.4));
+    info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * 3.5 * uere);
+    QTest::newRow("gga whole degrees")
+            << QLocationTestUtils::createGgaSentence(20, 130, dt.time()).toLatin1() << info << true;
+
+    info = QGeoPositionInfo();
+    info.setTimestamp(dt);
+    QTest::newRow("zda") << QLocationTestUtils::createZdaSentence(dt).toLatin1() << info << false;
+
+    info = QGeoPositionInfo();
+    info.setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * 3.5 * uere);
+    info.setAttribute(QGeoPositionInfo::VerticalAccuracy, 2 * 4.0 * uere);
+    QTest::newRow("gsa") << QLocationTestUtils::createGsaSentence().toLatin1() << info << true;
+}
+
+void tst_QNmeaTokenizer::sentences()
+{
+    QFETCH(QByteArray, sentence);
+    QFETCH(QGeoPositionInfo, expected);
+    QFETCH(bool, expectedFix);
+
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(sentence.constData(), sentence.size(),
+                                               &info, 5.1, &hasFix));
+    QCOMPARE(hasFix, expectedFix);
+    QCOMPARE(info, expected);
+}
+
+QTEST_APPLESS_MAIN(tst_QNmeaTokenizer)
+
+#include "tst_qnmeatokenizer.moc"
@@ -0,0 +1,25 @@
+TEMPLATE = subdirs
+
+# Results can be written in a machine readable format for tracking, e.g.
+#   make benchmark TESTARGS="-o results.xml,xml"
+# writes results.xml next to each benchmark.
+
+qtHaveModule(location) {
+    SUBDIRS += qgeotilespec \
+               qcache3q \
+               qgeocameratiles \
+               qgeofiletilecache \
+               qgeorouteparser \
+               qgeoprojection \
+               qgeosimplifiedpath
+
+    # These use the test plugin from tests/auto
+    !android: SUBDIRS += qgeotilerequestmanager
+
+    qtHaveModule(quick) {
+        SUBDIRS += qgeotiledmapscene
+        !android: SUBDIRS += qgeomapobjectqsgsupport
+    }
+}
+
+qtHaveModule(positioning): SUBDIRS += qgeoareamonitor qgeocoordinatebatch qnmeapositioninfosource
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qcache3q
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_bench_qcache3q.cpp
+
+QT += location-private testlib
@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "qcache3q_p.h"
+#include "qgeotilespec_p.h"
+
+QT_USE_NAMESPACE
+
+struct BenchTile
+{
+    int payload;
+};
+
+typedef QCache3Q<QGeoTileSpec, BenchTile> BenchCache;
+
+static QVector<QGeoTileSpec> tileWindow(int size)
+{
+    QVector<QGeoTileSpec> tiles;
+    tiles.reserve(size * size);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            tiles.append(QGeoTileSpec(QStringLiteral("bench"), 1, 16, 30000 + x, 20000 + y));
+    return tiles;
+}
+
+class tst_QCache3QBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void insert_data();
+    void insert();
+    void lookup_data();
+    void lookup();
+    void evict_data();
+    void evict();
+
+private:
+    void populateSizes();
+};
+
+void tst_QCache3QBenchmark::populateSizes()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("16x16") << 16;
+    QTest::newRow("64x64") << 64;
+}
+
+void tst_QCache3QBenchmark::insert_data()
+{
+    populateSizes();
+}
+
+// Fills an empty cache large enough to hold every tile
+void tst_QCache3QBenchmark::insert()
+{
+    QFETCH(int, size);
+
+    const QVector<QGeoTileSpec> tiles = tileWindow(size);
+    QSharedPointer<BenchTile> value(new BenchTile{0});
+
+    QBENCHMARK {
+        BenchCache cache(tiles.size());
+        for (const QGeoTileSpec &spec : tiles)
+            cache.insert(spec, value, 1);
+        QCOMPARE(cache.totalCost(), tiles.size());
+    }
+}
+
+void tst_QCache3QBenchmark::lookup_data()
+{
+    populateSizes();
+}
+
+// Looks up every tile of a full cache, half of the lookups miss
+void tst_QCache3QBenchmark::lookup()
+{
+    QFETCH(int, size);
+
+    const QVector<QGeoTileSpec> tiles = tileWindow(size);
+    QSharedPointer<BenchTile> value(new BenchTile{0});
+    BenchCache cache(tiles.size());
+    for (int i = 0; i < tiles.size(); i += 2)
+        cache.insert(tiles.at(i), value, 1);
+
+    QBENCHMARK {
+        int hits = 0;
+        for (const QGeoTileSpec &spec : tiles) {
+            if (cache.object(spec))
+                ++hits;
+        }
+        QCOMPARE(hits, (tiles.size() + 1) / 2);
+    }
+}
+
+void tst_QCache3QBenchmark::evict_data()
+{
+    populateSizes();
+}
+
+// Streams tiles through a cache a quarter of their number in size, as a long
+// pan does, so that nearly every insertion evicts a tile
+void tst_QCache3QBenchmark::evict()
+{
+    QFETCH(int, size);
+
+    const QVector<QGeoTileSpec> tiles = tileWindow(size);
+    QSharedPointer<BenchTile> value(new BenchTile{0});
+    BenchCache cache(tiles.size() / 4);
+
+    QBENCHMARK {
+        for (const QGeoTileSpec &spec : tiles)
+            cache.insert(spec, value, 1);
+        QVERIFY(cache.totalCost() <= cache.maxCost());
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QCache3QBenchmark)
+
+#include "tst_bench_qcache3q.moc"
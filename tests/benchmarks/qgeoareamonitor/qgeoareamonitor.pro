@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeoareamonitor
+
+SOURCES += tst_bench_qgeoareamonitor.cpp
+
+QT += positioning testlib
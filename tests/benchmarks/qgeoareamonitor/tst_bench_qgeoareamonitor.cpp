@@ -0,0 +1,215 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoAreaMonitorInfo>
+#include <QtPositioning/QGeoAreaMonitorSource>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPositionInfoSource>
+#include <QtPositioning/QGeoRectangle>
+
+QT_USE_NAMESPACE
+
+// Position source whose updates are pushed synchronously by the benchmark
+class BenchPositionSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+public:
+    explicit BenchPositionSource(QObject *parent = nullptr) : QGeoPositionInfoSource(parent) {}
+
+    QGeoPositionInfo lastKnownPosition(bool = false) const override { return m_last; }
+    PositioningMethods supportedPositioningMethods() const override { return AllPositioningMethods; }
+    int minimumUpdateInterval() const override { return 0; }
+    Error error() const override { return NoError; }
+
+    void startUpdates() override {}
+    void stopUpdates() override {}
+    void requestUpdate(int = 0) override {}
+
+    void push(const QGeoPositionInfo &info)
+    {
+        m_last = info;
+        emit positionUpdated(info);
+    }
+
+private:
+    QGeoPositionInfo m_last;
+};
+
+class tst_QGeoAreaMonitorBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void positionUpdated_data();
+    void positionUpdated();
+    void startStopMonitoring_data();
+    void startStopMonitoring();
+
+private:
+    static QList<QGeoAreaMonitorInfo> fences(int count, bool expiring);
+    static QList<QGeoPositionInfo> track(int count);
+    void populate_data();
+
+    QGeoAreaMonitorSource *m_monitor = nullptr;
+    BenchPositionSource *m_source = nullptr;
+};
+
+// Deterministic pseudo random numbers in [0, 1)
+static double nextRandom(quint32 *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (*state >> 8) / double(1 << 24);
+}
+
+// Depot and delivery zone like fences scattered over a 10 x 10 degree region,
+// half of them circles of 200 m to 2 km, half rectangles of up to 3 km
+QList<QGeoAreaMonitorInfo> tst_QGeoAreaMonitorBenchmark::fences(int count, bool expiring)
+{
+    quint32 state = 1;
+    const QDateTime now = QDateTime::currentDateTime();
+    QList<QGeoAreaMonitorInfo> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QGeoCoordinate center(40.0 + 10.0 * nextRandom(&state), 5.0 + 10.0 * nextRandom(&state));
+        QGeoAreaMonitorInfo info(QString::number(i));
+        if (i % 2)
+            info.setArea(QGeoCircle(center, 200.0 + 1800.0 * nextRandom(&state)));
+        else
+            info.setArea(QGeoRectangle(center, 0.005 + 0.025 * nextRandom(&state),
+                                       0.005 + 0.025 * nextRandom(&state)));
+        if (expiring)
+            info.setExpiration(now.addSecs(3600 + int(3600 * nextRandom(&state))));
+        result.append(info);
+    }
+    return result;
+}
+
+// A random walk through the fenced region in steps of about 500 m
+QList<QGeoPositionInfo> tst_QGeoAreaMonitorBenchmark::track(int count)
+{
+    quint32 state = 2;
+    const QDateTime start = QDateTime::currentDateTime();
+    QGeoCoordinate coordinate(45.0, 10.0);
+    QList<QGeoPositionInfo> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        coordinate = coordinate.atDistanceAndAzimuth(500.0, 360.0 * nextRandom(&state));
+        result.append(QGeoPositionInfo(coordinate, start.addSecs(i)));
+    }
+    return result;
+}
+
+void tst_QGeoAreaMonitorBenchmark::initTestCase()
+{
+    m_monitor = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), this);
+    if (!m_monitor)
+        QSKIP("The positionpoll plugin is not available");
+
+    // Owned by the plugin from here on
+    m_source = new BenchPositionSource;
+    m_monitor->setPositionInfoSource(m_source);
+    QCOMPARE(m_monitor->positionInfoSource(), m_source);
+
+    // Area events are only evaluated while someone listens
+    connect(m_monitor, &QGeoAreaMonitorSource::areaEntered, this, [] {});
+    connect(m_monitor, &QGeoAreaMonitorSource::areaExited, this, [] {});
+}
+
+void tst_QGeoAreaMonitorBenchmark::cleanupTestCase()
+{
+    delete m_monitor;
+}
+
+void tst_QGeoAreaMonitorBenchmark::cleanup()
+{
+    const QList<QGeoAreaMonitorInfo> active = m_monitor->activeMonitors();
+    for (const QGeoAreaMonitorInfo &info : active)
+        m_monitor->stopMonitoring(info);
+}
+
+void tst_QGeoAreaMonitorBenchmark::populate_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1k fences") << 1000;
+    QTest::newRow("20k fences") << 20000;
+    QTest::newRow("100k fences") << 100000;
+}
+
+void tst_QGeoAreaMonitorBenchmark::positionUpdated_data()
+{
+    populate_data();
+}
+
+// Cost of evaluating one position fix against all active fences
+void tst_QGeoAreaMonitorBenchmark::positionUpdated()
+{
+    QFETCH(int, count);
+
+    const QList<QGeoAreaMonitorInfo> areas = fences(count, false);
+    for (const QGeoAreaMonitorInfo &info : areas)
+        QVERIFY(m_monitor->startMonitoring(info));
+    const QList<QGeoPositionInfo> fixes = track(256);
+
+    int fix = 0;
+    QBENCHMARK {
+        m_source->push(fixes.at(fix));
+        fix = (fix + 1) % fixes.size();
+    }
+}
+
+void tst_QGeoAreaMonitorBenchmark::startStopMonitoring_data()
+{
+    populate_data();
+}
+
+// Adding and removing expiring fences, which reschedules the expiry timer
+// on every change
+void tst_QGeoAreaMonitorBenchmark::startStopMonitoring()
+{
+    QFETCH(int, count);
+
+    const QList<QGeoAreaMonitorInfo> areas = fences(count, true);
+
+    QBENCHMARK {
+        for (const QGeoAreaMonitorInfo &info : areas)
+            m_monitor->startMonitoring(info);
+        for (const QGeoAreaMonitorInfo &info : areas)
+            m_monitor->stopMonitoring(info);
+    }
+    QCOMPARE(m_monitor->activeMonitors().size(), 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoAreaMonitorBenchmark)
+
+#include "tst_bench_qgeoareamonitor.moc"
@@ -0,0 +1,693 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtLocation/private/qgeocameratiles_p.h>
+#include <QtLocation/private/qgeocameratiles_p_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeomaptype_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QMap>
+#include <QPair>
+#include <cmath>
+#include <limits>
+
+QT_USE_NAMESPACE
+
+// The tile coverage as QGeoCameraTiles used to compute it, for comparison:
+// the footprint is clipped to the map, split at the dateline, and the tiles
+// of every part are collected into a set.
+
+struct ClippedFootprint
+{
+    ClippedFootprint()
+    {}
+    ClippedFootprint(const PolygonVector &left_, const PolygonVector &mid_, const PolygonVector &right_)
+        : left(left_), mid(mid_), right(right_)
+    {}
+    PolygonVector left;
+    PolygonVector mid;
+    PolygonVector right;
+};
+
+struct TileMap
+{
+    void add(int tileX, int tileY)
+    {
+        if (data.contains(tileY)) {
+            int oldMinX = data.value(tileY).first;
+            int oldMaxX = data.value(tileY).second;
+            data.insert(tileY, QPair<int, int>(qMin(tileX, oldMinX), qMax(tileX, oldMaxX)));
+        } else {
+            data.insert(tileY, QPair<int, int>(tileX, tileX));
+        }
+    }
+
+    QMap<int, QPair<int, int> > data;
+};
+
+static QPair<PolygonVector, PolygonVector> splitPolygonAtAxisValue(const PolygonVector &polygon, int axis, double value)
+{
+    PolygonVector polygonBelow;
+    PolygonVector polygonAbove;
+
+    int size = polygon.size();
+
+    if (size == 0) {
+        return QPair<PolygonVector, PolygonVector>(polygonBelow, polygonAbove);
+    }
+
+    QVector<int> comparisons = QVector<int>(polygon.size());
+
+    for (int i = 0; i < size; ++i) {
+        double v = polygon.at(i).get(axis);
+        if (qFuzzyCompare(v - value + 1.0, 1.0)) {
+            comparisons[i] = 0;
+        } else {
+            if (v < value) {
+                comparisons[i] = -1;
+            } else if (value < v) {
+                comparisons[i] = 1;
+            }
+        }
+    }
+
+    for (int index = 0; index < size; ++index) {
+        int prevIndex = index - 1;
+        if (prevIndex < 0)
+            prevIndex += size;
+        int nextIndex = (index + 1) % size;
+
+        int prevComp = comparisons[prevIndex];
+        int comp = comparisons[index];
+        int nextComp = comparisons[nextIndex];
+
+         if (comp == 0) {
+            if (prevComp == -1) {
+                polygonBelow.append(polygon.at(index));
+                if (nextComp == 1) {
+                    polygonAbove.append(polygon.at(index));
+                }
+            } else if (prevComp == 1) {
+                polygonAbove.append(polygon.at(index));
+                if (nextComp == -1) {
+                    polygonBelow.append(polygon.at(index));
+                }
+            } else if (prevComp == 0) {
+                if (nextComp == -1) {
+                    polygonBelow.append(polygon.at(index));
+                } else if (nextComp == 1) {
+                    polygonAbove.append(polygon.at(index));
+                } else if (nextComp == 0) {
+                    // do nothing
+                }
+            }
+        } else {
+             if (comp == -1) {
+                 polygonBelow.append(polygon.at(index));
+             } else if (comp == 1) {
+                 polygonAbove.append(polygon.at(index));
+             }
+
+             // there is a point between this and the next point
+             // on the polygon that lies on the splitting line
+             // and should be added to both the below and above
+             // polygons
+             if ((nextComp != 0) && (nextComp != comp)) {
+                 QDoubleVector3D p1 = polygon.at(index);
+                 QDoubleVector3D p2 = polygon.at(nextIndex);
+
+                 double p1v = p1.get(axis);
+                 double p2v = p2.get(axis);
+
+                 double f = (p1v - value) / (p1v - p2v);
+
+                 if (((0 <= f) && (f <= 1.0))
+                         || qFuzzyCompare(f + 1.0, 1.0)
+                         || qFuzzyCompare(f + 1.0, 2.0) ) {
+                     QDoubleVector3D midPoint = (1.0 - f) * p1 + f * p2;
+                     polygonBelow.append(midPoint);
+                     polygonAbove.append(midPoint);
+                 }
+             }
+        }
+    }
+
+    return QPair<PolygonVector, PolygonVector>(polygonBelow, polygonAbove);
+}
+
+static void addXOffset(PolygonVector &footprint, double xoff)
+{
+    for (QDoubleVector3D &v: footprint)
+        v.setX(v.x() + xoff);
+}
+
+static ClippedFootprint clipFootprintToMap(const QGeoCameraTilesPrivate *d, const PolygonVector &footprint)
+{
+    bool clipX0 = false;
+    bool clipX1 = false;
+    bool clipY0 = false;
+    bool clipY1 = false;
+
+    double side = 1.0 * d->m_sideLength;
+    double minX = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+
+    for (const QDoubleVector3D &p: footprint) {
+        if (p.y() < 0.0)
+            clipY0 = true;
+        if (p.y() > side)
+            clipY1 = true;
+    }
+
+    PolygonVector results = footprint;
+
+    if (clipY0) {
+        results = splitPolygonAtAxisValue(results, 1, 0.0).second;
+    }
+
+    if (clipY1) {
+        results = splitPolygonAtAxisValue(results, 1, side).first;
+    }
+
+    for (const QDoubleVector3D &p: results) {
+        if ((p.x() < 0.0) || (qFuzzyIsNull(p.x())))
+            clipX0 = true;
+        if ((p.x() > side) || (qFuzzyCompare(side, p.x())))
+            clipX1 = true;
+    }
+
+    for (const QDoubleVector3D &v : results) {
+        minX = qMin(v.x(), minX);
+        maxX = qMax(v.x(), maxX);
+    }
+
+    double footprintWidth = maxX - minX;
+
+    if (clipX0) {
+        if (clipX1) {
+            if (footprintWidth > side) {
+                PolygonVector rightPart = splitPolygonAtAxisValue(results, 0, side).second;
+                addXOffset(rightPart,  -side);
+                rightPart = splitPolygonAtAxisValue(rightPart, 0, side).first; // clip it again, should it tend to infinite or so
+
+                PolygonVector leftPart = splitPolygonAtAxisValue(results, 0, 0).first;
+                addXOffset(leftPart,  side);
+                leftPart = splitPolygonAtAxisValue(leftPart, 0, 0).second; // same here
+
+                results = splitPolygonAtAxisValue(results, 0, 0.0).second;
+                results = splitPolygonAtAxisValue(results, 0, side).first;
+                return ClippedFootprint(leftPart, results, rightPart);
+            } else { // fitting the WebMercator square exactly?
+                results = splitPolygonAtAxisValue(results, 0, 0.0).second;
+                results = splitPolygonAtAxisValue(results, 0, side).first;
+                return ClippedFootprint(PolygonVector(), results, PolygonVector());
+            }
+        } else {
+            QPair<PolygonVector, PolygonVector> pair = splitPolygonAtAxisValue(results, 0, 0.0);
+            if (pair.first.isEmpty()) {
+                // if we touched the line but didn't cross it...
+                for (int i = 0; i < pair.second.size(); ++i) {
+                    if (qFuzzyIsNull(pair.second.at(i).x()))
+                        pair.first.append(pair.second.at(i));
+                }
+                if (pair.first.size() == 2) {
+                    double y0 = pair.first[0].y();
+                    double y1 = pair.first[1].y();
+                    pair.first.clear();
+                    pair.first.append(QDoubleVector3D(side, y0, 0.0));
+                    pair.first.append(QDoubleVector3D(side - 0.001, y0, 0.0));
+                    pair.first.append(QDoubleVector3D(side - 0.001, y1, 0.0));
+                    pair.first.append(QDoubleVector3D(side, y1, 0.0));
+                } else if (pair.first.size() == 1) {
+                    // FIXME this is trickier
+                    // - touching at one point on the tile boundary
+                    // - probably need to build a triangular polygon across the edge
+                    // - don't want to add another y tile if we can help it
+                    //   - initial version doesn't care
+                    double y = pair.first.at(0).y();
+                    pair.first.clear();
+                    pair.first.append(QDoubleVector3D(side - 0.001, y, 0.0));
+                    pair.first.append(QDoubleVector3D(side, y + 0.001, 0.0));
+                    pair.first.append(QDoubleVector3D(side, y - 0.001, 0.0));
+                }
+            } else {
+                addXOffset(pair.first, side);
+                if (footprintWidth > side)
+                    pair.first = splitPolygonAtAxisValue(pair.first, 0, 0).second;
+            }
+            return ClippedFootprint(pair.first, pair.second, PolygonVector());
+        }
+    } else {
+        if (clipX1) {
+            QPair<PolygonVector, PolygonVector> pair = splitPolygonAtAxisValue(results, 0, side);
+            if (pair.second.isEmpty()) {
+                // if we touched the line but didn't cross it...
+                for (int i = 0; i < pair.first.size(); ++i) {
+                    if (qFuzzyCompare(side, pair.first.at(i).x()))
+                        pair.second.append(pair.first.at(i));
+                }
+                if (pair.second.size() == 2) {
+                    double y0 = pair.second[0].y();
+                    double y1 = pair.second[1].y();
+                    pair.second.clear();
+                    pair.second.append(QDoubleVector3D(0, y0, 0.0));
+                    pair.second.append(QDoubleVector3D(0.001, y0, 0.0));
+                    pair.second.append(QDoubleVector3D(0.001, y1, 0.0));
+                    pair.second.append(QDoubleVector3D(0, y1, 0.0));
+                } else if (pair.second.size() == 1) {
+                    // FIXME this is trickier
+                    // - touching at one point on the tile boundary
+                    // - probably need to build a triangular polygon across the edge
+                    // - don't want to add another y tile if we can help it
+                    //   - initial version doesn't care
+                    double y = pair.second.at(0).y();
+                    pair.second.clear();
+                    pair.second.append(QDoubleVector3D(0.001, y, 0.0));
+                    pair.second.append(QDoubleVector3D(0.0, y - 0.001, 0.0));
+                    pair.second.append(QDoubleVector3D(0.0, y + 0.001, 0.0));
+                }
+            } else {
+                addXOffset(pair.second, -side);
+                if (footprintWidth > side)
+                    pair.second = splitPolygonAtAxisValue(pair.second, 0, side).first;
+            }
+            return ClippedFootprint(PolygonVector(), pair.first, pair.second);
+        } else {
+            return ClippedFootprint(PolygonVector(), results, PolygonVector());
+        }
+    }
+
+}
+
+static QList<QPair<double, int> > tileIntersections(double p1, int t1, double p2, int t2)
+{
+    if (t1 == t2) {
+        QList<QPair<double, int> > results = QList<QPair<double, int> >();
+        results.append(QPair<double, int>(0.0, t1));
+        return results;
+    }
+
+    int step = 1;
+    if (t1 > t2) {
+        step = -1;
+    }
+
+    int size = 1 + ((t2 - t1) / step);
+
+    QList<QPair<double, int> > results = QList<QPair<double, int> >();
+
+    results.append(QPair<double, int>(0.0, t1));
+
+    if (step == 1) {
+        for (int i = 1; i < size; ++i) {
+            double f = (t1 + i - p1) / (p2 - p1);
+            results.append(QPair<double, int>(f, t1 + i));
+        }
+    } else {
+        for (int i = 1; i < size; ++i) {
+            double f = (t1 - i + 1 - p1) / (p2 - p1);
+            results.append(QPair<double, int>(f, t1 - i));
+        }
+    }
+
+    return results;
+}
+
+static QSet<QGeoTileSpec> tilesFromPolygon(const QGeoCameraTilesPrivate *d, const PolygonVector &polygon)
+{
+    int numPoints = polygon.size();
+
+    if (numPoints == 0)
+        return QSet<QGeoTileSpec>();
+
+    QVector<int> tilesX(polygon.size());
+    QVector<int> tilesY(polygon.size());
+
+    // grab tiles at the corners of the polygon
+    for (int i = 0; i < numPoints; ++i) {
+
+        QDoubleVector2D p = polygon.at(i).toVector2D();
+
+        int x = 0;
+        int y = 0;
+
+        if (qFuzzyCompare(p.x(), d->m_sideLength * 1.0))
+            x = d->m_sideLength - 1;
+        else {
+            x = static_cast<int>(p.x()) % d->m_sideLength;
+            if ( !qFuzzyCompare(p.x(), 1.0 * x) && qFuzzyCompare(p.x(), 1.0 * (x + 1)) )
+                x++;
+        }
+
+        if (qFuzzyCompare(p.y(), d->m_sideLength * 1.0))
+            y = d->m_sideLength - 1;
+        else {
+            y = static_cast<int>(p.y()) % d->m_sideLength;
+            if ( !qFuzzyCompare(p.y(), 1.0 * y) && qFuzzyCompare(p.y(), 1.0 * (y + 1)) )
+                y++;
+        }
+
+        tilesX[i] = x;
+        tilesY[i] = y;
+    }
+
+    TileMap map;
+
+    // walk along the edges of the polygon and add all tiles covered by them
+    for (int i1 = 0; i1 < numPoints; ++i1) {
+        int i2 = (i1 + 1) % numPoints;
+
+        double x1 = polygon.at(i1).get(0);
+        double x2 = polygon.at(i2).get(0);
+
+        bool xFixed = qFuzzyCompare(x1, x2);
+        bool xIntegral = qFuzzyCompare(x1, std::floor(x1)) || qFuzzyCompare(x1 + 1.0, std::floor(x1 + 1.0));
+
+        QList<QPair<double, int> > xIntersects
+                = tileIntersections(x1,
+                                    tilesX.at(i1),
+                                    x2,
+                                    tilesX.at(i2));
+
+        double y1 = polygon.at(i1).get(1);
+        double y2 = polygon.at(i2).get(1);
+
+        bool yFixed = qFuzzyCompare(y1, y2);
+        bool yIntegral = qFuzzyCompare(y1, std::floor(y1)) || qFuzzyCompare(y1 + 1.0, std::floor(y1 + 1.0));
+
+        QList<QPair<double, int> > yIntersects
+                = tileIntersections(y1,
+                                    tilesY.at(i1),
+                                    y2,
+                                    tilesY.at(i2));
+
+        int x = xIntersects.takeFirst().second;
+        int y = yIntersects.takeFirst().second;
+
+
+        /*
+          If the polygon coincides with the tile edges we must be
+          inclusive and grab all tiles on both sides. We also need
+          to handle tiles with corners coindent with the
+          corners of the polygon.
+          e.g. all tiles marked with 'x' will be added
+
+              "+" - tile boundaries
+              "O" - polygon boundary
+
+                + + + + + + + + + + + + + + + + + + + + +
+                +       +       +       +       +       +
+                +       +   x   +   x   +   x   +       +
+                +       +       +       +       +       +
+                + + + + + + + + O O O O O + + + + + + + +
+                +       +       O       0       +       +
+                +       +   x   O   x   0   x   +       +
+                +       +       O       0       +       +
+                + + + + + + + + O 0 0 0 0 + + + + + + + +
+                +       +       +       +       +       +
+                +       +   x   +   x   +   x   +       +
+                +       +       +       +       +       +
+                + + + + + + + + + + + + + + + + + + + + +
+        */
+
+
+        int xOther = x;
+        int yOther = y;
+
+        if (xFixed && xIntegral) {
+             if (y2 < y1) {
+                 xOther = qMax(0, x - 1);
+            }
+        }
+
+        if (yFixed && yIntegral) {
+            if (x1 < x2) {
+                yOther = qMax(0, y - 1);
+
+            }
+        }
+
+        if (xIntegral) {
+            map.add(xOther, y);
+            if (yIntegral)
+                map.add(xOther, yOther);
+
+        }
+
+        if (yIntegral)
+            map.add(x, yOther);
+
+        map.add(x,y);
+
+        // top left corner
+        int iPrev =  (i1 + numPoints - 1) % numPoints;
+        double xPrevious = polygon.at(iPrev).get(0);
+        double yPrevious = polygon.at(iPrev).get(1);
+        bool xPreviousFixed = qFuzzyCompare(xPrevious, x1);
+        if (xIntegral && xPreviousFixed && yIntegral && yFixed) {
+            if ((x2 > x1) && (yPrevious > y1)) {
+                if ((x - 1) > 0 && (y - 1) > 0)
+                    map.add(x - 1, y - 1);
+            } else if ((x2 < x1) && (yPrevious < y1)) {
+                // what?
+            }
+        }
+
+        // for the simple case where intersections do not coincide with
+        // the boundaries, we move along the edge and add tiles until
+        // the x and y intersection lists are exhausted
+
+        while (!xIntersects.isEmpty() && !yIntersects.isEmpty()) {
+            QPair<double, int> nextX = xIntersects.first();
+            QPair<double, int> nextY = yIntersects.first();
+            if (nextX.first < nextY.first) {
+                x = nextX.second;
+                map.add(x, y);
+                xIntersects.removeFirst();
+
+            } else if (nextX.first > nextY.first) {
+                y = nextY.second;
+                map.add(x, y);
+                yIntersects.removeFirst();
+
+            } else {
+                map.add(x, nextY.second);
+                map.add(nextX.second, y);
+                x = nextX.second;
+                y = nextY.second;
+                map.add(x, y);
+                xIntersects.removeFirst();
+                yIntersects.removeFirst();
+            }
+        }
+
+        while (!xIntersects.isEmpty()) {
+            x = xIntersects.takeFirst().second;
+            map.add(x, y);
+            if (yIntegral && yFixed)
+                map.add(x, yOther);
+
+        }
+
+        while (!yIntersects.isEmpty()) {
+            y = yIntersects.takeFirst().second;
+            map.add(x, y);
+            if (xIntegral && xFixed)
+                map.add(xOther, y);
+        }
+    }
+
+    QSet<QGeoTileSpec> results;
+
+    int z = d->m_intZoomLevel;
+
+    typedef QMap<int, QPair<int, int> >::const_iterator iter;
+    iter i = map.data.constBegin();
+    iter end = map.data.constEnd();
+
+    QGeoTileSpec spec(d->m_pluginString, d->m_mapType.mapId(), z, -1, -1, d->m_mapVersion);
+    for (; i != end; ++i) {
+        int y = i.key();
+        int minX = i->first;
+        int maxX = i->second;
+        spec.setY(y);
+        for (int x = minX; x <= maxX; ++x) {
+            spec.setX(x);
+            results.insert(spec);
+        }
+    }
+
+    return results;
+}
+
+class tst_QGeoCameraTilesBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void createTiles_data();
+    void createTiles();
+    void coverage_data();
+    void coverage();
+};
+
+void tst_QGeoCameraTilesBenchmark::createTiles_data()
+{
+    QTest::addColumn<double>("zoomLevel");
+    QTest::addColumn<double>("tilt");
+
+    const double zoomLevels[] = { 4.0, 10.5, 16.5, 20.0 };
+    const double tilts[] = { 0.0, 30.0, 60.0, 80.0 };
+    for (double zoomLevel : zoomLevels) {
+        for (double tilt : tilts) {
+            QTest::newRow(qPrintable(QStringLiteral("z%1 tilt %2").arg(zoomLevel).arg(tilt)))
+                    << zoomLevel << tilt;
+        }
+    }
+}
+
+// Tile coverage of a 1280x720 viewport. The camera moves by a fraction of a
+// tile between calls, so every call recomputes the coverage.
+void tst_QGeoCameraTilesBenchmark::createTiles()
+{
+    QFETCH(double, zoomLevel);
+    QFETCH(double, tilt);
+
+    QGeoCameraData cameras[2];
+    for (int i = 0; i < 2; ++i) {
+        cameras[i].setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + i * 1e-7, 0.5)));
+        cameras[i].setZoomLevel(zoomLevel);
+        cameras[i].setTilt(tilt);
+        cameras[i].setBearing(30.0);
+    }
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(256);
+    ct.setScreenSize(QSize(1280, 720));
+    ct.setPluginString(QStringLiteral("bench"));
+    ct.setMapType(QGeoMapType(QGeoMapType::StreetMap, QStringLiteral("street map"), QStringLiteral("street map"),
+                              false, false, 1, QByteArrayLiteral(""), QGeoCameraCapabilities()));
+
+    int i = 0;
+    int tiles = 0;
+    QBENCHMARK {
+        ct.setCameraData(cameras[++i & 1]);
+        tiles = ct.createTiles().size();
+    }
+    QVERIFY(tiles > 0);
+}
+
+void tst_QGeoCameraTilesBenchmark::coverage_data()
+{
+    QTest::addColumn<double>("tilt");
+    QTest::addColumn<QString>("method");
+
+    const double tilts[] = { 0.0, 45.0, 60.0 };
+    const QString methods[] = { QStringLiteral("polygon"), QStringLiteral("spans"), QStringLiteral("incremental"),
+                                QStringLiteral("detail") };
+    for (double tilt : tilts) {
+        for (const QString &method : methods) {
+            QTest::newRow(qPrintable(QStringLiteral("tilt %1, %2").arg(tilt).arg(method)))
+                    << tilt << method;
+        }
+    }
+}
+
+// Tile coverage of a 1280x720 viewport at z14 while panning by an eighth of
+// a tile per call. "polygon" clips the footprint and collects the tiles of
+// every part into a set, the way createTiles() used to, "spans" scan-converts
+// the footprint, "incremental" only reports the tiles that changed and
+// "detail" uses lower zoom levels away from the camera.
+void tst_QGeoCameraTilesBenchmark::coverage()
+{
+    QFETCH(double, tilt);
+    QFETCH(QString, method);
+
+    const double zoomLevel = 14.0;
+    const double step = 1.0 / (8.0 * (1 << 14));
+    QVector<QGeoCameraData> cameras(64);
+    for (int i = 0; i < cameras.size(); ++i) {
+        cameras[i].setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + i * step, 0.5 + i * step * 0.5)));
+        cameras[i].setZoomLevel(zoomLevel);
+        cameras[i].setTilt(tilt);
+        cameras[i].setBearing(30.0);
+    }
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(256);
+    ct.setScreenSize(QSize(1280, 720));
+    ct.setPluginString(QStringLiteral("bench"));
+    ct.setMapType(QGeoMapType(QGeoMapType::StreetMap, QStringLiteral("street map"), QStringLiteral("street map"),
+                              false, false, 1, QByteArrayLiteral(""), QGeoCameraCapabilities()));
+    QGeoCameraTilesPrivate *d = QGeoCameraTilesPrivate::get(&ct);
+
+    QVector<QGeoCameraTileSpan> entered;
+    QVector<QGeoCameraTileSpan> left;
+    int i = 0;
+    int tiles = 0;
+    if (method == QLatin1String("polygon")) {
+        QBENCHMARK {
+            ct.setCameraData(cameras.at(i++ % cameras.size()));
+            const ClippedFootprint polygons
+                    = clipFootprintToMap(d, d->frustumFootprint(d->createFrustum(1.0)));
+            QSet<QGeoTileSpec> result;
+            if (!polygons.left.isEmpty())
+                result.unite(tilesFromPolygon(d, polygons.left));
+            if (!polygons.right.isEmpty())
+                result.unite(tilesFromPolygon(d, polygons.right));
+            if (!polygons.mid.isEmpty())
+                result.unite(tilesFromPolygon(d, polygons.mid));
+            tiles = result.size();
+        }
+    } else if (method == QLatin1String("spans")) {
+        QBENCHMARK {
+            ct.setCameraData(cameras.at(i++ % cameras.size()));
+            tiles = ct.tileSpans().size();
+        }
+    } else if (method == QLatin1String("incremental")) {
+        QBENCHMARK {
+            ct.setCameraData(cameras.at(i++ % cameras.size()));
+            ct.tileSpanChanges(&entered, &left);
+            tiles = ct.tileSpans().size();
+        }
+    } else {
+        ct.setDetailThreshold(1.25);
+        QBENCHMARK {
+            ct.setCameraData(cameras.at(i++ % cameras.size()));
+            tiles = ct.createTiles().size();
+        }
+    }
+    QVERIFY(tiles > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoCameraTilesBenchmark)
+
+#include "tst_bench_qgeocameratiles.moc"
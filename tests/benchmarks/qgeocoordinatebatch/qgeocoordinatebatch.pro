@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeocoordinatebatch
+
+SOURCES += tst_bench_qgeocoordinatebatch.cpp
+
+QT += positioning-private testlib
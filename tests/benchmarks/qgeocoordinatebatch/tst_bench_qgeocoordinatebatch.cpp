@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/private/qgeocoordinatebatch_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoCoordinateBatchBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void distances_data();
+    void distances();
+    void toMercator_data();
+    void toMercator();
+    void atDistanceAndAzimuth_data();
+    void atDistanceAndAzimuth();
+
+private:
+    QVector<double> m_latitudes;
+    QVector<double> m_longitudes;
+    QList<QGeoCoordinate> m_coordinates;
+};
+
+void tst_QGeoCoordinateBatchBenchmark::initTestCase()
+{
+    // A track wandering around central Europe
+    quint32 state = 1;
+    auto random = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / double(1 << 24) - 0.5;
+    };
+    double latitude = 48.0;
+    double longitude = 11.0;
+    for (int i = 0; i < 100000; ++i) {
+        latitude += random() * 0.001;
+        longitude += random() * 0.001;
+        m_latitudes << latitude;
+        m_longitudes << longitude;
+        m_coordinates << QGeoCoordinate(latitude, longitude);
+    }
+}
+
+void tst_QGeoCoordinateBatchBenchmark::distances_data()
+{
+    QTest::addColumn<bool>("batch");
+
+    QTest::newRow("QGeoCoordinate") << false;
+    QTest::newRow("QGeoCoordinateBatch") << true;
+}
+
+void tst_QGeoCoordinateBatchBenchmark::distances()
+{
+    QFETCH(bool, batch);
+
+    const int count = m_latitudes.size();
+    QVector<double> result(count - 1);
+    QBENCHMARK {
+        if (batch) {
+            QGeoCoordinateBatch::distances(m_latitudes.constData(), m_longitudes.constData(),
+                                           count, result.data());
+        } else {
+            for (int i = 0; i < count - 1; ++i)
+                result[i] = m_coordinates.at(i).distanceTo(m_coordinates.at(i + 1));
+        }
+    }
+}
+
+void tst_QGeoCoordinateBatchBenchmark::toMercator_data()
+{
+    distances_data();
+}
+
+void tst_QGeoCoordinateBatchBenchmark::toMercator()
+{
+    QFETCH(bool, batch);
+
+    const int count = m_latitudes.size();
+    QVector<double> x(count);
+    QVector<double> y(count);
+    QBENCHMARK {
+        if (batch) {
+            QGeoCoordinateBatch::toMercator(m_latitudes.constData(), m_longitudes.constData(),
+                                            count, x.data(), y.data());
+        } else {
+            for (int i = 0; i < count; ++i) {
+                const QDoubleVector2D p = QWebMercator::coordToMercator(m_coordinates.at(i));
+                x[i] = p.x();
+                y[i] = p.y();
+            }
+        }
+    }
+}
+
+void tst_QGeoCoordinateBatchBenchmark::atDistanceAndAzimuth_data()
+{
+    distances_data();
+}
+
+void tst_QGeoCoordinateBatchBenchmark::atDistanceAndAzimuth()
+{
+    QFETCH(bool, batch);
+
+    // The peripheral points of a map circle
+    const int steps = 128;
+    const QGeoCoordinate center(48.0, 11.0);
+    const double radius = 2500.0;
+    QVector<double> azimuths(steps);
+    for (int i = 0; i < steps; ++i)
+        azimuths[i] = 360.0 * i / steps;
+    QVector<double> latitudes(steps);
+    QVector<double> longitudes(steps);
+
+    QBENCHMARK {
+        if (batch) {
+            QGeoCoordinateBatch::atDistanceAndAzimuth(center.latitude(), center.longitude(),
+                                                      radius, azimuths.constData(), steps,
+                                                      latitudes.data(), longitudes.data());
+        } else {
+            for (int i = 0; i < steps; ++i) {
+                const QGeoCoordinate c = center.atDistanceAndAzimuth(radius, azimuths.at(i));
+                latitudes[i] = c.latitude();
+                longitudes[i] = c.longitude();
+            }
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoCoordinateBatchBenchmark)
+
+#include "tst_bench_qgeocoordinatebatch.moc"
@@ -0,0 +1,187 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "qgeofiletilecache_p.h"
+#include "qgeotilespec_p.h"
+#include "qgeotilefetcher_test.h"
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoFileTileCache::DiskStorage)
+Q_DECLARE_METATYPE(QAbstractGeoTileCache::CacheArea)
+
+// Gives access to the individual cache levels
+class BenchTileCache : public QGeoFileTileCache
+{
+public:
+    BenchTileCache(const QString &directory) : QGeoFileTileCache(directory) {}
+
+    using QGeoFileTileCache::init;
+    using QGeoFileTileCache::getFromMemory;
+    using QGeoFileTileCache::getFromDisk;
+
+    void dropTextures() { textureCache_.clear(); }
+    void dropMemory() { memoryCache_.clear(); }
+};
+
+class tst_QGeoFileTileCacheBenchmark : public QObject
+{
+    Q_OBJECT
+
+    enum Level {
+        TextureLevel,
+        MemoryLevel,
+        DiskLevel
+    };
+
+private Q_SLOTS:
+    void initTestCase();
+    void get_data();
+    void get();
+    void insert_data();
+    void insert();
+
+private:
+    void prepareCache(BenchTileCache *cache, QGeoFileTileCache::DiskStorage storage);
+
+    QVector<QGeoTileSpec> m_tiles;
+    QVector<QByteArray> m_bytes;
+};
+
+// The tiles are rendered by the fetcher of the test plugin, 8x8 tiles of 256x256 pixels
+void tst_QGeoFileTileCacheBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    QGeoTileFetcherTest fetcher(nullptr);
+    fetcher.setFinishRequestImmediately(true);
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            const QGeoTileSpec spec(QStringLiteral("bench"), 1, 16, 30000 + x, 20000 + y);
+            QScopedPointer<QGeoTiledMapReply> reply(fetcher.getTileImage(spec));
+            QVERIFY(!reply->mapImageData().isEmpty());
+            m_tiles.append(spec);
+            m_bytes.append(reply->mapImageData());
+        }
+    }
+}
+
+void tst_QGeoFileTileCacheBenchmark::prepareCache(BenchTileCache *cache, QGeoFileTileCache::DiskStorage storage)
+{
+    cache->setAsyncDecoding(false);
+    cache->setDiskStorage(storage);
+    cache->setMaxDiskUsage(64 * 1024 * 1024);
+    cache->setMaxMemoryUsage(64 * 1024 * 1024);
+    cache->setExtraTextureUsage(64 * 1024 * 1024);
+    cache->init();
+}
+
+void tst_QGeoFileTileCacheBenchmark::get_data()
+{
+    QTest::addColumn<int>("level");
+    QTest::addColumn<QGeoFileTileCache::DiskStorage>("storage");
+
+    QTest::newRow("texture") << int(TextureLevel) << QGeoFileTileCache::TileFiles;
+    QTest::newRow("memory") << int(MemoryLevel) << QGeoFileTileCache::TileFiles;
+    QTest::newRow("disk, tile files") << int(DiskLevel) << QGeoFileTileCache::TileFiles;
+    QTest::newRow("disk, segment files") << int(DiskLevel) << QGeoFileTileCache::SegmentFiles;
+}
+
+// Gets every tile from the given cache level, decoding it unless it comes
+// from the texture cache
+void tst_QGeoFileTileCacheBenchmark::get()
+{
+    QFETCH(int, level);
+    QFETCH(QGeoFileTileCache::DiskStorage, storage);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    BenchTileCache cache(dir.path());
+    prepareCache(&cache, storage);
+    for (int i = 0; i < m_tiles.size(); ++i)
+        cache.insert(m_tiles.at(i), m_bytes.at(i), QStringLiteral("png"));
+    for (const QGeoTileSpec &spec : qAsConst(m_tiles))
+        QVERIFY(cache.get(spec));
+
+    QBENCHMARK {
+        switch (level) {
+        case TextureLevel:
+            for (const QGeoTileSpec &spec : qAsConst(m_tiles))
+                QVERIFY(cache.get(spec));
+            break;
+        case MemoryLevel:
+            cache.dropTextures();
+            for (const QGeoTileSpec &spec : qAsConst(m_tiles))
+                QVERIFY(cache.getFromMemory(spec));
+            break;
+        case DiskLevel:
+            cache.dropTextures();
+            cache.dropMemory();
+            for (const QGeoTileSpec &spec : qAsConst(m_tiles))
+                QVERIFY(cache.getFromDisk(spec));
+            break;
+        }
+    }
+}
+
+void tst_QGeoFileTileCacheBenchmark::insert_data()
+{
+    QTest::addColumn<QAbstractGeoTileCache::CacheArea>("area");
+    QTest::addColumn<QGeoFileTileCache::DiskStorage>("storage");
+
+    QTest::newRow("memory") << QAbstractGeoTileCache::MemoryCache << QGeoFileTileCache::TileFiles;
+    QTest::newRow("disk, tile files") << QAbstractGeoTileCache::DiskCache << QGeoFileTileCache::TileFiles;
+    QTest::newRow("disk, segment files") << QAbstractGeoTileCache::DiskCache << QGeoFileTileCache::SegmentFiles;
+}
+
+// Inserts every tile, as done when a fetched tile arrives
+void tst_QGeoFileTileCacheBenchmark::insert()
+{
+    QFETCH(QAbstractGeoTileCache::CacheArea, area);
+    QFETCH(QGeoFileTileCache::DiskStorage, storage);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    BenchTileCache cache(dir.path());
+    prepareCache(&cache, storage);
+
+    const QString format = QStringLiteral("png");
+    QBENCHMARK {
+        for (int i = 0; i < m_tiles.size(); ++i)
+            cache.insert(m_tiles.at(i), m_bytes.at(i), format, area);
+    }
+    QVERIFY(cache.get(m_tiles.first()));
+}
+
+QTEST_MAIN(tst_QGeoFileTileCacheBenchmark)
+
+#include "tst_bench_qgeofiletilecache.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeomapobjectqsgsupport
+
+INCLUDEPATH += ../../auto/geotestplugin
+
+SOURCES += tst_bench_qgeomapobjectqsgsupport.cpp
+
+QT += location-private positioning-private quick testlib
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeotiledmap_test.h"
+#include "qgeotiledmappingmanagerengine_test.h"
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QStandardPaths>
+#include <QtTest/QtTest>
+#include <QtQuick/QSGNode>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qgeomapobjectqsgsupport_p.h>
+#include <QtLocation/private/qmapcircleobject_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapObjectQSGSupportBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void panMap_data();
+    void panMap();
+
+private:
+    QScopedPointer<QGeoServiceProvider> m_provider;
+    QScopedPointer<QGeoTiledMapTest> m_map;
+};
+
+void tst_QGeoMapObjectQSGSupportBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    m_provider.reset(new QGeoServiceProvider("qmlgeo.test.plugin", parameters));
+    m_provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = m_provider->mappingManager();
+    QVERIFY2(m_provider->error() == QGeoServiceProvider::NoError, "Could not load plugin: " + m_provider->errorString().toLatin1());
+    m_map.reset(static_cast<QGeoTiledMapTest*>(mappingManager->createMap(this)));
+    QVERIFY(m_map);
+    m_map->setActiveMapType(m_map->m_engine->supportedMapTypes().first());
+    m_map->setViewportSize(QSize(1280, 720));
+}
+
+void tst_QGeoMapObjectQSGSupportBenchmark::panMap_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<double>("zoomLevel");
+
+    // The objects are spread over a 4 by 4 degrees area
+    QTest::newRow("10k, city") << 10000 << 12.0;
+    QTest::newRow("100k, city") << 100000 << 12.0;
+    QTest::newRow("10k, region") << 10000 << 8.0;
+}
+
+// Pans the map a quarter of the screen width per step, updating the geometry
+// of the circles and synchronizing their nodes as the labs map does
+void tst_QGeoMapObjectQSGSupportBenchmark::panMap()
+{
+    QFETCH(int, count);
+    QFETCH(double, zoomLevel);
+
+    QSGNode root;
+    QGeoMapObjectQSGSupport support;
+    support.m_map = m_map.data();
+
+    QRandomGenerator random(42);
+    QVector<QMapCircleObject *> circles;
+    circles.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QMapCircleObject *circle = new QMapCircleObject;
+        circle->setCenter(QGeoCoordinate(48.0 + random.generateDouble() * 4.0,
+                                          9.0 + random.generateDouble() * 4.0));
+        circle->setRadius(100.0 + random.bounded(400));
+        circle->setColor(i % 2 ? QColor(Qt::red) : QColor(Qt::blue));
+
+        QGeoMapObjectPrivate *pimpl = support.createMapObjectImplementationPrivate(circle);
+        QVERIFY(pimpl);
+        circle->setImplementation(QExplicitlySharedDataPointer<QGeoMapObjectPrivate>(pimpl));
+        pimpl->setMap(m_map.data());
+        circles.append(circle);
+    }
+
+    QVector<QGeoCameraData> steps;
+    const QDoubleVector2D start = QWebMercator::coordToMercator(QGeoCoordinate(50.0, 9.0));
+    const double step = 0.25 * 1280.0 / (256.0 * (1 << int(zoomLevel)));
+    for (int i = 0; i < 48; ++i) {
+        QGeoCameraData camera;
+        camera.setCenter(QWebMercator::mercatorToCoord(start + QDoubleVector2D(i * step, 0.0)));
+        camera.setZoomLevel(zoomLevel);
+        steps.append(camera);
+    }
+
+    m_map->setCameraData(steps.first());
+    support.updateObjectsGeometry();
+    support.updateMapObjects(&root, nullptr);
+
+    QBENCHMARK {
+        for (const QGeoCameraData &camera : qAsConst(steps)) {
+            m_map->setCameraData(camera);
+            support.updateObjectsGeometry();
+            support.updateMapObjects(&root, nullptr);
+        }
+    }
+
+    for (QMapCircleObject *circle : qAsConst(circles)) {
+        support.removeMapObject(circle);
+        delete circle;
+    }
+    support.updateMapObjects(&root, nullptr);
+}
+
+QTEST_MAIN(tst_QGeoMapObjectQSGSupportBenchmark)
+
+#include "tst_bench_qgeomapobjectqsgsupport.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeoprojection
+
+SOURCES += tst_bench_qgeoprojection.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeoconvexclipper_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoProjectionBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void fling_data();
+    void fling();
+};
+
+void tst_QGeoProjectionBenchmark::fling_data()
+{
+    QTest::addColumn<double>("tilt");
+    QTest::addColumn<bool>("items");
+
+    const double tilts[] = { 0.0, 45.0, 60.0 };
+    for (double tilt : tilts) {
+        QTest::newRow(qPrintable(QStringLiteral("tilt %1, regions").arg(tilt))) << tilt << false;
+        QTest::newRow(qPrintable(QStringLiteral("tilt %1, items").arg(tilt))) << tilt << true;
+    }
+}
+
+// The work of the projection in one frame of a fling over a 1280x720
+// viewport at z14: the camera moves, decelerating, and the regions are
+// recomputed. "items" also projects 50 polylines of 32 points around the
+// camera and checks whether they need clipping, as the map items do.
+void tst_QGeoProjectionBenchmark::fling()
+{
+    QFETCH(double, tilt);
+    QFETCH(bool, items);
+
+    const double zoomLevel = 14.0;
+    const double tileSize = 1.0 / (1 << 14);
+    QVector<QGeoCameraData> cameras(120);
+    double offset = 0.0;
+    for (int i = 0; i < cameras.size(); ++i) {
+        offset += tileSize * 0.5 * (1.0 - double(i) / cameras.size());
+        cameras[i].setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + offset, 0.5 + offset * 0.25)));
+        cameras[i].setZoomLevel(zoomLevel);
+        cameras[i].setTilt(tilt);
+        cameras[i].setBearing(30.0);
+    }
+
+    QList<QList<QGeoCoordinate> > paths;
+    for (int i = 0; i < 50; ++i) {
+        QList<QGeoCoordinate> path;
+        const QDoubleVector2D start(0.5 + (i % 10 - 5) * tileSize, 0.5 + (i / 10 - 2) * tileSize);
+        for (int j = 0; j < 32; ++j)
+            path.append(QWebMercator::mercatorToCoord(start + QDoubleVector2D(j, (j & 1) * 2) * (tileSize / 16)));
+        paths.append(path);
+    }
+
+    QGeoProjectionWebMercator p;
+    p.setViewportSize(QSize(1280, 720));
+
+    QList<QDoubleVector2D> wrappedPath;
+    int i = 0;
+    int inside = 0;
+    QBENCHMARK {
+        p.setCameraData(cameras.at(i++ % cameras.size()));
+        const QGeoProjectionWebMercator::Regions &regions = p.regions();
+        QVERIFY(!regions.visible.isEmpty());
+        if (items) {
+            inside = 0;
+            for (const QList<QGeoCoordinate> &path : qAsConst(paths)) {
+                wrappedPath.clear();
+                for (const QGeoCoordinate &c : path)
+                    wrappedPath.append(p.geoToWrappedMapProjection(c));
+                if (QGeoConvexClipper::contains(regions.projectable, wrappedPath))
+                    ++inside;
+            }
+        }
+    }
+    QVERIFY(!items || inside > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoProjectionBenchmark)
+
+#include "tst_bench_qgeoprojection.moc"
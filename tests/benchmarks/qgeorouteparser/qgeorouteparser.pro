@@ -0,0 +1,11 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeorouteparser
+
+# The Esri plugin parses routes on its own
+INCLUDEPATH += ../../../src/plugins/geoservices/esri
+
+SOURCES += tst_bench_qgeorouteparser.cpp \
+           ../../../src/plugins/geoservices/esri/georoutejsonparser_esri.cpp
+
+QT += location-private positioning testlib
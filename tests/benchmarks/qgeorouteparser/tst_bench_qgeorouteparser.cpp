@@ -0,0 +1,293 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/private/qgeorouteparser_p.h>
+#include <QtLocation/private/qgeorouteparserosrmv4_p.h>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+
+#include "georoutejsonparser_esri.h"
+
+QT_USE_NAMESPACE
+
+// A synthetic route of steps * pointsPerStep points heading north east,
+// roughly 1000 km long with the sizes used below
+struct BenchRoute
+{
+    BenchRoute(int steps, int pointsPerStep) : steps(steps), pointsPerStep(pointsPerStep) {}
+
+    // Coordinates in 1e-6 degrees
+    int latitude(int point) const { return 45000000 + point * 80 + (point % 7) * 3; }
+    int longitude(int point) const { return 7000000 + point * 110 - (point % 5) * 4; }
+    int points() const { return steps * pointsPerStep + 1; }
+
+    int steps;
+    int pointsPerStep;
+};
+
+static void encodeValue(int value, QString *polyline)
+{
+    uint v = value < 0 ? ~(uint(value) << 1) : uint(value) << 1;
+    while (v >= 0x20) {
+        polyline->append(QChar(int((0x20 | (v & 0x1f)) + 63)));
+        v >>= 5;
+    }
+    polyline->append(QChar(int(v + 63)));
+}
+
+static QString encodePolyline(const BenchRoute &route, int first, int last)
+{
+    QString polyline;
+    int latitude = 0;
+    int longitude = 0;
+    for (int i = first; i <= last; ++i) {
+        encodeValue(route.latitude(i) - latitude, &polyline);
+        encodeValue(route.longitude(i) - longitude, &polyline);
+        latitude = route.latitude(i);
+        longitude = route.longitude(i);
+    }
+    return polyline;
+}
+
+static QByteArray osrmV4Reply(const BenchRoute &route)
+{
+    QJsonArray instructions;
+    for (int s = 0; s < route.steps; ++s) {
+        instructions.append(QJsonArray { QStringLiteral("3"), QStringLiteral("Street %1").arg(s), 500.0,
+                                         s * route.pointsPerStep, 30, QStringLiteral("500m"),
+                                         QStringLiteral("NE"), 45.0 });
+    }
+    instructions.append(QJsonArray { QStringLiteral("15"), QString(), 0.0, route.points() - 1, 0,
+                                     QStringLiteral("0m"), QStringLiteral("N"), 0.0 });
+
+    QJsonObject object;
+    object.insert(QStringLiteral("status"), 0);
+    object.insert(QStringLiteral("route_geometry"), encodePolyline(route, 0, route.points() - 1));
+    object.insert(QStringLiteral("route_instructions"), instructions);
+    object.insert(QStringLiteral("route_summary"), QJsonObject {
+                      { QStringLiteral("total_distance"), route.steps * 500.0 },
+                      { QStringLiteral("total_time"), route.steps * 30.0 } });
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+static QByteArray osrmV5Reply(const BenchRoute &route)
+{
+    QJsonArray steps;
+    for (int s = 0; s < route.steps; ++s) {
+        const int first = s * route.pointsPerStep;
+        QJsonObject maneuver {
+            { QStringLiteral("location"), QJsonArray { route.longitude(first) / 1e6, route.latitude(first) / 1e6 } },
+            { QStringLiteral("bearing_before"), 40 },
+            { QStringLiteral("bearing_after"), 50 },
+            { QStringLiteral("type"), s == 0 ? QStringLiteral("depart") : QStringLiteral("turn") },
+            { QStringLiteral("modifier"), s % 2 ? QStringLiteral("slight left") : QStringLiteral("slight right") } };
+        steps.append(QJsonObject {
+                         { QStringLiteral("distance"), 500.0 },
+                         { QStringLiteral("duration"), 30.0 },
+                         { QStringLiteral("name"), QStringLiteral("Street %1").arg(s) },
+                         { QStringLiteral("mode"), QStringLiteral("driving") },
+                         { QStringLiteral("geometry"), encodePolyline(route, first, first + route.pointsPerStep) },
+                         { QStringLiteral("maneuver"), maneuver },
+                         { QStringLiteral("intersections"), QJsonArray() } });
+    }
+
+    QJsonObject leg {
+        { QStringLiteral("distance"), route.steps * 500.0 },
+        { QStringLiteral("duration"), route.steps * 30.0 },
+        { QStringLiteral("steps"), steps } };
+    QJsonObject routeObject {
+        { QStringLiteral("distance"), route.steps * 500.0 },
+        { QStringLiteral("duration"), route.steps * 30.0 },
+        { QStringLiteral("legs"), QJsonArray { leg } } };
+    QJsonObject object {
+        { QStringLiteral("code"), QStringLiteral("Ok") },
+        { QStringLiteral("routes"), QJsonArray { routeObject } } };
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+static QByteArray esriReply(const BenchRoute &route)
+{
+    QJsonArray features;
+    for (int s = 0; s < route.steps; ++s) {
+        features.append(QJsonObject { { QStringLiteral("attributes"), QJsonObject {
+                                            { QStringLiteral("length"), 0.5 },
+                                            { QStringLiteral("time"), 0.5 },
+                                            { QStringLiteral("text"), QStringLiteral("Turn left on Street %1").arg(s) },
+                                            { QStringLiteral("maneuverType"), QStringLiteral("esriDMTTurnLeft") } } } });
+    }
+    QJsonObject direction {
+        { QStringLiteral("routeId"), 1 },
+        { QStringLiteral("routeName"), QStringLiteral("bench") },
+        { QStringLiteral("summary"), QJsonObject {
+              { QStringLiteral("totalLength"), route.steps * 0.5 },
+              { QStringLiteral("totalTime"), route.steps * 0.5 },
+              { QStringLiteral("envelope"), QJsonObject {
+                    { QStringLiteral("xmin"), 7.0 }, { QStringLiteral("ymin"), 45.0 },
+                    { QStringLiteral("xmax"), 17.0 }, { QStringLiteral("ymax"), 53.0 } } } } },
+        { QStringLiteral("features"), features } };
+
+    QJsonArray path;
+    for (int i = 0; i < route.points(); ++i)
+        path.append(QJsonArray { route.longitude(i) / 1e6, route.latitude(i) / 1e6 });
+    QJsonObject routeFeature {
+        { QStringLiteral("attributes"), QJsonObject { { QStringLiteral("ObjectID"), 1 } } },
+        { QStringLiteral("geometry"), QJsonObject { { QStringLiteral("paths"), QJsonArray { path } } } } };
+
+    QJsonObject object {
+        { QStringLiteral("directions"), QJsonArray { direction } },
+        { QStringLiteral("routes"), QJsonObject { { QStringLiteral("features"), QJsonArray { routeFeature } } } } };
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+class tst_QGeoRouteParserBenchmark : public QObject
+{
+    Q_OBJECT
+
+    enum Format {
+        OsrmV4,
+        OsrmV5,
+        Esri
+    };
+
+private Q_SLOTS:
+    void parse_data();
+    void parse();
+    void parseAsync_data();
+    void parseAsync();
+
+private:
+    void populateRoutes(bool esri);
+    static QByteArray reply(Format format, const BenchRoute &route);
+};
+
+void tst_QGeoRouteParserBenchmark::populateRoutes(bool esri)
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("steps");
+
+    QTest::newRow("osrm v4, 100 steps") << int(OsrmV4) << 100;
+    QTest::newRow("osrm v4, 2000 steps") << int(OsrmV4) << 2000;
+    QTest::newRow("osrm v5, 100 steps") << int(OsrmV5) << 100;
+    QTest::newRow("osrm v5, 2000 steps") << int(OsrmV5) << 2000;
+    if (esri) {
+        QTest::newRow("esri, 100 steps") << int(Esri) << 100;
+        QTest::newRow("esri, 2000 steps") << int(Esri) << 2000;
+    }
+}
+
+QByteArray tst_QGeoRouteParserBenchmark::reply(Format format, const BenchRoute &route)
+{
+    switch (format) {
+    case OsrmV4:
+        return osrmV4Reply(route);
+    case OsrmV5:
+        return osrmV5Reply(route);
+    case Esri:
+        return esriReply(route);
+    }
+    return QByteArray();
+}
+
+void tst_QGeoRouteParserBenchmark::parse_data()
+{
+    populateRoutes(true);
+}
+
+// Parses a whole reply, as done on the worker thread
+void tst_QGeoRouteParserBenchmark::parse()
+{
+    QFETCH(int, format);
+    QFETCH(int, steps);
+
+    const BenchRoute route(steps, 50);
+    const QByteArray data = reply(Format(format), route);
+    QGeoRouteParserOsrmV4 parserV4;
+    QGeoRouteParserOsrmV5 parserV5;
+
+    QList<QGeoRoute> routes;
+    QBENCHMARK {
+        QString errorString;
+        if (format == Esri) {
+            GeoRouteJsonParserEsri parser(QJsonDocument::fromJson(data));
+            QVERIFY(parser.isValid());
+            routes = parser.routes();
+        } else {
+            routes.clear();
+            const QGeoRouteParser &parser = format == OsrmV4 ? static_cast<const QGeoRouteParser &>(parserV4)
+                                                             : static_cast<const QGeoRouteParser &>(parserV5);
+            QCOMPARE(parser.parseReply(routes, errorString, data), QGeoRouteReply::NoError);
+        }
+    }
+
+    QCOMPARE(routes.size(), 1);
+    const QList<QGeoCoordinate> path = routes.first().path();
+    QCOMPARE(path.size(), format == OsrmV5 ? route.points() + route.steps - 1 : route.points());
+    QCOMPARE(path.last(), QGeoCoordinate(route.latitude(route.points() - 1) / 1e6,
+                                         route.longitude(route.points() - 1) / 1e6));
+}
+
+void tst_QGeoRouteParserBenchmark::parseAsync_data()
+{
+    populateRoutes(false);
+}
+
+// Time from handing a reply to the parser until the routes are delivered
+// back to the thread of the caller
+void tst_QGeoRouteParserBenchmark::parseAsync()
+{
+    QFETCH(int, format);
+    QFETCH(int, steps);
+
+    const BenchRoute route(steps, 50);
+    const QByteArray data = reply(Format(format), route);
+    QGeoRouteParserOsrmV4 parserV4;
+    QGeoRouteParserOsrmV5 parserV5;
+    const QGeoRouteParser &parser = format == OsrmV4 ? static_cast<const QGeoRouteParser &>(parserV4)
+                                                     : static_cast<const QGeoRouteParser &>(parserV5);
+
+    QBENCHMARK {
+        QGeoRouteParseJob *job = parser.parseReplyAsync(data);
+        QList<QGeoRoute> routes;
+        QEventLoop loop;
+        connect(job, &QGeoRouteParseJob::finished, &loop, [&]() {
+            routes = job->routes();
+            loop.quit();
+        });
+        loop.exec();
+        QCOMPARE(routes.size(), 1);
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteParserBenchmark)
+
+#include "tst_bench_qgeorouteparser.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeosimplifiedpath
+
+SOURCES += tst_bench_qgeosimplifiedpath.cpp
+
+QT += location-private positioning-private testlib
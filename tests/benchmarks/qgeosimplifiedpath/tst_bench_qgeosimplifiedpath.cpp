@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+#include <QtLocation/private/qgeosimplifiedpath_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoSimplifiedPathBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void simplify_data();
+    void simplify();
+
+private:
+    QList<QDoubleVector2D> m_track;
+};
+
+// A 1M point track across a hundredth of the map, a few meters per point
+void tst_QGeoSimplifiedPathBenchmark::initTestCase()
+{
+    QRandomGenerator random(1);
+    QDoubleVector2D p(0.5, 0.5);
+    double heading = 0.0;
+    m_track.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i) {
+        heading += (random.generateDouble() - 0.5) * 0.2;
+        p = p + QDoubleVector2D(std::cos(heading), std::sin(heading)) * 1e-8;
+        m_track << p;
+    }
+}
+
+void tst_QGeoSimplifiedPathBenchmark::simplify_data()
+{
+    QTest::addColumn<QString>("method");
+
+    QTest::newRow("rank") << QStringLiteral("rank");
+    QTest::newRow("append") << QStringLiteral("append");
+    QTest::newRow("zoom") << QStringLiteral("zoom");
+    QTest::newRow("cached") << QStringLiteral("cached");
+}
+
+// "rank" ranks the whole track, as when the path is set, "append" adds a
+// point and selects again, as for a live track, "zoom" selects the points
+// for another zoom level between 4 and 20 each time, and "cached" for the
+// same zoom level, as when panning. The tolerances are half a pixel.
+void tst_QGeoSimplifiedPathBenchmark::simplify()
+{
+    QFETCH(QString, method);
+
+    QGeoSimplifiedPath path;
+    path.setPath(m_track.mid(0, m_track.size() - 1000));
+    path.ranks();
+    int i = 0;
+    int points = 0;
+    if (method == QLatin1String("rank")) {
+        QBENCHMARK {
+            path.setPath(m_track);
+            points = path.ranks().size();
+        }
+    } else if (method == QLatin1String("append")) {
+        QBENCHMARK {
+            path.append(m_track.at(path.size() % m_track.size()));
+            points = path.simplified(0.5 / (256 << 16)).size();
+        }
+    } else if (method == QLatin1String("zoom")) {
+        QBENCHMARK {
+            points = path.simplified(0.5 / (256 << (4 + i++ % 17))).size();
+        }
+    } else {
+        QBENCHMARK {
+            points = path.simplified(0.5 / (256 << 16) * (1.0 + (i++ % 2) * 0.5)).size();
+        }
+    }
+    QVERIFY(points > 1);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoSimplifiedPathBenchmark)
+
+#include "tst_bench_qgeosimplifiedpath.moc"
@@ -0,0 +1,10 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeotiledmapscene
+
+INCLUDEPATH += ../../../src/location/maps ../../auto/geotestplugin
+
+HEADERS += ../../auto/geotestplugin/qgeotilefetcher_test.h
+SOURCES += tst_bench_qgeotiledmapscene.cpp
+
+QT += location-private positioning-private quick testlib
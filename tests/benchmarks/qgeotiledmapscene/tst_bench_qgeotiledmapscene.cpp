@@ -0,0 +1,192 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtQuick/QQuickRenderControl>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGNode>
+#include <QtTest/QtTest>
+
+#include "qgeotiledmapscene_p.h"
+#include "qgeocameratiles_p.h"
+#include "qgeocameradata_p.h"
+#include "qgeomaptype_p.h"
+#include "qabstractgeotilecache_p.h"
+#include "qgeotilespec_p.h"
+#include "qgeotilefetcher_test.h"
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTiledMapSceneBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void updateSceneGraph_data();
+    void updateSceneGraph();
+
+private:
+    struct Step
+    {
+        QGeoCameraData camera;
+        QSet<QGeoTileSpec> tiles;
+    };
+
+    QScopedPointer<QOpenGLContext> m_context;
+    QScopedPointer<QOffscreenSurface> m_surface;
+    QScopedPointer<QQuickRenderControl> m_renderControl;
+    QScopedPointer<QQuickWindow> m_window;
+
+    QVector<Step> m_steps;
+    QHash<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > m_textures;
+};
+
+static const QSize screenSize(1280, 720);
+static const int tileSize = 256;
+
+// Sets up a scene graph without showing a window, and a pan across a zoom 16
+// map, a quarter of a tile per step, with the tiles rendered by the fetcher
+// of the test plugin
+void tst_QGeoTiledMapSceneBenchmark::initTestCase()
+{
+    m_context.reset(new QOpenGLContext);
+    if (!m_context->create())
+        QSKIP("No OpenGL context available");
+    m_surface.reset(new QOffscreenSurface);
+    m_surface->setFormat(m_context->format());
+    m_surface->create();
+    QVERIFY(m_context->makeCurrent(m_surface.data()));
+
+    m_renderControl.reset(new QQuickRenderControl);
+    m_window.reset(new QQuickWindow(m_renderControl.data()));
+    m_window->resize(screenSize);
+    m_renderControl->initialize(m_context.data());
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(tileSize);
+    ct.setScreenSize(screenSize);
+    ct.setPluginString(QStringLiteral("bench"));
+    ct.setMapType(QGeoMapType(QGeoMapType::StreetMap, QStringLiteral("street map"), QStringLiteral("street map"),
+                              false, false, 1, QByteArrayLiteral(""), QGeoCameraCapabilities()));
+
+    const double zoomLevel = 16.0;
+    const double step = 0.25 / (1 << int(zoomLevel));
+    for (int i = 0; i < 48; ++i) {
+        Step s;
+        s.camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + i * step, 0.5)));
+        s.camera.setZoomLevel(zoomLevel);
+        ct.setCameraData(s.camera);
+        s.tiles = ct.createTiles();
+        m_steps.append(s);
+    }
+
+    QGeoTileFetcherTest fetcher(nullptr);
+    fetcher.setFinishRequestImmediately(true);
+    for (const Step &s : qAsConst(m_steps)) {
+        for (const QGeoTileSpec &spec : s.tiles) {
+            if (m_textures.contains(spec))
+                continue;
+            QScopedPointer<QGeoTiledMapReply> reply(fetcher.getTileImage(spec));
+            QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+            tt->spec = spec;
+            QVERIFY(tt->image.loadFromData(reply->mapImageData()));
+            tt->image = tt->image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            m_textures.insert(spec, tt);
+        }
+    }
+}
+
+void tst_QGeoTiledMapSceneBenchmark::cleanupTestCase()
+{
+    m_window.reset();
+    m_renderControl.reset();
+    if (m_context)
+        m_context->doneCurrent();
+}
+
+void tst_QGeoTiledMapSceneBenchmark::updateSceneGraph_data()
+{
+    QTest::addColumn<bool>("pan");
+    QTest::addColumn<bool>("atlas");
+
+    QTest::newRow("still") << false << false;
+    QTest::newRow("still, tile atlas") << false << true;
+    QTest::newRow("pan") << true << false;
+    QTest::newRow("pan, tile atlas") << true << true;
+}
+
+// Updates the scene graph once per step of the pan, adding the textures of
+// the tiles that became visible, or repeatedly without changes
+void tst_QGeoTiledMapSceneBenchmark::updateSceneGraph()
+{
+    QFETCH(bool, pan);
+    QFETCH(bool, atlas);
+
+    QGeoTiledMapScene scene;
+    scene.setTileSize(tileSize);
+    scene.setScreenSize(screenSize);
+    scene.setTileAtlasEnabled(atlas);
+
+    auto showStep = [&](const Step &s) {
+        scene.setCameraData(s.camera);
+        scene.setVisibleTiles(s.tiles);
+        const QSet<QGeoTileSpec> textured = scene.texturedTiles();
+        for (const QGeoTileSpec &spec : s.tiles) {
+            if (!textured.contains(spec))
+                scene.addTile(spec, m_textures.value(spec));
+        }
+    };
+
+    showStep(m_steps.first());
+    QSGNode *root = scene.updateSceneGraph(nullptr, m_window.data());
+    QVERIFY(root);
+
+    if (pan) {
+        QBENCHMARK {
+            for (const Step &s : qAsConst(m_steps)) {
+                showStep(s);
+                root = scene.updateSceneGraph(root, m_window.data());
+            }
+        }
+    } else {
+        QBENCHMARK {
+            root = scene.updateSceneGraph(root, m_window.data());
+        }
+    }
+
+    delete root;
+}
+
+QTEST_MAIN(tst_QGeoTiledMapSceneBenchmark)
+
+#include "tst_bench_qgeotiledmapscene.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeotilerequestmanager
+
+INCLUDEPATH += ../../auto/geotestplugin
+
+SOURCES += tst_bench_qgeotilerequestmanager.cpp
+
+QT += location-private positioning-private testlib
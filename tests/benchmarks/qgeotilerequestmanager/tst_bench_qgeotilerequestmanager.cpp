@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotiledmap_test.h"
+#include "qgeotilefetcher_test.h"
+#include "qgeotiledmappingmanagerengine_test.h"
+#include <QtCore/QStandardPaths>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeotiledmap_p.h>
+#include <QtLocation/private/qgeotilerequestmanager_p.h>
+#include <QtLocation/private/qgeocameratiles_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileRequestManagerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void requestTiles_data();
+    void requestTiles();
+
+private:
+    void runPan();
+
+    QScopedPointer<QGeoServiceProvider> m_provider;
+    QScopedPointer<QGeoTiledMapTest> m_map;
+    QGeoTileFetcherTest *m_fetcher = nullptr;
+    QVector<QSet<QGeoTileSpec> > m_steps;
+    QSet<QGeoTileSpec> m_allTiles;
+};
+
+// Loads the test plugin, which renders tiles locally, and scripts a pan
+// across a zoom 8 map, a quarter of a tile per step
+void tst_QGeoTileRequestManagerBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    parameters["maxZoomLevel"] = 8;
+    parameters["finishRequestImmediately"] = true;
+    m_provider.reset(new QGeoServiceProvider("qmlgeo.test.plugin", parameters));
+    m_provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = m_provider->mappingManager();
+    QVERIFY2(m_provider->error() == QGeoServiceProvider::NoError, "Could not load plugin: " + m_provider->errorString().toLatin1());
+    m_map.reset(static_cast<QGeoTiledMapTest*>(mappingManager->createMap(this)));
+    QVERIFY(m_map);
+    m_map->setActiveMapType(m_map->m_engine->supportedMapTypes().first());
+    m_fetcher = static_cast<QGeoTileFetcherTest*>(m_map->m_engine->tileFetcher());
+
+    QGeoCameraTiles ct;
+    ct.setTileSize(256);
+    ct.setScreenSize(QSize(1280, 720));
+    ct.setPluginString(m_map->m_engine->managerName() + QLatin1Char('_')
+                       + QString::number(m_map->m_engine->managerVersion()));
+    ct.setMapType(m_map->activeMapType());
+
+    const double zoomLevel = 8.0;
+    const double step = 0.25 / (1 << int(zoomLevel));
+    for (int i = 0; i < 48; ++i) {
+        QGeoCameraData camera;
+        camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5 + i * step, 0.5)));
+        camera.setZoomLevel(zoomLevel);
+        ct.setCameraData(camera);
+        m_steps.append(ct.createTiles());
+        m_allTiles += m_steps.last();
+    }
+}
+
+// Requests the tiles of every step of the pan, letting fetched and decoded
+// tiles arrive in between, then drops all requests
+void tst_QGeoTileRequestManagerBenchmark::runPan()
+{
+    QGeoTileRequestManager *requests = m_map->requestManager();
+    for (const QSet<QGeoTileSpec> &tiles : qAsConst(m_steps)) {
+        requests->requestTiles(tiles);
+        QCoreApplication::processEvents();
+    }
+    requests->requestTiles(QSet<QGeoTileSpec>());
+}
+
+void tst_QGeoTileRequestManagerBenchmark::requestTiles_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("uncached") << false;
+    QTest::newRow("cached") << true;
+}
+
+void tst_QGeoTileRequestManagerBenchmark::requestTiles()
+{
+    QFETCH(bool, cached);
+
+    m_map->clearData();
+    if (cached) {
+        QSignalSpy spy(m_fetcher, SIGNAL(tileFetched(QGeoTileSpec)));
+        m_map->requestManager()->requestTiles(m_allTiles);
+        QTRY_COMPARE_WITH_TIMEOUT(spy.count(), m_allTiles.size(), 60000);
+        m_map->requestManager()->requestTiles(QSet<QGeoTileSpec>());
+
+        QBENCHMARK {
+            runPan();
+        }
+    } else {
+        QBENCHMARK {
+            m_map->clearData();
+            runPan();
+        }
+    }
+}
+
+QTEST_MAIN(tst_QGeoTileRequestManagerBenchmark)
+
+#include "tst_bench_qgeotilerequestmanager.moc"
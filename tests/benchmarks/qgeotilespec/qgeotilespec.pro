@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeotilespec
+
+SOURCES += tst_bench_qgeotilespec.cpp
+
+QT += location-private testlib
@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QString>
+#include <QtCore/QSet>
+#include <QtTest/QtTest>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_USE_NAMESPACE
+
+// QGeoTileSpec as it used to be: a QString plugin name compared on every lookup,
+// and a hash reducing each field modulo 31. Kept for comparison.
+class LegacyTileSpec
+{
+public:
+    LegacyTileSpec(const QString &plugin, int mapId, int zoom, int x, int y, int version)
+        : plugin(plugin), mapId(mapId), zoom(zoom), x(x), y(y), version(version) {}
+
+    bool operator == (const LegacyTileSpec &rhs) const
+    {
+        return plugin == rhs.plugin && mapId == rhs.mapId && zoom == rhs.zoom
+                && x == rhs.x && y == rhs.y && version == rhs.version;
+    }
+
+    QString plugin;
+    int mapId;
+    int zoom;
+    int x;
+    int y;
+    int version;
+};
+
+uint qHash(const LegacyTileSpec &spec)
+{
+    unsigned int result = (qHash(spec.plugin) * 13) % 31;
+    result += ((spec.mapId * 17) % 31) << 5;
+    result += ((spec.zoom * 19) % 31) << 10;
+    result += ((spec.x * 23) % 31) << 15;
+    result += ((spec.y * 29) % 31) << 20;
+    result += (spec.version % 3) << 25;
+    return result;
+}
+
+template <typename Spec>
+static QSet<Spec> tileWindow(int zoom, int originX, int originY, int size)
+{
+    const QString plugin = QStringLiteral("osm_100-l-1");
+    QSet<Spec> tiles;
+    for (int y = originY; y < originY + size; ++y)
+        for (int x = originX; x < originX + size; ++x)
+            tiles.insert(Spec(plugin, 1, zoom, x, y, -1));
+    return tiles;
+}
+
+template <typename Spec>
+static int hashCollisions(const QSet<Spec> &tiles)
+{
+    QSet<uint> hashes;
+    for (const Spec &spec : tiles)
+        hashes.insert(qHash(spec));
+    return tiles.size() - hashes.size();
+}
+
+class tst_QGeoTileSpecBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void hashCollisions_data();
+    void hashCollisions();
+    void setDifference_data();
+    void setDifference();
+
+private:
+    void populateWindows();
+};
+
+void tst_QGeoTileSpecBenchmark::populateWindows()
+{
+    QTest::addColumn<bool>("legacy");
+    QTest::addColumn<int>("zoom");
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("legacy z17 20x20") << true << 17 << 20;
+    QTest::newRow("current z17 20x20") << false << 17 << 20;
+    QTest::newRow("legacy z17 60x60") << true << 17 << 60;
+    QTest::newRow("current z17 60x60") << false << 17 << 60;
+}
+
+void tst_QGeoTileSpecBenchmark::hashCollisions_data()
+{
+    populateWindows();
+}
+
+// Reports the number of tiles whose hash is shared with another tile of the window
+void tst_QGeoTileSpecBenchmark::hashCollisions()
+{
+    QFETCH(bool, legacy);
+    QFETCH(int, zoom);
+    QFETCH(int, size);
+
+    const int origin = (1 << zoom) / 2;
+    int collisions;
+    if (legacy)
+        collisions = ::hashCollisions(tileWindow<LegacyTileSpec>(zoom, origin, origin, size));
+    else
+        collisions = ::hashCollisions(tileWindow<QGeoTileSpec>(zoom, origin, origin, size));
+
+    QTest::setBenchmarkResult(collisions, QTest::Events);
+}
+
+void tst_QGeoTileSpecBenchmark::setDifference_data()
+{
+    populateWindows();
+}
+
+// The difference of two windows one tile apart, as computed on every pan
+void tst_QGeoTileSpecBenchmark::setDifference()
+{
+    QFETCH(bool, legacy);
+    QFETCH(int, zoom);
+    QFETCH(int, size);
+
+    const int origin = (1 << zoom) / 2;
+    if (legacy) {
+        const QSet<LegacyTileSpec> before = tileWindow<LegacyTileSpec>(zoom, origin, origin, size);
+        const QSet<LegacyTileSpec> after = tileWindow<LegacyTileSpec>(zoom, origin + 1, origin, size);
+        QBENCHMARK {
+            const QSet<LegacyTileSpec> removed = before - after;
+            const QSet<LegacyTileSpec> added = after - before;
+            QCOMPARE(removed.size(), size);
+            QCOMPARE(added.size(), size);
+        }
+    } else {
+        const QSet<QGeoTileSpec> before = tileWindow<QGeoTileSpec>(zoom, origin, origin, size);
+        const QSet<QGeoTileSpec> after = tileWindow<QGeoTileSpec>(zoom, origin + 1, origin, size);
+        QBENCHMARK {
+            const QSet<QGeoTileSpec> removed = before - after;
+            const QSet<QGeoTileSpec> added = after - before;
+            QCOMPARE(removed.size(), size);
+            QCOMPARE(added.size(), size);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileSpecBenchmark)
+
+#include "tst_bench_qgeotilespec.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qnmeapositioninfosource
+
+SOURCES += tst_bench_qnmeapositioninfosource.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryFile>
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QNmeaPositionInfoSource>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qnmeapositioninfosource_p.h>
+
+QT_USE_NAMESPACE
+
+static QByteArray withChecksum(const QByteArray &sentence)
+{
+    int result = 0;
+    for (int i = 1; i < sentence.size(); ++i)
+        result ^= sentence.at(i);
+    return sentence + '*' + QByteArray::number(result, 16).rightJustified(2, '0') + "\r\n";
+}
+
+class tst_QNmeaPositionInfoSourceBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void parse_data();
+    void parse();
+    void realTimeSource_data();
+    void realTimeSource();
+    void simulatedReplay_data();
+    void simulatedReplay();
+
+private:
+    QList<QByteArray> m_sentences;
+    QByteArray m_stream;
+};
+
+void tst_QNmeaPositionInfoSourceBenchmark::initTestCase()
+{
+    // One fix per second, each reported through RMC, GGA, GSA and VTG
+    QDateTime dt(QDate(2019, 3, 15), QTime(6, 0), Qt::UTC);
+    for (int i = 0; i < 250; ++i) {
+        const QByteArray time = dt.toString(QStringLiteral("hhmmss.zzz")).toLatin1();
+        const QByteArray date = dt.toString(QStringLiteral("ddMMyy")).toLatin1();
+        const QByteArray lat = QByteArray::number(2730.83609 + i * 0.00137, 'f', 5);
+        const QByteArray lng = QByteArray::number(15301.87844 + i * 0.00211, 'f', 5);
+
+        m_sentences << withChecksum("$GPRMC," + time + ",A," + lat + ",S," + lng
+                                    + ",E,0.7,9.0," + date + ",11.2,W,A");
+        m_sentences << withChecksum("$GPGGA," + time + ',' + lat + ",S," + lng
+                                    + ",E,1,04,3.5,49.4,M,39.2,M,,");
+        m_sentences << withChecksum("$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1");
+        m_sentences << withChecksum("$GPVTG,9.0,T,,M,0.7,N,1.3,K,A");
+        dt = dt.addSecs(1);
+    }
+    for (const QByteArray &sentence : qAsConst(m_sentences))
+        m_stream += sentence;
+}
+
+void tst_QNmeaPositionInfoSourceBenchmark::parse_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000 sentences") << m_sentences.count();
+}
+
+// Time per iteration is for the whole block of sentences
+void tst_QNmeaPositionInfoSourceBenchmark::parse()
+{
+    QFETCH(int, count);
+
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QBENCHMARK {
+        for (int i = 0; i < count; ++i) {
+            const QByteArray &sentence = m_sentences.at(i);
+            QLocationUtils::getPosInfoFromNmea(sentence.constData(), sentence.size(),
+                                               &info, 5.1, &hasFix);
+        }
+    }
+}
+
+void tst_QNmeaPositionInfoSourceBenchmark::realTimeSource_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000 sentences") << m_sentences.count();
+}
+
+// Time per iteration is for the whole block of sentences
+void tst_QNmeaPositionInfoSourceBenchmark::realTimeSource()
+{
+    QBuffer buffer(&m_stream);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QNmeaPositionInfoSource source(QNmeaPositionInfoSource::RealTimeMode);
+    source.setDevice(&buffer);
+    source.startUpdates();
+
+    QBENCHMARK {
+        // The source reads every available line when the device signals new data
+        buffer.seek(0);
+        emit buffer.readyRead();
+    }
+}
+
+void tst_QNmeaPositionInfoSourceBenchmark::simulatedReplay_data()
+{
+    QTest::addColumn<bool>("mapped");
+
+    QTest::newRow("buffer") << false;
+    QTest::newRow("mapped file") << true;
+}
+
+// Replays the whole log as fast as possible
+void tst_QNmeaPositionInfoSourceBenchmark::simulatedReplay()
+{
+    QFETCH(bool, mapped);
+
+    QBuffer buffer(&m_stream);
+    QTemporaryFile file;
+    QIODevice *device = &buffer;
+    if (mapped) {
+        QVERIFY(file.open());
+        QCOMPARE(file.write(m_stream), qint64(m_stream.size()));
+        device = &file;
+    } else {
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+    }
+
+    const int updates = m_sentences.count() / 4;
+    QBENCHMARK {
+        device->seek(0);
+        QNmeaPositionInfoSource source(QNmeaPositionInfoSource::SimulationMode);
+        source.setDevice(device);
+        QNmeaPositionInfoSourcePrivate::get(source)->setSimulationSpeed(0);
+
+        int received = 0;
+        connect(&source, &QGeoPositionInfoSource::positionUpdated, [&received]() { ++received; });
+        source.startUpdates();
+        while (received < updates)
+            QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(tst_QNmeaPositionInfoSourceBenchmark)
+
+#include "tst_bench_qnmeapositioninfosource.moc"
@@ -1,3 +1,3 @@
 TEMPLATE = subdirs
-SUBDIRS = auto
+SUBDIRS = auto benchmarks
 qtHaveModule(location):qtHaveModule(quick): SUBDIRS += plugins/declarativetestplugin